@@ -343,6 +343,27 @@ extern void dmabounce_unregister_dev(struct device *);
  */
 extern int dma_needs_bounce(struct device*, dma_addr_t, size_t);
 
+/*
+ * Lazy cache maintenance for long-lived single-direction streaming DMA
+ * buffers.  Registered buffers skip sync operations in the registered
+ * direction while the CPU has not touched them since the last sync;
+ * the owning driver reports CPU access with dma_lazy_touch().
+ */
+#ifdef CONFIG_DMA_LAZY_SYNC
+extern int dma_lazy_register(const void *kaddr, size_t size,
+		enum dma_data_direction dir);
+extern void dma_lazy_unregister(const void *kaddr);
+extern void dma_lazy_touch(const void *kaddr);
+#else
+static inline int dma_lazy_register(const void *kaddr, size_t size,
+		enum dma_data_direction dir)
+{
+	return -ENOSYS;
+}
+static inline void dma_lazy_unregister(const void *kaddr) { }
+static inline void dma_lazy_touch(const void *kaddr) { }
+#endif
+
 /*
  * The DMA API, implemented by dmabounce.c.  See below for descriptions.
  */
@@ -0,0 +1,63 @@
+/* arch/arm/kernel/hibernate.c
+ *
+ * Hibernation (suspend-to-disk) support for ARMv6 UP.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * The generic snapshot code does all the heavy lifting; the
+ * architecture only has to save and restore the CPU context around the
+ * snapshot (hibernate_asm.S) and tell the core which pages must not be
+ * saved.  VFP state is handled by the existing vfp sysdev suspend
+ * hooks, which run on both the snapshot and the resume path.
+ */
+
+#include <linux/init.h>
+#include <linux/mm.h>
+#include <linux/suspend.h>
+
+#include <asm/page.h>
+#include <asm/memory.h>
+#include <asm/system.h>
+
+extern const void __nosave_begin, __nosave_end;
+
+/*
+ * CPU context saved by swsusp_arch_suspend() and reloaded by
+ * swsusp_arch_resume().  Layout must match the offsets used in
+ * hibernate_asm.S: cpsr, control, TTBR0, domain, context ID,
+ * r4-r11, sp, lr.
+ *
+ * This deliberately lives in ordinary .data: the values written before
+ * the snapshot are part of the image, so after the page copy-back it
+ * holds exactly the context we need to return to.
+ */
+u32 swsusp_arch_ctx[15];
+
+/*
+ * Private stack for the page copy-back loop.  The live stack is among
+ * the pages being overwritten, so the loop must run on memory that the
+ * restore does not touch.
+ */
+u8 swsusp_resume_stack[PAGE_SIZE] __nosavedata __attribute__((aligned(8)));
+
+int pfn_is_nosave(unsigned long pfn)
+{
+	unsigned long nosave_begin_pfn = __pa(&__nosave_begin) >> PAGE_SHIFT;
+	unsigned long nosave_end_pfn =
+		PAGE_ALIGN(__pa(&__nosave_end)) >> PAGE_SHIFT;
+
+	return (pfn >= nosave_begin_pfn) && (pfn < nosave_end_pfn);
+}
+
+void save_processor_state(void)
+{
+	/* IRQs are already off; FIQs are still running */
+	local_fiq_disable();
+}
+
+void restore_processor_state(void)
+{
+	local_fiq_enable();
+}
@@ -504,6 +504,19 @@ static int bad_syscall(int n, struct pt_regs *regs)
 	return regs->ARM_r0;
 }
 
+/*
+ * Ranges wider than this are flushed with a single whole-cache
+ * clean+invalidate instead of line by line: the line loop costs more
+ * than cleaning the entire cache once the range exceeds the cache
+ * itself, and JIT compilers flush their whole multi-megabyte code
+ * cache this way.  UP only: flush_cache_all() works by set/way,
+ * which maintains just the local CPU's cache, so on SMP the syscall
+ * must stick to the broadcast ranged flush.
+ */
+#ifndef CONFIG_SMP
+#define CACHE_OP_WHOLE_THRESHOLD	(PAGE_SIZE * 16)
+#endif
+
 static inline void
 do_cache_op(unsigned long start, unsigned long end, int flags)
 {
@@ -522,7 +535,13 @@ do_cache_op(unsigned long start, unsigned long end, int flags)
 			end = vma->vm_end;
 
 		up_read(&mm->mmap_sem);
-		flush_cache_user_range(start, end);
+
+#ifndef CONFIG_SMP
+		if (end - start >= CACHE_OP_WHOLE_THRESHOLD)
+			flush_cache_all();
+		else
+#endif
+			flush_cache_user_range(start, end);
 
 #ifdef CONFIG_ARCH_MSM7X27
 		dmb();
@@ -28,10 +28,13 @@
 #include <linux/cpufreq.h>
 #include <linux/mutex.h>
 #include <linux/io.h>
+#include <linux/module.h>
+#include <linux/ktime.h>
 #include <mach/board.h>
 #include <mach/msm_iomap.h>
 
 #include "proc_comm.h"
+#include "clock.h"
 #include "acpuclock.h"
 
 
@@ -52,6 +55,18 @@
 #define PERF_SWITCH_DEBUG 0
 #define PERF_SWITCH_STEP_DEBUG 0
 
+/*
+ * Measured latency of the full acpuclk_set_rate() path (PLL and VDD
+ * handling included), readable under
+ * /sys/module/acpuclock_arm11/parameters/.  The platform data only
+ * carries a worst-case constant; these show what transitions actually
+ * cost so governor tuning does not have to assume the worst case.
+ */
+static unsigned int switch_us_last;
+static unsigned int switch_us_max;
+module_param(switch_us_last, uint, S_IRUGO);
+module_param(switch_us_max, uint, S_IRUGO);
+
 struct clock_state
 {
 	struct clkctl_acpu_speed	*current_speed;
@@ -63,7 +78,6 @@ struct clock_state
 	unsigned long			wait_for_irq_khz;
 };
 
-static struct clk *ebi1_clk;
 static struct clock_state drv_state = { 0 };
 
 static void __init acpuclk_init(void);
@@ -94,6 +108,10 @@ struct clkctl_acpu_speed {
 /* Index in acpu_freq_tbl[] for steppings. */
 	short		down;
 	short		up;
+/* Precomputed CLK_CNTL source/divider images for each mux bank,
+ * filled in at init so the switch path is a fixed write sequence. */
+	uint32_t	clkctl_src0;
+	uint32_t	clkctl_src1;
 };
 
 /*
@@ -224,67 +242,53 @@ static int acpuclk_set_vdd_level(int vdd)
 }
 
 /* Set proper dividers for the given clock speed. */
+/*
+ * Switch to the given speed using the precomputed CLK_CNTL images:
+ * the idle mux bank is programmed with a single read-modify-write and
+ * the source select bit is flipped afterwards, so the whole switch is
+ * a fixed sequence of two register reads and at most four writes.
+ */
 static void acpuclk_set_div(const struct clkctl_acpu_speed *hunt_s) {
 	uint32_t reg_clkctl, reg_clksel, clk_div;
 
+	reg_clksel = readl(A11S_CLK_SEL_ADDR);
+
 	/* AHB_CLK_DIV */
-	clk_div = (readl(A11S_CLK_SEL_ADDR) >> 1) & 0x03;
+	clk_div = (reg_clksel >> 1) & 0x03;
 	/*
 	 * If the new clock divider is higher than the previous, then
 	 * program the divider before switching the clock
 	 */
 	if (hunt_s->ahbclk_div > clk_div) {
-		reg_clksel = readl(A11S_CLK_SEL_ADDR);
 		reg_clksel &= ~(0x3 << 1);
 		reg_clksel |= (hunt_s->ahbclk_div << 1);
 		writel(reg_clksel, A11S_CLK_SEL_ADDR);
 	}
-	if ((readl(A11S_CLK_SEL_ADDR) & 0x01) == 0) {
-		/* SRC0 */
 
-		/* Program clock source */
-		reg_clkctl = readl(A11S_CLK_CNTL_ADDR);
-		reg_clkctl &= ~(0x07 << 4);
-		reg_clkctl |= (hunt_s->a11clk_src_sel << 4);
-		writel(reg_clkctl, A11S_CLK_CNTL_ADDR);
-
-		/* Program clock divider */
-		reg_clkctl = readl(A11S_CLK_CNTL_ADDR);
-		reg_clkctl &= ~0xf;
-		reg_clkctl |= hunt_s->a11clk_src_div;
+	reg_clkctl = readl(A11S_CLK_CNTL_ADDR);
+	if ((reg_clksel & 0x01) == 0) {
+		/* SRC0 in use; program source and divider into SRC1 */
+		reg_clkctl &= ~(0x07 << 4 | 0x0f);
+		reg_clkctl |= hunt_s->clkctl_src0;
 		writel(reg_clkctl, A11S_CLK_CNTL_ADDR);
 
-		/* Program clock source selection */
-		reg_clksel = readl(A11S_CLK_SEL_ADDR);
 		reg_clksel |= 1; /* CLK_SEL_SRC1NO  == SRC1 */
-		writel(reg_clksel, A11S_CLK_SEL_ADDR);
 	} else {
-		/* SRC1 */
-
-		/* Program clock source */
-		reg_clkctl = readl(A11S_CLK_CNTL_ADDR);
-		reg_clkctl &= ~(0x07 << 12);
-		reg_clkctl |= (hunt_s->a11clk_src_sel << 12);
-		writel(reg_clkctl, A11S_CLK_CNTL_ADDR);
-
-		/* Program clock divider */
-		reg_clkctl = readl(A11S_CLK_CNTL_ADDR);
-		reg_clkctl &= ~(0xf << 8);
-		reg_clkctl |= (hunt_s->a11clk_src_div << 8);
+		/* SRC1 in use; program source and divider into SRC0 */
+		reg_clkctl &= ~(0x07 << 12 | 0x0f << 8);
+		reg_clkctl |= hunt_s->clkctl_src1;
 		writel(reg_clkctl, A11S_CLK_CNTL_ADDR);
 
-		/* Program clock source selection */
-		reg_clksel = readl(A11S_CLK_SEL_ADDR);
 		reg_clksel &= ~1; /* CLK_SEL_SRC1NO  == SRC0 */
-		writel(reg_clksel, A11S_CLK_SEL_ADDR);
 	}
+	/* Program clock source selection */
+	writel(reg_clksel, A11S_CLK_SEL_ADDR);
 
 	/*
 	 * If the new clock divider is lower than the previous, then
 	 * program the divider after switching the clock
 	 */
 	if (hunt_s->ahbclk_div < clk_div) {
-		reg_clksel = readl(A11S_CLK_SEL_ADDR);
 		reg_clksel &= ~(0x3 << 1);
 		reg_clksel |= (hunt_s->ahbclk_div << 1);
 		writel(reg_clksel, A11S_CLK_SEL_ADDR);
@@ -297,6 +301,7 @@ int acpuclk_set_rate(unsigned long rate, int for_power_collapse)
 	struct clkctl_acpu_speed *cur_s, *tgt_s, *strt_s;
 	int rc = 0;
 	unsigned int plls_enabled = 0, pll;
+	ktime_t t_start = ktime_set(0, 0);
 
 	strt_s = cur_s = drv_state.current_speed;
 
@@ -326,6 +331,7 @@ int acpuclk_set_rate(unsigned long rate, int for_power_collapse)
 
 	if (!for_power_collapse) {
 		mutex_lock(&drv_state.lock);
+		t_start = ktime_get();
 		if (strt_s->pll != tgt_s->pll && tgt_s->pll != ACPU_PLL_TCXO) {
 			rc = pc_pll_request(tgt_s->pll, 1);
 			if (rc < 0) {
@@ -412,9 +418,15 @@ int acpuclk_set_rate(unsigned long rate, int for_power_collapse)
 			}
 		}
 
-	/* Change the AXI bus frequency if we can. */
+	/*
+	 * Change the AXI bus frequency if we can.  This is a vote, not a
+	 * raw rate set: pm_qos clients (kgsl, mdp, sdcc, the input boost
+	 * layer) hold the bus up through CLKVOTE_PMQOS regardless of how
+	 * far the CPU has scaled down.
+	 */
 	if (strt_s->axiclk_khz != tgt_s->axiclk_khz) {
-		rc = clk_set_rate(ebi1_clk, tgt_s->axiclk_khz * 1000);
+		rc = ebi1_clk_set_min_rate(CLKVOTE_ACPUCLK,
+					   tgt_s->axiclk_khz * 1000);
 		if (rc < 0)
 			pr_err("Setting AXI min rate failed!\n");
 	}
@@ -429,8 +441,13 @@ int acpuclk_set_rate(unsigned long rate, int for_power_collapse)
 	printk(KERN_DEBUG "%s: ACPU speed change complete\n", __FUNCTION__);
 #endif
 out:
-	if (!for_power_collapse)
+	if (!for_power_collapse) {
+		switch_us_last = (unsigned int)
+			ktime_to_us(ktime_sub(ktime_get(), t_start));
+		if (switch_us_last > switch_us_max)
+			switch_us_max = switch_us_last;
 		mutex_unlock(&drv_state.lock);
+	}
 	return rc;
 }
 
@@ -468,7 +485,7 @@ static void __init acpuclk_init(void)
 
 	drv_state.current_speed = speed;
 
-	rc = clk_set_rate(ebi1_clk, speed->axiclk_khz * 1000);
+	rc = ebi1_clk_set_min_rate(CLKVOTE_ACPUCLK, speed->axiclk_khz * 1000);
 	if (rc < 0)
 		pr_err("Setting AXI min rate failed!\n");
 
@@ -506,12 +523,23 @@ static void __init lpj_init(void)
 	}
 }
 
+/* Precompute the CLK_CNTL mux bank images for every table entry. */
+static void __init clkctl_init(void)
+{
+	struct clkctl_acpu_speed *speed;
+
+	for (speed = acpu_freq_tbl; speed->a11clk_khz != 0; speed++) {
+		speed->clkctl_src0 = (speed->a11clk_src_sel << 4) |
+				     speed->a11clk_src_div;
+		speed->clkctl_src1 = (speed->a11clk_src_sel << 12) |
+				     (speed->a11clk_src_div << 8);
+	}
+}
+
 void __init msm_acpu_clock_init(struct msm_acpu_clock_platform_data *clkdata)
 {
 	pr_info("acpu_clock_init()\n");
 
-	ebi1_clk = clk_get(NULL, "ebi1_clk");
-
 	mutex_init(&drv_state.lock);
 	drv_state.acpu_switch_time_us = clkdata->acpu_switch_time_us;
 	drv_state.max_speed_delta_khz = clkdata->max_speed_delta_khz;
@@ -520,6 +548,7 @@ void __init msm_acpu_clock_init(struct msm_acpu_clock_platform_data *clkdata)
 	drv_state.wait_for_irq_khz = clkdata->wait_for_irq_khz;
 	acpuclk_init();
 	lpj_init();
+	clkctl_init();
 #ifdef CONFIG_CPU_FREQ_TABLE
 	cpufreq_frequency_table_get_attr(freq_table, smp_processor_id());
 #endif
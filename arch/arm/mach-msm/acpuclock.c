@@ -35,6 +35,7 @@
 #include <mach/msm_iomap.h>
 #include <asm/mach-types.h>
 #include <mach/socinfo.h>
+#include <mach/bootcal.h>
 
 #include "proc_comm.h"
 #include "smd_private.h"
@@ -434,9 +435,13 @@ unsigned long acpuclk_wait_for_irq(void)
 	return ret;
 }
 
+/* poll granularity while waiting for the SVS plevel to settle */
+#define VDD_SWITCH_STEP_US 5
+
 static int acpuclk_set_vdd_level(int vdd)
 {
 	uint32_t current_vdd;
+	uint32_t cached, slept;
 
 	current_vdd = readl(A11S_VDD_SVS_PLEVEL_ADDR) & 0x07;
 
@@ -444,11 +449,34 @@ static int acpuclk_set_vdd_level(int vdd)
 	       current_vdd, vdd);
 
 	writel((1 << 7) | (vdd << 3), A11S_VDD_SVS_PLEVEL_ADDR);
-	udelay(drv_state.vdd_switch_time_us);
+
+	/*
+	 * The plevel readback tells us when the switch has actually
+	 * settled (which is why the old fixed delay was followed by a
+	 * pass/fail check), so rather than always sleeping the board's
+	 * worst case we sleep the time measured on earlier switches and
+	 * then poll in small steps.  The total wait is still bounded by
+	 * the conservative board value, so a cold or invalid calibration
+	 * cache simply degrades to the old behavior.
+	 */
+	if (bootcal_get(BOOTCAL_KEY_ACPU_VDD, &cached) ||
+	    cached > drv_state.vdd_switch_time_us)
+		cached = 0;
+	if (cached)
+		udelay(cached);
+	slept = cached;
+	while ((readl(A11S_VDD_SVS_PLEVEL_ADDR) & 0x7) != vdd &&
+	       slept < drv_state.vdd_switch_time_us) {
+		udelay(VDD_SWITCH_STEP_US);
+		slept += VDD_SWITCH_STEP_US;
+	}
 	if ((readl(A11S_VDD_SVS_PLEVEL_ADDR) & 0x7) != vdd) {
 		pr_err("VDD set failed\n");
 		return -EIO;
 	}
+	/* remember the largest settle time we have had to wait for */
+	if (slept > cached)
+		bootcal_set(BOOTCAL_KEY_ACPU_VDD, slept);
 
 	dprintk("VDD switched\n");
 
@@ -996,6 +1024,64 @@ static void shared_pll_control_init(void)
 	pr_warning("Falling back to proc_comm PLL control.\n");
 }
 
+/*
+ * Per-unit VDD calibration.  The stock tables carry worst-case SVS
+ * levels for every frequency; units validated at lower voltage on the
+ * factory line (or by the modem's own characterization) publish a
+ * calibration record in shared memory and get their table trimmed at
+ * boot.  Levels can only be lowered, never raised, and anything that
+ * fails validation leaves the worst-case plan untouched.  This is the
+ * closest an ARM11 target can get to AVS: the Scorpion AVS block's
+ * ring oscillators do not exist here, so there is no closed loop --
+ * just per-device static calibration.
+ */
+#define ACPU_VDD_CAL_MAGIC	0x41435643 /* 'ACVC' */
+#define ACPU_VDD_CAL_MAX	16
+
+struct acpu_vdd_cal {
+	uint32_t	magic;
+	uint32_t	count;
+	struct {
+		uint32_t khz;
+		uint32_t vdd;
+	} level[ACPU_VDD_CAL_MAX];
+};
+
+static void __init acpu_vdd_cal_init(void)
+{
+	struct acpu_vdd_cal *cal;
+	struct clkctl_acpu_speed *s;
+	int i, applied = 0;
+
+	cal = smem_alloc(SMEM_ID_VENDOR2, sizeof(*cal));
+	if (cal == NULL || cal->magic != ACPU_VDD_CAL_MAGIC)
+		return;
+	if (cal->count > ACPU_VDD_CAL_MAX) {
+		pr_warning("acpuclk: bad VDD calibration count %u\n",
+			   cal->count);
+		return;
+	}
+
+	for (i = 0; i < cal->count; i++) {
+		for (s = acpu_freq_tbl; s->a11clk_khz; s++) {
+			if (s->a11clk_khz != cal->level[i].khz)
+				continue;
+			/* only trim within the SVS range */
+			if (cal->level[i].vdd < 1 ||
+			    cal->level[i].vdd > 7 ||
+			    (int) cal->level[i].vdd > s->vdd)
+				break;
+			s->vdd = cal->level[i].vdd;
+			applied++;
+			break;
+		}
+	}
+
+	if (applied)
+		pr_info("acpuclk: per-unit VDD calibration applied to "
+			"%d levels\n", applied);
+}
+
 void __init msm_acpu_clock_init(struct msm_acpu_clock_platform_data *clkdata)
 {
 	pr_info("acpu_clock_init()\n");
@@ -1013,6 +1099,7 @@ void __init msm_acpu_clock_init(struct msm_acpu_clock_platform_data *clkdata)
 		msm7x25_acpu_pll_hw_bug_fix();
 	acpuclk_init();
 	lpj_init();
+	acpu_vdd_cal_init();
 	print_acpu_freq_tbl();
 #ifdef CONFIG_CPU_FREQ_MSM
 	cpufreq_table_init();
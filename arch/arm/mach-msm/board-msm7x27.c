@@ -23,6 +23,7 @@
 #include <linux/delay.h>
 #include <linux/bootmem.h>
 #include <linux/power_supply.h>
+#include <linux/workqueue.h>
 
 
 #include <mach/hardware.h>
@@ -1467,13 +1468,27 @@ static struct platform_device *devices[] __initdata = {
 	&android_pmem_audio_device,
 	&msm_fb_device,
 	&lcdc_gordon_panel_device,
+	&msm_device_pmic_leds,
+	&msm_device_snd,
+	&msm_device_adspdec,
+#ifdef CONFIG_ARCH_MSM7X27
+	&msm_device_kgsl,
+#endif
+	&hs_device,
+	&msm_batt_device,
+};
+
+/* Devices whose drivers are not needed until well after the UI is up
+ * (bluetooth uart, camera sensors, tsif).  They are registered from a
+ * worker once the initcalls have finished, so their synchronous probes
+ * stay off the cold-boot critical path.  Not __initdata: the worker
+ * may run after init memory has been freed.
+ */
+static struct platform_device *late_devices[] = {
 	&msm_device_uart_dm1,
 #ifdef CONFIG_BT
 	&msm_bt_power_device,
 #endif
-	&msm_device_pmic_leds,
-	&msm_device_snd,
-	&msm_device_adspdec,
 #ifdef CONFIG_MT9T013
 	&msm_camera_sensor_mt9t013,
 #endif
@@ -1493,16 +1508,28 @@ static struct platform_device *devices[] __initdata = {
 	&msm_camera_sensor_vb6801,
 #endif
 	&msm_bluesleep_device,
-#ifdef CONFIG_ARCH_MSM7X27
-	&msm_device_kgsl,
-#endif
 #if defined(CONFIG_TSIF) || defined(CONFIG_TSIF_MODULE)
 	&msm_device_tsif,
 #endif
-	&hs_device,
-	&msm_batt_device,
 };
 
+static void msm7x2x_register_late_devices(struct work_struct *work)
+{
+	platform_add_devices(late_devices, ARRAY_SIZE(late_devices));
+}
+static DECLARE_WORK(late_devices_work, msm7x2x_register_late_devices);
+
+static int __init msm7x2x_late_devices_init(void)
+{
+	if (!machine_is_msm7x25_surf() && !machine_is_msm7x25_ffa() &&
+	    !machine_is_msm7x27_surf() && !machine_is_msm7x27_ffa())
+		return 0;
+
+	schedule_work(&late_devices_work);
+	return 0;
+}
+late_initcall(msm7x2x_late_devices_init);
+
 static struct msm_panel_common_pdata mdp_pdata = {
 	.gpio = 97,
 };
@@ -0,0 +1,144 @@
+/* arch/arm/mach-msm/bootcal.c
+ *
+ * Persistent boot calibration cache.
+ *
+ * Copyright (C) 2011 LGE, Inc.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * Hardware settling waits on the boot and clock switch paths (PLL lock,
+ * regulator ramp, panel power-up) are normally sized for the worst case.
+ * Where the hardware gives us feedback about when the operation actually
+ * completed, the measured time can be remembered here and used (instead
+ * of the worst case) on the next boot.
+ *
+ * The cache lives in a small reserved-RAM block next to the ram_console
+ * region, so like ram_console it survives warm reboots but not a cold
+ * power-up.  A magic/CRC check rejects cold or corrupted contents, in
+ * which case callers simply keep their conservative defaults and the
+ * cache is rebuilt from fresh measurements.
+ */
+
+#include <linux/kernel.h>
+#include <linux/init.h>
+#include <linux/io.h>
+#include <linux/spinlock.h>
+#include <linux/crc32.h>
+
+#include <mach/bootcal.h>
+
+#define BOOTCAL_MAGIC		0x42434131	/* 'BCA1' */
+#define BOOTCAL_VERSION		1
+#define BOOTCAL_MAX_RECORDS	64
+
+struct bootcal_record {
+	uint32_t key;
+	uint32_t value_us;
+};
+
+struct bootcal_block {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t count;
+	uint32_t crc;
+	struct bootcal_record rec[BOOTCAL_MAX_RECORDS];
+};
+
+static struct bootcal_block *bootcal;
+static DEFINE_SPINLOCK(bootcal_lock);
+
+static uint32_t bootcal_crc(struct bootcal_block *blk)
+{
+	return crc32_le(~0, (unsigned char *)blk->rec,
+			blk->count * sizeof(blk->rec[0]));
+}
+
+/*
+ * Look up a previously measured value.  Returns -ENOENT when the cache
+ * is unavailable or has no entry for the key; the caller then uses its
+ * conservative default.  Safe from atomic context.
+ */
+int bootcal_get(uint32_t key, uint32_t *value_us)
+{
+	unsigned long flags;
+	uint32_t i;
+	int ret = -ENOENT;
+
+	spin_lock_irqsave(&bootcal_lock, flags);
+	if (!bootcal)
+		goto out;
+	for (i = 0; i < bootcal->count; i++) {
+		if (bootcal->rec[i].key == key) {
+			*value_us = bootcal->rec[i].value_us;
+			ret = 0;
+			break;
+		}
+	}
+out:
+	spin_unlock_irqrestore(&bootcal_lock, flags);
+	return ret;
+}
+
+/*
+ * Record a measured value for the next boot.  Safe from atomic context.
+ */
+void bootcal_set(uint32_t key, uint32_t value_us)
+{
+	unsigned long flags;
+	uint32_t i;
+
+	spin_lock_irqsave(&bootcal_lock, flags);
+	if (!bootcal)
+		goto out;
+	for (i = 0; i < bootcal->count; i++)
+		if (bootcal->rec[i].key == key)
+			break;
+	if (i == bootcal->count) {
+		if (i == BOOTCAL_MAX_RECORDS)
+			goto out;
+		bootcal->count = i + 1;
+	} else if (bootcal->rec[i].value_us == value_us) {
+		goto out;
+	}
+	bootcal->rec[i].key = key;
+	bootcal->rec[i].value_us = value_us;
+	bootcal->crc = bootcal_crc(bootcal);
+out:
+	spin_unlock_irqrestore(&bootcal_lock, flags);
+}
+
+void __init bootcal_init(unsigned long phys, unsigned long size)
+{
+	struct bootcal_block *blk;
+
+	if (size < sizeof(*blk)) {
+		pr_err("bootcal: region too small (%lu bytes)\n", size);
+		return;
+	}
+
+	blk = ioremap(phys, size);
+	if (!blk) {
+		pr_err("bootcal: failed to map region at %08lx\n", phys);
+		return;
+	}
+
+	if (blk->magic != BOOTCAL_MAGIC || blk->version != BOOTCAL_VERSION ||
+	    blk->count > BOOTCAL_MAX_RECORDS || blk->crc != bootcal_crc(blk)) {
+		pr_info("bootcal: no valid calibration data, starting fresh\n");
+		blk->count = 0;
+		blk->crc = bootcal_crc(blk);
+		blk->version = BOOTCAL_VERSION;
+		blk->magic = BOOTCAL_MAGIC;
+	} else {
+		pr_info("bootcal: %u cached value(s)\n", blk->count);
+	}
+
+	bootcal = blk;
+}
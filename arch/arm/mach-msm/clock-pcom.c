@@ -17,6 +17,8 @@
 #include <linux/ctype.h>
 #include <linux/stddef.h>
 #include <linux/spinlock.h>
+#include <linux/jiffies.h>
+#include <linux/workqueue.h>
 
 #include <mach/clk.h>
 
@@ -29,6 +31,11 @@
 struct clk_pcom {
 	unsigned count;
 	bool always_on;
+	/* remote clock still held after the last local disable */
+	bool deferred;
+	unsigned long release_at;
+	/* last rate reported by or accepted by the modem; 0 = unknown */
+	unsigned cached_rate;
 };
 
 static struct clk_pcom pcom_clocks[P_NR_CLKS] = {
@@ -38,6 +45,43 @@ static struct clk_pcom pcom_clocks[P_NR_CLKS] = {
 
 static DEFINE_SPINLOCK(pc_clk_lock);
 
+/* How long the modem keeps a clock on after the last local disable.
+ * mdp and kgsl toggle their clocks per frame, so immediate re-enable is
+ * the common case; holding the remote clock over the gap turns the
+ * disable/enable round trip pair into no proc_comm traffic at all.
+ */
+#define PC_CLK_RELEASE_DELAY	msecs_to_jiffies(100)
+
+static void pc_clk_release_worker(struct work_struct *work);
+static DECLARE_DELAYED_WORK(pc_clk_release_work, pc_clk_release_worker);
+
+static void pc_clk_release_worker(struct work_struct *work)
+{
+	unsigned long flags;
+	unsigned id;
+	int again = 0;
+
+	spin_lock_irqsave(&pc_clk_lock, flags);
+	for (id = 0; id < P_NR_CLKS; id++) {
+		struct clk_pcom *clk = &pcom_clocks[id];
+		unsigned tmp = id;
+
+		if (!clk->deferred)
+			continue;
+		if (time_is_after_jiffies(clk->release_at)) {
+			again = 1;
+			continue;
+		}
+		clk->deferred = false;
+		msm_proc_comm(PCOM_CLKCTL_RPC_DISABLE, &tmp, NULL);
+	}
+	spin_unlock_irqrestore(&pc_clk_lock, flags);
+
+	if (again)
+		schedule_delayed_work(&pc_clk_release_work,
+				      PC_CLK_RELEASE_DELAY);
+}
+
 /*
  * glue for the proc_comm interface
  */
@@ -52,14 +96,20 @@ int pc_clk_enable(unsigned id)
 
 	spin_lock_irqsave(&pc_clk_lock, flags);
 	if (clk->count == 0) {
-		rc = msm_proc_comm(PCOM_CLKCTL_RPC_ENABLE, &id, NULL);
-		if (rc < 0)
-			goto unlock;
-		else if ((int)id < 0) {
-			rc = -EINVAL;
-			goto unlock;
-		} else
+		if (clk->deferred) {
+			/* still held remotely from the grace period */
+			clk->deferred = false;
 			rc = 0;
+		} else {
+			rc = msm_proc_comm(PCOM_CLKCTL_RPC_ENABLE, &id, NULL);
+			if (rc < 0)
+				goto unlock;
+			else if ((int)id < 0) {
+				rc = -EINVAL;
+				goto unlock;
+			} else
+				rc = 0;
+		}
 	}
 	clk->count++;
 unlock:
@@ -79,8 +129,12 @@ void pc_clk_disable(unsigned id)
 	if (WARN_ON(clk->count == 0))
 		goto out;
 	clk->count--;
-	if (clk->count == 0)
-		msm_proc_comm(PCOM_CLKCTL_RPC_DISABLE, &id, NULL);
+	if (clk->count == 0) {
+		clk->deferred = true;
+		clk->release_at = jiffies + PC_CLK_RELEASE_DELAY;
+		schedule_delayed_work(&pc_clk_release_work,
+				      PC_CLK_RELEASE_DELAY + 1);
+	}
 out:
 	spin_unlock_irqrestore(&pc_clk_lock, flags);
 }
@@ -91,8 +145,11 @@ void pc_clk_auto_off(unsigned id)
 	struct clk_pcom *clk = &pcom_clocks[id];
 
 	spin_lock_irqsave(&pc_clk_lock, flags);
-	if (clk->count == 0)
+	if (clk->count == 0) {
+		/* auto_off means really off, grace period or not */
+		clk->deferred = false;
 		msm_proc_comm(PCOM_CLKCTL_RPC_DISABLE, &id, NULL);
+	}
 	spin_unlock_irqrestore(&pc_clk_lock, flags);
 }
 
@@ -113,15 +170,24 @@ int pc_clk_reset(unsigned id, enum clk_reset_action action)
 
 int pc_clk_set_rate(unsigned id, unsigned rate)
 {
+	struct clk_pcom *clk = &pcom_clocks[id];
+	int rc;
+
 	/* The rate _might_ be rounded off to the nearest KHz value by the
 	 * remote function. So a return value of 0 doesn't necessarily mean
 	 * that the exact rate was set successfully.
 	 */
-	int rc = msm_proc_comm(PCOM_CLKCTL_RPC_SET_RATE, &id, &rate);
+	rc = msm_proc_comm(PCOM_CLKCTL_RPC_SET_RATE, &id, &rate);
 	if (rc < 0)
 		return rc;
-	else
-		return (int)id < 0 ? -EINVAL : 0;
+	else if ((int)id < 0)
+		return -EINVAL;
+
+	/* the modem may have rounded the rate, so the cached value is
+	 * only refilled by the next real query
+	 */
+	clk->cached_rate = 0;
+	return 0;
 }
 
 int pc_clk_set_min_rate(unsigned id, unsigned rate)
@@ -130,6 +196,9 @@ int pc_clk_set_min_rate(unsigned id, unsigned rate)
 	bool ignore_error = (cpu_is_msm7x27() && id == P_EBI1_CLK &&
 				rate >= INT_MAX);
 
+	/* a new floor can move the actual rate */
+	pcom_clocks[id].cached_rate = 0;
+
 	rc = msm_proc_comm(PCOM_CLKCTL_RPC_MIN_RATE, &id, &rate);
 	if (rc < 0)
 		return rc;
@@ -141,7 +210,12 @@ int pc_clk_set_min_rate(unsigned id, unsigned rate)
 
 int pc_clk_set_max_rate(unsigned id, unsigned rate)
 {
-	int rc = msm_proc_comm(PCOM_CLKCTL_RPC_MAX_RATE, &id, &rate);
+	int rc;
+
+	/* a new ceiling can move the actual rate */
+	pcom_clocks[id].cached_rate = 0;
+
+	rc = msm_proc_comm(PCOM_CLKCTL_RPC_MAX_RATE, &id, &rate);
 	if (rc < 0)
 		return rc;
 	else
@@ -159,10 +233,20 @@ int pc_clk_set_flags(unsigned id, unsigned flags)
 
 unsigned pc_clk_get_rate(unsigned id)
 {
+	struct clk_pcom *clk = &pcom_clocks[id];
+
+	/* Only the apps side changes these clocks, so the last answer
+	 * stays good until a local set_rate invalidates it.  Drivers
+	 * that query the rate per frame then skip the round trip.
+	 */
+	if (clk->cached_rate)
+		return clk->cached_rate;
+
 	if (msm_proc_comm(PCOM_CLKCTL_RPC_RATE, &id, NULL))
 		return 0;
-	else
-		return id;
+
+	clk->cached_rate = id;
+	return id;
 }
 
 unsigned pc_clk_is_enabled(unsigned id)
@@ -89,6 +89,17 @@ struct daldevice_handle {;
 	struct mutex client_lock;
 };
 
+/* An asynchronous call in flight.  The remote echoes hdr.from back as
+ * the reply's hdr.to, so giving each call its own handle (and its own
+ * message buffer) allows multiple outstanding calls per client. */
+struct dalrpc_async_call {
+	struct list_head list;
+
+	struct dalrpc_msg msg;
+	void (*complete_fn)(void *context, uint32_t result);
+	void *context;
+};
+
 struct dalrpc_port {
 	struct list_head list;
 
@@ -103,6 +114,7 @@ struct dalrpc_port {
 
 	struct dalrpc_msg msg_in;
 	struct daldevice_handle *msg_owner;
+	struct dalrpc_async_call *msg_async;
 	unsigned msg_bytes_read;
 
 	struct list_head event_list;
@@ -116,6 +128,11 @@ static LIST_HEAD(port_list);
 static LIST_HEAD(client_list);
 static DEFINE_MUTEX(pc_lists_lock);
 
+/* outstanding async calls; a spinlock so calls can be issued from the
+ * completion callback, which runs with pc_lists_lock held */
+static LIST_HEAD(async_call_list);
+static DEFINE_SPINLOCK(async_call_lock);
+
 static DECLARE_WAIT_QUEUE_HEAD(event_wq);
 
 static int client_exists(void *handle)
@@ -154,6 +171,25 @@ static int client_exists_locked(void *handle)
 	return 0;
 }
 
+static struct dalrpc_async_call *async_call_find(void *handle)
+{
+	struct dalrpc_async_call *call;
+	unsigned long flags;
+
+	if (!handle)
+		return NULL;
+
+	spin_lock_irqsave(&async_call_lock, flags);
+	list_for_each_entry(call, &async_call_list, list)
+		if (call == handle) {
+			spin_unlock_irqrestore(&async_call_lock, flags);
+			return call;
+		}
+	spin_unlock_irqrestore(&async_call_lock, flags);
+
+	return NULL;
+}
+
 static int port_exists(struct dalrpc_port *p)
 {
 	struct dalrpc_port *p_iter;
@@ -277,9 +313,24 @@ static void process_asynch(struct dalrpc_port *p)
 
 static void process_msg(struct dalrpc_port *p)
 {
+	struct dalrpc_async_call *call;
+	unsigned long flags;
+
 	switch (p->msg_in.hdr.msgid) {
 
 	case DALRPC_MSGID_DDI_REPLY:
+		if (p->msg_async) {
+			call = p->msg_async;
+			spin_lock_irqsave(&async_call_lock, flags);
+			list_del(&call->list);
+			spin_unlock_irqrestore(&async_call_lock, flags);
+			if (call->complete_fn)
+				call->complete_fn(call->context,
+						  call->msg.param[0]);
+			kfree(call);
+			break;
+		}
+		/* fall through: synchronous reply */
 	case DALRPC_MSGID_ATTACH_REPLY:
 	case DALRPC_MSGID_DETACH_REPLY:
 		complete(&p->msg_owner->read_completion);
@@ -311,18 +362,32 @@ static void flush_msg(struct dalrpc_port *p)
 
 static int check_header(struct dalrpc_port *p)
 {
+	struct daldevice_handle *owner = NULL;
+	struct dalrpc_async_call *call = NULL;
+
+	if (p->msg_in.hdr.msgid != DALRPC_MSGID_ASYNCH) {
+		if (client_exists_locked(p->msg_in.hdr.to))
+			owner = (struct daldevice_handle *)p->msg_in.hdr.to;
+		else
+			call = async_call_find(p->msg_in.hdr.to);
+	}
+
 	if (check_version(&p->msg_in.hdr) ||
 	    p->msg_in.hdr.len > DALRPC_MAX_MSG_SIZE ||
 	    (p->msg_in.hdr.msgid != DALRPC_MSGID_ASYNCH &&
-	     !client_exists_locked(p->msg_in.hdr.to))) {
+	     !owner && !call)) {
 		printk(KERN_ERR "dalrpc_read_msg: bad msg\n");
 		flush_msg(p);
 		return 1;
 	}
-	p->msg_owner = (struct daldevice_handle *)p->msg_in.hdr.to;
+	p->msg_owner = owner;
+	p->msg_async = call;
 
-	if (p->msg_in.hdr.msgid != DALRPC_MSGID_ASYNCH)
-		memcpy(&p->msg_owner->msg.hdr, &p->msg_in.hdr,
+	if (call)
+		memcpy(&call->msg.hdr, &p->msg_in.hdr,
+		       sizeof(p->msg_in.hdr));
+	else if (owner)
+		memcpy(&owner->msg.hdr, &p->msg_in.hdr,
 		       sizeof(p->msg_in.hdr));
 
 	return 0;
@@ -350,10 +415,12 @@ static int dalrpc_read_msg(struct dalrpc_port *p)
 	}
 
 	/* read remainder of msg */
-	if (p->msg_in.hdr.msgid != DALRPC_MSGID_ASYNCH)
-		read_ptr = (uint8_t *)&p->msg_owner->msg;
-	else
+	if (p->msg_in.hdr.msgid == DALRPC_MSGID_ASYNCH)
 		read_ptr = (uint8_t *)&p->msg_in;
+	else if (p->msg_async)
+		read_ptr = (uint8_t *)&p->msg_async->msg;
+	else
+		read_ptr = (uint8_t *)&p->msg_owner->msg;
 	read_ptr += p->msg_bytes_read;
 
 	while (p->msg_bytes_read < p->msg_in.hdr.len) {
@@ -368,6 +435,7 @@ static int dalrpc_read_msg(struct dalrpc_port *p)
 	process_msg(p);
 	p->msg_bytes_read = 0;
 	p->msg_owner = NULL;
+	p->msg_async = NULL;
 
 	return 1;
 }
@@ -431,6 +499,7 @@ static struct dalrpc_port *dalrpc_port_open(char *port, int cpu)
 	INIT_LIST_HEAD(&p->cb_list);
 
 	p->msg_owner = NULL;
+	p->msg_async = NULL;
 	p->msg_bytes_read = 0;
 
 	if (smd_named_open_on_edge(port, cpu, &p->ch, p,
@@ -470,6 +539,51 @@ static void dalrpc_sendwait(struct daldevice_handle *h)
 		wait_for_completion(&h->read_completion);
 }
 
+/* Queue an async call and push it down the channel without waiting for
+ * the reply, so back-to-back calls batch up in the smd fifo and
+ * pipeline instead of serializing on round trips.  The caller fills in
+ * len, ddi_idx, proto_id and the parameters; ownership of the call
+ * passes to the receive worker, which frees it after running the
+ * completion callback. */
+static int dalrpc_async_dispatch(struct daldevice_handle *h,
+				 struct dalrpc_async_call *call)
+{
+	u8 *buf = (u8 *)&call->msg;
+	int len = call->msg.hdr.len;
+	int written = 0;
+	unsigned long flags;
+
+	call->msg.hdr.proto_ver = DALRPC_PROTOCOL_VERSION;
+	call->msg.hdr.prio = 0;
+	call->msg.hdr.async = 0;
+	call->msg.hdr.msgid = DALRPC_MSGID_DDI;
+	call->msg.hdr.from = call;
+	call->msg.hdr.to = h->remote_handle;
+
+	spin_lock_irqsave(&async_call_lock, flags);
+	list_add_tail(&call->list, &async_call_list);
+	spin_unlock_irqrestore(&async_call_lock, flags);
+
+	mutex_lock(&h->port->write_lock);
+	do {
+		written = smd_write(h->port->ch,
+				    buf + (call->msg.hdr.len - len), len);
+		if (written < 0)
+			break;
+		len -= written;
+	} while (len);
+	mutex_unlock(&h->port->write_lock);
+
+	if (written < 0) {
+		spin_lock_irqsave(&async_call_lock, flags);
+		list_del(&call->list);
+		spin_unlock_irqrestore(&async_call_lock, flags);
+		return written;
+	}
+
+	return 0;
+}
+
 int daldevice_attach(uint32_t device_id, char *port, int cpu,
 		     void **handle_ptr)
 {
@@ -1204,6 +1318,70 @@ uint32_t dalrpc_fcn_15(uint32_t ddi_idx, void *handle, const void *ibuf,
 }
 EXPORT_SYMBOL(dalrpc_fcn_15);
 
+int dalrpc_fcn_0_async(uint32_t ddi_idx, void *handle, uint32_t s1,
+		       void (*complete_fn)(void *context, uint32_t result),
+		       void *context)
+{
+	struct daldevice_handle *h = handle;
+	struct dalrpc_async_call *call;
+	int ret;
+
+	if (!client_exists(h))
+		return -EINVAL;
+
+	call = kzalloc(sizeof(struct dalrpc_async_call), GFP_KERNEL);
+	if (!call)
+		return -ENOMEM;
+
+	call->complete_fn = complete_fn;
+	call->context = context;
+	call->msg.hdr.len = sizeof(struct dalrpc_msg_hdr) + 4;
+	call->msg.hdr.ddi_idx = ddi_idx;
+	call->msg.hdr.proto_id = 0;
+	call->msg.param[0] = s1;
+
+	ret = dalrpc_async_dispatch(h, call);
+	if (ret < 0)
+		kfree(call);
+	return ret;
+}
+EXPORT_SYMBOL(dalrpc_fcn_0_async);
+
+int dalrpc_fcn_5_async(uint32_t ddi_idx, void *handle, const void *ibuf,
+		       uint32_t ilen,
+		       void (*complete_fn)(void *context, uint32_t result),
+		       void *context)
+{
+	struct daldevice_handle *h = handle;
+	struct dalrpc_async_call *call;
+	int ret;
+
+	if ((ilen + 4) > DALRPC_MAX_PARAMS_SIZE)
+		return -EINVAL;
+
+	if (!client_exists(h))
+		return -EINVAL;
+
+	call = kzalloc(sizeof(struct dalrpc_async_call), GFP_KERNEL);
+	if (!call)
+		return -ENOMEM;
+
+	call->complete_fn = complete_fn;
+	call->context = context;
+	call->msg.hdr.len = sizeof(struct dalrpc_msg_hdr) + 4 +
+		ROUND_BUFLEN(ilen);
+	call->msg.hdr.ddi_idx = ddi_idx;
+	call->msg.hdr.proto_id = 5;
+	call->msg.param[0] = ilen;
+	memcpy(&call->msg.param[1], ibuf, ilen);
+
+	ret = dalrpc_async_dispatch(h, call);
+	if (ret < 0)
+		kfree(call);
+	return ret;
+}
+EXPORT_SYMBOL(dalrpc_fcn_5_async);
+
 void *dalrpc_alloc_event(void *handle)
 {
 	struct daldevice_handle *h;
@@ -15,6 +15,7 @@
  */
 
 #include <linux/clk.h>
+#include <linux/delay.h>
 #include <linux/err.h>
 #include <linux/io.h>
 #include <linux/interrupt.h>
@@ -369,17 +370,20 @@ static void start_ready_cmds(int adm)
 	for (i = 0; i < MSM_DMOV_CHANNEL_COUNT; i++) {
 		rdy = &dmov_conf[adm].ready_commands[i];
 		act = &dmov_conf[adm].active_commands[i];
-		cmd = list_entry(rdy->next, typeof(*cmd), list);
-		if (!list_empty(rdy) && !check_crci_conflict(cmd, adm)) {
+		/* fill the command-pointer FIFO as far as it will go */
+		while (!list_empty(rdy)) {
+			cmd = list_entry(rdy->next, typeof(*cmd), list);
+			if (check_crci_conflict(cmd, adm))
+				break;
 			status = readl(DMOV_REG(DMOV_STATUS(i), adm));
-			if (status & DMOV_STATUS_CMD_PTR_RDY) {
-				list_del(&cmd->list);
-				list_add_tail(&cmd->list, act);
-				dmov_conf[adm].channel_active |= (1 << i);
-				set_crci_mask(cmd->crci_mask, adm);
-				writel(cmd->cmdptr,
-				       DMOV_REG(DMOV_CMD_PTR(i), adm));
-			}
+			if (!(status & DMOV_STATUS_CMD_PTR_RDY))
+				break;
+			list_del(&cmd->list);
+			list_add_tail(&cmd->list, act);
+			dmov_conf[adm].channel_active |= (1 << i);
+			set_crci_mask(cmd->crci_mask, adm);
+			writel(cmd->cmdptr,
+			       DMOV_REG(DMOV_CMD_PTR(i), adm));
 		}
 	}
 #endif
@@ -402,6 +406,7 @@ void msm_dmov_enqueue_cmd_ext(unsigned id, struct msm_dmov_cmd *cmd)
 #endif
 	status = readl(DMOV_REG(DMOV_STATUS(ch), adm));
 	if ((status & DMOV_STATUS_CMD_PTR_RDY) &&
+	    list_empty(&dmov_conf[adm].ready_commands[ch]) &&
 	    (!check_crci_conflict(cmd, adm))) {
 		PRINT_IO("msm_dmov_enqueue_cmd(%d), start command, status %x\n",
 			id, status);
@@ -505,6 +510,69 @@ int msm_dmov_exec_cmd(unsigned id, unsigned int crci_mask, unsigned int cmdptr)
 }
 EXPORT_SYMBOL(msm_dmov_exec_cmd);
 
+/* Polled variant of msm_dmov_exec_cmd() for the panic path: no locks,
+ * no interrupts, no scheduler.  The caller must guarantee the rest of
+ * the system is stopped.  Results of commands that were in flight when
+ * the system died are discarded without updating the driver's queue
+ * bookkeeping, so normal operation cannot be resumed afterwards.
+ */
+int msm_dmov_exec_cmd_poll(unsigned id, unsigned int crci_mask,
+			   unsigned int cmdptr)
+{
+	int adm = DMOV_ID_TO_ADM(id);
+	int ch = DMOV_ID_TO_CHAN(id);
+	unsigned int status;
+	unsigned int result = 0;
+	unsigned long irq_flags;
+	int i;
+
+	local_irq_save(irq_flags);
+#ifndef CONFIG_MSM_ADM3
+	if (clk_ctl == CLK_DIS && msm_dmov_clk_toggle(1)) {
+		local_irq_restore(irq_flags);
+		return -EIO;
+	}
+	/* leave the clocks on, we are not coming back */
+	clk_ctl = CLK_EN;
+#endif
+	/* drain whatever was queued when the system died */
+	for (i = 0; i < 100000; i++) {
+		status = readl(DMOV_REG(DMOV_STATUS(ch), adm));
+		while (status & DMOV_STATUS_RSLT_VALID) {
+			readl(DMOV_REG(DMOV_RSLT(ch), adm));
+			status = readl(DMOV_REG(DMOV_STATUS(ch), adm));
+		}
+		if (status & DMOV_STATUS_CMD_PTR_RDY)
+			break;
+		udelay(10);
+	}
+	if (!(status & DMOV_STATUS_CMD_PTR_RDY)) {
+		local_irq_restore(irq_flags);
+		PRINT_ERROR("msm_dmov_exec_cmd_poll(%d): channel stuck, "
+			    "status %x\n", id, status);
+		return -EBUSY;
+	}
+
+	writel(cmdptr, DMOV_REG(DMOV_CMD_PTR(ch), adm));
+	for (i = 0; i < 100000; i++) {
+		status = readl(DMOV_REG(DMOV_STATUS(ch), adm));
+		if (status & DMOV_STATUS_RSLT_VALID) {
+			result = readl(DMOV_REG(DMOV_RSLT(ch), adm));
+			break;
+		}
+		udelay(10);
+	}
+	local_irq_restore(irq_flags);
+
+	if (result != 0x80000002) {
+		PRINT_ERROR("msm_dmov_exec_cmd_poll(%d): ERROR, result: %x\n",
+			    id, result);
+		return -EIO;
+	}
+	return 0;
+}
+EXPORT_SYMBOL(msm_dmov_exec_cmd_poll);
+
 static void fill_errdata(struct msm_dmov_errdata *errdata, int ch, int adm)
 {
 	errdata->flush[0] = readl(DMOV_REG(DMOV_FLUSH0(ch), adm));
@@ -596,7 +664,12 @@ static irqreturn_t msm_datamover_irq_handler(int irq, void *dev_id)
 			ch_status = readl(DMOV_REG(DMOV_STATUS(ch), adm));
 #ifndef CONFIG_MSM_ADM3
 			PRINT_FLOW("msm_datamover_irq_handler id %d, status %x\n", id, ch_status);
-			if ((ch_status & DMOV_STATUS_CMD_PTR_RDY) &&
+			/* refill the channel's command-pointer FIFO as
+			 * far as it will go, so queued back-to-back
+			 * transfers chain in hardware instead of waiting
+			 * for one interrupt per command
+			 */
+			while ((ch_status & DMOV_STATUS_CMD_PTR_RDY) &&
 			    !list_empty(&dmov_conf[adm].ready_commands[ch])) {
 				cmd = list_entry(dmov_conf[adm].
 					ready_commands[ch].next, typeof(*cmd),
@@ -609,6 +682,8 @@ static irqreturn_t msm_datamover_irq_handler(int irq, void *dev_id)
 				PRINT_FLOW("msm_datamover_irq_handler id %d, start command\n", id);
 				writel(cmd->cmdptr, DMOV_REG(DMOV_CMD_PTR(ch),
 					adm));
+				ch_status = readl(DMOV_REG(DMOV_STATUS(ch),
+					adm));
 			}
 #endif
 		} while (ch_status & DMOV_STATUS_RSLT_VALID);
@@ -605,6 +605,44 @@ int msm_gpios_disable(const struct msm_gpio *table, int size)
 }
 EXPORT_SYMBOL(msm_gpios_disable);
 
+int msm_gpios_set_outputs(const struct msm_gpio_out *table, int size)
+{
+	int i, n;
+
+	for (i = 0; i < ARRAY_SIZE(msm_gpio_chips); i++) {
+		struct msm_gpio_chip *msm_chip = &msm_gpio_chips[i];
+		unsigned first = msm_chip->chip.base;
+		unsigned last = first + msm_chip->chip.ngpio - 1;
+		unsigned set = 0, clr = 0;
+		unsigned long irq_flags;
+		unsigned val;
+
+		for (n = 0; n < size; n++) {
+			if (table[n].gpio < first || table[n].gpio > last)
+				continue;
+			if (table[n].value)
+				set |= BIT(table[n].gpio - first);
+			else
+				clr |= BIT(table[n].gpio - first);
+		}
+		if (!(set | clr))
+			continue;
+
+		/* one OUT and one OE update per bank instead of a
+		 * read-modify-write pair per pin
+		 */
+		spin_lock_irqsave(&msm_chip->lock, irq_flags);
+		val = readl(msm_chip->regs.out);
+		writel((val | set) & ~clr, msm_chip->regs.out);
+		val = readl(msm_chip->regs.oe);
+		writel(val | set | clr, msm_chip->regs.oe);
+		spin_unlock_irqrestore(&msm_chip->lock, irq_flags);
+	}
+
+	return 0;
+}
+EXPORT_SYMBOL(msm_gpios_set_outputs);
+
 /* Locate the GPIO_OUT register for the given GPIO and return its address
  * and the bit position of the gpio's bit within the register.
  *
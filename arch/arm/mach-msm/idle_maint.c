@@ -0,0 +1,198 @@
+/* arch/arm/mach-msm/idle_maint.c
+ *
+ * Opportunistic idle-time maintenance.
+ *
+ * Background housekeeping (flash garbage collection and the like) is
+ * normally driven by per-daemon polling timers, which wake the CPU out
+ * of low power states at their own pace and fight the governor.  This
+ * file lets such daemons register short bounded work items instead.
+ * arch_idle() calls idle_maint_idle_enter() once the idle period has
+ * been predicted; if the prediction covers the cost of a pending item
+ * while the clocks are still up, the maintenance thread is woken and
+ * the idle loop falls straight back out to run it.  The system re-idles
+ * into the deep sleep modes afterwards with the housekeeping already
+ * paid for.
+ *
+ * Copyright (C) 2011 LGE, Inc.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/kthread.h>
+#include <linux/sched.h>
+#include <linux/delay.h>
+#include <linux/spinlock.h>
+#include <linux/idle_maint.h>
+
+/* Headroom factor applied to an item's declared cost before the
+ * predicted idle time is considered long enough to cover it.
+ */
+#define IDLE_MAINT_COST_MARGIN 2
+
+static DEFINE_SPINLOCK(idle_maint_lock);
+static LIST_HEAD(idle_maint_list);
+static struct task_struct *idle_maint_task;
+static atomic_t idle_maint_nr_pending;
+static atomic_t idle_maint_kicked;
+
+static unsigned int idle_maint_kicks;
+module_param_named(kicks, idle_maint_kicks, uint, S_IRUGO);
+static unsigned int idle_maint_runs;
+module_param_named(runs, idle_maint_runs, uint, S_IRUGO);
+
+void idle_maint_register(struct idle_maint_work *work)
+{
+	unsigned long flags;
+
+	work->pending = 0;
+	work->busy = 0;
+
+	spin_lock_irqsave(&idle_maint_lock, flags);
+	list_add_tail(&work->link, &idle_maint_list);
+	spin_unlock_irqrestore(&idle_maint_lock, flags);
+}
+EXPORT_SYMBOL(idle_maint_register);
+
+void idle_maint_unregister(struct idle_maint_work *work)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&idle_maint_lock, flags);
+	if (work->pending) {
+		work->pending = 0;
+		atomic_dec(&idle_maint_nr_pending);
+	}
+	list_del(&work->link);
+	spin_unlock_irqrestore(&idle_maint_lock, flags);
+
+	/* wait out a run() still in flight on this item */
+	while (work->busy)
+		msleep(1);
+}
+EXPORT_SYMBOL(idle_maint_unregister);
+
+void idle_maint_request(struct idle_maint_work *work)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&idle_maint_lock, flags);
+	if (!work->pending) {
+		work->pending = 1;
+		atomic_inc(&idle_maint_nr_pending);
+	}
+	spin_unlock_irqrestore(&idle_maint_lock, flags);
+}
+EXPORT_SYMBOL(idle_maint_request);
+
+/* Called from arch_idle() with interrupts disabled, idle_time_ns being
+ * the predicted length of the idle period about to start.  Returns
+ * nonzero if the maintenance thread was woken, in which case the caller
+ * should skip the sleep modes and let the idle loop reschedule.
+ */
+int idle_maint_idle_enter(int64_t idle_time_ns)
+{
+	struct idle_maint_work *work;
+	int kick = 0;
+
+	if (!atomic_read(&idle_maint_nr_pending) || idle_maint_task == NULL)
+		return 0;
+
+	/* an earlier kick has not been consumed yet */
+	if (atomic_read(&idle_maint_kicked))
+		return 0;
+
+	spin_lock(&idle_maint_lock);
+	list_for_each_entry(work, &idle_maint_list, link) {
+		if (work->pending && (int64_t)work->cost_us * 1000 *
+				IDLE_MAINT_COST_MARGIN <= idle_time_ns) {
+			kick = 1;
+			break;
+		}
+	}
+	spin_unlock(&idle_maint_lock);
+
+	if (kick) {
+		idle_maint_kicks++;
+		atomic_inc(&idle_maint_kicked);
+		wake_up_process(idle_maint_task);
+	}
+	return kick;
+}
+
+static int idle_maint_thread(void *data)
+{
+	struct idle_maint_work *work;
+	struct idle_maint_work *pos;
+	unsigned long flags;
+	int more;
+
+	set_user_nice(current, 19);
+
+	while (!kthread_should_stop()) {
+		/* run one bounded increment per idle kick; a re-requested
+		 * item waits for the next idle period instead of hogging
+		 * the CPU back-to-back
+		 */
+		set_current_state(TASK_INTERRUPTIBLE);
+		if (!atomic_read(&idle_maint_kicked)) {
+			schedule();
+			continue;
+		}
+		__set_current_state(TASK_RUNNING);
+		atomic_dec(&idle_maint_kicked);
+
+		work = NULL;
+		spin_lock_irqsave(&idle_maint_lock, flags);
+		list_for_each_entry(pos, &idle_maint_list, link) {
+			if (pos->pending) {
+				work = pos;
+				break;
+			}
+		}
+		if (work) {
+			/* rotate so the other items get their turn */
+			list_move_tail(&work->link, &idle_maint_list);
+			work->pending = 0;
+			work->busy = 1;
+			atomic_dec(&idle_maint_nr_pending);
+		}
+		spin_unlock_irqrestore(&idle_maint_lock, flags);
+
+		if (work) {
+			idle_maint_runs++;
+			more = work->run(work);
+			smp_mb();
+			work->busy = 0;
+			if (more)
+				idle_maint_request(work);
+		}
+
+		cond_resched();
+	}
+	return 0;
+}
+
+static int __init idle_maint_init(void)
+{
+	struct task_struct *task;
+
+	task = kthread_run(idle_maint_thread, NULL, "idle_maint");
+	if (IS_ERR(task)) {
+		printk(KERN_ERR "idle_maint: failed to start thread\n");
+		return PTR_ERR(task);
+	}
+	idle_maint_task = task;
+	return 0;
+}
+core_initcall(idle_maint_init);
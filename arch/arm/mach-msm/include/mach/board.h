@@ -327,6 +327,14 @@ struct msm_i2c_platform_data {
 	void (*msm_i2c_config_gpio)(int iface, int config_type);
 };
 
+/* Asynchronous transfer submission on the MSM i2c adapters, see
+ * drivers/i2c/busses/i2c-msm.c */
+struct i2c_adapter;
+struct i2c_msg;
+int msm_i2c_xfer_async(struct i2c_adapter *adap, struct i2c_msg *msgs,
+		       int num, void (*complete)(void *context, int result),
+		       void *context);
+
 enum msm_ssbi_controller_type {
 	MSM_SBI_CTRL_SSBI = 0,
 	MSM_SBI_CTRL_SSBI2,
@@ -32,6 +32,8 @@
  */
 #define MSM7X27_EBI1_CS0_BASE	PHYS_OFFSET
 #define LGE_RAM_CONSOLE_SIZE    (128 * SZ_1K * 2)
+/* boot calibration cache sits right after the ram_console region */
+#define LGE_BOOTCAL_SIZE        SZ_4K
 #endif
 
 /* define PMEM address size */
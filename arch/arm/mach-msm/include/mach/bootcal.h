@@ -0,0 +1,44 @@
+/* arch/arm/mach-msm/include/mach/bootcal.h
+ *
+ * Persistent boot calibration cache.
+ *
+ * Copyright (C) 2011 LGE, Inc.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef __ASM_ARCH_MSM_BOOTCAL_H
+#define __ASM_ARCH_MSM_BOOTCAL_H
+
+#include <linux/types.h>
+#include <linux/errno.h>
+#include <linux/init.h>
+
+/*
+ * Calibration keys.  Values are stored in microseconds.  Keep the key
+ * numbers stable across kernel versions: the cache in RAM outlives the
+ * kernel that wrote it across a warm reboot.
+ */
+#define BOOTCAL_KEY_ACPU_VDD	1	/* A11S VDD plevel switch settle */
+
+#ifdef CONFIG_MSM_BOOTCAL
+int bootcal_get(uint32_t key, uint32_t *value_us);
+void bootcal_set(uint32_t key, uint32_t value_us);
+void __init bootcal_init(unsigned long phys, unsigned long size);
+#else
+static inline int bootcal_get(uint32_t key, uint32_t *value_us)
+{
+	return -ENOENT;
+}
+static inline void bootcal_set(uint32_t key, uint32_t value_us) { }
+static inline void bootcal_init(unsigned long phys, unsigned long size) { }
+#endif
+
+#endif /* __ASM_ARCH_MSM_BOOTCAL_H */
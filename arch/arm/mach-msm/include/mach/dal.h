@@ -71,7 +71,8 @@ int daldevice_attach(uint32_t device_id, char *port, int cpu,
 		     void **handle_ptr);
 
 /* The caller must ensure there are no outstanding dalrpc calls on
- * the client before (and while) calling daldevice_detach. */
+ * the client, synchronous or asynchronous, before (and while) calling
+ * daldevice_detach. */
 int daldevice_detach(void *handle);
 
 uint32_t dalrpc_fcn_0(uint32_t ddi_idx, void *handle, uint32_t s1);
@@ -112,6 +113,21 @@ uint32_t dalrpc_fcn_15(uint32_t ddi_idx, void *handle, const void *ibuf,
 		       void *obuf, uint32_t olen, uint32_t *oalen,
 		       void *obuf2, uint32_t olen2);
 
+/* Asynchronous variants of the input-only protocols.  The call is
+ * dispatched without waiting for the reply, so a handle may have any
+ * number of calls outstanding and independent calls pipeline over the
+ * channel instead of serializing on round trips.  Returns 0 once the
+ * call is queued; complete_fn later runs from the port's receive worker
+ * with the remote status word.  It may issue further dalrpc calls but
+ * must not attach or detach devices and must not block for long. */
+int dalrpc_fcn_0_async(uint32_t ddi_idx, void *handle, uint32_t s1,
+		       void (*complete_fn)(void *context, uint32_t result),
+		       void *context);
+int dalrpc_fcn_5_async(uint32_t ddi_idx, void *handle, const void *ibuf,
+		       uint32_t ilen,
+		       void (*complete_fn)(void *context, uint32_t result),
+		       void *context);
+
 static inline uint32_t daldevice_info(void *handle,
 				      struct daldevice_info_t *info,
 				      uint32_t info_size)
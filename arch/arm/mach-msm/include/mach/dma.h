@@ -39,6 +39,8 @@ void msm_dmov_enqueue_cmd_ext(unsigned id, struct msm_dmov_cmd *cmd);
 void msm_dmov_stop_cmd(unsigned id, struct msm_dmov_cmd *cmd, int graceful);
 void msm_dmov_flush(unsigned int id);
 int msm_dmov_exec_cmd(unsigned id, unsigned int crci_mask, unsigned int cmdptr);
+int msm_dmov_exec_cmd_poll(unsigned id, unsigned int crci_mask,
+			   unsigned int cmdptr);
 unsigned int msm_dmov_build_crci_mask(int n, ...);
 
 #define DMOV_CRCIS_PER_CONF 10
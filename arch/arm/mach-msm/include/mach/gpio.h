@@ -116,6 +116,28 @@ int msm_gpios_enable(const struct msm_gpio *table, int size);
  */
 int msm_gpios_disable(const struct msm_gpio *table, int size);
 
+/**
+ * struct msm_gpio_out - precomputed output level for one GPIO
+ * @gpio:  gpio number
+ * @value: output level to drive
+ */
+struct msm_gpio_out {
+	unsigned gpio;
+	unsigned value;
+};
+
+/**
+ * msm_gpios_set_outputs() - drive a set of GPIOs as outputs in batch
+ *
+ * Folds the table into a single OUT and OE update per bank instead of
+ * a read-modify-write pair per pin.  Intended for board suspend/resume
+ * sleep configs where per-pin writes add up.
+ *
+ * @table: GPIO output table
+ * @size:  number of entries in @table
+ */
+int msm_gpios_set_outputs(const struct msm_gpio_out *table, int size);
+
 /**
  * msm_gpios_show_resume_irq() - show the interrupts that could have triggered
  * resume
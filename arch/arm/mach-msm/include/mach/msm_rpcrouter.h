@@ -278,6 +278,13 @@ struct msm_rpc_server
 
 	uint32_t version;
 
+	/* per-program request queue; calls for one program stay ordered
+	 * while independent programs are dispatched concurrently
+	 */
+	struct workqueue_struct *workqueue;
+	struct task_struct *req_task;
+	uint32_t current_xid;
+
 	int (*rpc_call)(struct msm_rpc_server *server,
 			struct rpc_request_hdr *req, unsigned len);
 
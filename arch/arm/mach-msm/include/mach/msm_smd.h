@@ -103,4 +103,17 @@ void smd_enable_read_intr(smd_channel_t *ch);
  */
 void smd_disable_read_intr(smd_channel_t *ch);
 
+/* Coalesce data-path doorbells to the remote processor: instead of one
+ * interrupt per write, pending doorbells are latched and a short flush
+ * timer raises a single interrupt for the whole burst.  Worth enabling
+ * on channels with bursty traffic (RIL, QMI); channel state changes
+ * are always signalled immediately.
+ */
+void smd_enable_doorbell_coalesce(smd_channel_t *ch);
+
+/* Turn doorbell coalescing back off, raising any latched doorbell
+ * immediately.
+ */
+void smd_disable_doorbell_coalesce(smd_channel_t *ch);
+
 #endif
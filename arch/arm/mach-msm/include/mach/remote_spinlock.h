@@ -189,6 +189,16 @@ static inline void __raw_remote_dek_spin_unlock(raw_remote_spinlock_t *lock)
 	lock->dek.self_lock = DEK_LOCK_YIELD;
 }
 
+/* Contention statistics: callers that want their remote lock profiled
+ * register a stats slot by name and record acquisition wait and hold
+ * times (in microseconds) while still holding the lock.  The collected
+ * histograms are exposed through the smd debugfs directory. */
+struct remote_spinlock_stats;
+struct remote_spinlock_stats *remote_spinlock_stats_register(const char *name);
+void remote_spinlock_stats_record(struct remote_spinlock_stats *s,
+				  uint32_t wait_us, uint32_t hold_us);
+int remote_spinlock_stats_fill(char *buf, int max);
+
 #ifdef CONFIG_MSM_SMD
 int _remote_spin_lock_init(remote_spinlock_id_t, _remote_spinlock_t *lock);
 #else
@@ -26,4 +26,18 @@ int vreg_enable(struct vreg *vreg);
 int vreg_disable(struct vreg *vreg);
 int vreg_set_level(struct vreg *vreg, unsigned mv);
 
+/*
+ * One step of a batched power-up sequence: set the named regulator to
+ * mv (0 = leave the level alone), enable it, and consider the rail
+ * usable settle_us after the enable.  Steps must be independent rails;
+ * see vreg_sequence_enable().
+ */
+struct vreg_seq_step {
+	const char *name;
+	unsigned mv;
+	unsigned settle_us;
+};
+
+int vreg_sequence_enable(const struct vreg_seq_step *steps, int nsteps);
+
 #endif
@@ -20,6 +20,20 @@
 
 int lcd_bl_power_state;
 
+/* output levels applied in one batch per transition, one register
+ * update per gpio bank instead of one per pin */
+static const struct msm_gpio_out thunderc_sleep_gpios[] = {
+	{ GPIO_LCD_MAKER_LOW, 0 },
+	{ GPIO_LCD_RESET_N,   0 },
+};
+
+static const struct msm_gpio_out thunderc_wake_gpios[] = {
+	{ GPIO_LCD_BL_EN,   1 },
+	{ GPIO_BL_I2C_SCL,  1 },
+	{ GPIO_BL_I2C_SDA,  1 },
+	{ GPIO_LCD_RESET_N, 0 },
+};
+
 int thunderc_pwrsink_suspend_noirq(struct device *dev)
 {
 	printk(KERN_INFO"%s: configure gpio for suspend\n", __func__);
@@ -40,11 +54,12 @@ int thunderc_pwrsink_suspend_noirq(struct device *dev)
 //	gpio_tlmm_config(GPIO_CFG(GPIO_LCD_VSYNC_O, 0, GPIO_INPUT, GPIO_PULL_DOWN, GPIO_2MA), GPIO_ENABLE);
 
 	gpio_tlmm_config(GPIO_CFG(GPIO_LCD_MAKER_LOW, 0, GPIO_OUTPUT, GPIO_NO_PULL, GPIO_2MA), GPIO_ENABLE);
-	gpio_direction_output(GPIO_LCD_MAKER_LOW, 0);
 
 	gpio_tlmm_config(GPIO_CFG(GPIO_LCD_RESET_N, 0, GPIO_OUTPUT, GPIO_PULL_DOWN, GPIO_2MA), GPIO_ENABLE);
-	gpio_direction_output(GPIO_LCD_RESET_N, 0);
-	
+
+	msm_gpios_set_outputs(thunderc_sleep_gpios,
+			      ARRAY_SIZE(thunderc_sleep_gpios));
+
 	lcd_bl_power_state = BL_POWER_SUSPEND;
 
 	camera_power_mutex_unlock();
@@ -65,21 +80,20 @@ int thunderc_pwrsink_resume_noirq(struct device *dev)
 	}
 
 	gpio_tlmm_config(GPIO_CFG(GPIO_LCD_BL_EN, 0, GPIO_OUTPUT, GPIO_NO_PULL, GPIO_2MA), GPIO_ENABLE);
-	gpio_direction_output(GPIO_LCD_BL_EN, 1);
 
 	gpio_tlmm_config(GPIO_CFG(GPIO_BL_I2C_SCL, 0, GPIO_OUTPUT, GPIO_NO_PULL, GPIO_2MA), GPIO_ENABLE);
-	gpio_direction_output(GPIO_BL_I2C_SCL, 1);
 
 	gpio_tlmm_config(GPIO_CFG(GPIO_BL_I2C_SDA, 0, GPIO_OUTPUT, GPIO_NO_PULL, GPIO_2MA), GPIO_ENABLE);
-	gpio_direction_output(GPIO_BL_I2C_SDA, 1);
 
 //	gpio_tlmm_config(GPIO_CFG(GPIO_LCD_VSYNC_O, 0, GPIO_INPUT, GPIO_PULL_DOWN, GPIO_2MA), GPIO_ENABLE);
 
 	gpio_tlmm_config(GPIO_CFG(GPIO_LCD_MAKER_LOW, 0, GPIO_INPUT, GPIO_PULL_UP, GPIO_2MA), GPIO_ENABLE);
 
 	gpio_tlmm_config(GPIO_CFG(GPIO_LCD_RESET_N, 0, GPIO_OUTPUT, GPIO_NO_PULL, GPIO_2MA), GPIO_ENABLE);
-	gpio_direction_output(GPIO_LCD_RESET_N, 0);
-	
+
+	msm_gpios_set_outputs(thunderc_wake_gpios,
+			      ARRAY_SIZE(thunderc_wake_gpios));
+
 	lcd_bl_power_state = BL_POWER_RESUME;
 
 	camera_power_mutex_unlock();
@@ -90,21 +104,20 @@ int thunderc_pwrsink_resume_noirq(struct device *dev)
 void thunderc_pwrsink_resume()
 {
 	gpio_tlmm_config(GPIO_CFG(GPIO_LCD_BL_EN, 0, GPIO_OUTPUT, GPIO_NO_PULL, GPIO_2MA), GPIO_ENABLE);
-	gpio_direction_output(GPIO_LCD_BL_EN, 1);
 
 	gpio_tlmm_config(GPIO_CFG(GPIO_BL_I2C_SCL, 0, GPIO_OUTPUT, GPIO_NO_PULL, GPIO_2MA), GPIO_ENABLE);
-	gpio_direction_output(GPIO_BL_I2C_SCL, 1);
 
 	gpio_tlmm_config(GPIO_CFG(GPIO_BL_I2C_SDA, 0, GPIO_OUTPUT, GPIO_NO_PULL, GPIO_2MA), GPIO_ENABLE);
-	gpio_direction_output(GPIO_BL_I2C_SDA, 1);
 
 //	gpio_tlmm_config(GPIO_CFG(GPIO_LCD_VSYNC_O, 0, GPIO_INPUT, GPIO_PULL_DOWN, GPIO_2MA), GPIO_ENABLE);
 
 	gpio_tlmm_config(GPIO_CFG(GPIO_LCD_MAKER_LOW, 0, GPIO_INPUT, GPIO_PULL_UP, GPIO_2MA), GPIO_ENABLE);
 
 	gpio_tlmm_config(GPIO_CFG(GPIO_LCD_RESET_N, 0, GPIO_OUTPUT, GPIO_NO_PULL, GPIO_2MA), GPIO_ENABLE);
-	gpio_direction_output(GPIO_LCD_RESET_N, 0);
-	
+
+	msm_gpios_set_outputs(thunderc_wake_gpios,
+			      ARRAY_SIZE(thunderc_wake_gpios));
+
 	lcd_bl_power_state = BL_POWER_RESUME;
 }
 
@@ -33,6 +33,7 @@
 #include <mach/msm_hsusb.h>
 #include <mach/rpc_hsusb.h>
 #include <mach/rpc_pmapp.h>
+#include <mach/bootcal.h>
 #include <linux/android_pmem.h>
 #ifdef CONFIG_ARCH_MSM7X27
 #include <linux/msm_kgsl.h>
@@ -119,8 +120,12 @@ void __init lge_add_ramconsole_devices(void)
 	res->end = res->start + LGE_RAM_CONSOLE_SIZE - 1;
 	printk("RAM CONSOLE START ADDR : %d\n", res->start);
 	printk("RAM CONSOLE END ADDR   : %d\n", res->end);
-	
+
 	platform_device_register(&ram_console_device);
+
+	/* the boot calibration cache shares the reserved area with
+	 * ram_console so it survives warm reboots the same way */
+	bootcal_init(res->end + 1, LGE_BOOTCAL_SIZE);
 }
 
 __WEAK struct lge_panic_handler_platform_data panic_handler_data;
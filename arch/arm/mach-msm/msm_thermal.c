@@ -0,0 +1,177 @@
+/* arch/arm/mach-msm/msm_thermal.c
+ *
+ * Graduated thermal throttling of the apps CPU.
+ *
+ * Copyright (C) 2011 LGE, Inc.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * Userspace throttling off the PMIC temperature alarm is a cliff: the
+ * alarm fires once and the policy hard-caps the clock, which is visible
+ * as stutter.  Instead, poll the board thermistor (the msm_therm ADC
+ * channel) from the kernel and walk a table of frequency caps one step
+ * at a time, with hysteresis on the way back up, so the device degrades
+ * gradually and recovers without bouncing.
+ *
+ * The cap is applied through a cpufreq policy notifier, so it composes
+ * with whatever governor and user limits are active.  All knobs are
+ * module parameters (visible under /sys/module/msm_thermal/parameters).
+ */
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/workqueue.h>
+#include <linux/completion.h>
+#include <linux/cpufreq.h>
+#include <linux/m_adc.h>
+
+#define MSM_THERMAL_MAX_STEPS	4
+
+static int enabled = 1;
+module_param(enabled, int, 0644);
+MODULE_PARM_DESC(enabled, "0 disables throttling (any active cap is lifted)");
+
+static int poll_ms = 1000;
+module_param(poll_ms, int, 0644);
+MODULE_PARM_DESC(poll_ms, "sensor polling interval in ms");
+
+static int hysteresis = 5;
+module_param(hysteresis, int, 0644);
+MODULE_PARM_DESC(hysteresis, "degC below a threshold before a step is lifted");
+
+/* Step i engages at temp_degc[i] and caps the policy at max_khz[i].
+ * Unused tail entries stay at zero.  Thresholds must ascend and caps
+ * descend; the table is validated once at init.
+ */
+static int temp_degc[MSM_THERMAL_MAX_STEPS] = { 60, 70, 80 };
+module_param_array(temp_degc, int, NULL, 0644);
+MODULE_PARM_DESC(temp_degc, "throttle step thresholds in degC");
+
+static int max_khz[MSM_THERMAL_MAX_STEPS] = { 600000, 480000, 245760 };
+module_param_array(max_khz, int, NULL, 0644);
+MODULE_PARM_DESC(max_khz, "frequency cap in kHz per throttle step");
+
+static int nsteps;
+static void *adc_handle;
+static int cur_step;		/* 0 = unthrottled, N = N caps engaged */
+static unsigned int cur_cap;	/* kHz; 0 = no cap */
+
+static void msm_thermal_check(struct work_struct *work);
+static DECLARE_DELAYED_WORK(check_work, msm_thermal_check);
+
+static int msm_thermal_get_temp(int *temp)
+{
+	struct adc_chan_result result;
+	struct completion conv_done;
+	int rc;
+
+	if (!adc_handle) {
+		rc = adc_channel_open(CHANNEL_ADC_MSM_THERM, &adc_handle);
+		if (rc) {
+			adc_handle = NULL;
+			return rc;
+		}
+	}
+
+	init_completion(&conv_done);
+	rc = adc_channel_request_conv(adc_handle, &conv_done);
+	if (rc)
+		return rc;
+	wait_for_completion(&conv_done);
+	rc = adc_channel_read_result(adc_handle, &result);
+	if (rc)
+		return rc;
+
+	*temp = (int)result.physical;
+	return 0;
+}
+
+static int msm_thermal_cpufreq_notify(struct notifier_block *nb,
+				      unsigned long event, void *data)
+{
+	struct cpufreq_policy *policy = data;
+
+	if (event == CPUFREQ_ADJUST && cur_cap)
+		cpufreq_verify_within_limits(policy, 0, cur_cap);
+
+	return NOTIFY_OK;
+}
+
+static struct notifier_block msm_thermal_cpufreq_nb = {
+	.notifier_call = msm_thermal_cpufreq_notify,
+};
+
+static void msm_thermal_set_step(int step)
+{
+	int cpu;
+
+	cur_step = step;
+	cur_cap = step ? max_khz[step - 1] : 0;
+
+	pr_info("msm_thermal: %s, cap %u kHz\n",
+		step ? "throttling" : "unthrottled", cur_cap);
+
+	for_each_online_cpu(cpu)
+		cpufreq_update_policy(cpu);
+}
+
+static void msm_thermal_check(struct work_struct *work)
+{
+	int temp, step = cur_step;
+
+	if (!enabled) {
+		if (cur_step)
+			msm_thermal_set_step(0);
+		goto resched;
+	}
+
+	/* the ADC comes up well after us; keep retrying quietly */
+	if (msm_thermal_get_temp(&temp))
+		goto resched;
+
+	/* one step per poll in either direction to avoid big jumps */
+	if (step < nsteps && temp >= temp_degc[step])
+		step++;
+	else if (step > 0 && temp <= temp_degc[step - 1] - hysteresis)
+		step--;
+
+	if (step != cur_step)
+		msm_thermal_set_step(step);
+
+resched:
+	schedule_delayed_work(&check_work, msecs_to_jiffies(poll_ms));
+}
+
+static int __init msm_thermal_init(void)
+{
+	int i;
+
+	for (i = 0; i < MSM_THERMAL_MAX_STEPS; i++) {
+		if (!temp_degc[i] || !max_khz[i])
+			break;
+		if (i && (temp_degc[i] <= temp_degc[i - 1] ||
+			  max_khz[i] >= max_khz[i - 1])) {
+			pr_err("msm_thermal: bad step table at entry %d\n", i);
+			return -EINVAL;
+		}
+	}
+	nsteps = i;
+	if (!nsteps) {
+		pr_err("msm_thermal: empty step table\n");
+		return -EINVAL;
+	}
+
+	cpufreq_register_notifier(&msm_thermal_cpufreq_nb,
+				  CPUFREQ_POLICY_NOTIFIER);
+	schedule_delayed_work(&check_work, msecs_to_jiffies(poll_ms));
+	return 0;
+}
+late_initcall(msm_thermal_init);
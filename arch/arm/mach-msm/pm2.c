@@ -30,9 +30,13 @@
 #include <linux/io.h>
 #include <linux/memory.h>
 #include <linux/console.h>
+#ifdef CONFIG_CPU_IDLE
+#include <linux/tick.h>
+#endif
 #ifdef CONFIG_HAS_WAKELOCK
 #include <linux/wakelock.h>
 #endif
+#include <linux/idle_maint.h>
 #include <mach/msm_iomap.h>
 #include <mach/system.h>
 #ifdef CONFIG_CPU_V7
@@ -64,6 +68,7 @@
 #include "gpio.h"
 #include "timer.h"
 #include "pm.h"
+#include "cpuidle.h"
 #include "spm.h"
 #include "sirc.h"
 
@@ -1404,6 +1409,22 @@ void arch_idle(void)
 	msm_pm_add_stat(MSM_PM_STAT_REQUESTED_IDLE, timer_expiration);
 #endif /* CONFIG_MSM_IDLE_STATS */
 
+	/*
+	 * If the predicted idle period is long enough to pay for a
+	 * pending maintenance increment, hand it over while the clocks
+	 * are still up instead of sleeping: running the work now means
+	 * its daemon does not wake us out of power collapse later on
+	 * its own timer.  Waking the worker makes a task runnable, so
+	 * skip the sleep modes and let the idle loop reschedule.
+	 */
+	if (idle_maint_idle_enter(timer_expiration)) {
+		low_power = 0;
+#ifdef CONFIG_MSM_IDLE_STATS
+		exit_stat = MSM_PM_STAT_IDLE_SPIN;
+#endif /* CONFIG_MSM_IDLE_STATS */
+		goto arch_idle_exit;
+	}
+
 	for (i = 0; i < ARRAY_SIZE(allow); i++)
 		allow[i] = true;
 
@@ -1582,6 +1603,186 @@ arch_idle_exit:
 #endif /* CONFIG_MSM_IDLE_STATS */
 }
 
+#ifdef CONFIG_CPU_IDLE
+/******************************************************************************
+ * CPUidle Hooks
+ *****************************************************************************/
+
+/* Sleep modes exported as C-states.  The board latency/residency table
+ * (msm_pm_modes) prices each state for the menu governor; MSM_PM_MODE()
+ * collapses to the bare mode number on these UP targets.
+ */
+static struct msm_cpuidle_state msm_pm_cstates[] = {
+	{0, 0, "C0", "wfi",
+		MSM_PM_SLEEP_MODE_WAIT_FOR_INTERRUPT},
+	{0, 1, "C1", "ramp-down-and-wfi",
+		MSM_PM_SLEEP_MODE_RAMP_DOWN_AND_WAIT_FOR_INTERRUPT},
+	{0, 2, "C2", "standalone-power-collapse",
+		MSM_PM_SLEEP_MODE_POWER_COLLAPSE_STANDALONE},
+	{0, 3, "C3", "power-collapse",
+		MSM_PM_SLEEP_MODE_POWER_COLLAPSE},
+};
+
+/* Smallest total time observed in each sleep mode.  When the wakeup
+ * interrupt arrives during entry this converges on the mode's real
+ * entry + exit overhead, which is the number to check the board
+ * latency table against.  Read-only diagnostics; the governor keeps
+ * using the configured latencies.
+ */
+static uint32_t msm_pm_idle_measured_min_us[MSM_PM_SLEEP_MODE_NR];
+module_param_array_named(idle_measured_min_us,
+	msm_pm_idle_measured_min_us, uint, NULL, S_IRUGO);
+
+/*
+ * Veto sleep modes that the coming idle period cannot use.  The menu
+ * governor handles latency QoS and predicted-residency pruning from the
+ * per-state latency/residency values; this hook only applies the gates
+ * it cannot know about: modem handshake readiness, pending-interrupt
+ * bookkeeping and idle wake locks.
+ */
+int msm_pm_idle_prepare(struct cpuidle_device *dev)
+{
+	int64_t sleep_ns = ktime_to_ns(tick_nohz_get_sleep_length());
+	int i;
+
+	for (i = 0; i < dev->state_count; i++) {
+		struct cpuidle_state *state = &dev->states[i];
+		enum msm_pm_sleep_mode mode =
+			(enum msm_pm_sleep_mode) state->driver_data;
+		struct msm_pm_platform_data *pm_mode = &msm_pm_modes[mode];
+		bool allow = pm_mode->supported && pm_mode->idle_enabled;
+
+		if (mode == MSM_PM_SLEEP_MODE_POWER_COLLAPSE) {
+			struct msm_pm_platform_data *no_xo = &msm_pm_modes[
+				MSM_PM_SLEEP_MODE_POWER_COLLAPSE_NO_XO_SHUTDOWN];
+
+			if (!allow)
+				allow = no_xo->supported &&
+					no_xo->idle_enabled;
+
+			if ((sleep_ns < msm_pm_idle_sleep_min_time) ||
+#ifdef CONFIG_HAS_WAKELOCK
+				has_wake_lock(WAKE_LOCK_IDLE) ||
+#endif
+				!msm_irq_idle_sleep_allowed() ||
+				msm_pm_modem_busy())
+				allow = false;
+		}
+
+		if (allow)
+			state->flags &= ~CPUIDLE_FLAG_IGNORE;
+		else
+			state->flags |= CPUIDLE_FLAG_IGNORE;
+	}
+
+	return 0;
+}
+
+/*
+ * Enter the sleep mode the governor picked.  Mirrors the corresponding
+ * arm of arch_idle(); returns the time spent in the mode, in
+ * microseconds, for the governor's prediction bookkeeping.
+ */
+int msm_pm_idle_enter(enum msm_pm_sleep_mode sleep_mode)
+{
+	int64_t timer_expiration;
+	int64_t time;
+	uint32_t us;
+	int low_power = 0;
+	int ret;
+#ifdef CONFIG_MSM_IDLE_STATS
+	int exit_stat = MSM_PM_STAT_IDLE_SPIN;
+#endif
+
+	timer_expiration = msm_timer_enter_idle();
+	time = ktime_to_ns(ktime_get());
+
+	switch (sleep_mode) {
+	case MSM_PM_SLEEP_MODE_WAIT_FOR_INTERRUPT:
+		msm_pm_swfi(false);
+#ifdef CONFIG_MSM_IDLE_STATS
+		exit_stat = MSM_PM_STAT_IDLE_WFI;
+#endif
+		break;
+
+	case MSM_PM_SLEEP_MODE_RAMP_DOWN_AND_WAIT_FOR_INTERRUPT:
+		ret = msm_pm_swfi(true);
+		if (ret)
+			while (!msm_irq_pending())
+				udelay(1);
+#ifdef CONFIG_MSM_IDLE_STATS
+		exit_stat = ret ? MSM_PM_STAT_IDLE_SPIN : MSM_PM_STAT_IDLE_WFI;
+#endif
+		break;
+
+	case MSM_PM_SLEEP_MODE_POWER_COLLAPSE_STANDALONE:
+		ret = msm_pm_power_collapse_standalone();
+#ifdef CONFIG_MSM_IDLE_STATS
+		exit_stat = ret ?
+			MSM_PM_STAT_IDLE_FAILED_STANDALONE_POWER_COLLAPSE :
+			MSM_PM_STAT_IDLE_STANDALONE_POWER_COLLAPSE;
+#endif
+		break;
+
+	case MSM_PM_SLEEP_MODE_POWER_COLLAPSE: {
+		uint32_t sleep_limit = SLEEP_LIMIT_NONE;
+		uint32_t sleep_delay;
+
+#ifdef CONFIG_CLOCK_BASED_SLEEP_LIMIT
+		if (msm_clock_require_tcxo(NULL, 0))
+			sleep_limit = SLEEP_LIMIT_NO_TCXO_SHUTDOWN;
+#endif
+		if (!msm_pm_modes[MSM_PM_SLEEP_MODE_POWER_COLLAPSE].
+				idle_enabled)
+			sleep_limit = SLEEP_LIMIT_NO_TCXO_SHUTDOWN;
+
+#if defined(CONFIG_MSM_MEMORY_LOW_POWER_MODE_IDLE_ACTIVE)
+		sleep_limit |= SLEEP_RESOURCE_MEMORY_BIT1;
+#elif defined(CONFIG_MSM_MEMORY_LOW_POWER_MODE_IDLE_RETENTION)
+		sleep_limit |= SLEEP_RESOURCE_MEMORY_BIT0;
+#endif
+
+		sleep_delay = (uint32_t) msm_pm_convert_and_cap_time(
+			timer_expiration, MSM_PM_SLEEP_TICK_LIMIT);
+		if (sleep_delay == 0) /* 0 would mean infinite time */
+			sleep_delay = 1;
+
+		ret = msm_pm_power_collapse(true, sleep_delay, sleep_limit);
+		low_power = (ret != -EBUSY && ret != -ETIMEDOUT);
+#ifdef CONFIG_MSM_IDLE_STATS
+		exit_stat = ret ? MSM_PM_STAT_IDLE_FAILED_POWER_COLLAPSE :
+			MSM_PM_STAT_IDLE_POWER_COLLAPSE;
+#endif
+		break;
+	}
+
+	default:
+		printk(KERN_ERR "%s: invalid sleep mode %d\n",
+			__func__, sleep_mode);
+		while (!msm_irq_pending())
+			udelay(1);
+		break;
+	}
+
+	msm_timer_exit_idle(low_power);
+
+	time = ktime_to_ns(ktime_get()) - time;
+#ifdef CONFIG_MSM_IDLE_STATS
+	msm_pm_add_stat(exit_stat, time);
+#endif
+
+	do_div(time, 1000);
+	us = (uint32_t) time;
+
+	if (sleep_mode < MSM_PM_SLEEP_MODE_NR &&
+		(!msm_pm_idle_measured_min_us[sleep_mode] ||
+		 us < msm_pm_idle_measured_min_us[sleep_mode]))
+		msm_pm_idle_measured_min_us[sleep_mode] = us;
+
+	return (int) us;
+}
+#endif /* CONFIG_CPU_IDLE */
+
 /*
  * Suspend the Apps processor.
  *
@@ -1953,6 +2154,15 @@ static int __init msm_pm_init(void)
 	atomic_set(&msm_pm_init_done, 1);
 	suspend_set_ops(&msm_pm_ops);
 
+#ifdef CONFIG_CPU_IDLE
+	/* When the cpuidle driver registers it takes over pm_idle;
+	 * arch_idle() remains the fallback if registration fails.
+	 */
+	msm_cpuidle_set_states(msm_pm_cstates, ARRAY_SIZE(msm_pm_cstates),
+		msm_pm_modes);
+	msm_cpuidle_init();
+#endif
+
 	msm_pm_mode_sysfs_add();
 #ifdef CONFIG_MSM_IDLE_STATS
 	d_entry = create_proc_entry("msm_pm_stats",
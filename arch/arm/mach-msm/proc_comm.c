@@ -52,6 +52,13 @@ static inline void notify_other_proc_comm(void)
 #define MDM_DATA1   0x18
 #define MDM_DATA2   0x1C
 
+/* proc_comm is entered from process context, irqs-off paths (power
+ * collapse, modem reset) and interrupt context alike.  Any wait for a
+ * turn that the current owner must run to give up deadlocks here: an
+ * irqs-off caller can interrupt the owner and then spin on it forever.
+ * So the gate has to be the classic irqs-off spinlock, even though it
+ * costs irq-off time for the duration of the command.
+ */
 static DEFINE_SPINLOCK(proc_comm_lock);
 
 /* Poll for a state change, checking for possible
@@ -145,7 +152,7 @@ crash:
 	//	extern int get_status_hidden_reset();
 		int ret;
 		spin_unlock_irqrestore(&proc_comm_lock, flags);
-	
+
 		if (LG_ErrorHandler_enable) // check using proc_comm after arm9 crash 
 			return 0;
 		
@@ -20,6 +20,8 @@
 #include <linux/kernel.h>
 #include <linux/string.h>
 #include <linux/delay.h>
+#include <linux/spinlock.h>
+#include <linux/bitops.h>
 
 #include <asm/system.h>
 
@@ -31,6 +33,107 @@
 #define SMEM_SPINLOCK_COUNT 8
 #define SMEM_SPINLOCK_ARRAY_SIZE (SMEM_SPINLOCK_COUNT * sizeof(uint32_t))
 
+/* Contention statistics for remote spinlocks.  The remote side can
+ * hold a lock for milliseconds during concurrent modem activity, which
+ * shows up here as long waits; the histograms separate time spent
+ * spinning on the remote owner from our own hold times.
+ */
+#define RSPIN_STATS_MAX 4
+#define RSPIN_HIST_BUCKETS 10
+
+struct remote_spinlock_stats {
+	const char *name;
+	uint32_t count;
+	uint32_t wait_hist[RSPIN_HIST_BUCKETS];
+	uint32_t hold_hist[RSPIN_HIST_BUCKETS];
+	uint32_t max_wait_us;
+	uint32_t max_hold_us;
+};
+
+static struct remote_spinlock_stats rspin_stats[RSPIN_STATS_MAX];
+static int rspin_stats_cnt;
+static DEFINE_SPINLOCK(rspin_stats_lock);
+
+struct remote_spinlock_stats *remote_spinlock_stats_register(const char *name)
+{
+	struct remote_spinlock_stats *s = NULL;
+	unsigned long flags;
+	int i;
+
+	spin_lock_irqsave(&rspin_stats_lock, flags);
+	for (i = 0; i < rspin_stats_cnt; i++)
+		if (!strcmp(rspin_stats[i].name, name)) {
+			s = &rspin_stats[i];
+			break;
+		}
+	if (!s && rspin_stats_cnt < RSPIN_STATS_MAX) {
+		s = &rspin_stats[rspin_stats_cnt++];
+		s->name = name;
+	}
+	spin_unlock_irqrestore(&rspin_stats_lock, flags);
+
+	return s;
+}
+
+static int usecs_to_bucket(uint32_t us)
+{
+	int b = fls(us);
+
+	if (b >= RSPIN_HIST_BUCKETS)
+		b = RSPIN_HIST_BUCKETS - 1;
+	return b;
+}
+
+/* The caller must still hold the lock being accounted (and therefore
+ * its local spinlock), so updates to a given stats slot are serialized.
+ */
+void remote_spinlock_stats_record(struct remote_spinlock_stats *s,
+				  uint32_t wait_us, uint32_t hold_us)
+{
+	if (!s)
+		return;
+
+	s->count++;
+	s->wait_hist[usecs_to_bucket(wait_us)]++;
+	s->hold_hist[usecs_to_bucket(hold_us)]++;
+	if (wait_us > s->max_wait_us)
+		s->max_wait_us = wait_us;
+	if (hold_us > s->max_hold_us)
+		s->max_hold_us = hold_us;
+}
+
+static int rspin_hist_dump(char *buf, int max, int i,
+			   const char *what, uint32_t *hist)
+{
+	int b;
+
+	i += scnprintf(buf + i, max - i, "  %s:", what);
+	for (b = 0; b < RSPIN_HIST_BUCKETS; b++)
+		i += scnprintf(buf + i, max - i, " %u", hist[b]);
+	i += scnprintf(buf + i, max - i, "\n");
+	return i;
+}
+
+int remote_spinlock_stats_fill(char *buf, int max)
+{
+	int i = 0;
+	int n;
+
+	i += scnprintf(buf + i, max - i,
+		       "histogram buckets: <1us <2us <4us ... >=256us\n");
+	for (n = 0; n < rspin_stats_cnt; n++) {
+		struct remote_spinlock_stats *s = &rspin_stats[n];
+
+		i += scnprintf(buf + i, max - i,
+			       "%s: count %u max_wait %uus max_hold %uus\n",
+			       s->name, s->count,
+			       s->max_wait_us, s->max_hold_us);
+		i = rspin_hist_dump(buf, max, i, "wait", s->wait_hist);
+		i = rspin_hist_dump(buf, max, i, "hold", s->hold_hist);
+	}
+	return i;
+}
+
 static int remote_spinlock_smem_init(int id, _remote_spinlock_t *lock)
 {
 	_remote_spinlock_t spinlock_start;
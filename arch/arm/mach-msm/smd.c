@@ -31,6 +31,7 @@
 #include <linux/ctype.h>
 #include <linux/remote_spinlock.h>
 #include <linux/uaccess.h>
+#include <linux/hrtimer.h>
 #include <mach/msm_smd.h>
 #include <mach/msm_iomap.h>
 #include <mach/system.h>
@@ -312,11 +313,22 @@ struct smd_channel {
 	unsigned last_state;
 	void (*notify_other_cpu)(void);
 
+	/* doorbell coalescing: data-path interrupts to the remote
+	 * processor are latched and raised once per burst by the
+	 * flush timer instead of once per packet
+	 */
+	int doorbell_coalesce;
+	int doorbell_pending;
+	struct hrtimer doorbell_timer;
+
 	char name[20];
 	struct platform_device pdev;
 	unsigned type;
 };
 
+/* how long a latched doorbell may sit before the timer flushes it */
+#define SMD_DOORBELL_FLUSH_NS	(100 * NSEC_PER_USEC)
+
 static struct platform_device loopback_tty_pdev = {.name = "LOOPBACK_TTY"};
 
 static LIST_HEAD(smd_ch_closed_list);
@@ -415,6 +427,11 @@ static unsigned ch_read_buffer(struct smd_channel *ch, void **ptr)
 	unsigned tail = ch->recv->tail;
 	*ptr = (void *) (ch->recv_data + tail);
 
+	/* the producer published head after the payload; don't let the
+	 * payload reads be speculated ahead of the head read
+	 */
+	rmb();
+
 	if (tail <= head)
 		return head - tail;
 	else
@@ -430,6 +447,8 @@ static int read_intr_blocked(struct smd_channel *ch)
 static void ch_read_done(struct smd_channel *ch, unsigned count)
 {
 	BUG_ON(count > smd_stream_read_avail(ch));
+	/* finish consuming the payload before handing the space back */
+	mb();
 	ch->recv->tail = (ch->recv->tail + count) & ch->fifo_mask;
 	ch->send->fTAIL = 1;
 }
@@ -523,10 +542,43 @@ static unsigned ch_write_buffer(struct smd_channel *ch, void **ptr)
 static void ch_write_done(struct smd_channel *ch, unsigned count)
 {
 	BUG_ON(count > smd_stream_write_avail(ch));
+	/* make the payload visible before publishing the new head */
+	wmb();
 	ch->send->head = (ch->send->head + count) & ch->fifo_mask;
 	ch->send->fHEAD = 1;
 }
 
+static enum hrtimer_restart smd_doorbell_timer_func(struct hrtimer *timer)
+{
+	struct smd_channel *ch =
+		container_of(timer, struct smd_channel, doorbell_timer);
+
+	ch->doorbell_pending = 0;
+	ch->notify_other_cpu();
+	return HRTIMER_NORESTART;
+}
+
+/* Raise the data-path doorbell to the remote processor or, when
+ * coalescing is enabled on the channel, latch it and let the flush
+ * timer raise one interrupt for the whole burst.  The rings are
+ * single-producer/single-consumer, so losing a race on the pending
+ * flag only costs a redundant doorbell.
+ */
+static void ch_notify_other_cpu(struct smd_channel *ch)
+{
+	if (!ch->doorbell_coalesce) {
+		ch->notify_other_cpu();
+		return;
+	}
+
+	if (!ch->doorbell_pending) {
+		ch->doorbell_pending = 1;
+		hrtimer_start(&ch->doorbell_timer,
+			      ktime_set(0, SMD_DOORBELL_FLUSH_NS),
+			      HRTIMER_MODE_REL);
+	}
+}
+
 static void ch_set_state(struct smd_channel *ch, unsigned n)
 {
 	if (n == SMD_SS_OPENED) {
@@ -755,7 +807,7 @@ static int smd_stream_write(smd_channel_t *ch, const void *_data, int len,
 	}
 
 	if (orig_len - len)
-		ch->notify_other_cpu();
+		ch_notify_other_cpu(ch);
 
 	return orig_len - len;
 }
@@ -807,7 +859,7 @@ static int smd_stream_read(smd_channel_t *ch, void *data, int len, int user_buf)
 	r = ch_read(ch, data, len, user_buf);
 	if (r > 0)
 		if (!read_intr_blocked(ch))
-			ch->notify_other_cpu();
+			ch_notify_other_cpu(ch);
 
 	return r;
 }
@@ -826,7 +878,7 @@ static int smd_packet_read(smd_channel_t *ch, void *data, int len, int user_buf)
 	r = ch_read(ch, data, len, user_buf);
 	if (r > 0)
 		if (!read_intr_blocked(ch))
-			ch->notify_other_cpu();
+			ch_notify_other_cpu(ch);
 
 	spin_lock_irqsave(&smd_lock, flags);
 	ch->current_packet -= r;
@@ -850,7 +902,7 @@ static int smd_packet_read_from_cb(smd_channel_t *ch, void *data, int len,
 	r = ch_read(ch, data, len, user_buf);
 	if (r > 0)
 		if (!read_intr_blocked(ch))
-			ch->notify_other_cpu();
+			ch_notify_other_cpu(ch);
 
 	ch->current_packet -= r;
 	update_packet_state(ch);
@@ -930,6 +982,9 @@ static int smd_alloc_channel(struct smd_alloc_elm *alloc_elm)
 	else
 		ch->notify_other_cpu = notify_dsps_smd;
 
+	hrtimer_init(&ch->doorbell_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	ch->doorbell_timer.function = smd_doorbell_timer_func;
+
 	if (smd_is_packet(alloc_elm)) {
 		ch->read = smd_packet_read;
 		ch->write = smd_packet_write;
@@ -1005,6 +1060,9 @@ static int smd_alloc_loopback_channel(void)
 	ch->type = SMD_LOOPBACK_TYPE;
 	ch->notify_other_cpu = notify_loopback_smd;
 
+	hrtimer_init(&ch->doorbell_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	ch->doorbell_timer.function = smd_doorbell_timer_func;
+
 	ch->read = smd_stream_read;
 	ch->write = smd_stream_write;
 	ch->read_avail = smd_stream_read_avail;
@@ -1129,6 +1187,9 @@ int smd_close(smd_channel_t *ch)
 	if (ch == 0)
 		return -1;
 
+	/* flush any latched doorbell before tearing the channel down */
+	smd_disable_doorbell_coalesce(ch);
+
 	spin_lock_irqsave(&smd_lock, flags);
 	ch->notify = do_nothing_notify;
 	list_del(&ch->ch_list);
@@ -1205,6 +1266,27 @@ void smd_disable_read_intr(smd_channel_t *ch)
 }
 EXPORT_SYMBOL(smd_disable_read_intr);
 
+void smd_enable_doorbell_coalesce(smd_channel_t *ch)
+{
+	if (ch)
+		ch->doorbell_coalesce = 1;
+}
+EXPORT_SYMBOL(smd_enable_doorbell_coalesce);
+
+void smd_disable_doorbell_coalesce(smd_channel_t *ch)
+{
+	if (!ch)
+		return;
+
+	ch->doorbell_coalesce = 0;
+	hrtimer_cancel(&ch->doorbell_timer);
+	if (ch->doorbell_pending) {
+		ch->doorbell_pending = 0;
+		ch->notify_other_cpu();
+	}
+}
+EXPORT_SYMBOL(smd_disable_doorbell_coalesce);
+
 int smd_wait_until_readable(smd_channel_t *ch, int bytes)
 {
 	return -1;
@@ -1271,6 +1353,19 @@ void *smem_alloc(unsigned id, unsigned size)
 
 #define SMEM_SPINLOCK_SMEM_ALLOC       "S:3"
 static remote_spinlock_t remote_spinlock;
+static struct remote_spinlock_stats *smem_lock_stats;
+
+/* Per-item lookup counters, dumped through debugfs.  Increments are not
+ * atomic; the counts are diagnostic and approximate under concurrency.
+ */
+static uint32_t smem_item_access[SMEM_NUM_ITEMS];
+
+uint32_t smem_item_access_count(unsigned id)
+{
+	if (id >= SMEM_NUM_ITEMS)
+		return 0;
+	return smem_item_access[id];
+}
 
 /* smem_alloc2 returns the pointer to smem item.  If it is not allocated,
  * it allocates it and then returns the pointer to it.
@@ -1280,6 +1375,7 @@ static void *smem_alloc2(unsigned id, unsigned size_in)
 	struct smem_shared *shared = (void *) MSM_SHARED_RAM_BASE;
 	struct smem_heap_entry *toc = shared->heap_toc;
 	unsigned long flags;
+	ktime_t t_request, t_locked;
 	void *ret = NULL;
 
 	if (!shared->heap_info.initialized) {
@@ -1290,8 +1386,12 @@ static void *smem_alloc2(unsigned id, unsigned size_in)
 	if (id >= SMEM_NUM_ITEMS)
 		return NULL;
 
+	smem_item_access[id]++;
+
 	size_in = ALIGN(size_in, 8);
+	t_request = ktime_get();
 	remote_spin_lock_irqsave(&remote_spinlock, flags);
+	t_locked = ktime_get();
 	if (toc[id].allocated) {
 		SMD_DBG("%s: %u already allocated\n", __func__, id);
 		if (size_in != toc[id].size)
@@ -1316,6 +1416,9 @@ static void *smem_alloc2(unsigned id, unsigned size_in)
 	}
 	/* TODO: system/hardware barrier required? */
 	barrier();
+	remote_spinlock_stats_record(smem_lock_stats,
+			ktime_to_us(ktime_sub(t_locked, t_request)),
+			ktime_to_us(ktime_sub(ktime_get(), t_locked)));
 	remote_spin_unlock_irqrestore(&remote_spinlock, flags);
 	return ret;
 }
@@ -1328,6 +1431,8 @@ void *smem_get_entry(unsigned id, unsigned *size)
 	if (id >= SMEM_NUM_ITEMS)
 		return 0;
 
+	smem_item_access[id]++;
+
 	if (toc[id].allocated) {
 		*size = toc[id].size;
 		return (void *) (MSM_SHARED_RAM_BASE + toc[id].offset);
@@ -1367,6 +1472,8 @@ static int smsm_init(void)
 		pr_err("%s: remote spinlock init failed %d\n", __func__, i);
 		return i;
 	}
+	smem_lock_stats =
+		remote_spinlock_stats_register(SMEM_SPINLOCK_SMEM_ALLOC);
 
 	if (!smsm_info.state) {
 		smsm_info.state = smem_alloc2(ID_SHARED_STATE,
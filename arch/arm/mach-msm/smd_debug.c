@@ -20,6 +20,7 @@
 #include <linux/ctype.h>
 
 #include <mach/msm_iomap.h>
+#include <mach/remote_spinlock.h>
 
 #include "smd_private.h"
 
@@ -434,6 +435,22 @@ static int debug_read_intr_mux(char *buf, int max)
 	return i;
 }
 
+static int debug_read_item_access(char *buf, int max)
+{
+	unsigned id;
+	uint32_t count;
+	int i = 0;
+
+	for (id = 0; id < SMEM_NUM_ITEMS; id++) {
+		count = smem_item_access_count(id);
+		if (count)
+			i += scnprintf(buf + i, max - i, "item %d: %u\n",
+				       id, count);
+	}
+
+	return i;
+}
+
 #define DEBUG_BUFMAX 4096
 static char debug_buffer[DEBUG_BUFMAX];
 
@@ -472,6 +489,8 @@ static int __init smd_debugfs_init(void)
 		return PTR_ERR(dent);
 
 	debug_create("ch", 0444, dent, debug_read_ch);
+	debug_create("item_access", 0444, dent, debug_read_item_access);
+	debug_create("remote_lock", 0444, dent, remote_spinlock_stats_fill);
 	debug_create("diag", 0444, dent, debug_read_diag_msg);
 	debug_create("mem", 0444, dent, debug_read_mem);
 	debug_create("version", 0444, dent, debug_read_smd_version);
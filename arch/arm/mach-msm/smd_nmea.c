@@ -26,32 +26,54 @@
 #include <linux/device.h>
 #include <linux/wait.h>
 #include <linux/sched.h>
+#include <linux/time.h>
 #include <linux/miscdevice.h>
 #include <linux/workqueue.h>
 #include <linux/uaccess.h>
+#include <linux/msm_nmea.h>
 
 #include <mach/msm_smd.h>
 
 #define MAX_BUF_SIZE 200
+#define NMEA_REC_NUM 16
 
 static DEFINE_MUTEX(nmea_ch_lock);
 static DEFINE_MUTEX(nmea_rx_buf_lock);
+static DEFINE_SPINLOCK(nmea_rx_ts_lock);
 
 static DECLARE_WAIT_QUEUE_HEAD(nmea_wait_queue);
 
+struct nmea_record {
+	struct timespec ts;
+	unsigned int len;
+	unsigned char data[MAX_BUF_SIZE];
+};
+
 struct nmea_device_t {
 	struct miscdevice misc;
 
 	struct smd_channel *ch;
 
-	unsigned char rx_buf[MAX_BUF_SIZE];
-	unsigned int bytes_read;
+	/* monotonic time of the last SMD data event, captured in the
+	 * notify callback so sentence timestamps do not inherit the
+	 * worker's scheduling jitter; protected by nmea_rx_ts_lock */
+	struct timespec rx_ts;
+
+	/* ring of received sentences, oldest dropped on overflow;
+	 * protected by nmea_rx_buf_lock */
+	struct nmea_record rec[NMEA_REC_NUM];
+	unsigned int rec_head;
+	unsigned int rec_tail;
+	unsigned int rec_count;
 };
 
 struct nmea_device_t *nmea_devp;
 
 static void nmea_work_func(struct work_struct *ws)
 {
+	struct nmea_record *rec;
+	unsigned long flags;
+	int received = 0;
 	int sz;
 
 	for (;;) {
@@ -66,15 +88,29 @@ static void nmea_work_func(struct work_struct *ws)
 		}
 
 		mutex_lock(&nmea_rx_buf_lock);
-		if (smd_read(nmea_devp->ch, nmea_devp->rx_buf, sz) != sz) {
+		rec = &nmea_devp->rec[nmea_devp->rec_head];
+		if (smd_read(nmea_devp->ch, rec->data, sz) != sz) {
 			mutex_unlock(&nmea_rx_buf_lock);
 			printk(KERN_ERR "nmea: not enough data?!\n");
 			continue;
 		}
-		nmea_devp->bytes_read = sz;
+		spin_lock_irqsave(&nmea_rx_ts_lock, flags);
+		rec->ts = nmea_devp->rx_ts;
+		spin_unlock_irqrestore(&nmea_rx_ts_lock, flags);
+		rec->len = sz;
+		nmea_devp->rec_head =
+			(nmea_devp->rec_head + 1) % NMEA_REC_NUM;
+		if (nmea_devp->rec_count == NMEA_REC_NUM)
+			nmea_devp->rec_tail =
+				(nmea_devp->rec_tail + 1) % NMEA_REC_NUM;
+		else
+			nmea_devp->rec_count++;
 		mutex_unlock(&nmea_rx_buf_lock);
-		wake_up_interruptible(&nmea_wait_queue);
+		received = 1;
 	}
+	/* one wakeup per drained burst, not per sentence */
+	if (received)
+		wake_up_interruptible(&nmea_wait_queue);
 }
 
 struct workqueue_struct *nmea_wq;
@@ -86,8 +122,14 @@ static void nmea_notify(void *priv, unsigned event)
 	case SMD_EVENT_DATA: {
 		int sz;
 		sz = smd_cur_packet_size(nmea_devp->ch);
-		if ((sz > 0) && (sz <= smd_read_avail(nmea_devp->ch)))
+		if ((sz > 0) && (sz <= smd_read_avail(nmea_devp->ch))) {
+			unsigned long flags;
+
+			spin_lock_irqsave(&nmea_rx_ts_lock, flags);
+			ktime_get_ts(&nmea_devp->rx_ts);
+			spin_unlock_irqrestore(&nmea_rx_ts_lock, flags);
 			queue_work(nmea_wq, &nmea_work);
+		}
 		break;
 	}
 	case SMD_EVENT_OPEN:
@@ -99,14 +141,82 @@ static void nmea_notify(void *priv, unsigned event)
 	}
 }
 
+/* pop the oldest sentence without its timestamp, matching the
+ * historical read behaviour */
+static ssize_t nmea_read_raw(char __user *buf, size_t count)
+{
+	struct nmea_record *rec;
+	int bytes_read;
+	int r;
+
+	mutex_lock(&nmea_rx_buf_lock);
+	rec = &nmea_devp->rec[nmea_devp->rec_tail];
+	bytes_read = rec->len;
+	if (bytes_read > count)
+		bytes_read = count;
+	r = copy_to_user(buf, rec->data, bytes_read);
+	nmea_devp->rec_tail = (nmea_devp->rec_tail + 1) % NMEA_REC_NUM;
+	nmea_devp->rec_count--;
+	mutex_unlock(&nmea_rx_buf_lock);
+
+	if (r > 0) {
+		printk(KERN_ERR "ERROR:%s:%i:%s: "
+			"copy_to_user could not copy %i bytes.\n",
+			__FILE__,
+			__LINE__,
+			__func__,
+			r);
+		return r;
+	}
+
+	return bytes_read;
+}
+
+/* drain every queued sentence that fits, each preceded by a
+ * struct nmea_rec_hdr carrying the receive timestamp */
+static ssize_t nmea_read_records(char __user *buf, size_t count)
+{
+	struct nmea_rec_hdr hdr;
+	struct nmea_record *rec;
+	size_t written = 0;
+	size_t rec_bytes;
+
+	mutex_lock(&nmea_rx_buf_lock);
+	while (nmea_devp->rec_count) {
+		rec = &nmea_devp->rec[nmea_devp->rec_tail];
+		rec_bytes = sizeof(hdr) + ALIGN(rec->len, 8);
+		if (rec_bytes > count - written)
+			break;
+
+		hdr.ts_ns = timespec_to_ns(&rec->ts);
+		hdr.len = rec->len;
+		hdr.pad = 0;
+		if (copy_to_user(buf + written, &hdr, sizeof(hdr)) ||
+		    copy_to_user(buf + written + sizeof(hdr), rec->data,
+				 rec->len)) {
+			mutex_unlock(&nmea_rx_buf_lock);
+			return written ? written : -EFAULT;
+		}
+		written += rec_bytes;
+		nmea_devp->rec_tail =
+			(nmea_devp->rec_tail + 1) % NMEA_REC_NUM;
+		nmea_devp->rec_count--;
+	}
+	mutex_unlock(&nmea_rx_buf_lock);
+
+	/* buffer too small for even one record */
+	if (!written)
+		return -EINVAL;
+	return written;
+}
+
 static ssize_t nmea_read(struct file *fp, char __user *buf,
 			 size_t count, loff_t *pos)
 {
 	int r;
-	int bytes_read;
 
 	r = wait_event_interruptible(nmea_wait_queue,
-				nmea_devp->bytes_read);
+				nmea_devp->rec_count);
 	if (r < 0) {
 		/* qualify error message */
 		if (r != -ERESTARTSYS) {
@@ -122,23 +232,19 @@ static ssize_t nmea_read(struct file *fp, char __user *buf,
 		return r;
 	}
 
-	mutex_lock(&nmea_rx_buf_lock);
-	bytes_read = nmea_devp->bytes_read;
-	nmea_devp->bytes_read = 0;
-	r = copy_to_user(buf, nmea_devp->rx_buf, bytes_read);
-	mutex_unlock(&nmea_rx_buf_lock);
+	if (fp->private_data)
+		return nmea_read_records(buf, count);
+	return nmea_read_raw(buf, count);
+}
 
-	if (r > 0) {
-		printk(KERN_ERR "ERROR:%s:%i:%s: "
-			"copy_to_user could not copy %i bytes.\n",
-			__FILE__,
-			__LINE__,
-			__func__,
-			r);
-		return r;
+static long nmea_ioctl(struct file *fp, unsigned int cmd, unsigned long arg)
+{
+	switch (cmd) {
+	case NMEA_SET_REC_MODE:
+		fp->private_data = (void *)(arg ? 1UL : 0UL);
+		return 0;
 	}
-
-	return bytes_read;
+	return -EINVAL;
 }
 
 static int nmea_open(struct inode *ip, struct file *fp)
@@ -170,6 +276,7 @@ static int nmea_release(struct inode *ip, struct file *fp)
 static const struct file_operations nmea_fops = {
 	.owner = THIS_MODULE,
 	.read = nmea_read,
+	.unlocked_ioctl = nmea_ioctl,
 	.open = nmea_open,
 	.release = nmea_release,
 };
@@ -192,7 +299,6 @@ static int __init nmea_init(void)
 {
 	int ret;
 
-	nmea_device.bytes_read = 0;
 	nmea_devp = &nmea_device;
 
 	nmea_wq = create_singlethread_workqueue("nmea");
@@ -153,6 +153,7 @@ enum {
 
 void *smem_alloc(unsigned id, unsigned size);
 void *smem_get_entry(unsigned id, unsigned *size);
+uint32_t smem_item_access_count(unsigned id);
 int smsm_change_state(uint32_t smsm_entry,
 		      uint32_t clear_mask, uint32_t set_mask);
 int smsm_change_intr_mask(uint32_t smsm_entry,
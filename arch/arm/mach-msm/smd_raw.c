@@ -0,0 +1,522 @@
+/* arch/arm/mach-msm/smd_raw.c
+ *
+ * Copyright (C) 2007 Google, Inc.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+/*
+ * SMD Raw Stream Driver -- Low latency character device access to SMD
+ *                          stream channels.
+ *
+ * smd_tty delivers modem data through the tty layer: the receive path
+ * copies into flip buffers from a tasklet and takes another scheduling
+ * hop through the ldisc before userspace sees a byte.  This driver
+ * exposes the same stream channels as plain character devices, copying
+ * SMD payload directly to the caller's buffer (one copy, via
+ * smd_read_user_buffer()) and waking readers straight from the SMD
+ * notify callback.
+ *
+ * A channel is claimed by whichever interface opens it first; smd_tty
+ * remains available for clients that want tty semantics.
+ */
+
+#include <linux/slab.h>
+#include <linux/cdev.h>
+#include <linux/module.h>
+#include <linux/fs.h>
+#include <linux/device.h>
+#include <linux/sched.h>
+#include <linux/mutex.h>
+#include <linux/delay.h>
+#include <linux/uaccess.h>
+#include <linux/wakelock.h>
+#include <linux/poll.h>
+#include <asm/ioctls.h>
+
+#include <mach/msm_smd.h>
+#include <mach/peripheral-loader.h>
+
+#include "modem_notifier.h"
+#include "smd_private.h"
+
+#define NUM_SMD_RAW_PORTS 4
+#define DEVICE_NAME "smdraw"
+
+struct smd_raw_dev {
+	struct cdev cdev;
+	struct device *devicep;
+	void *pil;
+
+	struct smd_channel *ch;
+	struct mutex ch_lock;
+	struct mutex rx_lock;
+	struct mutex tx_lock;
+	wait_queue_head_t ch_read_wait_queue;
+	wait_queue_head_t ch_write_wait_queue;
+	wait_queue_head_t ch_opened_wait_queue;
+	struct wake_lock wake_lock;
+
+	int i;
+
+	int is_open;
+	int open_count;
+
+	struct notifier_block nb;
+	int has_reset;
+	struct mutex has_reset_lock;
+} *smd_raw_devp[NUM_SMD_RAW_PORTS];
+
+static struct class *smd_raw_classp;
+static dev_t smd_raw_number;
+
+static char *smd_raw_dev_name[] = {
+	"smdraw_ds",
+	"smdraw_data1",
+	"smdraw_data21",
+	"smdraw_gpsnmea",
+};
+
+static char *smd_ch_name[] = {
+	"DS",
+	"DATA1",
+	"DATA21",
+	"GPSNMEA",
+};
+
+static void clean_and_signal(struct smd_raw_dev *devp)
+{
+	mutex_lock(&devp->has_reset_lock);
+	devp->has_reset = 1;
+	mutex_unlock(&devp->has_reset_lock);
+
+	devp->is_open = 0;
+
+	wake_up_interruptible(&devp->ch_read_wait_queue);
+	wake_up_interruptible(&devp->ch_write_wait_queue);
+	wake_up_interruptible(&devp->ch_opened_wait_queue);
+}
+
+static int modem_notifier(struct notifier_block *this,
+			  unsigned long code,
+			  void *_cmd)
+{
+	struct smd_raw_dev *devp =
+		container_of(this, struct smd_raw_dev, nb);
+
+	if (!devp)
+		return NOTIFY_DONE;
+
+	switch (code) {
+	case MODEM_NOTIFIER_START_RESET:
+		printk(KERN_ERR "%s: start reset ch:%i\n",
+		       __func__, devp->i);
+		clean_and_signal(devp);
+		break;
+	case MODEM_NOTIFIER_END_RESET:
+		break;
+	default:
+		break;
+	}
+	return NOTIFY_DONE;
+}
+
+static int smd_raw_ioctl(struct inode *inode,
+			 struct file *file,
+			 unsigned int cmd,
+			 unsigned long arg)
+{
+	int ret;
+	struct smd_raw_dev *devp = file->private_data;
+
+	if (!devp || !devp->ch)
+		return -EINVAL;
+
+	switch (cmd) {
+	case TIOCMGET:
+		ret = smd_tiocmget(devp->ch);
+		break;
+	case TIOCMSET:
+		ret = smd_tiocmset(devp->ch, arg, ~arg);
+		break;
+	default:
+		ret = -EINVAL;
+	}
+
+	return ret;
+}
+
+static ssize_t smd_raw_read(struct file *file,
+			    char __user *buf,
+			    size_t count,
+			    loff_t *ppos)
+{
+	int r;
+	int avail;
+	struct smd_raw_dev *devp = file->private_data;
+
+	if (!devp || !devp->ch)
+		return -EINVAL;
+
+	for (;;) {
+		if (devp->has_reset)
+			return -ENETRESET;
+
+		r = wait_event_interruptible(devp->ch_read_wait_queue,
+					     smd_read_avail(devp->ch) > 0 ||
+					     devp->has_reset);
+		if (devp->has_reset)
+			return -ENETRESET;
+		if (r < 0)
+			return r;
+
+		/* stream semantics: hand back whatever is there */
+		mutex_lock(&devp->rx_lock);
+		avail = smd_read_avail(devp->ch);
+		if (avail == 0) {
+			/* raced with another reader */
+			mutex_unlock(&devp->rx_lock);
+			continue;
+		}
+		break;
+	}
+
+	if (avail > count)
+		avail = count;
+
+	r = smd_read_user_buffer(devp->ch, buf, avail);
+	mutex_unlock(&devp->rx_lock);
+	if (r != avail) {
+		if (devp->has_reset)
+			return -ENETRESET;
+		printk(KERN_ERR "%s: short read %d/%d\n", __func__, r, avail);
+		return -EIO;
+	}
+
+	return avail;
+}
+
+static ssize_t smd_raw_write(struct file *file,
+			     const char __user *buf,
+			     size_t count,
+			     loff_t *ppos)
+{
+	int r;
+	int avail;
+	struct smd_raw_dev *devp = file->private_data;
+
+	if (!devp || !devp->ch)
+		return -EINVAL;
+
+	for (;;) {
+		if (devp->has_reset)
+			return -ENETRESET;
+
+		r = wait_event_interruptible(devp->ch_write_wait_queue,
+					     smd_write_avail(devp->ch) > 0 ||
+					     devp->has_reset);
+		if (devp->has_reset)
+			return -ENETRESET;
+		if (r < 0)
+			return r;
+
+		mutex_lock(&devp->tx_lock);
+		avail = smd_write_avail(devp->ch);
+		if (avail == 0) {
+			mutex_unlock(&devp->tx_lock);
+			continue;
+		}
+		break;
+	}
+
+	/* stream semantics: partial writes are fine, caller resubmits */
+	if (avail > count)
+		avail = count;
+
+	r = smd_write_user_buffer(devp->ch, buf, avail);
+	mutex_unlock(&devp->tx_lock);
+	if (r != avail) {
+		if (devp->has_reset)
+			return -ENETRESET;
+		printk(KERN_ERR "%s: short write %d/%d\n", __func__, r, avail);
+		return -EIO;
+	}
+
+	return avail;
+}
+
+static unsigned int smd_raw_poll(struct file *file, poll_table *wait)
+{
+	struct smd_raw_dev *devp = file->private_data;
+	unsigned int mask = 0;
+
+	if (!devp || !devp->ch)
+		return POLLERR;
+
+	poll_wait(file, &devp->ch_read_wait_queue, wait);
+	poll_wait(file, &devp->ch_write_wait_queue, wait);
+
+	if (devp->has_reset)
+		return POLLERR;
+	if (smd_read_avail(devp->ch) > 0)
+		mask |= POLLIN | POLLRDNORM;
+	if (smd_write_avail(devp->ch) > 0)
+		mask |= POLLOUT | POLLWRNORM;
+
+	return mask;
+}
+
+static void ch_notify(void *priv, unsigned event)
+{
+	struct smd_raw_dev *devp = priv;
+
+	if (devp->ch == 0)
+		return;
+
+	switch (event) {
+	case SMD_EVENT_DATA:
+		/* SMD_EVENT_DATA covers both new rx data and freed tx
+		 * space; readers and writers sort themselves out against
+		 * the fifo state.  Hold a timed wakelock so userspace
+		 * gets to run before suspend, same as smd_tty.
+		 */
+		if (smd_read_avail(devp->ch) > 0) {
+			wake_lock_timeout(&devp->wake_lock, HZ / 2);
+			wake_up_interruptible(&devp->ch_read_wait_queue);
+		}
+		if (smd_write_avail(devp->ch) > 0)
+			wake_up_interruptible(&devp->ch_write_wait_queue);
+		break;
+	case SMD_EVENT_OPEN:
+		devp->is_open = 1;
+		wake_up_interruptible(&devp->ch_opened_wait_queue);
+		break;
+	case SMD_EVENT_CLOSE:
+		devp->is_open = 0;
+		printk(KERN_ERR "%s: smd closed ch:%i\n", __func__, devp->i);
+		break;
+	}
+}
+
+static int smd_raw_open(struct inode *inode, struct file *file)
+{
+	int r = 0;
+	struct smd_raw_dev *devp;
+
+	devp = container_of(inode->i_cdev, struct smd_raw_dev, cdev);
+
+	if (!devp)
+		return -EINVAL;
+
+	file->private_data = devp;
+
+	mutex_lock(&devp->ch_lock);
+	if (devp->open_count == 0) {
+		devp->pil = pil_get("modem");
+		if (IS_ERR(devp->pil)) {
+			r = PTR_ERR(devp->pil);
+			goto out;
+		}
+
+		/* fails if smd_tty (or anyone else) already owns
+		 * the channel
+		 */
+		r = smd_open(smd_ch_name[devp->i], &devp->ch, devp,
+			     ch_notify);
+		if (r < 0) {
+			pr_err("%s: %s open failed %d\n", __func__,
+			       smd_ch_name[devp->i], r);
+			goto release_pil;
+		}
+
+		r = wait_event_interruptible_timeout(
+				devp->ch_opened_wait_queue,
+				devp->is_open, (2 * HZ));
+		if (r == 0)
+			r = -ETIMEDOUT;
+
+		if (r < 0) {
+			pr_err("%s: wait failed for smd open: %d\n",
+			       __func__, r);
+			smd_close(devp->ch);
+			devp->ch = 0;
+			goto release_pil;
+		}
+
+		smd_disable_read_intr(devp->ch);
+		r = 0;
+	}
+	devp->open_count++;
+
+release_pil:
+	if (r < 0)
+		pil_put(devp->pil);
+out:
+	mutex_unlock(&devp->ch_lock);
+
+	return r;
+}
+
+static int smd_raw_release(struct inode *inode, struct file *file)
+{
+	int r = 0;
+	struct smd_raw_dev *devp = file->private_data;
+
+	if (!devp)
+		return -EINVAL;
+
+	mutex_lock(&devp->ch_lock);
+	if (--devp->open_count == 0) {
+		clean_and_signal(devp);
+		if (devp->ch != 0) {
+			r = smd_close(devp->ch);
+			devp->ch = 0;
+			pil_put(devp->pil);
+		}
+		mutex_lock(&devp->has_reset_lock);
+		devp->has_reset = 0;
+		mutex_unlock(&devp->has_reset_lock);
+	}
+	mutex_unlock(&devp->ch_lock);
+
+	return r;
+}
+
+static const struct file_operations smd_raw_fops = {
+	.owner = THIS_MODULE,
+	.open = smd_raw_open,
+	.release = smd_raw_release,
+	.read = smd_raw_read,
+	.write = smd_raw_write,
+	.poll = smd_raw_poll,
+	.ioctl = smd_raw_ioctl,
+};
+
+static int __init smd_raw_init(void)
+{
+	int i;
+	int r;
+
+	r = alloc_chrdev_region(&smd_raw_number,
+				0,
+				NUM_SMD_RAW_PORTS,
+				DEVICE_NAME);
+	if (IS_ERR_VALUE(r)) {
+		printk(KERN_ERR "%s: alloc_chrdev_region() ret %i.\n",
+		       __func__, r);
+		goto error0;
+	}
+
+	smd_raw_classp = class_create(THIS_MODULE, DEVICE_NAME);
+	if (IS_ERR(smd_raw_classp)) {
+		printk(KERN_ERR "%s: class_create() ENOMEM\n", __func__);
+		r = -ENOMEM;
+		goto error1;
+	}
+
+	for (i = 0; i < NUM_SMD_RAW_PORTS; ++i) {
+		smd_raw_devp[i] = kzalloc(sizeof(struct smd_raw_dev),
+					  GFP_KERNEL);
+		if (!smd_raw_devp[i]) {
+			printk(KERN_ERR "%s: kzalloc() ENOMEM\n", __func__);
+			r = -ENOMEM;
+			goto error2;
+		}
+
+		smd_raw_devp[i]->i = i;
+
+		init_waitqueue_head(&smd_raw_devp[i]->ch_read_wait_queue);
+		init_waitqueue_head(&smd_raw_devp[i]->ch_write_wait_queue);
+		init_waitqueue_head(&smd_raw_devp[i]->ch_opened_wait_queue);
+		smd_raw_devp[i]->is_open = 0;
+
+		mutex_init(&smd_raw_devp[i]->ch_lock);
+		mutex_init(&smd_raw_devp[i]->rx_lock);
+		mutex_init(&smd_raw_devp[i]->tx_lock);
+		mutex_init(&smd_raw_devp[i]->has_reset_lock);
+		wake_lock_init(&smd_raw_devp[i]->wake_lock,
+			       WAKE_LOCK_SUSPEND, smd_raw_dev_name[i]);
+
+		cdev_init(&smd_raw_devp[i]->cdev, &smd_raw_fops);
+		smd_raw_devp[i]->cdev.owner = THIS_MODULE;
+
+		r = cdev_add(&smd_raw_devp[i]->cdev,
+			     (smd_raw_number + i),
+			     1);
+		if (IS_ERR_VALUE(r)) {
+			printk(KERN_ERR "%s: cdev_add() ret %i\n",
+			       __func__, r);
+			wake_lock_destroy(&smd_raw_devp[i]->wake_lock);
+			kfree(smd_raw_devp[i]);
+			goto error2;
+		}
+
+		smd_raw_devp[i]->devicep =
+			device_create(smd_raw_classp,
+				      NULL,
+				      (smd_raw_number + i),
+				      NULL,
+				      smd_raw_dev_name[i]);
+		if (IS_ERR(smd_raw_devp[i]->devicep)) {
+			printk(KERN_ERR "%s: device_create() ENOMEM\n",
+			       __func__);
+			r = -ENOMEM;
+			cdev_del(&smd_raw_devp[i]->cdev);
+			wake_lock_destroy(&smd_raw_devp[i]->wake_lock);
+			kfree(smd_raw_devp[i]);
+			goto error2;
+		}
+
+		smd_raw_devp[i]->nb.notifier_call = modem_notifier;
+		modem_register_notifier(&smd_raw_devp[i]->nb);
+	}
+
+	printk(KERN_INFO "SMD Raw Stream Driver Initialized.\n");
+	return 0;
+
+ error2:
+	while (--i >= 0) {
+		modem_unregister_notifier(&smd_raw_devp[i]->nb);
+		cdev_del(&smd_raw_devp[i]->cdev);
+		wake_lock_destroy(&smd_raw_devp[i]->wake_lock);
+		kfree(smd_raw_devp[i]);
+		device_destroy(smd_raw_classp,
+			       MKDEV(MAJOR(smd_raw_number), i));
+	}
+	class_destroy(smd_raw_classp);
+ error1:
+	unregister_chrdev_region(MAJOR(smd_raw_number), NUM_SMD_RAW_PORTS);
+ error0:
+	return r;
+}
+
+static void __exit smd_raw_cleanup(void)
+{
+	int i;
+
+	for (i = 0; i < NUM_SMD_RAW_PORTS; ++i) {
+		modem_unregister_notifier(&smd_raw_devp[i]->nb);
+		cdev_del(&smd_raw_devp[i]->cdev);
+		wake_lock_destroy(&smd_raw_devp[i]->wake_lock);
+		kfree(smd_raw_devp[i]);
+		device_destroy(smd_raw_classp,
+			       MKDEV(MAJOR(smd_raw_number), i));
+	}
+
+	class_destroy(smd_raw_classp);
+
+	unregister_chrdev_region(MAJOR(smd_raw_number), NUM_SMD_RAW_PORTS);
+}
+
+module_init(smd_raw_init);
+module_exit(smd_raw_cleanup);
+
+MODULE_DESCRIPTION("MSM Shared Memory Raw Stream Port");
+MODULE_LICENSE("GPL v2");
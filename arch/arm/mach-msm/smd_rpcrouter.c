@@ -18,7 +18,6 @@
 /* TODO: handle cases where smd_write() will tempfail due to full fifo */
 /* TODO: thread priority? schedule a work to bump it? */
 /* TODO: maybe make server_list_lock a mutex */
-/* TODO: pool fragments to avoid kmalloc/kfree churn */
 
 #include <linux/slab.h>
 #include <linux/module.h>
@@ -282,6 +281,7 @@ static void modem_reset_start_cleanup(void)
 	struct rr_fragment *frag, *next;
 	struct msm_rpc_reply *reply, *reply_tmp;
 	unsigned long flags;
+	int i;
 
 	spin_lock_irqsave(&local_endpoints_lock, flags);
 	/* remove all partial packets received */
@@ -290,11 +290,14 @@ static void modem_reset_start_cleanup(void)
 		   ept->dst_pid, RPCROUTER_PID_REMOTE);
 		/* remove replies */
 		spin_lock(&ept->reply_q_lock);
-		list_for_each_entry_safe(reply, reply_tmp,
-					 &ept->reply_pend_q, list) {
-			list_del(&reply->list);
-			kfree(reply);
+		for (i = 0; i < RPCROUTER_REPLY_HASH_SIZE; i++) {
+			list_for_each_entry_safe(reply, reply_tmp,
+						 &ept->reply_pend_q[i], list) {
+				list_del(&reply->list);
+				kfree(reply);
+			}
 		}
+		ept->reply_pend_cnt = 0;
 		list_for_each_entry_safe(reply, reply_tmp,
 					 &ept->reply_avail_q, list) {
 			list_del(&reply->list);
@@ -309,7 +312,7 @@ static void modem_reset_start_cleanup(void)
 				frag = pkt->first;
 				while (frag != NULL) {
 					next = frag->next;
-					kfree(frag);
+					rr_frag_free(frag);
 					frag = next;
 				}
 			kfree(pkt);
@@ -323,7 +326,7 @@ static void modem_reset_start_cleanup(void)
 				frag = pkt->first;
 				while (frag != NULL) {
 					next = frag->next;
-					kfree(frag);
+					rr_frag_free(frag);
 					frag = next;
 				}
 				kfree(pkt);
@@ -488,6 +491,7 @@ struct msm_rpc_endpoint *msm_rpcrouter_create_local_endpoint(dev_t dev)
 {
 	struct msm_rpc_endpoint *ept;
 	unsigned long flags;
+	int i;
 
 	ept = kmalloc(sizeof(struct msm_rpc_endpoint), GFP_KERNEL);
 	if (!ept)
@@ -521,7 +525,9 @@ struct msm_rpc_endpoint *msm_rpcrouter_create_local_endpoint(dev_t dev)
 	INIT_LIST_HEAD(&ept->read_q);
 	spin_lock_init(&ept->read_q_lock);
 	INIT_LIST_HEAD(&ept->reply_avail_q);
-	INIT_LIST_HEAD(&ept->reply_pend_q);
+	for (i = 0; i < RPCROUTER_REPLY_HASH_SIZE; i++)
+		INIT_LIST_HEAD(&ept->reply_pend_q[i]);
+	ept->reply_pend_cnt = 0;
 	spin_lock_init(&ept->reply_q_lock);
 	spin_lock_init(&ept->restart_lock);
 	init_waitqueue_head(&ept->restart_wait);
@@ -540,6 +546,7 @@ struct msm_rpc_endpoint *msm_rpcrouter_create_local_endpoint(dev_t dev)
 int msm_rpcrouter_destroy_local_endpoint(struct msm_rpc_endpoint *ept)
 {
 	int rc;
+	int i;
 	union rr_control_msg msg;
 	struct msm_rpc_reply *reply, *reply_tmp;
 	unsigned long flags;
@@ -567,10 +574,14 @@ int msm_rpcrouter_destroy_local_endpoint(struct msm_rpc_endpoint *ept)
 
 	/* Free replies */
 	spin_lock_irqsave(&ept->reply_q_lock, flags);
-	list_for_each_entry_safe(reply, reply_tmp, &ept->reply_pend_q, list) {
-		list_del(&reply->list);
-		kfree(reply);
+	for (i = 0; i < RPCROUTER_REPLY_HASH_SIZE; i++) {
+		list_for_each_entry_safe(reply, reply_tmp,
+					 &ept->reply_pend_q[i], list) {
+			list_del(&reply->list);
+			kfree(reply);
+		}
 	}
+	ept->reply_pend_cnt = 0;
 	list_for_each_entry_safe(reply, reply_tmp, &ept->reply_avail_q, list) {
 		list_del(&reply->list);
 		kfree(reply);
@@ -881,6 +892,51 @@ static void *rr_malloc(unsigned sz)
 	return ptr;
 }
 
+/* Inbound fragments are RPCROUTER_MSGSIZE_MAX sized and turn over at
+ * RPC call rate, so keep a small free list instead of going to the
+ * allocator for every fragment.  Fragments handed out by
+ * msm_rpc_read() as single-fragment buffers escape to callers who
+ * kfree() them directly; the pool simply refills on demand.
+ */
+#define RR_FRAG_POOL_MAX 32
+
+static DEFINE_SPINLOCK(rr_frag_pool_lock);
+static struct rr_fragment *rr_frag_pool;
+static int rr_frag_pool_cnt;
+
+static struct rr_fragment *rr_frag_alloc(void)
+{
+	struct rr_fragment *frag;
+	unsigned long flags;
+
+	spin_lock_irqsave(&rr_frag_pool_lock, flags);
+	frag = rr_frag_pool;
+	if (frag) {
+		rr_frag_pool = frag->next;
+		rr_frag_pool_cnt--;
+	}
+	spin_unlock_irqrestore(&rr_frag_pool_lock, flags);
+
+	if (!frag)
+		frag = rr_malloc(sizeof(*frag));
+	return frag;
+}
+
+void rr_frag_free(struct rr_fragment *frag)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&rr_frag_pool_lock, flags);
+	if (rr_frag_pool_cnt < RR_FRAG_POOL_MAX) {
+		frag->next = rr_frag_pool;
+		rr_frag_pool = frag;
+		rr_frag_pool_cnt++;
+		frag = NULL;
+	}
+	spin_unlock_irqrestore(&rr_frag_pool_lock, flags);
+	kfree(frag);
+}
+
 static int rr_read(struct rpcrouter_xprt_info *xprt_info,
 		   void *data, uint32_t len)
 {
@@ -992,11 +1048,11 @@ static void do_read_data(struct work_struct *work)
 
 	hdr.size -= sizeof(pm);
 
-	frag = rr_malloc(sizeof(*frag));
+	frag = rr_frag_alloc();
 	frag->next = NULL;
 	frag->length = hdr.size;
 	if (rr_read(xprt_info, frag->data, hdr.size)) {
-		kfree(frag);
+		rr_frag_free(frag);
 		goto fail_io;
 	}
 
@@ -1038,7 +1094,7 @@ static void do_read_data(struct work_struct *work)
 	ept = rpcrouter_lookup_local_endpoint(hdr.dst_cid);
 	if (!ept) {
 		DIAG("no local ept for cid %08x\n", hdr.dst_cid);
-		kfree(frag);
+		rr_frag_free(frag);
 		goto done;
 	}
 
@@ -1338,15 +1394,24 @@ static int msm_rpc_write_pkt(
 	return needed;
 }
 
+/* xids are assigned sequentially, so the low bits spread evenly */
+static inline struct list_head *reply_pend_q_hash(struct msm_rpc_endpoint *ept,
+						  uint32_t xid)
+{
+	return &ept->reply_pend_q[be32_to_cpu(xid) &
+				  (RPCROUTER_REPLY_HASH_SIZE - 1)];
+}
+
 static struct msm_rpc_reply *get_pend_reply(struct msm_rpc_endpoint *ept,
 					    uint32_t xid)
 {
 	unsigned long flags;
 	struct msm_rpc_reply *reply;
 	spin_lock_irqsave(&ept->reply_q_lock, flags);
-	list_for_each_entry(reply, &ept->reply_pend_q, list) {
+	list_for_each_entry(reply, reply_pend_q_hash(ept, xid), list) {
 		if (reply->xid == xid) {
 			list_del(&reply->list);
+			ept->reply_pend_cnt--;
 			spin_unlock_irqrestore(&ept->reply_q_lock, flags);
 			return reply;
 		}
@@ -1365,7 +1430,7 @@ void get_requesting_client(struct msm_rpc_endpoint *ept, uint32_t xid,
 		return;
 
 	spin_lock_irqsave(&ept->reply_q_lock, flags);
-	list_for_each_entry(reply, &ept->reply_pend_q, list) {
+	list_for_each_entry(reply, reply_pend_q_hash(ept, xid), list) {
 		if (reply->xid == xid) {
 			clnt_info->pid = reply->pid;
 			clnt_info->cid = reply->cid;
@@ -1425,7 +1490,8 @@ static void set_pend_reply(struct msm_rpc_endpoint *ept,
 		spin_lock_irqsave(&ept->reply_q_lock, flags);
 		D("%s: take reply lock on ept %p\n", __func__, ept);
 		wake_lock(&ept->reply_q_wake_lock);
-		list_add_tail(&reply->list, &ept->reply_pend_q);
+		list_add_tail(&reply->list, reply_pend_q_hash(ept, reply->xid));
+		ept->reply_pend_cnt++;
 		spin_unlock_irqrestore(&ept->reply_q_lock, flags);
 }
 
@@ -1550,7 +1616,7 @@ int msm_rpc_write(struct msm_rpc_endpoint *ept, void *buffer, int count)
 			set_avail_reply(ept, reply);
 
 		spin_lock_irqsave(&ept->reply_q_lock, flags);
-		if (list_empty(&ept->reply_pend_q)) {
+		if (ept->reply_pend_cnt == 0) {
 			D("%s: release reply lock on ept %p\n", __func__, ept);
 			wake_unlock(&ept->reply_q_wake_lock);
 		}
@@ -1593,7 +1659,7 @@ int msm_rpc_read(struct msm_rpc_endpoint *ept, void **buffer,
 		memcpy(buf, frag->data, frag->length);
 		next = frag->next;
 		buf += frag->length;
-		kfree(frag);
+		rr_frag_free(frag);
 		frag = next;
 	}
 
@@ -2114,6 +2180,7 @@ static int dump_remote_endpoints(char *buf, int max)
 static int dump_msm_rpc_endpoint(char *buf, int max)
 {
 	int i = 0;
+	int j;
 	unsigned long flags;
 	struct msm_rpc_reply *reply;
 	struct msm_rpc_endpoint *ept;
@@ -2144,9 +2211,11 @@ static int dump_msm_rpc_endpoint(char *buf, int max)
 
 		i += scnprintf(buf + i, max - i, "outstanding xids:\n");
 		spin_lock(&ept->reply_q_lock);
-		list_for_each_entry(reply, &ept->reply_pend_q, list)
-			i += scnprintf(buf + i, max - i, "    xid = %u\n",
-				       ntohl(reply->xid));
+		for (j = 0; j < RPCROUTER_REPLY_HASH_SIZE; j++)
+			list_for_each_entry(reply, &ept->reply_pend_q[j], list)
+				i += scnprintf(buf + i, max - i,
+					       "    xid = %u\n",
+					       ntohl(reply->xid));
 		spin_unlock(&ept->reply_q_lock);
 
 		i += scnprintf(buf + i, max - i, "complete unread packets:\n");
@@ -34,6 +34,8 @@
 #define RPCROUTER_PROCESSORS_MAX		4
 #define RPCROUTER_MSGSIZE_MAX			512
 #define RPCROUTER_PEND_REPLIES_MAX		32
+/* pending reply hash buckets, must be a power of two */
+#define RPCROUTER_REPLY_HASH_SIZE		16
 
 #define RPCROUTER_CLIENT_BCAST_ID		0xffffffff
 #define RPCROUTER_ROUTER_ADDRESS		0xfffffffe
@@ -185,11 +187,14 @@ struct msm_rpc_endpoint {
 	uint32_t dst_prog; /* be32 */
 	uint32_t dst_vers; /* be32 */
 
-	/* reply queue for inbound messages */
-	struct list_head reply_pend_q;
+	/* reply queue for inbound messages; pending replies are hashed
+	 * by request xid so lookup stays O(1) as outstanding calls grow
+	 */
+	struct list_head reply_pend_q[RPCROUTER_REPLY_HASH_SIZE];
 	struct list_head reply_avail_q;
 	spinlock_t reply_q_lock;
 	uint32_t reply_cnt;
+	uint32_t reply_pend_cnt;
 	struct wake_lock reply_q_wake_lock;
 
 	/* device node if this endpoint is accessed via userspace */
@@ -219,6 +224,9 @@ int __msm_rpc_read(struct msm_rpc_endpoint *ept,
 		   struct rr_fragment **frag,
 		   unsigned len, long timeout);
 
+/* return a fragment obtained from __msm_rpc_read() to the free pool */
+void rr_frag_free(struct rr_fragment *frag);
+
 int msm_rpcrouter_close(void);
 struct msm_rpc_endpoint *msm_rpcrouter_create_local_endpoint(dev_t dev);
 int msm_rpcrouter_destroy_local_endpoint(struct msm_rpc_endpoint *ept);
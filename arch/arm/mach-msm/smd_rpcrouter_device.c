@@ -174,7 +174,7 @@ static ssize_t rpcrouter_read(struct file *filp, char __user *buf,
 		}
 		buf += frag->length;
 		next = frag->next;
-		kfree(frag);
+		rr_frag_free(frag);
 		frag = next;
 	}
 
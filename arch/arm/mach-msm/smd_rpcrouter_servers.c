@@ -26,6 +26,7 @@
 #include <linux/types.h>
 #include <linux/fs.h>
 #include <linux/kthread.h>
+#include <linux/workqueue.h>
 #include <linux/delay.h>
 #include <linux/platform_device.h>
 #include <linux/wakelock.h>
@@ -45,7 +46,39 @@ static DEFINE_MUTEX(rpc_server_list_lock);
 static int rpc_servers_active;
 static struct wake_lock rpc_servers_wake_lock;
 static struct msm_rpc_xdr server_xdr;
-static uint32_t current_xid;
+
+/* inbound call handed to a server's worker */
+struct rpc_server_req {
+	struct work_struct work;
+	struct msm_rpc_server *server;
+	void *buffer;
+	int len;
+};
+
+/* wake lock held while any dispatched request is still in flight */
+static struct wake_lock rpc_servers_work_wake_lock;
+static DEFINE_SPINLOCK(rpc_req_lock);
+static unsigned int rpc_req_pending;
+
+static void rpc_req_get(void)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&rpc_req_lock, flags);
+	if (rpc_req_pending++ == 0)
+		wake_lock(&rpc_servers_work_wake_lock);
+	spin_unlock_irqrestore(&rpc_req_lock, flags);
+}
+
+static void rpc_req_put(void)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&rpc_req_lock, flags);
+	if (--rpc_req_pending == 0)
+		wake_unlock(&rpc_servers_work_wake_lock);
+	spin_unlock_irqrestore(&rpc_req_lock, flags);
+}
 
 #ifdef CONFIG_LGE_SUPPORT_AT_CMD
 // change little Endian to Big endian (there is not change function in Kernel)
@@ -116,6 +149,7 @@ static void rpc_server_register_all(void)
 
 int msm_rpc_create_server(struct msm_rpc_server *server)
 {
+	char wq_name[32];
 	void *buf;
 
 	/* make sure we're in a sane state first */
@@ -124,17 +158,26 @@ int msm_rpc_create_server(struct msm_rpc_server *server)
 	mutex_init(&server->cb_req_lock);
 
 	server->version = 1;
+	server->req_task = NULL;
+
+	snprintf(wq_name, sizeof(wq_name), "rpc_%08x", server->prog);
+	server->workqueue = create_singlethread_workqueue(wq_name);
+	if (!server->workqueue)
+		return -ENOMEM;
 
 	xdr_init(&server->cb_xdr);
 	buf = kmalloc(MSM_RPC_MSGSIZE_MAX, GFP_KERNEL);
-	if (!buf)
+	if (!buf) {
+		destroy_workqueue(server->workqueue);
 		return -ENOMEM;
+	}
 
 	xdr_init_output(&server->cb_xdr, buf, MSM_RPC_MSGSIZE_MAX);
 
 	server->cb_ept = server->cb_xdr.ept = msm_rpc_open();
 	if (IS_ERR(server->cb_ept)) {
 		xdr_clean_output(&server->cb_xdr);
+		destroy_workqueue(server->workqueue);
 		return PTR_ERR(server->cb_ept);
 	}
 
@@ -321,6 +364,7 @@ void *msm_rpc_server_start_accepted_reply(struct msm_rpc_server *server,
 	struct rpc_reply_hdr *reply;
 
 	mutex_lock(&server_xdr.out_lock);
+	server_xdr.out_index = 0;
 
 	reply = (struct rpc_reply_hdr *)server_xdr.out_buf;
 
@@ -625,18 +669,127 @@ EXPORT_SYMBOL(msm_rpc_server_cb_req2);
 
 void msm_rpc_server_get_requesting_client(struct msm_rpc_client_info *clnt_info)
 {
+	struct msm_rpc_server *server;
+
 	if (!clnt_info)
 		return;
 
-	get_requesting_client(endpoint, current_xid, clnt_info);
+	/* requests for a program are serialized on its worker, so the
+	 * server whose worker is running carries the xid being handled
+	 */
+	mutex_lock(&rpc_server_list_lock);
+	list_for_each_entry(server, &rpc_server_list, list) {
+		if (server->req_task == current) {
+			mutex_unlock(&rpc_server_list_lock);
+			get_requesting_client(endpoint, server->current_xid,
+					      clnt_info);
+			return;
+		}
+	}
+	mutex_unlock(&rpc_server_list_lock);
 }
 
-static int rpc_servers_thread(void *data)
+static void rpc_server_handle_req(struct work_struct *work)
 {
-	void *buffer, *buf;
+	struct rpc_server_req *req_work =
+		container_of(work, struct rpc_server_req, work);
+	struct msm_rpc_server *server = req_work->server;
+	struct rpc_request_hdr *req1 = req_work->buffer;
 	struct rpc_request_hdr req;
+	struct msm_rpc_xdr xdr;
+	int rc;
+
+	xdr_init(&xdr);
+	xdr.ept = endpoint;
+	xdr_init_input(&xdr, req_work->buffer, req_work->len);
+	xdr_recv_req(&xdr, &req);
+
+	server->req_task = current;
+	server->current_xid = req1->xid;
+
+	if (server->version == 2)
+		rc = server->rpc_call2(server, &req, &xdr);
+	else {
+		req1->type = be32_to_cpu(req1->type);
+		req1->xid = be32_to_cpu(req1->xid);
+		req1->rpc_vers = be32_to_cpu(req1->rpc_vers);
+		req1->prog = be32_to_cpu(req1->prog);
+		req1->vers = be32_to_cpu(req1->vers);
+		req1->procedure = be32_to_cpu(req1->procedure);
+
+		rc = server->rpc_call(server, req1, req_work->len);
+	}
+
+/* LGE_CHANGES_S [hoonylove004@lge.com] 2009-12-29, [VS740] AT CMD */
+/* Factory AT CMD feature added based on EVE */
+#ifdef CONFIG_LGE_SUPPORT_AT_CMD
+	switch (rc) {
+	case 0:
+		msm_rpc_server_start_accepted_reply(
+			server, req.xid,
+			RPC_ACCEPTSTAT_SUCCESS);
+		msm_rpc_server_send_accepted_reply(server, 0);
+
+		break;
+	
+	/* LGE_CHANGES LGE_FACTORY_AT_COMMANDS  */
+	// give Error result to ARM9 AT Command
+	case RPC_RETURN_RESULT_OK:
+	case RPC_RETURN_RESULT_ERROR:
+		{
+	  /*
+		for(loop = 0; loop < MAX_STRING_RET && server->retvalue.ret_string[loop]; loop++)
+			{
+			// too much print may occurs ARM9 crash !!!
+			printk(KERN_INFO"1returnString[%d] =%d\n", loop, server->retvalue.ret_string[loop]);
+			}
+		*/
+		}
+	case RPC_RETURN_RESULT_MIDDLE_OK:
+		AT_rpc_send_accepted_void_reply(
+			endpoint, req.xid,
+			(rc), server);
+
+		break;
+	/* LGE_CHANGES LGE_FACTORY_AT_COMMANDS  */
+
+	
+	default:
+		if (rc < 0) {
+		msm_rpc_server_start_accepted_reply(
+			server, req.xid,
+			RPC_ACCEPTSTAT_PROC_UNAVAIL);
+		msm_rpc_server_send_accepted_reply(server, 0);
+		}
+
+		break;
+	}
+#else	/* origin */
+	if (rc == 0) {
+		msm_rpc_server_start_accepted_reply(
+			server, req.xid,
+			RPC_ACCEPTSTAT_SUCCESS);
+		msm_rpc_server_send_accepted_reply(server, 0);
+	} else if (rc < 0) {
+		msm_rpc_server_start_accepted_reply(
+			server, req.xid,
+			RPC_ACCEPTSTAT_PROC_UNAVAIL);
+		msm_rpc_server_send_accepted_reply(server, 0);
+	}
+#endif
+/* LGE_CHANGES_E [hoonylove004@lge.com] 2009-12-29, [VS740] */	
+
+	xdr_clean_input(&xdr);
+	kfree(req_work);
+	rpc_req_put();
+}
+
+static int rpc_servers_thread(void *data)
+{
+	struct rpc_server_req *req_work;
 	struct rpc_request_hdr *req1;
 	struct msm_rpc_server *server;
+	void *buffer, *buf;
 	int rc;
 
 	xdr_init(&server_xdr);
@@ -661,99 +814,48 @@ static int rpc_servers_thread(void *data)
 			break;
 		}
 
-		req1 = (struct rpc_request_hdr *)buffer;
-		current_xid = req1->xid;
+		if (rc < (int)sizeof(struct rpc_request_hdr)) {
+			kfree(buffer);
+			continue;
+		}
 
-		xdr_init_input(&server_xdr, buffer, rc);
-		xdr_recv_req(&server_xdr, &req);
+		req1 = (struct rpc_request_hdr *)buffer;
 
-		server = rpc_server_find(req.prog, req.vers);
+		if ((be32_to_cpu(req1->rpc_vers) != 2) ||
+		    (be32_to_cpu(req1->type) != 0)) {
+			kfree(buffer);
+			continue;
+		}
 
-		if (req.rpc_vers != 2)
-			goto free_buffer;
-		if (req.type != 0)
-			goto free_buffer;
+		server = rpc_server_find(be32_to_cpu(req1->prog),
+					 be32_to_cpu(req1->vers));
 		if (!server) {
 			rpc_send_accepted_void_reply(
-				endpoint, req.xid,
+				endpoint, be32_to_cpu(req1->xid),
 				RPC_ACCEPTSTAT_PROG_UNAVAIL);
-			goto free_buffer;
+			kfree(buffer);
+			continue;
 		}
 
-		if (server->version == 2)
-			rc = server->rpc_call2(server, &req, &server_xdr);
-		else {
-			req1->type = be32_to_cpu(req1->type);
-			req1->xid = be32_to_cpu(req1->xid);
-			req1->rpc_vers = be32_to_cpu(req1->rpc_vers);
-			req1->prog = be32_to_cpu(req1->prog);
-			req1->vers = be32_to_cpu(req1->vers);
-			req1->procedure = be32_to_cpu(req1->procedure);
-
-			rc = server->rpc_call(server, req1, rc);
+		req_work = kmalloc(sizeof(*req_work), GFP_KERNEL);
+		if (!req_work) {
+			rpc_send_accepted_void_reply(
+				endpoint, be32_to_cpu(req1->xid),
+				RPC_ACCEPTSTAT_SYSTEM_ERR);
+			kfree(buffer);
+			continue;
 		}
 
-/* LGE_CHANGES_S [hoonylove004@lge.com] 2009-12-29, [VS740] AT CMD */
-/* Factory AT CMD feature added based on EVE */
-#ifdef CONFIG_LGE_SUPPORT_AT_CMD
-		switch (rc) {
-		case 0:
-			msm_rpc_server_start_accepted_reply(
-				server, req.xid,
-				RPC_ACCEPTSTAT_SUCCESS);
-			msm_rpc_server_send_accepted_reply(server, 0);
-
-			break;
-		
-		/* LGE_CHANGES LGE_FACTORY_AT_COMMANDS  */
-		// give Error result to ARM9 AT Command
-		case RPC_RETURN_RESULT_OK:
-		case RPC_RETURN_RESULT_ERROR:
-			{
-		  /*
-			for(loop = 0; loop < MAX_STRING_RET && server->retvalue.ret_string[loop]; loop++)
-				{
-				// too much print may occurs ARM9 crash !!!
-				printk(KERN_INFO"1returnString[%d] =%d\n", loop, server->retvalue.ret_string[loop]);
-				}
-			*/
-			}
-		case RPC_RETURN_RESULT_MIDDLE_OK:
-			AT_rpc_send_accepted_void_reply(
-				endpoint, req.xid,
-				(rc), server);
+		/* hand the call to the server's own queue so a slow
+		 * handler only delays calls for its program
+		 */
+		INIT_WORK(&req_work->work, rpc_server_handle_req);
+		req_work->server = server;
+		req_work->buffer = buffer;
+		req_work->len = rc;
 
-			break;
-		/* LGE_CHANGES LGE_FACTORY_AT_COMMANDS  */
-
-		
-		default:
-			if (rc < 0) {
-			msm_rpc_server_start_accepted_reply(
-				server, req.xid,
-				RPC_ACCEPTSTAT_PROC_UNAVAIL);
-			msm_rpc_server_send_accepted_reply(server, 0);
-			}
-
-			break;
-		}
-#else	/* origin */
-		if (rc == 0) {
-			msm_rpc_server_start_accepted_reply(
-				server, req.xid,
-				RPC_ACCEPTSTAT_SUCCESS);
-			msm_rpc_server_send_accepted_reply(server, 0);
-		} else if (rc < 0) {
-			msm_rpc_server_start_accepted_reply(
-				server, req.xid,
-				RPC_ACCEPTSTAT_PROC_UNAVAIL);
-			msm_rpc_server_send_accepted_reply(server, 0);
-		}
-#endif
-/* LGE_CHANGES_E [hoonylove004@lge.com] 2009-12-29, [VS740] */	
- free_buffer:
-		xdr_clean_input(&server_xdr);
-		server_xdr.out_index = 0;
+		rpc_req_get();
+		queue_work(server->workqueue, &req_work->work);
 	}
 	do_exit(0);
 }
@@ -768,7 +870,6 @@ static int rpcservers_probe(struct platform_device *pdev)
 
 	/* we're online -- register any servers installed beforehand */
 	rpc_servers_active = 1;
-	current_xid = 0;
 	rpc_server_register_all();
 
 	/* start the kernel thread */
@@ -790,6 +891,8 @@ static struct platform_driver rpcservers_driver = {
 static int __init rpc_servers_init(void)
 {
 	wake_lock_init(&rpc_servers_wake_lock, WAKE_LOCK_SUSPEND, "rpc_server");
+	wake_lock_init(&rpc_servers_work_wake_lock, WAKE_LOCK_SUSPEND,
+		       "rpc_server_req");
 	return platform_driver_register(&rpcservers_driver);
 }
 
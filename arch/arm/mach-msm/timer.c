@@ -22,6 +22,8 @@
 #include <linux/delay.h>
 #include <linux/io.h>
 #include <linux/percpu.h>
+#include <linux/seqlock.h>
+#include <linux/timer.h>
 
 #include <asm/mach/time.h>
 #include <mach/msm_iomap.h>
@@ -944,34 +946,74 @@ int __init msm_timer_init_time_sync(void (*timeout)(void))
 }
 
 
+/*
+ * Free-running sched_clock on the global timer.  Readers only share a
+ * seqlock-protected epoch and do the cycle-to-ns conversion themselves
+ * with the clocksource's mult/shift, so the common path is a counter
+ * read plus a multiply instead of a contended spinlock.  The epoch is
+ * folded forward from a timer well before the hardware count can wrap,
+ * and the clocksource read already applies the sleep offset, so time
+ * stays monotonic across suspend.
+ */
+static DEFINE_SEQLOCK(msm_sched_clock_lock);
+static cycle_t msm_sched_clock_epoch_cyc;
+static unsigned long long msm_sched_clock_epoch_ns;
+static unsigned long msm_sched_clock_interval;
+
+static void msm_sched_clock_poll(unsigned long data);
+static DEFINE_TIMER(msm_sched_clock_timer, msm_sched_clock_poll, 0, 0);
+
 unsigned long long sched_clock(void)
 {
-	static cycle_t last_ticks;
-	static unsigned long long last_ns;
-	static DEFINE_SPINLOCK(msm_timer_sched_clock_lock);
+	struct clocksource *cs = &msm_clocks[MSM_GLOBAL_TIMER].clocksource;
+	unsigned long long epoch_ns;
+	cycle_t cyc, epoch_cyc;
+	unsigned seq;
 
-	struct msm_clock *clock;
-	struct clocksource *cs;
-	cycle_t ticks, delta;
-	unsigned long irq_flags;
+	do {
+		seq = read_seqbegin(&msm_sched_clock_lock);
+		epoch_cyc = msm_sched_clock_epoch_cyc;
+		epoch_ns = msm_sched_clock_epoch_ns;
+	} while (read_seqretry(&msm_sched_clock_lock, seq));
+
+	cyc = cs->read(cs);
+
+	return epoch_ns + clocksource_cyc2ns((cyc - epoch_cyc) & cs->mask,
+					     cs->mult, cs->shift);
+}
 
-	clock = &msm_clocks[MSM_GLOBAL_TIMER];
-	cs = &clock->clocksource;
+static void msm_sched_clock_poll(unsigned long data)
+{
+	struct clocksource *cs = &msm_clocks[MSM_GLOBAL_TIMER].clocksource;
+	unsigned long flags;
+	cycle_t cyc;
 
-	ticks  = cs->read(cs);
+	cyc = cs->read(cs);
 
-	spin_lock_irqsave(&msm_timer_sched_clock_lock, irq_flags);
-	delta = (ticks - last_ticks) & cs->mask;
+	write_seqlock_irqsave(&msm_sched_clock_lock, flags);
+	msm_sched_clock_epoch_ns += clocksource_cyc2ns(
+			(cyc - msm_sched_clock_epoch_cyc) & cs->mask,
+			cs->mult, cs->shift);
+	msm_sched_clock_epoch_cyc = cyc;
+	write_sequnlock_irqrestore(&msm_sched_clock_lock, flags);
 
-	if (delta < cs->mask/2) {
-		last_ticks += delta;
-		last_ns += clocksource_cyc2ns(delta, cs->mult, cs->shift);
-	}
+	mod_timer(&msm_sched_clock_timer,
+		  round_jiffies(jiffies + msm_sched_clock_interval));
+}
 
-	ticks = last_ticks;
-	spin_unlock_irqrestore(&msm_timer_sched_clock_lock, irq_flags);
+static void __init msm_sched_clock_init(void)
+{
+	struct clocksource *cs = &msm_clocks[MSM_GLOBAL_TIMER].clocksource;
+	unsigned long long half_ns;
+
+	/* Fold the epoch forward at least twice per counter wrap */
+	half_ns = clocksource_cyc2ns(cs->mask >> 1, cs->mult, cs->shift);
+	msm_sched_clock_interval = msecs_to_jiffies(half_ns >> 20);
+	if (!msm_sched_clock_interval)
+		msm_sched_clock_interval = 1;
 
-	return last_ns;
+	mod_timer(&msm_sched_clock_timer,
+		  round_jiffies(jiffies + msm_sched_clock_interval));
 }
 
 #ifdef CONFIG_ARCH_MSM_SCORPIONMP
@@ -1035,6 +1077,9 @@ static void __init msm_timer_init(void)
 
 		clockevents_register_device(ce);
 	}
+
+	msm_sched_clock_init();
+
 #ifdef CONFIG_ARCH_MSM_SCORPIONMP
 	writel(1, msm_clocks[MSM_CLOCK_DGT].regbase + TIMER_ENABLE);
 	set_delay_fn(read_current_timer_delay_loop);
@@ -20,6 +20,9 @@
 #include <linux/init.h>
 #include <linux/debugfs.h>
 #include <linux/string.h>
+#include <linux/delay.h>
+#include <linux/ktime.h>
+#include <linux/err.h>
 #include <mach/vreg.h>
 
 #include "proc_comm.h"
@@ -150,6 +153,77 @@ int vreg_set_level(struct vreg *vreg, unsigned mv)
 }
 EXPORT_SYMBOL(vreg_set_level);
 
+/*
+ * Enable an ordered list of regulators, overlapping their settle times.
+ *
+ * Each step still costs one or two proc_comm round trips (the protocol
+ * has no multi-command form and runs on the modem's schedule), but the
+ * rails ramp while the later commands are in flight: the enables are
+ * issued back to back and a single wait at the end covers whatever part
+ * of each step's settle time has not already elapsed.  For a sequence
+ * of N independent rails this replaces the sum of the worst-case settle
+ * delays with roughly the largest one.
+ *
+ * The steps must be independent rails: the enable commands are issued
+ * in list order, but no step's settle time is allowed to complete
+ * before a later step is started.  Sequences where a rail must be
+ * stable before the next action (or that interleave GPIO/I2C steps)
+ * must keep their explicit delays.
+ *
+ * There is no apps-side readback of PMIC rail status on this target,
+ * so the settle times remain the worst-case numbers from the board
+ * files.  On failure every rail already enabled by this call is
+ * disabled again.  May be called from contexts that cannot sleep; the
+ * residual wait busy-waits like the mdelay()s it replaces.
+ */
+int vreg_sequence_enable(const struct vreg_seq_step *steps, int nsteps)
+{
+	ktime_t deadline = ktime_set(0, 0);
+	s64 remaining;
+	int i, rc;
+
+	for (i = 0; i < nsteps; i++) {
+		struct vreg *vreg = vreg_get(NULL, steps[i].name);
+		ktime_t ready;
+
+		if (IS_ERR(vreg)) {
+			rc = PTR_ERR(vreg);
+			goto unwind;
+		}
+		if (steps[i].mv) {
+			rc = vreg_set_level(vreg, steps[i].mv);
+			if (rc)
+				goto unwind;
+		}
+		rc = vreg_enable(vreg);
+		if (rc)
+			goto unwind;
+
+		/* the rail ramps while the following steps are issued */
+		ready = ktime_add_us(ktime_get(), steps[i].settle_us);
+		if (ready.tv64 > deadline.tv64)
+			deadline = ready;
+	}
+
+	remaining = ktime_us_delta(deadline, ktime_get());
+	while (remaining > 1000) {
+		mdelay(1);
+		remaining -= 1000;
+	}
+	if (remaining > 0)
+		udelay(remaining);
+
+	return 0;
+
+unwind:
+	pr_err("%s: step %d (%s) failed (%d)\n", __func__, i,
+	       steps[i].name, rc);
+	while (--i >= 0)
+		vreg_disable(vreg_get(NULL, steps[i].name));
+	return rc;
+}
+EXPORT_SYMBOL(vreg_sequence_enable);
+
 #if defined(CONFIG_DEBUG_FS)
 
 static int vreg_debug_set(void *data, u64 val)
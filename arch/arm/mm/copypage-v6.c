@@ -17,6 +17,7 @@
 #include <asm/tlbflush.h>
 #include <asm/cacheflush.h>
 #include <asm/cachetype.h>
+#include <asm/system.h>
 
 #include "mm.h"
 
@@ -29,6 +30,17 @@
 
 static DEFINE_SPINLOCK(v6_lock);
 
+/*
+ * Prefetch-tuned page copy/clear loops, arch/arm/lib/copy_page_pld.S.
+ * The right copy variant depends on the core's memory pipeline depth
+ * and is picked once at boot in v6_userpage_init().
+ */
+extern void copy_page_v6(void *to, const void *from);
+extern void copy_page_v7(void *to, const void *from);
+extern void clear_page_v6(void *to);
+
+static void (*fast_copy_page)(void *to, const void *from) = copy_page_v6;
+
 /*
  * Copy the user page.  No aliasing to deal with so we can just
  * attack the kernel's existing mapping of these pages.
@@ -40,7 +52,7 @@ static void v6_copy_user_highpage_nonaliasing(struct page *to,
 
 	kfrom = kmap_atomic(from, KM_USER0);
 	kto = kmap_atomic(to, KM_USER1);
-	copy_page(kto, kfrom);
+	fast_copy_page(kto, kfrom);
 	__cpuc_flush_dcache_area(kto, PAGE_SIZE);
 	kunmap_atomic(kto, KM_USER1);
 	kunmap_atomic(kfrom, KM_USER0);
@@ -53,7 +65,7 @@ static void v6_copy_user_highpage_nonaliasing(struct page *to,
 static void v6_clear_user_highpage_nonaliasing(struct page *page, unsigned long vaddr)
 {
 	void *kaddr = kmap_atomic(page, KM_USER0);
-	clear_page(kaddr);
+	clear_page_v6(kaddr);
 	kunmap_atomic(kaddr, KM_USER0);
 }
 
@@ -141,6 +153,8 @@ static int __init v6_userpage_init(void)
 	if (cache_is_vipt_aliasing()) {
 		cpu_user.cpu_clear_user_highpage = v6_clear_user_highpage_aliasing;
 		cpu_user.cpu_copy_user_highpage = v6_copy_user_highpage_aliasing;
+	} else if (cpu_architecture() >= CPU_ARCH_ARMv7) {
+		fast_copy_page = copy_page_v7;
 	}
 
 	return 0;
@@ -395,6 +395,115 @@ void dma_free_coherent(struct device *dev, size_t size, void *cpu_addr, dma_addr
 }
 EXPORT_SYMBOL(dma_free_coherent);
 
+#ifdef CONFIG_DMA_LAZY_SYNC
+/*
+ * Lazy maintenance for designated long-lived streaming DMA buffers.
+ *
+ * Audio and network drivers sync the same buffers thousands of times a
+ * second, and most of those syncs find nothing in the cache: the CPU
+ * has not touched the buffer since the previous operation.  A driver
+ * can register such a buffer with its DMA direction; syncs in that
+ * direction are then skipped while the buffer is clean, and the driver
+ * reports CPU access with dma_lazy_touch().  Only syncs matching the
+ * registered direction are ever skipped - a TO_DEVICE clean leaves
+ * valid lines in the cache, so mixed-direction use must always take
+ * the full path.  A sync covering the whole registered range marks the
+ * buffer clean again.
+ */
+#define DMA_LAZY_MAX_BUFFERS	8
+
+struct dma_lazy_buf {
+	const void *kaddr;	/* NULL = slot free */
+	size_t size;
+	enum dma_data_direction dir;
+	int dirty;
+};
+
+static struct dma_lazy_buf dma_lazy_bufs[DMA_LAZY_MAX_BUFFERS];
+static DEFINE_SPINLOCK(dma_lazy_lock);
+
+int dma_lazy_register(const void *kaddr, size_t size,
+	enum dma_data_direction dir)
+{
+	unsigned long flags;
+	int i;
+
+	if (dir != DMA_TO_DEVICE && dir != DMA_FROM_DEVICE)
+		return -EINVAL;
+
+	spin_lock_irqsave(&dma_lazy_lock, flags);
+	for (i = 0; i < DMA_LAZY_MAX_BUFFERS; i++) {
+		if (dma_lazy_bufs[i].kaddr)
+			continue;
+		dma_lazy_bufs[i].size = size;
+		dma_lazy_bufs[i].dir = dir;
+		dma_lazy_bufs[i].dirty = 1;
+		/* kaddr last: a NULL kaddr keeps lookups off the slot */
+		smp_wmb();
+		dma_lazy_bufs[i].kaddr = kaddr;
+		spin_unlock_irqrestore(&dma_lazy_lock, flags);
+		return 0;
+	}
+	spin_unlock_irqrestore(&dma_lazy_lock, flags);
+	return -ENOSPC;
+}
+EXPORT_SYMBOL(dma_lazy_register);
+
+void dma_lazy_unregister(const void *kaddr)
+{
+	unsigned long flags;
+	int i;
+
+	spin_lock_irqsave(&dma_lazy_lock, flags);
+	for (i = 0; i < DMA_LAZY_MAX_BUFFERS; i++)
+		if (dma_lazy_bufs[i].kaddr == kaddr)
+			dma_lazy_bufs[i].kaddr = NULL;
+	spin_unlock_irqrestore(&dma_lazy_lock, flags);
+}
+EXPORT_SYMBOL(dma_lazy_unregister);
+
+/* the CPU has read or written the buffer since the last sync */
+void dma_lazy_touch(const void *kaddr)
+{
+	int i;
+
+	for (i = 0; i < DMA_LAZY_MAX_BUFFERS; i++)
+		if (dma_lazy_bufs[i].kaddr == kaddr)
+			dma_lazy_bufs[i].dirty = 1;
+}
+EXPORT_SYMBOL(dma_lazy_touch);
+
+/* returns nonzero when the maintenance op for this range may be skipped */
+static int dma_lazy_skip(const void *kaddr, size_t size,
+	enum dma_data_direction dir)
+{
+	struct dma_lazy_buf *buf;
+	int i;
+
+	for (i = 0; i < DMA_LAZY_MAX_BUFFERS; i++) {
+		buf = &dma_lazy_bufs[i];
+		if (!buf->kaddr || dir != buf->dir)
+			continue;
+		if (kaddr < buf->kaddr ||
+		    kaddr + size > buf->kaddr + buf->size)
+			continue;
+		if (!buf->dirty)
+			return 1;
+		/* only a full-range sync proves the whole buffer clean */
+		if (kaddr == buf->kaddr && size == buf->size)
+			buf->dirty = 0;
+		return 0;
+	}
+	return 0;
+}
+#else
+static inline int dma_lazy_skip(const void *kaddr, size_t size,
+	enum dma_data_direction dir)
+{
+	return 0;
+}
+#endif /* CONFIG_DMA_LAZY_SYNC */
+
 /*
  * Make an area consistent for devices.
  * Note: Drivers should NOT use this function directly, as it will break
@@ -410,6 +519,9 @@ void ___dma_single_cpu_to_dev(const void *kaddr, size_t size,
 	BUG_ON(!virt_addr_valid(kaddr) || !virt_addr_valid(kaddr + size - 1));
 #endif
 
+	if (dma_lazy_skip(kaddr, size, dir))
+		return;
+
 	dmac_map_area(kaddr, size, dir);
 
 #ifdef CONFIG_OUTER_CACHE
@@ -427,6 +539,9 @@ EXPORT_SYMBOL(___dma_single_cpu_to_dev);
 void ___dma_single_dev_to_cpu(const void *kaddr, size_t size,
 	enum dma_data_direction dir)
 {
+	if (dma_lazy_skip(kaddr, size, dir))
+		return;
+
 #ifdef CONFIG_OUTER_CACHE
 	BUG_ON(!virt_addr_valid(kaddr) || !virt_addr_valid(kaddr + size - 1));
 
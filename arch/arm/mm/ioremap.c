@@ -277,7 +277,20 @@ void __iomem * __arm_ioremap_pfn_caller(unsigned long pfn,
 	 */
 	size = PAGE_ALIGN(offset + size);
 
-	area = get_vm_area_caller(size, VM_IOREMAP, caller);
+#ifndef CONFIG_SMP
+	/*
+	 * When the physical range can be section mapped, ask for a
+	 * section aligned virtual area as well, otherwise the page
+	 * aligned address handed back below almost never satisfies
+	 * the alignment test and large carveouts (framebuffer, gpu,
+	 * pmem) end up mapped with 4K pages, wasting TLB entries.
+	 */
+	if (!((__pfn_to_phys(pfn) | size) & ~PMD_MASK))
+		area = get_vm_area_aligned_caller(size, PMD_SIZE,
+						  VM_IOREMAP, caller);
+	else
+#endif
+		area = get_vm_area_caller(size, VM_IOREMAP, caller);
  	if (!area)
  		return NULL;
  	addr = (unsigned long)area->addr;
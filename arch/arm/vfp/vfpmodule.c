@@ -123,13 +123,29 @@ static int vfp_notifier(struct notifier_block *self, unsigned long cmd, void *v)
 		 */
 		if (thread->vfpstate.hard.cpu != cpu)
 			last_VFP_context[cpu] = NULL;
-#endif
 
 		/*
 		 * Always disable VFP so we can lazily save/restore the
 		 * old state.
 		 */
 		fmxr(FPEXC, fpexc & ~FPEXC_EN);
+#else
+		/*
+		 * On UP the save/restore is already lazy: with the
+		 * enable bit clear the next VFP instruction bounces to
+		 * the support code, which reloads state only when some
+		 * other thread's context owns the hardware.  When the
+		 * incoming thread's state is still resident that bounce
+		 * does nothing but set the enable bit again, so do that
+		 * here and skip the exception round trip.  With Dalvik
+		 * making most threads VFP users, resident-and-reused is
+		 * the common case at high switch rates.
+		 */
+		if (last_VFP_context[0] == &thread->vfpstate)
+			fmxr(FPEXC, fpexc | FPEXC_EN);
+		else
+			fmxr(FPEXC, fpexc & ~FPEXC_EN);
+#endif
 		return NOTIFY_DONE;
 	}
 
@@ -65,6 +65,9 @@ static inline void bfq_group_init_entity(struct bfqio_cgroup *bgrp,
 	entity->ioprio_class = entity->new_ioprio_class = bgrp->ioprio_class;
 	entity->ioprio_changed = 1;
 	entity->my_sched_data = &bfqg->sched_data;
+
+	bfqg->max_bps = bgrp->max_bps;
+	bfqg->rate_last_refill = jiffies;
 }
 
 static inline void bfq_group_set_parent(struct bfq_group *bfqg,
@@ -586,6 +589,172 @@ STORE_FUNCTION(ioprio, 0, IOPRIO_BE_NR - 1);
 STORE_FUNCTION(ioprio_class, IOPRIO_CLASS_RT, IOPRIO_CLASS_IDLE);
 #undef STORE_FUNCTION
 
+static u64 bfqio_cgroup_max_bps_read(struct cgroup *cgroup,
+				     struct cftype *cftype)
+{
+	struct bfqio_cgroup *bgrp;
+	u64 ret;
+
+	if (!cgroup_lock_live_group(cgroup))
+		return -ENODEV;
+
+	bgrp = cgroup_to_bfqio(cgroup);
+	spin_lock_irq(&bgrp->lock);
+	ret = bgrp->max_bps;
+	spin_unlock_irq(&bgrp->lock);
+
+	cgroup_unlock();
+
+	return ret;
+}
+
+/*
+ * The byte rate limit cannot go through STORE_FUNCTION(), which is
+ * tailored to the unsigned short parameters mirrored into the group
+ * entities; the limit lives directly in the bfq_groups.  Resetting the
+ * bucket on every write makes a new limit effective immediately.
+ */
+static int bfqio_cgroup_max_bps_write(struct cgroup *cgroup,
+				      struct cftype *cftype, u64 val)
+{
+	struct bfqio_cgroup *bgrp;
+	struct bfq_group *bfqg;
+	struct hlist_node *n;
+
+	if (val > ULONG_MAX)
+		return -EINVAL;
+
+	if (!cgroup_lock_live_group(cgroup))
+		return -ENODEV;
+
+	bgrp = cgroup_to_bfqio(cgroup);
+
+	spin_lock_irq(&bgrp->lock);
+	bgrp->max_bps = val;
+	hlist_for_each_entry(bfqg, n, &bgrp->group_data, group_node) {
+		bfqg->max_bps = val;
+		bfqg->rate_quota = 0;
+		bfqg->rate_last_refill = jiffies;
+	}
+	spin_unlock_irq(&bgrp->lock);
+
+	cgroup_unlock();
+
+	return 0;
+}
+
+/*
+ * Sum the service statistics of the groups of this cgroup over all the
+ * devices it has done I/O upon.  A device whose scheduler is being torn
+ * down is skipped; its counters are about to disappear anyway.
+ */
+static int bfqio_cgroup_stats_read(struct cgroup *cgroup,
+				   struct cftype *cftype,
+				   struct seq_file *m)
+{
+	struct bfqio_cgroup *bgrp;
+	struct bfq_group *bfqg;
+	struct hlist_node *n;
+	struct bfq_data *bfqd;
+	unsigned long uninitialized_var(flags);
+	unsigned long sectors = 0, ios = 0, wait = 0, throttled = 0;
+
+	if (!cgroup_lock_live_group(cgroup))
+		return -ENODEV;
+
+	bgrp = cgroup_to_bfqio(cgroup);
+
+	rcu_read_lock();
+	hlist_for_each_entry_rcu(bfqg, n, &bgrp->group_data, group_node) {
+		bfqd = bfq_get_bfqd_locked(&bfqg->bfqd, &flags);
+		if (bfqd == NULL)
+			continue;
+		sectors += bfqg->stat_sectors;
+		ios += bfqg->stat_ios;
+		wait += bfqg->stat_wait_jiffies;
+		throttled += bfqg->stat_throttled;
+		bfq_put_bfqd_unlock(bfqd, &flags);
+	}
+	rcu_read_unlock();
+
+	cgroup_unlock();
+
+	seq_printf(m, "sectors %lu\n", sectors);
+	seq_printf(m, "ios %lu\n", ios);
+	seq_printf(m, "wait_ms %u\n", jiffies_to_msecs(wait));
+	seq_printf(m, "throttled %lu\n", throttled);
+
+	return 0;
+}
+
+/**
+ * bfq_boost_group_queues - re-apply weight-raising to the queues of @bfqg.
+ * @bfqd: the device the group acts upon.
+ * @bfqg: the group whose queues are to be boosted.
+ *
+ * Walk all the queues active or idle on @bfqd and restart a boosting
+ * period for the sync ones scheduled inside @bfqg.  Must be called with
+ * the queue lock held.
+ */
+static void bfq_boost_group_queues(struct bfq_data *bfqd,
+				   struct bfq_group *bfqg)
+{
+	struct bfq_queue *bfqq;
+
+	if (!bfqd->low_latency)
+		return;
+
+	list_for_each_entry(bfqq, &bfqd->active_list, bfqq_list)
+		if (bfq_bfqq_sync(bfqq) &&
+		    bfqq->entity.sched_data == &bfqg->sched_data)
+			bfq_bfqq_boost(bfqd, bfqq);
+	list_for_each_entry(bfqq, &bfqd->idle_list, bfqq_list)
+		if (bfq_bfqq_sync(bfqq) &&
+		    bfqq->entity.sched_data == &bfqg->sched_data)
+			bfq_bfqq_boost(bfqd, bfqq);
+}
+
+/*
+ * Writing a non-zero value restarts a weight-raising period for all the
+ * sync queues of the cgroup, on all the devices it is doing I/O upon.
+ * Userspace (e.g. the activity manager) triggers this when the
+ * application owning the cgroup returns to foreground, so that its
+ * cold-restart faults receive the same interactive treatment as the
+ * I/O of a freshly started task.  The value is a pure trigger and is
+ * never stored.
+ */
+static int bfqio_cgroup_boost_write(struct cgroup *cgroup,
+				    struct cftype *cftype, u64 val)
+{
+	struct bfqio_cgroup *bgrp;
+	struct bfq_group *bfqg;
+	struct hlist_node *n;
+	struct bfq_data *bfqd;
+	unsigned long uninitialized_var(flags);
+
+	if (!cgroup_lock_live_group(cgroup))
+		return -ENODEV;
+
+	bgrp = cgroup_to_bfqio(cgroup);
+
+	if (val != 0) {
+		rcu_read_lock();
+		hlist_for_each_entry_rcu(bfqg, n, &bgrp->group_data,
+					 group_node) {
+			bfqd = bfq_get_bfqd_locked(&bfqg->bfqd, &flags);
+			if (bfqd == NULL)
+				continue;
+			bfq_boost_group_queues(bfqd, bfqg);
+			bfq_put_bfqd_unlock(bfqd, &flags);
+		}
+		rcu_read_unlock();
+	}
+
+	cgroup_unlock();
+
+	return 0;
+}
+
 static struct cftype bfqio_files[] = {
 	{
 		.name = "weight",
@@ -602,6 +771,19 @@ static struct cftype bfqio_files[] = {
 		.read_u64 = bfqio_cgroup_ioprio_class_read,
 		.write_u64 = bfqio_cgroup_ioprio_class_write,
 	},
+	{
+		.name = "boost",
+		.write_u64 = bfqio_cgroup_boost_write,
+	},
+	{
+		.name = "max_bps",
+		.read_u64 = bfqio_cgroup_max_bps_read,
+		.write_u64 = bfqio_cgroup_max_bps_write,
+	},
+	{
+		.name = "stats",
+		.read_seq_string = bfqio_cgroup_stats_read,
+	},
 };
 
 static int bfqio_populate(struct cgroup_subsys *subsys, struct cgroup *cgroup)
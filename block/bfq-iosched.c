@@ -59,6 +59,7 @@
 #include <linux/elevator.h>
 #include <linux/rbtree.h>
 #include <linux/ioprio.h>
+#include <linux/seq_file.h>
 #include "bfq.h"
 
 /* Max number of dispatches in one round of service. */
@@ -347,6 +348,26 @@ static void bfq_updated_next_req(struct bfq_data *bfqd,
 	bfq_activate_bfqq(bfqd, bfqq);
 }
 
+/**
+ * bfq_bfqq_boost - start a weight-raising period for @bfqq.
+ * @bfqd: the device data.
+ * @bfqq: the queue to boost.
+ *
+ * Give @bfqq a full boosting budget, as if it had just been activated
+ * after a long idle period.  Besides the activation path, this is used
+ * by the cgroup interface to re-apply weight-raising on demand to the
+ * queues of an application brought back to foreground, which would
+ * otherwise serve their cold faults with the old, plain weight.
+ */
+static void bfq_bfqq_boost(struct bfq_data *bfqd, struct bfq_queue *bfqq)
+{
+	bfqq->high_weight_budget = BFQ_BOOST_BUDGET;
+	bfqq->entity.ioprio_changed = 1;
+	bfq_log_bfqq(bfqd, bfqq, "wboost starting at %lu msec",
+		     bfqq->last_activation_time);
+	bfqq->last_activation_time = jiffies_to_msecs(jiffies);
+}
+
 static void bfq_add_rq_rb(struct request *rq)
 {
 	struct bfq_queue *bfqq = RQ_BFQQ(rq);
@@ -381,16 +402,12 @@ static void bfq_add_rq_rb(struct request *rq)
 		 * for enough time, start a boosting period
 		 */
 		if (bfqd->low_latency && bfqq->high_weight_budget == 0) {
-			if(bfqq->last_activation_time + BFQ_MIN_ACT_INTERVAL <
-			   jiffies_to_msecs(jiffies)) {
-				bfqq->high_weight_budget = BFQ_BOOST_BUDGET;
-				entity->ioprio_changed = 1;
-				bfq_log_bfqq(bfqd, bfqq,
-					     "wboost starting at %lu msec",
-					     bfqq->last_activation_time);
-			}
-			bfqq->last_activation_time =
-				jiffies_to_msecs(jiffies);
+			if (bfqq->last_activation_time + BFQ_MIN_ACT_INTERVAL <
+			    jiffies_to_msecs(jiffies))
+				bfq_bfqq_boost(bfqd, bfqq);
+			else
+				bfqq->last_activation_time =
+					jiffies_to_msecs(jiffies);
 		}
 
 		bfq_add_bfqq_busy(bfqd, bfqq);
@@ -689,6 +706,29 @@ static void __bfq_bfqq_expire(struct bfq_data *bfqd, struct bfq_queue *bfqq)
 		bfq_activate_bfqq(bfqd, bfqq);
 }
 
+/*
+ * Return the next budget for an async queue.  Async queues get the
+ * maximum possible budget when no sync queue is backlogged, as their
+ * ability to dispatch is limited by @bfqd->bfq_max_budget_async_rq
+ * anyway.  When some sync queue has pending requests, instead, shrink
+ * the budget towards the async service rate the device has actually
+ * been granting to the owning group lately, so that a stream of
+ * background writes cannot keep the disk head away from a waiting
+ * reader for a whole max_budget worth of service.
+ */
+static bfq_service_t bfq_async_next_budget(struct bfq_data *bfqd,
+					   struct bfq_queue *bfqq)
+{
+	struct bfq_group *bfqg = bfq_entity_group(&bfqq->entity);
+	bfq_service_t budget = bfqd->bfq_max_budget;
+
+	if (bfqd->busy_sync_queues > 0 && bfqg->async_rate > 0)
+		budget = max(min(budget, 2 * bfqg->async_rate),
+			     bfq_min_budget(bfqd));
+
+	return budget;
+}
+
 /**
  * __bfq_bfqq_recalc_budget - try to adapt the budget to the @bfqq behavior.
  * @bfqd: device data.
@@ -790,11 +830,12 @@ static void __bfq_bfqq_recalc_budget(struct bfq_data *bfqd,
 			return;
 		}
 	} else /* async queue */
-	    /* async queues get always the maximum possible budget
+	    /* async queues normally get the maximum possible budget
 	     * (their ability to dispatch is limited by
-	     * @bfqd->bfq_max_budget_async_rq).
+	     * @bfqd->bfq_max_budget_async_rq), but they are throttled
+	     * down while sync queues are backlogged.
 	     */
-		budget = bfqd->bfq_max_budget;
+		budget = bfq_async_next_budget(bfqd, bfqq);
 
 	bfqq->max_budget = budget;
 
@@ -1090,6 +1131,58 @@ keep_queue:
 	return bfqq;
 }
 
+/*
+ * Byte rate limiting.  Each group owns a token bucket, refilled at
+ * bfqg->max_bps bytes per second and charged at dispatch time; a group
+ * whose bucket has run dry is not served, and the rate timer restarts
+ * dispatching once enough credit should have accrued.  The bucket is
+ * allowed to go negative, so that a request larger than the accumulated
+ * credit still makes progress instead of starving the queue.
+ */
+static void bfq_group_rate_refill(struct bfq_group *bfqg)
+{
+	unsigned long now = jiffies;
+	long burst;
+
+	if (now == bfqg->rate_last_refill)
+		return;
+
+	bfqg->rate_quota += (now - bfqg->rate_last_refill) *
+		(long)(bfqg->max_bps / HZ);
+	bfqg->rate_last_refill = now;
+
+	/* Cap the credit an idle group can accrue to 250ms worth. */
+	burst = bfqg->max_bps / 4;
+	if (bfqg->rate_quota > burst)
+		bfqg->rate_quota = burst;
+}
+
+static inline int bfq_group_over_rate(struct bfq_group *bfqg)
+{
+	if (bfqg->max_bps == 0)
+		return 0;
+
+	bfq_group_rate_refill(bfqg);
+	return bfqg->rate_quota <= 0;
+}
+
+/*
+ * Restart dispatching roughly when the deficit of @bfqg will have been
+ * repaid; if the timer is already due earlier, leave it alone.
+ */
+static void bfq_group_rate_arm_timer(struct bfq_data *bfqd,
+				     struct bfq_group *bfqg)
+{
+	unsigned long delay, expire;
+
+	delay = (1 - bfqg->rate_quota) * HZ / bfqg->max_bps + 1;
+	expire = jiffies + delay;
+
+	if (!timer_pending(&bfqd->rate_timer) ||
+	    time_after(bfqd->rate_timer.expires, expire))
+		mod_timer(&bfqd->rate_timer, expire);
+}
+
 /*
  * Dispatch some requests from bfqq, moving them to the request queue
  * dispatch list.
@@ -1098,6 +1191,7 @@ static int __bfq_dispatch_requests(struct bfq_data *bfqd,
 				   struct bfq_queue *bfqq,
 				   int max_dispatch)
 {
+	struct bfq_group *bfqg = bfq_entity_group(&bfqq->entity);
 	int dispatched = 0;
 
 	BUG_ON(RB_EMPTY_ROOT(&bfqq->sort_list));
@@ -1127,6 +1221,11 @@ static int __bfq_dispatch_requests(struct bfq_data *bfqd,
 		bfq_bfqq_served(bfqq, service_to_charge);
 		bfq_dispatch_insert(bfqd->queue, rq);
 
+		bfqg->stat_ios++;
+		bfqg->stat_sectors += blk_rq_sectors(rq);
+		if (bfqg->max_bps != 0)
+			bfqg->rate_quota -= blk_rq_bytes(rq);
+
 		if (bfqq->high_weight_budget > 0) { /* queue is being boosted */
 			struct bfq_entity *entity = &bfqq->entity;
 
@@ -1168,6 +1267,10 @@ static int __bfq_dispatch_requests(struct bfq_data *bfqd,
 
 		if (RB_EMPTY_ROOT(&bfqq->sort_list))
 			break;
+
+		/* The group's bucket ran dry; stop serving it. */
+		if (bfqg->max_bps != 0 && bfqg->rate_quota <= 0)
+			break;
 	} while (dispatched < max_dispatch);
 
 	bfq_log_bfqq(bfqd, bfqq, "dispatched %d reqs", dispatched);
@@ -1234,7 +1337,7 @@ static int bfq_dispatch_requests(struct request_queue *q, int force)
 {
 	struct bfq_data *bfqd = q->elevator->elevator_data;
 	struct bfq_queue *bfqq;
-	int dispatched;
+	int dispatched, throttled;
 
 	bfq_log(bfqd, "dispatch requests: %d busy queues", bfqd->busy_queues);
 	if (bfqd->busy_queues == 0)
@@ -1244,9 +1347,29 @@ static int bfq_dispatch_requests(struct request_queue *q, int force)
 		return bfq_forced_dispatch(bfqd);
 
 	dispatched = 0;
+	throttled = 0;
 	while ((bfqq = bfq_select_queue(bfqd)) != NULL) {
+		struct bfq_group *bfqg = bfq_entity_group(&bfqq->entity);
 		int max_dispatch;
 
+		/*
+		 * An over-limit group is not served: expire the queue as
+		 * for a consumed budget, so that its finish time moves
+		 * forward and other groups win the next selections, and
+		 * retry once the bucket has been refilled.  Bound the
+		 * number of rejections per round to avoid spinning when
+		 * every backlogged queue is over its limit.
+		 */
+		if (bfq_group_over_rate(bfqg)) {
+			bfqg->stat_throttled++;
+			bfq_group_rate_arm_timer(bfqd, bfqg);
+			bfq_bfqq_expire(bfqd, bfqq, 0,
+					BFQ_BFQQ_BUDGET_TIMEOUT);
+			if (++throttled >= bfqd->busy_queues)
+				break;
+			continue;
+		}
+
 		max_dispatch = bfqd->bfq_quantum;
 		if (bfq_class_idle(bfqq))
 			max_dispatch = 1;
@@ -1703,6 +1826,9 @@ static void bfq_completed_request(struct request_queue *q, struct request *rq)
 	if (bfq_bfqq_sync(bfqq))
 		bfqd->sync_flight--;
 
+	bfq_entity_group(&bfqq->entity)->stat_wait_jiffies +=
+		jiffies - rq->start_time;
+
 	if (sync)
 		RQ_CIC(rq)->last_end_request = jiffies;
 
@@ -1921,9 +2047,25 @@ static void bfq_idle_slice_timer(unsigned long data)
 	spin_unlock_irqrestore(bfqd->queue->queue_lock, flags);
 }
 
+/*
+ * Handler of the expiration of the rate limiting timer: by now some
+ * over-limit group should have earned back enough credit, so just
+ * restart the dispatch loop.
+ */
+static void bfq_rate_timer(unsigned long data)
+{
+	struct bfq_data *bfqd = (struct bfq_data *)data;
+	unsigned long flags;
+
+	spin_lock_irqsave(bfqd->queue->queue_lock, flags);
+	bfq_schedule_dispatch(bfqd);
+	spin_unlock_irqrestore(bfqd->queue->queue_lock, flags);
+}
+
 static void bfq_shutdown_timer_wq(struct bfq_data *bfqd)
 {
 	del_timer_sync(&bfqd->idle_slice_timer);
+	del_timer_sync(&bfqd->rate_timer);
 	cancel_work_sync(&bfqd->unplug_work);
 }
 
@@ -2049,6 +2191,10 @@ static void *bfq_init_queue(struct request_queue *q)
 	bfqd->idle_slice_timer.function = bfq_idle_slice_timer;
 	bfqd->idle_slice_timer.data = (unsigned long)bfqd;
 
+	init_timer(&bfqd->rate_timer);
+	bfqd->rate_timer.function = bfq_rate_timer;
+	bfqd->rate_timer.data = (unsigned long)bfqd;
+
 	INIT_WORK(&bfqd->unplug_work, bfq_kick_queue);
 
 	INIT_LIST_HEAD(&bfqd->active_list);
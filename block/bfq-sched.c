@@ -567,6 +567,34 @@ __bfq_entity_update_weight_prio(struct bfq_service_tree *old_st,
 	return new_st;
 }
 
+/* Window, in jiffies, used to estimate the per-group async service rate. */
+#define BFQ_ASYNC_RATE_WINDOW	(HZ / 8)
+
+/**
+ * bfq_group_async_served - update the async service rate estimate of a group.
+ * @bfqg: the group that received async service.
+ * @served: the amount of service received.
+ *
+ * Accumulate the async service granted to @bfqg and, once per window,
+ * fold it into a decayed estimate of the rate the device is actually
+ * granting to the group's async queues.  The estimate is used by the
+ * budget feedback to shrink the next async budgets while sync queues
+ * are backlogged; the exponential decay makes sure that a group that
+ * stops writing quickly loses its history.
+ */
+static void bfq_group_async_served(struct bfq_group *bfqg,
+				   bfq_service_t served)
+{
+	bfqg->async_service += served;
+	if (time_after_eq(jiffies,
+			  bfqg->async_rate_start + BFQ_ASYNC_RATE_WINDOW)) {
+		bfqg->async_rate = (3 * bfqg->async_rate +
+				    bfqg->async_service) / 4;
+		bfqg->async_service = 0;
+		bfqg->async_rate_start = jiffies;
+	}
+}
+
 /**
  * bfq_bfqq_served - update the scheduler status after selection for service.
  * @bfqq: the queue being served.
@@ -581,6 +609,9 @@ static void bfq_bfqq_served(struct bfq_queue *bfqq, bfq_service_t served)
 	struct bfq_entity *entity = &bfqq->entity;
 	struct bfq_service_tree *st;
 
+	if (!bfq_bfqq_sync(bfqq))
+		bfq_group_async_served(bfq_entity_group(entity), served);
+
 	for_each_entity(entity) {
 		st = bfq_entity_service_tree(entity);
 
@@ -989,6 +1020,10 @@ static void bfq_del_bfqq_busy(struct bfq_data *bfqd, struct bfq_queue *bfqq,
 
 	BUG_ON(bfqd->busy_queues == 0);
 	bfqd->busy_queues--;
+	if (bfq_bfqq_sync(bfqq)) {
+		BUG_ON(bfqd->busy_sync_queues == 0);
+		bfqd->busy_sync_queues--;
+	}
 
 	bfq_deactivate_bfqq(bfqd, bfqq, requeue);
 }
@@ -1007,4 +1042,6 @@ static void bfq_add_bfqq_busy(struct bfq_data *bfqd, struct bfq_queue *bfqq)
 
 	bfq_mark_bfqq_busy(bfqq);
 	bfqd->busy_queues++;
+	if (bfq_bfqq_sync(bfqq))
+		bfqd->busy_sync_queues++;
 }
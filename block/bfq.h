@@ -176,6 +176,8 @@ struct bfq_group;
  * @root_group: root bfq_group for the device.
  * @busy_queues: number of bfq_queues containing requests (including the
  *		 queue under service, even if it is idling).
+ * @busy_sync_queues: number of busy sync bfq_queues; used to decide
+ *		      whether async budgets have to be shrunk.
  * @queued: number of queued requests.
  * @rq_in_driver: number of requests dispatched and waiting for completion.
  * @sync_flight: number of sync requests in the driver.
@@ -186,6 +188,9 @@ struct bfq_group;
  * @budgets_assigned: number of budgets assigned.
  * @idle_slice_timer: timer set when idling for the next sequential request
  *                    from the queue under service.
+ * @rate_timer: timer set when dispatching is stopped because every
+ *              eligible group is over its byte rate limit; fires when
+ *              some group should have earned back enough credit.
  * @unplug_work: delayed work to restart dispatching on the request queue.
  * @active_queue: bfq_queue under service.
  * @active_cic: cfq_io_context (cic) associated with the @active_queue.
@@ -225,6 +230,7 @@ struct bfq_data {
 	struct bfq_group *root_group;
 
 	int busy_queues;
+	int busy_sync_queues;
 	int queued;
 	int rq_in_driver;
 	int sync_flight;
@@ -236,6 +242,7 @@ struct bfq_data {
 	int budgets_assigned;
 
 	struct timer_list idle_slice_timer;
+	struct timer_list rate_timer;
 	struct work_struct unplug_work;
 
 	struct bfq_queue *active_queue;
@@ -404,6 +411,24 @@ enum bfqq_expiration {
  * @async_idle_bfqq: async queue for the idle class (ioprio is ignored).
  * @my_entity: pointer to @entity, %NULL for the toplevel group; used
  *             to avoid too many special cases during group creation/migration.
+ * @async_service: async service received by the group in the current
+ *                 observation window.
+ * @async_rate: decayed estimate of the async service the device grants
+ *              to the group per observation window; used as feedback to
+ *              shrink async budgets while sync queues are backlogged.
+ * @async_rate_start: start, in jiffies, of the current observation window.
+ * @max_bps: byte rate limit for the group, 0 meaning unlimited; mirrored
+ *           from the containing cgroup's bfqio_cgroup.
+ * @rate_quota: token bucket for @max_bps, charged at dispatch time and
+ *              refilled from the elapsed jiffies; allowed to go negative
+ *              so that a request larger than the credit still progresses.
+ * @rate_last_refill: time, in jiffies, of the last bucket refill.
+ * @stat_sectors: number of sectors dispatched on behalf of the group.
+ * @stat_ios: number of requests dispatched on behalf of the group.
+ * @stat_wait_jiffies: total queue-to-completion time of the requests
+ *                     completed on behalf of the group.
+ * @stat_throttled: number of times a queue of the group was denied
+ *                  dispatch because the group was over @max_bps.
  *
  * Each (device, cgroup) pair has its own bfq_group, i.e., for each cgroup
  * there is a set of bfq_groups, each one collecting the lower-level
@@ -429,6 +454,19 @@ struct bfq_group {
 	struct bfq_queue *async_idle_bfqq;
 
 	struct bfq_entity *my_entity;
+
+	bfq_service_t async_service;
+	bfq_service_t async_rate;
+	unsigned long async_rate_start;
+
+	unsigned long max_bps;
+	long rate_quota;
+	unsigned long rate_last_refill;
+
+	unsigned long stat_sectors;
+	unsigned long stat_ios;
+	unsigned long stat_wait_jiffies;
+	unsigned long stat_throttled;
 };
 
 /**
@@ -437,6 +475,8 @@ struct bfq_group {
  * @weight: cgroup weight.
  * @ioprio: cgroup ioprio.
  * @ioprio_class: cgroup ioprio_class.
+ * @max_bps: byte rate limit applied to every group of the cgroup,
+ *           0 meaning unlimited.
  * @lock: spinlock that protects @ioprio, @ioprio_class and @group_data.
  * @group_data: list containing the bfq_group belonging to this cgroup.
  *
@@ -447,6 +487,7 @@ struct bfqio_cgroup {
 	struct cgroup_subsys_state css;
 
 	unsigned short weight, ioprio, ioprio_class;
+	unsigned long max_bps;
 
 	spinlock_t lock;
 	struct hlist_head group_data;
@@ -457,6 +498,19 @@ struct bfq_group {
 
 	struct bfq_queue *async_bfqq[2][IOPRIO_BE_NR];
 	struct bfq_queue *async_idle_bfqq;
+
+	bfq_service_t async_service;
+	bfq_service_t async_rate;
+	unsigned long async_rate_start;
+
+	unsigned long max_bps;
+	long rate_quota;
+	unsigned long rate_last_refill;
+
+	unsigned long stat_sectors;
+	unsigned long stat_ios;
+	unsigned long stat_wait_jiffies;
+	unsigned long stat_throttled;
 };
 #endif
 
@@ -472,6 +526,16 @@ bfq_entity_service_tree(struct bfq_entity *entity)
 	return sched_data->service_tree + idx;
 }
 
+/*
+ * Return the group a leaf entity is scheduled into; works with both
+ * the hierarchical and the flat setup, as a bfq_queue always belongs
+ * to the sched_data of some bfq_group (possibly the root one).
+ */
+static inline struct bfq_group *bfq_entity_group(struct bfq_entity *entity)
+{
+	return container_of(entity->sched_data, struct bfq_group, sched_data);
+}
+
 static inline struct bfq_queue *cic_to_bfqq(struct cfq_io_context *cic,
 					    int is_sync)
 {
@@ -548,6 +612,7 @@ static inline void bfq_put_bfqd_unlock(struct bfq_data *bfqd,
 
 static void bfq_changed_ioprio(struct io_context *ioc,
 			       struct cfq_io_context *cic);
+static void bfq_bfqq_boost(struct bfq_data *bfqd, struct bfq_queue *bfqq);
 static void bfq_put_queue(struct bfq_queue *bfqq);
 static void bfq_dispatch_insert(struct request_queue *q, struct request *rq);
 static struct bfq_queue *bfq_get_queue(struct bfq_data *bfqd,
@@ -643,6 +643,8 @@ int blk_get_queue(struct request_queue *q)
 
 static inline void blk_free_request(struct request_queue *q, struct request *rq)
 {
+	blk_io_lat_drop(rq);
+
 	if (rq->cmd_flags & REQ_ELVPRIV)
 		elv_put_request(q, rq);
 	mempool_free(rq, q->rq.rq_pool);
@@ -837,6 +839,8 @@ rq_starved:
 	if (ioc_batching(q, ioc))
 		ioc->nr_batch_requests--;
 
+	blk_io_lat_get(rq);
+
 	trace_block_getrq(q, bio, rw_flags & 1);
 out:
 	return rq;
@@ -1869,6 +1873,48 @@ struct request *blk_peek_request(struct request_queue *q)
 }
 EXPORT_SYMBOL(blk_peek_request);
 
+/**
+ * blk_peek_request_contig - peek at a request contiguous with a previous one
+ * @q: request queue to peek at
+ * @prev: the last request pulled off @q by the driver
+ *
+ * Description:
+ *     Return the request at the top of @q only if it starts exactly at
+ *     the sector where @prev ends and transfers data in the same
+ *     direction, so that a driver able to chain transfers can issue
+ *     both as a single unit.  Barrier requests are never returned and
+ *     never crossed.  The returned request is not started; the driver
+ *     has to call blk_start_request() on it before processing it, just
+ *     as with blk_peek_request().
+ *
+ * Return:
+ *     Pointer to the request at the top of @q if it is contiguous with
+ *     @prev.  Null otherwise.
+ *
+ * Context:
+ *     queue_lock must be held.
+ */
+struct request *blk_peek_request_contig(struct request_queue *q,
+					struct request *prev)
+{
+	struct request *rq;
+
+	if (prev == NULL || blk_barrier_rq(prev))
+		return NULL;
+
+	rq = blk_peek_request(q);
+	if (rq == NULL)
+		return NULL;
+
+	if (!blk_fs_request(rq) || blk_barrier_rq(rq) ||
+	    rq_data_dir(rq) != rq_data_dir(prev) ||
+	    blk_rq_pos(rq) != blk_rq_pos(prev) + blk_rq_sectors(prev))
+		return NULL;
+
+	return rq;
+}
+EXPORT_SYMBOL(blk_peek_request_contig);
+
 void blk_dequeue_request(struct request *rq)
 {
 	struct request_queue *q = rq->q;
@@ -2134,6 +2180,8 @@ static void blk_finish_request(struct request *req, int error)
 
 	blk_account_io_done(req);
 
+	blk_io_lat_done(req);
+
 	if (req->end_io)
 		req->end_io(req, error);
 	else {
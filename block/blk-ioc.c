@@ -100,6 +100,9 @@ struct io_context *alloc_io_context(gfp_t gfp_flags, int node)
 		INIT_RADIX_TREE(&ret->bfq_radix_root, GFP_ATOMIC | __GFP_HIGH);
 		INIT_HLIST_HEAD(&ret->bfq_cic_list);
 		ret->ioc_data = NULL;
+#ifdef CONFIG_BLK_IO_LATENCY
+		memset(ret->lat_hist, 0, sizeof(ret->lat_hist));
+#endif
 	}
 
 	return ret;
@@ -170,6 +173,56 @@ void copy_io_context(struct io_context **pdst, struct io_context **psrc)
 }
 EXPORT_SYMBOL(copy_io_context);
 
+#ifdef CONFIG_BLK_IO_LATENCY
+/*
+ * Pin the submitter's io_context to the request, so its latency can be
+ * charged back at completion time.
+ */
+void blk_io_lat_get(struct request *rq)
+{
+	struct io_context *ioc = current->io_context;
+
+	if (ioc != NULL && atomic_long_inc_not_zero(&ioc->refcount))
+		rq->lat_ioc = ioc;
+	rq->lat_submit_ns = sched_clock();
+}
+
+/*
+ * Account the submit-to-complete latency of @rq to its submitter.  The
+ * histogram update is lockless and may lose the odd increment under
+ * contention, which is acceptable for a diagnostic counter.
+ */
+void blk_io_lat_done(struct request *rq)
+{
+	struct io_context *ioc = rq->lat_ioc;
+	unsigned long long delta;
+	int bucket;
+
+	if (ioc == NULL)
+		return;
+
+	delta = sched_clock() - rq->lat_submit_ns;
+	/* delta >> 10 is roughly microseconds. */
+	bucket = min(fls64(delta >> 10), BLK_IO_LAT_BUCKETS - 1);
+	ioc->lat_hist[rq_data_dir(rq)][bucket]++;
+
+	rq->lat_ioc = NULL;
+	put_io_context(ioc);
+}
+
+/*
+ * Release the pinned io_context of a request that is freed without
+ * completing on its own, e.g. after being merged into another one.
+ */
+void blk_io_lat_drop(struct request *rq)
+{
+	if (rq->lat_ioc != NULL) {
+		put_io_context(rq->lat_ioc);
+		rq->lat_ioc = NULL;
+	}
+}
+#endif /* CONFIG_BLK_IO_LATENCY */
+
 static int __init blk_ioc_init(void)
 {
 	iocontext_cachep = kmem_cache_create("blkdev_ioc",
@@ -5,6 +5,8 @@
 #include <linux/module.h>
 #include <linux/bio.h>
 #include <linux/blkdev.h>
+#include <linux/slab.h>
+#include <linux/workqueue.h>
 #include <linux/scatterlist.h>
 
 #include "blk.h"
@@ -113,6 +115,189 @@ out:
 }
 EXPORT_SYMBOL(blkdev_issue_discard);
 
+/*
+ * Batched discards.  Filesystems doing online discard (e.g. ext4 with
+ * -o discard) issue many small synchronous ranges from their commit
+ * path, stalling writers for the duration of every TRIM command.
+ * blkdev_queue_discard() instead collects the ranges, merges adjacent
+ * ones, and lets a background worker push them out while the device is
+ * otherwise idle.  blkdev_discard_flush() drains the queue
+ * synchronously and is meant for unmount.
+ */
+struct discard_range {
+	struct list_head	list;
+	struct block_device	*bdev;
+	sector_t		sector;
+	sector_t		nr_sects;
+};
+
+static LIST_HEAD(discard_pending);
+static DEFINE_SPINLOCK(discard_pending_lock);
+
+/* Delay before pending discards are pushed to the device. */
+#define BLKDEV_DISCARD_DELAY	(HZ / 4)
+
+static void blkdev_discard_work(struct work_struct *work);
+static DECLARE_DELAYED_WORK(discard_work, blkdev_discard_work);
+
+/*
+ * Fold a new range into an adjacent or overlapping pending one, if any.
+ * A range grown this way may still touch another pending range; the two
+ * are then simply issued as separate commands, which is harmless.
+ * Must be called with discard_pending_lock held.
+ */
+static int discard_range_merge(struct block_device *bdev, sector_t sector,
+			       sector_t nr_sects)
+{
+	struct discard_range *r;
+
+	list_for_each_entry(r, &discard_pending, list) {
+		if (r->bdev != bdev)
+			continue;
+		if (sector + nr_sects < r->sector ||
+		    r->sector + r->nr_sects < sector)
+			continue;
+		if (sector < r->sector) {
+			r->nr_sects += r->sector - sector;
+			r->sector = sector;
+		}
+		if (sector + nr_sects > r->sector + r->nr_sects)
+			r->nr_sects = sector + nr_sects - r->sector;
+		return 1;
+	}
+
+	return 0;
+}
+
+static void blkdev_discard_work(struct work_struct *work)
+{
+	struct discard_range *r;
+	struct request_queue *q;
+	unsigned long flags;
+	int requeued = 0;
+	LIST_HEAD(run);
+
+	spin_lock_irqsave(&discard_pending_lock, flags);
+	list_splice_init(&discard_pending, &run);
+	spin_unlock_irqrestore(&discard_pending_lock, flags);
+
+	while (!list_empty(&run)) {
+		r = list_first_entry(&run, struct discard_range, list);
+		list_del(&r->list);
+
+		q = bdev_get_queue(r->bdev);
+		if (q != NULL && q->in_flight[0] + q->in_flight[1] > 0) {
+			/* Device busy: hold the range back for a while. */
+			spin_lock_irqsave(&discard_pending_lock, flags);
+			if (discard_range_merge(r->bdev, r->sector,
+						r->nr_sects))
+				kfree(r);
+			else
+				list_add_tail(&r->list, &discard_pending);
+			spin_unlock_irqrestore(&discard_pending_lock, flags);
+			requeued = 1;
+			continue;
+		}
+
+		blkdev_issue_discard(r->bdev, r->sector, r->nr_sects,
+				     GFP_NOIO, BLKDEV_IFL_WAIT);
+		kfree(r);
+	}
+
+	if (requeued)
+		schedule_delayed_work(&discard_work, BLKDEV_DISCARD_DELAY);
+}
+
+/**
+ * blkdev_queue_discard - queue a discard for deferred, batched issue
+ * @bdev:	blockdev to issue discard for
+ * @sector:	start sector
+ * @nr_sects:	number of sectors to discard
+ * @gfp_mask:	memory allocation flags
+ *
+ * Description:
+ *    Remember the range and return immediately; adjacent pending
+ *    ranges are merged and a background worker issues the result when
+ *    the device has no other requests in flight.  If the range cannot
+ *    be remembered the discard is issued synchronously instead, so the
+ *    blocks are never silently left untrimmed.
+ */
+int blkdev_queue_discard(struct block_device *bdev, sector_t sector,
+			 sector_t nr_sects, gfp_t gfp_mask)
+{
+	struct request_queue *q = bdev_get_queue(bdev);
+	struct discard_range *r;
+	unsigned long flags;
+
+	if (!q)
+		return -ENXIO;
+
+	if (!blk_queue_discard(q))
+		return -EOPNOTSUPP;
+
+	r = kmalloc(sizeof(*r), gfp_mask);
+
+	spin_lock_irqsave(&discard_pending_lock, flags);
+	if (discard_range_merge(bdev, sector, nr_sects)) {
+		spin_unlock_irqrestore(&discard_pending_lock, flags);
+		kfree(r);
+	} else if (r == NULL) {
+		spin_unlock_irqrestore(&discard_pending_lock, flags);
+		return blkdev_issue_discard(bdev, sector, nr_sects, gfp_mask,
+					    BLKDEV_IFL_WAIT);
+	} else {
+		r->bdev = bdev;
+		r->sector = sector;
+		r->nr_sects = nr_sects;
+		list_add_tail(&r->list, &discard_pending);
+		spin_unlock_irqrestore(&discard_pending_lock, flags);
+	}
+
+	schedule_delayed_work(&discard_work, BLKDEV_DISCARD_DELAY);
+
+	return 0;
+}
+EXPORT_SYMBOL(blkdev_queue_discard);
+
+/**
+ * blkdev_discard_flush - synchronously issue all pending discards
+ * @bdev:	blockdev to drain, or %NULL for all devices
+ *
+ * Description:
+ *    Push out every discard queued with blkdev_queue_discard() for
+ *    @bdev and wait for them, issuing the last ones with a barrier.
+ *    To be called before unmount or device removal.
+ */
+int blkdev_discard_flush(struct block_device *bdev)
+{
+	struct discard_range *r, *n;
+	unsigned long flags;
+	int ret = 0, err;
+	LIST_HEAD(run);
+
+	/* Make sure the worker is not sitting on part of the queue. */
+	flush_delayed_work(&discard_work);
+
+	spin_lock_irqsave(&discard_pending_lock, flags);
+	list_for_each_entry_safe(r, n, &discard_pending, list)
+		if (bdev == NULL || r->bdev == bdev)
+			list_move_tail(&r->list, &run);
+	spin_unlock_irqrestore(&discard_pending_lock, flags);
+
+	list_for_each_entry_safe(r, n, &run, list) {
+		err = blkdev_issue_discard(r->bdev, r->sector, r->nr_sects,
+					   GFP_NOIO, BLKDEV_IFL_WAIT |
+					   BLKDEV_IFL_BARRIER);
+		if (err && !ret)
+			ret = err;
+		list_del(&r->list);
+		kfree(r);
+	}
+
+	return ret;
+}
+EXPORT_SYMBOL(blkdev_discard_flush);
+
 struct bio_batch
 {
 	atomic_t 		done;
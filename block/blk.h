@@ -18,6 +18,22 @@ int blk_rq_append_bio(struct request_queue *q, struct request *rq,
 void blk_dequeue_request(struct request *rq);
 void __blk_queue_free_tags(struct request_queue *q);
 
+#ifdef CONFIG_BLK_IO_LATENCY
+void blk_io_lat_get(struct request *rq);
+void blk_io_lat_done(struct request *rq);
+void blk_io_lat_drop(struct request *rq);
+#else
+static inline void blk_io_lat_get(struct request *rq)
+{
+}
+static inline void blk_io_lat_done(struct request *rq)
+{
+}
+static inline void blk_io_lat_drop(struct request *rq)
+{
+}
+#endif
+
 void blk_unplug_work(struct work_struct *work);
 void blk_unplug_timeout(unsigned long data);
 void blk_rq_timed_out_timer(unsigned long data);
@@ -30,6 +30,8 @@ static const int cfq_slice_sync = HZ / 10;
 static int cfq_slice_async = HZ / 25;
 static const int cfq_slice_async_rq = 2;
 static int cfq_slice_idle = HZ / 125;
+/* skip idling on non-rotational media, see cfq_cfqd_noidle() */
+static int cfq_nonrot_noidle = 1;
 static const int cfq_target_latency = HZ * 3/10; /* 300 ms */
 static const int cfq_hist_divisor = 4;
 
@@ -273,6 +275,7 @@ struct cfq_data {
 	unsigned int cfq_slice_idle;
 	unsigned int cfq_latency;
 	unsigned int cfq_group_isolation;
+	unsigned int cfq_nonrot_noidle;
 
 	unsigned int cic_index;
 	struct list_head cic_list;
@@ -882,6 +885,16 @@ cfq_group_service_tree_del(struct cfq_data *cfqd, struct cfq_group *cfqg)
 	cfq_blkiocg_update_dequeue_stats(&cfqg->blkg, 1);
 }
 
+/*
+ * On non-rotational media there is no seek penalty, so idle windows only
+ * throttle the device.  In this mode we never idle and instead preserve
+ * fairness through IOPS based service accounting, see cfq_group_served().
+ */
+static inline bool cfq_cfqd_noidle(struct cfq_data *cfqd)
+{
+	return cfqd->cfq_nonrot_noidle && blk_queue_nonrot(cfqd->queue);
+}
+
 static inline unsigned int cfq_cfqq_slice_usage(struct cfq_queue *cfqq)
 {
 	unsigned int slice_used;
@@ -920,7 +933,15 @@ static void cfq_group_served(struct cfq_data *cfqd, struct cfq_group *cfqg,
 	BUG_ON(nr_sync < 0);
 	used_sl = charge_sl = cfq_cfqq_slice_usage(cfqq);
 
-	if (!cfq_cfqq_sync(cfqq) && !nr_sync)
+	/*
+	 * Without idling, slices end as soon as the queue runs dry and the
+	 * time used says more about the workload than about the share the
+	 * group got.  Charge dispatched requests instead; the unit differs
+	 * but vdisktime only needs to be consistent across groups.
+	 */
+	if (cfq_cfqd_noidle(cfqd))
+		charge_sl = cfqq->slice_dispatch;
+	else if (!cfq_cfqq_sync(cfqq) && !nr_sync)
 		charge_sl = cfqq->allocated_slice;
 
 	/* Can't update vdisktime while group is on service tree */
@@ -1842,6 +1863,10 @@ static bool cfq_should_idle(struct cfq_data *cfqd, struct cfq_queue *cfqq)
 	if (prio == IDLE_WORKLOAD)
 		return false;
 
+	/* Nor on non-rotational media, where idling only costs bandwidth. */
+	if (cfq_cfqd_noidle(cfqd))
+		return false;
+
 	/* We do for queues that were marked with idle window flag. */
 	if (cfq_cfqq_idle_window(cfqq) &&
 	   !(blk_queue_nonrot(cfqd->queue) && cfqd->hw_tag))
@@ -1866,10 +1891,12 @@ static void cfq_arm_slice_timer(struct cfq_data *cfqd)
 
 	/*
 	 * SSD device without seek penalty, disable idling. But only do so
-	 * for devices that support queuing, otherwise we still have a problem
-	 * with sync vs async workloads.
+	 * for devices that support queuing (unless nonrot_noidle asks for
+	 * it unconditionally), otherwise we still have a problem with sync
+	 * vs async workloads.
 	 */
-	if (blk_queue_nonrot(cfqd->queue) && cfqd->hw_tag)
+	if (blk_queue_nonrot(cfqd->queue) &&
+	    (cfqd->hw_tag || cfqd->cfq_nonrot_noidle))
 		return;
 
 	WARN_ON(!RB_EMPTY_ROOT(&cfqq->sort_list));
@@ -2314,6 +2341,14 @@ static bool cfq_may_dispatch(struct cfq_data *cfqd, struct cfq_queue *cfqq)
 		return false;
 
 	max_dispatch = max_t(unsigned int, cfqd->cfq_quantum / 2, 1);
+
+	/*
+	 * Since we don't idle on non-rotational media, queue depth is the
+	 * only way to keep the device busy; always allow the full quantum.
+	 */
+	if (cfq_cfqd_noidle(cfqd))
+		max_dispatch = cfqd->cfq_quantum;
+
 	if (cfq_class_idle(cfqq))
 		max_dispatch = 1;
 
@@ -3336,6 +3371,10 @@ static bool cfq_should_wait_busy(struct cfq_data *cfqd, struct cfq_queue *cfqq)
 {
 	struct cfq_io_context *cic = cfqd->active_cic;
 
+	/* Waiting for the group to get busy is just another idle window */
+	if (cfq_cfqd_noidle(cfqd))
+		return false;
+
 	/* If there are other queues in the group, don't wait */
 	if (cfqq->cfqg->nr_cfqq > 1)
 		return false;
@@ -3853,6 +3892,7 @@ static void *cfq_init_queue(struct request_queue *q)
 	cfqd->cfq_slice_idle = cfq_slice_idle;
 	cfqd->cfq_latency = 1;
 	cfqd->cfq_group_isolation = 0;
+	cfqd->cfq_nonrot_noidle = cfq_nonrot_noidle;
 	cfqd->hw_tag = -1;
 	/*
 	 * we optimistically start assuming sync ops weren't delayed in last
@@ -3928,6 +3968,7 @@ SHOW_FUNCTION(cfq_slice_async_show, cfqd->cfq_slice[0], 1);
 SHOW_FUNCTION(cfq_slice_async_rq_show, cfqd->cfq_slice_async_rq, 0);
 SHOW_FUNCTION(cfq_low_latency_show, cfqd->cfq_latency, 0);
 SHOW_FUNCTION(cfq_group_isolation_show, cfqd->cfq_group_isolation, 0);
+SHOW_FUNCTION(cfq_nonrot_noidle_show, cfqd->cfq_nonrot_noidle, 0);
 #undef SHOW_FUNCTION
 
 #define STORE_FUNCTION(__FUNC, __PTR, MIN, MAX, __CONV)			\
@@ -3961,6 +4002,7 @@ STORE_FUNCTION(cfq_slice_async_rq_store, &cfqd->cfq_slice_async_rq, 1,
 		UINT_MAX, 0);
 STORE_FUNCTION(cfq_low_latency_store, &cfqd->cfq_latency, 0, 1, 0);
 STORE_FUNCTION(cfq_group_isolation_store, &cfqd->cfq_group_isolation, 0, 1, 0);
+STORE_FUNCTION(cfq_nonrot_noidle_store, &cfqd->cfq_nonrot_noidle, 0, 1, 0);
 #undef STORE_FUNCTION
 
 #define CFQ_ATTR(name) \
@@ -3978,6 +4020,7 @@ static struct elv_fs_entry cfq_attrs[] = {
 	CFQ_ATTR(slice_idle),
 	CFQ_ATTR(low_latency),
 	CFQ_ATTR(group_isolation),
+	CFQ_ATTR(nonrot_noidle),
 	__ATTR_NULL
 };
 
@@ -22,6 +22,8 @@ static const int write_expire = 5 * HZ; /* ditto for writes, these limits are SO
 static const int writes_starved = 2;    /* max times reads can starve a write */
 static const int fifo_batch = 16;       /* # of sequential requests treated as one
 				     by the above parameters. For throughput. */
+static const int flash_align = 4096;    /* erase-block window size for flash
+				     mode, in KiB. */
 
 struct deadline_data {
 	/*
@@ -49,6 +51,16 @@ struct deadline_data {
 	int fifo_batch;
 	int writes_starved;
 	int front_merges;
+
+	/*
+	 * flash mode: on erase-block based media the dominant write cost
+	 * is erase-block misalignment, not seeks.  Batch writes by
+	 * erase-block-aligned windows of flash_align KiB instead of by
+	 * request count, and serve reads as soon as a window ends.
+	 */
+	int flash_mode;
+	int flash_align;
+	sector_t flash_window;		/* window of the last write moved */
 };
 
 static void deadline_move_request(struct deadline_data *, struct request *);
@@ -221,6 +233,22 @@ deadline_move_request(struct deadline_data *dd, struct request *rq)
 	deadline_move_to_dispatch(dd, rq);
 }
 
+/*
+ * Number of the erase-block-sized window @sector falls into; flash_align
+ * is in KiB, so one window is flash_align * 2 sectors.
+ */
+static sector_t deadline_flash_window(struct deadline_data *dd, sector_t sector)
+{
+	sector_div(sector, dd->flash_align * 2);
+	return sector;
+}
+
+static inline int deadline_flash_same_window(struct deadline_data *dd,
+					     struct request *rq)
+{
+	return deadline_flash_window(dd, blk_rq_pos(rq)) == dd->flash_window;
+}
+
 /*
  * deadline_check_fifo returns 0 if there are no expired requests on the fifo,
  * 1 otherwise. Requires !list_empty(&dd->fifo_list[data_dir])
@@ -258,8 +286,21 @@ static int deadline_dispatch_requests(struct request_queue *q, int force)
 	else
 		rq = dd->next_rq[READ];
 
-	if (rq && dd->batching < dd->fifo_batch)
-		/* we have a next request are still entitled to batch */
+	if (dd->flash_mode && rq && rq_data_dir(rq) == WRITE &&
+	    (reads || !deadline_flash_same_window(dd, rq)))
+		/*
+		 * The write batch left its erase-block window, or a read
+		 * is waiting: end the batch here.
+		 */
+		rq = NULL;
+
+	if (rq && (dd->batching < dd->fifo_batch ||
+		   (dd->flash_mode && rq_data_dir(rq) == WRITE)))
+		/*
+		 * We have a next request and are still entitled to batch;
+		 * in flash mode write batches are bounded by the window,
+		 * not by the request count.
+		 */
 		goto dispatch_request;
 
 	/*
@@ -270,7 +311,14 @@ static int deadline_dispatch_requests(struct request_queue *q, int force)
 	if (reads) {
 		BUG_ON(RB_EMPTY_ROOT(&dd->sort_list[READ]));
 
-		if (writes && (dd->starved++ >= dd->writes_starved))
+		if (dd->flash_mode) {
+			/*
+			 * Reads are served immediately; writes only rely
+			 * on their (soft) fifo deadline.
+			 */
+			if (writes && deadline_check_fifo(dd, WRITE))
+				goto dispatch_writes;
+		} else if (writes && (dd->starved++ >= dd->writes_starved))
 			goto dispatch_writes;
 
 		data_dir = READ;
@@ -321,6 +369,8 @@ dispatch_request:
 	 * rq is the selected appropriate request.
 	 */
 	dd->batching++;
+	if (dd->flash_mode && rq_data_dir(rq) == WRITE)
+		dd->flash_window = deadline_flash_window(dd, blk_rq_pos(rq));
 	deadline_move_request(dd, rq);
 
 	return 1;
@@ -364,6 +414,8 @@ static void *deadline_init_queue(struct request_queue *q)
 	dd->writes_starved = writes_starved;
 	dd->front_merges = 1;
 	dd->fifo_batch = fifo_batch;
+	dd->flash_mode = 0;
+	dd->flash_align = flash_align;
 	return dd;
 }
 
@@ -400,6 +452,8 @@ SHOW_FUNCTION(deadline_write_expire_show, dd->fifo_expire[WRITE], 1);
 SHOW_FUNCTION(deadline_writes_starved_show, dd->writes_starved, 0);
 SHOW_FUNCTION(deadline_front_merges_show, dd->front_merges, 0);
 SHOW_FUNCTION(deadline_fifo_batch_show, dd->fifo_batch, 0);
+SHOW_FUNCTION(deadline_flash_mode_show, dd->flash_mode, 0);
+SHOW_FUNCTION(deadline_flash_align_show, dd->flash_align, 0);
 #undef SHOW_FUNCTION
 
 #define STORE_FUNCTION(__FUNC, __PTR, MIN, MAX, __CONV)			\
@@ -423,6 +477,8 @@ STORE_FUNCTION(deadline_write_expire_store, &dd->fifo_expire[WRITE], 0, INT_MAX,
 STORE_FUNCTION(deadline_writes_starved_store, &dd->writes_starved, INT_MIN, INT_MAX, 0);
 STORE_FUNCTION(deadline_front_merges_store, &dd->front_merges, 0, 1, 0);
 STORE_FUNCTION(deadline_fifo_batch_store, &dd->fifo_batch, 0, INT_MAX, 0);
+STORE_FUNCTION(deadline_flash_mode_store, &dd->flash_mode, 0, 1, 0);
+STORE_FUNCTION(deadline_flash_align_store, &dd->flash_align, 4, INT_MAX, 0);
 #undef STORE_FUNCTION
 
 #define DD_ATTR(name) \
@@ -435,6 +491,8 @@ static struct elv_fs_entry deadline_attrs[] = {
 	DD_ATTR(writes_starved),
 	DD_ATTR(front_merges),
 	DD_ATTR(fifo_batch),
+	DD_ATTR(flash_mode),
+	DD_ATTR(flash_align),
 	__ATTR_NULL
 };
 
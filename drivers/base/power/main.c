@@ -70,6 +70,8 @@ void device_pm_init(struct device *dev)
 	dev->power.status = DPM_ON;
 	init_completion(&dev->power.completion);
 	dev->power.wakeup_count = 0;
+	dev->power.suspend_time_ns = 0;
+	dev->power.resume_time_ns = 0;
 	pm_runtime_init(dev);
 }
 
@@ -479,6 +481,7 @@ void dpm_resume_noirq(pm_message_t state)
 	transition_started = false;
 	while (!list_empty(&dpm_noirq_list)) {
 		struct device *dev = to_device(dpm_noirq_list.next);
+		ktime_t calltime;
 		int error;
 
 		get_device(dev);
@@ -486,7 +489,10 @@ void dpm_resume_noirq(pm_message_t state)
 		list_move_tail(&dev->power.entry, &dpm_suspended_list);
 		mutex_unlock(&dpm_list_mtx);
 
+		calltime = ktime_get();
 		error = device_resume_noirq(dev, state);
+		dev->power.resume_time_ns +=
+			ktime_to_ns(ktime_sub(ktime_get(), calltime));
 		if (error)
 			pm_dev_err(dev, state, " early", error);
 
@@ -528,6 +534,7 @@ static int legacy_resume(struct device *dev, int (*cb)(struct device *dev))
 static int device_resume(struct device *dev, pm_message_t state, bool async)
 {
 	int error = 0;
+	ktime_t calltime;
 
 	TRACE_DEVICE(dev);
 	TRACE_RESUME(0);
@@ -535,6 +542,7 @@ static int device_resume(struct device *dev, pm_message_t state, bool async)
 	if (dev->parent && dev->parent->power.status >= DPM_OFF)
 		dpm_wait(dev->parent, async);
 	device_lock(dev);
+	calltime = ktime_get();
 
 	dev->power.status = DPM_RESUMING;
 
@@ -569,6 +577,8 @@ static int device_resume(struct device *dev, pm_message_t state, bool async)
 		}
 	}
  End:
+	dev->power.resume_time_ns +=
+		ktime_to_ns(ktime_sub(ktime_get(), calltime));
 	device_unlock(dev);
 	complete_all(&dev->power.completion);
 
@@ -828,11 +838,15 @@ int dpm_suspend_noirq(pm_message_t state)
 	mutex_lock(&dpm_list_mtx);
 	while (!list_empty(&dpm_suspended_list)) {
 		struct device *dev = to_device(dpm_suspended_list.prev);
+		ktime_t calltime;
 
 		get_device(dev);
 		mutex_unlock(&dpm_list_mtx);
 
+		calltime = ktime_get();
 		error = device_suspend_noirq(dev, state);
+		dev->power.suspend_time_ns +=
+			ktime_to_ns(ktime_sub(ktime_get(), calltime));
 		if (error) {
 			pm_dev_err(dev, state, " late", error);
 			break;
@@ -882,9 +896,11 @@ static int legacy_suspend(struct device *dev, pm_message_t state,
 static int __device_suspend(struct device *dev, pm_message_t state, bool async)
 {
 	int error = 0;
+	ktime_t calltime;
 
 	dpm_wait_for_children(dev, async);
 	device_lock(dev);
+	calltime = ktime_get();
 
 	if (async_error)
 		goto End;
@@ -924,6 +940,8 @@ static int __device_suspend(struct device *dev, pm_message_t state, bool async)
 		dev->power.status = DPM_OFF;
 
  End:
+	dev->power.suspend_time_ns +=
+		ktime_to_ns(ktime_sub(ktime_get(), calltime));
 	device_unlock(dev);
 	complete_all(&dev->power.completion);
 
@@ -1013,6 +1031,10 @@ static int device_prepare(struct device *dev, pm_message_t state)
 {
 	int error = 0;
 
+	/* start of a new cycle, restart the per-device timing totals */
+	dev->power.suspend_time_ns = 0;
+	dev->power.resume_time_ns = 0;
+
 	device_lock(dev);
 
 	if (dev->bus && dev->bus->pm && dev->bus->pm->prepare) {
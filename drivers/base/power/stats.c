@@ -0,0 +1,190 @@
+/*
+ * drivers/base/power/stats.c - Suspend/resume timing statistics.
+ *
+ * This file is released under the GPLv2.
+ *
+ * Collects per-device suspend/resume callback times (accumulated by
+ * drivers/base/power/main.c in dev->power.suspend_time_ns and
+ * dev->power.resume_time_ns) and per-cycle phase totals (recorded by
+ * kernel/power/suspend.c through suspend_phase_record()), and exposes
+ * them in debugfs:
+ *
+ *   /sys/kernel/debug/suspend_stats/phases   per-phase last/avg/max times
+ *   /sys/kernel/debug/suspend_stats/devices  per-device times of the last
+ *                                            cycle, worst offenders first
+ */
+
+#include <linux/device.h>
+#include <linux/suspend.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/sort.h>
+#include <linux/slab.h>
+#include <linux/err.h>
+
+#include "power.h"
+
+static const char * const suspend_phase_names[SUSPEND_PHASE_COUNT] = {
+	[SUSPEND_PHASE_FREEZE]		= "freeze",
+	[SUSPEND_PHASE_DEV_SUSPEND]	= "dev_suspend",
+	[SUSPEND_PHASE_ENTER]		= "enter",
+	[SUSPEND_PHASE_DEV_RESUME]	= "dev_resume",
+	[SUSPEND_PHASE_THAW]		= "thaw",
+};
+
+static struct {
+	s64		last_ns;
+	s64		max_ns;
+	s64		total_ns;
+	unsigned int	count;
+} suspend_phase_stats[SUSPEND_PHASE_COUNT];
+
+static DEFINE_SPINLOCK(suspend_phase_lock);
+
+void suspend_phase_record(enum suspend_phase phase, ktime_t starttime)
+{
+	s64 elapsed_ns = ktime_to_ns(ktime_sub(ktime_get(), starttime));
+	unsigned long flags;
+
+	if (phase >= SUSPEND_PHASE_COUNT)
+		return;
+
+	spin_lock_irqsave(&suspend_phase_lock, flags);
+	suspend_phase_stats[phase].last_ns = elapsed_ns;
+	if (elapsed_ns > suspend_phase_stats[phase].max_ns)
+		suspend_phase_stats[phase].max_ns = elapsed_ns;
+	suspend_phase_stats[phase].total_ns += elapsed_ns;
+	suspend_phase_stats[phase].count++;
+	spin_unlock_irqrestore(&suspend_phase_lock, flags);
+}
+
+static int suspend_phases_show(struct seq_file *m, void *unused)
+{
+	unsigned long flags;
+	int i;
+
+	seq_puts(m, "phase\tcount\tlast_usecs\tavg_usecs\tmax_usecs\n");
+	spin_lock_irqsave(&suspend_phase_lock, flags);
+	for (i = 0; i < SUSPEND_PHASE_COUNT; i++) {
+		s64 avg_ns = 0;
+
+		if (suspend_phase_stats[i].count)
+			avg_ns = div_s64(suspend_phase_stats[i].total_ns,
+					 suspend_phase_stats[i].count);
+		seq_printf(m, "%s\t%u\t%lld\t%lld\t%lld\n",
+			   suspend_phase_names[i],
+			   suspend_phase_stats[i].count,
+			   div_s64(suspend_phase_stats[i].last_ns,
+				   NSEC_PER_USEC),
+			   div_s64(avg_ns, NSEC_PER_USEC),
+			   div_s64(suspend_phase_stats[i].max_ns,
+				   NSEC_PER_USEC));
+	}
+	spin_unlock_irqrestore(&suspend_phase_lock, flags);
+	return 0;
+}
+
+static int suspend_phases_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, suspend_phases_show, NULL);
+}
+
+static const struct file_operations suspend_phases_fops = {
+	.owner = THIS_MODULE,
+	.open = suspend_phases_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int suspend_device_cmp(const void *a, const void *b)
+{
+	struct device *const *deva = a;
+	struct device *const *devb = b;
+	s64 ta = (*deva)->power.suspend_time_ns + (*deva)->power.resume_time_ns;
+	s64 tb = (*devb)->power.suspend_time_ns + (*devb)->power.resume_time_ns;
+
+	if (ta < tb)
+		return 1;
+	if (ta > tb)
+		return -1;
+	return 0;
+}
+
+static int suspend_devices_show(struct seq_file *m, void *unused)
+{
+	struct device **devs;
+	struct list_head *entry;
+	int count = 0;
+	int n = 0;
+	int i;
+
+	device_pm_lock();
+	list_for_each(entry, &dpm_list)
+		count++;
+	device_pm_unlock();
+
+	devs = kmalloc(count * sizeof(*devs), GFP_KERNEL);
+	if (!devs)
+		return -ENOMEM;
+
+	/*
+	 * Devices may have come and gone since the count, hold references
+	 * so dev_name() stays valid while we print outside the lock.
+	 */
+	device_pm_lock();
+	list_for_each(entry, &dpm_list) {
+		if (n >= count)
+			break;
+		devs[n] = to_device(entry);
+		get_device(devs[n]);
+		n++;
+	}
+	device_pm_unlock();
+
+	sort(devs, n, sizeof(*devs), suspend_device_cmp, NULL);
+
+	seq_puts(m, "device\tsuspend_usecs\tresume_usecs\n");
+	for (i = 0; i < n; i++) {
+		if (devs[i]->power.suspend_time_ns ||
+		    devs[i]->power.resume_time_ns)
+			seq_printf(m, "%s\t%lld\t%lld\n", dev_name(devs[i]),
+				   div_s64(devs[i]->power.suspend_time_ns,
+					   NSEC_PER_USEC),
+				   div_s64(devs[i]->power.resume_time_ns,
+					   NSEC_PER_USEC));
+		put_device(devs[i]);
+	}
+	kfree(devs);
+	return 0;
+}
+
+static int suspend_devices_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, suspend_devices_show, NULL);
+}
+
+static const struct file_operations suspend_devices_fops = {
+	.owner = THIS_MODULE,
+	.open = suspend_devices_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init suspend_stats_init(void)
+{
+	struct dentry *dir;
+
+	dir = debugfs_create_dir("suspend_stats", NULL);
+	if (IS_ERR_OR_NULL(dir))
+		return 0;
+	debugfs_create_file("phases", S_IRUGO, dir, NULL,
+			    &suspend_phases_fops);
+	debugfs_create_file("devices", S_IRUGO, dir, NULL,
+			    &suspend_devices_fops);
+	return 0;
+}
+late_initcall(suspend_stats_init);
@@ -115,6 +115,16 @@ struct msm_rotator_dev {
 	struct mutex imem_lock;
 	int imem_owner;
 	wait_queue_head_t wq;
+	/*
+	 * Job kicked off by MSM_ROTATOR_IOCTL_ROTATE_ASYNC and not yet
+	 * reaped; its pmem references are parked here until the next
+	 * rotation is programmed or MSM_ROTATOR_IOCTL_WAIT is called.
+	 * Protected by rotator_lock.
+	 */
+	int pending;
+	int pending_rc;
+	struct file *pending_src_file;
+	struct file *pending_dst_file;
 };
 
 #define chroma_addr(start, w, h, bpp) ((start) + ((h) * (w) * (bpp)))
@@ -216,9 +226,12 @@ static void disable_rot_clks(void)
 	clk_disable(msm_rotator_dev->axi_clk);
 }
 
+static int msm_rotator_drain(void);
+
 static void msm_rotator_rot_clk_work_f(struct work_struct *work)
 {
 	if (mutex_trylock(&msm_rotator_dev->rotator_lock)) {
+		msm_rotator_drain();
 		if (msm_rotator_dev->rot_clk_state == CLK_EN) {
 			disable_rot_clks();
 			msm_rotator_dev->rot_clk_state = CLK_DIS;
@@ -239,6 +252,51 @@ static irqreturn_t msm_rotator_isr(int irq, void *dev_id)
 	return IRQ_HANDLED;
 }
 
+/*
+ * Reap an asynchronously started rotation: wait for the hardware,
+ * record its status for MSM_ROTATOR_IOCTL_WAIT and release the parked
+ * pmem references.  Called with rotator_lock held; a no-op when
+ * nothing is in flight.
+ */
+static int msm_rotator_drain(void)
+{
+	unsigned int status;
+	int rc = 0;
+
+	if (!msm_rotator_dev->pending)
+		return 0;
+
+	wait_event(msm_rotator_dev->wq,
+		   (msm_rotator_dev->processing == 0));
+	status = (unsigned char)ioread32(MSM_ROTATOR_INTR_STATUS);
+	if ((status & 0x03) != 0x01) {
+		dev_warn(msm_rotator_dev->device,
+			 "%s: async rotation failed, status %x\n",
+			 __func__, status);
+		msm_rotator_dev->last_session_idx = INVALID_SESSION;
+		rc = -EFAULT;
+	}
+	iowrite32(0, MSM_ROTATOR_INTR_ENABLE);
+	iowrite32(3, MSM_ROTATOR_INTR_CLEAR);
+
+	disable_irq(msm_rotator_dev->irq);
+#ifdef CONFIG_MSM_ROTATOR_USE_IMEM
+	msm_rotator_imem_free(ROTATOR_REQUEST);
+#endif
+	schedule_delayed_work(&msm_rotator_dev->rot_clk_work, HZ);
+
+	if (msm_rotator_dev->pending_src_file)
+		put_pmem_file(msm_rotator_dev->pending_src_file);
+	if (msm_rotator_dev->pending_dst_file)
+		put_pmem_file(msm_rotator_dev->pending_dst_file);
+	msm_rotator_dev->pending_src_file = NULL;
+	msm_rotator_dev->pending_dst_file = NULL;
+	msm_rotator_dev->pending = 0;
+	msm_rotator_dev->pending_rc = rc;
+
+	return rc;
+}
+
 static int get_bpp(int format)
 {
 	switch (format) {
@@ -694,7 +752,7 @@ static int get_img(int memory_id, unsigned long *start, unsigned long *len,
 	return ret;
 }
 
-static int msm_rotator_do_rotate(unsigned long arg)
+static int msm_rotator_do_rotate(unsigned long arg, int async)
 {
 	int rc = 0;
 	unsigned int status;
@@ -728,6 +786,8 @@ static int msm_rotator_do_rotate(unsigned long arg)
 	out_paddr += info.dst.offset;
 
 	mutex_lock(&msm_rotator_dev->rotator_lock);
+	/* reap a still-running async job before touching the hardware */
+	msm_rotator_drain();
 	for (s = 0; s < MAX_SESSIONS; s++)
 		if ((msm_rotator_dev->img_info[s] != NULL) &&
 			(info.session_id ==
@@ -841,6 +901,20 @@ static int msm_rotator_do_rotate(unsigned long arg)
 	msm_rotator_dev->processing = 1;
 	iowrite32(0x1, MSM_ROTATOR_START);
 
+	if (async) {
+		/*
+		 * Return with the job in flight so the caller can decode
+		 * the next frame while this one rotates.  The clk work
+		 * doubles as a reap backstop if no further ioctl comes.
+		 */
+		msm_rotator_dev->pending = 1;
+		msm_rotator_dev->pending_src_file = src_file;
+		msm_rotator_dev->pending_dst_file = dst_file;
+		schedule_delayed_work(&msm_rotator_dev->rot_clk_work, HZ);
+		mutex_unlock(&msm_rotator_dev->rotator_lock);
+		return 0;
+	}
+
 	wait_event(msm_rotator_dev->wq,
 		   (msm_rotator_dev->processing == 0));
 	status = (unsigned char)ioread32(MSM_ROTATOR_INTR_STATUS);
@@ -934,6 +1008,7 @@ static int msm_rotator_start(unsigned long arg)
 	}
 
 	mutex_lock(&msm_rotator_dev->rotator_lock);
+	msm_rotator_drain();
 	for (s = 0; s < MAX_SESSIONS; s++) {
 		if ((msm_rotator_dev->img_info[s] != NULL) &&
 			(info.session_id ==
@@ -982,6 +1057,19 @@ rotator_start_exit:
 	return rc;
 }
 
+static int msm_rotator_wait(unsigned long arg)
+{
+	int rc;
+
+	mutex_lock(&msm_rotator_dev->rotator_lock);
+	msm_rotator_drain();
+	rc = msm_rotator_dev->pending_rc;
+	msm_rotator_dev->pending_rc = 0;
+	mutex_unlock(&msm_rotator_dev->rotator_lock);
+
+	return rc;
+}
+
 static int msm_rotator_finish(unsigned long arg)
 {
 	int rc = 0;
@@ -992,6 +1080,7 @@ static int msm_rotator_finish(unsigned long arg)
 		return -EFAULT;
 
 	mutex_lock(&msm_rotator_dev->rotator_lock);
+	msm_rotator_drain();
 	for (s = 0; s < MAX_SESSIONS; s++) {
 		if ((msm_rotator_dev->img_info[s] != NULL) &&
 			(session_id ==
@@ -1021,7 +1110,11 @@ static int msm_rotator_ioctl(struct inode *inode, struct file *file,
 	case MSM_ROTATOR_IOCTL_START:
 		return msm_rotator_start(arg);
 	case MSM_ROTATOR_IOCTL_ROTATE:
-		return msm_rotator_do_rotate(arg);
+		return msm_rotator_do_rotate(arg, 0);
+	case MSM_ROTATOR_IOCTL_ROTATE_ASYNC:
+		return msm_rotator_do_rotate(arg, 1);
+	case MSM_ROTATOR_IOCTL_WAIT:
+		return msm_rotator_wait(arg);
 	case MSM_ROTATOR_IOCTL_FINISH:
 		return msm_rotator_finish(arg);
 
@@ -1279,6 +1372,7 @@ static int msm_rotator_suspend(struct platform_device *dev, pm_message_t state)
 	}
 	mutex_unlock(&msm_rotator_dev->imem_lock);
 	mutex_lock(&msm_rotator_dev->rotator_lock);
+	msm_rotator_drain();
 	if (msm_rotator_dev->rot_clk_state == CLK_EN) {
 		disable_rot_clks();
 		msm_rotator_dev->rot_clk_state = CLK_SUSPEND;
@@ -28,6 +28,14 @@
 #include <linux/cpu.h>
 #include <linux/completion.h>
 #include <linux/mutex.h>
+#ifdef CONFIG_INPUT
+#include <linux/input.h>
+#include <linux/pm_qos_params.h>
+#include <linux/workqueue.h>
+#endif
+#ifdef CONFIG_HAS_EARLYSUSPEND
+#include <linux/earlysuspend.h>
+#endif
 #include <linux/sched.h>
 
 #define dprintk(msg...) cpufreq_debug_printk(CPUFREQ_DEBUG_CORE, \
@@ -1535,6 +1543,396 @@ int cpufreq_unregister_notifier(struct notifier_block *nb, unsigned int list)
 EXPORT_SYMBOL(cpufreq_unregister_notifier);
 
 
+/*********************************************************************
+ *                         INPUT EVENT BOOST                         *
+ *********************************************************************/
+
+#ifdef CONFIG_INPUT
+/*
+ * Governors that set ->input_boost get an immediate floor frequency on
+ * input events, held for input_boost_ms, instead of paying their
+ * sampling ramp on the first touch after idle.  The floor is enforced
+ * in __cpufreq_driver_target() so it holds regardless of what the
+ * governor requests during the boost window.  A zero input_boost_freq
+ * (the default) disables the boost.
+ */
+static struct {
+	unsigned int freq;	/* floor in kHz, 0 = disabled */
+	unsigned int bus_khz;	/* bus/memory clock floor, 0 = disabled */
+	unsigned int ms;	/* hold period */
+	unsigned long end;	/* jiffies at which the boost expires */
+} input_boost = {
+	.ms = 100,
+};
+
+/*
+ * Bus bandwidth half of the boost: a PM_QOS_SYSTEM_BUS_FREQ vote (in
+ * kHz, aggregated by the platform - the bus/memory clock on MSM) held
+ * for the boost window and dropped automatically, so interactive work
+ * is not starved of memory bandwidth just because the bus scaled down
+ * with CPU frequency.  Independent of the governor's input_boost flag
+ * since the bus floor helps GPU- and IO-bound loads too.
+ */
+static struct pm_qos_request_list *input_boost_bus_req;
+
+static void cpufreq_input_bus_release_fn(struct work_struct *unused)
+{
+	if (input_boost_bus_req)
+		pm_qos_update_request(input_boost_bus_req,
+				      PM_QOS_DEFAULT_VALUE);
+}
+
+static DECLARE_DELAYED_WORK(cpufreq_input_bus_release_work,
+			    cpufreq_input_bus_release_fn);
+
+static unsigned int cpufreq_input_boost_floor(struct cpufreq_policy *policy,
+					      unsigned int target_freq)
+{
+	unsigned int floor;
+
+	if (!input_boost.freq || !policy->governor ||
+	    !policy->governor->input_boost)
+		return target_freq;
+
+	if (time_after(jiffies, input_boost.end))
+		return target_freq;
+
+	floor = min(input_boost.freq, policy->max);
+	return max(target_freq, floor);
+}
+
+static void cpufreq_input_boost_fn(struct work_struct *unused)
+{
+	struct cpufreq_policy *policy;
+	unsigned int floor;
+
+	if (input_boost.bus_khz && input_boost_bus_req) {
+		pm_qos_update_request(input_boost_bus_req,
+				      input_boost.bus_khz);
+		cancel_delayed_work(&cpufreq_input_bus_release_work);
+		schedule_delayed_work(&cpufreq_input_bus_release_work,
+				      msecs_to_jiffies(input_boost.ms));
+	}
+
+	policy = cpufreq_cpu_get(0);
+	if (!policy)
+		return;
+
+	if (lock_policy_rwsem_write(0) < 0)
+		goto out;
+
+	if (policy->governor && policy->governor->input_boost) {
+		floor = min(input_boost.freq, policy->max);
+		if (policy->cur < floor)
+			__cpufreq_driver_target(policy, floor,
+						CPUFREQ_RELATION_L);
+	}
+	unlock_policy_rwsem_write(0);
+out:
+	cpufreq_cpu_put(policy);
+}
+
+static DECLARE_WORK(cpufreq_input_boost_work, cpufreq_input_boost_fn);
+
+static void cpufreq_input_boost_event(struct input_handle *handle,
+		unsigned int type, unsigned int code, int value)
+{
+	if (!input_boost.freq && !input_boost.bus_khz)
+		return;
+
+	input_boost.end = jiffies + msecs_to_jiffies(input_boost.ms);
+	schedule_work_on(0, &cpufreq_input_boost_work);
+}
+
+static int cpufreq_input_boost_connect(struct input_handler *handler,
+		struct input_dev *dev, const struct input_device_id *id)
+{
+	struct input_handle *handle;
+	int error;
+
+	handle = kzalloc(sizeof(struct input_handle), GFP_KERNEL);
+	if (!handle)
+		return -ENOMEM;
+
+	handle->dev = dev;
+	handle->handler = handler;
+	handle->name = "cpufreq_boost";
+
+	error = input_register_handle(handle);
+	if (error)
+		goto err2;
+
+	error = input_open_device(handle);
+	if (error)
+		goto err1;
+
+	return 0;
+err1:
+	input_unregister_handle(handle);
+err2:
+	kfree(handle);
+	return error;
+}
+
+static void cpufreq_input_boost_disconnect(struct input_handle *handle)
+{
+	input_close_device(handle);
+	input_unregister_handle(handle);
+	kfree(handle);
+}
+
+static const struct input_device_id cpufreq_input_boost_ids[] = {
+	{ .driver_info = 1 },
+	{ },
+};
+
+static struct input_handler cpufreq_input_boost_handler = {
+	.event		= cpufreq_input_boost_event,
+	.connect	= cpufreq_input_boost_connect,
+	.disconnect	= cpufreq_input_boost_disconnect,
+	.name		= "cpufreq_boost",
+	.id_table	= cpufreq_input_boost_ids,
+};
+
+static ssize_t show_input_boost_freq(struct kobject *kobj,
+		struct attribute *attr, char *buf)
+{
+	return sprintf(buf, "%u\n", input_boost.freq);
+}
+
+static ssize_t store_input_boost_freq(struct kobject *a,
+		struct attribute *b, const char *buf, size_t count)
+{
+	unsigned int input;
+
+	if (sscanf(buf, "%u", &input) != 1)
+		return -EINVAL;
+
+	input_boost.freq = input;
+	return count;
+}
+
+static ssize_t show_input_boost_bus_khz(struct kobject *kobj,
+		struct attribute *attr, char *buf)
+{
+	return sprintf(buf, "%u\n", input_boost.bus_khz);
+}
+
+static ssize_t store_input_boost_bus_khz(struct kobject *a,
+		struct attribute *b, const char *buf, size_t count)
+{
+	unsigned int input;
+
+	if (sscanf(buf, "%u", &input) != 1)
+		return -EINVAL;
+
+	input_boost.bus_khz = input;
+	return count;
+}
+
+static ssize_t show_input_boost_ms(struct kobject *kobj,
+		struct attribute *attr, char *buf)
+{
+	return sprintf(buf, "%u\n", input_boost.ms);
+}
+
+static ssize_t store_input_boost_ms(struct kobject *a,
+		struct attribute *b, const char *buf, size_t count)
+{
+	unsigned int input;
+
+	if (sscanf(buf, "%u", &input) != 1 || input == 0)
+		return -EINVAL;
+
+	input_boost.ms = input;
+	return count;
+}
+
+define_one_global_rw(input_boost_freq);
+define_one_global_rw(input_boost_bus_khz);
+define_one_global_rw(input_boost_ms);
+
+static struct attribute *input_boost_attributes[] = {
+	&input_boost_freq.attr,
+	&input_boost_bus_khz.attr,
+	&input_boost_ms.attr,
+	NULL
+};
+
+static struct attribute_group input_boost_attr_group = {
+	.attrs = input_boost_attributes,
+	.name = "input_boost",
+};
+
+static void __init cpufreq_input_boost_init(void)
+{
+	int ret;
+
+	ret = sysfs_create_group(cpufreq_global_kobject,
+				 &input_boost_attr_group);
+	if (ret)
+		pr_err("%s: failed to create sysfs group: %d\n",
+			__func__, ret);
+
+	input_boost_bus_req = pm_qos_add_request(PM_QOS_SYSTEM_BUS_FREQ,
+						 PM_QOS_DEFAULT_VALUE);
+
+	ret = input_register_handler(&cpufreq_input_boost_handler);
+	if (ret)
+		pr_err("%s: failed to register input handler: %d\n",
+			__func__, ret);
+}
+#else
+static inline unsigned int cpufreq_input_boost_floor(
+		struct cpufreq_policy *policy, unsigned int target_freq)
+{
+	return target_freq;
+}
+
+static inline void cpufreq_input_boost_init(void) { }
+#endif /* CONFIG_INPUT */
+
+
+/*********************************************************************
+ *                     SCREEN-OFF FREQUENCY LIMITS                   *
+ *********************************************************************/
+
+#ifdef CONFIG_HAS_EARLYSUSPEND
+/*
+ * Kernel-side screen-state frequency policy: a configured cap/floor
+ * pair is applied through the CPUFREQ_ADJUST policy notifier the
+ * moment the screen blanks and removed on late resume.  This avoids
+ * the userspace sysfs write, which races with wakelocks and arrives
+ * hundreds of milliseconds after screen-off through the freeze path.
+ * Zero (the default) leaves the respective limit alone.
+ */
+static struct {
+	unsigned int max_freq;	/* cap while the screen is off */
+	unsigned int min_freq;	/* floor while the screen is off */
+	int active;
+} screen_off_limits;
+
+static int cpufreq_screen_off_policy_notifier(struct notifier_block *nb,
+		unsigned long val, void *data)
+{
+	struct cpufreq_policy *policy = data;
+
+	if (val != CPUFREQ_ADJUST || !screen_off_limits.active)
+		return 0;
+
+	if (screen_off_limits.max_freq)
+		cpufreq_verify_within_limits(policy, 0,
+					     screen_off_limits.max_freq);
+	if (screen_off_limits.min_freq)
+		cpufreq_verify_within_limits(policy,
+					     screen_off_limits.min_freq,
+					     UINT_MAX);
+	return 0;
+}
+
+static struct notifier_block screen_off_policy_nb = {
+	.notifier_call = cpufreq_screen_off_policy_notifier,
+};
+
+static void cpufreq_screen_off_update(void)
+{
+	unsigned int cpu;
+
+	for_each_online_cpu(cpu)
+		cpufreq_update_policy(cpu);
+}
+
+static void cpufreq_screen_off_early_suspend(struct early_suspend *h)
+{
+	screen_off_limits.active = 1;
+	cpufreq_screen_off_update();
+}
+
+static void cpufreq_screen_off_late_resume(struct early_suspend *h)
+{
+	screen_off_limits.active = 0;
+	cpufreq_screen_off_update();
+}
+
+static struct early_suspend cpufreq_screen_off_suspend_desc = {
+	.suspend = cpufreq_screen_off_early_suspend,
+	.resume = cpufreq_screen_off_late_resume,
+	.level = EARLY_SUSPEND_LEVEL_DISABLE_FB + 1,
+};
+
+static ssize_t show_screen_off_max_freq(struct kobject *kobj,
+		struct attribute *attr, char *buf)
+{
+	return sprintf(buf, "%u\n", screen_off_limits.max_freq);
+}
+
+static ssize_t store_screen_off_max_freq(struct kobject *a,
+		struct attribute *b, const char *buf, size_t count)
+{
+	unsigned int input;
+
+	if (sscanf(buf, "%u", &input) != 1)
+		return -EINVAL;
+
+	screen_off_limits.max_freq = input;
+	if (screen_off_limits.active)
+		cpufreq_screen_off_update();
+	return count;
+}
+
+static ssize_t show_screen_off_min_freq(struct kobject *kobj,
+		struct attribute *attr, char *buf)
+{
+	return sprintf(buf, "%u\n", screen_off_limits.min_freq);
+}
+
+static ssize_t store_screen_off_min_freq(struct kobject *a,
+		struct attribute *b, const char *buf, size_t count)
+{
+	unsigned int input;
+
+	if (sscanf(buf, "%u", &input) != 1)
+		return -EINVAL;
+
+	screen_off_limits.min_freq = input;
+	if (screen_off_limits.active)
+		cpufreq_screen_off_update();
+	return count;
+}
+
+define_one_global_rw(screen_off_max_freq);
+define_one_global_rw(screen_off_min_freq);
+
+static struct attribute *screen_off_attributes[] = {
+	&screen_off_max_freq.attr,
+	&screen_off_min_freq.attr,
+	NULL
+};
+
+static struct attribute_group screen_off_attr_group = {
+	.attrs = screen_off_attributes,
+	.name = "screen_off",
+};
+
+static void __init cpufreq_screen_off_init(void)
+{
+	int ret;
+
+	ret = sysfs_create_group(cpufreq_global_kobject,
+				 &screen_off_attr_group);
+	if (ret)
+		pr_err("%s: failed to create sysfs group: %d\n",
+			__func__, ret);
+
+	cpufreq_register_notifier(&screen_off_policy_nb,
+				  CPUFREQ_POLICY_NOTIFIER);
+	register_early_suspend(&cpufreq_screen_off_suspend_desc);
+}
+#else
+static inline void cpufreq_screen_off_init(void) { }
+#endif /* CONFIG_HAS_EARLYSUSPEND */
+
+
 /*********************************************************************
  *                              GOVERNORS                            *
  *********************************************************************/
@@ -1546,6 +1944,8 @@ int __cpufreq_driver_target(struct cpufreq_policy *policy,
 {
 	int retval = -EINVAL;
 
+	target_freq = cpufreq_input_boost_floor(policy, target_freq);
+
 	dprintk("target for CPU %u: %u kHz, relation %u\n", policy->cpu,
 		target_freq, relation);
 	if (cpu_online(policy->cpu) && cpufreq_driver->target)
@@ -2031,6 +2431,9 @@ static int __init cpufreq_core_init(void)
 						&cpu_sysdev_class.kset.kobj);
 	BUG_ON(!cpufreq_global_kobject);
 
+	cpufreq_input_boost_init();
+	cpufreq_screen_off_init();
+
 	return 0;
 }
 core_initcall(cpufreq_core_init);
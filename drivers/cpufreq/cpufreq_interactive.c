@@ -164,6 +164,7 @@ struct cpufreq_governor cpufreq_gov_interactive = {
 	.name = "interactive",
 	.governor = cpufreq_governor_interactive,
 	.max_transition_latency = 10000000,
+	.input_boost = 1,
 	.owner = THIS_MODULE,
 };
 
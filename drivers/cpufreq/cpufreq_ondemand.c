@@ -41,6 +41,7 @@
 #define MIN_FREQUENCY_UP_THRESHOLD		(11)
 #define MAX_FREQUENCY_UP_THRESHOLD		(100)
 #define MIN_FREQUENCY_DOWN_DIFFERENTIAL		(1)
+#define DEF_BG_LOAD_WEIGHT			(100)
 
 /*
  * The polling frequency of this governor depends on the capability of
@@ -82,6 +83,9 @@ struct cpu_dbs_info_s {
 	cputime64_t prev_cpu_iowait;
 	cputime64_t prev_cpu_wall;
 	cputime64_t prev_cpu_nice;
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	u64 prev_bg_exec;
+#endif
 	struct cpufreq_policy *cur_policy;
 	struct delayed_work work;
 	struct cpufreq_frequency_table *freq_table;
@@ -118,12 +122,18 @@ static struct dbs_tuners {
 	unsigned int sampling_down_factor;
 	unsigned int powersave_bias;
 	unsigned int io_is_busy;
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	unsigned int bg_load_weight;
+#endif
 } dbs_tuners_ins = {
 	.up_threshold = DEF_FREQUENCY_UP_THRESHOLD,
 	.sampling_down_factor = DEF_SAMPLING_DOWN_FACTOR,
 	.down_differential = DEF_FREQUENCY_DOWN_DIFFERENTIAL,
 	.ignore_nice = 0,
 	.powersave_bias = 0,
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	.bg_load_weight = DEF_BG_LOAD_WEIGHT,
+#endif
 };
 
 static inline cputime64_t get_cpu_idle_time_jiffy(unsigned int cpu,
@@ -272,6 +282,9 @@ show_one(down_differential, down_differential);
 show_one(sampling_down_factor, sampling_down_factor);
 show_one(ignore_nice_load, ignore_nice);
 show_one(powersave_bias, powersave_bias);
+#ifdef CONFIG_FAIR_GROUP_SCHED
+show_one(bg_load_weight, bg_load_weight);
+#endif
 
 /*** delete after deprecation time ***/
 
@@ -452,6 +465,25 @@ static ssize_t store_powersave_bias(struct kobject *a, struct attribute *b,
 	return count;
 }
 
+#ifdef CONFIG_FAIR_GROUP_SCHED
+static ssize_t store_bg_load_weight(struct kobject *a, struct attribute *b,
+				    const char *buf, size_t count)
+{
+	unsigned int input;
+	int ret;
+
+	ret = sscanf(buf, "%u", &input);
+	if (ret != 1 || input > 100)
+		return -EINVAL;
+
+	mutex_lock(&dbs_mutex);
+	dbs_tuners_ins.bg_load_weight = input;
+	mutex_unlock(&dbs_mutex);
+
+	return count;
+}
+#endif
+
 define_one_global_rw(sampling_rate);
 define_one_global_rw(io_is_busy);
 define_one_global_rw(up_threshold);
@@ -459,6 +491,9 @@ define_one_global_rw(down_differential);
 define_one_global_rw(sampling_down_factor);
 define_one_global_rw(ignore_nice_load);
 define_one_global_rw(powersave_bias);
+#ifdef CONFIG_FAIR_GROUP_SCHED
+define_one_global_rw(bg_load_weight);
+#endif
 
 static struct attribute *dbs_attributes[] = {
 	&sampling_rate_max.attr,
@@ -470,6 +505,9 @@ static struct attribute *dbs_attributes[] = {
 	&ignore_nice_load.attr,
 	&powersave_bias.attr,
 	&io_is_busy.attr,
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	&bg_load_weight.attr,
+#endif
 	NULL
 };
 
@@ -604,6 +642,36 @@ static void dbs_check_cpu(struct cpu_dbs_info_s *this_dbs_info)
 		if (dbs_tuners_ins.io_is_busy && idle_time >= iowait_time)
 			idle_time -= iowait_time;
 
+#ifdef CONFIG_FAIR_GROUP_SCHED
+		/*
+		 * Only count bg_load_weight percent of the time spent
+		 * running tasks from child cpu cgroups (the Android
+		 * background groups) as busy; the remainder is treated
+		 * as idle.  Background-only load then settles at mid
+		 * frequencies while foreground load still ramps to max.
+		 */
+		{
+			u64 cur_bg_exec = sched_group_child_exec_time(j);
+			u64 bg_exec_delta = cur_bg_exec -
+				j_dbs_info->prev_bg_exec;
+			unsigned int bg_time;
+
+			j_dbs_info->prev_bg_exec = cur_bg_exec;
+
+			do_div(bg_exec_delta, NSEC_PER_USEC);
+			bg_time = (unsigned int) bg_exec_delta;
+
+			if (dbs_tuners_ins.bg_load_weight < 100 &&
+			    wall_time >= idle_time) {
+				if (bg_time > wall_time - idle_time)
+					bg_time = wall_time - idle_time;
+				idle_time += bg_time *
+					(100 - dbs_tuners_ins.bg_load_weight) /
+					100;
+			}
+		}
+#endif
+
 		if (unlikely(!wall_time || wall_time < idle_time))
 			continue;
 
@@ -855,6 +923,10 @@ static int cpufreq_governor_dbs(struct cpufreq_policy *policy,
 				j_dbs_info->prev_cpu_nice =
 						kstat_cpu(j).cpustat.nice;
 			}
+#ifdef CONFIG_FAIR_GROUP_SCHED
+			j_dbs_info->prev_bg_exec =
+					sched_group_child_exec_time(j);
+#endif
 		}
 		this_dbs_info->cpu = cpu;
 		this_dbs_info->rate_mult = 1;
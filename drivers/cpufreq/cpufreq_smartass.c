@@ -145,6 +145,41 @@ static unsigned long max_cpu_load;
 #define DEFAULT_MIN_CPU_LOAD 25
 static unsigned long min_cpu_load;
 
+#ifdef CONFIG_HOTPLUG_CPU
+/*
+ * Hotplug coordination for multi-core targets (msm8x60): the governor
+ * brings the second core online when running flat out under load and
+ * parks it again when load drops to the minimum speed, instead of
+ * leaving that to a slow userspace daemon.  While suspended all
+ * non-boot cores stay parked.  Has no effect on single-core devices.
+ */
+#define DEFAULT_HOTPLUG_ENABLED 1
+static unsigned int hotplug_enabled;
+
+/*
+ * Bring another core online when load exceeds this while already at
+ * max speed.
+ */
+#define DEFAULT_HOTPLUG_UP_LOAD 80
+static unsigned long hotplug_up_load;
+
+/*
+ * Park a core when load drops below this at minimum speed.
+ */
+#define DEFAULT_HOTPLUG_DOWN_LOAD 20
+static unsigned long hotplug_down_load;
+
+/*
+ * The minimum amount of time between hotplug decisions.
+ */
+#define DEFAULT_HOTPLUG_RATE_US 200000
+static unsigned long hotplug_rate_us;
+
+static u64 hotplug_change_time;
+static int hotplug_target;
+static struct work_struct hotplug_work;
+#endif
+
 
 static int cpufreq_governor_smartass(struct cpufreq_policy *policy,
                 unsigned int event);
@@ -156,6 +191,7 @@ struct cpufreq_governor cpufreq_gov_smartass = {
         .name = "smartass",
         .governor = cpufreq_governor_smartass,
         .max_transition_latency = 9000000,
+        .input_boost = 1,
         .owner = THIS_MODULE,
 };
 
@@ -179,6 +215,54 @@ inline static unsigned int validate_freq(struct smartass_info_s *this_smartass,
         return freq;
 }
 
+#ifdef CONFIG_HOTPLUG_CPU
+static void smartass_hotplug_work_fn(struct work_struct *work)
+{
+        unsigned int cpu;
+
+        for_each_present_cpu(cpu) {
+                if (cpu == 0)
+                        continue;
+                if (hotplug_target && !cpu_online(cpu)) {
+                        cpu_up(cpu);
+                        break; // one core at a time
+                } else if (!hotplug_target && cpu_online(cpu))
+                        cpu_down(cpu);
+        }
+}
+
+static void smartass_hotplug_check(struct smartass_info_s *this_smartass,
+                struct cpufreq_policy *policy, int cpu_load, u64 now)
+{
+        int target;
+
+        // cpu0 makes all hotplug decisions; it never goes offline.
+        if (!hotplug_enabled || policy->cpu != 0 || num_possible_cpus() < 2)
+                return;
+
+        if (cputime64_sub(now, hotplug_change_time) < hotplug_rate_us)
+                return;
+
+        if (suspended || (cpu_load < hotplug_down_load &&
+                          policy->cur <= this_smartass->min_speed))
+                target = 0;
+        else if (!suspended && cpu_load > hotplug_up_load &&
+                 policy->cur >= this_smartass->max_speed)
+                target = 1;
+        else
+                return;
+
+        if (target && num_online_cpus() == num_possible_cpus())
+                return;
+        if (!target && num_online_cpus() == 1)
+                return;
+
+        hotplug_target = target;
+        hotplug_change_time = now;
+        queue_work(up_wq, &hotplug_work);
+}
+#endif
+
 static void reset_timer(unsigned long cpu, struct smartass_info_s *this_smartass) {
   this_smartass->time_in_idle = get_cpu_idle_time_us(cpu, &this_smartass->idle_exit_time);
   mod_timer(&this_smartass->timer, jiffies + sample_rate_jiffies);
@@ -220,6 +304,10 @@ static void cpufreq_smartass_timer(unsigned long data)
 
         this_smartass->cur_cpu_load = cpu_load;
 
+#ifdef CONFIG_HOTPLUG_CPU
+        smartass_hotplug_check(this_smartass, policy, cpu_load, update_time);
+#endif
+
         // Scale up if load is above max or if there where no idle cycles since coming out of idle,
         // or when we are above our max speed for a very long time (should only happend if entering sleep
         // at high loads)
@@ -243,6 +331,20 @@ static void cpufreq_smartass_timer(unsigned long data)
 
                 this_smartass->force_ramp_up = 1;
                 cpumask_set_cpu(data, &work_cpumask);
+#ifdef CONFIG_HOTPLUG_CPU
+                // coupled ramp: bring the other online cores up with us
+                if (hotplug_enabled) {
+                        unsigned int j;
+                        for_each_online_cpu(j) {
+                                struct smartass_info_s *j_smartass =
+                                        &per_cpu(smartass_info, j);
+                                if (j == data || !j_smartass->enable)
+                                        continue;
+                                j_smartass->force_ramp_up = 1;
+                                cpumask_set_cpu(j, &work_cpumask);
+                        }
+                }
+#endif
                 queue_work(up_wq, &freq_scale_work);
                 return;
         }
@@ -563,6 +665,80 @@ static ssize_t store_min_cpu_load(struct cpufreq_policy *policy, const char *buf
 static struct freq_attr min_cpu_load_attr = __ATTR(min_cpu_load, 0644,
                 show_min_cpu_load, store_min_cpu_load);
 
+#ifdef CONFIG_HOTPLUG_CPU
+static ssize_t show_hotplug_enabled(struct cpufreq_policy *policy, char *buf)
+{
+        return sprintf(buf, "%u\n", hotplug_enabled);
+}
+
+static ssize_t store_hotplug_enabled(struct cpufreq_policy *policy, const char *buf, size_t count)
+{
+        ssize_t res;
+        unsigned long input;
+        res = strict_strtoul(buf, 0, &input);
+        if (res >= 0)
+          hotplug_enabled = !!input;
+        return res;
+}
+
+static struct freq_attr hotplug_enabled_attr = __ATTR(hotplug_enabled, 0644,
+                show_hotplug_enabled, store_hotplug_enabled);
+
+static ssize_t show_hotplug_up_load(struct cpufreq_policy *policy, char *buf)
+{
+        return sprintf(buf, "%lu\n", hotplug_up_load);
+}
+
+static ssize_t store_hotplug_up_load(struct cpufreq_policy *policy, const char *buf, size_t count)
+{
+        ssize_t res;
+        unsigned long input;
+        res = strict_strtoul(buf, 0, &input);
+        if (res >= 0 && input <= 100)
+          hotplug_up_load = input;
+        return res;
+}
+
+static struct freq_attr hotplug_up_load_attr = __ATTR(hotplug_up_load, 0644,
+                show_hotplug_up_load, store_hotplug_up_load);
+
+static ssize_t show_hotplug_down_load(struct cpufreq_policy *policy, char *buf)
+{
+        return sprintf(buf, "%lu\n", hotplug_down_load);
+}
+
+static ssize_t store_hotplug_down_load(struct cpufreq_policy *policy, const char *buf, size_t count)
+{
+        ssize_t res;
+        unsigned long input;
+        res = strict_strtoul(buf, 0, &input);
+        if (res >= 0 && input <= 100)
+          hotplug_down_load = input;
+        return res;
+}
+
+static struct freq_attr hotplug_down_load_attr = __ATTR(hotplug_down_load, 0644,
+                show_hotplug_down_load, store_hotplug_down_load);
+
+static ssize_t show_hotplug_rate_us(struct cpufreq_policy *policy, char *buf)
+{
+        return sprintf(buf, "%lu\n", hotplug_rate_us);
+}
+
+static ssize_t store_hotplug_rate_us(struct cpufreq_policy *policy, const char *buf, size_t count)
+{
+        ssize_t res;
+        unsigned long input;
+        res = strict_strtoul(buf, 0, &input);
+        if (res >= 0 && input <= 100000000)
+          hotplug_rate_us = input;
+        return res;
+}
+
+static struct freq_attr hotplug_rate_us_attr = __ATTR(hotplug_rate_us, 0644,
+                show_hotplug_rate_us, store_hotplug_rate_us);
+#endif
+
 static struct attribute * smartass_attributes[] = {
         &debug_mask_attr.attr,
         &up_rate_us_attr.attr,
@@ -576,6 +752,12 @@ static struct attribute * smartass_attributes[] = {
         &ramp_down_step_attr.attr,
         &max_cpu_load_attr.attr,
         &min_cpu_load_attr.attr,
+#ifdef CONFIG_HOTPLUG_CPU
+        &hotplug_enabled_attr.attr,
+        &hotplug_up_load_attr.attr,
+        &hotplug_down_load_attr.attr,
+        &hotplug_rate_us_attr.attr,
+#endif
         NULL,
 };
 
@@ -675,12 +857,28 @@ static void smartass_suspend(int cpu, int suspend)
 
 static void smartass_early_suspend(struct early_suspend *handler) {
         int i;
+        suspended = 1;
         for_each_online_cpu(i)
                 smartass_suspend(i,1);
+#ifdef CONFIG_HOTPLUG_CPU
+        // screen-off profile: park the non-boot cores right away
+        if (hotplug_enabled && num_online_cpus() > 1) {
+                hotplug_target = 0;
+                queue_work(up_wq, &hotplug_work);
+        }
+#endif
 }
 
 static void smartass_late_resume(struct early_suspend *handler) {
         int i;
+        suspended = 0;
+#ifdef CONFIG_HOTPLUG_CPU
+        // wake with the second core available, the load will park it again
+        if (hotplug_enabled && num_online_cpus() < num_possible_cpus()) {
+                hotplug_target = 1;
+                queue_work(up_wq, &hotplug_work);
+        }
+#endif
         for_each_online_cpu(i)
                 smartass_suspend(i,0);
 }
@@ -707,6 +905,14 @@ static int __init cpufreq_smartass_init(void)
         ramp_down_step = DEFAULT_RAMP_DOWN_STEP;
         max_cpu_load = DEFAULT_MAX_CPU_LOAD;
         min_cpu_load = DEFAULT_MIN_CPU_LOAD;
+#ifdef CONFIG_HOTPLUG_CPU
+        hotplug_enabled = DEFAULT_HOTPLUG_ENABLED;
+        hotplug_up_load = DEFAULT_HOTPLUG_UP_LOAD;
+        hotplug_down_load = DEFAULT_HOTPLUG_DOWN_LOAD;
+        hotplug_rate_us = DEFAULT_HOTPLUG_RATE_US;
+        hotplug_change_time = 0;
+        INIT_WORK(&hotplug_work, smartass_hotplug_work_fn);
+#endif
 
         suspended = 0;
 
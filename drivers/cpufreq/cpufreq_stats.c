@@ -20,10 +20,20 @@
 #include <linux/kobject.h>
 #include <linux/spinlock.h>
 #include <linux/notifier.h>
+#include <linux/ktime.h>
+#include <linux/bitops.h>
 #include <asm/cputime.h>
 
 static spinlock_t cpufreq_stats_lock;
 
+/* Power-of-two microsecond buckets for transition latencies; the last
+ * bucket collects everything at or above 2^(BUCKETS-1) us. */
+#define CPUFREQ_STATS_LAT_BUCKETS 16
+
+/* A transition reversed within this window counts as an overshoot. */
+static unsigned int overshoot_window_ms = 100;
+module_param(overshoot_window_ms, uint, 0644);
+
 #define CPUFREQ_STATDEVICE_ATTR(_name, _mode, _show) \
 static struct freq_attr _attr_##_name = {\
 	.attr = {.name = __stringify(_name), .mode = _mode, }, \
@@ -42,6 +52,13 @@ struct cpufreq_stats {
 #ifdef CONFIG_CPU_FREQ_STAT_DETAILS
 	unsigned int *trans_table;
 #endif
+	ktime_t prechange_time;
+	int prechange_pending;
+	unsigned int trans_latency[CPUFREQ_STATS_LAT_BUCKETS];
+	unsigned int max_trans_latency_us;
+	ktime_t last_trans_time;
+	int last_trans_dir;
+	unsigned int overshoot;
 };
 
 static DEFINE_PER_CPU(struct cpufreq_stats *, cpufreq_stats_table);
@@ -140,12 +157,39 @@ static ssize_t show_trans_table(struct cpufreq_policy *policy, char *buf)
 CPUFREQ_STATDEVICE_ATTR(trans_table, 0444, show_trans_table);
 #endif
 
+static ssize_t show_trans_latency(struct cpufreq_policy *policy, char *buf)
+{
+	ssize_t len = 0;
+	int i;
+	struct cpufreq_stats *stat = per_cpu(cpufreq_stats_table, policy->cpu);
+	if (!stat)
+		return 0;
+	len += sprintf(buf + len, "buckets: <1us <2us <4us ... >=%uus\n",
+			1U << (CPUFREQ_STATS_LAT_BUCKETS - 1));
+	for (i = 0; i < CPUFREQ_STATS_LAT_BUCKETS; i++)
+		len += sprintf(buf + len, "%u ", stat->trans_latency[i]);
+	len += sprintf(buf + len, "\nmax %uus\n", stat->max_trans_latency_us);
+	return len;
+}
+
+static ssize_t show_overshoot(struct cpufreq_policy *policy, char *buf)
+{
+	struct cpufreq_stats *stat = per_cpu(cpufreq_stats_table, policy->cpu);
+	if (!stat)
+		return 0;
+	return sprintf(buf, "%u\n", stat->overshoot);
+}
+
 CPUFREQ_STATDEVICE_ATTR(total_trans, 0444, show_total_trans);
 CPUFREQ_STATDEVICE_ATTR(time_in_state, 0444, show_time_in_state);
+CPUFREQ_STATDEVICE_ATTR(trans_latency, 0444, show_trans_latency);
+CPUFREQ_STATDEVICE_ATTR(overshoot, 0444, show_overshoot);
 
 static struct attribute *default_attrs[] = {
 	&_attr_total_trans.attr,
 	&_attr_time_in_state.attr,
+	&_attr_trans_latency.attr,
+	&_attr_overshoot.attr,
 #ifdef CONFIG_CPU_FREQ_STAT_DETAILS
 	&_attr_trans_table.attr,
 #endif
@@ -271,6 +315,43 @@ static int cpufreq_stat_notifier_policy(struct notifier_block *nb,
 	return 0;
 }
 
+static void cpufreq_stats_record_latency(struct cpufreq_stats *stat,
+		struct cpufreq_freqs *freq)
+{
+	ktime_t now = ktime_get();
+	unsigned int us;
+	int bucket;
+
+	if (stat->prechange_pending) {
+		us = (unsigned int) ktime_to_us(ktime_sub(now,
+					stat->prechange_time));
+		bucket = fls(us);
+		if (bucket >= CPUFREQ_STATS_LAT_BUCKETS)
+			bucket = CPUFREQ_STATS_LAT_BUCKETS - 1;
+		stat->trans_latency[bucket]++;
+		if (us > stat->max_trans_latency_us)
+			stat->max_trans_latency_us = us;
+		stat->prechange_pending = 0;
+	}
+
+	/*
+	 * A transition in the opposite direction of the previous one,
+	 * within the overshoot window, means the governor went too far
+	 * and immediately had to back off.
+	 */
+	if (freq->new != freq->old) {
+		int dir = freq->new > freq->old ? 1 : -1;
+
+		if (stat->last_trans_dir && dir != stat->last_trans_dir &&
+		    ktime_to_ns(ktime_sub(now, stat->last_trans_time)) <
+		    (s64) overshoot_window_ms * NSEC_PER_MSEC)
+			stat->overshoot++;
+
+		stat->last_trans_dir = dir;
+		stat->last_trans_time = now;
+	}
+}
+
 static int cpufreq_stat_notifier_trans(struct notifier_block *nb,
 		unsigned long val, void *data)
 {
@@ -278,13 +359,25 @@ static int cpufreq_stat_notifier_trans(struct notifier_block *nb,
 	struct cpufreq_stats *stat;
 	int old_index, new_index;
 
-	if (val != CPUFREQ_POSTCHANGE)
+	if (val != CPUFREQ_PRECHANGE && val != CPUFREQ_POSTCHANGE)
 		return 0;
 
 	stat = per_cpu(cpufreq_stats_table, freq->cpu);
 	if (!stat)
 		return 0;
 
+	if (val == CPUFREQ_PRECHANGE) {
+		spin_lock(&cpufreq_stats_lock);
+		stat->prechange_time = ktime_get();
+		stat->prechange_pending = 1;
+		spin_unlock(&cpufreq_stats_lock);
+		return 0;
+	}
+
+	spin_lock(&cpufreq_stats_lock);
+	cpufreq_stats_record_latency(stat, freq);
+	spin_unlock(&cpufreq_stats_lock);
+
 	old_index = stat->last_index;
 	new_index = freq_table_get_index(stat, freq->new);
 
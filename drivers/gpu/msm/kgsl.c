@@ -801,6 +801,7 @@ static long kgsl_ioctl_rb_issueibcmds(struct kgsl_device_private *dev_priv,
 {
 	int result = 0;
 	struct kgsl_ringbuffer_issueibcmds param;
+	struct kgsl_ibdesc stack_ibdesc[KGSL_NUM_STACK_IBS];
 	struct kgsl_ibdesc *ibdesc;
 	struct kgsl_context *context;
 
@@ -820,21 +821,26 @@ static long kgsl_ioctl_rb_issueibcmds(struct kgsl_device_private *dev_priv,
 	if (param.flags & KGSL_CONTEXT_SUBMIT_IB_LIST) {
 		KGSL_DRV_INFO("Using IB list mode for ib submission, numibs:"
 				" %d\n", param.numibs);
-		if (!param.numibs) {
+		if (!param.numibs || param.numibs > KGSL_MAX_NUMIBS) {
 			KGSL_DRV_ERR("Invalid numibs as parameter: %d\n",
 					param.numibs);
 			result = -EINVAL;
 			goto done;
 		}
 
-		ibdesc = kzalloc(sizeof(struct kgsl_ibdesc) * param.numibs,
-					GFP_KERNEL);
-		if (!ibdesc) {
-			KGSL_MEM_ERR("kzalloc failed to allocate memory for "
-				"ibdesc , size: %x\n",
-				sizeof(struct kgsl_ibdesc) * param.numibs);
-			result = -ENOMEM;
-			goto done;
+		if (param.numibs <= KGSL_NUM_STACK_IBS) {
+			ibdesc = stack_ibdesc;
+		} else {
+			ibdesc = kzalloc(sizeof(struct kgsl_ibdesc) *
+					param.numibs, GFP_KERNEL);
+			if (!ibdesc) {
+				KGSL_MEM_ERR("kzalloc failed to allocate "
+					"memory for ibdesc , size: %x\n",
+					sizeof(struct kgsl_ibdesc) *
+					param.numibs);
+				result = -ENOMEM;
+				goto done;
+			}
 		}
 
 		if (copy_from_user(ibdesc, (void *)param.ibdesc_addr,
@@ -849,14 +855,8 @@ static long kgsl_ioctl_rb_issueibcmds(struct kgsl_device_private *dev_priv,
 				" submission\n");
 		/* If user space driver is still using the old mode of
 		 * submitting single ib then we need to support that as well */
-		ibdesc = kzalloc(sizeof(struct kgsl_ibdesc), GFP_KERNEL);
-		if (!ibdesc) {
-			KGSL_MEM_ERR("kzalloc failed to allocate memory for"
-				" ibdesc, size: %x\n",
-				sizeof(struct kgsl_ibdesc));
-			result = -ENOMEM;
-			goto done;
-		}
+		ibdesc = stack_ibdesc;
+		memset(&ibdesc[0], 0, sizeof(ibdesc[0]));
 		ibdesc[0].gpuaddr = param.ibdesc_addr;
 		ibdesc[0].sizedwords = param.numibs;
 		param.numibs = 1;
@@ -878,6 +878,8 @@ static long kgsl_ioctl_rb_issueibcmds(struct kgsl_device_private *dev_priv,
 	if (result != 0)
 		goto free_ibdesc;
 
+	kgsl_gputime_submit(dev_priv->device, context->id, param.timestamp);
+
 	/* this is a check to try to detect if a command buffer was freed
 	 * during issueibcmds().
 	 */
@@ -892,7 +894,8 @@ static long kgsl_ioctl_rb_issueibcmds(struct kgsl_device_private *dev_priv,
 		goto free_ibdesc;
 	}
 free_ibdesc:
-	kfree(ibdesc);
+	if (ibdesc != stack_ibdesc)
+		kfree(ibdesc);
 done:
 	return result;
 }
@@ -1938,6 +1941,7 @@ static int __devinit kgsl_platform_probe(struct platform_device *pdev)
 	result = kgsl_drm_init(pdev);
 
 	INIT_LIST_HEAD(&kgsl_driver.pagetable_list);
+	INIT_LIST_HEAD(&kgsl_driver.pt_cache);
 	pm_runtime_enable(&pdev->dev);
 
 	result = kgsl_yamato_init(device);
@@ -2024,12 +2028,14 @@ static struct platform_driver kgsl_platform_driver = {
 
 static int __init kgsl_mod_init(void)
 {
+	kgsl_sharedmem_init();
 	return platform_driver_register(&kgsl_platform_driver);
 }
 
 static void __exit kgsl_mod_exit(void)
 {
 	platform_driver_unregister(&kgsl_platform_driver);
+	kgsl_sharedmem_uninit();
 }
 
 #ifdef MODULE
@@ -61,6 +61,16 @@
 #define KGSL_NUM_2D_DEVICES 2
 #define IDX_2D(X) ((X)-KGSL_DEVICE_2D0)
 
+/*
+ * IB-list submissions up to this size stay on the stack instead of
+ * going through the allocator; GL issues hundreds of small batches per
+ * frame, so the common path must be allocation free.
+ */
+#define KGSL_NUM_STACK_IBS	16
+
+/* Upper bound on one IB-list submission, to keep allocations sane */
+#define KGSL_MAX_NUMIBS		10000
+
 /* The size of each entry in a page table */
 #define KGSL_PAGETABLE_ENTRY_SIZE  4
 
@@ -92,6 +102,9 @@ struct kgsl_driver {
 	struct list_head process_list;
 	/* Global list of pagetables */
 	struct list_head pagetable_list;
+	/* Cache of retired pagetables kept ready for reuse */
+	struct list_head pt_cache;
+	unsigned int pt_cache_count;
 	/* Mutex for accessing the pagetable list */
 	struct mutex pt_mutex;
 	/* Mutex for accessing the process list */
@@ -16,6 +16,8 @@
  *
  */
 
+#include <linux/sched.h>
+
 #include "kgsl.h"
 #include "kgsl_log.h"
 #include "kgsl_cmdstream.h"
@@ -61,6 +63,61 @@ kgsl_cmdstream_readtimestamp(struct kgsl_device *device,
 	return timestamp;
 }
 
+/*
+ * Remember a submission so the gpu time it takes can be charged to its
+ * context once it retires.  Called with the device mutex held.
+ */
+void kgsl_gputime_submit(struct kgsl_device *device, unsigned int context_id,
+			 uint32_t timestamp)
+{
+	struct kgsl_gputime *gputime = &device->gputime;
+	unsigned int slot = gputime->pending_head % KGSL_GPUTIME_PENDING;
+
+	if (gputime->pending_head - gputime->pending_tail >=
+	    KGSL_GPUTIME_PENDING)
+		return;
+
+	gputime->pending[slot].context_id = context_id;
+	gputime->pending[slot].timestamp = timestamp;
+	gputime->pending[slot].submit_ns = sched_clock();
+	gputime->pending_head++;
+}
+
+/*
+ * Charge retired submissions against their contexts.  Retirement times
+ * are only known at sampling resolution, so each drain attributes the
+ * busy window since the previous sample to the retired contexts in
+ * submission order; the total never double counts.  Called with the
+ * device mutex held.
+ */
+static void kgsl_gputime_sample(struct kgsl_device *device,
+				uint32_t ts_processed)
+{
+	struct kgsl_gputime *gputime = &device->gputime;
+	unsigned long long now = sched_clock();
+
+	while (gputime->pending_tail != gputime->pending_head) {
+		struct kgsl_gputime_pending *pending =
+			&gputime->pending[gputime->pending_tail %
+					  KGSL_GPUTIME_PENDING];
+		unsigned long long start;
+		unsigned int id;
+
+		if (!timestamp_cmp(ts_processed, pending->timestamp))
+			break;
+
+		start = max(pending->submit_ns, gputime->last_retire_ns);
+		if (now > start) {
+			id = min_t(unsigned int, pending->context_id,
+				   KGSL_GPUTIME_CTXTS - 1);
+			gputime->busy_ns[id] += now - start;
+			gputime->submits[id]++;
+			gputime->last_retire_ns = now;
+		}
+		gputime->pending_tail++;
+	}
+}
+
 void kgsl_cmdstream_memqueue_drain(struct kgsl_device *device)
 {
 	struct kgsl_mem_entry *entry, *entry_tmp;
@@ -73,6 +130,8 @@ void kgsl_cmdstream_memqueue_drain(struct kgsl_device *device)
 					device,
 					KGSL_TIMESTAMP_RETIRED);
 
+	kgsl_gputime_sample(device, ts_processed);
+
 	list_for_each_entry_safe(entry, entry_tmp, &device->memqueue, list) {
 		KGSL_MEM_DBG("ts_processed %d ts_free %d gpuaddr %x)\n",
 			     ts_processed, entry->free_timestamp,
@@ -62,6 +62,9 @@ int kgsl_cmdstream_close(struct kgsl_device *device);
 
 void kgsl_cmdstream_memqueue_drain(struct kgsl_device *device);
 
+void kgsl_gputime_submit(struct kgsl_device *device, unsigned int context_id,
+			 uint32_t timestamp);
+
 uint32_t
 kgsl_cmdstream_readtimestamp(struct kgsl_device *device,
 			     enum kgsl_timestamp_type type);
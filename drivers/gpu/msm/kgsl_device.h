@@ -131,6 +131,29 @@ struct kgsl_memregion {
 	unsigned int   sizebytes;
 };
 
+/*
+ * Per-context gpu time accounting, sampled whenever the memqueue is
+ * drained against the retired timestamp.  All state is protected by
+ * the device mutex.
+ */
+#define KGSL_GPUTIME_PENDING	64	/* in-flight submissions tracked */
+#define KGSL_GPUTIME_CTXTS	33	/* last slot collects overflow ids */
+
+struct kgsl_gputime_pending {
+	unsigned int context_id;
+	uint32_t timestamp;
+	unsigned long long submit_ns;
+};
+
+struct kgsl_gputime {
+	struct kgsl_gputime_pending pending[KGSL_GPUTIME_PENDING];
+	unsigned int pending_head;
+	unsigned int pending_tail;
+	unsigned long long busy_ns[KGSL_GPUTIME_CTXTS];
+	unsigned int submits[KGSL_GPUTIME_CTXTS];
+	unsigned long long last_retire_ns;
+};
+
 struct kgsl_device {
 	struct device *dev;
 	const char *name;
@@ -154,6 +177,7 @@ struct kgsl_device {
 	uint32_t		requested_state;
 
 	struct list_head memqueue;
+	struct kgsl_gputime gputime;
 	unsigned int active_cnt;
 	struct completion suspend_gate;
 
@@ -18,6 +18,7 @@
 
 #include <linux/delay.h>
 #include <linux/debugfs.h>
+#include <linux/slab.h>
 #include <linux/uaccess.h>
 #include <linux/io.h>
 
@@ -472,6 +473,102 @@ static const struct file_operations kgsl_mh_debug_fops = {
 	.read = kgsl_mh_debug_read,
 };
 
+static ssize_t kgsl_gputime_read(
+	struct file *file,
+	char __user *buff,
+	size_t buff_count,
+	loff_t *ppos)
+{
+	char *buf;
+	int i, minor, len = 0;
+	ssize_t ret;
+
+	buf = kmalloc(2 * PAGE_SIZE, GFP_KERNEL);
+	if (buf == NULL)
+		return -ENOMEM;
+
+	for (minor = 0; minor < KGSL_DEVICE_MAX; minor++) {
+		struct kgsl_device *device = kgsl_driver.devp[minor];
+		struct kgsl_gputime *gputime;
+
+		if (device == NULL)
+			continue;
+
+		gputime = &device->gputime;
+		mutex_lock(&device->mutex);
+		len += scnprintf(buf + len, 2 * PAGE_SIZE - len,
+				 "%s: ctxt busy_ns submits\n", device->name);
+		for (i = 0; i < KGSL_GPUTIME_CTXTS; i++) {
+			if (gputime->submits[i] == 0)
+				continue;
+			len += scnprintf(buf + len, 2 * PAGE_SIZE - len,
+					 "%d %llu %u\n", i,
+					 gputime->busy_ns[i],
+					 gputime->submits[i]);
+		}
+		mutex_unlock(&device->mutex);
+	}
+
+	ret = simple_read_from_buffer(buff, buff_count, ppos, buf, len);
+	kfree(buf);
+	return ret;
+}
+
+static const struct file_operations kgsl_gputime_fops = {
+	.open = kgsl_dbgfs_open,
+	.release = kgsl_dbgfs_release,
+	.read = kgsl_gputime_read,
+};
+
+static ssize_t kgsl_pwrlog_read(
+	struct file *file,
+	char __user *buff,
+	size_t buff_count,
+	loff_t *ppos)
+{
+	char *buf;
+	unsigned int i, first, count;
+	int minor, len = 0;
+	ssize_t ret;
+
+	buf = kmalloc(2 * PAGE_SIZE, GFP_KERNEL);
+	if (buf == NULL)
+		return -ENOMEM;
+
+	for (minor = 0; minor < KGSL_DEVICE_MAX; minor++) {
+		struct kgsl_device *device = kgsl_driver.devp[minor];
+		struct kgsl_pwrlog *log;
+
+		if (device == NULL)
+			continue;
+
+		log = &device->pwrctrl.pwrlog;
+		mutex_lock(&device->mutex);
+		len += scnprintf(buf + len, 2 * PAGE_SIZE - len,
+				 "%s: when_ns pwrflag\n", device->name);
+		count = min_t(unsigned int, log->head, KGSL_PWRLOG_ENTRIES);
+		first = log->head - count;
+		for (i = first; i != log->head; i++) {
+			struct kgsl_pwrlog_entry *entry =
+				&log->entries[i % KGSL_PWRLOG_ENTRIES];
+			len += scnprintf(buf + len, 2 * PAGE_SIZE - len,
+					 "%llu %#x\n", entry->when_ns,
+					 entry->pwrflag);
+		}
+		mutex_unlock(&device->mutex);
+	}
+
+	ret = simple_read_from_buffer(buff, buff_count, ppos, buf, len);
+	kfree(buf);
+	return ret;
+}
+
+static const struct file_operations kgsl_pwrlog_fops = {
+	.open = kgsl_dbgfs_open,
+	.release = kgsl_dbgfs_release,
+	.read = kgsl_pwrlog_read,
+};
+
 #endif /* CONFIG_DEBUG_FS */
 
 int kgsl_debug_init(void)
@@ -497,6 +594,9 @@ int kgsl_debug_init(void)
 	debugfs_create_file("cp_debug", 0400, dent, 0, &kgsl_cp_debug_fops);
 	debugfs_create_file("mh_debug", 0400, dent, 0, &kgsl_mh_debug_fops);
 
+	debugfs_create_file("gputime",  0400, dent, 0, &kgsl_gputime_fops);
+	debugfs_create_file("pwr_log",  0400, dent, 0, &kgsl_pwrlog_fops);
+
 #ifdef CONFIG_MSM_KGSL_MMU
 	debugfs_create_file("cache_enable", 0644, dent, 0,
 				&kgsl_cache_enable_fops);
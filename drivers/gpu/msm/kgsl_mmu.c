@@ -146,6 +146,28 @@ void kgsl_mh_intrcallback(struct kgsl_device *device)
 	KGSL_MEM_VDBG("return\n");
 }
 
+/* How many retired pagetables to keep around for reuse */
+#define KGSL_PT_CACHE_MAX	2
+
+static void kgsl_mmu_freepagetable(struct kgsl_pagetable *pagetable)
+{
+	dma_pool_free(kgsl_driver.ptpool, pagetable->base.hostptr,
+		      pagetable->base.physaddr);
+
+	if (pagetable->pool) {
+		gen_pool_destroy(pagetable->pool);
+		pagetable->pool = NULL;
+	}
+
+	if (pagetable->tlbflushfilter.base) {
+		pagetable->tlbflushfilter.size = 0;
+		kfree(pagetable->tlbflushfilter.base);
+		pagetable->tlbflushfilter.base = NULL;
+	}
+
+	kfree(pagetable);
+}
+
 static struct kgsl_pagetable *kgsl_mmu_createpagetableobject(
 				struct kgsl_mmu *mmu,
 				unsigned int name)
@@ -155,6 +177,38 @@ static struct kgsl_pagetable *kgsl_mmu_createpagetableobject(
 
 	KGSL_MEM_VDBG("enter (mmu=%p)\n", mmu);
 
+	/*
+	 * Reuse a retired pagetable matching this mmu's address range if
+	 * one is cached: it keeps its backing page, flush filter and
+	 * address pool, so only the global mappings need to be redone.
+	 * Process churn otherwise pays for a full pagetable setup on
+	 * every app start.
+	 */
+	list_for_each_entry(pagetable, &kgsl_driver.pt_cache, list) {
+		if (pagetable->va_base != mmu->va_base ||
+		    pagetable->va_range != mmu->va_range)
+			continue;
+
+		list_del(&pagetable->list);
+		kgsl_driver.pt_cache_count--;
+
+		pagetable->refcnt = 1;
+		pagetable->name = name;
+		pagetable->tlb_flags = 0;
+		pagetable->last_superpte = 0;
+		GSL_TLBFLUSH_FILTER_RESET();
+
+		if (kgsl_setup_pt(pagetable)) {
+			kgsl_mmu_freepagetable(pagetable);
+			return NULL;
+		}
+
+		list_add(&pagetable->list, &kgsl_driver.pagetable_list);
+
+		KGSL_MEM_VDBG("return %p (cached)\n", pagetable);
+		return pagetable;
+	}
+
 	pagetable = kzalloc(sizeof(struct kgsl_pagetable), GFP_KERNEL);
 	if (pagetable == NULL) {
 		KGSL_MEM_ERR("Unable to allocate pagetable object.\n");
@@ -233,21 +287,13 @@ static void kgsl_mmu_destroypagetable(struct kgsl_pagetable *pagetable)
 
 	kgsl_cleanup_pt(pagetable);
 
-	dma_pool_free(kgsl_driver.ptpool, pagetable->base.hostptr,
-		      pagetable->base.physaddr);
-
-	if (pagetable->pool) {
-		gen_pool_destroy(pagetable->pool);
-		pagetable->pool = NULL;
-	}
-
-	if (pagetable->tlbflushfilter.base) {
-		pagetable->tlbflushfilter.size = 0;
-		kfree(pagetable->tlbflushfilter.base);
-		pagetable->tlbflushfilter.base = NULL;
+	if (kgsl_driver.pt_cache_count < KGSL_PT_CACHE_MAX) {
+		list_add(&pagetable->list, &kgsl_driver.pt_cache);
+		kgsl_driver.pt_cache_count++;
+		return;
 	}
 
-	kfree(pagetable);
+	kgsl_mmu_freepagetable(pagetable);
 }
 
 struct kgsl_pagetable *kgsl_mmu_getpagetable(struct kgsl_mmu *mmu,
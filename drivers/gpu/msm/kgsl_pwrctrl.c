@@ -17,6 +17,7 @@
  */
 #include <linux/interrupt.h>
 #include <linux/err.h>
+#include <linux/sched.h>
 #include <mach/clk.h>
 #include <mach/dal_axi.h>
 #include <mach/msm_bus.h>
@@ -76,6 +77,17 @@ void kgsl_pwrctrl_uninit_sysfs(struct kgsl_device *device)
 	device_remove_file(device->dev, &pwrio_fraction_attr);
 }
 
+/* Record a power transition; called with the device mutex held */
+void kgsl_pwrlog_add(struct kgsl_device *device, unsigned int pwrflag)
+{
+	struct kgsl_pwrlog *log = &device->pwrctrl.pwrlog;
+	unsigned int slot = log->head % KGSL_PWRLOG_ENTRIES;
+
+	log->entries[slot].when_ns = sched_clock();
+	log->entries[slot].pwrflag = pwrflag;
+	log->head++;
+}
+
 int kgsl_pwrctrl_clk(struct kgsl_device *device, unsigned int pwrflag)
 {
 	struct kgsl_pwrctrl *pwr = &device->pwrctrl;
@@ -96,6 +108,7 @@ int kgsl_pwrctrl_clk(struct kgsl_device *device, unsigned int pwrflag)
 			pwr->power_flags &=
 					~(KGSL_PWRFLAGS_CLK_ON);
 			pwr->power_flags |= KGSL_PWRFLAGS_CLK_OFF;
+			kgsl_pwrlog_add(device, KGSL_PWRFLAGS_CLK_OFF);
 		}
 		return KGSL_SUCCESS;
 	case KGSL_PWRFLAGS_CLK_ON:
@@ -114,6 +127,7 @@ int kgsl_pwrctrl_clk(struct kgsl_device *device, unsigned int pwrflag)
 			pwr->power_flags &=
 				~(KGSL_PWRFLAGS_CLK_OFF);
 			pwr->power_flags |= KGSL_PWRFLAGS_CLK_ON;
+			kgsl_pwrlog_add(device, KGSL_PWRFLAGS_CLK_ON);
 		}
 		return KGSL_SUCCESS;
 	default:
@@ -136,6 +150,7 @@ int kgsl_pwrctrl_axi(struct kgsl_device *device, unsigned int pwrflag)
 			pwr->power_flags &=
 				~(KGSL_PWRFLAGS_AXI_ON);
 			pwr->power_flags |= KGSL_PWRFLAGS_AXI_OFF;
+			kgsl_pwrlog_add(device, KGSL_PWRFLAGS_AXI_OFF);
 		}
 		return KGSL_SUCCESS;
 	case KGSL_PWRFLAGS_AXI_ON:
@@ -148,6 +163,7 @@ int kgsl_pwrctrl_axi(struct kgsl_device *device, unsigned int pwrflag)
 			pwr->power_flags &=
 				~(KGSL_PWRFLAGS_AXI_OFF);
 			pwr->power_flags |= KGSL_PWRFLAGS_AXI_ON;
+			kgsl_pwrlog_add(device, KGSL_PWRFLAGS_AXI_ON);
 		}
 		return KGSL_SUCCESS;
 	default:
@@ -174,6 +190,7 @@ int kgsl_pwrctrl_pwrrail(struct kgsl_device *device, unsigned int pwrflag)
 					~(KGSL_PWRFLAGS_POWER_ON);
 			pwr->power_flags |=
 					KGSL_PWRFLAGS_POWER_OFF;
+			kgsl_pwrlog_add(device, KGSL_PWRFLAGS_POWER_OFF);
 		}
 		return KGSL_SUCCESS;
 	case KGSL_PWRFLAGS_POWER_ON:
@@ -190,6 +207,7 @@ int kgsl_pwrctrl_pwrrail(struct kgsl_device *device, unsigned int pwrflag)
 					~(KGSL_PWRFLAGS_POWER_OFF);
 			pwr->power_flags |=
 					KGSL_PWRFLAGS_POWER_ON;
+			kgsl_pwrlog_add(device, KGSL_PWRFLAGS_POWER_ON);
 		}
 		return KGSL_SUCCESS;
 	default:
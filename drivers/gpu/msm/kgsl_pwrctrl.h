@@ -60,6 +60,23 @@ enum kgsl_clk_freq {
 	KGSL_NUM_FREQ = 4
 };
 
+/*
+ * Ring of recent power transitions (clk/axi/rail on and off) with the
+ * time they happened, so governor behavior can be reconstructed from
+ * the field.  Protected by the device mutex.
+ */
+#define KGSL_PWRLOG_ENTRIES	128
+
+struct kgsl_pwrlog_entry {
+	unsigned long long when_ns;
+	unsigned int pwrflag;
+};
+
+struct kgsl_pwrlog {
+	struct kgsl_pwrlog_entry entries[KGSL_PWRLOG_ENTRIES];
+	unsigned int head;
+};
+
 struct kgsl_pwrctrl {
 	int interrupt_num;
 	int have_irq;
@@ -79,8 +96,11 @@ struct kgsl_pwrctrl {
 	unsigned int io_fraction;
 	unsigned int io_count;
 	struct kgsl_yamato_context *suspended_ctxt;
+	struct kgsl_pwrlog pwrlog;
 };
 
+void kgsl_pwrlog_add(struct kgsl_device *device, unsigned int pwrflag);
+
 int kgsl_pwrctrl_clk(struct kgsl_device *device, unsigned int pwrflag);
 int kgsl_pwrctrl_axi(struct kgsl_device *device, unsigned int pwrflag);
 int kgsl_pwrctrl_pwrrail(struct kgsl_device *device, unsigned int pwrflag);
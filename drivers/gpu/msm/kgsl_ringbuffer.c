@@ -742,6 +742,7 @@ kgsl_ringbuffer_issueibcmds(struct kgsl_device_private *dev_priv,
 {
 	struct kgsl_device *device = dev_priv->device;
 	struct kgsl_yamato_device *yamato_device = KGSL_YAMATO_DEVICE(device);
+	unsigned int stack_link[KGSL_NUM_STACK_IBS * 3];
 	unsigned int *link;
 	unsigned int *cmds;
 	unsigned int i;
@@ -763,13 +764,18 @@ kgsl_ringbuffer_issueibcmds(struct kgsl_device_private *dev_priv,
 	BUG_ON(ibdesc == 0);
 	BUG_ON(numibs == 0);
 
-	link = kzalloc(sizeof(unsigned int) * numibs * 3, GFP_KERNEL);
-	cmds = link;
-	if (!link) {
-		KGSL_MEM_ERR("Failed to allocate memory for for command"
-				" submission, size %x\n", numibs * 3);
-		return -ENOMEM;
+	if (numibs <= KGSL_NUM_STACK_IBS) {
+		link = stack_link;
+	} else {
+		link = kzalloc(sizeof(unsigned int) * numibs * 3, GFP_KERNEL);
+		if (!link) {
+			KGSL_MEM_ERR("Failed to allocate memory for for"
+					" command submission, size %x\n",
+					numibs * 3);
+			return -ENOMEM;
+		}
 	}
+	cmds = link;
 	for (i = 0; i < numibs; i++) {
 		kgsl_cffdump_parse_ibs(dev_priv, NULL,
 			ibdesc[i].gpuaddr, ibdesc[i].sizedwords, false);
@@ -793,7 +799,8 @@ kgsl_ringbuffer_issueibcmds(struct kgsl_device_private *dev_priv,
 
 	KGSL_CMD_VDBG("return %d\n", 0);
 
-	kfree(link);
+	if (link != stack_link)
+		kfree(link);
 
 	return 0;
 }
@@ -16,6 +16,7 @@
  *
  */
 #include <linux/io.h>
+#include <linux/mm.h>
 #include <linux/spinlock.h>
 #include <linux/genalloc.h>
 #include <linux/dma-mapping.h>
@@ -87,27 +88,170 @@ void kgsl_cache_range_op(unsigned long addr, int size,
 
 }
 
+/*
+ * Size-binned cache of recently freed vmalloc buffers.  Games that
+ * allocate and free scratch buffers every frame otherwise go to the
+ * page allocator and invalidate the dcache range on every allocation;
+ * cached buffers were invalidated when they went into the cache and
+ * nothing touches them afterwards, so a hit skips both.
+ */
+#define KGSL_MEMCACHE_BINS	8
+#define KGSL_MEMCACHE_MAX	(8 * 1024 * 1024)
+
+struct kgsl_memcache_entry {
+	struct list_head list;
+	void *hostptr;
+	unsigned int size;
+};
+
+static struct {
+	spinlock_t lock;
+	struct list_head bins[KGSL_MEMCACHE_BINS];
+	unsigned int bytes;
+	struct shrinker shrinker;
+} kgsl_memcache = {
+	.lock = __SPIN_LOCK_UNLOCKED(kgsl_memcache.lock),
+};
+
+/* sizes are multiples of 8K; 16K and below land in bin 0 */
+static int kgsl_memcache_bin(unsigned int size)
+{
+	return min(fls(size >> 14), KGSL_MEMCACHE_BINS - 1);
+}
+
+static void *kgsl_memcache_get(unsigned int size)
+{
+	struct kgsl_memcache_entry *entry;
+	void *hostptr = NULL;
+
+	spin_lock(&kgsl_memcache.lock);
+	list_for_each_entry(entry, &kgsl_memcache.bins[kgsl_memcache_bin(size)],
+			    list) {
+		if (entry->size == size) {
+			list_del(&entry->list);
+			kgsl_memcache.bytes -= size;
+			hostptr = entry->hostptr;
+			break;
+		}
+	}
+	spin_unlock(&kgsl_memcache.lock);
+
+	if (hostptr)
+		kfree(entry);
+
+	return hostptr;
+}
+
+static void kgsl_memcache_put(void *hostptr, unsigned int size)
+{
+	struct kgsl_memcache_entry *entry = NULL;
+
+	if (kgsl_memcache.bytes + size <= KGSL_MEMCACHE_MAX)
+		entry = kmalloc(sizeof(*entry), GFP_KERNEL);
+
+	if (entry == NULL) {
+		vfree(hostptr);
+		return;
+	}
+
+	/*
+	 * Invalidate now, while the contents are dead, so reuse does not
+	 * need any dcache maintenance at all.
+	 */
+	kgsl_cache_range_op((unsigned long) hostptr, size,
+			    KGSL_MEMFLAGS_CACHE_INV |
+			    KGSL_MEMFLAGS_VMALLOC_MEM);
+
+	entry->hostptr = hostptr;
+	entry->size = size;
+
+	spin_lock(&kgsl_memcache.lock);
+	list_add(&entry->list, &kgsl_memcache.bins[kgsl_memcache_bin(size)]);
+	kgsl_memcache.bytes += size;
+	spin_unlock(&kgsl_memcache.lock);
+}
+
+static int kgsl_memcache_shrink(struct shrinker *s, int nr_to_scan,
+				gfp_t gfp_mask)
+{
+	struct kgsl_memcache_entry *entry;
+	int bin;
+
+	while (nr_to_scan > 0) {
+		entry = NULL;
+
+		spin_lock(&kgsl_memcache.lock);
+		for (bin = KGSL_MEMCACHE_BINS - 1; bin >= 0; bin--) {
+			if (!list_empty(&kgsl_memcache.bins[bin])) {
+				entry = list_first_entry(
+						&kgsl_memcache.bins[bin],
+						struct kgsl_memcache_entry,
+						list);
+				list_del(&entry->list);
+				kgsl_memcache.bytes -= entry->size;
+				break;
+			}
+		}
+		spin_unlock(&kgsl_memcache.lock);
+
+		if (entry == NULL)
+			break;
+
+		nr_to_scan -= entry->size >> PAGE_SHIFT;
+		vfree(entry->hostptr);
+		kfree(entry);
+	}
+
+	return kgsl_memcache.bytes >> PAGE_SHIFT;
+}
+
+void kgsl_sharedmem_init(void)
+{
+	int bin;
+
+	for (bin = 0; bin < KGSL_MEMCACHE_BINS; bin++)
+		INIT_LIST_HEAD(&kgsl_memcache.bins[bin]);
+
+	kgsl_memcache.shrinker.shrink = kgsl_memcache_shrink;
+	kgsl_memcache.shrinker.seeks = DEFAULT_SEEKS;
+	register_shrinker(&kgsl_memcache.shrinker);
+}
+
+void kgsl_sharedmem_uninit(void)
+{
+	unregister_shrinker(&kgsl_memcache.shrinker);
+	kgsl_memcache_shrink(&kgsl_memcache.shrinker, INT_MAX, GFP_KERNEL);
+}
+
 int
 kgsl_sharedmem_vmalloc(struct kgsl_memdesc *memdesc,
 		       struct kgsl_pagetable *pagetable, size_t size)
 {
+	void *hostptr;
+	int from_cache = 1;
 	int result;
 
 	size = ALIGN(size, KGSL_PAGESIZE * 2);
 
-	memdesc->hostptr = vmalloc(size);
-	if (memdesc->hostptr == NULL) {
-		KGSL_MEM_ERR("vmalloc failed: %x\n", size);
-		return -ENOMEM;
+	hostptr = kgsl_memcache_get(size);
+	if (hostptr == NULL) {
+		from_cache = 0;
+		hostptr = vmalloc(size);
+		if (hostptr == NULL) {
+			KGSL_MEM_ERR("vmalloc failed: %x\n", size);
+			return -ENOMEM;
+		}
 	}
 
+	memdesc->hostptr = hostptr;
 	memdesc->size = size;
 	memdesc->pagetable = pagetable;
 	memdesc->priv = KGSL_MEMFLAGS_VMALLOC_MEM | KGSL_MEMFLAGS_CACHE_CLEAN;
 
-	kgsl_cache_range_op((unsigned int) memdesc->hostptr,
-			    size, KGSL_MEMFLAGS_CACHE_INV |
-			    KGSL_MEMFLAGS_VMALLOC_MEM);
+	if (!from_cache)
+		kgsl_cache_range_op((unsigned int) memdesc->hostptr,
+				    size, KGSL_MEMFLAGS_CACHE_INV |
+				    KGSL_MEMFLAGS_VMALLOC_MEM);
 
 	result = kgsl_mmu_map(pagetable, (unsigned long) memdesc->hostptr,
 			      memdesc->size,
@@ -117,7 +261,7 @@ kgsl_sharedmem_vmalloc(struct kgsl_memdesc *memdesc,
 			      KGSL_MEMFLAGS_VMALLOC_MEM);
 
 	if (result) {
-		vfree(memdesc->hostptr);
+		kgsl_memcache_put(hostptr, size);
 		memset(memdesc, 0, sizeof(*memdesc));
 	}
 
@@ -140,7 +284,8 @@ kgsl_sharedmem_free(struct kgsl_memdesc *memdesc)
 					       memdesc->size);
 
 			if (memdesc->hostptr)
-				vfree(memdesc->hostptr);
+				kgsl_memcache_put(memdesc->hostptr,
+						  memdesc->size);
 		} else if (memdesc->priv & KGSL_MEMFLAGS_CONPHYS)
 			dma_free_coherent(NULL, memdesc->size,
 					  memdesc->hostptr,
@@ -78,6 +78,9 @@ struct kgsl_memdesc {
 	unsigned int priv;
 };
 
+void kgsl_sharedmem_init(void);
+void kgsl_sharedmem_uninit(void);
+
 int kgsl_sharedmem_vmalloc(struct kgsl_memdesc *memdesc,
 			   struct kgsl_pagetable *pagetable, size_t size);
 
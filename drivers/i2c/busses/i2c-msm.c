@@ -92,6 +92,12 @@ struct msm_i2c_dev {
 	int                          clk_state;
 	void                         *complete;
 
+	/* async transfer queue, drained in order by async_wq */
+	struct workqueue_struct      *async_wq;
+	struct work_struct           async_work;
+	struct list_head             async_queue;
+	spinlock_t                   async_lock;
+
 	struct pm_qos_request_list *pm_qos_req;
 };
 
@@ -557,6 +563,86 @@ static const struct i2c_algorithm msm_i2c_algo = {
 	.functionality	= msm_i2c_func,
 };
 
+struct msm_i2c_async_req {
+	struct list_head           node;
+	struct i2c_adapter         *adap;
+	struct i2c_msg             *msgs;
+	int                        num;
+	void                       (*complete)(void *context, int result);
+	void                       *context;
+};
+
+static void
+msm_i2c_async_work(struct work_struct *work)
+{
+	struct msm_i2c_dev *dev = container_of(work, struct msm_i2c_dev,
+					       async_work);
+	struct msm_i2c_async_req *req;
+	unsigned long flags;
+	int ret;
+
+	spin_lock_irqsave(&dev->async_lock, flags);
+	while (!list_empty(&dev->async_queue)) {
+		req = list_first_entry(&dev->async_queue,
+				       struct msm_i2c_async_req, node);
+		list_del(&req->node);
+		spin_unlock_irqrestore(&dev->async_lock, flags);
+
+		ret = i2c_transfer(req->adap, req->msgs, req->num);
+		if (req->complete)
+			req->complete(req->context, ret);
+		kfree(req);
+
+		spin_lock_irqsave(&dev->async_lock, flags);
+	}
+	spin_unlock_irqrestore(&dev->async_lock, flags);
+}
+
+/**
+ * msm_i2c_xfer_async - submit an i2c transaction without waiting for it
+ * @adap: one of the MSM adapters (primary or auxiliary)
+ * @msgs: messages to transfer, as for i2c_transfer()
+ * @num: number of messages
+ * @complete: called with the i2c_transfer() return value when done
+ * @context: passed through to @complete
+ *
+ * May be called from atomic context.  Transactions run on the
+ * controller's queue in submission order; @complete is invoked from
+ * process context and should be short, since it delays the rest of the
+ * queue.  @msgs and the buffers they reference must stay valid until
+ * @complete runs.
+ */
+int
+msm_i2c_xfer_async(struct i2c_adapter *adap, struct i2c_msg *msgs, int num,
+		   void (*complete)(void *context, int result), void *context)
+{
+	struct msm_i2c_dev *dev;
+	struct msm_i2c_async_req *req;
+	unsigned long flags;
+
+	if (!adap || adap->algo != &msm_i2c_algo)
+		return -EINVAL;
+	dev = i2c_get_adapdata(adap);
+
+	req = kmalloc(sizeof(*req), GFP_ATOMIC);
+	if (!req)
+		return -ENOMEM;
+
+	req->adap = adap;
+	req->msgs = msgs;
+	req->num = num;
+	req->complete = complete;
+	req->context = context;
+
+	spin_lock_irqsave(&dev->async_lock, flags);
+	list_add_tail(&req->node, &dev->async_queue);
+	spin_unlock_irqrestore(&dev->async_lock, flags);
+	queue_work(dev->async_wq, &dev->async_work);
+
+	return 0;
+}
+EXPORT_SYMBOL(msm_i2c_xfer_async);
+
 static int
 msm_i2c_probe(struct platform_device *pdev)
 {
@@ -694,6 +780,16 @@ msm_i2c_probe(struct platform_device *pdev)
 		goto err_pm_qos_add_request_failed;
 	}
 
+	spin_lock_init(&dev->async_lock);
+	INIT_LIST_HEAD(&dev->async_queue);
+	INIT_WORK(&dev->async_work, msm_i2c_async_work);
+	dev->async_wq = create_singlethread_workqueue("msm_i2c_async");
+	if (!dev->async_wq) {
+		dev_err(&pdev->dev, "create async workqueue failed\n");
+		ret = -ENOMEM;
+		goto err_async_wq_failed;
+	}
+
 	disable_irq(dev->irq);
 	dev->suspended = 0;
 	mutex_init(&dev->mlock);
@@ -706,8 +802,10 @@ msm_i2c_probe(struct platform_device *pdev)
 
 	return 0;
 
+err_async_wq_failed:
+	pm_qos_remove_request(dev->pm_qos_req);
 err_pm_qos_add_request_failed:
-	free_irq(dev->irq, dev); 
+	free_irq(dev->irq, dev);
 err_request_irq_failed:
 	i2c_del_adapter(&dev->adap_pri);
 	i2c_del_adapter(&dev->adap_aux);
@@ -729,6 +827,8 @@ msm_i2c_remove(struct platform_device *pdev)
 	struct msm_i2c_dev	*dev = platform_get_drvdata(pdev);
 	struct resource		*mem;
 
+	/* Drain the async queue before tearing anything down */
+	destroy_workqueue(dev->async_wq);
 	/* Grab mutex to ensure ongoing transaction is over */
 	mutex_lock(&dev->mlock);
 	dev->suspended = 1;
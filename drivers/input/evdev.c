@@ -10,7 +10,7 @@
 
 #define EVDEV_MINOR_BASE	64
 #define EVDEV_MINORS		32
-#define EVDEV_BUFFER_SIZE	64
+#define EVDEV_BUFFER_SIZE	256
 
 #include <linux/poll.h>
 #include <linux/sched.h>
@@ -40,6 +40,7 @@ struct evdev_client {
 	struct input_event buffer[EVDEV_BUFFER_SIZE];
 	int head;
 	int tail;
+	int packet_head; /* head of the last complete packet (EV_SYN) */
 	spinlock_t buffer_lock; /* protects access to buffer, head and tail */
 	struct fasync_struct *fasync;
 	struct evdev *evdev;
@@ -61,6 +62,21 @@ static void evdev_pass_event(struct evdev_client *client,
 	wake_lock_timeout(&client->wake_lock, 5 * HZ);
 	client->buffer[client->head++] = *event;
 	client->head &= EVDEV_BUFFER_SIZE - 1;
+
+	if (unlikely(client->head == client->tail)) {
+		/*
+		 * The ring overran before the reader caught up: drop the
+		 * oldest event and make everything buffered visible, even
+		 * if the last packet is incomplete, so the reader is not
+		 * stalled waiting for an EV_SYN that already fell out.
+		 */
+		client->tail = (client->tail + 1) & (EVDEV_BUFFER_SIZE - 1);
+		client->packet_head = client->head;
+		wake_up_interruptible(&client->evdev->wait);
+	}
+
+	if (event->type == EV_SYN)
+		client->packet_head = client->head;
 	spin_unlock(&client->buffer_lock);
 
 	if (event->type == EV_SYN)
@@ -96,7 +112,14 @@ static void evdev_event(struct input_handle *handle,
 
 	rcu_read_unlock();
 
-	wake_up_interruptible(&evdev->wait);
+	/*
+	 * Wake readers once per complete packet rather than per event:
+	 * touch firmware reporting many axes at 100Hz+ otherwise costs a
+	 * scheduler round-trip for every event in the frame.  Readers
+	 * only see events up to packet_head, so reads are frame-aligned.
+	 */
+	if (type == EV_SYN)
+		wake_up_interruptible(&evdev->wait);
 }
 
 static int evdev_fasync(int fd, struct file *file, int on)
@@ -343,7 +366,7 @@ static int evdev_fetch_next_event(struct evdev_client *client,
 
 	spin_lock_irq(&client->buffer_lock);
 
-	have_event = client->head != client->tail;
+	have_event = client->packet_head != client->tail;
 	if (have_event) {
 		*event = client->buffer[client->tail++];
 		client->tail &= EVDEV_BUFFER_SIZE - 1;
@@ -367,12 +390,12 @@ static ssize_t evdev_read(struct file *file, char __user *buffer,
 	if (count < input_event_size())
 		return -EINVAL;
 
-	if (client->head == client->tail && evdev->exist &&
+	if (client->packet_head == client->tail && evdev->exist &&
 	    (file->f_flags & O_NONBLOCK))
 		return -EAGAIN;
 
 	retval = wait_event_interruptible(evdev->wait,
-		client->head != client->tail || !evdev->exist);
+		client->packet_head != client->tail || !evdev->exist);
 	if (retval)
 		return retval;
 
@@ -398,7 +421,7 @@ static unsigned int evdev_poll(struct file *file, poll_table *wait)
 	struct evdev *evdev = client->evdev;
 
 	poll_wait(file, &evdev->wait, wait);
-	return ((client->head == client->tail) ? 0 : (POLLIN | POLLRDNORM)) |
+	return ((client->packet_head == client->tail) ? 0 : (POLLIN | POLLRDNORM)) |
 		(evdev->exist ? 0 : (POLLHUP | POLLERR));
 }
 
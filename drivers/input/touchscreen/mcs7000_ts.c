@@ -107,12 +107,9 @@ module_param_named(debug_mask, mcs7000_debug_mask, int,
 #define MCS7000_TS_MAX_HW_VERSION				0x40
 #define MCS7000_TS_MAX_FW_VERSION				0x20
 
-static struct workqueue_struct *mcs7000_wq;
-
 struct mcs7000_ts_data {
 	struct i2c_client *client;
 	struct input_dev *input_dev;
-	struct work_struct work;
 	struct wake_lock wakelock;
 	int num_irq;
 	int intr_gpio;
@@ -296,7 +293,7 @@ static __inline void mcs7000_single_ts_event_release(struct mcs7000_ts_data *ts)
 }
 #endif /* end of LG_FW_MULTI_TOUCH */
 
-static void mcs7000_ts_work_func(struct work_struct *work)
+static void mcs7000_ts_report(struct mcs7000_ts_data *ts)
 {
 	int x1 = 0, y1 = 0;
 #ifdef LG_FW_MULTI_TOUCH
@@ -312,29 +309,31 @@ static void mcs7000_ts_work_func(struct work_struct *work)
 	//static int key_pressed = 0;
 	static int touch_pressed = 0;
 
-	struct mcs7000_ts_data *ts = container_of(work, struct mcs7000_ts_data, work);
-
 	if (MCS7000_DM_TRACE_FUNC & mcs7000_debug_mask)
 		DMSG("\n");
 
 	ts->pendown = !gpio_get_value(ts->intr_gpio);
 
-/* read the registers of MCS7000 IC */
+/* read the full finger-state block of the MCS7000 IC in one write+read
+ * transaction (repeated start, no stop in between) */
 	{
-	int tmp1,tmp2 ;
-	read_buf[0]= MCS7000_TS_INPUT_INFO;
-	tmp1 =i2c_master_send(ts->client,read_buf ,1);
-	tmp2 =i2c_master_recv(ts->client,read_buf ,READ_NUM);
-	printk ("test msg  temp1 =[%d], temp2([%d],\n",tmp1,tmp2);
-	}
-
-/* MCS600 IC used function  */  
-#if 0
-	if (i2c_smbus_read_i2c_block_data(ts->client, MCS6000_TS_INPUT_INFO, READ_NUM, read_buf) < 0) {
+	struct i2c_msg msg[2];
+	unsigned char start_reg = MCS7000_TS_INPUT_INFO;
+
+	msg[0].addr = ts->client->addr;
+	msg[0].flags = 0;
+	msg[0].len = 1;
+	msg[0].buf = &start_reg;
+	msg[1].addr = ts->client->addr;
+	msg[1].flags = I2C_M_RD;
+	msg[1].len = READ_NUM;
+	msg[1].buf = read_buf;
+
+	if (i2c_transfer(ts->client->adapter, msg, 2) < 0) {
 		printk(KERN_ERR "%s touch ic read error\n", __FUNCTION__);
-		goto touch_retry;
+		return;
+	}
 	}
-#endif
 
 	input_type = read_buf[0] & 0x0f;
 	/* touch key function disable by younchan.kim,2010-09-24 */
@@ -428,27 +427,31 @@ static void mcs7000_ts_work_func(struct work_struct *work)
 		}
 	}
 
-touch_retry:
-	if (ts->pendown)
-		queue_work(mcs7000_wq, &ts->work);
-	else {
-		enable_irq(ts->num_irq);
-		ts->irq_sync++;
-	}
 }
 
 static irqreturn_t mcs7000_ts_irq_handler(int irq, void *dev_id)
 {
 	struct mcs7000_ts_data *ts = dev_id;
 
-	if (gpio_get_value(ts->intr_gpio) == 0) {
-		disable_irq_nosync(ts->client->irq);
-		ts->irq_sync--;
-		queue_work(mcs7000_wq, &ts->work);
-	}
-	else  {
+	if (gpio_get_value(ts->intr_gpio) != 0) {
 		printk(KERN_INFO "mcs7000_ts_irq_handler: check int gpio level\n");
+		return IRQ_HANDLED;
 	}
+	return IRQ_WAKE_THREAD;
+}
+
+/* Threaded handler: the burst read sleeps on the i2c transfer, so the
+ * report runs in the irq thread.  The panel keeps INT low while a
+ * finger is down, so keep reporting until pen-up; IRQF_ONESHOT keeps
+ * the line masked until we return. */
+static irqreturn_t mcs7000_ts_irq_thread(int irq, void *dev_id)
+{
+	struct mcs7000_ts_data *ts = dev_id;
+
+	do {
+		mcs7000_ts_report(ts);
+	} while (ts->pendown);
+
 	return IRQ_HANDLED;
 }
 
@@ -989,7 +992,6 @@ static int mcs7000_ts_probe(struct i2c_client *client, const struct i2c_device_i
 		goto err_alloc_data_failed;
 	}	
 
-	INIT_WORK(&ts->work, mcs7000_ts_work_func);
 	ts->client = client;
 	i2c_set_clientdata(client, ts);
 	pdata = client->dev.platform_data;
@@ -1119,7 +1121,10 @@ static int mcs7000_ts_probe(struct i2c_client *client, const struct i2c_device_i
 			goto err_gpio_direction_input_failed;
 		}
 
-		ret = request_irq(client->irq, mcs7000_ts_irq_handler, IRQF_TRIGGER_FALLING, "mcs7000_ts", ts);
+		ret = request_threaded_irq(client->irq, mcs7000_ts_irq_handler,
+				mcs7000_ts_irq_thread,
+				IRQF_TRIGGER_FALLING | IRQF_ONESHOT,
+				"mcs7000_ts", ts);
 		if (ret == 0) {
 		//	ret = i2c_smbus_write_byte_data(ts->client, 0x1d, 0x01); /* enable int */
 			if (ret)
@@ -1212,11 +1217,6 @@ static int mcs7000_ts_suspend(struct i2c_client *client, pm_message_t mesg)
 		ts->irq_sync--;
 	}
 
-	ret = cancel_work_sync(&ts->work);
-	if (ret) {
-		enable_irq(client->irq);
-		ts->irq_sync++;
-	}
 //	ret = i2c_smbus_write_byte_data(ts->client, 0x1d, 0x00); /* disable int */
 //	if (ret < 0)
 //		printk(KERN_ERR "mcs7000_ts_suspend: i2c write failed\n");
@@ -1317,18 +1317,12 @@ static struct i2c_driver mcs7000_ts_driver = {
 
 static int __devinit mcs7000_ts_init(void)
 {
-	mcs7000_wq = create_singlethread_workqueue("mcs7000_wq");
-	if (!mcs7000_wq)
-		return -ENOMEM;
-
 	return i2c_add_driver(&mcs7000_ts_driver);
 }
 
 static void __exit mcs7000_ts_exit(void)
 {
 	i2c_del_driver(&mcs7000_ts_driver);
-	if (mcs7000_wq)
-		destroy_workqueue(mcs7000_wq);
 }
 
 module_init(mcs7000_ts_init);
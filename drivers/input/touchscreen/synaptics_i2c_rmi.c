@@ -83,7 +83,7 @@ err_page_select_failed:
 	return ret;
 }
 
-static void synaptics_ts_work_func(struct work_struct *work)
+static void synaptics_ts_report(struct synaptics_ts_data *ts)
 {
 	int i;
 	int ret;
@@ -91,7 +91,6 @@ static void synaptics_ts_work_func(struct work_struct *work)
 	struct i2c_msg msg[2];
 	uint8_t start_reg;
 	uint8_t buf[15];
-	struct synaptics_ts_data *ts = container_of(work, struct synaptics_ts_data, work);
 	int buf_len = ts->has_relative_report ? 15 : 13;
 
 	msg[0].addr = ts->client->addr;
@@ -230,8 +229,13 @@ static void synaptics_ts_work_func(struct work_struct *work)
 			}
 		}
 	}
-	if (ts->use_irq)
-		enable_irq(ts->client->irq);
+}
+
+static void synaptics_ts_work_func(struct work_struct *work)
+{
+	struct synaptics_ts_data *ts = container_of(work, struct synaptics_ts_data, work);
+
+	synaptics_ts_report(ts);
 }
 
 static enum hrtimer_restart synaptics_ts_timer_func(struct hrtimer *timer)
@@ -245,13 +249,14 @@ static enum hrtimer_restart synaptics_ts_timer_func(struct hrtimer *timer)
 	return HRTIMER_NORESTART;
 }
 
-static irqreturn_t synaptics_ts_irq_handler(int irq, void *dev_id)
+/* Threaded handler: the burst read sleeps on the i2c transfer, so the
+ * report runs in the irq thread instead of bouncing through a
+ * workqueue; the irq line stays masked (IRQF_ONESHOT) until it returns. */
+static irqreturn_t synaptics_ts_irq_thread(int irq, void *dev_id)
 {
 	struct synaptics_ts_data *ts = dev_id;
 
-	/* printk("synaptics_ts_irq_handler\n"); */
-	disable_irq_nosync(ts->client->irq);
-	queue_work(synaptics_wq, &ts->work);
+	synaptics_ts_report(ts);
 	return IRQ_HANDLED;
 }
 
@@ -516,7 +521,9 @@ static int synaptics_ts_probe(
 		goto err_input_register_device_failed;
 	}
 	if (client->irq) {
-		ret = request_irq(client->irq, synaptics_ts_irq_handler, irqflags, client->name, ts);
+		ret = request_threaded_irq(client->irq, NULL,
+				synaptics_ts_irq_thread,
+				irqflags | IRQF_ONESHOT, client->name, ts);
 		if (ret == 0) {
 			ret = i2c_smbus_write_byte_data(ts->client, 0xf1, 0x01); /* enable abs int */
 			if (ret)
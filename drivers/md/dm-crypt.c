@@ -41,6 +41,7 @@ struct convert_context {
 	unsigned int idx_out;
 	sector_t sector;
 	atomic_t pending;
+	struct ablkcipher_request *req;
 };
 
 /*
@@ -133,7 +134,6 @@ struct crypt_config {
 	 * correctly aligned.
 	 */
 	unsigned int dmreq_start;
-	struct ablkcipher_request *req;
 
 	char cipher[CRYPTO_MAX_ALG_NAME];
 	char chainmode[CRYPTO_MAX_ALG_NAME];
@@ -388,6 +388,7 @@ static void crypt_convert_init(struct crypt_config *cc,
 	ctx->idx_in = bio_in ? bio_in->bi_idx : 0;
 	ctx->idx_out = bio_out ? bio_out->bi_idx : 0;
 	ctx->sector = sector + cc->iv_offset;
+	ctx->req = NULL;
 	init_completion(&ctx->restart);
 }
 
@@ -460,13 +461,22 @@ static void kcryptd_async_done(struct crypto_async_request *async_req,
 static void crypt_alloc_req(struct crypt_config *cc,
 			    struct convert_context *ctx)
 {
-	if (!cc->req)
-		cc->req = mempool_alloc(cc->req_pool, GFP_NOIO);
-	ablkcipher_request_set_tfm(cc->req, cc->tfm);
-	ablkcipher_request_set_callback(cc->req, CRYPTO_TFM_REQ_MAY_BACKLOG |
+	if (!ctx->req)
+		ctx->req = mempool_alloc(cc->req_pool, GFP_NOIO);
+	ablkcipher_request_set_tfm(ctx->req, cc->tfm);
+	ablkcipher_request_set_callback(ctx->req, CRYPTO_TFM_REQ_MAY_BACKLOG |
 					CRYPTO_TFM_REQ_MAY_SLEEP,
 					kcryptd_async_done,
-					dmreq_of_req(cc, cc->req));
+					dmreq_of_req(cc, ctx->req));
+}
+
+static void crypt_free_req(struct crypt_config *cc,
+			   struct convert_context *ctx)
+{
+	if (ctx->req) {
+		mempool_free(ctx->req, cc->req_pool);
+		ctx->req = NULL;
+	}
 }
 
 /*
@@ -486,7 +496,7 @@ static int crypt_convert(struct crypt_config *cc,
 
 		atomic_inc(&ctx->pending);
 
-		r = crypt_convert_block(cc, ctx, cc->req);
+		r = crypt_convert_block(cc, ctx, ctx->req);
 
 		switch (r) {
 		/* async */
@@ -495,7 +505,8 @@ static int crypt_convert(struct crypt_config *cc,
 			INIT_COMPLETION(ctx->restart);
 			/* fall through*/
 		case -EINPROGRESS:
-			cc->req = NULL;
+			/* the request is now owned by kcryptd_async_done */
+			ctx->req = NULL;
 			ctx->sector++;
 			continue;
 
@@ -509,10 +520,12 @@ static int crypt_convert(struct crypt_config *cc,
 		/* error */
 		default:
 			atomic_dec(&ctx->pending);
+			crypt_free_req(cc, ctx);
 			return r;
 		}
 	}
 
+	crypt_free_req(cc, ctx);
 	return 0;
 }
 
@@ -1134,7 +1147,6 @@ static int crypt_ctr(struct dm_target *ti, unsigned int argc, char **argv)
 		ti->error = "Cannot allocate crypt request mempool";
 		goto bad_req_pool;
 	}
-	cc->req = NULL;
 
 	cc->page_pool = mempool_create_page_pool(MIN_POOL_PAGES, 0);
 	if (!cc->page_pool) {
@@ -1183,7 +1195,13 @@ static int crypt_ctr(struct dm_target *ti, unsigned int argc, char **argv)
 		goto bad_io_queue;
 	}
 
-	cc->crypt_queue = create_singlethread_workqueue("kcryptd");
+	/*
+	 * One crypt worker per CPU: the ciphers are stateless outside of
+	 * setkey, and each in-flight request now lives in its own
+	 * convert_context, so conversions can run concurrently.  IO
+	 * submission stays on its own single thread above.
+	 */
+	cc->crypt_queue = create_workqueue("kcryptd");
 	if (!cc->crypt_queue) {
 		ti->error = "Couldn't create kcryptd queue";
 		goto bad_crypt_queue;
@@ -1225,9 +1243,6 @@ static void crypt_dtr(struct dm_target *ti)
 	destroy_workqueue(cc->io_queue);
 	destroy_workqueue(cc->crypt_queue);
 
-	if (cc->req)
-		mempool_free(cc->req, cc->req_pool);
-
 	bioset_free(cc->bs);
 	mempool_destroy(cc->page_pool);
 	mempool_destroy(cc->req_pool);
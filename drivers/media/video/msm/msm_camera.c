@@ -671,6 +671,7 @@ static int __msm_get_frame(struct msm_sync *sync,
 	}
 
 	frame->ts = qcmd->ts;
+	ktime_get_ts(&frame->ts_wake);
 	frame->buffer = (unsigned long)pmem_info.vaddr;
 	frame->y_off = pmem_info.y_off;
 	frame->cbcr_off = pmem_info.cbcr_off;
@@ -747,6 +748,59 @@ static int msm_get_frame(struct msm_sync *sync, void __user *arg)
 	return rc;
 }
 
+/*
+ * Drain every ready preview frame in one ioctl.  A busy preview
+ * pipeline otherwise pays one GETFRAME round trip and one wakeup per
+ * frame.  Crop and face-detect ROI data are not copied on this path;
+ * callers that need them keep using MSM_CAM_IOCTL_GETFRAME.
+ */
+static int msm_get_frame_batch(struct msm_sync *sync, void __user *arg)
+{
+	struct msm_frame_batch batch;
+	struct msm_frame frame;
+	uint32_t i;
+	int rc;
+
+	if (copy_from_user(&batch, arg, sizeof(batch))) {
+		ERR_COPY_FROM_USER();
+		return -EFAULT;
+	}
+
+	if (!batch.max || !batch.frames)
+		return -EINVAL;
+
+	for (i = 0; i < batch.max; i++) {
+		if (i && !sync->frame_q.len)
+			break;
+
+		memset(&frame, 0, sizeof(frame));
+		rc = __msm_get_frame(sync, &frame);
+		if (rc < 0) {
+			if (i)
+				break;
+			return rc;
+		}
+
+		/* read the frame after the status has been read */
+		rmb();
+
+		if (copy_to_user((void *)&batch.frames[i],
+				&frame, sizeof(struct msm_frame))) {
+			ERR_COPY_TO_USER();
+			return -EFAULT;
+		}
+	}
+
+	batch.count = i;
+	if (copy_to_user(arg, &batch, sizeof(batch))) {
+		ERR_COPY_TO_USER();
+		return -EFAULT;
+	}
+
+	CDBG("%s: got %d frames\n", __func__, batch.count);
+	return 0;
+}
+
 static int msm_enable_vfe(struct msm_sync *sync, void __user *arg)
 {
 	int rc = -EIO;
@@ -2346,6 +2400,9 @@ static long msm_ioctl_frame(struct file *filep, unsigned int cmd,
 		 * after SELECT is done */
 		rc = msm_get_frame(pmsm->sync, argp);
 		break;
+	case MSM_CAM_IOCTL_GETFRAME_BATCH:
+		rc = msm_get_frame_batch(pmsm->sync, argp);
+		break;
 	case MSM_CAM_IOCTL_RELEASE_FRAME_BUFFER:
 		rc = msm_put_frame_buffer(pmsm->sync, argp);
 		break;
@@ -40,6 +40,11 @@
 
 extern void ram_console_enable_console(int);
 
+#ifdef CONFIG_ANDROID_FLIGHT_RECORDER
+/* drivers/staging/android/flight_recorder.c */
+extern size_t flight_recorder_get_dump(const void **buf);
+#endif
+
 struct panic_header {
 	u32 magic;
 #define PANIC_MAGIC 0xdeadf00d
@@ -52,6 +57,11 @@ struct panic_header {
 
 	u32 threads_offset;
 	u32 threads_length;
+
+	/* zero in images written by older kernels, which is also how
+	 * "no flight recorder data" is encoded */
+	u32 flight_offset;
+	u32 flight_length;
 };
 
 struct apanic_data {
@@ -60,6 +70,7 @@ struct apanic_data {
 	void			*bounce;
 	struct proc_dir_entry	*apanic_console;
 	struct proc_dir_entry	*apanic_threads;
+	struct proc_dir_entry	*apanic_flight;
 };
 
 static struct apanic_data drv_ctx;
@@ -163,6 +174,10 @@ static int apanic_proc_read(char *buffer, char **start, off_t offset,
 		file_length = ctx->curr.threads_length;
 		file_offset = ctx->curr.threads_offset;
 		break;
+	case 3:	/* apanic_flight */
+		file_length = ctx->curr.flight_length;
+		file_offset = ctx->curr.flight_offset;
+		break;
 	default:
 		pr_err("Bad dat (%d)\n", (int) dat);
 		mutex_unlock(&drv_mutex);
@@ -281,6 +296,10 @@ static void apanic_remove_proc_work(struct work_struct *work)
 		remove_proc_entry("apanic_threads", NULL);
 		ctx->apanic_threads = NULL;
 	}
+	if (ctx->apanic_flight) {
+		remove_proc_entry("apanic_flight", NULL);
+		ctx->apanic_flight = NULL;
+	}
 	mutex_unlock(&drv_mutex);
 }
 
@@ -344,9 +363,10 @@ static void mtd_panic_notify_add(struct mtd_info *mtd)
 
 	memcpy(&ctx->curr, hdr, sizeof(struct panic_header));
 
-	printk(KERN_INFO "apanic: c(%u, %u) t(%u, %u)\n",
+	printk(KERN_INFO "apanic: c(%u, %u) t(%u, %u) f(%u, %u)\n",
 	       hdr->console_offset, hdr->console_length,
-	       hdr->threads_offset, hdr->threads_length);
+	       hdr->threads_offset, hdr->threads_length,
+	       hdr->flight_offset, hdr->flight_length);
 
 	if (hdr->console_length) {
 		ctx->apanic_console = create_proc_entry("apanic_console",
@@ -378,6 +398,21 @@ static void mtd_panic_notify_add(struct mtd_info *mtd)
 		}
 	}
 
+	if (hdr->flight_length) {
+		ctx->apanic_flight = create_proc_entry("apanic_flight",
+						       S_IFREG | S_IRUGO, NULL);
+		if (!ctx->apanic_flight)
+			printk(KERN_ERR "%s: failed creating procfile\n",
+			       __func__);
+		else {
+			ctx->apanic_flight->read_proc = apanic_proc_read;
+			ctx->apanic_flight->write_proc = apanic_proc_write;
+			ctx->apanic_flight->size = hdr->flight_length;
+			ctx->apanic_flight->data = (void *) 3;
+			proc_entry_created = 1;
+		}
+	}
+
 	if (!proc_entry_created)
 		mtd_panic_erase();
 
@@ -484,6 +519,43 @@ static int apanic_write_console(struct mtd_info *mtd, unsigned int off)
 	return idx;
 }
 
+#ifdef CONFIG_ANDROID_FLIGHT_RECORDER
+/*
+ * Writes the flight recorder snapshot (already compressed and framed
+ * by the recorder) to the specified offset in flash.
+ * Returns number of bytes written
+ */
+static int apanic_write_flight(struct mtd_info *mtd, unsigned int off)
+{
+	struct apanic_data *ctx = &drv_ctx;
+	const uint8_t *dump;
+	size_t len;
+	size_t idx = 0;
+	int rc;
+
+	len = flight_recorder_get_dump((const void **)&dump);
+	while (idx < len) {
+		size_t chunk = len - idx;
+
+		if (chunk > mtd->writesize)
+			chunk = mtd->writesize;
+		memcpy(ctx->bounce, dump + idx, chunk);
+		if (chunk != mtd->writesize)
+			memset(ctx->bounce + chunk, 0,
+			       mtd->writesize - chunk);
+		rc = apanic_writeflashpage(mtd, off, ctx->bounce);
+		if (rc <= 0) {
+			printk(KERN_EMERG
+			       "apanic: Flash write failed (%d)\n", rc);
+			return idx;
+		}
+		idx += chunk;
+		off += rc;
+	}
+	return idx;
+}
+#endif
+
 static int apanic(struct notifier_block *this, unsigned long event,
 			void *ptr)
 {
@@ -493,6 +565,8 @@ static int apanic(struct notifier_block *this, unsigned long event,
 	int console_len = 0;
 	int threads_offset = 0;
 	int threads_len = 0;
+	int flight_offset = 0;
+	int flight_len = 0;
 	int rc;
 
 	if (in_panic)
@@ -542,6 +616,18 @@ static int apanic(struct notifier_block *this, unsigned long event,
 		threads_len = 0;
 	}
 
+#ifdef CONFIG_ANDROID_FLIGHT_RECORDER
+	/*
+	 * Write out the flight recorder ring
+	 */
+	flight_offset = ALIGN(threads_offset + threads_len,
+			      ctx->mtd->writesize);
+	if (!flight_offset)
+		flight_offset = ctx->mtd->writesize;
+
+	flight_len = apanic_write_flight(ctx->mtd, flight_offset);
+#endif
+
 	/*
 	 * Finally write the panic header
 	 */
@@ -555,6 +641,9 @@ static int apanic(struct notifier_block *this, unsigned long event,
 	hdr->threads_offset = threads_offset;
 	hdr->threads_length = threads_len;
 
+	hdr->flight_offset = flight_offset;
+	hdr->flight_length = flight_len;
+
 	rc = apanic_writeflashpage(ctx->mtd, 0, ctx->bounce);
 	if (rc <= 0) {
 		printk(KERN_EMERG "apanic: Header write failed (%d)\n",
@@ -0,0 +1,140 @@
+/* drivers/misc/bootkv.c
+ *
+ * Early-boot key-value store backed by an MTD partition.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * Init and early services read dozens of small config values before
+ * the writable filesystems are mounted, serializing early boot on
+ * mount ordering.  This driver reads a small checksummed blob of
+ * "key=value" lines from a dedicated NAND partition as soon as the
+ * partition appears and exposes it read-only at /proc/bootkv, so
+ * early userspace can get its configuration without waiting for any
+ * filesystem.
+ *
+ * Partition layout:
+ *	struct bootkv_header	magic, version, payload length, CRC32
+ *	payload			"key=value\n" lines
+ *
+ * The blob is written from userspace (recovery/provisioning) with the
+ * usual MTD tools; the kernel never writes it.  A bad magic, length
+ * or CRC simply means /proc/bootkv is not created and userspace falls
+ * back to its config files.
+ */
+
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/init.h>
+#include <linux/slab.h>
+#include <linux/crc32.h>
+#include <linux/mtd/mtd.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+
+#define BOOTKV_MAGIC	0x31564b42	/* "BKV1" */
+#define BOOTKV_VERSION	1
+#define BOOTKV_MAX_SIZE	(64 * 1024)
+
+static char mtddev[64] = "bootkv";
+module_param_string(mtddev, mtddev, sizeof(mtddev), 0400);
+MODULE_PARM_DESC(mtddev, "name of the MTD partition holding the store");
+
+struct bootkv_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t len;
+	uint32_t crc;
+};
+
+static char *bootkv_data;
+static size_t bootkv_len;
+
+static int bootkv_proc_show(struct seq_file *m, void *v)
+{
+	seq_write(m, bootkv_data, bootkv_len);
+	return 0;
+}
+
+static int bootkv_proc_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, bootkv_proc_show, NULL);
+}
+
+static const struct file_operations bootkv_proc_fops = {
+	.owner		= THIS_MODULE,
+	.open		= bootkv_proc_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+static void bootkv_mtd_add(struct mtd_info *mtd)
+{
+	struct bootkv_header hdr;
+	size_t retlen;
+	char *buf;
+	int ret;
+
+	if (bootkv_data || strcmp(mtd->name, mtddev))
+		return;
+
+	ret = mtd->read(mtd, 0, sizeof(hdr), &retlen, (u_char *)&hdr);
+	if ((ret && ret != -EUCLEAN) || retlen != sizeof(hdr)) {
+		printk(KERN_ERR "bootkv: header read failed (%d)\n", ret);
+		return;
+	}
+
+	if (hdr.magic != BOOTKV_MAGIC || hdr.version != BOOTKV_VERSION ||
+	    hdr.len == 0 || hdr.len > BOOTKV_MAX_SIZE ||
+	    sizeof(hdr) + hdr.len > mtd->size) {
+		printk(KERN_INFO "bootkv: no valid store on %s\n", mtd->name);
+		return;
+	}
+
+	buf = kmalloc(hdr.len, GFP_KERNEL);
+	if (!buf)
+		return;
+
+	ret = mtd->read(mtd, sizeof(hdr), hdr.len, &retlen, (u_char *)buf);
+	if ((ret && ret != -EUCLEAN) || retlen != hdr.len) {
+		printk(KERN_ERR "bootkv: payload read failed (%d)\n", ret);
+		goto free;
+	}
+
+	if (crc32_le(~0, (unsigned char *)buf, hdr.len) != hdr.crc) {
+		printk(KERN_ERR "bootkv: bad checksum, ignoring store\n");
+		goto free;
+	}
+
+	bootkv_data = buf;
+	bootkv_len = hdr.len;
+	proc_create("bootkv", S_IRUGO, NULL, &bootkv_proc_fops);
+	printk(KERN_INFO "bootkv: %u bytes from %s\n", hdr.len, mtd->name);
+	return;
+
+free:
+	kfree(buf);
+}
+
+static void bootkv_mtd_remove(struct mtd_info *mtd)
+{
+	/* the store was copied out of flash; nothing to drop */
+}
+
+static struct mtd_notifier bootkv_notifier = {
+	.add	= bootkv_mtd_add,
+	.remove	= bootkv_mtd_remove,
+};
+
+static int __init bootkv_init(void)
+{
+	register_mtd_user(&bootkv_notifier);
+	return 0;
+}
+
+module_init(bootkv_init);
+
+MODULE_DESCRIPTION("Early-boot key-value store backed by MTD");
+MODULE_LICENSE("GPL");
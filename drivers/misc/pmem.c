@@ -21,6 +21,7 @@
 #include <linux/mm.h>
 #include <linux/list.h>
 #include <linux/debugfs.h>
+#include <linux/seq_file.h>
 #include <linux/android_pmem.h>
 #include <linux/mempolicy.h>
 #include <linux/kobject.h>
@@ -91,6 +92,12 @@ struct pmem_data {
 	int master_fd;
 	/* file struct of the master */
 	struct file *master_file;
+	/* number of live userspace mappings of this allocation */
+	int map_count;
+	/* set when no CPU-visible dirty cache lines can exist since the
+	 * last full flush; lets the back-to-back hand-off flushes of the
+	 * camera -> kgsl -> mdp pipeline skip the multi-MB dcache walk */
+	int cache_clean;
 	/* a list of currently available regions if this is a suballocation */
 	struct list_head region_list;
 	/* a linked list of data so we can access them for debugging */
@@ -149,6 +156,18 @@ struct alloc_list {
 	struct list_head allocs;
 };
 
+/* a kernel API buffer whose owner has volunteered it for relocation
+ * during defragmentation of a bitmap-allocated region; lives on
+ * pmem_info.movable_list, protected by that region's arena_mutex */
+struct pmem_movable {
+	struct list_head list;
+	int bit;                 /* current first quantum of the buffer */
+	unsigned short quanta;   /* length in quanta */
+	unsigned short spacing;  /* required alignment in quanta */
+	int (*relocate)(void *data, unsigned long new_paddr);
+	void *data;
+};
+
 struct pmem_info {
 	struct miscdevice dev;
 	/* physical start address of the remaped pmem space */
@@ -235,6 +254,14 @@ struct pmem_info {
 	 */
 	struct mutex arena_mutex;
 
+	/* kernel API buffers registered for relocation, and defrag/
+	 * fragmentation counters; all protected by arena_mutex except the
+	 * counters, which debugfs reads without it (approximate is fine) */
+	struct list_head movable_list;
+	unsigned int alloc_fails;
+	unsigned int defrag_passes;
+	unsigned int defrag_quanta;
+
 	long (*ioctl)(struct file *, unsigned int, unsigned long);
 	int (*release)(struct inode *, struct file *);
 };
@@ -744,12 +771,21 @@ static int pmem_free_bitmap(int id, int bitnum)
 		if (curr_bit == bitnum) {
 			const int curr_quanta =
 				pmem[id].allocator.bitmap.bitm_alloc[i].quanta;
+			struct pmem_movable *m;
 
 			bitmap_bits_clear_all(pmem[id].allocator.bitmap.bitmap,
 				curr_bit, curr_bit + curr_quanta);
 			pmem[id].allocator.bitmap.bitmap_free += curr_quanta;
 			pmem[id].allocator.bitmap.bitm_alloc[i].bit = -1;
 			pmem[id].allocator.bitmap.bitm_alloc[i].quanta = 0;
+
+			/* drop any relocation registration for this buffer */
+			list_for_each_entry(m, &pmem[id].movable_list, list)
+				if (m->bit == bitnum) {
+					list_del(&m->list);
+					kfree(m);
+					break;
+				}
 			return 0;
 		}
 	}
@@ -933,6 +969,8 @@ static int pmem_open(struct inode *inode, struct file *file)
 	data->vma = NULL;
 	data->pid = 0;
 	data->master_file = NULL;
+	data->map_count = 0;
+	data->cache_clean = 0;
 #if PMEM_DEBUG
 	data->ref = 0;
 #endif
@@ -1175,6 +1213,94 @@ static int reserve_quanta(const unsigned int quanta_needed,
 	return ret;
 }
 
+static void ioremap_pmem(int id);
+
+/*
+ * Compact a bitmap-managed region by sliding registered movable buffers
+ * towards the bottom of the arena, coalescing the holes they leave with
+ * the free space above.  For each buffer we reserve a lower run first,
+ * copy the contents through the kernel mapping, then tell the owner via
+ * its relocate callback; only after the callback accepts the new address
+ * are the old quanta released, so a veto or a failed reservation leaves
+ * the buffer untouched.  The callback runs under arena_mutex and must
+ * switch the owner's mappings before returning.
+ *
+ * Returns the number of quanta moved.  Caller should hold the lock on
+ * arena_mutex!
+ */
+static int pmem_defrag_bitmap(int id)
+{
+	struct pmem_movable *m;
+	int total_bits = (pmem[id].size + pmem[id].quantum - 1) /
+				pmem[id].quantum;
+	int moved = 0;
+
+	if (list_empty(&pmem[id].movable_list))
+		return 0;
+
+	if (!pmem[id].vbase)
+		ioremap_pmem(id);
+	if (!pmem[id].vbase) {
+#if PMEM_DEBUG
+		pr_alert("pmem: %s: no kernel mapping for id %d, "
+			"cannot relocate buffers\n", __func__, id);
+#endif
+		return 0;
+	}
+
+	pmem[id].defrag_passes++;
+
+	list_for_each_entry(m, &pmem[id].movable_list, list) {
+		int new_bit, i;
+		unsigned long old_off, new_off;
+
+		/* bitmap_allocate_contiguous scans up from bit 0, so a
+		 * successful reservation below the current position is
+		 * the lowest aligned hole the buffer fits in */
+		new_bit = bitmap_allocate_contiguous(
+				pmem[id].allocator.bitmap.bitmap,
+				m->quanta, total_bits, m->spacing);
+		if (new_bit < 0)
+			continue;
+		if (new_bit >= m->bit) {
+			bitmap_bits_clear_all(
+				pmem[id].allocator.bitmap.bitmap,
+				new_bit, new_bit + m->quanta);
+			continue;
+		}
+
+		old_off = (unsigned long)m->bit * pmem[id].quantum;
+		new_off = (unsigned long)new_bit * pmem[id].quantum;
+		memcpy(pmem[id].vbase + new_off, pmem[id].vbase + old_off,
+			(unsigned long)m->quanta * pmem[id].quantum);
+
+		if (m->relocate(m->data, pmem[id].base + new_off)) {
+			/* owner vetoed the move; old copy is untouched */
+			bitmap_bits_clear_all(
+				pmem[id].allocator.bitmap.bitmap,
+				new_bit, new_bit + m->quanta);
+			continue;
+		}
+
+		for (i = 0; i < pmem[id].allocator.bitmap.bitmap_allocs; i++)
+			if (pmem[id].allocator.bitmap.bitm_alloc[i].bit ==
+					m->bit) {
+				pmem[id].allocator.bitmap.bitm_alloc[i].bit =
+					new_bit;
+				break;
+			}
+		bitmap_bits_clear_all(pmem[id].allocator.bitmap.bitmap,
+			m->bit, m->bit + m->quanta);
+		DLOG("id %d moved %u quanta from bit %d to %d\n",
+			id, m->quanta, m->bit, new_bit);
+		m->bit = new_bit;
+		moved += m->quanta;
+	}
+
+	pmem[id].defrag_quanta += moved;
+	return moved;
+}
+
 static int pmem_allocator_bitmap(const int id,
 		const unsigned long len,
 		const unsigned int align)
@@ -1203,12 +1329,17 @@ static int pmem_allocator_bitmap(const int id,
 			"PMEM memory region exhausted, id %d."
 			" Unable to comply with allocation request.\n", id);
 #endif
+		pmem[id].alloc_fails++;
 		return -1;
 	}
 
 	bitnum = reserve_quanta(quanta_needed, id, align);
-	if (bitnum == -1)
+	if (bitnum == -1 && pmem_defrag_bitmap(id) > 0)
+		bitnum = reserve_quanta(quanta_needed, id, align);
+	if (bitnum == -1) {
+		pmem[id].alloc_fails++;
 		goto leave;
+	}
 
 	for (i = 0;
 		i < pmem[id].allocator.bitmap.bitmap_allocs &&
@@ -1503,11 +1634,12 @@ static void pmem_vma_open(struct vm_area_struct *vma)
 		current->parent->pid, file, file_count(file));
 	/* this should never be called as we don't support copying pmem
 	 * ranges via fork */
-	down_read(&data->sem);
+	down_write(&data->sem);
 	BUG_ON(!has_allocation(file));
+	data->map_count++;
 	/* remap the garbage pages, forkers don't get access to the data */
 	pmem_unmap_pfn_range(id, vma, data, 0, vma->vm_start - vma->vm_end);
-	up_read(&data->sem);
+	up_write(&data->sem);
 }
 
 static void pmem_vma_close(struct vm_area_struct *vma)
@@ -1538,6 +1670,8 @@ static void pmem_vma_close(struct vm_area_struct *vma)
 		       "exist!\n");
 		return;
 	}
+	if (data->map_count > 0)
+		data->map_count--;
 	if (data->vma == vma) {
 		data->vma = NULL;
 		if ((data->flags & PMEM_FLAGS_CONNECTED) &&
@@ -1662,6 +1796,9 @@ static int pmem_mmap(struct file *file, struct vm_area_struct *vma)
 		data->flags |= PMEM_FLAGS_MASTERMAP;
 		data->pid = current->pid;
 	}
+	/* a live mapping means the CPU can dirty the cache at any time */
+	data->map_count++;
+	data->cache_clean = 0;
 	vma->vm_ops = &vm_ops;
 error:
 	up_write(&data->sem);
@@ -1849,6 +1986,16 @@ void flush_pmem_file(struct file *file, unsigned long offset, unsigned long len)
 	if (!has_allocation(file))
 		goto end;
 
+	/* Hand-off flushes arrive back to back: the camera flushes when
+	 * queueing a frame, then kgsl and mdp each flush again on import.
+	 * When nothing can have dirtied the cache since the last full
+	 * flush, skip the walk.  The flag is only ever set while no
+	 * userspace mapping exists (the write-held sem in mmap excludes
+	 * us here), so a mapped buffer always takes the full flush.
+	 */
+	if (data->cache_clean)
+		goto end;
+
 	vaddr = pmem_start_vaddr(id, data);
 
 	if (pmem[id].allocator_type == PMEM_ALLOCATORTYPE_SYSTEM) {
@@ -1863,6 +2010,8 @@ void flush_pmem_file(struct file *file, unsigned long offset, unsigned long len)
 
 		outer_flush_range(phy_start, phy_end);
 #endif
+		if (data->map_count == 0)
+			data->cache_clean = 1;
 		goto end;
 	}
 	/* if this isn't a submmapped file, flush the whole thing */
@@ -1876,6 +2025,8 @@ void flush_pmem_file(struct file *file, unsigned long offset, unsigned long len)
 
 		outer_flush_range(phy_start, phy_end);
 #endif
+		if (data->map_count == 0)
+			data->cache_clean = 1;
 		goto end;
 	}
 	/* otherwise, flush the region of the file we are drawing */
@@ -2092,6 +2243,77 @@ int pmem_kfree(const int32_t physaddr)
 }
 EXPORT_SYMBOL(pmem_kfree);
 
+/*
+ * Register a buffer returned by pmem_kalloc() as movable: when its
+ * region fragments badly the allocator may copy the buffer to a lower
+ * address and invoke the callback with the new physical address.  The
+ * callback runs with the region's arena_mutex held and must repoint the
+ * owner's mappings before returning 0; returning nonzero vetoes the
+ * move and the buffer stays where it is.  Only regions using the bitmap
+ * allocator relocate buffers.  The registration is dropped
+ * automatically when the buffer is freed.
+ */
+int pmem_set_movable(const int32_t physaddr, const unsigned int align,
+	int (*relocate)(void *data, unsigned long new_paddr), void *data)
+{
+	int i, id = -1, bit;
+	struct pmem_movable *m;
+
+	if (!relocate)
+		return -EINVAL;
+
+	for (i = 0; i < ARRAY_SIZE(kapi_memtypes); i++) {
+		const int c = kapi_memtypes[i].info_id;
+
+		if (c >= 0 && pmem[c].allocate &&
+				physaddr >= pmem[c].base &&
+				physaddr < pmem[c].base + pmem[c].size) {
+			id = c;
+			break;
+		}
+	}
+	if (id < 0 ||
+			pmem[id].allocator_type != PMEM_ALLOCATORTYPE_BITMAP) {
+#if PMEM_DEBUG
+		pr_alert("pmem: %s: physaddr %#x is not from a bitmap "
+			"kernel region\n", __func__, physaddr);
+#endif
+		return -EINVAL;
+	}
+
+	m = kmalloc(sizeof(struct pmem_movable), GFP_KERNEL);
+	if (!m)
+		return -ENOMEM;
+
+	bit = bit_from_paddr(id, physaddr);
+
+	mutex_lock(&pmem[id].arena_mutex);
+	for (i = 0; i < pmem[id].allocator.bitmap.bitmap_allocs; i++)
+		if (pmem[id].allocator.bitmap.bitm_alloc[i].bit == bit)
+			break;
+	if (i >= pmem[id].allocator.bitmap.bitmap_allocs) {
+		mutex_unlock(&pmem[id].arena_mutex);
+		kfree(m);
+#if PMEM_DEBUG
+		pr_alert("pmem: %s: physaddr %#x is not an allocation "
+			"start address\n", __func__, physaddr);
+#endif
+		return -EINVAL;
+	}
+
+	m->bit = bit;
+	m->quanta = pmem[id].allocator.bitmap.bitm_alloc[i].quanta;
+	m->spacing = align > pmem[id].quantum ?
+			align / pmem[id].quantum : 1;
+	m->relocate = relocate;
+	m->data = data;
+	list_add_tail(&m->list, &pmem[id].movable_list);
+	mutex_unlock(&pmem[id].arena_mutex);
+
+	return 0;
+}
+EXPORT_SYMBOL(pmem_set_movable);
+
 static int pmem_connect(unsigned long connect, struct file *file)
 {
 	int ret = 0, put_needed;
@@ -2351,6 +2573,9 @@ int pmem_remap(struct pmem_region *region, struct file *file,
 		}
 	}
 
+	/* region changes can expose the buffer to new CPU writes */
+	data->cache_clean = 0;
+
 	if (data->vma && PMEM_IS_SUBMAP(data)) {
 		if (operation == PMEM_MAP)
 			ret = pmem_remap_pfn_range(id, data->vma, data,
@@ -2793,6 +3018,77 @@ static int pmem_memory_callback(struct notifier_block *self,
 }
 #endif
 
+static struct dentry *pmem_debugfs_root;
+
+#define PMEM_FRAG_MAX_ORDER 16
+
+static int pmem_stats_show(struct seq_file *s, void *unused)
+{
+	const int id = (int)(long)s->private;
+	unsigned int runs[PMEM_FRAG_MAX_ORDER];
+	int total_bits, bit, run = 0, largest = 0, movable = 0;
+	struct pmem_movable *m;
+
+	seq_printf(s, "size: %lu\n", pmem[id].size);
+	seq_printf(s, "quantum: %u\n", pmem[id].quantum);
+	seq_printf(s, "alloc_fails: %u\n", pmem[id].alloc_fails);
+	seq_printf(s, "defrag_passes: %u\n", pmem[id].defrag_passes);
+	seq_printf(s, "defrag_quanta: %u\n", pmem[id].defrag_quanta);
+
+	if (pmem[id].allocator_type != PMEM_ALLOCATORTYPE_BITMAP)
+		return 0;
+
+	memset(runs, 0, sizeof(runs));
+	total_bits = (pmem[id].size + pmem[id].quantum - 1) /
+			pmem[id].quantum;
+
+	mutex_lock(&pmem[id].arena_mutex);
+	for (bit = 0; bit <= total_bits; bit++) {
+		if (bit < total_bits &&
+			!(pmem[id].allocator.bitmap.bitmap
+				[bit >> PMEM_32BIT_WORD_ORDER] &
+				(1 << (bit & 31)))) {
+			run++;
+			continue;
+		}
+		if (run) {
+			int order = fls(run) - 1;
+
+			if (order >= PMEM_FRAG_MAX_ORDER)
+				order = PMEM_FRAG_MAX_ORDER - 1;
+			runs[order]++;
+			if (run > largest)
+				largest = run;
+			run = 0;
+		}
+	}
+	list_for_each_entry(m, &pmem[id].movable_list, list)
+		movable++;
+	mutex_unlock(&pmem[id].arena_mutex);
+
+	seq_printf(s, "free_quanta: %u\n",
+		pmem[id].allocator.bitmap.bitmap_free);
+	seq_printf(s, "largest_free_run: %d\n", largest);
+	seq_printf(s, "movable_buffers: %d\n", movable);
+	seq_printf(s, "free runs by order (>= 2^n quanta):\n");
+	for (bit = 0; bit < PMEM_FRAG_MAX_ORDER; bit++)
+		if (runs[bit])
+			seq_printf(s, "  %d: %u\n", bit, runs[bit]);
+	return 0;
+}
+
+static int pmem_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, pmem_stats_show, inode->i_private);
+}
+
+static const struct file_operations pmem_stats_fops = {
+	.open = pmem_stats_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 int pmem_setup(struct android_pmem_platform_data *pdata,
 	       long (*ioctl)(struct file *, unsigned int, unsigned long),
 	       int (*release)(struct inode *, struct file *))
@@ -3031,6 +3327,7 @@ int pmem_setup(struct android_pmem_platform_data *pdata,
 	mutex_init(&pmem[id].arena_mutex);
 	mutex_init(&pmem[id].data_list_mutex);
 	INIT_LIST_HEAD(&pmem[id].data_list);
+	INIT_LIST_HEAD(&pmem[id].movable_list);
 
 	pmem[id].dev.name = pdata->name;
 	if (!is_kernel_memtype) {
@@ -3048,6 +3345,12 @@ int pmem_setup(struct android_pmem_platform_data *pdata,
 		pr_info("pmem: Initializing %s (in-kernel)\n", pdata->name);
 	}
 
+	if (!pmem_debugfs_root)
+		pmem_debugfs_root = debugfs_create_dir("pmem", NULL);
+	if (pmem_debugfs_root && !IS_ERR(pmem_debugfs_root))
+		debugfs_create_file(pdata->name, S_IRUGO, pmem_debugfs_root,
+			(void *)(long)id, &pmem_stats_fops);
+
 	/* do not set up unstable pmem now, wait until first memory hotplug */
 	if (pmem[id].memory_state == MEMORY_UNSTABLE_NO_MEMORY_ALLOCATED)
 		return 0;
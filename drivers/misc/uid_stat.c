@@ -20,6 +20,7 @@
 #include <linux/kernel.h>
 #include <linux/list.h>
 #include <linux/proc_fs.h>
+#include <linux/seq_file.h>
 #include <linux/slab.h>
 #include <linux/spinlock.h>
 #include <linux/stat.h>
@@ -173,6 +174,52 @@ int uid_stat_udp_rcv(uid_t uid, int size) {
 	return 0;
 }
 
+static unsigned int counter_val(atomic_t *counter)
+{
+	return (unsigned int) (atomic_read(counter) + INT_MIN);
+}
+
+/* Dump every uid on one line each, so user space can sample all apps
+ * with a single read instead of walking the per-uid entries. */
+static int uid_stat_all_show(struct seq_file *m, void *v)
+{
+	struct uid_stat *entry;
+	unsigned long flags;
+
+	seq_printf(m, "uid tcp_snd tcp_rcv tcp_snd_pkt tcp_rcv_pkt "
+		      "udp_snd udp_rcv udp_snd_pkt udp_rcv_pkt\n");
+
+	/* entries are never removed from uid_list; seq_printf does not
+	 * sleep, so holding the lock across the walk is fine */
+	spin_lock_irqsave(&uid_lock, flags);
+	list_for_each_entry(entry, &uid_list, link) {
+		seq_printf(m, "%u %u %u %u %u %u %u %u %u\n",
+			entry->uid,
+			counter_val(&entry->tcp_snd),
+			counter_val(&entry->tcp_rcv),
+			counter_val(&entry->tcp_snd_pkt),
+			counter_val(&entry->tcp_rcv_pkt),
+			counter_val(&entry->udp_snd),
+			counter_val(&entry->udp_rcv),
+			counter_val(&entry->udp_snd_pkt),
+			counter_val(&entry->udp_rcv_pkt));
+	}
+	spin_unlock_irqrestore(&uid_lock, flags);
+	return 0;
+}
+
+static int uid_stat_all_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, uid_stat_all_show, NULL);
+}
+
+static const struct file_operations uid_stat_all_fops = {
+	.open = uid_stat_all_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 static int __init uid_stat_init(void)
 {
 	parent = proc_mkdir("uid_stat", NULL);
@@ -180,6 +227,7 @@ static int __init uid_stat_init(void)
 		pr_err("uid_stat: failed to create proc entry\n");
 		return -1;
 	}
+	proc_create("all", S_IRUGO, parent, &uid_stat_all_fops);
 	return 0;
 }
 
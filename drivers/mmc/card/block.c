@@ -299,6 +299,19 @@ static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 		brq.stop.flags = MMC_RSP_SPI_R1B | MMC_RSP_R1B | MMC_CMD_AC;
 		brq.data.blocks = blk_rq_sectors(req);
 
+		/*
+		 * The queue thread may have fetched a run of contiguous
+		 * requests; issue the whole run as one transfer.  The
+		 * fetch path guarantees that it fits the host limits.
+		 */
+		if (mq->req_count > 1) {
+			int i;
+
+			brq.data.blocks = 0;
+			for (i = 0; i < mq->req_count; i++)
+				brq.data.blocks += blk_rq_sectors(mq->reqs[i]);
+		}
+
 		/*
 		 * The block layer doesn't support all sector count
 		 * restrictions, so we need to be prepared for too big
@@ -347,7 +360,8 @@ static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 		 * Adjust the sg list so it is the same size as the
 		 * request.
 		 */
-		if (brq.data.blocks != blk_rq_sectors(req)) {
+		if (mq->req_count == 1 &&
+		    brq.data.blocks != blk_rq_sectors(req)) {
 			int i, data_size = brq.data.blocks << 9;
 			struct scatterlist *sg;
 
@@ -364,10 +378,29 @@ static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 
 		mmc_queue_bounce_pre(mq);
 
+		/*
+		 * Let the host DMA-map the transfer here, where sleeping
+		 * and interrupts are still allowed.
+		 */
+		mmc_pre_req(card->host, &brq.mrq);
+
 		mmc_wait_for_req(card->host, &brq.mrq);
 
+		mmc_post_req(card->host, &brq.mrq, 0);
+
 		mmc_queue_bounce_post(mq);
 
+		/*
+		 * If a chained transfer failed, break the chain up and
+		 * redo the head request on its own, so the per-request
+		 * error handling below can take over.
+		 */
+		if (mq->req_count > 1 &&
+		    (brq.cmd.error || brq.data.error || brq.stop.error)) {
+			mmc_queue_unchain(mq);
+			continue;
+		}
+
 		/*
 		 * Check for errors here, but don't jump to cmd_err
 		 * until later as we need to wait for the card to leave
@@ -468,7 +501,15 @@ static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 		 * A block was successfully transferred.
 		 */
 		spin_lock_irq(&md->lock);
-		ret = __blk_end_request(req, 0, brq.data.bytes_xfered);
+		if (mq->req_count > 1) {
+			int i;
+
+			for (i = 0; i < mq->req_count; i++)
+				__blk_end_request(mq->reqs[i], 0,
+						  blk_rq_bytes(mq->reqs[i]));
+			ret = 0;
+		} else
+			ret = __blk_end_request(req, 0, brq.data.bytes_xfered);
 		spin_unlock_irq(&md->lock);
 	} while (ret);
 
@@ -477,6 +518,13 @@ static int mmc_blk_issue_rq(struct mmc_queue *mq, struct request *req)
 	return 1;
 
  cmd_err:
+	/*
+	 * Requeue any chained followers; only the head request gets
+	 * error handling here.
+	 */
+	if (mq->req_count > 1)
+		mmc_queue_unchain(mq);
+
  	/*
  	 * If this is an SD card and we're writing, we can first
  	 * mark the known good sectors as ok.
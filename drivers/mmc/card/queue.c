@@ -42,6 +42,66 @@ static int mmc_prep_request(struct request_queue *q, struct request *req)
 	return BLKPREP_OK;
 }
 
+/*
+ * Fetch the next request, plus up to MMC_QUEUE_MAX_CHAIN - 1 physically
+ * contiguous followers that still fit in a single transfer of the host,
+ * so that the whole run can be issued as one multi-block command.  Must
+ * be called with the queue lock held.
+ */
+static struct request *mmc_queue_fetch(struct mmc_queue *mq)
+{
+	struct request_queue *q = mq->queue;
+	struct mmc_host *host = mq->card->host;
+	struct request *req, *next;
+	unsigned int sectors, segs;
+
+	req = blk_fetch_request(q);
+	mq->reqs[0] = req;
+	mq->req_count = req != NULL;
+
+	if (req == NULL || mq->bounce_buf != NULL || !blk_fs_request(req))
+		return req;
+
+	sectors = blk_rq_sectors(req);
+	segs = req->nr_phys_segments;
+
+	while (mq->req_count < MMC_QUEUE_MAX_CHAIN) {
+		next = blk_peek_request_contig(q, mq->reqs[mq->req_count - 1]);
+		if (next == NULL)
+			break;
+		if (sectors + blk_rq_sectors(next) > host->max_blk_count ||
+		    (sectors + blk_rq_sectors(next)) * 512 >
+		     host->max_req_size ||
+		    segs + next->nr_phys_segments > host->max_phys_segs)
+			break;
+		blk_start_request(next);
+		mq->reqs[mq->req_count++] = next;
+		sectors += blk_rq_sectors(next);
+		segs += next->nr_phys_segments;
+	}
+
+	return req;
+}
+
+/*
+ * Put every request but the head of the chain back to the front of the
+ * block queue, so that a failed chained transfer can be redone (and its
+ * errors handled) one request at a time.
+ */
+void mmc_queue_unchain(struct mmc_queue *mq)
+{
+	struct request_queue *q = mq->queue;
+	unsigned long flags;
+	int i;
+
+	spin_lock_irqsave(q->queue_lock, flags);
+	for (i = mq->req_count - 1; i > 0; i--)
+		blk_requeue_request(q, mq->reqs[i]);
+	spin_unlock_irqrestore(q->queue_lock, flags);
+
+	mq->req_count = 1;
+}
+
 static int mmc_queue_thread(void *d)
 {
 	struct mmc_queue *mq = d;
@@ -64,7 +124,9 @@ static int mmc_queue_thread(void *d)
 		spin_lock_irq(q->queue_lock);
 		set_current_state(TASK_INTERRUPTIBLE);
 		if (!blk_queue_plugged(q))
-			req = blk_fetch_request(q);
+			req = mmc_queue_fetch(mq);
+		else
+			mq->req_count = 0;
 		mq->req = req;
 		spin_unlock_irq(q->queue_lock);
 
@@ -153,6 +215,7 @@ int mmc_init_queue(struct mmc_queue *mq, struct mmc_card *card, spinlock_t *lock
 
 	mq->queue->queuedata = mq;
 	mq->req = NULL;
+	mq->req_count = 0;
 
 	blk_queue_prep_rq(mq->queue, mmc_prep_request);
 	blk_queue_ordered(mq->queue, QUEUE_ORDERED_DRAIN, NULL);
@@ -321,6 +384,27 @@ void mmc_queue_resume(struct mmc_queue *mq)
 	}
 }
 
+/*
+ * Map a chain of contiguous requests into a single sg list.  Each
+ * sub-mapping terminates its part of the list, so the end mark of all
+ * but the last one has to be removed again; there is no inverse of
+ * sg_mark_end() in this kernel.
+ */
+static unsigned int mmc_queue_map_sg_chain(struct mmc_queue *mq)
+{
+	unsigned int sg_len = 0;
+	int i;
+
+	for (i = 0; i < mq->req_count; i++) {
+		if (sg_len > 0)
+			mq->sg[sg_len - 1].page_link &= ~0x02;
+		sg_len += blk_rq_map_sg(mq->queue, mq->reqs[i],
+					mq->sg + sg_len);
+	}
+
+	return sg_len;
+}
+
 /*
  * Prepare the sg list(s) to be handed of to the host driver
  */
@@ -331,8 +415,11 @@ unsigned int mmc_queue_map_sg(struct mmc_queue *mq)
 	struct scatterlist *sg;
 	int i;
 
-	if (!mq->bounce_buf)
+	if (!mq->bounce_buf) {
+		if (mq->req_count > 1)
+			return mmc_queue_map_sg_chain(mq);
 		return blk_rq_map_sg(mq->queue, mq->req, mq->sg);
+	}
 
 	BUG_ON(!mq->bounce_sg);
 
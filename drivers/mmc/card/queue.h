@@ -4,12 +4,20 @@
 struct request;
 struct task_struct;
 
+/*
+ * Max number of physically contiguous requests issued as a single
+ * multi-block transfer.
+ */
+#define MMC_QUEUE_MAX_CHAIN	4
+
 struct mmc_queue {
 	struct mmc_card		*card;
 	struct task_struct	*thread;
 	struct semaphore	thread_sem;
 	unsigned int		flags;
 	struct request		*req;
+	struct request		*reqs[MMC_QUEUE_MAX_CHAIN];
+	int			req_count;
 	int			(*issue_fn)(struct mmc_queue *, struct request *);
 	void			*data;
 	struct request_queue	*queue;
@@ -25,6 +33,7 @@ extern void mmc_queue_suspend(struct mmc_queue *);
 extern void mmc_queue_resume(struct mmc_queue *);
 
 extern unsigned int mmc_queue_map_sg(struct mmc_queue *);
+extern void mmc_queue_unchain(struct mmc_queue *);
 extern void mmc_queue_bounce_pre(struct mmc_queue *);
 extern void mmc_queue_bounce_post(struct mmc_queue *);
 
@@ -468,6 +468,46 @@ u8 sdio_writeb_readb(struct sdio_func *func, u8 write_byte,
 }
 EXPORT_SYMBOL_GPL(sdio_writeb_readb);
 
+/**
+ *	sdio_reg_batch - issue a batch of single byte register accesses
+ *	@func: SDIO function to access
+ *	@ops: array of register operations to perform, in order
+ *	@count: number of operations in @ops
+ *
+ *	Issues a sequence of CMD52 accesses back to back under one host
+ *	claim, so drivers that do several register reads and writes per
+ *	packet pay the host resume and claim cost once per burst rather
+ *	than once per register.  For read operations the value read is
+ *	stored back into the entry.  Processing stops at the first failed
+ *	access; its error code is returned and the remaining entries are
+ *	left untouched.  For a run of registers at consecutive addresses
+ *	sdio_memcpy_fromio() (a single CMD53) is cheaper still.
+ */
+int sdio_reg_batch(struct sdio_func *func, struct sdio_reg_op *ops,
+	unsigned count)
+{
+	unsigned i;
+	int ret;
+
+	BUG_ON(!func);
+
+	for (i = 0; i < count; i++) {
+		struct sdio_reg_op *op = &ops[i];
+
+		if (op->write)
+			ret = mmc_io_rw_direct(func->card, 1, func->num,
+				op->addr, op->value, NULL);
+		else
+			ret = mmc_io_rw_direct(func->card, 0, func->num,
+				op->addr, 0, &op->value);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+EXPORT_SYMBOL_GPL(sdio_reg_batch);
+
 /**
  *	sdio_memcpy_fromio - read a chunk of memory from a SDIO function
  *	@func: SDIO function to access
@@ -82,6 +82,18 @@ static int  msmsdcc_dbg_init(void);
 
 static unsigned int msmsdcc_pwrsave = 1;
 
+/*
+ * Reads up to this many bytes are done by PIO and polled for completion
+ * from the caller's context instead of waiting for the interrupt; the
+ * transfer finishes well inside the IRQ + context switch round trip.
+ * Set to 0 to always use DMA + interrupt completion.
+ */
+static unsigned int msmsdcc_piopoll_size = 1024;
+module_param_named(piopoll_size, msmsdcc_piopoll_size, uint, 0644);
+
+/* How long to poll before falling back to the interrupt path */
+#define MSMSDCC_POLL_TIMEOUT	msecs_to_jiffies(10)
+
 #define DUMMY_52_STATE_NONE		0
 #define DUMMY_52_STATE_SENT		1
 
@@ -317,8 +329,10 @@ msmsdcc_dma_complete_tlet(unsigned long data)
 		if (!mrq->data->error)
 			mrq->data->error = -EIO;
 	}
-	dma_unmap_sg(mmc_dev(host->mmc), host->dma.sg, host->dma.num_ents,
-		     host->dma.dir);
+	/* Requests mapped by msmsdcc_pre_req() are unmapped in post_req */
+	if (!mrq->data->host_cookie)
+		dma_unmap_sg(mmc_dev(host->mmc), host->dma.sg,
+			     host->dma.num_ents, host->dma.dir);
 
 	if (host->curr.user_pages) {
 		struct scatterlist *sg = host->dma.sg;
@@ -385,11 +399,32 @@ msmsdcc_dma_complete_func(struct msm_dmov_cmd *cmd,
 	tasklet_schedule(&host->dma_tlet);
 }
 
+/*
+ * Small reads are kept on the PIO path and polled for completion from
+ * msmsdcc_request(), which also saves the dmov setup and dma_map_sg()
+ * cache maintenance on their critical path.
+ */
+static inline int msmsdcc_piopoll_xfer(struct mmc_data *data)
+{
+	return msmsdcc_piopoll_size && (data->flags & MMC_DATA_READ) &&
+	       (data->blksz * data->blocks) <= msmsdcc_piopoll_size;
+}
+
 static int validate_dma(struct msmsdcc_host *host, struct mmc_data *data)
 {
 	if (host->dma.channel == -1)
 		return -ENOENT;
 
+	/*
+	 * piopoll_size is writable at runtime, so the piopoll decision
+	 * can differ between msmsdcc_pre_req() and here.  A request
+	 * already mapped by pre_req must stay on the DMA path: falling
+	 * back to PIO would leave post_req's dma_unmap_sg() to
+	 * invalidate the cache lines the PIO read just filled.
+	 */
+	if (!data->host_cookie && msmsdcc_piopoll_xfer(data))
+		return -EAGAIN;
+
 	if ((data->blksz * data->blocks) < MCI_FIFOSIZE)
 		return -EINVAL;
 	if ((data->blksz * data->blocks) % MCI_FIFOSIZE)
@@ -402,7 +437,6 @@ static int msmsdcc_config_dma(struct msmsdcc_host *host, struct mmc_data *data)
 	struct msmsdcc_nc_dmadata *nc;
 	dmov_box *box;
 	uint32_t rows;
-	uint32_t crci;
 	unsigned int n;
 	int i, rc;
 	struct scatterlist *sg = data->sg;
@@ -418,24 +452,6 @@ static int msmsdcc_config_dma(struct msmsdcc_host *host, struct mmc_data *data)
 
 	nc = host->dma.nc;
 
-	if (host->pdev_id == 1)
-		crci = DMOV_SDC1_CRCI;
-	else if (host->pdev_id == 2)
-		crci = DMOV_SDC2_CRCI;
-	else if (host->pdev_id == 3)
-		crci = DMOV_SDC3_CRCI;
-	else if (host->pdev_id == 4)
-		crci = DMOV_SDC4_CRCI;
-#ifdef DMOV_SDC5_CRCI
-	else if (host->pdev_id == 5)
-		crci = DMOV_SDC5_CRCI;
-#endif
-	else {
-		host->dma.sg = NULL;
-		host->dma.num_ents = 0;
-		return -ENOENT;
-	}
-
 	if (data->flags & MMC_DATA_READ)
 		host->dma.dir = DMA_FROM_DEVICE;
 	else
@@ -443,53 +459,46 @@ static int msmsdcc_config_dma(struct msmsdcc_host *host, struct mmc_data *data)
 
 	/* host->curr.user_pages = (data->flags & MMC_DATA_USERPAGE); */
 	host->curr.user_pages = 0;
+
+	/*
+	 * The command boxes are pre-built in msmsdcc_init_dma(); only the
+	 * per-transfer addresses, row counts and direction need to be
+	 * filled in here.
+	 */
 	box = &nc->cmd[0];
 	for (i = 0; i < host->dma.num_ents; i++) {
-		box->cmd = CMD_MODE_BOX;
-
 		/* Initialize sg dma address */
 		sg->dma_address = page_to_dma(mmc_dev(host->mmc), sg_page(sg))
 					+ sg->offset;
 
-		if (i == (host->dma.num_ents - 1))
-			box->cmd |= CMD_LC;
 		rows = (sg_dma_len(sg) % MCI_FIFOSIZE) ?
 			(sg_dma_len(sg) / MCI_FIFOSIZE) + 1 :
 			(sg_dma_len(sg) / MCI_FIFOSIZE) ;
 
+		box->num_rows = rows * ((1 << 16) + 1);
+
 		if (data->flags & MMC_DATA_READ) {
+			box->cmd = CMD_MODE_BOX |
+				   CMD_SRC_CRCI(host->dma.crci);
 			box->src_row_addr = msmsdcc_fifo_addr(host);
 			box->dst_row_addr = sg_dma_address(sg);
-
-			box->src_dst_len = (MCI_FIFOSIZE << 16) |
-					   (MCI_FIFOSIZE);
 			box->row_offset = MCI_FIFOSIZE;
-
-			box->num_rows = rows * ((1 << 16) + 1);
-			box->cmd |= CMD_SRC_CRCI(crci);
 		} else {
+			box->cmd = CMD_MODE_BOX |
+				   CMD_DST_CRCI(host->dma.crci);
 			box->src_row_addr = sg_dma_address(sg);
 			box->dst_row_addr = msmsdcc_fifo_addr(host);
-
-			box->src_dst_len = (MCI_FIFOSIZE << 16) |
-					   (MCI_FIFOSIZE);
 			box->row_offset = (MCI_FIFOSIZE << 16);
-
-			box->num_rows = rows * ((1 << 16) + 1);
-			box->cmd |= CMD_DST_CRCI(crci);
 		}
+		if (i == (host->dma.num_ents - 1))
+			box->cmd |= CMD_LC;
 		box++;
 		sg++;
 	}
 
-	/* location of command block must be 64 bit aligned */
-	BUG_ON(host->dma.cmd_busaddr & 0x07);
-
-	nc->cmdptr = (host->dma.cmd_busaddr >> 3) | CMD_PTR_LP;
-	host->dma.hdr.cmdptr = DMOV_CMD_PTR_LIST |
-			       DMOV_CMD_ADDR(host->dma.cmdptr_busaddr);
-	host->dma.hdr.complete_func = msmsdcc_dma_complete_func;
-	host->dma.hdr.crci_mask = msm_dmov_build_crci_mask(1, crci);
+	/* Already mapped by msmsdcc_pre_req()? */
+	if (data->host_cookie)
+		return 0;
 
 	n = dma_map_sg(mmc_dev(host->mmc), host->dma.sg,
 			host->dma.num_ents, host->dma.dir);
@@ -600,8 +609,6 @@ msmsdcc_start_data(struct msmsdcc_host *host, struct mmc_data *data,
 		host->cmd_datactrl = datactrl;
 		host->cmd_cmd = cmd;
 
-		host->dma.hdr.exec_func = msmsdcc_dma_exec_func;
-		host->dma.hdr.user = (void *)host;
 		host->dma.busy = 1;
 
 		if (cmd) {
@@ -1059,6 +1066,44 @@ msmsdcc_request_start(struct msmsdcc_host *host, struct mmc_request *mrq)
 	}
 }
 
+/*
+ * Map the data of a request that will go out by DMA before 'request' is
+ * called, in a context that may sleep and with interrupts enabled; the
+ * ARM cache maintenance in dma_map_sg() is too expensive to do inside
+ * the irqs-off section of msmsdcc_request().
+ */
+static void
+msmsdcc_pre_req(struct mmc_host *mmc, struct mmc_request *mrq)
+{
+	struct msmsdcc_host *host = mmc_priv(mmc);
+	struct mmc_data *data = mrq->data;
+
+	if (!data || validate_dma(host, data))
+		return;
+
+	if (dma_map_sg(mmc_dev(mmc), data->sg, data->sg_len,
+		       (data->flags & MMC_DATA_READ) ?
+		       DMA_FROM_DEVICE : DMA_TO_DEVICE) == data->sg_len)
+		data->host_cookie = 1;
+	else
+		dma_unmap_sg(mmc_dev(mmc), data->sg, data->sg_len,
+			     (data->flags & MMC_DATA_READ) ?
+			     DMA_FROM_DEVICE : DMA_TO_DEVICE);
+}
+
+static void
+msmsdcc_post_req(struct mmc_host *mmc, struct mmc_request *mrq, int err)
+{
+	struct mmc_data *data = mrq->data;
+
+	if (data && data->host_cookie) {
+		dma_unmap_sg(mmc_dev(mmc), data->sg, data->sg_len,
+			     (data->flags & MMC_DATA_READ) ?
+			     DMA_FROM_DEVICE : DMA_TO_DEVICE);
+		data->host_cookie = 0;
+	}
+}
+
 static void
 msmsdcc_request(struct mmc_host *mmc, struct mmc_request *mrq)
 {
@@ -1070,6 +1115,8 @@ msmsdcc_request(struct mmc_host *mmc, struct mmc_request *mrq)
         WARN_ON(host->pwr == 0);
 
 	spin_lock_irqsave(&host->lock, flags);
+	/* a pending deferred clock gate would race with this request */
+	del_timer(&host->busclk_timer);
 	/*
 	 * Enable clocks for SDIO clients if they are already turned off
 	 * as part of their low-power management.
@@ -1113,6 +1160,31 @@ msmsdcc_request(struct mmc_host *mmc, struct mmc_request *mrq)
 
 	msmsdcc_request_start(host, mrq);
 	spin_unlock_irqrestore(&host->lock, flags);
+
+	/*
+	 * A small PIO read finishes in a few microseconds, well under the
+	 * interrupt plus context switch round trip, so service it by
+	 * polling right here.  The handlers are status driven and run
+	 * under the host lock, and the interrupt stays armed, so if the
+	 * transfer overruns the poll window the IRQ path completes it as
+	 * usual.
+	 */
+	if (mrq->data && !mrq->data->host_cookie &&
+	    msmsdcc_piopoll_xfer(mrq->data)) {
+		unsigned long timeout = jiffies + MSMSDCC_POLL_TIMEOUT;
+		int done;
+
+		do {
+			local_irq_save(flags);
+			msmsdcc_pio_irq(0, host);
+			msmsdcc_irq(0, host);
+			done = host->curr.mrq != mrq;
+			local_irq_restore(flags);
+			if (done)
+				break;
+			cpu_relax();
+		} while (time_before(jiffies, timeout));
+	}
 }
 
 static inline int msmsdcc_is_pwrsave(struct msmsdcc_host *host)
@@ -1122,6 +1194,48 @@ static inline int msmsdcc_is_pwrsave(struct msmsdcc_host *host)
 	return 0;
 }
 
+/* timeout before a deferred SDIO bus clock gate actually takes effect */
+#define MSM_MMC_BUSCLK_TIMEOUT_MS	10
+
+/* gate the SDCC source clocks and arm SDIO wakeup; host->lock held */
+static void msmsdcc_gate_bus_clocks(struct msmsdcc_host *host)
+{
+	struct mmc_host *mmc = host->mmc;
+
+	if (mmc->card && mmc->card->type == MMC_TYPE_SDIO &&
+			!host->plat->sdiowakeup_irq) {
+		writel(MCI_SDIOINTMASK, host->base + MMCIMASK0);
+		WARN_ON(host->sdcc_irq_disabled);
+		if (host->plat->cfg_mpm_sdiowakeup &&
+				(mmc->pm_flags & MMC_PM_WAKE_SDIO_IRQ))
+			host->plat->cfg_mpm_sdiowakeup(
+					mmc_dev(mmc), 1);
+		enable_irq_wake(host->irqres->start);
+	}
+	clk_disable(host->clk);
+	if (!IS_ERR(host->pclk))
+		clk_disable(host->pclk);
+	if (!IS_ERR_OR_NULL(host->dfab_pclk))
+		clk_disable(host->dfab_pclk);
+	host->clks_on = 0;
+}
+
+static void
+msmsdcc_busclk_expired(unsigned long data)
+{
+	struct msmsdcc_host *host = (struct msmsdcc_host *)data;
+	unsigned long flags;
+
+	spin_lock_irqsave(&host->lock, flags);
+	if (host->clks_on && !host->curr.mrq) {
+		writel(readl(host->base + MMCICLOCK) & ~MCI_CLK_ENABLE,
+			host->base + MMCICLOCK);
+		udelay(50);
+		msmsdcc_gate_bus_clocks(host);
+	}
+	spin_unlock_irqrestore(&host->lock, flags);
+}
+
 static void
 msmsdcc_set_ios(struct mmc_host *mmc, struct mmc_ios *ios)
 {
@@ -1132,9 +1246,25 @@ msmsdcc_set_ios(struct mmc_host *mmc, struct mmc_ios *ios)
 
 	DBG(host, "ios->clock = %u\n", ios->clock);
 
+	/*
+	 * SDIO clients gate the bus clock between bursts of register
+	 * accesses, and an immediate gate means the next burst pays a
+	 * full clock reprogram plus stabilization delay up front.  Defer
+	 * the gate briefly instead, so back to back bursts reuse the
+	 * running clocks and only a bus that stays quiet is gated.
+	 */
+	if (!ios->clock && ios->power_mode == MMC_POWER_ON &&
+			mmc->card && mmc->card->type == MMC_TYPE_SDIO &&
+			host->clks_on && !host->sdcc_suspending) {
+		mod_timer(&host->busclk_timer, jiffies +
+			msecs_to_jiffies(MSM_MMC_BUSCLK_TIMEOUT_MS));
+		return;
+	}
+
 	if (ios->clock) {
 
 		spin_lock_irqsave(&host->lock, flags);
+		del_timer(&host->busclk_timer);
 		if (!host->clks_on) {
 			if (!IS_ERR_OR_NULL(host->dfab_pclk))
 				clk_enable(host->dfab_pclk);
@@ -1219,24 +1349,8 @@ msmsdcc_set_ios(struct mmc_host *mmc, struct mmc_ios *ios)
 	}
 
 	spin_lock_irqsave(&host->lock, flags);
-	if (!(clk & MCI_CLK_ENABLE) && host->clks_on) {
-		if (mmc->card && mmc->card->type == MMC_TYPE_SDIO &&
-				!host->plat->sdiowakeup_irq) {
-			writel(MCI_SDIOINTMASK, host->base + MMCIMASK0);
-			WARN_ON(host->sdcc_irq_disabled);
-			if (host->plat->cfg_mpm_sdiowakeup &&
-					(mmc->pm_flags & MMC_PM_WAKE_SDIO_IRQ))
-				host->plat->cfg_mpm_sdiowakeup(
-						mmc_dev(mmc), 1);
-			enable_irq_wake(host->irqres->start);
-		}
-		clk_disable(host->clk);
-		if (!IS_ERR(host->pclk))
-			clk_disable(host->pclk);
-		if (!IS_ERR_OR_NULL(host->dfab_pclk))
-			clk_disable(host->dfab_pclk);
-		host->clks_on = 0;
-	}
+	if (!(clk & MCI_CLK_ENABLE) && host->clks_on)
+		msmsdcc_gate_bus_clocks(host);
 	spin_unlock_irqrestore(&host->lock, flags);
 }
 
@@ -1366,6 +1480,8 @@ static int msmsdcc_disable(struct mmc_host *mmc, int lazy)
 static const struct mmc_host_ops msmsdcc_ops = {
 	.enable		= msmsdcc_enable,
 	.disable	= msmsdcc_disable,
+	.pre_req	= msmsdcc_pre_req,
+	.post_req	= msmsdcc_post_req,
 	.request	= msmsdcc_request,
 	.set_ios	= msmsdcc_set_ios,
 	.get_ro		= msmsdcc_get_ro,
@@ -1446,6 +1562,8 @@ msmsdcc_status_notify_cb(int card_present, void *dev_id)
 static int
 msmsdcc_init_dma(struct msmsdcc_host *host)
 {
+	int i;
+
 	memset(&host->dma, 0, sizeof(struct msmsdcc_dma_data));
 	host->dma.host = host;
 	host->dma.channel = -1;
@@ -1453,6 +1571,26 @@ msmsdcc_init_dma(struct msmsdcc_host *host)
 	if (!host->dmares)
 		return -ENODEV;
 
+	if (host->pdev_id == 1)
+		host->dma.crci = DMOV_SDC1_CRCI;
+	else if (host->pdev_id == 2)
+		host->dma.crci = DMOV_SDC2_CRCI;
+	else if (host->pdev_id == 3)
+		host->dma.crci = DMOV_SDC3_CRCI;
+	else if (host->pdev_id == 4)
+		host->dma.crci = DMOV_SDC4_CRCI;
+#ifdef DMOV_SDC5_CRCI
+	else if (host->pdev_id == 5)
+		host->dma.crci = DMOV_SDC5_CRCI;
+#endif
+	else {
+		/* No CRCI for this slot, leave the channel disabled so
+		 * that all requests fall back to PIO. */
+		pr_err("%s: no CRCI for slot %d, DMA disabled\n",
+		       mmc_hostname(host->mmc), host->pdev_id);
+		return 0;
+	}
+
 	host->dma.nc = dma_alloc_coherent(NULL,
 					  sizeof(struct msmsdcc_nc_dmadata),
 					  &host->dma.nc_busaddr,
@@ -1465,6 +1603,26 @@ msmsdcc_init_dma(struct msmsdcc_host *host)
 	host->dma.cmd_busaddr = host->dma.nc_busaddr;
 	host->dma.cmdptr_busaddr = host->dma.nc_busaddr +
 				offsetof(struct msmsdcc_nc_dmadata, cmdptr);
+
+	/* location of command block must be 64 bit aligned */
+	BUG_ON(host->dma.cmd_busaddr & 0x07);
+
+	/*
+	 * Pre-build everything about the command list that doesn't depend
+	 * on the transfer, so that msmsdcc_config_dma() only has to patch
+	 * addresses and row counts into the boxes per request.
+	 */
+	for (i = 0; i < NR_SG; i++)
+		host->dma.nc->cmd[i].src_dst_len = (MCI_FIFOSIZE << 16) |
+						   (MCI_FIFOSIZE);
+	host->dma.nc->cmdptr = (host->dma.cmd_busaddr >> 3) | CMD_PTR_LP;
+	host->dma.hdr.cmdptr = DMOV_CMD_PTR_LIST |
+			       DMOV_CMD_ADDR(host->dma.cmdptr_busaddr);
+	host->dma.hdr.complete_func = msmsdcc_dma_complete_func;
+	host->dma.hdr.crci_mask = msm_dmov_build_crci_mask(1, host->dma.crci);
+	host->dma.hdr.exec_func = msmsdcc_dma_exec_func;
+	host->dma.hdr.user = (void *)host;
+
 	host->dma.channel = host->dmares->start;
 
 	return 0;
@@ -1646,6 +1804,9 @@ msmsdcc_probe(struct platform_device *pdev)
 	tasklet_init(&host->dma_tlet, msmsdcc_dma_complete_tlet,
 			(unsigned long)host);
 
+	setup_timer(&host->busclk_timer, msmsdcc_busclk_expired,
+			(unsigned long)host);
+
 	/*
 	 * Setup DMA
 	 */
@@ -1981,6 +2142,7 @@ static int msmsdcc_remove(struct platform_device *pdev)
 		sysfs_remove_group(&pdev->dev.kobj, &dev_attr_grp);
 
 	tasklet_kill(&host->dma_tlet);
+	del_timer_sync(&host->busclk_timer);
 	mmc_remove_host(mmc);
 
 	if (plat->status_irq)
@@ -2029,6 +2191,7 @@ msmsdcc_runtime_suspend(struct device *dev)
 	if (mmc) {
 		host->sdcc_suspending = 1;
 		mmc->suspend_task = current;
+		del_timer_sync(&host->busclk_timer);
 
 			/*
 			 * MMC core thinks that host is disabled by now since
@@ -190,6 +190,7 @@ struct msmsdcc_dma_data {
 	int				num_ents;
 
 	int				channel;
+	uint32_t			crci;
 	struct msmsdcc_host		*host;
 	int				busy; /* Set if DM is busy */
 	unsigned int 			result;
@@ -270,6 +271,8 @@ struct msmsdcc_host {
 
 	unsigned int sdcc_irq_disabled;
 
+	/* defers bus clock gating for SDIO clients between access bursts */
+	struct timer_list	busclk_timer;
 };
 
 int msmsdcc_set_pwrsave(struct mmc_host *mmc, int pwrsave);
@@ -42,6 +42,10 @@ uint32_t dual_nand_ctlr_present;
 uint32_t interleave_enable;
 unsigned crci_mask;
 
+/* set while mtd->panic_write runs: switches the write path to the
+ * polled data mover and keeps it from sleeping */
+static int msm_nand_in_panic;
+
 #define MSM_NAND_DMA_BUFFER_SIZE SZ_8K
 #define MSM_NAND_DMA_BUFFER_SLOTS \
 	(MSM_NAND_DMA_BUFFER_SIZE / (sizeof(((atomic_t *)0)->counter) * 8))
@@ -728,6 +732,264 @@ uint32_t flash_onfi_probe(struct msm_nand_chip *chip)
 	return err;
 }
 
+/* Number of pages chained into one dmov submission on the data-only
+ * read fast path.  The controller overlaps the NAND transfer and ECC
+ * of consecutive codewords, so removing the per-page CPU turnaround
+ * keeps the interface streaming; statuses for the whole batch are
+ * collected in the chain and inspected once it completes.
+ */
+#define MSM_NAND_MULTI_READ_PAGES 4
+
+static int msm_nand_read_pages_multi(struct mtd_info *mtd, loff_t from,
+				     struct mtd_oob_ops *ops)
+{
+	struct msm_nand_chip *chip = mtd->priv;
+
+	struct {
+		dmov_s cmd[MSM_NAND_MULTI_READ_PAGES * 8 * 4 + 3];
+		unsigned cmdptr;
+		struct {
+			struct {
+				uint32_t cmd;
+				uint32_t addr0;
+				uint32_t addr1;
+				uint32_t chipsel;
+			} seq[MSM_NAND_MULTI_READ_PAGES];
+			uint32_t cfg0;
+			uint32_t cfg1;
+			uint32_t exec;
+			uint32_t ecccfg;
+			struct {
+				uint32_t flash_status;
+				uint32_t buffer_status;
+			} result[MSM_NAND_MULTI_READ_PAGES][8];
+		} data;
+	} *dma_buffer;
+	dmov_s *cmd;
+	unsigned n, p;
+	unsigned page = 0;
+	uint32_t sectordatasize;
+	int err = 0, pageerr, rawerr;
+	dma_addr_t data_dma_addr = 0;
+	dma_addr_t data_dma_addr_curr = 0;
+	unsigned page_count;
+	unsigned pages_read = 0;
+	unsigned batch;
+	uint32_t ecc_errors;
+	uint32_t total_ecc_errors = 0;
+	unsigned cwperpage;
+
+	if (mtd->writesize == 2048)
+		page = from >> 11;
+
+	if (mtd->writesize == 4096)
+		page = from >> 12;
+
+	cwperpage = (mtd->writesize >> 9);
+	page_count = ops->len / mtd->writesize;
+
+	data_dma_addr_curr = data_dma_addr =
+		msm_nand_dma_map(chip->dev, ops->datbuf, ops->len,
+			       DMA_FROM_DEVICE);
+	if (dma_mapping_error(chip->dev, data_dma_addr)) {
+		pr_err("%s: failed to get dma addr for %p\n",
+		       __func__, ops->datbuf);
+		return -EIO;
+	}
+
+	wait_event(chip->wait_queue,
+		   (dma_buffer = msm_nand_get_dma_buffer(
+			    chip, sizeof(*dma_buffer))));
+
+	while (page_count > 0) {
+		batch = page_count < MSM_NAND_MULTI_READ_PAGES ?
+			page_count : MSM_NAND_MULTI_READ_PAGES;
+		cmd = dma_buffer->cmd;
+
+		dma_buffer->data.cfg0 =
+			(chip->CFG0 & ~(7U << 6)) | ((cwperpage-1) << 6);
+		dma_buffer->data.cfg1 = chip->CFG1;
+		dma_buffer->data.ecccfg = chip->ecc_buf_cfg;
+		dma_buffer->data.exec = 1;
+
+		for (p = 0; p < batch; p++, page++) {
+			dma_buffer->data.seq[p].cmd =
+				MSM_NAND_CMD_PAGE_READ_ECC;
+			dma_buffer->data.seq[p].addr0 = page << 16;
+			dma_buffer->data.seq[p].addr1 = (page >> 16) & 0xff;
+			/* chipsel_0 + enable DM interface */
+			dma_buffer->data.seq[p].chipsel = 0 | 4;
+
+			for (n = 0; n < cwperpage; n++) {
+				dma_buffer->data.result[p][n].flash_status =
+					0xeeeeeeee;
+				dma_buffer->data.result[p][n].buffer_status =
+					0xeeeeeeee;
+
+				/* block on cmd ready; the first codeword
+				 * of each page programs CMD / ADDR0 /
+				 * ADDR1 / CHIPSEL in a burst
+				 */
+				cmd->cmd = DST_CRCI_NAND_CMD;
+				cmd->src = msm_virt_to_dma(chip,
+						&dma_buffer->data.seq[p].cmd);
+				cmd->dst = MSM_NAND_FLASH_CMD;
+				if (n == 0)
+					cmd->len = 16;
+				else
+					cmd->len = 4;
+				cmd++;
+
+				/* CFG and ECC registers keep their
+				 * values across the whole chain
+				 */
+				if (p == 0 && n == 0) {
+					cmd->cmd = 0;
+					cmd->src = msm_virt_to_dma(chip,
+							&dma_buffer->data.cfg0);
+					cmd->dst = MSM_NAND_DEV0_CFG0;
+					cmd->len = 8;
+					cmd++;
+
+					cmd->cmd = 0;
+					cmd->src = msm_virt_to_dma(chip,
+						&dma_buffer->data.ecccfg);
+					cmd->dst = MSM_NAND_EBI2_ECC_BUF_CFG;
+					cmd->len = 4;
+					cmd++;
+				}
+
+				/* kick the execute register */
+				cmd->cmd = 0;
+				cmd->src = msm_virt_to_dma(chip,
+						&dma_buffer->data.exec);
+				cmd->dst = MSM_NAND_EXEC_CMD;
+				cmd->len = 4;
+				cmd++;
+
+				/* block on data ready, then read the
+				 * status registers
+				 */
+				cmd->cmd = SRC_CRCI_NAND_DATA;
+				cmd->src = MSM_NAND_FLASH_STATUS;
+				cmd->dst = msm_virt_to_dma(chip,
+						&dma_buffer->data.result[p][n]);
+				/* MSM_NAND_FLASH_STATUS +
+				 * MSM_NAND_BUFFER_STATUS */
+				cmd->len = 8;
+				cmd++;
+
+				sectordatasize = (n < (cwperpage - 1))
+					? 516 : (512 - ((cwperpage - 1) << 2));
+
+				cmd->cmd = 0;
+				cmd->src = MSM_NAND_FLASH_BUFFER;
+				cmd->dst = data_dma_addr_curr;
+				data_dma_addr_curr += sectordatasize;
+				cmd->len = sectordatasize;
+				cmd++;
+			}
+		}
+
+		BUILD_BUG_ON(MSM_NAND_MULTI_READ_PAGES * 8 * 4 + 3 !=
+				ARRAY_SIZE(dma_buffer->cmd));
+		BUG_ON(cmd - dma_buffer->cmd > ARRAY_SIZE(dma_buffer->cmd));
+		dma_buffer->cmd[0].cmd |= CMD_OCB;
+		cmd[-1].cmd |= CMD_OCU | CMD_LC;
+
+		dma_buffer->cmdptr =
+			(msm_virt_to_dma(chip, dma_buffer->cmd) >> 3)
+			| CMD_PTR_LP;
+
+		dsb();
+		msm_dmov_exec_cmd(chip->dma_channel, crci_mask,
+			DMOV_CMD_PTR_LIST | DMOV_CMD_ADDR(msm_virt_to_dma(chip,
+			&dma_buffer->cmdptr)));
+		dsb();
+
+		for (p = 0; p < batch; p++) {
+			pageerr = rawerr = 0;
+			for (n = 0; n < cwperpage; n++) {
+				if (dma_buffer->data.result[p][n].flash_status
+						& 0x110) {
+					rawerr = -EIO;
+					break;
+				}
+			}
+			if (rawerr) {
+				uint8_t *datbuf = ops->datbuf +
+					pages_read * mtd->writesize;
+
+				dma_sync_single_for_cpu(chip->dev,
+					data_dma_addr +
+					pages_read * mtd->writesize,
+					mtd->writesize, DMA_BIDIRECTIONAL);
+
+				for (n = 0; n < mtd->writesize; n++) {
+					/* empty blocks read 0x54 at
+					 * these offsets
+					 */
+					if (n % 516 == 3 && datbuf[n] == 0x54)
+						datbuf[n] = 0xff;
+					if (datbuf[n] != 0xff) {
+						pageerr = rawerr;
+						break;
+					}
+				}
+
+				dma_sync_single_for_device(chip->dev,
+					data_dma_addr +
+					pages_read * mtd->writesize,
+					mtd->writesize, DMA_BIDIRECTIONAL);
+			}
+			if (pageerr) {
+				for (n = 0; n < cwperpage; n++) {
+					if (dma_buffer->data.result[p][n].
+							buffer_status & 0x8) {
+						/* not thread safe */
+						mtd->ecc_stats.failed++;
+						pageerr = -EBADMSG;
+						break;
+					}
+				}
+			}
+			if (!rawerr) { /* check for correctable errors */
+				for (n = 0; n < cwperpage; n++) {
+					ecc_errors = dma_buffer->data.
+						result[p][n].buffer_status & 0x7;
+					if (ecc_errors) {
+						total_ecc_errors += ecc_errors;
+						/* not thread safe */
+						mtd->ecc_stats.corrected +=
+							ecc_errors;
+						if (ecc_errors > 1)
+							pageerr = -EUCLEAN;
+					}
+				}
+			}
+			if (pageerr && (pageerr != -EUCLEAN || err == 0))
+				err = pageerr;
+
+			if (err && err != -EUCLEAN && err != -EBADMSG)
+				break;
+			pages_read++;
+		}
+		if (err && err != -EUCLEAN && err != -EBADMSG)
+			break;
+		page_count -= batch;
+	}
+	msm_nand_release_dma_buffer(chip, dma_buffer, sizeof(*dma_buffer));
+
+	dma_unmap_page(chip->dev, data_dma_addr, ops->len, DMA_BIDIRECTIONAL);
+
+	ops->retlen = mtd->writesize * pages_read;
+	ops->oobretlen = 0;
+	if (err)
+		pr_err("%s: %llx %x failed %d, corrected %d\n",
+		       __func__, from, ops->len, err, total_ecc_errors);
+	return err;
+}
+
 static int msm_nand_read_oob(struct mtd_info *mtd, loff_t from,
 			     struct mtd_oob_ops *ops)
 {
@@ -827,6 +1089,13 @@ static int msm_nand_read_oob(struct mtd_info *mtd, loff_t from,
 	else
 		page_count = ops->len / (mtd->writesize + mtd->oobsize);
 
+	/* Data-only ECC reads of several pages go down the chained
+	 * fast path, one dmov submission per batch of pages.
+	 */
+	if (ops->datbuf && !ops->oobbuf && ops->mode != MTD_OOB_RAW &&
+	    page_count > 1)
+		return msm_nand_read_pages_multi(mtd, from, ops);
+
 	if (ops->datbuf) {
 		data_dma_addr_curr = data_dma_addr =
 			msm_nand_dma_map(chip->dev, ops->datbuf, ops->len,
@@ -2029,7 +2298,19 @@ msm_nand_write_oob(struct mtd_info *mtd, loff_t to, struct mtd_oob_ops *ops)
 	else
 		page_count = ops->len / (mtd->writesize + mtd->oobsize);
 
-	wait_event(chip->wait_queue, (dma_buffer =
+	if (msm_nand_in_panic) {
+		/* single threaded by now; reclaim any buffer slots that
+		 * were held when the system died
+		 */
+		dma_buffer = msm_nand_get_dma_buffer(chip,
+						sizeof(*dma_buffer));
+		if (!dma_buffer) {
+			atomic_set(&chip->dma_buffer_busy, 0);
+			dma_buffer = msm_nand_get_dma_buffer(chip,
+						sizeof(*dma_buffer));
+		}
+	} else
+		wait_event(chip->wait_queue, (dma_buffer =
 			msm_nand_get_dma_buffer(chip, sizeof(*dma_buffer))));
 
 	while (page_count-- > 0) {
@@ -2177,9 +2458,16 @@ msm_nand_write_oob(struct mtd_info *mtd, loff_t to, struct mtd_oob_ops *ops)
 			CMD_PTR_LP;
 
 		dsb();
-		msm_dmov_exec_cmd(chip->dma_channel, crci_mask,
-			DMOV_CMD_PTR_LIST | DMOV_CMD_ADDR(
-				msm_virt_to_dma(chip, &dma_buffer->cmdptr)));
+		if (msm_nand_in_panic)
+			msm_dmov_exec_cmd_poll(chip->dma_channel, crci_mask,
+				DMOV_CMD_PTR_LIST | DMOV_CMD_ADDR(
+					msm_virt_to_dma(chip,
+						&dma_buffer->cmdptr)));
+		else
+			msm_dmov_exec_cmd(chip->dma_channel, crci_mask,
+				DMOV_CMD_PTR_LIST | DMOV_CMD_ADDR(
+					msm_virt_to_dma(chip,
+						&dma_buffer->cmdptr)));
 		dsb();
 
 		/* if any of the writes failed (0x10), or there was a
@@ -2865,6 +3153,28 @@ static int msm_nand_write(struct mtd_info *mtd, loff_t to, size_t len,
 	return ret;
 }
 
+static int msm_nand_panic_write(struct mtd_info *mtd, loff_t to, size_t len,
+				size_t *retlen, const u_char *buf)
+{
+	int ret;
+	struct mtd_oob_ops ops;
+
+	if (dual_nand_ctlr_present)
+		return -EOPNOTSUPP;
+
+	msm_nand_in_panic = 1;
+	ops.mode = MTD_OOB_PLACE;
+	ops.len = len;
+	ops.retlen = 0;
+	ops.ooblen = 0;
+	ops.datbuf = (uint8_t *)buf;
+	ops.oobbuf = NULL;
+	ret = msm_nand_write_oob(mtd, to, &ops);
+	msm_nand_in_panic = 0;
+	*retlen = ops.retlen;
+	return ret;
+}
+
 static int
 msm_nand_erase(struct mtd_info *mtd, struct erase_info *instr)
 {
@@ -6688,6 +6998,7 @@ int msm_nand_scan(struct mtd_info *mtd, int maxchips)
 	mtd->unpoint = NULL;
 	mtd->read = msm_nand_read;
 	mtd->write = msm_nand_write;
+	mtd->panic_write = msm_nand_panic_write;
 	mtd->read_oob  = msm_nand_read_oob;
 	mtd->write_oob = msm_nand_write_oob;
 	if (dual_nand_ctlr_present) {
@@ -27,8 +27,19 @@ struct mtdblk_dev {
 	unsigned long cache_offset;
 	unsigned int cache_size;
 	enum { STATE_EMPTY, STATE_CLEAN, STATE_DIRTY } cache_state;
+	unsigned char *ra_data;
+	unsigned long ra_offset;
+	unsigned int ra_len;
+	unsigned long ra_next_pos;
+	unsigned int ra_streak;
 };
 
+/*
+ * Number of consecutive sequential reads before the erase-block
+ * readahead buffer is engaged (see do_cached_read() below).
+ */
+#define MTDBLOCK_RA_MIN_STREAK	4
+
 static struct mutex mtdblks_lock;
 
 /*
@@ -136,6 +147,9 @@ static int do_cached_write (struct mtdblk_dev *mtdblk, unsigned long pos,
 	DEBUG(MTD_DEBUG_LEVEL2, "mtdblock: write on \"%s\" at 0x%lx, size 0x%x\n",
 		mtd->name, pos, len);
 
+	/* the flash is changing underneath the readahead buffer */
+	mtdblk->ra_len = 0;
+
 	if (!sect_size)
 		return mtd->write(mtd, pos, len, &retlen, buf);
 
@@ -195,6 +209,43 @@ static int do_cached_write (struct mtdblk_dev *mtdblk, unsigned long pos,
 }
 
 
+/*
+ * Pull the whole erase block around pos into the readahead buffer with
+ * one MTD read, so that a sequential stream of 512-byte sector requests
+ * runs at sequential flash bandwidth instead of one small read per
+ * sector.  Drivers with a multi-page read path (msm_nand) benefit the
+ * most, but even a plain page-at-a-time driver saves the per-call
+ * overhead.  Errors just leave the buffer empty; the caller falls back
+ * to direct reads.
+ */
+static void mtdblock_fill_readahead(struct mtdblk_dev *mtdblk,
+				    unsigned long pos)
+{
+	struct mtd_info *mtd = mtdblk->mbd.mtd;
+	unsigned long start = pos - (pos % mtd->erasesize);
+	unsigned int size = mtd->erasesize;
+	size_t retlen;
+	int ret;
+
+	mtdblk->ra_len = 0;
+
+	if (!mtdblk->ra_data) {
+		mtdblk->ra_data = vmalloc(mtd->erasesize);
+		if (!mtdblk->ra_data)
+			return;
+	}
+
+	if (start + size > mtd->size)
+		size = mtd->size - start;
+
+	ret = mtd->read(mtd, start, size, &retlen, mtdblk->ra_data);
+	if (ret && ret != -EUCLEAN)
+		return;
+
+	mtdblk->ra_offset = start;
+	mtdblk->ra_len = retlen;
+}
+
 static int do_cached_read (struct mtdblk_dev *mtdblk, unsigned long pos,
 			   int len, char *buf)
 {
@@ -206,6 +257,18 @@ static int do_cached_read (struct mtdblk_dev *mtdblk, unsigned long pos,
 	DEBUG(MTD_DEBUG_LEVEL2, "mtdblock: read on \"%s\" at 0x%lx, size 0x%x\n",
 			mtd->name, pos, len);
 
+	/*
+	 * Readahead bookkeeping: count back-to-back sequential reads and
+	 * start pre-reading whole erase blocks once a stream is evident.
+	 * All requests are serialized by the blktrans thread, so the
+	 * state needs no extra locking.
+	 */
+	if (pos == mtdblk->ra_next_pos)
+		mtdblk->ra_streak++;
+	else
+		mtdblk->ra_streak = 0;
+	mtdblk->ra_next_pos = pos + len;
+
 	if (!sect_size)
 		return mtd->read(mtd, pos, len, &retlen, buf);
 
@@ -226,11 +289,25 @@ static int do_cached_read (struct mtdblk_dev *mtdblk, unsigned long pos,
 		    mtdblk->cache_offset == sect_start) {
 			memcpy (buf, mtdblk->cache_data + offset, size);
 		} else {
-			ret = mtd->read(mtd, pos, size, &retlen, buf);
-			if (ret)
-				return ret;
-			if (retlen != size)
-				return -EIO;
+			if (mtd->erasesize &&
+			    (mtdblk->ra_len == 0 ||
+			     pos < mtdblk->ra_offset ||
+			     pos + size > mtdblk->ra_offset + mtdblk->ra_len) &&
+			    mtdblk->ra_streak >= MTDBLOCK_RA_MIN_STREAK)
+				mtdblock_fill_readahead(mtdblk, pos);
+
+			if (mtdblk->ra_len &&
+			    pos >= mtdblk->ra_offset &&
+			    pos + size <= mtdblk->ra_offset + mtdblk->ra_len) {
+				memcpy(buf, mtdblk->ra_data +
+				       (pos - mtdblk->ra_offset), size);
+			} else {
+				ret = mtd->read(mtd, pos, size, &retlen, buf);
+				if (ret)
+					return ret;
+				if (retlen != size)
+					return -EIO;
+			}
 		}
 
 		buf += size;
@@ -310,6 +387,10 @@ static int mtdblock_release(struct mtd_blktrans_dev *mbd)
 		if (mbd->mtd->sync)
 			mbd->mtd->sync(mbd->mtd);
 		vfree(mtdblk->cache_data);
+		vfree(mtdblk->ra_data);
+		mtdblk->ra_data = NULL;
+		mtdblk->ra_len = 0;
+		mtdblk->ra_streak = 0;
 	}
 
 	mutex_unlock(&mtdblks_lock);
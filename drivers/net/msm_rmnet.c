@@ -47,6 +47,10 @@
 
 #define HEADROOM_FOR_QOS    8
 
+/* receive buffers recycled per device; covers the largest rx frame */
+#define RMNET_POOL_SIZE (RMNET_DATA_LEN + ETH_HLEN + NET_IP_ALIGN)
+#define RMNET_POOL_MAX  16
+
 static const char *ch_name[8] = {
 	"DATA5",
 	"DATA6",
@@ -73,6 +77,7 @@ struct rmnet_private
 	unsigned long timeout_us;
 #endif
 	struct sk_buff *skb;
+	struct skb_pool rx_pool;
 	spinlock_t lock;
 	struct tasklet_struct tsklt;
 	u32 operation_mode;    /* IOCTL specified mode (protocol, QoS header) */
@@ -260,7 +265,7 @@ static void smd_net_data_handler(unsigned long arg)
 					dev->mtu : (dev->mtu + ETH_HLEN));
 			ptr = 0;
 		} else {
-			skb = dev_alloc_skb(sz + NET_IP_ALIGN);
+			skb = skb_pool_alloc(&p->rx_pool, sz + NET_IP_ALIGN);
 			if (skb == NULL) {
 				pr_err("rmnet_recv() cannot allocate skb\n");
 			} else {
@@ -271,7 +276,7 @@ static void smd_net_data_handler(unsigned long arg)
 				if (smd_read(p->ch, ptr, sz) != sz) {
 					pr_err("rmnet_recv() smd lied about avail?!");
 					ptr = 0;
-					dev_kfree_skb_irq(skb);
+					skb_pool_recycle(&p->rx_pool, skb);
 				} else {
 					/* Handle Rx frame format */
 					spin_lock_irqsave(&p->lock, flags);
@@ -347,8 +352,8 @@ static int _rmnet_xmit(struct sk_buff *skb, struct net_device *dev)
 	}
 
 xmit_out:
-	/* data xmited, safe to release skb */
-	dev_kfree_skb_irq(skb);
+	/* data xmited; feed the skb back to the receive pool when we can */
+	skb_pool_recycle(&p->rx_pool, skb);
 	return 0;
 }
 
@@ -448,6 +453,12 @@ static int __rmnet_open(struct net_device *dev)
 
 		if (r < 0)
 			return -ENODEV;
+
+		/* Back-to-back transmits land in the SMD fifo as one
+		 * train with a single doorbell; the flush timer caps
+		 * the added latency for a lone packet.
+		 */
+		smd_enable_doorbell_coalesce(p->ch);
 	}
 
 	smd_disable_read_intr(p->ch);
@@ -491,6 +502,7 @@ static int rmnet_stop(struct net_device *dev)
 
 	netif_stop_queue(dev);
 	tasklet_kill(&p->tsklt);
+	skb_pool_purge(&p->rx_pool);
 
 	/* TODO: unload modem safely,
 	   currently, this causes unnecessary unloads */
@@ -740,6 +752,7 @@ static int __init rmnet_init(void)
 		/* Initial config uses Ethernet */
 		p->operation_mode = RMNET_MODE_LLP_ETH;
 		p->skb = NULL;
+		skb_pool_init(&p->rx_pool, RMNET_POOL_SIZE, RMNET_POOL_MAX);
 		spin_lock_init(&p->lock);
 		tasklet_init(&p->tsklt, _rmnet_resume_flow,
 				(unsigned long)dev);
@@ -291,6 +291,9 @@ typedef struct dhd_info {
 	wait_queue_head_t ctrl_wait;
 	atomic_t pend_8021x_cnt;
 
+	/* Frames handed to the stack per softirq kick in dhd_rx_frame() */
+	uint rx_batch_budget;
+
 #ifdef CONFIG_HAS_EARLYSUSPEND
 	struct early_suspend early_suspend;
 #endif /* CONFIG_HAS_EARLYSUSPEND */
@@ -1199,6 +1202,12 @@ dhd_txflowcontrol(dhd_pub_t *dhdp, int ifidx, bool state)
 		netif_wake_queue(net);
 }
 
+/* Budget for batched RX delivery: shrinks when the backlog overflows,
+ * creeps back up on clean batches.
+ */
+#define DHD_RX_BATCH_MIN	4
+#define DHD_RX_BATCH_MAX	32
+
 void
 dhd_rx_frame(dhd_pub_t *dhdp, int ifidx, void *pktbuf, int numpkt)
 {
@@ -1210,10 +1219,14 @@ dhd_rx_frame(dhd_pub_t *dhdp, int ifidx, void *pktbuf, int numpkt)
 	int i;
 	dhd_if_t *ifp;
 	wl_event_msg_t event;
+	struct sk_buff_head rxq;
+	uint budget, batched = 0;
+	bool dropped = FALSE;
 
 	DHD_TRACE(("%s: Enter\n", __FUNCTION__));
 
 	save_pktbuf = pktbuf;
+	__skb_queue_head_init(&rxq);
 
 	for (i = 0; pktbuf && i < numpkt; i++, pktbuf = pnext) {
 
@@ -1274,15 +1287,20 @@ dhd_rx_frame(dhd_pub_t *dhdp, int ifidx, void *pktbuf, int numpkt)
 		dhdp->dstats.rx_bytes += skb->len;
 		dhdp->rx_packets++; /* Local count */
 
+		__skb_queue_tail(&rxq, skb);
+	}
+
+	/* Hand the accumulated frames to the stack in one go: all but the
+	 * last frame of each budget chunk only sit down on the backlog via
+	 * netif_rx(), and the chunk's last frame wakes the softirq once.
+	 * If the receive is processed inside an ISR the softirq runs on
+	 * interrupt exit anyway, so plain netif_rx() is enough there.
+	 */
+	budget = dhd->rx_batch_budget;
+	while ((skb = __skb_dequeue(&rxq)) != NULL) {
 		if (in_interrupt()) {
 			netif_rx(skb);
-		} else {
-			/* If the receive is not processed inside an ISR,
-			 * the softirqd must be woken explicitly to service
-			 * the NET_RX_SOFTIRQ.  In 2.6 kernels, this is handled
-			 * by netif_rx_ni(), but in earlier kernels, we need
-			 * to do it manually.
-			 */
+		} else if (skb_queue_empty(&rxq) || ++batched >= budget) {
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2, 6, 0)
 			netif_rx_ni(skb);
 #else
@@ -1292,8 +1310,18 @@ dhd_rx_frame(dhd_pub_t *dhdp, int ifidx, void *pktbuf, int numpkt)
 			RAISE_RX_SOFTIRQ();
 			local_irq_restore(flags);
 #endif /* LINUX_VERSION_CODE >= KERNEL_VERSION(2, 6, 0) */
+			batched = 0;
+		} else if (netif_rx(skb) == NET_RX_DROP) {
+			dropped = TRUE;
 		}
 	}
+
+	/* Adapt the budget to what the backlog can absorb */
+	if (dropped)
+		dhd->rx_batch_budget = MAX(budget / 2, DHD_RX_BATCH_MIN);
+	else if (budget < DHD_RX_BATCH_MAX)
+		dhd->rx_batch_budget = budget + 1;
+
 	dhd_os_wake_lock_timeout_enable(dhdp);
 }
 
@@ -2042,6 +2070,7 @@ dhd_attach(osl_t *osh, struct dhd_bus *bus, uint bus_hdrlen)
 	spin_lock_init(&dhd->wl_lock);
 	dhd->wl_count = 0;
 	dhd->wl_packet = 0;
+	dhd->rx_batch_budget = DHD_RX_BATCH_MAX;
 #ifdef CONFIG_HAS_WAKELOCK
 	wake_lock_init(&dhd->wl_wifi, WAKE_LOCK_SUSPEND, "wlan_wake");
 	wake_lock_init(&dhd->wl_rxwake, WAKE_LOCK_SUSPEND, "wlan_rx_wake");
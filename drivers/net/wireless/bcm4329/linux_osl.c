@@ -79,8 +79,12 @@ struct osl_info {
 	uint failed;
 	uint bustype;
 	bcm_mem_link_t *dbgmem_list;
+	struct skb_pool pkt_pool;
 };
 
+/* recycled packet buffers; PKTBUFSZ covers the normal receive frames */
+#define OSL_PKT_POOL_MAX	16
+
 static int16 linuxbcmerrormap[] =
 {	0, 			
 	-EINVAL,		
@@ -169,6 +173,7 @@ osl_attach(void *pdev, uint bustype, bool pkttag)
 	osh->pdev = pdev;
 	osh->pub.pkttag = pkttag;
 	osh->bustype = bustype;
+	skb_pool_init(&osh->pkt_pool, PKTBUFSZ, OSL_PKT_POOL_MAX);
 
 	switch (bustype) {
 		case PCI_BUS:
@@ -238,6 +243,7 @@ osl_detach(osl_t *osh)
 	}
 #endif 
 	ASSERT(osh->magic == OS_HANDLE_MAGIC);
+	skb_pool_purge(&osh->pkt_pool);
 	kfree(osh);
 }
 
@@ -247,7 +253,7 @@ osl_pktget(osl_t *osh, uint len)
 {
 	struct sk_buff *skb;
 
-	if ((skb = dev_alloc_skb(len))) {
+	if ((skb = skb_pool_alloc(&osh->pkt_pool, len))) {
 		skb_put(skb, len);
 		skb->priority = 0;
 
@@ -275,13 +281,7 @@ osl_pktfree(osl_t *osh, void *p, bool send)
 		skb->next = NULL;
 
 
-		if (skb->destructor) {
-			
-			dev_kfree_skb_any(skb);
-		} else {
-			
-			dev_kfree_skb(skb);
-		}
+		skb_pool_recycle(&osh->pkt_pool, skb);
 
 		osh->pub.pktalloced--;
 
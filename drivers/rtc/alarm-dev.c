@@ -61,6 +61,7 @@ static long alarm_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
 {
 	int rv = 0;
 	unsigned long flags;
+	struct alarm_time_range new_alarm_range;
 	struct timespec new_alarm_time;
 	struct timespec new_rtc_time;
 	struct timespec tmp_time;
@@ -109,6 +110,26 @@ static long alarm_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
 		new_alarm_time.tv_nsec = 0;
 		goto from_old_alarm_set;
 
+	case ANDROID_ALARM_SET_RANGE(0):
+		if (copy_from_user(&new_alarm_range, (void __user *)arg,
+		    sizeof(new_alarm_range))) {
+			rv = -EFAULT;
+			goto err1;
+		}
+		spin_lock_irqsave(&alarm_slock, flags);
+		pr_alarm(IO, "alarm %d set range %ld.%09ld to %ld.%09ld\n",
+			alarm_type,
+			new_alarm_range.earliest.tv_sec,
+			new_alarm_range.earliest.tv_nsec,
+			new_alarm_range.latest.tv_sec,
+			new_alarm_range.latest.tv_nsec);
+		alarm_enabled |= alarm_type_mask;
+		alarm_start_range(&alarms[alarm_type],
+			timespec_to_ktime(new_alarm_range.earliest),
+			timespec_to_ktime(new_alarm_range.latest));
+		spin_unlock_irqrestore(&alarm_slock, flags);
+		break;
+
 	case ANDROID_ALARM_SET_AND_WAIT(0):
 	case ANDROID_ALARM_SET(0):
 		if (copy_from_user(&new_alarm_time, (void __user *)arg,
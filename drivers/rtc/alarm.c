@@ -15,11 +15,14 @@
 
 #include <asm/mach/time.h>
 #include <linux/android_alarm.h>
+#include <linux/debugfs.h>
 #include <linux/device.h>
+#include <linux/hardirq.h>
 #include <linux/miscdevice.h>
 #include <linux/platform_device.h>
 #include <linux/rtc.h>
 #include <linux/sched.h>
+#include <linux/seq_file.h>
 #include <linux/spinlock.h>
 #include <linux/sysdev.h>
 #include <linux/wakelock.h>
@@ -68,6 +71,39 @@ static struct platform_device *alarm_platform_dev;
 struct alarm_queue alarms[ANDROID_ALARM_TYPE_COUNT];
 static bool suspended;
 
+/*
+ * Per-uid alarm accounting, so spurious wakeups can be pinned on their
+ * source.  The table is small: only a handful of uids program alarms
+ * directly (AlarmManager runs in the system server) and kernel users
+ * show up as uid 0.  Protected by alarm_slock.
+ */
+#define ALARM_UID_STATS_SIZE 64
+
+struct alarm_uid_stat {
+	uid_t uid;
+	unsigned int sets;
+	unsigned int fires;
+	unsigned int wakeup_fires;
+	bool used;
+};
+static struct alarm_uid_stat alarm_uid_stats[ALARM_UID_STATS_SIZE];
+
+static struct alarm_uid_stat *alarm_uid_stat_find(uid_t uid)
+{
+	int i;
+
+	for (i = 0; i < ALARM_UID_STATS_SIZE; i++)
+		if (alarm_uid_stats[i].used && alarm_uid_stats[i].uid == uid)
+			return &alarm_uid_stats[i];
+	for (i = 0; i < ALARM_UID_STATS_SIZE; i++)
+		if (!alarm_uid_stats[i].used) {
+			alarm_uid_stats[i].used = true;
+			alarm_uid_stats[i].uid = uid;
+			return &alarm_uid_stats[i];
+		}
+	return NULL;
+}
+
 static void update_timer_locked(struct alarm_queue *base, bool head_removed)
 {
 	struct alarm *alarm;
@@ -155,6 +191,7 @@ void alarm_init(struct alarm *alarm,
 	RB_CLEAR_NODE(&alarm->node);
 	alarm->type = type;
 	alarm->function = function;
+	alarm->uid = 0;
 
 	pr_alarm(FLOW, "created alarm, type %d, func %pF\n", type, function);
 }
@@ -169,8 +206,15 @@ void alarm_init(struct alarm *alarm,
 void alarm_start_range(struct alarm *alarm, ktime_t start, ktime_t end)
 {
 	unsigned long flags;
+	struct alarm_uid_stat *stat;
 
 	spin_lock_irqsave(&alarm_slock, flags);
+	/* alarms restarted from their own callback keep the original uid */
+	if (!in_interrupt())
+		alarm->uid = current_uid();
+	stat = alarm_uid_stat_find(alarm->uid);
+	if (stat)
+		stat->sets++;
 	alarm->softexpires = start;
 	alarm->expires = end;
 	alarm_enqueue_locked(alarm);
@@ -342,12 +386,16 @@ static enum hrtimer_restart alarm_timer_triggered(struct hrtimer *timer)
 {
 	struct alarm_queue *base;
 	struct alarm *alarm;
+	struct alarm_uid_stat *stat;
+	bool is_wakeup;
 	unsigned long flags;
 	ktime_t now;
 
 	spin_lock_irqsave(&alarm_slock, flags);
 
 	base = container_of(timer, struct alarm_queue, timer);
+	is_wakeup = base == &alarms[ANDROID_ALARM_RTC_WAKEUP] ||
+			base == &alarms[ANDROID_ALARM_ELAPSED_REALTIME_WAKEUP];
 	now = base->stopped ? base->stopped_time : hrtimer_cb_get_time(timer);
 	now = ktime_sub(now, base->delta);
 
@@ -365,6 +413,12 @@ static enum hrtimer_restart alarm_timer_triggered(struct hrtimer *timer)
 		base->first = rb_next(&alarm->node);
 		rb_erase(&alarm->node, &base->alarms);
 		RB_CLEAR_NODE(&alarm->node);
+		stat = alarm_uid_stat_find(alarm->uid);
+		if (stat) {
+			stat->fires++;
+			if (is_wakeup)
+				stat->wakeup_fires++;
+		}
 		pr_alarm(CALL, "call alarm, type %d, func %pF, %lld (s %lld)\n",
 			alarm->type, alarm->function,
 			ktime_to_ns(alarm->expires),
@@ -567,6 +621,38 @@ static int __init alarm_late_init(void)
 	return 0;
 }
 
+static int alarm_stats_show(struct seq_file *s, void *unused)
+{
+	unsigned long flags;
+	int i;
+
+	seq_printf(s, "uid        sets       fires      wakeup_fires\n");
+	spin_lock_irqsave(&alarm_slock, flags);
+	for (i = 0; i < ALARM_UID_STATS_SIZE; i++) {
+		if (!alarm_uid_stats[i].used)
+			continue;
+		seq_printf(s, "%-10u %-10u %-10u %u\n",
+			alarm_uid_stats[i].uid,
+			alarm_uid_stats[i].sets,
+			alarm_uid_stats[i].fires,
+			alarm_uid_stats[i].wakeup_fires);
+	}
+	spin_unlock_irqrestore(&alarm_slock, flags);
+	return 0;
+}
+
+static int alarm_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, alarm_stats_show, NULL);
+}
+
+static const struct file_operations alarm_stats_fops = {
+	.open = alarm_stats_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 static int __init alarm_driver_init(void)
 {
 	int err;
@@ -589,6 +675,9 @@ static int __init alarm_driver_init(void)
 	if (err < 0)
 		goto err2;
 
+	debugfs_create_file("alarm_stats", S_IRUGO, NULL, NULL,
+			    &alarm_stats_fops);
+
 	return 0;
 
 err2:
@@ -116,6 +116,14 @@ struct msm_hs_rx {
 	struct wake_lock wake_lock;
 	struct delayed_work flip_insert_work;
 	struct tasklet_struct tlet;
+	/* Adaptive stale watermark: bounce between rxstale_min for prompt
+	 * delivery of sparse traffic (HCI events) and rxstale_max for
+	 * fewer stale interrupts during bulk streams (ACL data).
+	 */
+	unsigned int rxstale_min;
+	unsigned int rxstale_max;
+	unsigned int rxstale_cur;
+	unsigned int bulk_streak;
 };
 
 enum buffer_states {
@@ -561,9 +569,59 @@ static void msm_hs_set_bps_locked(struct uart_port *uport,
 		return;
 	}
 
-	data = rxstale & UARTDM_IPR_STALE_LSB_BMSK;
-	data |= UARTDM_IPR_STALE_TIMEOUT_MSB_BMSK & (rxstale << 2);
+	/* At BT HCI rates a stale period of 31 character times keeps the
+	 * stale interrupt rate down during bulk ACL streams but is worth
+	 * shortening while traffic is sparse, so single HCI events do not
+	 * sit in the FIFO for the full period.  The rx path bounces the
+	 * watermark between these bounds based on observed chunk sizes;
+	 * at lower rates the table value is used unchanged.
+	 */
+	if (bps >= 921600) {
+		msm_uport->rx.rxstale_min = 4;
+		msm_uport->rx.rxstale_max = rxstale;
+	} else {
+		msm_uport->rx.rxstale_min = rxstale;
+		msm_uport->rx.rxstale_max = rxstale;
+	}
+	msm_uport->rx.rxstale_cur = msm_uport->rx.rxstale_min;
+	msm_uport->rx.bulk_streak = 0;
+
+	data = msm_uport->rx.rxstale_cur & UARTDM_IPR_STALE_LSB_BMSK;
+	data |= UARTDM_IPR_STALE_TIMEOUT_MSB_BMSK &
+					(msm_uport->rx.rxstale_cur << 2);
+
+	msm_hs_write(uport, UARTDM_IPR_ADDR, data);
+}
+
+/* Called with the port lock held and the clock on, after each completed
+ * rx transfer.  Two consecutive near-full buffers switch the stale
+ * watermark to the bulk value; any small chunk drops it straight back
+ * to the latency-oriented minimum.
+ */
+static void msm_hs_adjust_rxstale_locked(struct uart_port *uport, int rx_count)
+{
+	struct msm_hs_port *msm_uport = UARTDM_TO_MSM(uport);
+	struct msm_hs_rx *rx = &msm_uport->rx;
+	unsigned int want;
+	unsigned long data;
+
+	if (rx->rxstale_min == rx->rxstale_max)
+		return;
+
+	if (rx_count >= UARTDM_RX_BUF_SIZE / 2) {
+		if (rx->bulk_streak < 2)
+			rx->bulk_streak++;
+	} else {
+		rx->bulk_streak = 0;
+	}
+
+	want = (rx->bulk_streak >= 2) ? rx->rxstale_max : rx->rxstale_min;
+	if (want == rx->rxstale_cur)
+		return;
 
+	rx->rxstale_cur = want;
+	data = want & UARTDM_IPR_STALE_LSB_BMSK;
+	data |= UARTDM_IPR_STALE_TIMEOUT_MSB_BMSK & (want << 2);
 	msm_hs_write(uport, UARTDM_IPR_ADDR, data);
 }
 
@@ -946,6 +1004,8 @@ static void msm_serial_hs_rx_tlet(unsigned long tlet_ptr)
 
 	rx_count = msm_hs_read(uport, UARTDM_RX_TOTAL_SNAP_ADDR);
 
+	msm_hs_adjust_rxstale_locked(uport, rx_count);
+
 	/* order the read of rx.buffer */
 	dma_coherent_post_ops();
 
@@ -36,6 +36,9 @@
 
 #include "binder.h"
 
+#define CREATE_TRACE_POINTS
+#include "binder_trace.h"
+
 static DEFINE_MUTEX(binder_lock);
 static DEFINE_MUTEX(binder_deferred_lock);
 
@@ -105,6 +108,15 @@ module_param_named(debug_mask, binder_debug_mask, uint, S_IWUSR | S_IRUGO);
 static int binder_debug_no_lock;
 module_param_named(proc_no_lock, binder_debug_no_lock, bool, S_IWUSR | S_IRUGO);
 
+/*
+ * Synchronous transactions whose send-to-reply latency exceeds this
+ * many (approximate) microseconds are recorded in the
+ * slow_transaction_log debugfs file. 0 disables the log.
+ */
+static uint32_t binder_slow_transaction_usecs;
+module_param_named(slow_transaction_usecs, binder_slow_transaction_usecs,
+		   uint, S_IWUSR | S_IRUGO);
+
 static DECLARE_WAIT_QUEUE_HEAD(binder_user_error_wait);
 static int binder_stop_on_user_error;
 
@@ -198,6 +210,36 @@ static struct binder_transaction_log_entry *binder_transaction_log_add(
 	return e;
 }
 
+/*
+ * Ring of recent synchronous transactions that blew the
+ * slow_transaction_usecs budget, with the latency split between the
+ * target's todo queue and the handler so a slow call can be blamed
+ * without a full trace. Times are in units of 1.024us
+ * (sched_clock() >> 10) and wrap with it.
+ */
+struct binder_slow_log_entry {
+	int debug_id;
+	int from_proc;
+	int from_thread;
+	int to_proc;
+	int to_thread;
+	unsigned int code;
+	u32 queue_usec;
+	u32 handler_usec;
+	u32 total_usec;
+};
+struct binder_slow_transaction_log {
+	int next;
+	int full;
+	struct binder_slow_log_entry entry[64];
+};
+static struct binder_slow_transaction_log binder_slow_transaction_log;
+
+static inline u32 binder_stamp(void)
+{
+	return (u32)(sched_clock() >> 10);
+}
+
 struct binder_work {
 	struct list_head entry;
 	enum {
@@ -231,9 +273,17 @@ struct binder_node {
 	unsigned has_async_transaction:1;
 	unsigned accept_fds:1;
 	unsigned min_priority:8;
+	int async_queued;
 	struct list_head async_todo;
 };
 
+/*
+ * Per-node backlog of queued one-way transactions above which we start
+ * complaining; a service this far behind is adding latency for everyone
+ * sharing its process.
+ */
+#define BINDER_NODE_ASYNC_BUDGET 32
+
 struct binder_ref_death {
 	struct binder_work work;
 	void __user *cookie;
@@ -258,8 +308,11 @@ struct binder_ref {
 
 struct binder_buffer {
 	struct list_head entry; /* free and allocated entries by addesss */
-	struct rb_node rb_node; /* free entry by size or allocated entry */
-				/* by address */
+	union {
+		struct rb_node rb_node; /* free entry by size or allocated */
+					/* entry by address */
+		struct list_head bin_entry; /* entry in proc->quick_bin */
+	};
 	unsigned free:1;
 	unsigned allow_user_free:1;
 	unsigned async_transaction:1;
@@ -279,6 +332,18 @@ enum binder_deferred_state {
 	BINDER_DEFERRED_RELEASE      = 0x04,
 };
 
+/*
+ * Small transactions dominate binder traffic, so recently freed buffers
+ * of a few small size classes are kept in per-proc quick bins with their
+ * pages still mapped. Allocations that fit a bin recycle a buffer without
+ * walking the free_buffers rbtree or touching the page tables.
+ */
+#define BINDER_QUICK_BIN_SHIFT	5	/* smallest class: 32 bytes */
+#define BINDER_QUICK_BIN_COUNT	4	/* 32, 64, 128 and 256 bytes */
+#define BINDER_QUICK_BIN_MAX	(1 << (BINDER_QUICK_BIN_SHIFT + \
+				       BINDER_QUICK_BIN_COUNT - 1))
+#define BINDER_QUICK_BIN_DEPTH	16	/* per-class cap on cached buffers */
+
 struct binder_proc {
 	struct hlist_node proc_node;
 	struct rb_root threads;
@@ -297,12 +362,16 @@ struct binder_proc {
 	struct list_head buffers;
 	struct rb_root free_buffers;
 	struct rb_root allocated_buffers;
+	struct list_head quick_bin[BINDER_QUICK_BIN_COUNT];
+	int quick_bin_count[BINDER_QUICK_BIN_COUNT];
+	int copies_in_flight; /* payload copies running without binder_lock */
 	size_t free_async_space;
 
 	struct page **pages;
 	size_t buffer_size;
 	uint32_t buffer_free;
 	struct list_head todo;
+	struct list_head todo_async;
 	wait_queue_head_t wait;
 	struct binder_stats stats;
 	struct list_head delivered_death;
@@ -355,8 +424,39 @@ struct binder_transaction {
 	long	priority;
 	long	saved_priority;
 	uid_t	sender_euid;
+
+	/* binder_stamp() values for the slow-transaction log and traces */
+	u32	send_stamp;
+	u32	queue_stamp;
+	u32	dequeue_stamp;
 };
 
+static void binder_slow_transaction_record(struct binder_transaction *t,
+					   struct binder_proc *proc,
+					   struct binder_thread *thread,
+					   u32 now)
+{
+	struct binder_slow_transaction_log *log = &binder_slow_transaction_log;
+	struct binder_slow_log_entry *e;
+
+	e = &log->entry[log->next];
+	memset(e, 0, sizeof(*e));
+	e->debug_id = t->debug_id;
+	e->from_proc = t->from ? t->from->proc->pid : 0;
+	e->from_thread = t->from ? t->from->pid : 0;
+	e->to_proc = proc->pid;
+	e->to_thread = thread->pid;
+	e->code = t->code;
+	e->queue_usec = t->dequeue_stamp - t->queue_stamp;
+	e->handler_usec = now - t->dequeue_stamp;
+	e->total_usec = now - t->send_stamp;
+	log->next++;
+	if (log->next == ARRAY_SIZE(log->entry)) {
+		log->next = 0;
+		log->full = 1;
+	}
+}
+
 static void
 binder_defer_work(struct binder_proc *proc, enum binder_deferred_state defer);
 
@@ -525,6 +625,16 @@ static size_t binder_buffer_size(struct binder_proc *proc,
 			struct binder_buffer, entry) - (size_t)buffer->data;
 }
 
+static int binder_quick_bin_index(size_t size)
+{
+	int i;
+
+	for (i = 0; i < BINDER_QUICK_BIN_COUNT; i++)
+		if (size <= (1 << (BINDER_QUICK_BIN_SHIFT + i)))
+			return i;
+	return -1;
+}
+
 static void binder_insert_free_buffer(struct binder_proc *proc,
 				      struct binder_buffer *new_buffer)
 {
@@ -615,7 +725,9 @@ static int binder_update_page_range(struct binder_proc *proc, int allocate,
 	unsigned long user_page_addr;
 	struct vm_struct tmp_area;
 	struct page **page;
+	struct page **page_array_ptr;
 	struct mm_struct *mm;
+	int ret;
 
 	binder_debug(BINDER_DEBUG_BUFFER_ALLOC,
 		     "binder: %d: %s pages %p-%p\n", proc->pid,
@@ -643,9 +755,12 @@ static int binder_update_page_range(struct binder_proc *proc, int allocate,
 		goto err_no_vma;
 	}
 
+	/*
+	 * Allocate the whole range up front and map it into the kernel
+	 * with a single map_vm_area() call; mapping page by page makes
+	 * large payloads pay a vmalloc walk and TLB flush per page.
+	 */
 	for (page_addr = start; page_addr < end; page_addr += PAGE_SIZE) {
-		int ret;
-		struct page **page_array_ptr;
 		page = &proc->pages[(page_addr - proc->buffer) / PAGE_SIZE];
 
 		BUG_ON(*page);
@@ -653,18 +768,21 @@ static int binder_update_page_range(struct binder_proc *proc, int allocate,
 		if (*page == NULL) {
 			printk(KERN_ERR "binder: %d: binder_alloc_buf failed "
 			       "for page at %p\n", proc->pid, page_addr);
-			goto err_alloc_page_failed;
-		}
-		tmp_area.addr = page_addr;
-		tmp_area.size = PAGE_SIZE + PAGE_SIZE /* guard page? */;
-		page_array_ptr = page;
-		ret = map_vm_area(&tmp_area, PAGE_KERNEL, &page_array_ptr);
-		if (ret) {
-			printk(KERN_ERR "binder: %d: binder_alloc_buf failed "
-			       "to map page at %p in kernel\n",
-			       proc->pid, page_addr);
-			goto err_map_kernel_failed;
+			goto err_free_pages;
 		}
+	}
+	tmp_area.addr = start;
+	tmp_area.size = end - start + PAGE_SIZE /* guard page? */;
+	page_array_ptr = &proc->pages[(start - proc->buffer) / PAGE_SIZE];
+	ret = map_vm_area(&tmp_area, PAGE_KERNEL, &page_array_ptr);
+	if (ret) {
+		printk(KERN_ERR "binder: %d: binder_alloc_buf failed "
+		       "to map range %p-%p in kernel\n",
+		       proc->pid, start, end);
+		goto err_free_pages;
+	}
+	for (page_addr = start; page_addr < end; page_addr += PAGE_SIZE) {
+		page = &proc->pages[(page_addr - proc->buffer) / PAGE_SIZE];
 		user_page_addr =
 			(uintptr_t)page_addr + proc->user_buffer_offset;
 		ret = vm_insert_page(vma, user_page_addr, page[0]);
@@ -682,20 +800,17 @@ static int binder_update_page_range(struct binder_proc *proc, int allocate,
 	}
 	return 0;
 
-free_range:
-	for (page_addr = end - PAGE_SIZE; page_addr >= start;
-	     page_addr -= PAGE_SIZE) {
-		page = &proc->pages[(page_addr - proc->buffer) / PAGE_SIZE];
-		if (vma)
-			zap_page_range(vma, (uintptr_t)page_addr +
-				proc->user_buffer_offset, PAGE_SIZE, NULL);
 err_vm_insert_page_failed:
-		unmap_kernel_range((unsigned long)page_addr, PAGE_SIZE);
-err_map_kernel_failed:
+	zap_page_range(vma, (uintptr_t)start + proc->user_buffer_offset,
+		       page_addr - start, NULL);
+	unmap_kernel_range((unsigned long)start, end - start);
+err_free_pages:
+	for (page_addr = start; page_addr < end; page_addr += PAGE_SIZE) {
+		page = &proc->pages[(page_addr - proc->buffer) / PAGE_SIZE];
+		if (*page == NULL)
+			break;
 		__free_page(*page);
 		*page = NULL;
-err_alloc_page_failed:
-		;
 	}
 err_no_vma:
 	if (mm) {
@@ -703,6 +818,22 @@ err_no_vma:
 		mmput(mm);
 	}
 	return -ENOMEM;
+
+free_range:
+	if (vma)
+		zap_page_range(vma, (uintptr_t)start +
+			proc->user_buffer_offset, end - start, NULL);
+	unmap_kernel_range((unsigned long)start, end - start);
+	for (page_addr = start; page_addr < end; page_addr += PAGE_SIZE) {
+		page = &proc->pages[(page_addr - proc->buffer) / PAGE_SIZE];
+		__free_page(*page);
+		*page = NULL;
+	}
+	if (mm) {
+		up_write(&mm->mmap_sem);
+		mmput(mm);
+	}
+	return 0;
 }
 
 static struct binder_buffer *binder_alloc_buf(struct binder_proc *proc,
@@ -716,6 +847,7 @@ static struct binder_buffer *binder_alloc_buf(struct binder_proc *proc,
 	void *has_page_addr;
 	void *end_page_addr;
 	size_t size;
+	size_t carve_size;
 
 	if (proc->vma == NULL) {
 		printk(KERN_ERR "binder: %d: binder_alloc_buf, no vma\n",
@@ -740,15 +872,50 @@ static struct binder_buffer *binder_alloc_buf(struct binder_proc *proc,
 		return NULL;
 	}
 
+	/*
+	 * Small requests are rounded up to their size class so that freed
+	 * buffers come back at exactly one of the bin sizes; a bin hit
+	 * recycles a buffer whose pages are still mapped.
+	 */
+	carve_size = size;
+	if (size <= BINDER_QUICK_BIN_MAX) {
+		int bin;
+
+		for (bin = binder_quick_bin_index(size);
+		     bin < BINDER_QUICK_BIN_COUNT; bin++) {
+			if (list_empty(&proc->quick_bin[bin]))
+				continue;
+			buffer = list_first_entry(&proc->quick_bin[bin],
+						  struct binder_buffer,
+						  bin_entry);
+			list_del(&buffer->bin_entry);
+			proc->quick_bin_count[bin]--;
+			binder_insert_allocated_buffer(proc, buffer);
+			binder_debug(BINDER_DEBUG_BUFFER_ALLOC,
+				     "binder: %d: binder_alloc_buf size %zd "
+				     "recycled %p from bin %d\n",
+				     proc->pid, size, buffer, bin);
+			buffer->data_size = data_size;
+			buffer->offsets_size = offsets_size;
+			buffer->async_transaction = is_async;
+			if (is_async)
+				proc->free_async_space -=
+					size + sizeof(struct binder_buffer);
+			return buffer;
+		}
+		carve_size = 1 << (BINDER_QUICK_BIN_SHIFT +
+				   binder_quick_bin_index(size));
+	}
+
 	while (n) {
 		buffer = rb_entry(n, struct binder_buffer, rb_node);
 		BUG_ON(!buffer->free);
 		buffer_size = binder_buffer_size(proc, buffer);
 
-		if (size < buffer_size) {
+		if (carve_size < buffer_size) {
 			best_fit = n;
 			n = n->rb_left;
-		} else if (size > buffer_size)
+		} else if (carve_size > buffer_size)
 			n = n->rb_right;
 		else {
 			best_fit = n;
@@ -772,10 +939,13 @@ static struct binder_buffer *binder_alloc_buf(struct binder_proc *proc,
 	has_page_addr =
 		(void *)(((uintptr_t)buffer->data + buffer_size) & PAGE_MASK);
 	if (n == NULL) {
-		if (size + sizeof(struct binder_buffer) + 4 >= buffer_size)
-			buffer_size = size; /* no room for other buffers */
+		if (carve_size + sizeof(struct binder_buffer) + 4 >=
+		    buffer_size)
+			buffer_size = carve_size; /* no room for other */
+						  /* buffers */
 		else
-			buffer_size = size + sizeof(struct binder_buffer);
+			buffer_size = carve_size +
+				sizeof(struct binder_buffer);
 	}
 	end_page_addr =
 		(void *)PAGE_ALIGN((uintptr_t)buffer->data + buffer_size);
@@ -788,8 +958,9 @@ static struct binder_buffer *binder_alloc_buf(struct binder_proc *proc,
 	rb_erase(best_fit, &proc->free_buffers);
 	buffer->free = 0;
 	binder_insert_allocated_buffer(proc, buffer);
-	if (buffer_size != size) {
-		struct binder_buffer *new_buffer = (void *)buffer->data + size;
+	if (buffer_size != carve_size) {
+		struct binder_buffer *new_buffer =
+			(void *)buffer->data + carve_size;
 		list_add(&new_buffer->entry, &buffer->entry);
 		new_buffer->free = 1;
 		binder_insert_free_buffer(proc, new_buffer);
@@ -869,6 +1040,38 @@ static void binder_delete_free_buffer(struct binder_proc *proc,
 	}
 }
 
+static void binder_release_buf(struct binder_proc *proc,
+			       struct binder_buffer *buffer)
+{
+	size_t buffer_size;
+
+	buffer_size = binder_buffer_size(proc, buffer);
+
+	binder_update_page_range(proc, 0,
+		(void *)PAGE_ALIGN((uintptr_t)buffer->data),
+		(void *)(((uintptr_t)buffer->data + buffer_size) & PAGE_MASK),
+		NULL);
+	buffer->free = 1;
+	if (!list_is_last(&buffer->entry, &proc->buffers)) {
+		struct binder_buffer *next = list_entry(buffer->entry.next,
+						struct binder_buffer, entry);
+		if (next->free) {
+			rb_erase(&next->rb_node, &proc->free_buffers);
+			binder_delete_free_buffer(proc, next);
+		}
+	}
+	if (proc->buffers.next != &buffer->entry) {
+		struct binder_buffer *prev = list_entry(buffer->entry.prev,
+						struct binder_buffer, entry);
+		if (prev->free) {
+			binder_delete_free_buffer(proc, buffer);
+			rb_erase(&prev->rb_node, &proc->free_buffers);
+			buffer = prev;
+		}
+	}
+	binder_insert_free_buffer(proc, buffer);
+}
+
 static void binder_free_buf(struct binder_proc *proc,
 			    struct binder_buffer *buffer)
 {
@@ -898,30 +1101,43 @@ static void binder_free_buf(struct binder_proc *proc,
 			     proc->free_async_space);
 	}
 
-	binder_update_page_range(proc, 0,
-		(void *)PAGE_ALIGN((uintptr_t)buffer->data),
-		(void *)(((uintptr_t)buffer->data + buffer_size) & PAGE_MASK),
-		NULL);
 	rb_erase(&buffer->rb_node, &proc->allocated_buffers);
-	buffer->free = 1;
-	if (!list_is_last(&buffer->entry, &proc->buffers)) {
-		struct binder_buffer *next = list_entry(buffer->entry.next,
-						struct binder_buffer, entry);
-		if (next->free) {
-			rb_erase(&next->rb_node, &proc->free_buffers);
-			binder_delete_free_buffer(proc, next);
+
+	if (buffer_size <= BINDER_QUICK_BIN_MAX &&
+	    buffer_size >= (1 << BINDER_QUICK_BIN_SHIFT) &&
+	    (buffer_size & (buffer_size - 1)) == 0) {
+		int bin = binder_quick_bin_index(buffer_size);
+
+		if (proc->quick_bin_count[bin] < BINDER_QUICK_BIN_DEPTH) {
+			buffer->async_transaction = 0;
+			list_add(&buffer->bin_entry, &proc->quick_bin[bin]);
+			proc->quick_bin_count[bin]++;
+			binder_debug(BINDER_DEBUG_BUFFER_ALLOC,
+				     "binder: %d: binder_free_buf %p "
+				     "cached in bin %d\n",
+				     proc->pid, buffer, bin);
+			return;
 		}
 	}
-	if (proc->buffers.next != &buffer->entry) {
-		struct binder_buffer *prev = list_entry(buffer->entry.prev,
-						struct binder_buffer, entry);
-		if (prev->free) {
-			binder_delete_free_buffer(proc, buffer);
-			rb_erase(&prev->rb_node, &proc->free_buffers);
-			buffer = prev;
+
+	binder_release_buf(proc, buffer);
+}
+
+static void binder_drain_quick_bins(struct binder_proc *proc)
+{
+	int bin;
+
+	for (bin = 0; bin < BINDER_QUICK_BIN_COUNT; bin++) {
+		while (!list_empty(&proc->quick_bin[bin])) {
+			struct binder_buffer *buffer =
+				list_first_entry(&proc->quick_bin[bin],
+						 struct binder_buffer,
+						 bin_entry);
+			list_del(&buffer->bin_entry);
+			proc->quick_bin_count[bin]--;
+			binder_release_buf(proc, buffer);
 		}
 	}
-	binder_insert_free_buffer(proc, buffer);
 }
 
 static struct binder_node *binder_get_node(struct binder_proc *proc,
@@ -1391,6 +1607,8 @@ static void binder_transaction(struct binder_proc *proc,
 	struct binder_transaction *in_reply_to = NULL;
 	struct binder_transaction_log_entry *e;
 	uint32_t return_error;
+	int drop_lock;
+	int copy_failed = 0;
 
 	e = binder_transaction_log_add(&binder_transaction_log);
 	e->call_type = reply ? 2 : !!(tr->flags & TF_ONE_WAY);
@@ -1494,7 +1712,15 @@ static void binder_transaction(struct binder_proc *proc,
 		target_list = &target_thread->todo;
 		target_wait = &target_thread->wait;
 	} else {
-		target_list = &target_proc->todo;
+		/*
+		 * One-way transactions go to a separate lane so that a
+		 * flood of async work cannot delay synchronous calls;
+		 * readers always drain proc->todo first.
+		 */
+		if (!reply && (tr->flags & TF_ONE_WAY))
+			target_list = &target_proc->todo_async;
+		else
+			target_list = &target_proc->todo;
 		target_wait = &target_proc->wait;
 	}
 	e->to_proc = target_proc->pid;
@@ -1516,6 +1742,10 @@ static void binder_transaction(struct binder_proc *proc,
 
 	t->debug_id = ++binder_last_id;
 	e->debug_id = t->debug_id;
+	t->send_stamp = binder_stamp();
+	trace_binder_transaction_send(t->debug_id, reply,
+				      !!(tr->flags & TF_ONE_WAY),
+				      target_proc->pid);
 
 	if (reply)
 		binder_debug(BINDER_DEBUG_TRANSACTION,
@@ -1559,18 +1789,35 @@ static void binder_transaction(struct binder_proc *proc,
 
 	offp = (size_t *)(t->buffer->data + ALIGN(tr->data_size, sizeof(void *)));
 
+	/*
+	 * The payload copy is the longest part of a transaction and needs
+	 * no binder state, so run it without binder_lock when we hold no
+	 * target thread pointer across it. copies_in_flight delays the
+	 * target's deferred release so target_proc and t->buffer stay
+	 * valid; target_node is pinned by the binder_inc_node above.
+	 */
+	drop_lock = target_thread == NULL;
+	if (drop_lock) {
+		target_proc->copies_in_flight++;
+		mutex_unlock(&binder_lock);
+	}
 	if (copy_from_user(t->buffer->data, tr->data.ptr.buffer, tr->data_size)) {
 		binder_user_error("binder: %d:%d got transaction with invalid "
 			"data ptr\n", proc->pid, thread->pid);
 		return_error = BR_FAILED_REPLY;
-		goto err_copy_data_failed;
-	}
-	if (copy_from_user(offp, tr->data.ptr.offsets, tr->offsets_size)) {
+		copy_failed = 1;
+	} else if (copy_from_user(offp, tr->data.ptr.offsets, tr->offsets_size)) {
 		binder_user_error("binder: %d:%d got transaction with invalid "
 			"offsets ptr\n", proc->pid, thread->pid);
 		return_error = BR_FAILED_REPLY;
-		goto err_copy_data_failed;
+		copy_failed = 1;
+	}
+	if (drop_lock) {
+		mutex_lock(&binder_lock);
+		target_proc->copies_in_flight--;
 	}
+	if (copy_failed)
+		goto err_copy_data_failed;
 	if (!IS_ALIGNED(tr->offsets_size, sizeof(size_t))) {
 		binder_user_error("binder: %d:%d got transaction with "
 			"invalid offsets size, %zd\n",
@@ -1718,7 +1965,18 @@ static void binder_transaction(struct binder_proc *proc,
 		}
 	}
 	if (reply) {
+		u32 now = binder_stamp();
+
 		BUG_ON(t->buffer->async_transaction != 0);
+		trace_binder_transaction_reply(in_reply_to->debug_id,
+			in_reply_to->dequeue_stamp - in_reply_to->queue_stamp,
+			now - in_reply_to->dequeue_stamp,
+			now - in_reply_to->send_stamp);
+		if (binder_slow_transaction_usecs &&
+		    now - in_reply_to->send_stamp >
+		    binder_slow_transaction_usecs)
+			binder_slow_transaction_record(in_reply_to, proc,
+						       thread, now);
 		binder_pop_transaction(target_thread, in_reply_to);
 	} else if (!(t->flags & TF_ONE_WAY)) {
 		BUG_ON(t->buffer->async_transaction != 0);
@@ -1731,10 +1989,20 @@ static void binder_transaction(struct binder_proc *proc,
 		if (target_node->has_async_transaction) {
 			target_list = &target_node->async_todo;
 			target_wait = NULL;
+			target_node->async_queued++;
+			if (target_node->async_queued > BINDER_NODE_ASYNC_BUDGET)
+				binder_debug(BINDER_DEBUG_TRANSACTION,
+					     "binder: %d:%d node %d async "
+					     "backlog %d over budget\n",
+					     proc->pid, thread->pid,
+					     target_node->debug_id,
+					     target_node->async_queued);
 		} else
 			target_node->has_async_transaction = 1;
 	}
 	t->work.type = BINDER_WORK_TRANSACTION;
+	t->queue_stamp = binder_stamp();
+	trace_binder_transaction_enqueue(t->debug_id, target_proc->pid);
 	list_add_tail(&t->work.entry, target_list);
 	tcomplete->type = BINDER_WORK_TRANSACTION_COMPLETE;
 	list_add_tail(&tcomplete->entry, &thread->todo);
@@ -1962,8 +2230,10 @@ int binder_thread_write(struct binder_proc *proc, struct binder_thread *thread,
 				BUG_ON(!buffer->target_node->has_async_transaction);
 				if (list_empty(&buffer->target_node->async_todo))
 					buffer->target_node->has_async_transaction = 0;
-				else
+				else {
 					list_move_tail(buffer->target_node->async_todo.next, &thread->todo);
+					buffer->target_node->async_queued--;
+				}
 			}
 			binder_transaction_buffer_release(proc, buffer, NULL);
 			binder_free_buf(proc, buffer);
@@ -2183,7 +2453,7 @@ void binder_stat_br(struct binder_proc *proc, struct binder_thread *thread,
 static int binder_has_proc_work(struct binder_proc *proc,
 				struct binder_thread *thread)
 {
-	return !list_empty(&proc->todo) ||
+	return !list_empty(&proc->todo) || !list_empty(&proc->todo_async) ||
 		(thread->looper & BINDER_LOOPER_STATE_NEED_RETURN);
 }
 
@@ -2276,6 +2546,8 @@ retry:
 			w = list_first_entry(&thread->todo, struct binder_work, entry);
 		else if (!list_empty(&proc->todo) && wait_for_proc_work)
 			w = list_first_entry(&proc->todo, struct binder_work, entry);
+		else if (!list_empty(&proc->todo_async) && wait_for_proc_work)
+			w = list_first_entry(&proc->todo_async, struct binder_work, entry);
 		else {
 			if (ptr - buffer == 4 && !(thread->looper & BINDER_LOOPER_STATE_NEED_RETURN)) /* no data added */
 				goto retry;
@@ -2460,6 +2732,9 @@ retry:
 			     t->buffer->data_size, t->buffer->offsets_size,
 			     tr.data.ptr.buffer, tr.data.ptr.offsets);
 
+		t->dequeue_stamp = binder_stamp();
+		trace_binder_transaction_dequeue(t->debug_id,
+				t->dequeue_stamp - t->queue_stamp);
 		list_del(&t->work.entry);
 		t->buffer->allow_user_free = 1;
 		if (cmd == BR_TRANSACTION && !(t->flags & TF_ONE_WAY)) {
@@ -2875,6 +3150,7 @@ err_bad_arg:
 static int binder_open(struct inode *nodp, struct file *filp)
 {
 	struct binder_proc *proc;
+	int i;
 
 	binder_debug(BINDER_DEBUG_OPEN_CLOSE, "binder_open: %d:%d\n",
 		     current->group_leader->pid, current->pid);
@@ -2884,7 +3160,10 @@ static int binder_open(struct inode *nodp, struct file *filp)
 		return -ENOMEM;
 	get_task_struct(current);
 	proc->tsk = current;
+	for (i = 0; i < BINDER_QUICK_BIN_COUNT; i++)
+		INIT_LIST_HEAD(&proc->quick_bin[i]);
 	INIT_LIST_HEAD(&proc->todo);
+	INIT_LIST_HEAD(&proc->todo_async);
 	init_waitqueue_head(&proc->wait);
 	proc->default_priority = task_nice(current);
 	mutex_lock(&binder_lock);
@@ -3013,8 +3292,10 @@ static void binder_deferred_release(struct binder_proc *proc)
 		binder_delete_ref(ref);
 	}
 	binder_release_work(&proc->todo);
+	binder_release_work(&proc->todo_async);
 	buffers = 0;
 
+	binder_drain_quick_bins(proc);
 	while ((n = rb_first(&proc->allocated_buffers))) {
 		struct binder_buffer *buffer = rb_entry(n, struct binder_buffer,
 							rb_node);
@@ -3097,8 +3378,15 @@ static void binder_deferred_func(struct work_struct *work)
 		if (defer & BINDER_DEFERRED_FLUSH)
 			binder_deferred_flush(proc);
 
-		if (defer & BINDER_DEFERRED_RELEASE)
-			binder_deferred_release(proc); /* frees proc */
+		if (defer & BINDER_DEFERRED_RELEASE) {
+			if (proc->copies_in_flight)
+				/* a sender is copying a payload into this
+				   proc without binder_lock, try again */
+				binder_defer_work(proc,
+						  BINDER_DEFERRED_RELEASE);
+			else
+				binder_deferred_release(proc); /* frees proc */
+		}
 
 		mutex_unlock(&binder_lock);
 		if (files)
@@ -3286,6 +3574,8 @@ static void print_binder_proc(struct seq_file *m,
 				    rb_entry(n, struct binder_buffer, rb_node));
 	list_for_each_entry(w, &proc->todo, entry)
 		print_binder_work(m, "  ", "  pending transaction", w);
+	list_for_each_entry(w, &proc->todo_async, entry)
+		print_binder_work(m, "  ", "  pending async transaction", w);
 	list_for_each_entry(w, &proc->delivered_death, entry) {
 		seq_puts(m, "  has delivered dead binder\n");
 		break;
@@ -3429,6 +3719,18 @@ static void print_binder_proc_stats(struct seq_file *m,
 	}
 	seq_printf(m, "  pending transactions: %d\n", count);
 
+	count = 0;
+	list_for_each_entry(w, &proc->todo_async, entry) {
+		switch (w->type) {
+		case BINDER_WORK_TRANSACTION:
+			count++;
+			break;
+		default:
+			break;
+		}
+	}
+	seq_printf(m, "  pending async transactions: %d\n", count);
+
 	print_binder_stats(m, "  ", &proc->stats);
 }
 
@@ -3533,6 +3835,30 @@ static int binder_transaction_log_show(struct seq_file *m, void *unused)
 	return 0;
 }
 
+static void print_binder_slow_log_entry(struct seq_file *m,
+					struct binder_slow_log_entry *e)
+{
+	seq_printf(m,
+		   "%d: from %d:%d to %d:%d code %x queue %u handler %u total %u\n",
+		   e->debug_id, e->from_proc, e->from_thread, e->to_proc,
+		   e->to_thread, e->code, e->queue_usec, e->handler_usec,
+		   e->total_usec);
+}
+
+static int binder_slow_transaction_log_show(struct seq_file *m, void *unused)
+{
+	struct binder_slow_transaction_log *log = m->private;
+	int i;
+
+	if (log->full) {
+		for (i = log->next; i < ARRAY_SIZE(log->entry); i++)
+			print_binder_slow_log_entry(m, &log->entry[i]);
+	}
+	for (i = 0; i < log->next; i++)
+		print_binder_slow_log_entry(m, &log->entry[i]);
+	return 0;
+}
+
 static const struct file_operations binder_fops = {
 	.owner = THIS_MODULE,
 	.poll = binder_poll,
@@ -3553,6 +3879,7 @@ BINDER_DEBUG_ENTRY(state);
 BINDER_DEBUG_ENTRY(stats);
 BINDER_DEBUG_ENTRY(transactions);
 BINDER_DEBUG_ENTRY(transaction_log);
+BINDER_DEBUG_ENTRY(slow_transaction_log);
 
 static int __init binder_init(void)
 {
@@ -3593,6 +3920,11 @@ static int __init binder_init(void)
 				    binder_debugfs_dir_entry_root,
 				    &binder_transaction_log_failed,
 				    &binder_transaction_log_fops);
+		debugfs_create_file("slow_transaction_log",
+				    S_IRUGO,
+				    binder_debugfs_dir_entry_root,
+				    &binder_slow_transaction_log,
+				    &binder_slow_transaction_log_fops);
 	}
 	return ret;
 }
@@ -0,0 +1,114 @@
+/* drivers/staging/android/binder_trace.h
+ *
+ * Copyright (C) 2010 Google, Inc.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM binder
+
+#if !defined(_BINDER_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _BINDER_TRACE_H
+
+#include <linux/tracepoint.h>
+
+/*
+ * The four events below bracket the life of a transaction: sender
+ * builds it (send), it lands on the target's todo list (enqueue), a
+ * target thread picks it up (dequeue) and the handler answers (reply).
+ * debug_id matches the ids in /sys/kernel/debug/binder/* so trace
+ * output can be correlated with the transaction logs. The *_usec
+ * values are in units of 1.024us (sched_clock() >> 10).
+ */
+
+TRACE_EVENT(binder_transaction_send,
+	TP_PROTO(int debug_id, int reply, int one_way, int to_proc),
+	TP_ARGS(debug_id, reply, one_way, to_proc),
+
+	TP_STRUCT__entry(
+		__field(int, debug_id)
+		__field(int, reply)
+		__field(int, one_way)
+		__field(int, to_proc)
+	),
+	TP_fast_assign(
+		__entry->debug_id = debug_id;
+		__entry->reply = reply;
+		__entry->one_way = one_way;
+		__entry->to_proc = to_proc;
+	),
+	TP_printk("transaction=%d reply=%d one_way=%d to_proc=%d",
+		  __entry->debug_id, __entry->reply, __entry->one_way,
+		  __entry->to_proc)
+);
+
+TRACE_EVENT(binder_transaction_enqueue,
+	TP_PROTO(int debug_id, int to_proc),
+	TP_ARGS(debug_id, to_proc),
+
+	TP_STRUCT__entry(
+		__field(int, debug_id)
+		__field(int, to_proc)
+	),
+	TP_fast_assign(
+		__entry->debug_id = debug_id;
+		__entry->to_proc = to_proc;
+	),
+	TP_printk("transaction=%d to_proc=%d",
+		  __entry->debug_id, __entry->to_proc)
+);
+
+TRACE_EVENT(binder_transaction_dequeue,
+	TP_PROTO(int debug_id, u32 queue_usec),
+	TP_ARGS(debug_id, queue_usec),
+
+	TP_STRUCT__entry(
+		__field(int, debug_id)
+		__field(u32, queue_usec)
+	),
+	TP_fast_assign(
+		__entry->debug_id = debug_id;
+		__entry->queue_usec = queue_usec;
+	),
+	TP_printk("transaction=%d queue_usec=%u",
+		  __entry->debug_id, __entry->queue_usec)
+);
+
+TRACE_EVENT(binder_transaction_reply,
+	TP_PROTO(int debug_id, u32 queue_usec, u32 handler_usec,
+		 u32 total_usec),
+	TP_ARGS(debug_id, queue_usec, handler_usec, total_usec),
+
+	TP_STRUCT__entry(
+		__field(int, debug_id)
+		__field(u32, queue_usec)
+		__field(u32, handler_usec)
+		__field(u32, total_usec)
+	),
+	TP_fast_assign(
+		__entry->debug_id = debug_id;
+		__entry->queue_usec = queue_usec;
+		__entry->handler_usec = handler_usec;
+		__entry->total_usec = total_usec;
+	),
+	TP_printk("transaction=%d queue_usec=%u handler_usec=%u total_usec=%u",
+		  __entry->debug_id, __entry->queue_usec,
+		  __entry->handler_usec, __entry->total_usec)
+);
+
+#endif /* _BINDER_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_PATH .
+#define TRACE_INCLUDE_FILE binder_trace
+#include <trace/define_trace.h>
@@ -0,0 +1,195 @@
+/* drivers/staging/android/flight_recorder.c
+ *
+ * Copyright (C) 2010 Google, Inc.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * Always-on flight recorder: records scheduler switches, IRQ
+ * entry/exit and driver-defined marker events as compact binary
+ * records in a small ring. On panic the ring is LZO-compressed and
+ * appended to the ram console region, so field crashes come back with
+ * the last seconds of scheduling context attached to /proc/last_kmsg.
+ * This is far cheaper than enabling ftrace on production builds and
+ * needs no live system for extraction.
+ */
+
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/kernel.h>
+#include <linux/spinlock.h>
+#include <linux/notifier.h>
+#include <linux/sched.h>
+#include <linux/interrupt.h>
+#include <linux/lzo.h>
+#include <trace/events/sched.h>
+#include <trace/events/irq.h>
+
+#include "flight_recorder.h"
+
+enum {
+	FLIGHT_EV_SCHED_SWITCH = 1,
+	FLIGHT_EV_IRQ_ENTRY,
+	FLIGHT_EV_IRQ_EXIT,
+	FLIGHT_EV_CUSTOM,
+};
+
+/* Fixed 12-byte records. Timestamps are sched_clock() >> 10, i.e.
+ * units of 1.024us, wrapping every ~73 minutes - plenty of range for
+ * the window around a panic and much cheaper than a 64-bit division
+ * on every scheduler switch. */
+struct flight_event {
+	uint32_t tstamp;
+	uint16_t type;
+	uint16_t arg1;
+	uint32_t arg2;
+} __attribute__((packed));
+
+#define FLIGHT_RING_EVENTS	2048	/* must be a power of 2, 24K ring */
+
+static struct flight_event flight_ring[FLIGHT_RING_EVENTS];
+static unsigned int flight_head;
+static int flight_stopped;
+static DEFINE_SPINLOCK(flight_lock);
+
+static void flight_record(u16 type, u16 arg1, u32 arg2)
+{
+	struct flight_event *ev;
+	unsigned long flags;
+
+	if (flight_stopped)
+		return;
+	spin_lock_irqsave(&flight_lock, flags);
+	ev = &flight_ring[flight_head & (FLIGHT_RING_EVENTS - 1)];
+	flight_head++;
+	ev->tstamp = (uint32_t)(sched_clock() >> 10);
+	ev->type = type;
+	ev->arg1 = arg1;
+	ev->arg2 = arg2;
+	spin_unlock_irqrestore(&flight_lock, flags);
+}
+
+void flight_recorder_event(u16 code, u32 value)
+{
+	flight_record(FLIGHT_EV_CUSTOM, code, value);
+}
+EXPORT_SYMBOL_GPL(flight_recorder_event);
+
+static void probe_sched_switch(void *ignore, struct task_struct *prev,
+			       struct task_struct *next)
+{
+	flight_record(FLIGHT_EV_SCHED_SWITCH, prev->pid,
+		      ((u32)(prev->state & 0xff) << 16) | (u16)next->pid);
+}
+
+static void probe_irq_entry(void *ignore, int irq, struct irqaction *action)
+{
+	flight_record(FLIGHT_EV_IRQ_ENTRY, irq, 0);
+}
+
+static void probe_irq_exit(void *ignore, int irq, struct irqaction *action,
+			   int ret)
+{
+	flight_record(FLIGHT_EV_IRQ_EXIT, irq, ret);
+}
+
+/*
+ * Panic dump. The compressed snapshot is framed with a magic so the
+ * extraction tool can locate it inside /proc/last_kmsg; hdr.head is
+ * the ring index one past the newest record.
+ */
+#define FLIGHT_DUMP_MAGIC	0x43524C46	/* "FLRC" */
+
+struct flight_dump_hdr {
+	uint32_t magic;
+	uint32_t ulen;		/* uncompressed ring size */
+	uint32_t clen;		/* compressed payload length */
+	uint32_t head;
+} __attribute__((packed));
+
+static uint8_t flight_cbuf[sizeof(struct flight_dump_hdr) +
+			   lzo1x_worst_compress(sizeof(flight_ring))];
+static uint8_t flight_lzo_wmem[LZO1X_1_MEM_COMPRESS];
+static size_t flight_dump_len;
+
+/* drivers/staging/android/ram_console.c */
+extern void ram_console_append_blob(const void *data, size_t count);
+
+/* Stop recording and build the framed, compressed snapshot in
+ * flight_cbuf.  Several consumers may ask for it during one panic
+ * (ram console, apanic), so the result is built once and cached.
+ */
+static size_t flight_build_dump(void)
+{
+	struct flight_dump_hdr *hdr = (struct flight_dump_hdr *)flight_cbuf;
+	size_t clen;
+
+	if (flight_dump_len)
+		return flight_dump_len;
+	flight_stopped = 1;
+	if (lzo1x_1_compress((void *)flight_ring, sizeof(flight_ring),
+			     flight_cbuf + sizeof(*hdr), &clen,
+			     flight_lzo_wmem) != LZO_E_OK)
+		return 0;
+	hdr->magic = FLIGHT_DUMP_MAGIC;
+	hdr->ulen = sizeof(flight_ring);
+	hdr->clen = clen;
+	hdr->head = flight_head;
+	flight_dump_len = sizeof(*hdr) + clen;
+	return flight_dump_len;
+}
+
+size_t flight_recorder_get_dump(const void **buf)
+{
+	*buf = flight_cbuf;
+	return flight_build_dump();
+}
+
+static int flight_panic_handler(struct notifier_block *this,
+				unsigned long event, void *ptr)
+{
+	size_t len = flight_build_dump();
+
+	if (len)
+		ram_console_append_blob(flight_cbuf, len);
+	return NOTIFY_DONE;
+}
+
+static struct notifier_block flight_panic_block = {
+	.notifier_call = flight_panic_handler,
+};
+
+static int __init flight_recorder_init(void)
+{
+	int ret;
+
+	ret = register_trace_sched_switch(probe_sched_switch, NULL);
+	if (ret)
+		goto err_sched;
+	ret = register_trace_irq_handler_entry(probe_irq_entry, NULL);
+	if (ret)
+		goto err_irq_entry;
+	ret = register_trace_irq_handler_exit(probe_irq_exit, NULL);
+	if (ret)
+		goto err_irq_exit;
+
+	atomic_notifier_chain_register(&panic_notifier_list,
+				       &flight_panic_block);
+	return 0;
+
+err_irq_exit:
+	unregister_trace_irq_handler_entry(probe_irq_entry, NULL);
+err_irq_entry:
+	unregister_trace_sched_switch(probe_sched_switch, NULL);
+err_sched:
+	printk(KERN_ERR "flight_recorder: failed to register probes, %d\n",
+	       ret);
+	return ret;
+}
+late_initcall(flight_recorder_init);
@@ -0,0 +1,37 @@
+/* drivers/staging/android/flight_recorder.h
+ *
+ * Copyright (C) 2010 Google, Inc.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#ifndef _LINUX_FLIGHT_RECORDER_H
+#define _LINUX_FLIGHT_RECORDER_H
+
+#include <linux/types.h>
+
+#ifdef CONFIG_ANDROID_FLIGHT_RECORDER
+/* Drop a driver-defined marker event into the flight recorder ring.
+ * Safe from any context, including interrupts. */
+void flight_recorder_event(u16 code, u32 value);
+
+/* Stop recording and return the framed, compressed panic snapshot of
+ * the ring.  Panic context only; the returned buffer stays valid. */
+size_t flight_recorder_get_dump(const void **buf);
+#else
+static inline void flight_recorder_event(u16 code, u32 value) {}
+static inline size_t flight_recorder_get_dump(const void **buf)
+{
+	return 0;
+}
+#endif
+
+#endif /* _LINUX_FLIGHT_RECORDER_H */
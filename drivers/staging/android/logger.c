@@ -23,10 +23,13 @@
 #include <linux/miscdevice.h>
 #include <linux/uaccess.h>
 #include <linux/poll.h>
+#include <linux/mm.h>
 #include <linux/slab.h>
 #include <linux/time.h>
+#include <linux/timer.h>
 #include "logger.h"
 
+#include <asm/io.h>
 #include <asm/ioctls.h>
 
 /*
@@ -45,8 +48,27 @@ struct logger_log {
 	size_t			w_off;	/* current write head offset */
 	size_t			head;	/* new readers start here */
 	size_t			size;	/* size of the log */
+	size_t			bytes_pending; /* written since last wakeup */
+	struct timer_list	wake_timer; /* bounds wakeup batching delay */
 };
 
+/*
+ * Wakeup batching: rather than waking readers on every entry, wait until
+ * wake_batch_bytes have accumulated or wake_delay_ms have passed. Chatty
+ * writers then cost one wakeup per batch instead of one per write. Zero
+ * (the default) keeps the historical wakeup-per-write behavior.
+ */
+static unsigned int logger_wake_bytes;
+static unsigned int logger_wake_delay = 20;
+
+static void logger_wake_timer_fn(unsigned long data)
+{
+	struct logger_log *log = (struct logger_log *)data;
+
+	log->bytes_pending = 0;
+	wake_up_interruptible(&log->wq);
+}
+
 /*
  * struct logger_reader - a logging device open for reading
  *
@@ -329,6 +351,7 @@ ssize_t logger_aio_write(struct kiocb *iocb, const struct iovec *iov,
 	struct logger_entry header;
 	struct timespec now;
 	ssize_t ret = 0;
+	int do_wake = 1;
 
 	now = current_kernel_time();
 
@@ -373,10 +396,22 @@ ssize_t logger_aio_write(struct kiocb *iocb, const struct iovec *iov,
 		ret += nr;
 	}
 
+	if (logger_wake_bytes) {
+		log->bytes_pending += sizeof(struct logger_entry) + ret;
+		if (log->bytes_pending >= logger_wake_bytes)
+			log->bytes_pending = 0;
+		else
+			do_wake = 0;
+	}
+
 	mutex_unlock(&log->mutex);
 
-	/* wake up any blocked readers */
-	wake_up_interruptible(&log->wq);
+	/* wake up any blocked readers, batching wakeups if so configured */
+	if (do_wake)
+		wake_up_interruptible(&log->wq);
+	else if (!timer_pending(&log->wake_timer))
+		mod_timer(&log->wake_timer,
+			  jiffies + msecs_to_jiffies(logger_wake_delay));
 
 	return ret;
 }
@@ -473,6 +508,33 @@ static unsigned int logger_poll(struct file *file, poll_table *wait)
 	return ret;
 }
 
+/*
+ * logger_mmap - map the ring buffer read-only into a reader
+ *
+ * Together with LOGGER_GET_READ_OFF/LOGGER_SET_READ_OFF this lets a
+ * reader parse entries straight out of the ring without the per-entry
+ * copy_to_user() in read(). The mapping is strictly read-only; writes
+ * still go through write() and the log mutex.
+ */
+static int logger_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct logger_log *log = file_get_log(file);
+
+	if (!(file->f_mode & FMODE_READ))
+		return -EPERM;
+
+	if (vma->vm_pgoff || vma->vm_end - vma->vm_start != log->size)
+		return -EINVAL;
+
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	return remap_pfn_range(vma, vma->vm_start,
+			       virt_to_phys(log->buffer) >> PAGE_SHIFT,
+			       log->size, vma->vm_page_prot);
+}
+
 static long logger_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
 {
 	struct logger_log *log = file_get_log(file);
@@ -517,6 +579,27 @@ static long logger_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
 		log->head = log->w_off;
 		ret = 0;
 		break;
+	case LOGGER_GET_READ_OFF:
+		if (!(file->f_mode & FMODE_READ)) {
+			ret = -EBADF;
+			break;
+		}
+		reader = file->private_data;
+		ret = reader->r_off;
+		break;
+	case LOGGER_SET_READ_OFF:
+		if (!(file->f_mode & FMODE_READ)) {
+			ret = -EBADF;
+			break;
+		}
+		if (arg >= log->size) {
+			ret = -EINVAL;
+			break;
+		}
+		reader = file->private_data;
+		reader->r_off = arg;
+		ret = 0;
+		break;
 	}
 
 	mutex_unlock(&log->mutex);
@@ -529,6 +612,7 @@ static const struct file_operations logger_fops = {
 	.read = logger_read,
 	.aio_write = logger_aio_write,
 	.poll = logger_poll,
+	.mmap = logger_mmap,
 	.unlocked_ioctl = logger_ioctl,
 	.compat_ioctl = logger_ioctl,
 	.open = logger_open,
@@ -541,7 +625,7 @@ static const struct file_operations logger_fops = {
  * LONG_MAX minus LOGGER_ENTRY_MAX_LEN.
  */
 #define DEFINE_LOGGER_DEVICE(VAR, NAME, SIZE) \
-static unsigned char _buf_ ## VAR[SIZE]; \
+static unsigned char _buf_ ## VAR[SIZE] __aligned(PAGE_SIZE); \
 static struct logger_log VAR = { \
 	.buffer = _buf_ ## VAR, \
 	.misc = { \
@@ -580,6 +664,9 @@ static int __init init_log(struct logger_log *log)
 {
 	int ret;
 
+	setup_timer(&log->wake_timer, logger_wake_timer_fn,
+		    (unsigned long)log);
+
 	ret = misc_register(&log->misc);
 	if (unlikely(ret)) {
 		printk(KERN_ERR "logger: failed to register misc "
@@ -616,4 +703,8 @@ static int __init logger_init(void)
 out:
 	return ret;
 }
+module_param_named(wake_batch_bytes, logger_wake_bytes, uint,
+		   S_IRUGO | S_IWUSR);
+module_param_named(wake_delay_ms, logger_wake_delay, uint, S_IRUGO | S_IWUSR);
+
 device_initcall(logger_init);
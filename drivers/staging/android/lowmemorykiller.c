@@ -31,10 +31,12 @@
 
 #include <linux/module.h>
 #include <linux/kernel.h>
+#include <linux/jiffies.h>
 #include <linux/mm.h>
 #include <linux/oom.h>
 #include <linux/sched.h>
 #include <linux/notifier.h>
+#include <linux/compaction.h>
 
 static uint32_t lowmem_debug_level = 2;
 static int lowmem_adj[6] = {
@@ -53,8 +55,20 @@ static size_t lowmem_minfree[6] = {
 static int lowmem_minfree_size = 4;
 
 static struct task_struct *lowmem_deathpending;
+static unsigned long lowmem_deathpending_timeout;
 static DEFINE_SPINLOCK(lowmem_deathpending_lock);
 
+/*
+ * Verdict cache for the tasklist walk. A walk that found no victim at a
+ * given threshold cannot find one at a stricter (higher) threshold
+ * either, so remember that verdict briefly and spare back-to-back
+ * shrinker calls from direct reclaim the full walk.
+ */
+#define LOWMEM_VERDICT_TTL	(HZ / 4)
+static int lowmem_no_victim_valid;
+static int lowmem_no_victim_adj;
+static unsigned long lowmem_no_victim_stamp;
+
 #define lowmem_print(level, x...)			\
 	do {						\
 		if (lowmem_debug_level >= (level))	\
@@ -110,10 +124,13 @@ static int lowmem_shrink(struct shrinker *s, int nr_to_scan, gfp_t gfp_mask)
 	 * If we already have a death outstanding, then
 	 * bail out right away; indicating to vmscan
 	 * that we have nothing further to offer on
-	 * this pass.
+	 * this pass. The kill itself is asynchronous; we only wait for
+	 * the victim's memory to come back, and not forever: a victim
+	 * stuck in uninterruptible sleep must not block further kills.
 	 *
 	 */
-	if (lowmem_deathpending)
+	if (lowmem_deathpending &&
+	    time_before_eq(jiffies, lowmem_deathpending_timeout))
 		return 0;
 
 	if (lowmem_adj_size < array_size)
@@ -126,6 +143,15 @@ static int lowmem_shrink(struct shrinker *s, int nr_to_scan, gfp_t gfp_mask)
 			break;
 		}
 	}
+
+	/*
+	 * We are below at least one of the minfree watermarks, so the
+	 * system is about to start killing for memory. Have background
+	 * compaction pre-produce high-order pages now, before a pmem or
+	 * kgsl allocation has to compact synchronously.
+	 */
+	if (min_adj != OOM_ADJUST_MAX + 1)
+		wake_compaction();
 	if (nr_to_scan > 0)
 		lowmem_print(3, "lowmem_shrink %d, %x, ofree %d %d, ma %d\n",
 			     nr_to_scan, gfp_mask, other_free, other_file,
@@ -141,6 +167,14 @@ static int lowmem_shrink(struct shrinker *s, int nr_to_scan, gfp_t gfp_mask)
 	}
 	selected_oom_adj = min_adj;
 
+	if (lowmem_no_victim_valid && min_adj >= lowmem_no_victim_adj &&
+	    time_before(jiffies,
+			lowmem_no_victim_stamp + LOWMEM_VERDICT_TTL)) {
+		lowmem_print(5, "lowmem_shrink %d, %x, cached no victim, "
+			     "return %d\n", nr_to_scan, gfp_mask, rem);
+		return rem;
+	}
+
 	read_lock(&tasklist_lock);
 	for_each_process(p) {
 		struct mm_struct *mm;
@@ -177,15 +211,30 @@ static int lowmem_shrink(struct shrinker *s, int nr_to_scan, gfp_t gfp_mask)
 			     p->pid, p->comm, oom_adj, tasksize);
 	}
 
+	if (!selected) {
+		lowmem_no_victim_adj = min_adj;
+		lowmem_no_victim_stamp = jiffies;
+		lowmem_no_victim_valid = 1;
+	} else {
+		lowmem_no_victim_valid = 0;
+	}
+
 	if (selected) {
 		spin_lock_irqsave(&lowmem_deathpending_lock, flags);
-		if (!lowmem_deathpending) {
+		if (!lowmem_deathpending ||
+		    time_after(jiffies, lowmem_deathpending_timeout)) {
 			lowmem_print(1,
 				"send sigkill to %d (%s), adj %d, size %d\n",
 				selected->pid, selected->comm,
 				selected_oom_adj, selected_tasksize);
+			/*
+			 * The task free notifier is already registered if
+			 * we are replacing a victim that timed out.
+			 */
+			if (!lowmem_deathpending)
+				task_free_register(&task_nb);
 			lowmem_deathpending = selected;
-			task_free_register(&task_nb);
+			lowmem_deathpending_timeout = jiffies + HZ;
 			force_sig(SIGKILL, selected);
 			rem -= selected_tasksize;
 		}
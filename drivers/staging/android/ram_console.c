@@ -26,6 +26,12 @@
 #include <linux/rslib.h>
 #endif
 
+#ifdef CONFIG_ANDROID_RAM_CONSOLE_COMPRESSION
+#include <linux/lzo.h>
+#include <linux/notifier.h>
+#include <linux/slab.h>
+#endif
+
 struct ram_console_buffer {
 	uint32_t    sig;
 	uint32_t    start;
@@ -122,8 +128,7 @@ static void ram_console_update_header(void)
 #endif
 }
 
-static void
-ram_console_write(struct console *console, const char *s, unsigned int count)
+static void ram_console_append(const char *s, unsigned int count)
 {
 	int rem;
 	struct ram_console_buffer *buffer = ram_console_buffer;
@@ -148,6 +153,84 @@ ram_console_write(struct console *console, const char *s, unsigned int count)
 	ram_console_update_header();
 }
 
+#ifdef CONFIG_ANDROID_RAM_CONSOLE_COMPRESSION
+/*
+ * Console output is staged one chunk at a time and LZO-compressed before
+ * it is appended to the ring; each compressed chunk carries a small
+ * header so the stream can be re-synchronized after the writer laps the
+ * ring. The partial staging chunk is flushed from a panic notifier.
+ */
+#define RAM_CONSOLE_CHUNK_MAGIC	0x5A4C	/* "LZ" */
+#define RAM_CONSOLE_CHUNK_SIZE	1024
+
+struct ram_console_chunk_hdr {
+	uint16_t magic;
+	uint16_t clen;	/* compressed payload length */
+	uint16_t ulen;	/* uncompressed payload length */
+} __attribute__((packed));
+
+static uint8_t ram_console_stage[RAM_CONSOLE_CHUNK_SIZE];
+static size_t ram_console_stage_len;
+static uint8_t ram_console_cbuf[sizeof(struct ram_console_chunk_hdr) +
+				lzo1x_worst_compress(RAM_CONSOLE_CHUNK_SIZE)];
+static uint8_t ram_console_lzo_wmem[LZO1X_1_MEM_COMPRESS];
+
+static void ram_console_flush_chunk(void)
+{
+	struct ram_console_chunk_hdr *hdr =
+		(struct ram_console_chunk_hdr *)ram_console_cbuf;
+	size_t clen;
+
+	if (!ram_console_stage_len)
+		return;
+
+	if (lzo1x_1_compress(ram_console_stage, ram_console_stage_len,
+			     ram_console_cbuf + sizeof(*hdr), &clen,
+			     ram_console_lzo_wmem) != LZO_E_OK) {
+		ram_console_stage_len = 0;
+		return;
+	}
+	hdr->magic = RAM_CONSOLE_CHUNK_MAGIC;
+	hdr->clen = clen;
+	hdr->ulen = ram_console_stage_len;
+	ram_console_stage_len = 0;
+	ram_console_append((char *)ram_console_cbuf, sizeof(*hdr) + clen);
+}
+
+static void
+ram_console_write(struct console *console, const char *s, unsigned int count)
+{
+	while (count) {
+		size_t len = min_t(size_t, count, RAM_CONSOLE_CHUNK_SIZE -
+				   ram_console_stage_len);
+
+		memcpy(ram_console_stage + ram_console_stage_len, s, len);
+		ram_console_stage_len += len;
+		s += len;
+		count -= len;
+		if (ram_console_stage_len == RAM_CONSOLE_CHUNK_SIZE)
+			ram_console_flush_chunk();
+	}
+}
+
+static int ram_console_panic_handler(struct notifier_block *this,
+				     unsigned long event, void *ptr)
+{
+	ram_console_flush_chunk();
+	return NOTIFY_DONE;
+}
+
+static struct notifier_block ram_console_panic_block = {
+	.notifier_call = ram_console_panic_handler,
+};
+#else
+static void
+ram_console_write(struct console *console, const char *s, unsigned int count)
+{
+	ram_console_append(s, count);
+}
+#endif
+
 static struct console ram_console = {
 	.name	= "ram",
 	.write	= ram_console_write,
@@ -168,6 +251,70 @@ void ram_console_enable_console(int enabled)
 		ram_console.flags &= ~CON_ENABLED;
 }
 
+/*
+ * Append a binary blob through the normal console path, so it goes
+ * into the compressed chunk stream when compression is enabled and
+ * shows up in /proc/last_kmsg after the next boot. Used by the flight
+ * recorder to attach its panic dump.
+ */
+void ram_console_append_blob(const void *data, size_t count)
+{
+	if (ram_console_buffer == NULL)
+		return;
+	ram_console_write(NULL, data, count);
+#ifdef CONFIG_ANDROID_RAM_CONSOLE_COMPRESSION
+	ram_console_flush_chunk();
+#endif
+}
+
+#ifdef CONFIG_ANDROID_RAM_CONSOLE_COMPRESSION
+static uint8_t ram_console_decomp_chunk[RAM_CONSOLE_CHUNK_SIZE] __initdata;
+
+/*
+ * ram_console_decompress_old - rebuild the previous boot's log from the
+ * compressed chunk stream in 'lin' (the linearized ring contents).
+ *
+ * After the writer laps the ring the first bytes are the tail of a
+ * clobbered chunk, so any header that does not validate (or fails to
+ * decompress) just advances the scan by one byte until the stream
+ * re-synchronizes on the next chunk magic.
+ */
+static size_t __init
+ram_console_decompress_old(const uint8_t *lin, size_t size, char *dest,
+			   size_t cap)
+{
+	size_t in = 0;
+	size_t out = 0;
+
+	while (in + sizeof(struct ram_console_chunk_hdr) < size) {
+		const struct ram_console_chunk_hdr *hdr =
+			(const struct ram_console_chunk_hdr *)(lin + in);
+		size_t ulen = RAM_CONSOLE_CHUNK_SIZE;
+
+		if (hdr->magic != RAM_CONSOLE_CHUNK_MAGIC || !hdr->clen ||
+		    hdr->clen > lzo1x_worst_compress(RAM_CONSOLE_CHUNK_SIZE) ||
+		    !hdr->ulen || hdr->ulen > RAM_CONSOLE_CHUNK_SIZE ||
+		    in + sizeof(*hdr) + hdr->clen > size) {
+			in++;
+			continue;
+		}
+		if (lzo1x_decompress_safe(lin + in + sizeof(*hdr), hdr->clen,
+					  ram_console_decomp_chunk,
+					  &ulen) != LZO_E_OK ||
+		    ulen != hdr->ulen) {
+			in++;
+			continue;
+		}
+		if (out + ulen > cap)
+			break;
+		memcpy(dest + out, ram_console_decomp_chunk, ulen);
+		out += ulen;
+		in += sizeof(*hdr) + hdr->clen;
+	}
+	return out;
+}
+#endif
+
 static void __init
 ram_console_save_old(struct ram_console_buffer *buffer, char *dest)
 {
@@ -214,6 +361,55 @@ ram_console_save_old(struct ram_console_buffer *buffer, char *dest)
 	old_log_size += strbuf_len;
 #endif
 
+#ifdef CONFIG_ANDROID_RAM_CONSOLE_COMPRESSION
+	{
+		uint8_t *lin;
+		size_t cap;
+		size_t out;
+
+		/*
+		 * The decompressed log can be several times the ring size;
+		 * a caller-provided buffer is only as big as the data area.
+		 */
+		if (dest == NULL)
+			cap = 4 * (size_t)buffer->size;
+		else
+			cap = ram_console_buffer_size;
+
+		lin = kmalloc(buffer->size, GFP_KERNEL);
+		if (lin == NULL) {
+			printk(KERN_ERR
+			       "ram_console: failed to allocate buffer\n");
+			return;
+		}
+		memcpy(lin, &buffer->data[buffer->start],
+		       buffer->size - buffer->start);
+		memcpy(lin + buffer->size - buffer->start, &buffer->data[0],
+		       buffer->start);
+
+		if (dest == NULL) {
+			dest = kmalloc(cap, GFP_KERNEL);
+			if (dest == NULL) {
+				kfree(lin);
+				printk(KERN_ERR "ram_console: failed to "
+				       "allocate buffer\n");
+				return;
+			}
+		}
+
+		out = ram_console_decompress_old(lin, buffer->size, dest, cap);
+		kfree(lin);
+
+		ram_console_old_log = dest;
+		ram_console_old_log_size = out;
+#ifdef CONFIG_ANDROID_RAM_CONSOLE_ERROR_CORRECTION
+		if (out + strbuf_len <= cap) {
+			memcpy(dest + out, strbuf, strbuf_len);
+			ram_console_old_log_size += strbuf_len;
+		}
+#endif
+	}
+#else
 	if (dest == NULL) {
 		dest = kmalloc(old_log_size, GFP_KERNEL);
 		if (dest == NULL) {
@@ -233,6 +429,7 @@ ram_console_save_old(struct ram_console_buffer *buffer, char *dest)
 	memcpy(ram_console_old_log + old_log_size - strbuf_len,
 	       strbuf, strbuf_len);
 #endif
+#endif
 }
 
 static int __init ram_console_init(struct ram_console_buffer *buffer,
@@ -314,6 +511,10 @@ static int __init ram_console_init(struct ram_console_buffer *buffer,
 	buffer->start = 0;
 	buffer->size = 0;
 
+#ifdef CONFIG_ANDROID_RAM_CONSOLE_COMPRESSION
+	atomic_notifier_chain_register(&panic_notifier_list,
+				       &ram_console_panic_block);
+#endif
 	register_console(&ram_console);
 #ifdef CONFIG_ANDROID_RAM_CONSOLE_ENABLE_VERBOSE
 	console_verbose();
@@ -36,6 +36,15 @@
 static int ramzswap_major;
 static struct ramzswap *devices;
 
+/*
+ * Per-CPU compression buffers, shared by all devices.  A writer
+ * compresses into the buffer of whatever CPU it runs on, with
+ * preemption disabled, so writes from different CPUs do not serialize
+ * on a single per-device buffer any more.
+ */
+static DEFINE_PER_CPU(unsigned char *, compress_buffer);
+static DEFINE_PER_CPU(void *, compress_workmem);
+
 /* Module params (documentation at end) */
 static unsigned int num_devices;
 
@@ -321,8 +330,8 @@ out:
 
 static int ramzswap_write(struct ramzswap *rzs, struct bio *bio)
 {
-	int ret;
-	u32 offset, index;
+	int ret, zero, prealloc = 0;
+	u32 offset = 0, index;
 	size_t clen;
 	struct zobj_header *zheader;
 	struct page *page, *page_store;
@@ -333,14 +342,11 @@ static int ramzswap_write(struct ramzswap *rzs, struct bio *bio)
 	page = bio->bi_io_vec[0].bv_page;
 	index = bio->bi_sector >> SECTORS_PER_PAGE_SHIFT;
 
-	src = rzs->compress_buffer;
-
-	mutex_lock(&rzs->lock);
-
 	user_mem = kmap_atomic(page, KM_USER0);
-	if (page_zero_filled(user_mem)) {
-		kunmap_atomic(user_mem, KM_USER0);
-		mutex_unlock(&rzs->lock);
+	zero = page_zero_filled(user_mem);
+	kunmap_atomic(user_mem, KM_USER0);
+
+	if (zero) {
 		rzs_stat_inc(&rzs->stats.pages_zero);
 		rzs_set_flag(rzs, index, RZS_ZERO);
 
@@ -349,13 +355,24 @@ static int ramzswap_write(struct ramzswap *rzs, struct bio *bio)
 		return 0;
 	}
 
-	ret = lzo1x_1_compress(user_mem, PAGE_SIZE, src, &clen,
-				rzs->compress_workmem);
+	/*
+	 * Compress into the buffer of whatever CPU we run on.  We stay
+	 * in atomic context until the compressed data has been copied
+	 * into its final object, so the buffer can't be stolen from
+	 * under us; the object is therefore allocated without sleeping.
+	 * If that fails, the allocation is retried in sleepable context
+	 * and the (deterministic) compression simply redone, see below.
+	 */
+compress:
+	src = get_cpu_var(compress_buffer);
 
+	user_mem = kmap_atomic(page, KM_USER0);
+	ret = lzo1x_1_compress(user_mem, PAGE_SIZE, src, &clen,
+				__get_cpu_var(compress_workmem));
 	kunmap_atomic(user_mem, KM_USER0);
 
 	if (unlikely(ret != LZO_E_OK)) {
-		mutex_unlock(&rzs->lock);
+		put_cpu_var(compress_buffer);
 		pr_err("Compression failed! err=%d\n", ret);
 		rzs_stat64_inc(rzs, &rzs->stats.failed_writes);
 		goto out;
@@ -367,10 +384,11 @@ static int ramzswap_write(struct ramzswap *rzs, struct bio *bio)
 	 * errors which has side effect of hanging the system.
 	 */
 	if (unlikely(clen > max_zpage_size)) {
+		put_cpu_var(compress_buffer);
+
 		clen = PAGE_SIZE;
 		page_store = alloc_page(GFP_NOIO | __GFP_HIGHMEM);
 		if (unlikely(!page_store)) {
-			mutex_unlock(&rzs->lock);
 			pr_info("Error allocating memory for incompressible "
 				"page: %u\n", index);
 			rzs_stat64_inc(rzs, &rzs->stats.failed_writes);
@@ -385,15 +403,31 @@ static int ramzswap_write(struct ramzswap *rzs, struct bio *bio)
 		goto memstore;
 	}
 
-	if (xv_malloc(rzs->mem_pool, clen + sizeof(*zheader),
+	if (!prealloc &&
+	    xv_malloc(rzs->mem_pool, clen + sizeof(*zheader),
 			&rzs->table[index].page, &offset,
-			GFP_NOIO | __GFP_HIGHMEM)) {
-		mutex_unlock(&rzs->lock);
-		pr_info("Error allocating memory for compressed "
-			"page: %u, size=%zu\n", index, clen);
-		rzs_stat64_inc(rzs, &rzs->stats.failed_writes);
-		goto out;
+			GFP_NOWAIT | __GFP_HIGHMEM)) {
+		put_cpu_var(compress_buffer);
+
+		if (xv_malloc(rzs->mem_pool, clen + sizeof(*zheader),
+				&rzs->table[index].page, &offset,
+				GFP_NOIO | __GFP_HIGHMEM)) {
+			pr_info("Error allocating memory for compressed "
+				"page: %u, size=%zu\n", index, clen);
+			rzs_stat64_inc(rzs, &rzs->stats.failed_writes);
+			goto out;
+		}
+		/*
+		 * We may have slept and changed CPUs, invalidating the
+		 * compressed data; redo the compression into the object
+		 * allocated above (same input, so same size).
+		 */
+		rzs->table[index].offset = offset;
+		prealloc = 1;
+		goto compress;
 	}
+	if (prealloc)
+		offset = rzs->table[index].offset;
 
 memstore:
 	rzs->table[index].offset = offset;
@@ -415,6 +449,8 @@ memstore:
 	kunmap_atomic(cmem, KM_USER1);
 	if (unlikely(rzs_test_flag(rzs, index, RZS_UNCOMPRESSED)))
 		kunmap_atomic(src, KM_USER0);
+	else
+		put_cpu_var(compress_buffer);
 
 	/* Update stats */
 	rzs->stats.compr_size += clen;
@@ -422,8 +458,6 @@ memstore:
 	if (clen <= PAGE_SIZE / 2)
 		rzs_stat_inc(&rzs->stats.good_compress);
 
-	mutex_unlock(&rzs->lock);
-
 	set_bit(BIO_UPTODATE, &bio->bi_flags);
 	bio_endio(bio, 0);
 	return 0;
@@ -491,13 +525,6 @@ static void reset_device(struct ramzswap *rzs)
 	/* Do not accept any new I/O request */
 	rzs->init_done = 0;
 
-	/* Free various per-device buffers */
-	kfree(rzs->compress_workmem);
-	free_pages((unsigned long)rzs->compress_buffer, 1);
-
-	rzs->compress_workmem = NULL;
-	rzs->compress_buffer = NULL;
-
 	/* Free all pages that are still in this ramzswap device */
 	for (index = 0; index < rzs->disksize >> PAGE_SHIFT; index++) {
 		struct page *page;
@@ -541,20 +568,6 @@ static int ramzswap_ioctl_init_device(struct ramzswap *rzs)
 
 	ramzswap_set_disksize(rzs, totalram_pages << PAGE_SHIFT);
 
-	rzs->compress_workmem = kzalloc(LZO1X_MEM_COMPRESS, GFP_KERNEL);
-	if (!rzs->compress_workmem) {
-		pr_err("Error allocating compressor working memory!\n");
-		ret = -ENOMEM;
-		goto fail;
-	}
-
-	rzs->compress_buffer = (void *)__get_free_pages(__GFP_ZERO, 1);
-	if (!rzs->compress_buffer) {
-		pr_err("Error allocating compressor buffer space\n");
-		ret = -ENOMEM;
-		goto fail;
-	}
-
 	num_pages = rzs->disksize >> PAGE_SHIFT;
 	rzs->table = vmalloc(num_pages * sizeof(*rzs->table));
 	if (!rzs->table) {
@@ -682,6 +695,37 @@ out:
 	return ret;
 }
 
+static void free_compress_buffers(void)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		free_pages((unsigned long)per_cpu(compress_buffer, cpu), 1);
+		kfree(per_cpu(compress_workmem, cpu));
+		per_cpu(compress_buffer, cpu) = NULL;
+		per_cpu(compress_workmem, cpu) = NULL;
+	}
+}
+
+static int alloc_compress_buffers(void)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		per_cpu(compress_buffer, cpu) =
+			(void *)__get_free_pages(GFP_KERNEL | __GFP_ZERO, 1);
+		per_cpu(compress_workmem, cpu) =
+			kzalloc(LZO1X_MEM_COMPRESS, GFP_KERNEL);
+		if (!per_cpu(compress_buffer, cpu) ||
+		    !per_cpu(compress_workmem, cpu)) {
+			free_compress_buffers();
+			return -ENOMEM;
+		}
+	}
+
+	return 0;
+}
+
 void ramzswap_slot_free_notify(struct block_device *bdev, unsigned long index)
 {
 	struct ramzswap *rzs;
@@ -699,11 +743,106 @@ static struct block_device_operations ramzswap_devops = {
 	.owner = THIS_MODULE
 };
 
+#if defined(CONFIG_RAMZSWAP_STATS)
+/*
+ * Per-device statistics, exported under
+ * /sys/block/ramzswap<id>/. Same numbers as RZSIO_GET_STATS but
+ * readable without the rzscontrol utility.
+ */
+#define RZS_ATTR_RO_STAT64(name)				\
+static ssize_t name##_show(struct device *dev,			\
+		struct device_attribute *attr, char *buf)	\
+{								\
+	struct ramzswap *rzs = dev_to_disk(dev)->private_data;	\
+								\
+	return sprintf(buf, "%llu\n",				\
+		rzs_stat64_read(rzs, &rzs->stats.name));	\
+}								\
+static DEVICE_ATTR(name, S_IRUGO, name##_show, NULL)
+
+RZS_ATTR_RO_STAT64(num_reads);
+RZS_ATTR_RO_STAT64(num_writes);
+RZS_ATTR_RO_STAT64(invalid_io);
+RZS_ATTR_RO_STAT64(notify_free);
+
+static ssize_t zero_pages_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct ramzswap *rzs = dev_to_disk(dev)->private_data;
+
+	return sprintf(buf, "%u\n", rzs->stats.pages_zero);
+}
+static DEVICE_ATTR(zero_pages, S_IRUGO, zero_pages_show, NULL);
+
+static ssize_t orig_data_size_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct ramzswap *rzs = dev_to_disk(dev)->private_data;
+
+	return sprintf(buf, "%llu\n",
+		(u64)rzs->stats.pages_stored << PAGE_SHIFT);
+}
+static DEVICE_ATTR(orig_data_size, S_IRUGO, orig_data_size_show, NULL);
+
+static ssize_t compr_data_size_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct ramzswap *rzs = dev_to_disk(dev)->private_data;
+
+	return sprintf(buf, "%zu\n", rzs->stats.compr_size);
+}
+static DEVICE_ATTR(compr_data_size, S_IRUGO, compr_data_size_show, NULL);
+
+static ssize_t mem_used_total_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct ramzswap *rzs = dev_to_disk(dev)->private_data;
+	size_t mem_used = 0;
+
+	if (rzs->init_done)
+		mem_used = xv_get_total_size_bytes(rzs->mem_pool)
+			+ ((size_t)rzs->stats.pages_expand << PAGE_SHIFT);
+
+	return sprintf(buf, "%zu\n", mem_used);
+}
+static DEVICE_ATTR(mem_used_total, S_IRUGO, mem_used_total_show, NULL);
+
+static struct attribute *ramzswap_disk_attrs[] = {
+	&dev_attr_num_reads.attr,
+	&dev_attr_num_writes.attr,
+	&dev_attr_invalid_io.attr,
+	&dev_attr_notify_free.attr,
+	&dev_attr_zero_pages.attr,
+	&dev_attr_orig_data_size.attr,
+	&dev_attr_compr_data_size.attr,
+	&dev_attr_mem_used_total.attr,
+	NULL,
+};
+
+static struct attribute_group ramzswap_disk_attr_group = {
+	.attrs = ramzswap_disk_attrs,
+};
+
+static int ramzswap_sysfs_init(struct ramzswap *rzs)
+{
+	return sysfs_create_group(&disk_to_dev(rzs->disk)->kobj,
+			&ramzswap_disk_attr_group);
+}
+
+static void ramzswap_sysfs_exit(struct ramzswap *rzs)
+{
+	sysfs_remove_group(&disk_to_dev(rzs->disk)->kobj,
+			&ramzswap_disk_attr_group);
+}
+#else
+static int ramzswap_sysfs_init(struct ramzswap *rzs) { return 0; }
+static void ramzswap_sysfs_exit(struct ramzswap *rzs) { }
+#endif /* CONFIG_RAMZSWAP_STATS */
+
 static int create_device(struct ramzswap *rzs, int device_id)
 {
 	int ret = 0;
 
-	mutex_init(&rzs->lock);
 	spin_lock_init(&rzs->stat64_lock);
 
 	rzs->queue = blk_alloc_queue(GFP_KERNEL);
@@ -742,6 +881,11 @@ static int create_device(struct ramzswap *rzs, int device_id)
 
 	add_disk(rzs->disk);
 
+	/* Stats are nice to have but the device works without them */
+	if (ramzswap_sysfs_init(rzs))
+		pr_warning("Error creating sysfs group for device %d\n",
+			device_id);
+
 	rzs->init_done = 0;
 
 out:
@@ -751,6 +895,7 @@ out:
 static void destroy_device(struct ramzswap *rzs)
 {
 	if (rzs->disk) {
+		ramzswap_sysfs_exit(rzs);
 		del_gendisk(rzs->disk);
 		put_disk(rzs->disk);
 	}
@@ -770,11 +915,17 @@ static int __init ramzswap_init(void)
 		goto out;
 	}
 
+	ret = alloc_compress_buffers();
+	if (ret) {
+		pr_err("Error allocating per-cpu compression buffers\n");
+		goto out;
+	}
+
 	ramzswap_major = register_blkdev(0, "ramzswap");
 	if (ramzswap_major <= 0) {
 		pr_warning("Unable to get major number\n");
 		ret = -EBUSY;
-		goto out;
+		goto free_buffers;
 	}
 
 	if (!num_devices) {
@@ -803,6 +954,8 @@ free_devices:
 		destroy_device(&devices[--dev_id]);
 unregister:
 	unregister_blkdev(ramzswap_major, "ramzswap");
+free_buffers:
+	free_compress_buffers();
 out:
 	return ret;
 }
@@ -822,6 +975,7 @@ static void __exit ramzswap_exit(void)
 
 	unregister_blkdev(ramzswap_major, "ramzswap");
 
+	free_compress_buffers();
 	kfree(devices);
 	pr_debug("Cleanup done!\n");
 }
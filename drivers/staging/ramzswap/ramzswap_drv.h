@@ -16,7 +16,6 @@
 #define _RAMZSWAP_DRV_H_
 
 #include <linux/spinlock.h>
-#include <linux/mutex.h>
 
 #include "ramzswap_ioctl.h"
 #include "xvmalloc.h"
@@ -108,11 +107,8 @@ struct ramzswap_stats {
 
 struct ramzswap {
 	struct xv_pool *mem_pool;
-	void *compress_workmem;
-	void *compress_buffer;
 	struct table *table;
 	spinlock_t stat64_lock;	/* protect 64-bit stats */
-	struct mutex lock;
 	struct request_queue *queue;
 	struct gendisk *disk;
 	int init_done;
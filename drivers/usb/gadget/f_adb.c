@@ -29,6 +29,10 @@
 #include <linux/types.h>
 #include <linux/device.h>
 #include <linux/miscdevice.h>
+#include <linux/splice.h>
+#include <linux/pipe_fs_i.h>
+#include <linux/mm.h>
+#include <linux/highmem.h>
 
 #include <linux/usb/android_composite.h>
 
@@ -40,7 +44,11 @@
 #include "u_lgeusb.h"
 #endif
 
-#define BULK_BUFFER_SIZE           4096
+/* 16K is the largest transfer msm72k accepts per request (one dTD,
+ * pages 0-3); adb_write() splits bigger payloads across requests, so
+ * with TX_REQ_MAX requests up to 64K can still be in flight at once
+ * instead of one 4K bounce per request. */
+#define BULK_BUFFER_SIZE           16384
 
 /* number of tx requests to allocate */
 #define TX_REQ_MAX 4
@@ -210,6 +218,14 @@ static void adb_complete_in(struct usb_ep *ep, struct usb_request *req)
 	if (req->status != 0)
 		atomic_set(&dev->error, 1);
 
+	/* a spliced request points into a page cache page; drop our
+	 * reference and put the bounce buffer back (see adb_pipe_to_usb) */
+	if (req->context) {
+		put_page(virt_to_page(req->buf));
+		req->buf = req->context;
+		req->context = NULL;
+	}
+
 	req_put(dev, &dev->tx_idle, req);
 
 	wake_up(&dev->write_wq);
@@ -417,6 +433,77 @@ static ssize_t adb_write(struct file *fp, const char __user *buf,
 	return r;
 }
 
+/* Queue one pipe buffer on the bulk-in endpoint.  Lowmem page cache
+ * pages are handed to the UDC in place (it maps req->buf with
+ * dma_map_single, so any kernel virtual address works); we just hold a
+ * page reference until the completion swaps the bounce buffer back.
+ * Highmem pages fall back to a copy. */
+static int adb_pipe_to_usb(struct pipe_inode_info *pipe,
+		struct pipe_buffer *buf, struct splice_desc *sd)
+{
+	struct adb_dev *dev = sd->u.file->private_data;
+	struct usb_request *req = 0;
+	int ret;
+
+	ret = buf->ops->confirm(pipe, buf);
+	if (ret)
+		return ret;
+
+	if (atomic_read(&dev->error))
+		return -EIO;
+
+	ret = wait_event_interruptible(dev->write_wq,
+		((req = req_get(dev, &dev->tx_idle)) ||
+		 atomic_read(&dev->error)));
+	if (ret < 0)
+		return ret;
+	if (!req)
+		return -EIO;
+
+	if (PageHighMem(buf->page)) {
+		void *src = kmap(buf->page);
+		memcpy(req->buf, src + buf->offset, sd->len);
+		kunmap(buf->page);
+	} else {
+		get_page(buf->page);
+		req->context = req->buf;
+		req->buf = page_address(buf->page) + buf->offset;
+	}
+	req->length = sd->len;
+
+	ret = usb_ep_queue(dev->ep_in, req, GFP_KERNEL);
+	if (ret < 0) {
+		DBG(dev->cdev, "adb_pipe_to_usb: xfer error %d\n", ret);
+		if (req->context) {
+			put_page(buf->page);
+			req->buf = req->context;
+			req->context = NULL;
+		}
+		req_put(dev, &dev->tx_idle, req);
+		atomic_set(&dev->error, 1);
+		return -EIO;
+	}
+
+	return sd->len;
+}
+
+static ssize_t adb_splice_write(struct pipe_inode_info *pipe,
+		struct file *fp, loff_t *ppos, size_t count, unsigned int flags)
+{
+	struct adb_dev *dev = fp->private_data;
+	ssize_t ret;
+
+	DBG(dev->cdev, "adb_splice_write(%d)\n", count);
+
+	if (_lock(&dev->write_excl))
+		return -EBUSY;
+	ret = splice_from_pipe(pipe, fp, ppos, count, flags, adb_pipe_to_usb);
+	_unlock(&dev->write_excl);
+
+	DBG(dev->cdev, "adb_splice_write returning %d\n", ret);
+	return ret;
+}
+
 static int adb_open(struct inode *ip, struct file *fp)
 {
 	pr_debug("adb_open\n");
@@ -443,6 +530,7 @@ static const struct file_operations adb_fops = {
 	.owner = THIS_MODULE,
 	.read = adb_read,
 	.write = adb_write,
+	.splice_write = adb_splice_write,
 	.open = adb_open,
 	.release = adb_release,
 };
@@ -331,6 +331,17 @@ static struct sk_buff *rndis_add_header(struct gether *port,
 {
 	struct sk_buff *skb2;
 
+	/* When the frame already has room for the RNDIS header, push it
+	 * in place instead of reallocating and copying the whole payload.
+	 * u_ether advertises needed_headroom, so forwarded and locally
+	 * built frames normally arrive with that room reserved.
+	 */
+	if (skb_headroom(skb) >= sizeof(struct rndis_packet_msg_type) &&
+	    !skb_header_cloned(skb)) {
+		rndis_add_hdr(skb);
+		return skb;
+	}
+
 	skb2 = skb_realloc_headroom(skb, sizeof(struct rndis_packet_msg_type));
 	if (skb2)
 		rndis_add_hdr(skb2);
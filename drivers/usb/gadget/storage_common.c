@@ -290,15 +290,19 @@ static struct fsg_lun *fsg_lun_from_dev(struct device *dev)
 #define EP0_BUFSIZE	256
 #define DELAYED_STATUS	(EP0_BUFSIZE + 999)	/* An impossibly large value */
 
-/* Number of buffers for CBW, DATA and CSW */
-#ifdef CONFIG_USB_CSW_HACK
+/* Number of buffers for CBW, DATA and CSW.
+ * Four buffers keep the pipeline full: while one bulk transfer is on the
+ * wire up to three more can already be read from (or written to) backing
+ * storage and queued, so vfs_read/vfs_write overlaps the bulk-in/out
+ * traffic instead of alternating with it. */
 #define FSG_NUM_BUFFERS    4
-#else
-#define FSG_NUM_BUFFERS    2
-#endif
 
 
-/* Default size of buffer length. */
+/* Default size of buffer length.
+ * Bigger buffers mean fewer request completions per SCSI command, but
+ * the msm72k UDC rejects any request longer than 16K (one dTD carries
+ * at most four pages), so 16K is the largest size every target here
+ * can actually queue. */
 #define FSG_BUFLEN	((u32)16384)
 
 /* Maximal number of LUNs supported in mass storage function */
@@ -901,6 +901,11 @@ struct net_device *gether_connect(struct gether *link)
 		dev->unwrap = link->unwrap;
 		dev->wrap = link->wrap;
 
+		/* have the stack reserve room for the port's framing
+		 * header, so wrap() can push it without a reallocation
+		 */
+		dev->net->needed_headroom = link->header_len;
+
 		spin_lock(&dev->lock);
 		dev->port_usb = link;
 		link->ioport = dev;
@@ -991,6 +996,7 @@ void gether_disconnect(struct gether *link)
 
 	/* finish forgetting about this USB link episode */
 	dev->header_len = 0;
+	dev->net->needed_headroom = 0;
 	dev->unwrap = NULL;
 	dev->wrap = NULL;
 
@@ -117,6 +117,43 @@ static struct platform_driver mddi_driver = {
 extern int int_mddi_pri_flag;
 DEFINE_MUTEX(pmdh_clk_lock);
 
+/* link rates captured at mddi_on() for pmdh_link_clk_boost() */
+static u32 mddi_link_base_rate;
+static u32 mddi_link_boost_rate;
+static int mddi_link_boost_cnt;
+
+/*
+ * Raise the primary MDDI link clock to the panel maximum for the
+ * duration of a bulk transfer and drop back to the operating rate
+ * once the last user is done.  Refcounted so overlapping batches
+ * keep the link fast.
+ */
+int pmdh_link_clk_boost(int on)
+{
+	int ret = 0;
+
+	mutex_lock(&pmdh_clk_lock);
+	if (!mddi_clk || !mddi_link_boost_rate ||
+	    mddi_link_boost_rate <= mddi_link_base_rate)
+		goto boost_done;
+
+	if (on) {
+		if (mddi_link_boost_cnt++ == 0)
+			ret = clk_set_min_rate(mddi_clk,
+					       mddi_link_boost_rate);
+	} else if (mddi_link_boost_cnt) {
+		if (--mddi_link_boost_cnt == 0)
+			ret = clk_set_min_rate(mddi_clk,
+					       mddi_link_base_rate);
+	}
+
+	if (ret < 0)
+		printk(KERN_ERR "%s: clk_set_min_rate failed\n", __func__);
+boost_done:
+	mutex_unlock(&pmdh_clk_lock);
+	return ret;
+}
+
 int pmdh_clk_func(int value)
 {
 	int ret = 0;
@@ -278,6 +315,15 @@ static int mddi_on(struct platform_device *pdev)
 		printk(KERN_ERR "%s: clk_set_min_rate failed\n",
 			__func__);
 
+	mutex_lock(&pmdh_clk_lock);
+	mddi_link_base_rate = clk_rate;
+	mddi_link_boost_rate = mfd->panel_info.clk_max;
+	if (mddi_pdata &&
+	    mddi_pdata->mddi_sel_clk &&
+	    mddi_pdata->mddi_sel_clk(&mddi_link_boost_rate))
+		mddi_link_boost_rate = clk_rate;
+	mutex_unlock(&pmdh_clk_lock);
+
 #ifdef CONFIG_MSM_BUS_SCALING
 	mdp_bus_scale_update_request(2);
 #else
@@ -283,6 +283,133 @@ int mddi_host_register_write(uint32 reg_addr,
 	return ret;
 }				/* mddi_host_register_write */
 
+/* keep batches well below the dynamic llist pool so other clients of
+ * the host (vsync, register reads) can still obtain items while a
+ * batch is being assembled */
+#define MDDI_REG_WRITE_BATCH_CHUNK 16
+
+int mddi_host_register_write_batch(const mddi_reg_write_type *reg_list,
+	uint32 count, boolean wait, mddi_host_type host)
+{
+	mddi_linked_list_type *curr_llist_ptr;
+	mddi_linked_list_type *curr_llist_dma_ptr;
+	mddi_linked_list_type *prev_llist_ptr;
+	mddi_register_access_packet_type *regacc_pkt_ptr;
+	uint16 first_llist_idx;
+	uint16 curr_llist_idx = UNASSIGNED_INDEX;
+	uint16 prev_llist_idx;
+	uint32 done = 0;
+	uint32 chunk;
+	uint32 i;
+	int ret = 0;
+
+	if (!reg_list || !count)
+		return -EINVAL;
+
+	if (in_interrupt())
+		MDDI_MSG_CRIT("Called from ISR context\n");
+
+	if (!mddi_host_powered) {
+		MDDI_MSG_ERR("MDDI powered down!\n");
+		mddi_init();
+	}
+
+	if (host == MDDI_HOST_PRIM)
+		pmdh_link_clk_boost(1);
+
+	down(&mddi_host_mutex);
+
+	/*
+	 * Chain the register access packets through their
+	 * next_packet_pointer so the whole chunk goes out as a single
+	 * link transaction; only the final packet carries the link
+	 * controller end flag and the completion we may wait on.
+	 */
+	while (done < count) {
+		chunk = count - done;
+		if (chunk > MDDI_REG_WRITE_BATCH_CHUNK)
+			chunk = MDDI_REG_WRITE_BATCH_CHUNK;
+
+		first_llist_idx = UNASSIGNED_INDEX;
+		prev_llist_ptr = NULL;
+		prev_llist_idx = UNASSIGNED_INDEX;
+
+		for (i = 0; i < chunk; i++, done++) {
+			curr_llist_idx =
+				mddi_get_next_free_llist_item(host, TRUE);
+			curr_llist_ptr = &llist_extern[host][curr_llist_idx];
+			curr_llist_dma_ptr =
+				&llist_dma_extern[host][curr_llist_idx];
+
+			curr_llist_ptr->link_controller_flags = 1;
+			curr_llist_ptr->packet_header_count = 14;
+			curr_llist_ptr->packet_data_count = 4;
+
+			curr_llist_ptr->next_packet_pointer = NULL;
+			curr_llist_ptr->reserved = 0;
+
+			regacc_pkt_ptr =
+				&curr_llist_ptr->packet_header.register_pkt;
+
+			regacc_pkt_ptr->packet_length =
+				curr_llist_ptr->packet_header_count +
+				MDDI_DATA_PACKET_4_BYTES;
+			regacc_pkt_ptr->packet_type = 146;
+			regacc_pkt_ptr->bClient_ID = 0;
+			regacc_pkt_ptr->read_write_info = 0x0001;
+			regacc_pkt_ptr->register_address = reg_list[done].addr;
+			regacc_pkt_ptr->register_data_list[0] =
+				reg_list[done].value;
+
+			regacc_pkt_ptr =
+				&curr_llist_dma_ptr->packet_header.register_pkt;
+			curr_llist_ptr->packet_data_pointer =
+			    (void *)(&regacc_pkt_ptr->register_data_list[0]);
+
+			if (first_llist_idx == UNASSIGNED_INDEX) {
+				first_llist_idx = curr_llist_idx;
+			} else {
+				prev_llist_ptr->link_controller_flags = 0;
+				prev_llist_ptr->next_packet_pointer =
+					&llist_dma_extern[host][curr_llist_idx];
+				llist_extern_notify[host][prev_llist_idx].
+					next_idx = curr_llist_idx;
+			}
+			prev_llist_ptr = curr_llist_ptr;
+			prev_llist_idx = curr_llist_idx;
+		}
+
+		mddi_queue_forward_packets(first_llist_idx, curr_llist_idx,
+					   (wait && (done == count)),
+					   NULL, host);
+	}
+
+	up(&mddi_host_mutex);
+
+	if (wait) {
+		int wait_ret;
+
+		mddi_linked_list_notify_type *llist_notify_ptr;
+		llist_notify_ptr = &llist_extern_notify[host][curr_llist_idx];
+		wait_ret = wait_for_completion_timeout(
+					&(llist_notify_ptr->done_comp), 5 * HZ);
+
+		if (wait_ret <= 0)
+			ret = -EBUSY;
+
+		if (wait_ret < 0)
+			printk(KERN_ERR "%s: failed to wait for completion!\n",
+				__func__);
+		else if (!wait_ret)
+			printk(KERN_ERR "%s: Timed out waiting!\n", __func__);
+	}
+
+	if (host == MDDI_HOST_PRIM)
+		pmdh_link_clk_boost(0);
+
+	return ret;
+}				/* mddi_host_register_write_batch */
+
 boolean mddi_host_register_read_int
     (uint32 reg_addr, uint32 *reg_value_ptr, mddi_host_type host) {
 	mddi_linked_list_type *curr_llist_ptr;
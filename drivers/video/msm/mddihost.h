@@ -208,6 +208,16 @@ void mddi_queue_static_window_adjust
     (const mddi_reg_write_type *reg_write,
      uint16 num_writes, mddi_llist_done_cb_type done_cb);
 
+/*
+ * Batched register writes: the whole list is chained into as few
+ * forward-link transactions as possible and the primary link clock is
+ * boosted while the batch drains, which makes long panel init and
+ * backlight ramp sequences far cheaper than per-register packets.
+ */
+int mddi_host_register_write_batch(const mddi_reg_write_type *reg_list,
+	uint32 count, boolean wait, mddi_host_type host);
+int pmdh_link_clk_boost(int on);
+
 #ifdef ENABLE_MDDI_MULTI_READ_WRITE
 int mddi_host_register_multiwrite(uint32 reg_addr,
 	uint32 *value_list_ptr, uint32 value_count,
@@ -232,6 +242,8 @@ int mddi_host_register_multiread(uint32 reg_addr,
 	mddi_host_register_read_int(reg, val_ptr, MDDI_HOST_PRIM)
 #define mddi_queue_register_writes(reg_ptr, val, wait, sig) \
 	mddi_host_register_writes(reg_ptr, val, wait, sig, MDDI_HOST_PRIM)
+#define mddi_queue_register_write_batch(reg_list, count, wait, sig) \
+	mddi_host_register_write_batch(reg_list, count, wait, MDDI_HOST_PRIM)
 
 void mddi_wait(uint16 time_ms);
 void mddi_assign_max_pkt_dimensions(uint16 image_cols,
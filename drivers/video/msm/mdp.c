@@ -349,6 +349,15 @@ int mdp_ppp_pipe_wait(void)
 		if (!ret)
 			printk(KERN_ERR "%s: Timed out waiting for the MDP.\n",
 					__func__);
+		else if (ret > 0 && mdp_debug[MDP_PPP_BLOCK]) {
+			struct timeval now;
+
+			jiffies_to_timeval(jiffies, &now);
+			mdp_ppp_timeval.tv_usec =
+			    now.tv_usec - mdp_ppp_timeval.tv_usec;
+			MSM_FB_INFO("MDP-PPP: %d\n",
+				    (int)mdp_ppp_timeval.tv_usec);
+		}
 	}
 
 	return ret;
@@ -428,18 +437,13 @@ void mdp_pipe_kickoff(uint32 term, struct msm_fb_data_type *mfd)
 		INIT_COMPLETION(mdp_ppp_comp);
 		mdp_ppp_waiting = TRUE;
 		outpdw(MDP_BASE + 0x30, 0x1000);
-		wait_for_completion_killable(&mdp_ppp_comp);
-		mdp_disable_irq(term);
-
-		if (mdp_debug[MDP_PPP_BLOCK]) {
-			struct timeval now;
 
-			jiffies_to_timeval(jiffies, &now);
-			mdp_ppp_timeval.tv_usec =
-			    now.tv_usec - mdp_ppp_timeval.tv_usec;
-			MSM_FB_INFO("MDP-PPP: %d\n",
-				    (int)mdp_ppp_timeval.tv_usec);
-		}
+		/*
+		 * The blit now completes asynchronously; the caller reaps
+		 * it through mdp_ppp_pipe_wait() before reprogramming the
+		 * pipe or releasing the images, so the CPU can set up the
+		 * next blit of a composition batch while this one runs.
+		 */
 	} else if (term == MDP_DMA2_TERM) {
 		if (mdp_debug[MDP_DMA2_BLOCK]) {
 			MSM_FB_INFO("MDP-DMA2: %d\n",
@@ -908,6 +912,39 @@ static struct platform_driver mdp_driver = {
 	},
 };
 
+#ifndef CONFIG_FB_MSM_MDP40
+/*
+ * Retained-state fast resume.  The MDP core normally keeps its
+ * registers across a suspend cycle since only the clocks are gated,
+ * but boards with a working footswitch power collapse the core and
+ * lose everything mdp_hw_init() programmed.  Replaying the full init
+ * (LUT and CSC reload, several hundred register writes) on the
+ * screen-on path costs visible blank time, so the interrupt enable
+ * register is snapshotted at suspend and compared on resume: if the
+ * core was reset, only the registers the first DMA kickoff depends on
+ * are restored inline and the full init runs later from a workqueue
+ * as a validation pass.
+ */
+static uint32 mdp_suspend_intr_snapshot;
+static boolean mdp_suspend_state_valid = FALSE;
+
+static void mdp_hw_revalidate_workqueue_handler(struct work_struct *work)
+{
+	unsigned long flag;
+
+	/* keep blits out while the LUT and CSC blocks are reloaded */
+	down(&mdp_ppp_mutex);
+	mdp_hw_init();
+	spin_lock_irqsave(&mdp_spin_lock, flag);
+	outp32(MDP_INTR_ENABLE, mdp_intr_mask);
+	spin_unlock_irqrestore(&mdp_spin_lock, flag);
+	up(&mdp_ppp_mutex);
+}
+
+static DECLARE_WORK(mdp_hw_revalidate_worker,
+		    mdp_hw_revalidate_workqueue_handler);
+#endif
+
 static int mdp_off(struct platform_device *pdev)
 {
 	int ret = 0;
@@ -922,6 +959,9 @@ static int mdp_off(struct platform_device *pdev)
 static int mdp_on(struct platform_device *pdev)
 {
 	int ret = 0;
+#ifndef CONFIG_FB_MSM_MDP40
+	unsigned long flag;
+#endif
 #ifdef CONFIG_FB_MSM_MDP40
 	mdp_pipe_ctrl(MDP_CMD_BLOCK, MDP_BLOCK_POWER_ON, FALSE);
 	if (is_mdp4_hw_reset()) {
@@ -932,6 +972,20 @@ static int mdp_on(struct platform_device *pdev)
 #endif
 
 	mdp_pipe_ctrl(MDP_CMD_BLOCK, MDP_BLOCK_POWER_ON, FALSE);
+#ifndef CONFIG_FB_MSM_MDP40
+	if (mdp_suspend_state_valid) {
+		if (inp32(MDP_INTR_ENABLE) != mdp_suspend_intr_snapshot) {
+			/* core was power collapsed; bring up the bare
+			 * minimum here and revalidate in the background */
+			mdp_hw_core_restore();
+			spin_lock_irqsave(&mdp_spin_lock, flag);
+			outp32(MDP_INTR_ENABLE, mdp_intr_mask);
+			spin_unlock_irqrestore(&mdp_spin_lock, flag);
+			schedule_work(&mdp_hw_revalidate_worker);
+		}
+		mdp_suspend_state_valid = FALSE;
+	}
+#endif
 	ret = panel_next_on(pdev);
 	mdp_pipe_ctrl(MDP_CMD_BLOCK, MDP_BLOCK_POWER_OFF, FALSE);
 	return ret;
@@ -1150,6 +1204,8 @@ static int mdp_probe(struct platform_device *pdev)
 	pdata->off = mdp_off;
 	pdata->next = pdev;
 
+	INIT_WORK(&mfd->pan_worker, mdp_pan_update_workqueue_handler);
+
 	switch (mfd->panel.type) {
 	case EXT_MDDI_PANEL:
 	case MDDI_PANEL:
@@ -1364,6 +1420,14 @@ static void mdp_suspend_sub(void)
 	while (atomic_read(&mdp_block_power_cnt[MDP_PPP_BLOCK]) > 0)
 		cpu_relax();
 
+#ifndef CONFIG_FB_MSM_MDP40
+	/* snapshot state for the retained-state check on resume */
+	mdp_pipe_ctrl(MDP_CMD_BLOCK, MDP_BLOCK_POWER_ON, FALSE);
+	mdp_suspend_intr_snapshot = inp32(MDP_INTR_ENABLE);
+	mdp_suspend_state_valid = TRUE;
+	mdp_pipe_ctrl(MDP_CMD_BLOCK, MDP_BLOCK_POWER_OFF, FALSE);
+#endif
+
 	/* try to power down */
 	mdp_pipe_ctrl(MDP_MASTER_BLOCK, MDP_BLOCK_POWER_OFF, FALSE);
 }
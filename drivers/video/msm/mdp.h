@@ -637,16 +637,26 @@ struct mdp_dma_data {
 #define MDP_DMA_P_LUT_POST    BIT(4)
 
 void mdp_hw_init(void);
+void mdp_hw_core_restore(void);
 int mdp_ppp_pipe_wait(void);
+void mdp_ppp_wait(void);
 void mdp_pipe_kickoff(uint32 term, struct msm_fb_data_type *mfd);
 void mdp_pipe_ctrl(MDP_BLOCK_TYPE block, MDP_BLOCK_POWER_STATE state,
 		   boolean isr);
 void mdp_set_dma_pan_info(struct fb_info *info, struct mdp_dirty_region *dirty,
 			  boolean sync);
 void mdp_dma_pan_update(struct fb_info *info);
+void mdp_dma_pan_queue(struct fb_info *info);
 void mdp_refresh_screen(unsigned long data);
+
+extern struct workqueue_struct *mdp_dma_wq;
+extern uint32 mdp_pan_drops;
 int mdp_ppp_blit(struct fb_info *info, struct mdp_blit_req *req);
+int mdp_ppp_blit_addr(struct fb_info *info, struct mdp_blit_req *req,
+		      unsigned long src_start, unsigned long dst_start,
+		      struct file *p_src_file, struct file *p_dst_file);
 void mdp_lcd_update_workqueue_handler(struct work_struct *work);
+void mdp_pan_update_workqueue_handler(struct work_struct *work);
 void mdp_vsync_resync_workqueue_handler(struct work_struct *work);
 void mdp_dma2_update(struct msm_fb_data_type *mfd);
 void mdp_config_vsync(struct msm_fb_data_type *);
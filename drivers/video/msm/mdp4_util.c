@@ -207,6 +207,20 @@ int mdp_ppp_blit(struct fb_info *info, struct mdp_blit_req *req)
 	return -1;
 }
 
+int mdp_ppp_blit_addr(struct fb_info *info, struct mdp_blit_req *req,
+		      unsigned long src_start, unsigned long dst_start,
+		      struct file *p_src_file, struct file *p_dst_file)
+{
+
+	/* not implemented yet */
+	return -1;
+}
+
+void mdp_ppp_wait(void)
+{
+	/* nothing pending; mdp4 has no PPP */
+}
+
 void mdp4_fetch_cfg(uint32 core_clk)
 {
 
@@ -1188,6 +1188,13 @@ int mdp_debugfs_init(void)
 	}
 #endif
 
+	if (debugfs_create_u32("pan_drops", 0444, dent, &mdp_pan_drops)
+			== NULL) {
+		printk(KERN_ERR "%s(%d): debugfs_create_u32: debug fail\n",
+			__FILE__, __LINE__);
+		return -1;
+	}
+
 	dent = debugfs_create_dir("mddi", NULL);
 
 	if (IS_ERR(dent)) {
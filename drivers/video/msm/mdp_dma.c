@@ -58,6 +58,7 @@ uint32 mdp_total_vdopkts;
 
 extern u32 msm_fb_debug_enabled;
 extern struct workqueue_struct *mdp_dma_wq;
+extern struct semaphore msm_fb_pan_sem;
 
 int vsync_start_y_adjust = 4;
 
@@ -501,42 +502,91 @@ void mdp_lcd_update_workqueue_handler(struct work_struct *work)
 		mfd->dma_fnc(mfd);
 }
 
+/* frames superseded before the DMA latched them; see mdp_dma_pan_queue */
+uint32 mdp_pan_drops;
+
+void mdp_pan_update_workqueue_handler(struct work_struct *work)
+{
+	struct msm_fb_data_type *mfd;
+
+	mfd = container_of(work, struct msm_fb_data_type, pan_worker);
+	down(&msm_fb_pan_sem);
+	mdp_dma_pan_update(mfd->fbi);
+	up(&msm_fb_pan_sem);
+}
+
+/*
+ * Queue a pageflip and return without waiting for the panel.  The
+ * singlethreaded mdp_dma_wq gives an effective depth of two (one frame
+ * being pushed, one latched in mfd->ibuf); queueing while a flip is
+ * still pending is a no-op, so the pending work simply pushes whatever
+ * mdp_set_dma_pan_info() latched last and the superseded frame is
+ * counted in mdp_pan_drops.
+ */
+void mdp_dma_pan_queue(struct fb_info *info)
+{
+	struct msm_fb_data_type *mfd = (struct msm_fb_data_type *)info->par;
+
+	queue_work(mdp_dma_wq, &mfd->pan_worker);
+}
+
 void mdp_set_dma_pan_info(struct fb_info *info, struct mdp_dirty_region *dirty,
 			  boolean sync)
 {
 	struct msm_fb_data_type *mfd = (struct msm_fb_data_type *)info->par;
 	MDPIBUF *iBuf;
 	int bpp = info->var.bits_per_pixel / 8;
+	uint8 *buf;
 
 	down(&mfd->sem);
 	iBuf = &mfd->ibuf;
-	iBuf->buf = (uint8 *) info->fix.smem_start;
-	iBuf->buf += info->var.xoffset * bpp +
+	buf = (uint8 *) info->fix.smem_start;
+	buf += info->var.xoffset * bpp +
 			info->var.yoffset * info->fix.line_length;
 
-	iBuf->ibuf_width = info->var.xres_virtual;
-	iBuf->bpp = bpp;
+	/* a frame queued but never latched by the DMA is superseded */
+	if (!mfd->ibuf_flushed && iBuf->buf && buf != iBuf->buf)
+		mdp_pan_drops++;
+
+	/*
+	 * Clip the DMA transfer (and hence the panel window) to the
+	 * changed region when the caller supplied one; the rectangle was
+	 * already validated against xres/yres in msm_fb_pan_display().
+	 */
+	if (dirty) {
+		uint32 x1 = dirty->xoffset;
+		uint32 y1 = dirty->yoffset;
+		uint32 x2 = dirty->xoffset + dirty->width;
+		uint32 y2 = dirty->yoffset + dirty->height;
 
-	iBuf->vsync_enable = sync;
-    iBuf->dma_x = 0;
-    iBuf->dma_y = 0;
-    iBuf->dma_w = info->var.xres;
-    iBuf->dma_h = info->var.yres;
-//	if (dirty) {
 		/*
-		 * ToDo: dirty region check inside var.xoffset+xres
-		 * <-> var.yoffset+yres
+		 * If damage queued for the same buffer has not been
+		 * pushed to the panel yet, widen the rectangle to cover
+		 * it too so no pending region is lost.
 		 */
-	/*	iBuf->dma_x = dirty->xoffset % info->var.xres;
-		iBuf->dma_y = dirty->yoffset % info->var.yres;
-		iBuf->dma_w = dirty->width;
-		iBuf->dma_h = dirty->height;
+		if (!mfd->ibuf_flushed && buf == iBuf->buf) {
+			x1 = min(x1, (uint32) iBuf->dma_x);
+			y1 = min(y1, (uint32) iBuf->dma_y);
+			x2 = max(x2, iBuf->dma_x + iBuf->dma_w);
+			y2 = max(y2, iBuf->dma_y + iBuf->dma_h);
+		}
+
+		iBuf->dma_x = x1;
+		iBuf->dma_y = y1;
+		iBuf->dma_w = x2 - x1;
+		iBuf->dma_h = y2 - y1;
 	} else {
 		iBuf->dma_x = 0;
 		iBuf->dma_y = 0;
 		iBuf->dma_w = info->var.xres;
 		iBuf->dma_h = info->var.yres;
-	}*/
+	}
+	iBuf->buf = buf;
+
+	iBuf->ibuf_width = info->var.xres_virtual;
+	iBuf->bpp = bpp;
+
+	iBuf->vsync_enable = sync;
 	mfd->ibuf_flushed = FALSE;
 	up(&mfd->sem);
 }
@@ -701,6 +701,35 @@ void mdp_load_thunder_lut(int lut_type)
 
 #define   IRQ_EN_1__MDP_IRQ___M    0x00000800
 
+/*
+ * The bare minimum needed to bring the core back up after it has been
+ * power collapsed: just the registers the next DMA/PPP kickoff depends
+ * on.  The LUT is left bypassed and the CSC blocks untouched so the
+ * screen-on path does not pay for reloading them; mdp_hw_init() is
+ * replayed afterwards as a background validation pass.  The caller
+ * must hold an MDP cmd block power vote and is responsible for
+ * reprogramming MDP_INTR_ENABLE.
+ */
+void mdp_hw_core_restore(void)
+{
+	/* debug interface write access */
+	outpdw(MDP_BASE + 0x60, 1);
+
+	outp32(MDP_EBI2_PORTMAP_MODE, 0x3);
+	outpdw(MDP_CMD_DEBUG_ACCESS_BASE + 0x01f8, 0x0);
+	outpdw(MDP_CMD_DEBUG_ACCESS_BASE + 0x01fc, 0x0);
+	outpdw(MDP_BASE + 0x60, 0x1);
+
+#ifndef CONFIG_FB_MSM_MDP22
+	MDP_OUTP(MDP_BASE + 0xE0000, 0);
+	MDP_OUTP(MDP_BASE + 0x100, 0xffffffff);
+	/* LUT bypassed until mdp_load_lut_param() has run */
+	MDP_OUTP(MDP_BASE + 0x90070, 0);
+	MDP_OUTP(MDP_BASE + 0x94010, 1);
+	MDP_OUTP(MDP_BASE + 0x9401c, 2);
+#endif
+}
+
 void mdp_hw_init(void)
 {
 	int i;
@@ -708,14 +737,9 @@ void mdp_hw_init(void)
 	/* MDP cmd block enable */
 	mdp_pipe_ctrl(MDP_CMD_BLOCK, MDP_BLOCK_POWER_ON, FALSE);
 
-	/* debug interface write access */
-	outpdw(MDP_BASE + 0x60, 1);
+	mdp_hw_core_restore();
 
 	outp32(MDP_INTR_ENABLE, MDP_ANY_INTR_MASK);
-	outp32(MDP_EBI2_PORTMAP_MODE, 0x3);
-	outpdw(MDP_CMD_DEBUG_ACCESS_BASE + 0x01f8, 0x0);
-	outpdw(MDP_CMD_DEBUG_ACCESS_BASE + 0x01fc, 0x0);
-	outpdw(MDP_BASE + 0x60, 0x1);
 	mdp_load_lut_param();
 
 	/*
@@ -748,14 +772,6 @@ void mdp_hw_init(void)
 	MDP_OUTP(MDP_CMD_DEBUG_ACCESS_BASE + 0x01e0, 0);
 	MDP_OUTP(MDP_CMD_DEBUG_ACCESS_BASE + 0x01e4, 0);
 
-#ifndef CONFIG_FB_MSM_MDP22
-	MDP_OUTP(MDP_BASE + 0xE0000, 0);
-	MDP_OUTP(MDP_BASE + 0x100, 0xffffffff);
-	MDP_OUTP(MDP_BASE + 0x90070, 0);
-	MDP_OUTP(MDP_BASE + 0x94010, 1);
-	MDP_OUTP(MDP_BASE + 0x9401c, 2);
-#endif
-
 #if defined(CONFIG_MACH_MSM7X27_THUNDERG) || defined(CONFIG_MACH_MSM7X27_THUNDERC)
 	/* LGE_CHANGE_S
 	  * Change code to apply new LUT for display quality. 2010-08-03. minjong.gong@lge.com 
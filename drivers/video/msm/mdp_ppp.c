@@ -579,6 +579,41 @@ static void flush_imgs(struct mdp_blit_req *req, int src_bpp, int dst_bpp,
 			struct file *p_src_file, struct file *p_dst_file) { }
 #endif
 
+void put_img(struct file *p_src_file);
+
+/*
+ * One blit may be in flight on the PPP after mdp_pipe_kickoff() returns.
+ * Its image file references are parked here until the pipe is reaped, so
+ * the CPU can program the next blit of a batch while this one runs.
+ * Protected by mdp_ppp_mutex.
+ */
+static int mdp_ppp_busy;
+static struct file *mdp_ppp_busy_src_file;
+static struct file *mdp_ppp_busy_dst_file;
+
+static void mdp_ppp_drain(void)
+{
+	if (!mdp_ppp_busy)
+		return;
+
+	do { } while (mdp_ppp_pipe_wait() <= 0);
+	mdp_disable_irq(MDP_PPP_TERM);
+
+	put_img(mdp_ppp_busy_src_file);
+	put_img(mdp_ppp_busy_dst_file);
+	mdp_ppp_busy_src_file = NULL;
+	mdp_ppp_busy_dst_file = NULL;
+	mdp_ppp_busy = 0;
+}
+
+/* Wait for any in-flight blit to retire and release its images. */
+void mdp_ppp_wait(void)
+{
+	down(&mdp_ppp_mutex);
+	mdp_ppp_drain();
+	up(&mdp_ppp_mutex);
+}
+
 static void mdp_start_ppp(struct msm_fb_data_type *mfd, MDPIBUF *iBuf,
 struct mdp_blit_req *req, struct file *p_src_file, struct file *p_dst_file)
 {
@@ -614,8 +649,8 @@ struct mdp_blit_req *req, struct file *p_src_file, struct file *p_dst_file)
 	ppp_dst_cfg_reg = 0;
 	ppp_src_cfg_reg = 0;
 
-	/* Wait for the pipe to clear */
-	do { } while (mdp_ppp_pipe_wait() <= 0);
+	/* Reap the previous blit before reprogramming the pipe */
+	mdp_ppp_drain();
 
 	/*
 	 * destination config
@@ -1156,6 +1191,7 @@ struct mdp_blit_req *req, struct file *p_src_file, struct file *p_dst_file)
 	MDP_OUTP(MDP_BASE + 0x00100, 0xFF00);
 #endif
 	mdp_pipe_kickoff(MDP_PPP_TERM, mfd);
+	mdp_ppp_busy = 1;
 }
 
 static int mdp_ppp_verify_req(struct mdp_blit_req *req)
@@ -1300,39 +1336,20 @@ void put_img(struct file *p_src_file)
 }
 
 
-int mdp_ppp_blit(struct fb_info *info, struct mdp_blit_req *req)
+/*
+ * Same as mdp_ppp_blit() but with the source and destination buffers
+ * already resolved to bus addresses.  Kernel-internal callers (the
+ * fbcon scroll acceleration in msm_fb) use this to blit within the
+ * framebuffer itself, where there is no file descriptor to look up.
+ */
+int mdp_ppp_blit_addr(struct fb_info *info, struct mdp_blit_req *req,
+		      unsigned long src_start, unsigned long dst_start,
+		      struct file *p_src_file, struct file *p_dst_file)
 {
-	unsigned long src_start, dst_start;
-	unsigned long src_len = 0;
-	unsigned long dst_len = 0;
 	MDPIBUF iBuf;
 	u32 dst_width, dst_height;
-	struct file *p_src_file = 0 , *p_dst_file = 0;
 	struct msm_fb_data_type *mfd = (struct msm_fb_data_type *)info->par;
 
-	if (req->dst.format == MDP_FB_FORMAT)
-		req->dst.format =  mfd->fb_imgType;
-	if (req->src.format == MDP_FB_FORMAT)
-		req->src.format = mfd->fb_imgType;
-	if (req->flags & MDP_BLIT_SRC_GEM)
-		get_gem_img(&req->src, &src_start, &src_len);
-	else
-		get_img(&req->src, info, &src_start, &src_len, &p_src_file);
-	if (src_len == 0) {
-		printk(KERN_ERR "mdp_ppp: could not retrieve image from "
-		       "memory\n");
-		return -1;
-	}
-	if (req->flags & MDP_BLIT_DST_GEM)
-		get_gem_img(&req->dst, &dst_start, &dst_len);
-	else
-		get_img(&req->dst, info, &dst_start, &dst_len, &p_dst_file);
-	if (dst_len == 0) {
-		put_img(p_src_file);
-		printk(KERN_ERR "mdp_ppp: could not retrieve image from "
-		       "memory\n");
-		return -1;
-	}
 	if (mdp_ppp_verify_req(req)) {
 		printk(KERN_ERR "mdp_ppp: invalid image!\n");
 		put_img(p_src_file);
@@ -1562,9 +1579,50 @@ int mdp_ppp_blit(struct fb_info *info, struct mdp_blit_req *req)
 
 	/* MDP cmd block disable */
 	mdp_pipe_ctrl(MDP_CMD_BLOCK, MDP_BLOCK_POWER_OFF, FALSE);
+
+	/*
+	 * The last kickoff is still running; park the image references
+	 * for mdp_ppp_drain() to release once the pipe is reaped.
+	 */
+	mdp_ppp_busy_src_file = p_src_file;
+	mdp_ppp_busy_dst_file = p_dst_file;
 	up(&mdp_ppp_mutex);
 
-	put_img(p_src_file);
-	put_img(p_dst_file);
 	return 0;
 }
+
+int mdp_ppp_blit(struct fb_info *info, struct mdp_blit_req *req)
+{
+	unsigned long src_start, dst_start;
+	unsigned long src_len = 0;
+	unsigned long dst_len = 0;
+	struct file *p_src_file = 0 , *p_dst_file = 0;
+	struct msm_fb_data_type *mfd = (struct msm_fb_data_type *)info->par;
+
+	if (req->dst.format == MDP_FB_FORMAT)
+		req->dst.format =  mfd->fb_imgType;
+	if (req->src.format == MDP_FB_FORMAT)
+		req->src.format = mfd->fb_imgType;
+	if (req->flags & MDP_BLIT_SRC_GEM)
+		get_gem_img(&req->src, &src_start, &src_len);
+	else
+		get_img(&req->src, info, &src_start, &src_len, &p_src_file);
+	if (src_len == 0) {
+		printk(KERN_ERR "mdp_ppp: could not retrieve image from "
+		       "memory\n");
+		return -1;
+	}
+	if (req->flags & MDP_BLIT_DST_GEM)
+		get_gem_img(&req->dst, &dst_start, &dst_len);
+	else
+		get_img(&req->dst, info, &dst_start, &dst_len, &p_dst_file);
+	if (dst_len == 0) {
+		put_img(p_src_file);
+		printk(KERN_ERR "mdp_ppp: could not retrieve image from "
+		       "memory\n");
+		return -1;
+	}
+
+	return mdp_ppp_blit_addr(info, req, src_start, dst_start,
+				 p_src_file, p_dst_file);
+}
@@ -37,6 +37,7 @@
 #include <linux/vmalloc.h>
 #include <linux/debugfs.h>
 #include <linux/console.h>
+#include <linux/hardirq.h>
 #include <linux/android_pmem.h>
 #include <linux/leds.h>
 #include <linux/pm_runtime.h>
@@ -490,6 +491,9 @@ static int msm_fb_suspend_sub(struct msm_fb_data_type *mfd)
 	if ((!mfd) || (mfd->key != MFD_KEY))
 		return 0;
 
+	/* retire any queued pageflip before powering the panel down */
+	flush_workqueue(mdp_dma_wq);
+
 	/*
 	 * suspend this channel
 	 */
@@ -779,12 +783,93 @@ static void msm_fb_fillrect(struct fb_info *info,
 	}
 }
 
+/*
+ * fbcon scrolls by copying nearly the whole visible page onto itself,
+ * which at WVGA is slow enough in software to throttle verbose boot and
+ * recovery output.  Do the copy with a PPP screen-to-screen blit
+ * instead.  The PPP offers no control over its processing direction, so
+ * an overlapping copy (the scroll case) is bounced through the spare
+ * framebuffer page; fbcon only ever draws page zero, and while the
+ * console owns the display nothing else uses the back page.  Returns
+ * nonzero when the caller must fall back to the software copy.
+ */
+static int msm_fb_ppp_copyarea(struct fb_info *info,
+			       const struct fb_copyarea *area)
+{
+	struct msm_fb_data_type *mfd = (struct msm_fb_data_type *)info->par;
+	u32 bpp = info->var.bits_per_pixel >> 3;
+	u32 page_len = info->var.yres * info->fix.line_length;
+	struct mdp_blit_req req;
+	int ret;
+
+	if (!mfd->panel_power_on || !bpp || !info->fix.smem_start)
+		return -EINVAL;
+
+	/* the blit path takes mutexes and waits for the pipe */
+	if (in_interrupt() || in_atomic() || irqs_disabled() ||
+	    oops_in_progress)
+		return -EBUSY;
+
+	if (area->sx + area->width > info->var.xres ||
+	    area->dx + area->width > info->var.xres ||
+	    area->sy + area->height > info->var.yres ||
+	    area->dy + area->height > info->var.yres)
+		return -EINVAL;
+
+	memset(&req, 0, sizeof(req));
+	req.src.width = info->fix.line_length / bpp;
+	req.src.height = info->var.yres;
+	req.src.format = mfd->fb_imgType;
+	req.dst = req.src;
+	req.alpha = MDP_ALPHA_NOP;
+	req.transp_mask = MDP_TRANSP_NOP;
+
+	req.src_rect.x = area->sx;
+	req.src_rect.y = area->sy;
+	req.src_rect.w = area->width;
+	req.src_rect.h = area->height;
+	req.dst_rect = req.src_rect;
+	req.dst_rect.x = area->dx;
+	req.dst_rect.y = area->dy;
+
+	if (area->sx < area->dx + area->width &&
+	    area->dx < area->sx + area->width &&
+	    area->sy < area->dy + area->height &&
+	    area->dy < area->sy + area->height) {
+		/* overlapping: copy out to the back page and back in */
+		if (info->fix.smem_len < 2 * page_len)
+			return -EINVAL;
+
+		req.dst.offset = page_len;
+		req.dst_rect = req.src_rect;
+		ret = mdp_ppp_blit_addr(info, &req, info->fix.smem_start,
+					info->fix.smem_start, NULL, NULL);
+		if (ret)
+			return ret;
+
+		req.src.offset = page_len;
+		req.dst.offset = 0;
+		req.dst_rect.x = area->dx;
+		req.dst_rect.y = area->dy;
+	}
+
+	ret = mdp_ppp_blit_addr(info, &req, info->fix.smem_start,
+				info->fix.smem_start, NULL, NULL);
+	if (ret)
+		return ret;
+
+	/* fbcon draws over the scrolled region as soon as we return */
+	mdp_ppp_wait();
+	return 0;
+}
+
 static void msm_fb_copyarea(struct fb_info *info,
 			    const struct fb_copyarea *area)
 {
 	struct msm_fb_data_type *mfd = (struct msm_fb_data_type *)info->par;
 
-	cfb_copyarea(info, area);
+	if (msm_fb_ppp_copyarea(info, area))
+		cfb_copyarea(info, area);
 	if (!mfd->hw_refresh && (info->var.yoffset == 0) &&
 		!mfd->sw_currently_refreshing) {
 		struct fb_var_screeninfo var;
@@ -1465,7 +1550,15 @@ static int msm_fb_pan_display(struct fb_var_screeninfo *var,
 	down(&msm_fb_pan_sem);
 	mdp_set_dma_pan_info(info, dirtyPtr,
 			     (var->activate == FB_ACTIVATE_VBL));
-	mdp_dma_pan_update(info);
+	/*
+	 * Vblank-synchronized flips are queued so the caller does not
+	 * block for up to a frame; everything else (fbcon, tools doing
+	 * FB_ACTIVATE_NOW) keeps the synchronous push.
+	 */
+	if (var->activate == FB_ACTIVATE_VBL)
+		mdp_dma_pan_queue(info);
+	else
+		mdp_dma_pan_update(info);
 	up(&msm_fb_pan_sem);
 
 	++mfd->panel_info.frame_count;
@@ -2427,11 +2520,19 @@ static int msmfb_blit(struct fb_info *info, void __user *p)
 				 * Note that early returns don't guarantee
 				 * memory coherency.
 				 */
-				if (ret)
+				if (ret) {
+					mdp_ppp_wait();
 					return ret;
+				}
 			}
 		}
 
+		/*
+		 * Reap the last blit of the window; earlier ones were
+		 * reaped when their successors were programmed.
+		 */
+		mdp_ppp_wait();
+
 		/*
 		 * Ensure that CPU cache and other internal CPU state is
 		 * updated to reflect any change in memory modified by MDP blit
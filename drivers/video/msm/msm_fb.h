@@ -110,6 +110,7 @@ struct msm_fb_data_type {
 
 	boolean panel_power_on;
 	struct work_struct dma_update_worker;
+	struct work_struct pan_worker;
 	struct semaphore sem;
 
 	struct timer_list vsync_resync_timer;
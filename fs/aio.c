@@ -67,6 +67,9 @@ static LIST_HEAD(fput_head);
 
 #define AIO_BATCH_HASH_BITS	3 /* allocated on-stack, so don't go crazy */
 #define AIO_BATCH_HASH_SIZE	(1 << AIO_BATCH_HASH_BITS)
+
+/* iocb pointers fetched per copy_from_user() in do_io_submit() */
+#define AIO_SUBMIT_BATCH	32
 struct aio_batch_entry {
 	struct hlist_node list;
 	struct address_space *mapping;
@@ -1053,6 +1056,45 @@ out:
 	return ret;
 }
 
+/* aio_read_evt_batch
+ *	Pull up to @nr events off of the ioctx's event ring with a single
+ *	acquisition of the ring lock.  Returns the number of events fetched.
+ */
+static int aio_read_evt_batch(struct kioctx *ioctx, struct io_event *ents,
+			      int nr)
+{
+	struct aio_ring_info *info = &ioctx->ring_info;
+	struct aio_ring *ring;
+	unsigned long head;
+	int ret = 0;
+
+	ring = kmap_atomic(info->ring_pages[0], KM_USER0);
+
+	if (ring->head == ring->tail)
+		goto out;
+
+	spin_lock(&info->ring_lock);
+
+	head = ring->head % info->nr;
+	while (ret < nr && head != ring->tail) {
+		struct io_event *evp = aio_ring_event(info, head, KM_USER1);
+		ents[ret++] = *evp;
+		head = (head + 1) % info->nr;
+		put_aio_ring_event(evp, KM_USER1);
+	}
+	if (ret) {
+		smp_mb(); /* finish reading the events before updatng the head */
+		ring->head = head;
+	}
+	spin_unlock(&info->ring_lock);
+
+out:
+	kunmap_atomic(ring, KM_USER0);
+	dprintk("leaving aio_read_evt_batch: %d  h%lu t%lu\n", ret,
+		 (unsigned long)ring->head, (unsigned long)ring->tail);
+	return ret;
+}
+
 struct aio_timeout {
 	struct timer_list	timer;
 	int			timed_out;
@@ -1089,6 +1131,9 @@ static inline void clear_timeout(struct aio_timeout *to)
 	del_singleshot_timer_sync(&to->timer);
 }
 
+/* Events staged on the stack per ring lock acquisition in read_events() */
+#define AIO_READ_BATCH	16
+
 static int read_events(struct kioctx *ctx,
 			long min_nr, long nr,
 			struct io_event __user *event,
@@ -1100,34 +1145,38 @@ static int read_events(struct kioctx *ctx,
 	int			ret;
 	int			i = 0;
 	struct io_event		ent;
+	struct io_event		ents[AIO_READ_BATCH];
 	struct aio_timeout	to;
 	int			retry = 0;
 
-	/* needed to zero any padding within an entry (there shouldn't be 
+	/* needed to zero any padding within an entry (there shouldn't be
 	 * any, but C is fun!
 	 */
 	memset(&ent, 0, sizeof(ent));
+	memset(ents, 0, sizeof(ents));
 retry:
 	ret = 0;
 	while (likely(i < nr)) {
-		ret = aio_read_evt(ctx, &ent);
+		int this = min_t(long, nr - i, AIO_READ_BATCH);
+
+		ret = aio_read_evt_batch(ctx, ents, this);
 		if (unlikely(ret <= 0))
 			break;
 
-		dprintk("read event: %Lx %Lx %Lx %Lx\n",
-			ent.data, ent.obj, ent.res, ent.res2);
+		dprintk("read %d events: first %Lx %Lx %Lx %Lx\n", ret,
+			ents[0].data, ents[0].obj, ents[0].res, ents[0].res2);
 
-		/* Could we split the check in two? */
-		ret = -EFAULT;
-		if (unlikely(copy_to_user(event, &ent, sizeof(ent)))) {
-			dprintk("aio: lost an event due to EFAULT.\n");
+		if (unlikely(copy_to_user(event, ents,
+					  ret * sizeof(ents[0])))) {
+			dprintk("aio: lost events due to EFAULT.\n");
+			ret = -EFAULT;
 			break;
 		}
-		ret = 0;
 
-		/* Good, event copied to userland, update counts. */
-		event ++;
-		i ++;
+		/* Good, events copied to userland, update counts. */
+		event += ret;
+		i += ret;
+		ret = 0;
 	}
 
 	if (min_nr <= i)
@@ -1682,23 +1731,38 @@ long do_io_submit(aio_context_t ctx_id, long nr,
 	/*
 	 * AKPM: should this return a partial result if some of the IOs were
 	 * successfully submitted?
+	 *
+	 * The iocb pointer array is pulled in AIO_SUBMIT_BATCH entries at a
+	 * time, so large submissions pay one uaccess per batch rather than
+	 * one __get_user() per iocb.
 	 */
-	for (i=0; i<nr; i++) {
-		struct iocb __user *user_iocb;
-		struct iocb tmp;
+	for (i = 0; i < nr;) {
+		struct iocb __user *ulist[AIO_SUBMIT_BATCH];
+		long this = min_t(long, nr - i, AIO_SUBMIT_BATCH);
+		long j;
 
-		if (unlikely(__get_user(user_iocb, iocbpp + i))) {
+		if (unlikely(copy_from_user(ulist, iocbpp + i,
+					    this * sizeof(*iocbpp)))) {
 			ret = -EFAULT;
 			break;
 		}
 
-		if (unlikely(copy_from_user(&tmp, user_iocb, sizeof(tmp)))) {
-			ret = -EFAULT;
-			break;
-		}
+		for (j = 0; j < this; j++) {
+			struct iocb tmp;
 
-		ret = io_submit_one(ctx, user_iocb, &tmp, batch_hash, compat);
-		if (ret)
+			if (unlikely(copy_from_user(&tmp, ulist[j],
+						    sizeof(tmp)))) {
+				ret = -EFAULT;
+				break;
+			}
+
+			ret = io_submit_one(ctx, ulist[j], &tmp, batch_hash,
+					    compat);
+			if (ret)
+				break;
+			i++;
+		}
+		if (j < this)
 			break;
 	}
 	aio_batch_free(batch_hash);
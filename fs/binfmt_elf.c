@@ -57,6 +57,16 @@ static int elf_core_dump(struct coredump_params *cprm);
 #define ELF_MIN_ALIGN	PAGE_SIZE
 #endif
 
+/*
+ * Kick off readahead for the leading part of the text segment at exec
+ * time.  Cold application start is otherwise serialized on one demand
+ * fault at a time, which hurts badly on slow flash media.  The reads
+ * are only queued here; they complete while the rest of the binary is
+ * being set up.  0 disables the readahead.
+ */
+static unsigned int exec_readahead_kb = 512;
+module_param(exec_readahead_kb, uint, 0644);
+
 #ifndef ELF_CORE_EFLAGS
 #define ELF_CORE_EFLAGS	0
 #endif
@@ -577,6 +587,7 @@ static int load_elf_binary(struct linux_binprm *bprm, struct pt_regs *regs)
 	unsigned long start_code, end_code, start_data, end_data;
 	unsigned long reloc_func_desc = 0;
 	int executable_stack = EXSTACK_DEFAULT;
+	int text_readahead_done = 0;
 	unsigned long def_flags = 0;
 	struct {
 		struct elfhdr elf_ex;
@@ -792,6 +803,19 @@ static int load_elf_binary(struct linux_binprm *bprm, struct pt_regs *regs)
 
 		elf_flags = MAP_PRIVATE | MAP_DENYWRITE | MAP_EXECUTABLE;
 
+		if ((elf_ppnt->p_flags & PF_X) && exec_readahead_kb &&
+		    !text_readahead_done) {
+			unsigned long ra_bytes =
+				min_t(unsigned long, elf_ppnt->p_filesz,
+				      (unsigned long)exec_readahead_kb << 10);
+
+			force_page_cache_readahead(bprm->file->f_mapping,
+				bprm->file,
+				elf_ppnt->p_offset >> PAGE_CACHE_SHIFT,
+				DIV_ROUND_UP(ra_bytes, PAGE_CACHE_SIZE));
+			text_readahead_done = 1;
+		}
+
 		vaddr = elf_ppnt->p_vaddr;
 		if (loc->elf_ex.e_type == ET_EXEC || load_addr_set) {
 			elf_flags |= MAP_FIXED;
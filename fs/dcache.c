@@ -33,11 +33,19 @@
 #include <linux/bootmem.h>
 #include <linux/fs_struct.h>
 #include <linux/hardirq.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
 #include "internal.h"
 
 int sysctl_vfs_cache_pressure __read_mostly = 100;
 EXPORT_SYMBOL_GPL(sysctl_vfs_cache_pressure);
 
+/*
+ * Upper bound on the number of negative dentries kept per superblock,
+ * enforced when a new negative dentry is added.  0 means no limit.
+ */
+int sysctl_neg_dentry_limit __read_mostly;
+
  __cacheline_aligned_in_smp DEFINE_SPINLOCK(dcache_lock);
 __cacheline_aligned_in_smp DEFINE_SEQLOCK(rename_lock);
 
@@ -157,6 +165,25 @@ static void dentry_lru_del_init(struct dentry *dentry)
 	}
 }
 
+/*
+ * Negative dentry accounting.  The count is kept per superblock so that
+ * a lookup-miss heavy filesystem can be capped without disturbing the
+ * dentry population of the others.  Dentries allocated without a
+ * superblock (anonymous and root dentries in the making) are not
+ * counted until they have one.
+ */
+static inline void dentry_neg_inc(struct dentry *dentry)
+{
+	if (dentry->d_sb)
+		atomic_inc(&dentry->d_sb->s_nr_neg_dentry);
+}
+
+static inline void dentry_neg_dec(struct dentry *dentry)
+{
+	if (dentry->d_sb)
+		atomic_dec(&dentry->d_sb->s_nr_neg_dentry);
+}
+
 /**
  * d_kill - kill dentry and return parent
  * @dentry: dentry to kill
@@ -171,6 +198,8 @@ static struct dentry *d_kill(struct dentry *dentry)
 {
 	struct dentry *parent;
 
+	if (!dentry->d_inode)
+		dentry_neg_dec(dentry);
 	list_del(&dentry->d_u.d_child);
 	dentry_stat.nr_dentry--;	/* For d_free, below */
 	/*drops the locks, at that point nobody can reach this dentry */
@@ -525,6 +554,70 @@ restart:
 	spin_unlock(&dcache_lock);
 }
 
+/*
+ * Trim the tail of @sb's dentry LRU back down towards the negative
+ * dentry limit.  Positive dentries found on the way are put back at the
+ * head of the LRU, mirroring the DCACHE_REFERENCED handling in
+ * __shrink_dcache_sb().  The scan is bounded so that a lookup-miss
+ * storm pays a small constant cost per miss instead of a full LRU walk.
+ */
+static void prune_negative_dentries(struct super_block *sb)
+{
+	LIST_HEAD(kept);
+	LIST_HEAD(tmp);
+	struct dentry *dentry;
+	int excess = atomic_read(&sb->s_nr_neg_dentry) - sysctl_neg_dentry_limit;
+	int scan = 128;
+
+	spin_lock(&dcache_lock);
+	while (excess > 0 && scan-- && !list_empty(&sb->s_dentry_lru)) {
+		dentry = list_entry(sb->s_dentry_lru.prev,
+				struct dentry, d_lru);
+		BUG_ON(dentry->d_sb != sb);
+
+		spin_lock(&dentry->d_lock);
+		if (dentry->d_inode) {
+			list_move(&dentry->d_lru, &kept);
+			spin_unlock(&dentry->d_lock);
+		} else {
+			list_move_tail(&dentry->d_lru, &tmp);
+			spin_unlock(&dentry->d_lock);
+			excess--;
+		}
+		cond_resched_lock(&dcache_lock);
+	}
+	while (!list_empty(&tmp)) {
+		dentry = list_entry(tmp.prev, struct dentry, d_lru);
+		dentry_lru_del_init(dentry);
+		spin_lock(&dentry->d_lock);
+		if (atomic_read(&dentry->d_count)) {
+			spin_unlock(&dentry->d_lock);
+			continue;
+		}
+		prune_one_dentry(dentry);
+		/* dentry->d_lock was dropped in prune_one_dentry() */
+		cond_resched_lock(&dcache_lock);
+	}
+	if (!list_empty(&kept))
+		list_splice(&kept, &sb->s_dentry_lru);
+	spin_unlock(&dcache_lock);
+}
+
+/*
+ * Called after a negative dentry has been added.  Keeps the per-sb
+ * negative dentry population at the fs.negative-dentry-limit sysctl
+ * (0 disables the cap).
+ */
+static void dentry_neg_cap(struct super_block *sb)
+{
+	int limit = sysctl_neg_dentry_limit;
+
+	if (!limit || !sb)
+		return;
+	if (atomic_read(&sb->s_nr_neg_dentry) > limit)
+		prune_negative_dentries(sb);
+}
+
 /**
  * prune_dcache - shrink the dcache
  * @count: number of entries to try to free
@@ -971,6 +1064,7 @@ struct dentry *d_alloc(struct dentry * parent, const struct qstr *name)
 	if (parent)
 		list_add(&dentry->d_u.d_child, &parent->d_subdirs);
 	dentry_stat.nr_dentry++;
+	dentry_neg_inc(dentry);
 	spin_unlock(&dcache_lock);
 
 	return dentry;
@@ -991,8 +1085,10 @@ EXPORT_SYMBOL(d_alloc_name);
 /* the caller must hold dcache_lock */
 static void __d_instantiate(struct dentry *dentry, struct inode *inode)
 {
-	if (inode)
+	if (inode) {
 		list_add(&dentry->d_alias, &inode->i_dentry);
+		dentry_neg_dec(dentry);
+	}
 	dentry->d_inode = inode;
 	fsnotify_d_instantiate(dentry, inode);
 }
@@ -1019,6 +1115,8 @@ void d_instantiate(struct dentry *entry, struct inode * inode)
 	__d_instantiate(entry, inode);
 	spin_unlock(&dcache_lock);
 	security_d_instantiate(entry, inode);
+	if (!inode)
+		dentry_neg_cap(entry->d_sb);
 }
 EXPORT_SYMBOL(d_instantiate);
 
@@ -1112,6 +1210,8 @@ struct dentry * d_alloc_root(struct inode * root_inode)
 		if (res) {
 			res->d_sb = root_inode->i_sb;
 			res->d_parent = res;
+			/* not counted in d_alloc(); ->d_sb is known only now */
+			dentry_neg_inc(res);
 			d_instantiate(res, root_inode);
 		}
 	}
@@ -1431,6 +1531,14 @@ next:
  	}
  	rcu_read_unlock();
 
+	if (found) {
+		/* racy, but these are only ever used as rough rates */
+		if (found->d_inode)
+			parent->d_sb->s_pos_dentry_hits++;
+		else
+			parent->d_sb->s_neg_dentry_hits++;
+	}
+
  	return found;
 }
 
@@ -1532,6 +1640,7 @@ void d_delete(struct dentry * dentry)
 	isdir = S_ISDIR(dentry->d_inode->i_mode);
 	if (atomic_read(&dentry->d_count) == 1) {
 		dentry->d_flags &= ~DCACHE_CANT_MOUNT;
+		dentry_neg_inc(dentry);	/* stays around as a negative dentry */
 		dentry_iput(dentry);
 		fsnotify_nameremove(dentry, isdir);
 		return;
@@ -2276,6 +2385,52 @@ ino_t find_inode_number(struct dentry *dir, struct qstr *name)
 }
 EXPORT_SYMBOL(find_inode_number);
 
+#ifdef CONFIG_PROC_FS
+/*
+ * /proc/fs/negative_dentries: per superblock negative dentry population
+ * and positive/negative lookup hit counters, for judging how a
+ * fs.negative-dentry-limit setting is behaving.
+ */
+static int negative_dentries_show(struct seq_file *m, void *v)
+{
+	struct super_block *sb;
+
+	seq_printf(m, "%-32s %10s %12s %12s\n",
+			"device", "negative", "neg_hits", "pos_hits");
+	spin_lock(&sb_lock);
+	list_for_each_entry(sb, &super_blocks, s_list) {
+		if (list_empty(&sb->s_instances))
+			continue;
+		seq_printf(m, "%-32s %10d %12lu %12lu\n", sb->s_id,
+				atomic_read(&sb->s_nr_neg_dentry),
+				sb->s_neg_dentry_hits,
+				sb->s_pos_dentry_hits);
+	}
+	spin_unlock(&sb_lock);
+	return 0;
+}
+
+static int negative_dentries_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, negative_dentries_show, NULL);
+}
+
+static const struct file_operations negative_dentries_fops = {
+	.open		= negative_dentries_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+static int __init negative_dentries_proc_init(void)
+{
+	proc_create("fs/negative_dentries", S_IRUGO, NULL,
+			&negative_dentries_fops);
+	return 0;
+}
+fs_initcall(negative_dentries_proc_init);
+#endif
+
 static __initdata unsigned long dhash_entries;
 static int __init set_dhash_entries(char *str)
 {
@@ -39,9 +39,12 @@
 
 /*
  * How many user pages to map in one call to get_user_pages().  This determines
- * the size of a structure on the stack.
+ * the size of the page array in struct dio, which is kmalloced per request.
+ * A 1MB window keeps the mapping overhead of large streaming O_DIRECT
+ * transfers down to one get_user_pages() round trip per megabyte while
+ * bios continue to be built and submitted out of the current window.
  */
-#define DIO_PAGES	64
+#define DIO_PAGES	256
 
 /*
  * This code generally works in units of "dio_blocks".  A dio_block is
@@ -26,6 +26,7 @@
 #include <linux/file.h>
 #include <linux/fdtable.h>
 #include <linux/mm.h>
+#include <linux/vmacache.h>
 #include <linux/stat.h>
 #include <linux/fcntl.h>
 #include <linux/smp_lock.h>
@@ -782,6 +783,13 @@ static int exec_mmap(struct mm_struct *mm)
 	task_lock(tsk);
 	active_mm = tsk->active_mm;
 	tsk->mm = mm;
+	/*
+	 * Drop the cached vmas pointing into the old mm: the new mm
+	 * starts with vmacache_seqnum zero, so a stale match would
+	 * otherwise be possible.
+	 */
+	tsk->vmacache_seqnum = 0;
+	vmacache_flush(tsk);
 	tsk->active_mm = mm;
 	activate_mm(active_mm, mm);
 	task_unlock(tsk);
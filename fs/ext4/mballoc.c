@@ -2588,8 +2588,18 @@ static void release_blocks_on_commit(journal_t *journal, transaction_t *txn)
 			trace_ext4_discard_blocks(sb,
 					(unsigned long long)discard_block,
 					entry->count);
-			ret = sb_issue_discard(sb, discard_block, entry->count);
-			if (ret == EOPNOTSUPP) {
+			/*
+			 * Queue the range for batched background issue
+			 * instead of trimming it synchronously from the
+			 * commit path; the queue is drained on unmount.
+			 */
+			ret = blkdev_queue_discard(sb->s_bdev,
+				discard_block <<
+					(sb->s_blocksize_bits - 9),
+				(sector_t)entry->count <<
+					(sb->s_blocksize_bits - 9),
+				GFP_NOFS);
+			if (ret == -EOPNOTSUPP) {
 				ext4_warning(sb,
 					"discard not supported, disabling");
 				clear_opt(EXT4_SB(sb)->s_mount_opt, DISCARD);
@@ -651,6 +651,9 @@ static void ext4_put_super(struct super_block *sb)
 	flush_workqueue(sbi->dio_unwritten_wq);
 	destroy_workqueue(sbi->dio_unwritten_wq);
 
+	if (test_opt(sb, DISCARD))
+		blkdev_discard_flush(sb->s_bdev);
+
 	lock_super(sb);
 	lock_kernel();
 	if (sb->s_dirt)
@@ -675,6 +678,7 @@ static void ext4_put_super(struct super_block *sb)
 		ext4_commit_super(sb, 1);
 	}
 	if (sbi->s_proc) {
+		remove_proc_entry("journal_stats", sbi->s_proc);
 		remove_proc_entry(sb->s_id, ext4_proc_root);
 	}
 	kobject_del(&sbi->s_kobj);
@@ -934,6 +938,8 @@ static int ext4_show_options(struct seq_file *seq, struct vfsmount *vfs)
 		seq_printf(seq, ",max_batch_time=%u",
 			   (unsigned) sbi->s_min_batch_time);
 	}
+	if (test_opt(sb, FSYNC_BATCH))
+		seq_puts(seq, ",fsync_batch");
 
 	/*
 	 * We're changing the default of barrier mount option, so
@@ -1148,6 +1154,7 @@ enum {
 	Opt_user_xattr, Opt_nouser_xattr, Opt_acl, Opt_noacl,
 	Opt_auto_da_alloc, Opt_noauto_da_alloc, Opt_noload, Opt_nobh, Opt_bh,
 	Opt_commit, Opt_min_batch_time, Opt_max_batch_time,
+	Opt_fsync_batch, Opt_nofsync_batch,
 	Opt_journal_update, Opt_journal_dev,
 	Opt_journal_checksum, Opt_journal_async_commit,
 	Opt_abort, Opt_data_journal, Opt_data_ordered, Opt_data_writeback,
@@ -1191,6 +1198,8 @@ static const match_table_t tokens = {
 	{Opt_commit, "commit=%u"},
 	{Opt_min_batch_time, "min_batch_time=%u"},
 	{Opt_max_batch_time, "max_batch_time=%u"},
+	{Opt_fsync_batch, "fsync_batch"},
+	{Opt_nofsync_batch, "nofsync_batch"},
 	{Opt_journal_update, "journal=update"},
 	{Opt_journal_dev, "journal_dev=%u"},
 	{Opt_journal_checksum, "journal_checksum"},
@@ -1492,6 +1501,12 @@ static int parse_options(char *options, struct super_block *sb,
 				return 0;
 			sbi->s_min_batch_time = option;
 			break;
+		case Opt_fsync_batch:
+			set_opt(sbi->s_mount_opt, FSYNC_BATCH);
+			break;
+		case Opt_nofsync_batch:
+			clear_opt(sbi->s_mount_opt, FSYNC_BATCH);
+			break;
 		case Opt_data_journal:
 			data_opt = EXT4_MOUNT_JOURNAL_DATA;
 			goto datacheck;
@@ -2431,6 +2446,75 @@ static int ext4_feature_set_ok(struct super_block *sb, int readonly)
 	return 1;
 }
 
+#ifdef CONFIG_PROC_FS
+/*
+ * Per-commit journal statistics: how many commits have run, how much
+ * they carry and how long they take.  Useful for judging fsync commit
+ * batching effectiveness on slow media.
+ */
+static int ext4_journal_stats_show(struct seq_file *seq, void *offset)
+{
+	struct super_block *sb = seq->private;
+	journal_t *journal = EXT4_SB(sb)->s_journal;
+	struct transaction_stats_s stats;
+	u64 avg_commit_us;
+
+	if (!journal) {
+		seq_puts(seq, "no journal\n");
+		return 0;
+	}
+
+	spin_lock(&journal->j_history_lock);
+	memcpy(&stats, &journal->j_stats, sizeof(stats));
+	spin_unlock(&journal->j_history_lock);
+
+	spin_lock(&journal->j_state_lock);
+	avg_commit_us = journal->j_average_commit_time;
+	spin_unlock(&journal->j_state_lock);
+	do_div(avg_commit_us, 1000);
+
+	seq_printf(seq, "commits %lu\n", stats.ts_tid);
+	seq_printf(seq, "average_commit_time_us %llu\n",
+		   (unsigned long long)avg_commit_us);
+	seq_printf(seq, "blocks %u\n", stats.run.rs_blocks);
+	seq_printf(seq, "blocks_logged %u\n", stats.run.rs_blocks_logged);
+	seq_printf(seq, "handles %u\n", stats.run.rs_handle_count);
+	if (stats.ts_tid) {
+		seq_printf(seq, "average_blocks_per_commit %lu\n",
+			   (unsigned long)stats.run.rs_blocks_logged /
+			   stats.ts_tid);
+		seq_printf(seq, "average_handles_per_commit %lu\n",
+			   (unsigned long)stats.run.rs_handle_count /
+			   stats.ts_tid);
+	}
+	seq_printf(seq, "total_wait_time_ms %u\n",
+		   jiffies_to_msecs(stats.run.rs_wait));
+	seq_printf(seq, "total_running_time_ms %u\n",
+		   jiffies_to_msecs(stats.run.rs_running));
+	seq_printf(seq, "total_locked_time_ms %u\n",
+		   jiffies_to_msecs(stats.run.rs_locked));
+	seq_printf(seq, "total_flushing_time_ms %u\n",
+		   jiffies_to_msecs(stats.run.rs_flushing));
+	seq_printf(seq, "total_logging_time_ms %u\n",
+		   jiffies_to_msecs(stats.run.rs_logging));
+
+	return 0;
+}
+
+static int ext4_journal_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, ext4_journal_stats_show, PDE(inode)->data);
+}
+
+static const struct file_operations ext4_journal_stats_fops = {
+	.owner		= THIS_MODULE,
+	.open		= ext4_journal_stats_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+#endif
+
 static int ext4_fill_super(struct super_block *sb, void *data, int silent)
 				__releases(kernel_lock)
 				__acquires(kernel_lock)
@@ -2769,6 +2853,9 @@ static int ext4_fill_super(struct super_block *sb, void *data, int silent)
 #ifdef CONFIG_PROC_FS
 	if (ext4_proc_root)
 		sbi->s_proc = proc_mkdir(sb->s_id, ext4_proc_root);
+	if (sbi->s_proc)
+		proc_create_data("journal_stats", S_IRUGO, sbi->s_proc,
+				 &ext4_journal_stats_fops, sb);
 #endif
 
 	bgl_lock_init(sbi->s_blockgroup_lock);
@@ -3080,6 +3167,7 @@ failed_mount2:
 	kfree(sbi->s_group_desc);
 failed_mount:
 	if (sbi->s_proc) {
+		remove_proc_entry("journal_stats", sbi->s_proc);
 		remove_proc_entry(sb->s_id, ext4_proc_root);
 	}
 #ifdef CONFIG_QUOTA
@@ -3119,6 +3207,10 @@ static void ext4_init_journal_params(struct super_block *sb, journal_t *journal)
 		journal->j_flags |= JBD2_ABORT_ON_SYNCDATA_ERR;
 	else
 		journal->j_flags &= ~JBD2_ABORT_ON_SYNCDATA_ERR;
+	if (test_opt(sb, FSYNC_BATCH))
+		journal->j_flags |= JBD2_FSYNC_BATCH;
+	else
+		journal->j_flags &= ~JBD2_FSYNC_BATCH;
 	spin_unlock(&journal->j_state_lock);
 }
 
@@ -24,7 +24,7 @@
 #include <linux/workqueue.h>
 
 /** Max number of pages that can be used in a single read request */
-#define FUSE_MAX_PAGES_PER_REQ 32
+#define FUSE_MAX_PAGES_PER_REQ 64
 
 /** Bias for fi->writectr, meaning new writepages must not be sent */
 #define FUSE_NOWRITE INT_MIN
@@ -457,6 +457,10 @@ struct fuse_conn {
 	/** Do multi-page cached writes */
 	unsigned big_writes:1;
 
+	/** Write dirty pages back from the page cache instead of
+	    writing through to userspace */
+	unsigned writeback_cache:1;
+
 	/** Don't apply umask to creation modes */
 	unsigned dont_mask:1;
 
@@ -96,3 +96,14 @@ extern void put_super(struct super_block *sb);
 struct nameidata;
 extern struct file *nameidata_to_filp(struct nameidata *);
 extern void release_open_intent(struct nameidata *);
+
+/*
+ * namei.c
+ */
+#ifdef CONFIG_FS_PERM_CACHE
+extern void inode_perm_cache_prune(struct inode *);
+#else
+static inline void inode_perm_cache_prune(struct inode *inode)
+{
+}
+#endif
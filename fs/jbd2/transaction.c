@@ -1286,28 +1286,47 @@ int jbd2_journal_stop(handle_t *handle)
 	 * writes.  No point in waiting for joiners in that case.
 	 */
 	pid = current->pid;
-	if (handle->h_sync && journal->j_last_sync_writer != pid) {
+	if (handle->h_sync) {
 		u64 commit_time, trans_time;
-
-		journal->j_last_sync_writer = pid;
+		int batch;
 
 		spin_lock(&journal->j_state_lock);
 		commit_time = journal->j_average_commit_time;
 		spin_unlock(&journal->j_state_lock);
 
-		trans_time = ktime_to_ns(ktime_sub(ktime_get(),
-						   transaction->t_start_time));
+		batch = (journal->j_last_sync_writer != pid);
 
-		commit_time = max_t(u64, commit_time,
-				    1000*journal->j_min_batch_time);
-		commit_time = min_t(u64, commit_time,
-				    1000*journal->j_max_batch_time);
+		/*
+		 * With JBD2_FSYNC_BATCH set, back-to-back commits from a
+		 * single writer (the SQLite fsync storm pattern) are held
+		 * off as well: another fsync arriving within an average
+		 * commit time of the last one is likely to have company.
+		 */
+		if (!batch && (journal->j_flags & JBD2_FSYNC_BATCH) &&
+		    ktime_to_ns(ktime_sub(ktime_get(),
+					  journal->j_last_sync_time)) <
+		    commit_time)
+			batch = 1;
 
-		if (trans_time < commit_time) {
-			ktime_t expires = ktime_add_ns(ktime_get(),
-						       commit_time);
-			set_current_state(TASK_UNINTERRUPTIBLE);
-			schedule_hrtimeout(&expires, HRTIMER_MODE_ABS);
+		journal->j_last_sync_writer = pid;
+		journal->j_last_sync_time = ktime_get();
+
+		if (batch) {
+			trans_time = ktime_to_ns(ktime_sub(ktime_get(),
+						transaction->t_start_time));
+
+			commit_time = max_t(u64, commit_time,
+					    1000*journal->j_min_batch_time);
+			commit_time = min_t(u64, commit_time,
+					    1000*journal->j_max_batch_time);
+
+			if (trans_time < commit_time) {
+				ktime_t expires = ktime_add_ns(ktime_get(),
+							       commit_time);
+				set_current_state(TASK_UNINTERRUPTIBLE);
+				schedule_hrtimeout(&expires,
+						   HRTIMER_MODE_ABS);
+			}
 		}
 	}
 
@@ -31,7 +31,9 @@
 #include <linux/file.h>
 #include <linux/fcntl.h>
 #include <linux/device_cgroup.h>
+#include <linux/hash.h>
 #include <linux/fs_struct.h>
+#include <linux/vfs_latency.h>
 #include <asm/uaccess.h>
 
 #include "internal.h"
@@ -239,6 +241,121 @@ int generic_permission(struct inode *inode, int mask,
 	return -EACCES;
 }
 
+#ifdef CONFIG_FS_PERM_CACHE
+/*
+ * Small direct-mapped cache of DAC permission check results, keyed by
+ * (cred, inode, mask).  Path walks over the static system partitions
+ * recheck the same directory inodes with the same credentials over and
+ * over; a hit skips generic_permission() and the security hooks.
+ *
+ * Only results that cannot go stale behind our back are cached: no
+ * MAY_WRITE (remount r/o, immutable flags), no device nodes (device
+ * cgroup policy) and no filesystems with their own ->permission.
+ * Everything else is invalidated explicitly via
+ * inode_perm_cache_prune() on attr/xattr changes and inode
+ * destruction.
+ *
+ * The cred is matched by pointer (creds are immutable once
+ * committed); fsuid/fsgid, the capability set and the group_info
+ * pointer are matched as well so that a recycled cred allocation
+ * cannot produce a false hit.
+ */
+#define PERM_CACHE_SHIFT	9
+#define PERM_CACHE_SIZE		(1 << PERM_CACHE_SHIFT)
+
+struct perm_cache_entry {
+	struct inode *inode;
+	const struct cred *cred;
+	struct group_info *group_info;
+	kernel_cap_t cap_effective;
+	uid_t fsuid;
+	gid_t fsgid;
+	int mask;
+	int result;
+};
+
+static struct perm_cache_entry perm_cache[PERM_CACHE_SIZE];
+static DEFINE_SPINLOCK(perm_cache_lock);
+/* Bumped by every prune; a verdict computed under an older generation
+ * must not be inserted, or it would outlive the change that pruned. */
+static unsigned int perm_cache_gen;
+
+static unsigned int perm_cache_hash(struct inode *inode, int mask)
+{
+	return hash_long((unsigned long)inode ^ (mask << 4),
+			 PERM_CACHE_SHIFT);
+}
+
+static int perm_cache_may_cache(struct inode *inode, int mask)
+{
+	return !(mask & MAY_WRITE) && !inode->i_op->permission &&
+		!S_ISCHR(inode->i_mode) && !S_ISBLK(inode->i_mode);
+}
+
+static int perm_cache_lookup(struct inode *inode, int mask, int *result)
+{
+	const struct cred *cred = current_cred();
+	struct perm_cache_entry *pe;
+	int hit = 0;
+
+	spin_lock(&perm_cache_lock);
+	pe = &perm_cache[perm_cache_hash(inode, mask)];
+	if (pe->inode == inode && pe->mask == mask && pe->cred == cred &&
+	    pe->fsuid == cred->fsuid && pe->fsgid == cred->fsgid &&
+	    pe->group_info == cred->group_info &&
+	    !memcmp(&pe->cap_effective, &cred->cap_effective,
+		    sizeof(kernel_cap_t))) {
+		*result = pe->result;
+		hit = 1;
+	}
+	spin_unlock(&perm_cache_lock);
+	return hit;
+}
+
+static void perm_cache_insert(struct inode *inode, int mask, int result,
+			      unsigned int gen)
+{
+	const struct cred *cred = current_cred();
+	struct perm_cache_entry *pe;
+
+	spin_lock(&perm_cache_lock);
+	/*
+	 * A prune may have run between the permission computation and
+	 * this insert (e.g. a concurrent chmod); the verdict is stale
+	 * then and must be discarded.
+	 */
+	if (gen == perm_cache_gen) {
+		pe = &perm_cache[perm_cache_hash(inode, mask)];
+		pe->inode = inode;
+		pe->cred = cred;
+		pe->group_info = cred->group_info;
+		pe->cap_effective = cred->cap_effective;
+		pe->fsuid = cred->fsuid;
+		pe->fsgid = cred->fsgid;
+		pe->mask = mask;
+		pe->result = result;
+	}
+	spin_unlock(&perm_cache_lock);
+}
+
+/*
+ * Drop all cached results for an inode.  Called when its attributes
+ * or xattrs change and when the inode is destroyed (the allocation
+ * may be reused for an unrelated inode).
+ */
+void inode_perm_cache_prune(struct inode *inode)
+{
+	int i;
+
+	spin_lock(&perm_cache_lock);
+	perm_cache_gen++;
+	for (i = 0; i < PERM_CACHE_SIZE; i++)
+		if (perm_cache[i].inode == inode)
+			perm_cache[i].inode = NULL;
+	spin_unlock(&perm_cache_lock);
+}
+#endif /* CONFIG_FS_PERM_CACHE */
+
 /**
  * inode_permission  -  check for access rights to a given inode
  * @inode:	inode to check permission on
@@ -252,6 +369,14 @@ int generic_permission(struct inode *inode, int mask,
 int inode_permission(struct inode *inode, int mask)
 {
 	int retval;
+#ifdef CONFIG_FS_PERM_CACHE
+	int cacheable = perm_cache_may_cache(inode, mask);
+	/* sampled before the checks below read the inode state */
+	unsigned int gen = ACCESS_ONCE(perm_cache_gen);
+
+	if (cacheable && perm_cache_lookup(inode, mask, &retval))
+		return retval;
+#endif
 
 	if (mask & MAY_WRITE) {
 		umode_t mode = inode->i_mode;
@@ -275,15 +400,18 @@ int inode_permission(struct inode *inode, int mask)
 	else
 		retval = generic_permission(inode, mask, inode->i_op->check_acl);
 
-	if (retval)
-		return retval;
-
-	retval = devcgroup_inode_permission(inode, mask);
-	if (retval)
-		return retval;
+	if (!retval)
+		retval = devcgroup_inode_permission(inode, mask);
 
-	return security_inode_permission(inode,
+	if (!retval)
+		retval = security_inode_permission(inode,
 			mask & (MAY_READ|MAY_WRITE|MAY_EXEC|MAY_APPEND));
+
+#ifdef CONFIG_FS_PERM_CACHE
+	if (cacheable)
+		perm_cache_insert(inode, mask, retval, gen);
+#endif
+	return retval;
 }
 
 /**
@@ -1056,6 +1184,7 @@ out_fail:
 static int do_path_lookup(int dfd, const char *name,
 				unsigned int flags, struct nameidata *nd)
 {
+	ktime_t lat_start = vfs_latency_start();
 	int retval = path_init(dfd, name, flags, nd);
 	if (!retval)
 		retval = path_walk(name, nd);
@@ -1066,6 +1195,9 @@ static int do_path_lookup(int dfd, const char *name,
 		path_put(&nd->root);
 		nd->root.mnt = NULL;
 	}
+	if (!retval)
+		vfs_latency_end(nd->path.dentry->d_sb, VFS_LAT_LOOKUP,
+				lat_start);
 	return retval;
 }
 
@@ -82,6 +82,7 @@
 #include <linux/pid_namespace.h>
 #include <linux/fs_struct.h>
 #include <linux/slab.h>
+#include <linux/iocontext.h>
 #include "internal.h"
 
 /* NOTE:
@@ -1049,6 +1050,13 @@ static ssize_t oom_adjust_write(struct file *file, const char __user *buf,
 	task->signal->oom_adj = oom_adjust;
 
 	unlock_task_sighand(task, &flags);
+
+	/* The scheduler may group tasks by their foreground/background state */
+	sched_oomgroup_reclassify(task);
+
+	/* keep the preloaded OOM victim candidate current */
+	oom_preload_update(task);
+
 	put_task_struct(task);
 
 	return count;
@@ -1293,6 +1301,67 @@ static const struct file_operations proc_pid_sched_operations = {
 
 #endif
 
+#ifdef CONFIG_SCHED_WAKEUP_HIST
+/*
+ * Print out the per-task wakeup latency histogram, one "<bucket_us>
+ * <count>" line per log2 bucket.  Any write resets the counters.
+ */
+static int sched_hist_show(struct seq_file *m, void *v)
+{
+	struct inode *inode = m->private;
+	struct task_struct *p;
+	int i;
+
+	p = get_proc_task(inode);
+	if (!p)
+		return -ESRCH;
+	for (i = 0; i < SCHED_WAKEUP_HIST_BUCKETS; i++)
+		seq_printf(m, "%u %u\n", 1U << i,
+			   p->sched_info.wait_hist[i]);
+	put_task_struct(p);
+
+	return 0;
+}
+
+static ssize_t
+sched_hist_write(struct file *file, const char __user *buf,
+		 size_t count, loff_t *offset)
+{
+	struct inode *inode = file->f_path.dentry->d_inode;
+	struct task_struct *p;
+
+	p = get_proc_task(inode);
+	if (!p)
+		return -ESRCH;
+	memset(p->sched_info.wait_hist, 0, sizeof(p->sched_info.wait_hist));
+	put_task_struct(p);
+
+	return count;
+}
+
+static int sched_hist_open(struct inode *inode, struct file *filp)
+{
+	int ret;
+
+	ret = single_open(filp, sched_hist_show, NULL);
+	if (!ret) {
+		struct seq_file *m = filp->private_data;
+
+		m->private = inode;
+	}
+	return ret;
+}
+
+static const struct file_operations proc_pid_sched_hist_operations = {
+	.open		= sched_hist_open,
+	.read		= seq_read,
+	.write		= sched_hist_write,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+#endif
+
 #ifdef CONFIG_SCHED_AUTOGROUP
 /*
  * Print out autogroup related information:
@@ -2661,6 +2730,34 @@ static int proc_tgid_io_accounting(struct task_struct *task, char *buffer)
 }
 #endif /* CONFIG_TASK_IO_ACCOUNTING */
 
+#ifdef CONFIG_BLK_IO_LATENCY
+static int proc_pid_io_latency(struct seq_file *m, struct pid_namespace *ns,
+				struct pid *pid, struct task_struct *task)
+{
+	struct io_context *ioc;
+	int rw, i;
+
+	task_lock(task);
+	ioc = task->io_context;
+	if (ioc && !atomic_long_inc_not_zero(&ioc->refcount))
+		ioc = NULL;
+	task_unlock(task);
+
+	if (!ioc)
+		return 0;
+
+	for (rw = 0; rw < 2; rw++) {
+		seq_printf(m, "%s:", rw == READ ? "read" : "write");
+		for (i = 0; i < BLK_IO_LAT_BUCKETS; i++)
+			seq_printf(m, " %lu", ioc->lat_hist[rw][i]);
+		seq_putc(m, '\n');
+	}
+
+	put_io_context(ioc);
+	return 0;
+}
+#endif /* CONFIG_BLK_IO_LATENCY */
+
 static int proc_pid_personality(struct seq_file *m, struct pid_namespace *ns,
 				struct pid *pid, struct task_struct *task)
 {
@@ -2712,6 +2809,7 @@ static const struct pid_entry tgid_base_stuff[] = {
 	REG("mountstats", S_IRUSR, proc_mountstats_operations),
 #ifdef CONFIG_PROC_PAGE_MONITOR
 	REG("clear_refs", S_IWUSR, proc_clear_refs_operations),
+	REG("reclaim",    S_IWUSR, proc_reclaim_operations),
 	REG("smaps",      S_IRUGO, proc_smaps_operations),
 	REG("pagemap",    S_IRUSR, proc_pagemap_operations),
 #endif
@@ -2727,6 +2825,9 @@ static const struct pid_entry tgid_base_stuff[] = {
 #ifdef CONFIG_SCHEDSTATS
 	INF("schedstat",  S_IRUGO, proc_pid_schedstat),
 #endif
+#ifdef CONFIG_SCHED_WAKEUP_HIST
+	REG("sched_hist", S_IRUGO|S_IWUSR, proc_pid_sched_hist_operations),
+#endif
 #ifdef CONFIG_LATENCYTOP
 	REG("latency",  S_IRUGO, proc_lstats_operations),
 #endif
@@ -2751,6 +2852,9 @@ static const struct pid_entry tgid_base_stuff[] = {
 #ifdef CONFIG_TASK_IO_ACCOUNTING
 	INF("io",	S_IRUGO, proc_tgid_io_accounting),
 #endif
+#ifdef CONFIG_BLK_IO_LATENCY
+	ONE("io_latency", S_IRUGO, proc_pid_io_latency),
+#endif
 };
 
 static int proc_tgid_base_readdir(struct file * filp,
@@ -3051,6 +3155,7 @@ static const struct pid_entry tid_base_stuff[] = {
 	REG("mountinfo",  S_IRUGO, proc_mountinfo_operations),
 #ifdef CONFIG_PROC_PAGE_MONITOR
 	REG("clear_refs", S_IWUSR, proc_clear_refs_operations),
+	REG("reclaim",   S_IWUSR, proc_reclaim_operations),
 	REG("smaps",     S_IRUGO, proc_smaps_operations),
 	REG("pagemap",    S_IRUSR, proc_pagemap_operations),
 #endif
@@ -3066,6 +3171,9 @@ static const struct pid_entry tid_base_stuff[] = {
 #ifdef CONFIG_SCHEDSTATS
 	INF("schedstat", S_IRUGO, proc_pid_schedstat),
 #endif
+#ifdef CONFIG_SCHED_WAKEUP_HIST
+	REG("sched_hist", S_IRUGO|S_IWUSR, proc_pid_sched_hist_operations),
+#endif
 #ifdef CONFIG_LATENCYTOP
 	REG("latency",  S_IRUGO, proc_lstats_operations),
 #endif
@@ -3087,6 +3195,9 @@ static const struct pid_entry tid_base_stuff[] = {
 #ifdef CONFIG_TASK_IO_ACCOUNTING
 	INF("io",	S_IRUGO, proc_tid_io_accounting),
 #endif
+#ifdef CONFIG_BLK_IO_LATENCY
+	ONE("io_latency", S_IRUGO, proc_pid_io_latency),
+#endif
 };
 
 static int proc_tid_base_readdir(struct file * filp,
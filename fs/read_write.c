@@ -16,6 +16,7 @@
 #include <linux/syscalls.h>
 #include <linux/pagemap.h>
 #include <linux/splice.h>
+#include <linux/vfs_latency.h>
 #include "read_write.h"
 
 #include <asm/uaccess.h>
@@ -295,6 +296,7 @@ EXPORT_SYMBOL(do_sync_read);
 ssize_t vfs_read(struct file *file, char __user *buf, size_t count, loff_t *pos)
 {
 	ssize_t ret;
+	ktime_t start;
 
 	if (!(file->f_mode & FMODE_READ))
 		return -EBADF;
@@ -303,6 +305,7 @@ ssize_t vfs_read(struct file *file, char __user *buf, size_t count, loff_t *pos)
 	if (unlikely(!access_ok(VERIFY_WRITE, buf, count)))
 		return -EFAULT;
 
+	start = vfs_latency_start();
 	ret = rw_verify_area(READ, file, pos, count);
 	if (ret >= 0) {
 		count = ret;
@@ -316,6 +319,7 @@ ssize_t vfs_read(struct file *file, char __user *buf, size_t count, loff_t *pos)
 		}
 		inc_syscr(current);
 	}
+	vfs_latency_end(file->f_path.dentry->d_sb, VFS_LAT_READ, start);
 
 	return ret;
 }
@@ -351,6 +355,7 @@ EXPORT_SYMBOL(do_sync_write);
 ssize_t vfs_write(struct file *file, const char __user *buf, size_t count, loff_t *pos)
 {
 	ssize_t ret;
+	ktime_t start;
 
 	if (!(file->f_mode & FMODE_WRITE))
 		return -EBADF;
@@ -359,6 +364,7 @@ ssize_t vfs_write(struct file *file, const char __user *buf, size_t count, loff_
 	if (unlikely(!access_ok(VERIFY_READ, buf, count)))
 		return -EFAULT;
 
+	start = vfs_latency_start();
 	ret = rw_verify_area(WRITE, file, pos, count);
 	if (ret >= 0) {
 		count = ret;
@@ -372,6 +378,7 @@ ssize_t vfs_write(struct file *file, const char __user *buf, size_t count, loff_
 		}
 		inc_syscw(current);
 	}
+	vfs_latency_end(file->f_path.dentry->d_sb, VFS_LAT_WRITE, start);
 
 	return ret;
 }
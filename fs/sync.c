@@ -15,6 +15,7 @@
 #include <linux/quotaops.h>
 #include <linux/buffer_head.h>
 #include <linux/backing-dev.h>
+#include <linux/vfs_latency.h>
 #include "internal.h"
 
 #define VALID_FLAGS (SYNC_FILE_RANGE_WAIT_BEFORE|SYNC_FILE_RANGE_WRITE| \
@@ -174,6 +175,7 @@ EXPORT_SYMBOL(file_fsync);
 int vfs_fsync_range(struct file *file, loff_t start, loff_t end, int datasync)
 {
 	struct address_space *mapping = file->f_mapping;
+	ktime_t lat_start;
 	int err, ret;
 
 	if (!file->f_op || !file->f_op->fsync) {
@@ -181,6 +183,7 @@ int vfs_fsync_range(struct file *file, loff_t start, loff_t end, int datasync)
 		goto out;
 	}
 
+	lat_start = vfs_latency_start();
 	ret = filemap_write_and_wait_range(mapping, start, end);
 
 	/*
@@ -192,6 +195,7 @@ int vfs_fsync_range(struct file *file, loff_t start, loff_t end, int datasync)
 	if (!ret)
 		ret = err;
 	mutex_unlock(&mapping->host->i_mutex);
+	vfs_latency_end(file->f_path.dentry->d_sb, VFS_LAT_FSYNC, lat_start);
 
 out:
 	return ret;
@@ -0,0 +1,174 @@
+/*
+ * Per-mount VFS operation latency accounting.
+ *
+ * When enabled through debugfs, vfs_read(), vfs_write(), vfs_fsync_range()
+ * and path lookups are timed.  Each sample fires the vfs_op_latency
+ * tracepoint and is added to an in-kernel log2 histogram keyed by
+ * superblock, so a stall can be attributed to a mount on a production
+ * device without streaming trace data:
+ *
+ *	/sys/kernel/debug/vfs_latency/enable	collection on/off
+ *	/sys/kernel/debug/vfs_latency/stats	per-mount histograms
+ *	/sys/kernel/debug/vfs_latency/reset	write to clear the stats
+ *
+ * Bucket n of a histogram counts samples in [2^(n-1), 2^n) microseconds,
+ * bucket 0 counts sub-microsecond samples and the last bucket is open
+ * ended.
+ */
+
+#include <linux/fs.h>
+#include <linux/kdev_t.h>
+#include <linux/ktime.h>
+#include <linux/log2.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/spinlock.h>
+#include <linux/string.h>
+#include <linux/init.h>
+#include <linux/vfs_latency.h>
+
+#define CREATE_TRACE_POINTS
+#include <trace/events/vfs.h>
+
+unsigned int vfs_latency_enabled __read_mostly;
+
+#define VFS_LAT_SLOTS	16
+#define VFS_LAT_BUCKETS	16
+
+static const char *const vfs_lat_op_names[VFS_LAT_OPS] = {
+	"read", "write", "fsync", "lookup",
+};
+
+struct vfs_lat_slot {
+	dev_t dev;
+	char id[32];
+	unsigned long hist[VFS_LAT_OPS][VFS_LAT_BUCKETS];
+};
+
+static struct vfs_lat_slot vfs_lat_slots[VFS_LAT_SLOTS];
+static DEFINE_SPINLOCK(vfs_lat_lock);
+
+/*
+ * Find the histogram slot for a superblock, claiming a free one on
+ * first use.  Slots are never released; a device that sees more than
+ * VFS_LAT_SLOTS distinct mounts simply stops gaining new entries until
+ * the stats are reset.
+ */
+static struct vfs_lat_slot *vfs_lat_find_slot(struct super_block *sb)
+{
+	struct vfs_lat_slot *slot;
+	unsigned long flags;
+	int i;
+
+	for (i = 0; i < VFS_LAT_SLOTS; i++) {
+		slot = &vfs_lat_slots[i];
+		if (slot->dev == sb->s_dev)
+			return slot;
+		if (!slot->dev) {
+			spin_lock_irqsave(&vfs_lat_lock, flags);
+			if (!slot->dev) {
+				strlcpy(slot->id, sb->s_id, sizeof(slot->id));
+				slot->dev = sb->s_dev;
+			}
+			spin_unlock_irqrestore(&vfs_lat_lock, flags);
+			if (slot->dev == sb->s_dev)
+				return slot;
+		}
+	}
+	return NULL;
+}
+
+void vfs_latency_record(struct super_block *sb, int op, ktime_t start)
+{
+	struct vfs_lat_slot *slot;
+	s64 us;
+	int bucket;
+
+	if (!sb)
+		return;
+
+	us = ktime_to_us(ktime_sub(ktime_get(), start));
+	if (us < 0)
+		us = 0;
+
+	trace_vfs_op_latency(sb->s_dev, op, us);
+
+	slot = vfs_lat_find_slot(sb);
+	if (slot) {
+		bucket = min(fls64(us), VFS_LAT_BUCKETS - 1);
+		/* racy increment; these are only ever rough counts */
+		slot->hist[op][bucket]++;
+	}
+}
+
+static int vfs_lat_stats_show(struct seq_file *m, void *v)
+{
+	int i, op, b;
+
+	for (i = 0; i < VFS_LAT_SLOTS; i++) {
+		struct vfs_lat_slot *slot = &vfs_lat_slots[i];
+
+		if (!slot->dev)
+			continue;
+		for (op = 0; op < VFS_LAT_OPS; op++) {
+			unsigned long total = 0;
+
+			for (b = 0; b < VFS_LAT_BUCKETS; b++)
+				total += slot->hist[op][b];
+			if (!total)
+				continue;
+			seq_printf(m, "%-16s %2u:%-2u %-6s:", slot->id,
+				   MAJOR(slot->dev), MINOR(slot->dev),
+				   vfs_lat_op_names[op]);
+			for (b = 0; b < VFS_LAT_BUCKETS; b++)
+				seq_printf(m, " %lu", slot->hist[op][b]);
+			seq_putc(m, '\n');
+		}
+	}
+	return 0;
+}
+
+static int vfs_lat_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, vfs_lat_stats_show, NULL);
+}
+
+static const struct file_operations vfs_lat_stats_fops = {
+	.open		= vfs_lat_stats_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+static ssize_t vfs_lat_reset_write(struct file *file, const char __user *buf,
+				   size_t count, loff_t *ppos)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&vfs_lat_lock, flags);
+	memset(vfs_lat_slots, 0, sizeof(vfs_lat_slots));
+	spin_unlock_irqrestore(&vfs_lat_lock, flags);
+	return count;
+}
+
+static const struct file_operations vfs_lat_reset_fops = {
+	.write		= vfs_lat_reset_write,
+};
+
+static int __init vfs_latency_init(void)
+{
+	struct dentry *dir;
+
+	dir = debugfs_create_dir("vfs_latency", NULL);
+	if (!dir || IS_ERR(dir))
+		return 0;
+
+	debugfs_create_u32("enable", S_IRUGO | S_IWUSR, dir,
+			   &vfs_latency_enabled);
+	debugfs_create_file("stats", S_IRUGO, dir, NULL,
+			    &vfs_lat_stats_fops);
+	debugfs_create_file("reset", S_IWUSR, dir, NULL,
+			    &vfs_lat_reset_fops);
+	return 0;
+}
+fs_initcall(vfs_latency_init);
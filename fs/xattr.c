@@ -19,6 +19,7 @@
 #include <linux/fsnotify.h>
 #include <linux/audit.h>
 #include <asm/uaccess.h>
+#include "internal.h"
 
 
 /*
@@ -125,6 +126,8 @@ vfs_setxattr(struct dentry *dentry, const char *name, const void *value,
 		goto out;
 
 	error = __vfs_setxattr_noperm(dentry, name, value, size, flags);
+	if (!error)
+		inode_perm_cache_prune(inode);
 
 out:
 	mutex_unlock(&inode->i_mutex);
@@ -236,8 +239,10 @@ vfs_removexattr(struct dentry *dentry, const char *name)
 	error = inode->i_op->removexattr(dentry, name);
 	mutex_unlock(&inode->i_mutex);
 
-	if (!error)
+	if (!error) {
 		fsnotify_xattr(dentry);
+		inode_perm_cache_prune(inode);
+	}
 	return error;
 }
 EXPORT_SYMBOL_GPL(vfs_removexattr);
@@ -51,6 +51,9 @@ extern const char *yaffs_guts_c_version;
 #include <linux/interrupt.h>
 #include <linux/string.h>
 #include <linux/ctype.h>
+#include <linux/kthread.h>
+#include <linux/freezer.h>
+#include <linux/idle_maint.h>
 
 #include "asm/div64.h"
 
@@ -387,6 +390,100 @@ static void yaffs_GrossUnlock(yaffs_Device *dev)
 }
 
 
+/*-----------------------------------------------------------------*/
+/* Background garbage collection.
+ *
+ * Each writable mount gets a thread that does routine garbage collection
+ * when the device has been idle (no page writes) for a polling interval,
+ * so that the write path only has to collect inline when erased blocks
+ * actually run short.
+ */
+
+#define YAFFS_BG_GC_URGENT_MS	50	/* short of erased blocks */
+#define YAFFS_BG_GC_IDLE_MS	250	/* idle and work to do */
+#define YAFFS_BG_GC_QUIET_MS	2000	/* nothing to do */
+
+#define YAFFS_BG_GC_COST_US	20000	/* rough cost of one GC tick */
+
+/* Idle-maintenance callback: just get the background thread back on
+ * CPU inside the idle window; the GC tick itself runs below under the
+ * gross lock as usual.
+ */
+static int yaffs_BackgroundMaintRun(struct idle_maint_work *work)
+{
+	wake_up_process((struct task_struct *)work->data);
+	return 0;
+}
+
+static int yaffs_BackgroundThread(void *data)
+{
+	yaffs_Device *dev = (yaffs_Device *)data;
+	int lastWrites = 0;
+	unsigned ms = YAFFS_BG_GC_IDLE_MS;
+	int urgency;
+	int idle;
+	int more = 1;
+	struct idle_maint_work maintWork = {
+		.name = "yaffs-bg-gc",
+		.cost_us = YAFFS_BG_GC_COST_US,
+		.run = yaffs_BackgroundMaintRun,
+		.data = current,
+	};
+
+	set_freezable();
+	idle_maint_register(&maintWork);
+
+	while (!kthread_should_stop()) {
+		schedule_timeout_interruptible(msecs_to_jiffies(ms));
+		try_to_freeze();
+		if (kthread_should_stop())
+			break;
+
+		yaffs_GrossLock(dev);
+
+		idle = (dev->nPageWrites == lastWrites);
+		lastWrites = dev->nPageWrites;
+
+		if (!idle) {
+			/* New writes mean new GC debt */
+			more = 1;
+		}
+
+		urgency = yaffs_GetGCUrgency(dev);
+
+		/* Write-back deferral: push dirty short-op cache chunks
+		 * out once the device has gone idle, so sub-chunk writes
+		 * coalesce in RAM rather than programming NAND each time.
+		 */
+		if (idle) {
+			yaffs_FlushEntireDeviceCache(dev);
+			lastWrites = dev->nPageWrites;
+		}
+
+		if (urgency || (idle && more))
+			more = yaffs_BackgroundGarbageCollect(dev, urgency);
+
+		yaffs_GrossUnlock(dev);
+
+		if (urgency)
+			ms = YAFFS_BG_GC_URGENT_MS;
+		else if (more) {
+			/* Non-urgent debt: ask to be woken in the next
+			 * long idle window and stretch the polling
+			 * fallback, rather than waking the CPU on our
+			 * own timer every quarter second.
+			 */
+			idle_maint_request(&maintWork);
+			ms = YAFFS_BG_GC_QUIET_MS;
+		} else
+			ms = YAFFS_BG_GC_QUIET_MS;
+	}
+
+	idle_maint_unregister(&maintWork);
+	return 0;
+}
+
+
 /*-----------------------------------------------------------------*/
 /* Directory search context allows us to unlock access to yaffs during
  * filldir without causing problems with the directory being modified.
@@ -1896,6 +1993,15 @@ static void yaffs_put_super(struct super_block *sb)
 
 	T(YAFFS_TRACE_OS, ("yaffs_put_super\n"));
 
+	/* Stop the GC thread before taking the lock for the final flush;
+	 * it takes the gross lock itself.
+	 */
+	if (dev->gcThread) {
+		kthread_stop((struct task_struct *)dev->gcThread);
+		dev->gcThread = NULL;
+		dev->backgroundGC = 0;
+	}
+
 	yaffs_GrossLock(dev);
 
 	yaffs_FlushEntireDeviceCache(dev);
@@ -1946,6 +2052,7 @@ typedef struct {
 	int skip_checkpoint_read;
 	int skip_checkpoint_write;
 	int no_cache;
+	int cache_size;		/* short-op cache entries; 0 = default */
 	int empty_lost_and_found_overridden;
 	int empty_lost_and_found;
 } yaffs_options;
@@ -1978,6 +2085,20 @@ static int yaffs_parse_options(yaffs_options *options, const char *options_str)
 			options->inband_tags = 1;
 		else if (!strcmp(cur_opt, "no-cache"))
 			options->no_cache = 1;
+		else if (!strncmp(cur_opt, "cache-size=", 11)) {
+			char *end;
+			int val = simple_strtoul(cur_opt + 11, &end, 10);
+
+			if (end == cur_opt + 11 || *end) {
+				printk(KERN_INFO
+					"yaffs: Bad mount option \"%s\"\n",
+					cur_opt);
+				error = 1;
+			} else if (val == 0)
+				options->no_cache = 1;
+			else
+				options->cache_size = val;
+		}
 		else if (!strcmp(cur_opt, "no-checkpoint-read"))
 			options->skip_checkpoint_read = 1;
 		else if (!strcmp(cur_opt, "no-checkpoint-write"))
@@ -2213,7 +2334,16 @@ static struct super_block *yaffs_internal_read_super(int yaffsVersion,
 	dev->nChunksPerBlock = YAFFS_CHUNKS_PER_BLOCK;
 	dev->totalBytesPerChunk = YAFFS_BYTES_PER_CHUNK;
 	dev->nReservedBlocks = 5;
-	dev->nShortOpCaches = (options.no_cache) ? 0 : 10;
+	/* Cache size is per-mount: "no-cache" or "cache-size=0" disables
+	 * it, "cache-size=N" sets it (clamped to YAFFS_MAX_SHORT_OP_CACHES
+	 * during initialisation), and the default stays at 10 entries.
+	 */
+	if (options.no_cache)
+		dev->nShortOpCaches = 0;
+	else if (options.cache_size)
+		dev->nShortOpCaches = options.cache_size;
+	else
+		dev->nShortOpCaches = 10;
 	dev->inbandTags = options.inband_tags;
 
 	/* ... and the functions. */
@@ -2320,6 +2450,19 @@ static struct super_block *yaffs_internal_read_super(int yaffsVersion,
 	T(YAFFS_TRACE_ALWAYS,
 	  ("yaffs_read_super: isCheckpointed %d\n", dev->isCheckpointed));
 
+	/* Start background garbage collection for writable mounts */
+	if (!dev->readOnly) {
+		static int bgThreadNumber;
+		struct task_struct *task;
+
+		task = kthread_run(yaffs_BackgroundThread, dev,
+				"yaffs-bg-%d", bgThreadNumber++);
+		if (!IS_ERR(task)) {
+			dev->gcThread = task;
+			dev->backgroundGC = 1;
+		}
+	}
+
 	T(YAFFS_TRACE_OS, ("yaffs_read_super: done\n"));
 	return sb;
 }
@@ -2444,6 +2587,9 @@ static char *yaffs_dump_dev(char *buf, yaffs_Device * dev)
 	buf += sprintf(buf, "garbageCollections. %d\n", dev->garbageCollections);
 	buf += sprintf(buf, "passiveGCs......... %d\n",
 		    dev->passiveGarbageCollections);
+	buf += sprintf(buf, "backgroundGCs...... %d\n",
+		    dev->backgroundGarbageCollections);
+	buf += sprintf(buf, "gcUrgency.......... %d\n", yaffs_GetGCUrgency(dev));
 	buf += sprintf(buf, "nRetriedWrites..... %d\n", dev->nRetriedWrites);
 	buf += sprintf(buf, "nShortOpCaches..... %d\n", dev->nShortOpCaches);
 	buf += sprintf(buf, "nRetireBlocks...... %d\n", dev->nRetiredBlocks);
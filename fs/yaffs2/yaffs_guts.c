@@ -399,6 +399,289 @@ static int yaffs_CountChunkBits(yaffs_Device *dev, int blk)
 	return n;
 }
 
+/*
+ * Block summaries
+ *
+ * The packed tags of all the data chunks in a block are written into the
+ * last chunk(s) of that block as it fills up.  On a mount without a valid
+ * checkpoint the scanner can then read one summary chunk per block instead
+ * of reading the tags of every chunk, which makes the unclean-shutdown
+ * boot path a great deal faster.
+ */
+
+typedef struct {
+	unsigned version;
+	unsigned block;
+	unsigned sequenceNumber;
+	unsigned sum;
+} yaffs_SummaryHeader;
+
+#define YAFFS_SUMMARY_VERSION	1
+
+static void yaffs_SummaryClear(yaffs_Device *dev)
+{
+	if (dev->summaryTags)
+		memset(dev->summaryTags, 0xFF,
+			dev->chunksPerSummary *
+			sizeof(yaffs_PackedTags2TagsPart));
+	dev->summaryBlock = -1;
+}
+
+static void yaffs_SummaryDeinit(yaffs_Device *dev)
+{
+	if (dev->summaryTags) {
+		YFREE(dev->summaryTags);
+		dev->summaryTags = NULL;
+	}
+	dev->chunksPerSummary = 0;
+	dev->summaryBlock = -1;
+}
+
+static int yaffs_SummaryInit(yaffs_Device *dev)
+{
+	int sumBytesPerChunk;
+	int sumBytes;
+	int chunksUsed;
+
+	dev->chunksPerSummary = 0;
+	dev->summaryTags = NULL;
+	dev->summaryBlock = -1;
+
+	if (!dev->isYaffs2)
+		return YAFFS_OK;
+
+	sumBytesPerChunk = dev->nDataBytesPerChunk -
+				sizeof(yaffs_SummaryHeader);
+	if (sumBytesPerChunk <= 0)
+		return YAFFS_OK;
+
+	sumBytes = dev->nChunksPerBlock * sizeof(yaffs_PackedTags2TagsPart);
+	chunksUsed = (sumBytes + sumBytesPerChunk - 1) / sumBytesPerChunk;
+
+	if (chunksUsed >= dev->nChunksPerBlock) {
+		/* The summary does not fit; run without summaries. */
+		return YAFFS_OK;
+	}
+
+	dev->chunksPerSummary = dev->nChunksPerBlock - chunksUsed;
+
+	dev->summaryTags = YMALLOC(dev->chunksPerSummary *
+				sizeof(yaffs_PackedTags2TagsPart));
+	if (!dev->summaryTags) {
+		dev->chunksPerSummary = 0;
+		return YAFFS_FAIL;
+	}
+
+	yaffs_SummaryClear(dev);
+
+	return YAFFS_OK;
+}
+
+static unsigned yaffs_SummaryChecksum(yaffs_Device *dev)
+{
+	const __u8 *bytes = (const __u8 *)dev->summaryTags;
+	int n = dev->chunksPerSummary * sizeof(yaffs_PackedTags2TagsPart);
+	unsigned sum = 0;
+
+	while (n > 0) {
+		sum += *bytes++;
+		n--;
+	}
+	return sum;
+}
+
+static void yaffs_SummaryRecord(yaffs_Device *dev,
+				const yaffs_ExtendedTags *tags,
+				int chunkInBlock)
+{
+	yaffs_PackedTags2TagsPart *sumTags =
+		&((yaffs_PackedTags2TagsPart *)dev->summaryTags)[chunkInBlock];
+
+	yaffs_PackTags2TagsPart(sumTags, tags);
+}
+
+static void yaffs_SummaryFetch(yaffs_Device *dev,
+				yaffs_ExtendedTags *tags,
+				int chunkInBlock)
+{
+	yaffs_PackedTags2TagsPart *sumTags =
+		&((yaffs_PackedTags2TagsPart *)dev->summaryTags)[chunkInBlock];
+
+	yaffs_UnpackTags2TagsPart(tags, sumTags);
+}
+
+/* Write out the summary for the current allocation block and close the
+ * block off.  Called when the last data chunk of the block is written.
+ */
+static void yaffs_SummaryWrite(yaffs_Device *dev, int blk)
+{
+	yaffs_SummaryHeader hdr;
+	yaffs_ExtendedTags tags;
+	yaffs_BlockInfo *bi = yaffs_GetBlockInfo(dev, blk);
+	__u8 *buffer;
+	__u8 *sumBuffer = (__u8 *)dev->summaryTags;
+	int sumBytesPerChunk = dev->nDataBytesPerChunk -
+				sizeof(yaffs_SummaryHeader);
+	int nBytes = dev->chunksPerSummary *
+			sizeof(yaffs_PackedTags2TagsPart);
+	int chunkInBlock = dev->chunksPerSummary;
+	int chunkInNAND = blk * dev->nChunksPerBlock + chunkInBlock;
+	int thisTx;
+	int result = YAFFS_OK;
+
+	buffer = yaffs_GetTempBuffer(dev, __LINE__);
+
+	hdr.version = YAFFS_SUMMARY_VERSION;
+	hdr.block = blk;
+	hdr.sequenceNumber = bi->sequenceNumber;
+	hdr.sum = yaffs_SummaryChecksum(dev);
+
+	while (result == YAFFS_OK && nBytes > 0 &&
+	       chunkInBlock < dev->nChunksPerBlock) {
+		thisTx = nBytes;
+		if (thisTx > sumBytesPerChunk)
+			thisTx = sumBytesPerChunk;
+
+		memset(buffer, 0xFF, dev->nDataBytesPerChunk);
+		memcpy(buffer, &hdr, sizeof(hdr));
+		memcpy(buffer + sizeof(hdr), sumBuffer, thisTx);
+
+		yaffs_InitialiseTags(&tags);
+		tags.chunkUsed = 1;
+		tags.objectId = YAFFS_OBJECTID_SUMMARY;
+		tags.chunkId = chunkInBlock - dev->chunksPerSummary + 1;
+		tags.byteCount = thisTx;
+		tags.sequenceNumber = bi->sequenceNumber;
+
+		result = yaffs_WriteChunkWithTagsToNAND(dev, chunkInNAND,
+							buffer, &tags);
+		if (result != YAFFS_OK)
+			break;
+
+		yaffs_SetChunkBit(dev, blk, chunkInBlock);
+		bi->pagesInUse++;
+		dev->nFreeChunks--;
+
+		sumBuffer += thisTx;
+		nBytes -= thisTx;
+		chunkInBlock++;
+		chunkInNAND++;
+	}
+
+	if (result != YAFFS_OK)
+		T(YAFFS_TRACE_ERROR,
+		  (TSTR("yaffs: summary write failed for block %d" TENDSTR),
+		   blk));
+
+	yaffs_ReleaseTempBuffer(dev, buffer, __LINE__);
+
+	/* The block is full now, summary or no summary; the scanner falls
+	 * back to a full tag scan for blocks whose summary is unreadable.
+	 */
+	bi->blockState = YAFFS_BLOCK_STATE_FULL;
+	if (dev->allocationBlock == blk)
+		dev->allocationBlock = -1;
+}
+
+/* Note the tags of a freshly written chunk in the summary buffer and
+ * write the summary out when the last data chunk of the block goes down.
+ */
+static void yaffs_SummaryAdd(yaffs_Device *dev,
+				const yaffs_ExtendedTags *tags,
+				int chunkInNAND)
+{
+	int blockInNAND = chunkInNAND / dev->nChunksPerBlock;
+	int chunkInBlock = chunkInNAND % dev->nChunksPerBlock;
+
+	if (!dev->chunksPerSummary ||
+	    blockInNAND != dev->summaryBlock ||
+	    chunkInBlock >= dev->chunksPerSummary)
+		return;
+
+	yaffs_SummaryRecord(dev, tags, chunkInBlock);
+
+	if (chunkInBlock == dev->chunksPerSummary - 1)
+		yaffs_SummaryWrite(dev, blockInNAND);
+}
+
+/* Try to load the summary for a block during scanning.
+ * Returns YAFFS_OK and fills dev->summaryTags if a valid summary was
+ * found; the caller then need not read per-chunk tags for the block.
+ */
+static int yaffs_SummaryRead(yaffs_Device *dev, int blk)
+{
+	yaffs_SummaryHeader hdr;
+	yaffs_ExtendedTags tags;
+	yaffs_BlockInfo *bi = yaffs_GetBlockInfo(dev, blk);
+	__u8 *buffer;
+	__u8 *sumBuffer = (__u8 *)dev->summaryTags;
+	int sumBytesPerChunk = dev->nDataBytesPerChunk -
+				sizeof(yaffs_SummaryHeader);
+	int nBytes = dev->chunksPerSummary *
+			sizeof(yaffs_PackedTags2TagsPart);
+	int chunkInBlock = dev->chunksPerSummary;
+	int chunkInNAND = blk * dev->nChunksPerBlock + chunkInBlock;
+	int thisTx;
+	int c;
+	int result = YAFFS_OK;
+
+	memset(&hdr, 0, sizeof(hdr));
+
+	buffer = yaffs_GetTempBuffer(dev, __LINE__);
+
+	while (result == YAFFS_OK && nBytes > 0 &&
+	       chunkInBlock < dev->nChunksPerBlock) {
+		thisTx = nBytes;
+		if (thisTx > sumBytesPerChunk)
+			thisTx = sumBytesPerChunk;
+
+		result = yaffs_ReadChunkWithTagsFromNAND(dev, chunkInNAND,
+							buffer, &tags);
+
+		if (!tags.chunkUsed ||
+		    tags.objectId != YAFFS_OBJECTID_SUMMARY ||
+		    tags.chunkId !=
+			(unsigned)(chunkInBlock - dev->chunksPerSummary + 1) ||
+		    tags.byteCount != (unsigned)thisTx ||
+		    tags.eccResult == YAFFS_ECC_RESULT_UNFIXED)
+			result = YAFFS_FAIL;
+
+		if (result != YAFFS_OK)
+			break;
+
+		if (chunkInBlock == dev->chunksPerSummary)
+			memcpy(&hdr, buffer, sizeof(hdr));
+
+		memcpy(sumBuffer, buffer + sizeof(hdr), thisTx);
+
+		sumBuffer += thisTx;
+		nBytes -= thisTx;
+		chunkInBlock++;
+		chunkInNAND++;
+	}
+
+	yaffs_ReleaseTempBuffer(dev, buffer, __LINE__);
+
+	if (result == YAFFS_OK &&
+	    (hdr.version != YAFFS_SUMMARY_VERSION ||
+	     hdr.block != (unsigned)blk ||
+	     hdr.sequenceNumber != bi->sequenceNumber ||
+	     hdr.sum != yaffs_SummaryChecksum(dev)))
+		result = YAFFS_FAIL;
+
+	if (result == YAFFS_OK) {
+		/* Account for the summary chunks themselves; the scanner
+		 * will not visit them.
+		 */
+		for (c = dev->chunksPerSummary; c < chunkInBlock; c++) {
+			yaffs_SetChunkBit(dev, blk, c);
+			bi->pagesInUse++;
+		}
+	}
+
+	return result;
+}
+
 /*
  * Verification code
  */
@@ -1002,6 +1285,8 @@ static int yaffs_WriteNewChunkWithTagsToNAND(struct yaffs_DeviceStruct *dev,
 		/* Copy the data into the robustification buffer */
 		yaffs_HandleWriteChunkOk(dev, chunk, data, tags);
 
+		yaffs_SummaryAdd(dev, tags, chunk);
+
 	} while (writeOk != YAFFS_OK &&
 		(yaffs_wr_attempts <= 0 || attempts <= yaffs_wr_attempts));
 
@@ -2921,6 +3206,12 @@ static int yaffs_AllocateChunk(yaffs_Device *dev, int useReserve,
 		/* Get next block to allocate off */
 		dev->allocationBlock = yaffs_FindBlockForAllocation(dev);
 		dev->allocationPage = 0;
+
+		/* Start a fresh summary for the new block */
+		if (dev->chunksPerSummary && dev->allocationBlock >= 0) {
+			yaffs_SummaryClear(dev);
+			dev->summaryBlock = dev->allocationBlock;
+		}
 	}
 
 	if (!useReserve && !yaffs_CheckSpaceForAllocation(dev)) {
@@ -3060,9 +3351,18 @@ static int yaffs_GarbageCollectBlock(yaffs_Device *dev, int block,
 				yaffs_ReadChunkWithTagsFromNAND(dev, oldChunk,
 								buffer, &tags);
 
-				object =
-				    yaffs_FindObjectByNumber(dev,
-							     tags.objectId);
+				if (tags.chunkId > 0 &&
+				    tags.objectId == YAFFS_OBJECTID_SUMMARY) {
+					/* Summary chunk: nothing to copy,
+					 * the delete below drops it along
+					 * with the block.
+					 */
+					object = NULL;
+					markNAND = 0;
+				} else
+					object =
+					    yaffs_FindObjectByNumber(dev,
+								tags.objectId);
 
 				T(YAFFS_TRACE_GC_DETAIL,
 				  (TSTR
@@ -3085,7 +3385,8 @@ static int yaffs_GarbageCollectBlock(yaffs_Device *dev, int block,
 
 				}
 
-				if (!object) {
+				if (!object &&
+				    tags.objectId != YAFFS_OBJECTID_SUMMARY) {
 					T(YAFFS_TRACE_ERROR,
 					  (TSTR
 					   ("page %d in gc has no object: %d %d %d "
@@ -3238,6 +3539,27 @@ static int yaffs_GarbageCollectBlock(yaffs_Device *dev, int block,
  * The idea is to help clear out space in a more spread-out manner.
  * Dunno if it really does anything useful.
  */
+/* How badly do we need erased blocks?  Zero means no hurry; positive is
+ * the number of blocks we are short of the comfortable threshold.
+ */
+int yaffs_GetGCUrgency(yaffs_Device *dev)
+{
+	int checkpointBlockAdjust;
+	int threshold;
+
+	checkpointBlockAdjust = yaffs_CalcCheckpointBlocksRequired(dev) -
+				dev->blocksInCheckpoint;
+	if (checkpointBlockAdjust < 0)
+		checkpointBlockAdjust = 0;
+
+	threshold = dev->nReservedBlocks + checkpointBlockAdjust + 2;
+
+	if (dev->nErasedBlocks >= threshold)
+		return 0;
+
+	return threshold - dev->nErasedBlocks;
+}
+
 static int yaffs_CheckGarbageCollection(yaffs_Device *dev)
 {
 	int block;
@@ -3245,8 +3567,6 @@ static int yaffs_CheckGarbageCollection(yaffs_Device *dev)
 	int gcOk = YAFFS_OK;
 	int maxTries = 0;
 
-	int checkpointBlockAdjust;
-
 	if (dev->isDoingGC) {
 		/* Bail out so we don't get recursive gc */
 		return YAFFS_OK;
@@ -3259,16 +3579,19 @@ static int yaffs_CheckGarbageCollection(yaffs_Device *dev)
 	do {
 		maxTries++;
 
-		checkpointBlockAdjust = yaffs_CalcCheckpointBlocksRequired(dev) - dev->blocksInCheckpoint;
-		if (checkpointBlockAdjust < 0)
-			checkpointBlockAdjust = 0;
-
-		if (dev->nErasedBlocks < (dev->nReservedBlocks + checkpointBlockAdjust + 2)) {
+		if (yaffs_GetGCUrgency(dev) > 0) {
 			/* We need a block soon...*/
 			aggressive = 1;
 		} else {
 			/* We're in no hurry */
 			aggressive = 0;
+
+			/* With a background GC thread running, routine
+			 * tidying happens off-line; don't stall the write
+			 * path for it.
+			 */
+			if (dev->backgroundGC)
+				return YAFFS_OK;
 		}
 
 		if (dev->gcBlock <= 0) {
@@ -3304,6 +3627,49 @@ static int yaffs_CheckGarbageCollection(yaffs_Device *dev)
 	return aggressive ? gcOk : YAFFS_OK;
 }
 
+/* One increment of background garbage collection.  Called by the OS glue
+ * from its GC thread with the gross lock held.  Returns non-zero while
+ * there is more work worth doing.
+ */
+int yaffs_BackgroundGarbageCollect(yaffs_Device *dev, int urgency)
+{
+	int aggressive = (urgency > 0);
+	int block;
+
+	if (dev->isDoingGC)
+		return 1;
+
+	/* Don't break a saved checkpoint just to tidy up; wait until
+	 * writes have invalidated it anyway.
+	 */
+	if (!aggressive && dev->isCheckpointed)
+		return 0;
+
+	if (dev->gcBlock <= 0) {
+		dev->gcBlock = yaffs_FindBlockForGarbageCollection(dev,
+								aggressive);
+		dev->gcChunk = 0;
+	}
+
+	block = dev->gcBlock;
+
+	if (block <= 0)
+		return 0;
+
+	dev->garbageCollections++;
+	dev->backgroundGarbageCollections++;
+	if (!aggressive)
+		dev->passiveGarbageCollections++;
+
+	T(YAFFS_TRACE_GC,
+	  (TSTR("yaffs: background GC block %d urgency %d" TENDSTR),
+	   block, urgency));
+
+	yaffs_GarbageCollectBlock(dev, block, aggressive);
+
+	return dev->gcBlock > 0 || yaffs_GetGCUrgency(dev) > 0;
+}
+
 /*-------------------------  TAGS --------------------------------*/
 
 static int yaffs_TagsMatch(const yaffs_ExtendedTags *tags, int objectId,
@@ -6138,6 +6504,7 @@ static int yaffs_ScanBackwards(yaffs_Device *dev)
 	int fileSize;
 	int isShrink;
 	int foundChunksInBlock;
+	int summaryAvailable;
 	int equivalentObjectId;
 	int alloc_failed = 0;
 
@@ -6293,7 +6660,21 @@ static int yaffs_ScanBackwards(yaffs_Device *dev)
 
 		/* For each chunk in each block that needs scanning.... */
 		foundChunksInBlock = 0;
-		for (c = dev->nChunksPerBlock - 1;
+
+		/* If the block carries a valid summary then the tags of all
+		 * its data chunks come from the summary and only the data
+		 * chunks need walking.
+		 */
+		summaryAvailable = 0;
+		if (dev->chunksPerSummary &&
+		    state == YAFFS_BLOCK_STATE_NEEDS_SCANNING &&
+		    yaffs_SummaryRead(dev, blk) == YAFFS_OK) {
+			summaryAvailable = 1;
+			foundChunksInBlock = 1;
+		}
+
+		for (c = summaryAvailable ?
+			dev->chunksPerSummary - 1 : dev->nChunksPerBlock - 1;
 		     !alloc_failed && c >= 0 &&
 		     (state == YAFFS_BLOCK_STATE_NEEDS_SCANNING ||
 		      state == YAFFS_BLOCK_STATE_ALLOCATING); c--) {
@@ -6303,8 +6684,21 @@ static int yaffs_ScanBackwards(yaffs_Device *dev)
 
 			chunk = blk * dev->nChunksPerBlock + c;
 
-			result = yaffs_ReadChunkWithTagsFromNAND(dev, chunk, NULL,
-							&tags);
+			if (summaryAvailable) {
+				yaffs_SummaryFetch(dev, &tags, c);
+				result = YAFFS_OK;
+			} else
+				result = yaffs_ReadChunkWithTagsFromNAND(dev,
+							chunk, NULL, &tags);
+
+			/* Keep the in-memory summary up to date while we
+			 * re-walk the block we will resume allocating from.
+			 */
+			if (dev->summaryBlock == blk &&
+			    c < dev->chunksPerSummary &&
+			    tags.chunkUsed &&
+			    tags.eccResult != YAFFS_ECC_RESULT_UNFIXED)
+				yaffs_SummaryRecord(dev, &tags, c);
 
 			/* Let's have a good look at this chunk... */
 
@@ -6339,6 +6733,17 @@ static int yaffs_ScanBackwards(yaffs_Device *dev)
 							dev->allocationBlock = blk;
 							dev->allocationPage = c;
 							dev->allocationBlockFinder = blk;
+
+							/* Rebuild the summary
+							 * for this block as
+							 * we walk the rest
+							 * of it.
+							 */
+							if (dev->chunksPerSummary &&
+							    dev->summaryBlock != blk) {
+								yaffs_SummaryClear(dev);
+								dev->summaryBlock = blk;
+							}
 						} else {
 							/* This is a partially written block that is not
 							 * the current allocation block. This block must have
@@ -6371,7 +6776,18 @@ static int yaffs_ScanBackwards(yaffs_Device *dev)
 				 (TSTR("Chunk (%d:%d) with bad tags:obj = %d, chunkId = %d, byteCount = %d, ignored"TENDSTR),
 			  	 blk, c, tags.objectId, tags.chunkId, tags.byteCount));
 
-				  dev->nFreeChunks++;			
+				  dev->nFreeChunks++;
+
+			} else if (tags.chunkId > 0 &&
+				tags.objectId == YAFFS_OBJECTID_SUMMARY) {
+				/* A summary chunk in a block whose summary
+				 * could not be used.  Account for the space
+				 * but don't make an object out of it.
+				 */
+				foundChunksInBlock = 1;
+
+				yaffs_SetChunkBit(dev, blk, c);
+				bi->pagesInUse++;
 
 			} else if (tags.chunkId > 0) {
 				/* chunkId > 0 so it is a data chunk... */
@@ -7532,6 +7948,9 @@ int yaffs_GutsInitialise(yaffs_Device *dev)
 			init_failed = 1;
 	}
 
+	if (!init_failed && yaffs_SummaryInit(dev) != YAFFS_OK)
+		init_failed = 1;
+
 	if (dev->isYaffs2)
 		dev->useHeaderFileSize = 1;
 
@@ -7646,6 +8065,8 @@ void yaffs_Deinitialise(yaffs_Device *dev)
 
 		YFREE(dev->gcCleanupList);
 
+		yaffs_SummaryDeinit(dev);
+
 		for (i = 0; i < YAFFS_N_TEMP_BUFFERS; i++)
 			YFREE(dev->tempBuffer[i].buffer);
 
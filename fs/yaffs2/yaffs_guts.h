@@ -88,9 +88,14 @@
 #define YAFFS_OBJECTID_CHECKPOINT_DATA	0x20
 #define YAFFS_SEQUENCE_CHECKPOINT_DATA  0x21
 
+/* Pseudo object id for block summary chunks.
+ * (0x10 is taken by the superblock header above, so use 0x30.)
+ */
+#define YAFFS_OBJECTID_SUMMARY		0x30
+
 /* */
 
-#define YAFFS_MAX_SHORT_OP_CACHES	20
+#define YAFFS_MAX_SHORT_OP_CACHES	128
 
 #define YAFFS_N_TEMP_BUFFERS		6
 
@@ -693,6 +698,14 @@ struct yaffs_DeviceStruct {
 	__u32 allocationPage;
 	int allocationBlockFinder;	/* Used to search for next allocation block */
 
+	/* Block summaries (yaffs2 only).
+	 * chunksPerSummary is the number of data chunks per block when
+	 * summaries are in use; zero means summaries are disabled.
+	 */
+	int chunksPerSummary;
+	int summaryBlock;	/* Block the summary buffer tracks, or -1 */
+	void *summaryTags;	/* Packed tag parts for the allocation block */
+
 	/* Runtime state */
 	int nTnodesCreated;
 	yaffs_Tnode *freeTnodes;
@@ -702,6 +715,8 @@ struct yaffs_DeviceStruct {
 	int isDoingGC;
 	int gcBlock;
 	int gcChunk;
+	int backgroundGC;	/* A background GC thread is running */
+	void *gcThread;		/* Background GC thread; owned by OS glue */
 
 	int nObjectsCreated;
 	yaffs_Object *freeObjects;
@@ -728,6 +743,7 @@ struct yaffs_DeviceStruct {
 	int nGCCopies;
 	int garbageCollections;
 	int passiveGarbageCollections;
+	int backgroundGarbageCollections;
 	int nRetriedWrites;
 	int nRetiredBlocks;
 	int eccFixed;
@@ -827,6 +843,10 @@ void yaffs_Deinitialise(yaffs_Device *dev);
 
 int yaffs_GetNumberOfFreeChunks(yaffs_Device *dev);
 
+/* Background garbage collection */
+int yaffs_GetGCUrgency(yaffs_Device *dev);
+int yaffs_BackgroundGarbageCollect(yaffs_Device *dev, int urgency);
+
 int yaffs_RenameObject(yaffs_Object *oldDir, const YCHAR *oldName,
 		       yaffs_Object *newDir, const YCHAR *newName);
 
@@ -0,0 +1,18 @@
+#ifndef _LINUX_ALLOC_SAMPLE_H
+#define _LINUX_ALLOC_SAMPLE_H
+
+#include <linux/types.h>
+
+/*
+ * Sampled allocation origin tracking. Records the call site and size
+ * of 1-in-N slab and page allocations; see mm/alloc_sample.c.
+ */
+#ifdef CONFIG_ALLOC_SAMPLING
+extern void alloc_sample(unsigned long call_site, size_t size);
+#else
+static inline void alloc_sample(unsigned long call_site, size_t size)
+{
+}
+#endif
+
+#endif /* _LINUX_ALLOC_SAMPLE_H */
@@ -52,6 +52,8 @@ enum android_alarm_type {
  * @softexpires: the absolute earliest expiry time of the alarm.
  * @expires:	the absolute expiry time.
  * @function:	alarm expiry callback function
+ * @uid:	uid of the last task that started the alarm, for wakeup
+ *		accounting
  *
  * The alarm structure must be initialized by alarm_init()
  *
@@ -63,6 +65,7 @@ struct alarm {
 	ktime_t			softexpires;
 	ktime_t			expires;
 	void			(*function)(struct alarm *);
+	uid_t			uid;
 };
 
 void alarm_init(struct alarm *alarm,
@@ -89,6 +92,14 @@ enum android_alarm_return_flags {
 	ANDROID_ALARM_TIME_CHANGE_MASK = 1U << 16
 };
 
+/* expiry window for ANDROID_ALARM_SET_RANGE; the alarm fires no
+ * earlier than earliest and no later than latest, letting the kernel
+ * batch it into a single wakeup with other alarms due in the window */
+struct alarm_time_range {
+	struct timespec earliest;
+	struct timespec latest;
+};
+
 /* Disable alarm */
 #define ANDROID_ALARM_CLEAR(type)           _IO('a', 0 | ((type) << 4))
 
@@ -101,6 +112,8 @@ enum android_alarm_return_flags {
 #define ANDROID_ALARM_SET_AND_WAIT(type)    ALARM_IOW(3, type, struct timespec)
 #define ANDROID_ALARM_GET_TIME(type)        ALARM_IOW(4, type, struct timespec)
 #define ANDROID_ALARM_SET_RTC               _IOW('a', 5, struct timespec)
+#define ANDROID_ALARM_SET_RANGE(type)       ALARM_IOW(6, type, \
+						struct alarm_time_range)
 #define ANDROID_ALARM_BASE_CMD(cmd)         (cmd & ~(_IOC(0, 0, 0xf0, 0)))
 #define ANDROID_ALARM_IOCTL_TO_TYPE(cmd)    (_IOC_NR(cmd) >> 4)
 
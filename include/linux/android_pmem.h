@@ -129,6 +129,13 @@ enum pmem_allocator_type {
 int32_t pmem_kalloc(const size_t size, const uint32_t flags);
 int32_t pmem_kfree(const int32_t physaddr);
 
+/* mark a pmem_kalloc'd buffer as movable: the allocator may relocate it
+ * to fight fragmentation, notifying the owner through the callback (see
+ * drivers/misc/pmem.c for the callback contract); align must match the
+ * alignment the buffer was allocated with */
+int pmem_set_movable(const int32_t physaddr, const unsigned int align,
+	int (*relocate)(void *data, unsigned long new_paddr), void *data);
+
 /* kernel api names for board specific data structures */
 #define PMEM_KERNEL_EBI1_DATA_NAME "pmem_kernel_ebi1"
 #define PMEM_KERNEL_SMI_DATA_NAME "pmem_kernel_smi"
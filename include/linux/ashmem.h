@@ -50,4 +50,12 @@ int get_ashmem_file(int fd, struct file **filp, struct file **vm_file,
 			unsigned long *len);
 void put_ashmem_file(struct file *file);
 
+#ifdef CONFIG_ASHMEM
+void ashmem_discard_notify(void);
+#else
+static inline void ashmem_discard_notify(void)
+{
+}
+#endif
+
 #endif	/* _LINUX_ASHMEM_H */
@@ -198,6 +198,10 @@ struct request {
 #ifdef CONFIG_BLK_CGROUP
 	unsigned long long start_time_ns;
 	unsigned long long io_start_time_ns;    /* when passed to hardware */
+#endif
+#ifdef CONFIG_BLK_IO_LATENCY
+	struct io_context *lat_ioc;	/* submitter, for latency histograms */
+	unsigned long long lat_submit_ns;
 #endif
 	/* Number of scatter-gather DMA addr+len pairs after
 	 * physical address coalescing is performed.
@@ -885,6 +889,8 @@ static inline unsigned int blk_rq_cur_sectors(const struct request *rq)
  * Request issue related functions.
  */
 extern struct request *blk_peek_request(struct request_queue *q);
+extern struct request *blk_peek_request_contig(struct request_queue *q,
+					       struct request *prev);
 extern void blk_start_request(struct request *rq);
 extern struct request *blk_fetch_request(struct request_queue *q);
 
@@ -1016,6 +1022,9 @@ extern int blkdev_issue_flush(struct block_device *, gfp_t, sector_t *,
 			unsigned long);
 extern int blkdev_issue_discard(struct block_device *bdev, sector_t sector,
 		sector_t nr_sects, gfp_t gfp_mask, unsigned long flags);
+extern int blkdev_queue_discard(struct block_device *bdev, sector_t sector,
+		sector_t nr_sects, gfp_t gfp_mask);
+extern int blkdev_discard_flush(struct block_device *bdev);
 extern int blkdev_issue_zeroout(struct block_device *bdev, sector_t sector,
 			sector_t nr_sects, gfp_t gfp_mask, unsigned long flags);
 static inline int sb_issue_discard(struct super_block *sb,
@@ -176,6 +176,7 @@ struct cpufreq_governor {
 	unsigned int max_transition_latency; /* HW must be able to switch to
 			next freq faster than this value in nano secs or we
 			will fallback to performance governor */
+	unsigned int input_boost; /* opt into the core input-event boost */
 	struct list_head	governor_list;
 	struct module		*owner;
 };
@@ -44,6 +44,7 @@ struct dentry_stat_t {
 	int dummy[2];
 };
 extern struct dentry_stat_t dentry_stat;
+extern int sysctl_neg_dentry_limit;
 
 /* Name hashing routines. Initial hash value */
 /* Hash courtesy of the R5 hash in reiserfs modulo sign bits */
@@ -18,6 +18,7 @@
 
 #ifdef CONFIG_HAS_EARLYSUSPEND
 #include <linux/list.h>
+#include <linux/workqueue.h>
 #endif
 
 /* The early_suspend structure defines suspend and resume hooks to be called
@@ -41,6 +42,8 @@ struct early_suspend {
 	int level;
 	void (*suspend)(struct early_suspend *h);
 	void (*resume)(struct early_suspend *h);
+	/* used internally to run same-level handlers concurrently */
+	struct work_struct work;
 #endif
 };
 
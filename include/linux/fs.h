@@ -1348,6 +1348,9 @@ struct super_block {
 	/* s_dentry_lru and s_nr_dentry_unused are protected by dcache_lock */
 	struct list_head	s_dentry_lru;	/* unused dentry lru */
 	int			s_nr_dentry_unused;	/* # of dentry on lru */
+	atomic_t		s_nr_neg_dentry;	/* # of negative dentries */
+	unsigned long		s_neg_dentry_hits;	/* lookups hitting a negative dentry */
+	unsigned long		s_pos_dentry_hits;	/* lookups hitting a positive dentry */
 
 	struct block_device	*s_bdev;
 	struct backing_dev_info *s_bdi;
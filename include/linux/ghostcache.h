@@ -0,0 +1,31 @@
+#ifndef _LINUX_GHOSTCACHE_H
+#define _LINUX_GHOSTCACHE_H
+
+#include <linux/mm_types.h>
+
+struct address_space;
+
+/*
+ * Compressed second-chance cache for evicted clean file pages; see
+ * mm/ghostcache.c.
+ */
+#ifdef CONFIG_GHOST_CACHE
+extern void ghostcache_put_page(struct address_space *mapping,
+				struct page *page);
+extern int ghostcache_get_page(struct page *page);
+extern void ghostcache_invalidate_inode(struct address_space *mapping);
+#else
+static inline void ghostcache_put_page(struct address_space *mapping,
+				       struct page *page)
+{
+}
+static inline int ghostcache_get_page(struct page *page)
+{
+	return -1;
+}
+static inline void ghostcache_invalidate_inode(struct address_space *mapping)
+{
+}
+#endif
+
+#endif /* _LINUX_GHOSTCACHE_H */
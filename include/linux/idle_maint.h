@@ -0,0 +1,56 @@
+/* include/linux/idle_maint.h
+ *
+ * Opportunistic idle-time maintenance work.
+ *
+ * Copyright (C) 2011 LGE, Inc.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#ifndef _LINUX_IDLE_MAINT_H
+#define _LINUX_IDLE_MAINT_H
+
+#include <linux/list.h>
+#include <linux/types.h>
+
+/* A short, bounded piece of deferrable maintenance work.  The owner
+ * registers it once, then calls idle_maint_request() whenever there is
+ * something to do.  When the idle path predicts an idle period long
+ * enough to pay for cost_us, run() is called once from a low priority
+ * kernel thread; returning nonzero re-requests the item for the next
+ * idle period.
+ */
+struct idle_maint_work {
+	struct list_head link;
+	const char *name;
+	unsigned int cost_us;	/* worst case cost of one run() call */
+	int (*run)(struct idle_maint_work *work);
+	void *data;
+	int pending;
+	int busy;
+};
+
+#ifdef CONFIG_MSM_IDLE_MAINT
+void idle_maint_register(struct idle_maint_work *work);
+void idle_maint_unregister(struct idle_maint_work *work);
+void idle_maint_request(struct idle_maint_work *work);
+int idle_maint_idle_enter(int64_t idle_time_ns);
+#else
+static inline void idle_maint_register(struct idle_maint_work *work) {}
+static inline void idle_maint_unregister(struct idle_maint_work *work) {}
+static inline void idle_maint_request(struct idle_maint_work *work) {}
+static inline int idle_maint_idle_enter(int64_t idle_time_ns)
+{
+	return 0;
+}
+#endif
+
+#endif
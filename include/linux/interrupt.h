@@ -411,6 +411,7 @@ extern void softirq_init(void);
 extern void raise_softirq_irqoff(unsigned int nr);
 extern void raise_softirq(unsigned int nr);
 extern void wakeup_softirqd(void);
+extern int softirq_time_limit_us;
 
 /* This is the worklist that queues up per-cpu softirq work.
  *
@@ -37,6 +37,11 @@ enum {
 	IOC_IOPRIO_CHANGED_BITS
 };
 
+#ifdef CONFIG_BLK_IO_LATENCY
+/* Number of log2 buckets in the per-io_context latency histograms. */
+#define BLK_IO_LAT_BUCKETS	16
+#endif
+
 /*
  * I/O subsystem state of the associated processes.  It is refcounted
  * and kmalloc'ed. These could be shared between processes.
@@ -66,6 +71,15 @@ struct io_context {
 	struct radix_tree_root bfq_radix_root;
 	struct hlist_head bfq_cic_list;
 	void *ioc_data;
+
+#ifdef CONFIG_BLK_IO_LATENCY
+	/*
+	 * Log2 histograms of request submit-to-complete latency, in
+	 * microseconds, one per data direction.  Updated locklessly
+	 * from completion context, so the counts are approximate.
+	 */
+	unsigned long lat_hist[2][BLK_IO_LAT_BUCKETS];
+#endif
 };
 
 static inline struct io_context *ioc_task_link(struct io_context *ioc)
@@ -11,8 +11,16 @@
 #define IOPRIO_CLASS_SHIFT	(13)
 #define IOPRIO_PRIO_MASK	((1UL << IOPRIO_CLASS_SHIFT) - 1)
 
+/*
+ * The top bit of the data field flags "launch mode": the task is
+ * cold-starting an application and readahead should not bother with
+ * window ramp-up. See ondemand_readahead(). The flag rides along in
+ * the normal ioprio value and is masked out of the priority data.
+ */
+#define IOPRIO_FLAG_LAUNCH	(1 << (IOPRIO_CLASS_SHIFT - 1))
+
 #define IOPRIO_PRIO_CLASS(mask)	((mask) >> IOPRIO_CLASS_SHIFT)
-#define IOPRIO_PRIO_DATA(mask)	((mask) & IOPRIO_PRIO_MASK)
+#define IOPRIO_PRIO_DATA(mask)	((mask) & IOPRIO_PRIO_MASK & ~IOPRIO_FLAG_LAUNCH)
 #define IOPRIO_PRIO_VALUE(class, data)	(((class) << IOPRIO_CLASS_SHIFT) | data)
 
 #define ioprio_valid(mask)	(IOPRIO_PRIO_CLASS((mask)) != IOPRIO_CLASS_NONE)
@@ -172,6 +172,31 @@ struct irq_2_iommu;
  * @dir:		/proc/irq/ procfs entry
  * @name:		flow handler name for /proc/interrupts output
  */
+#ifdef CONFIG_IRQ_TIME_STATS
+#define IRQ_TIME_HIST_BUCKETS	12
+
+/**
+ * struct irq_time_stats - handler timing statistics for one interrupt
+ * @max:		worst observed action-chain duration
+ * @hist:		log2 duration histogram; bucket n counts chains
+ *			that took less than 2^n units, last bucket is
+ *			open ended
+ * @thread_wake_stamp:	timestamp of the last threaded-handler wakeup
+ * @thread_wake_max:	worst observed wakeup-to-run latency of the
+ *			handler thread
+ *
+ * All values are in units of 1.024us (sched_clock() >> 10) and are
+ * written without locking from the context handling this interrupt;
+ * readers may see a torn update, which is acceptable for statistics.
+ */
+struct irq_time_stats {
+	u32			max;
+	u32			hist[IRQ_TIME_HIST_BUCKETS];
+	u32			thread_wake_stamp;
+	u32			thread_wake_max;
+};
+#endif
+
 struct irq_desc {
 	unsigned int		irq;
 	struct timer_rand_state *timer_rand_state;
@@ -205,6 +230,9 @@ struct irq_desc {
 	wait_queue_head_t       wait_for_threads;
 #ifdef CONFIG_PROC_FS
 	struct proc_dir_entry	*dir;
+#endif
+#ifdef CONFIG_IRQ_TIME_STATS
+	struct irq_time_stats	time_stats;
 #endif
 	const char		*name;
 } ____cacheline_internodealigned_in_smp;
@@ -734,6 +734,7 @@ jbd2_time_diff(unsigned long start, unsigned long end)
  * @j_wbufsize: maximum number of buffer_heads allowed in j_wbuf, the
  *	number that will fit in j_blocksize
  * @j_last_sync_writer: most recent pid which did a synchronous write
+ * @j_last_sync_time: time of the most recent synchronous handle stop
  * @j_history: Buffer storing the transactions statistics history
  * @j_history_max: Maximum number of transactions in the statistics history
  * @j_history_cur: Current number of transactions in the statistics history
@@ -944,6 +945,12 @@ struct journal_s
 	 */
 	pid_t			j_last_sync_writer;
 
+	/*
+	 * when the last synchronous handle was stopped; used with
+	 * JBD2_FSYNC_BATCH to spot back-to-back fsync traffic
+	 */
+	ktime_t			j_last_sync_time;
+
 	/*
 	 * the average amount of time in nanoseconds it takes to commit a
 	 * transaction to disk. [j_state_lock]
@@ -991,6 +998,8 @@ struct journal_s
 #define JBD2_ABORT_ON_SYNCDATA_ERR	0x040	/* Abort the journal on file
 						 * data write error in ordered
 						 * mode */
+#define JBD2_FSYNC_BATCH	0x080	/* Hold off back-to-back sync commits
+					 * from a single writer as well */
 
 /*
  * Function declarations for the journaling transaction and buffer
@@ -72,6 +72,7 @@ extern int mem_cgroup_shmem_charge_fallback(struct page *page,
 			struct mm_struct *mm, gfp_t gfp_mask);
 
 extern void mem_cgroup_out_of_memory(struct mem_cgroup *mem, gfp_t gfp_mask);
+extern int mem_cgroup_oom_priority(struct task_struct *p);
 int task_in_mem_cgroup(struct task_struct *task, const struct mem_cgroup *mem);
 
 extern struct mem_cgroup *try_get_mem_cgroup_from_page(struct page *page);
@@ -127,12 +128,19 @@ static inline bool mem_cgroup_disabled(void)
 }
 
 void mem_cgroup_update_file_mapped(struct page *page, int val);
+void mem_cgroup_update_file_dirty(struct page *page, int val);
+bool mem_cgroup_dirty_limit_exceeded(void);
 unsigned long mem_cgroup_soft_limit_reclaim(struct zone *zone, int order,
 						gfp_t gfp_mask, int nid,
 						int zid);
 #else /* CONFIG_CGROUP_MEM_RES_CTLR */
 struct mem_cgroup;
 
+static inline int mem_cgroup_oom_priority(struct task_struct *p)
+{
+	return 0;
+}
+
 static inline int mem_cgroup_newpage_charge(struct page *page,
 					struct mm_struct *mm, gfp_t gfp_mask)
 {
@@ -302,6 +310,16 @@ static inline void mem_cgroup_update_file_mapped(struct page *page,
 {
 }
 
+static inline void mem_cgroup_update_file_dirty(struct page *page,
+							int val)
+{
+}
+
+static inline bool mem_cgroup_dirty_limit_exceeded(void)
+{
+	return false;
+}
+
 static inline
 unsigned long mem_cgroup_soft_limit_reclaim(struct zone *zone, int order,
 					    gfp_t gfp_mask, int nid, int zid)
@@ -82,6 +82,17 @@ struct mmc_host_ops {
 	 */
 	int (*enable)(struct mmc_host *host);
 	int (*disable)(struct mmc_host *host, int lazy);
+	/*
+	 * It is optional for the host to implement pre_req and post_req in
+	 * order to support double buffering of requests (prepare one
+	 * request while another request is active).  pre_req is called
+	 * from a context that may sleep, before 'request'; post_req undoes
+	 * whatever pre_req set up, with 'err' non-zero if the request was
+	 * never started.  Hosts mark prepared data with data->host_cookie.
+	 */
+	void	(*pre_req)(struct mmc_host *host, struct mmc_request *req);
+	void	(*post_req)(struct mmc_host *host, struct mmc_request *req,
+			    int err);
 	void	(*request)(struct mmc_host *host, struct mmc_request *req);
 	/*
 	 * Avoid calling these three functions too often or in a "fast path",
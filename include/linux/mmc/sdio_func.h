@@ -158,6 +158,17 @@ extern void sdio_writel(struct sdio_func *func, u32 b,
 extern u8 sdio_writeb_readb(struct sdio_func *func, u8 write_byte,
 	unsigned int addr, int *err_ret);
 
+/* one entry of a sdio_reg_batch() burst; for reads the byte read is
+ * stored back in value */
+struct sdio_reg_op {
+	unsigned int addr;
+	u8 value;
+	u8 write;
+};
+
+extern int sdio_reg_batch(struct sdio_func *func, struct sdio_reg_op *ops,
+	unsigned count);
+
 extern int sdio_memcpy_toio(struct sdio_func *func, unsigned int addr,
 	void *src, int count);
 extern int sdio_writesb(struct sdio_func *func, unsigned int addr,
@@ -0,0 +1,41 @@
+/* Copyright (c) 2010, Code Aurora Forum. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+#ifndef _LINUX_MSM_NMEA_H
+#define _LINUX_MSM_NMEA_H
+
+#include <linux/ioctl.h>
+#include <linux/types.h>
+
+/*
+ * Record mode for /dev/nmea: each read returns as many whole records
+ * as fit in the supplied buffer.  A record is a header followed by
+ * the raw sentence bytes, with the next header aligned to 8 bytes:
+ *
+ *	offset 0:                     struct nmea_rec_hdr
+ *	offset sizeof(hdr):           len sentence bytes
+ *	next record at sizeof(hdr) + ((len + 7) & ~7)
+ *
+ * The timestamp is CLOCK_MONOTONIC captured in the SMD receive
+ * callback, before any scheduling delay.
+ */
+struct nmea_rec_hdr {
+	__u64 ts_ns;
+	__u32 len;
+	__u32 pad;
+};
+
+#define NMEA_IOCTL_MAGIC 'n'
+
+/* non-zero arg switches the fd to record mode, zero back to raw */
+#define NMEA_SET_REC_MODE _IOW(NMEA_IOCTL_MAGIC, 1, unsigned int)
+
+#endif
@@ -40,6 +40,17 @@
 		_IOW(MSM_ROTATOR_IOCTL_MAGIC, 2, struct msm_rotator_data_info)
 #define MSM_ROTATOR_IOCTL_FINISH   \
 		_IOW(MSM_ROTATOR_IOCTL_MAGIC, 3, int)
+/*
+ * Like ROTATE but returns as soon as the hardware is started; the job
+ * is reaped when the next rotation is issued or by WAIT, which returns
+ * the completion status of the last asynchronous job.  The rotator has
+ * a single pipe, so WAIT drains whatever is in flight regardless of
+ * the session id passed.
+ */
+#define MSM_ROTATOR_IOCTL_ROTATE_ASYNC   \
+		_IOW(MSM_ROTATOR_IOCTL_MAGIC, 4, struct msm_rotator_data_info)
+#define MSM_ROTATOR_IOCTL_WAIT   \
+		_IOW(MSM_ROTATOR_IOCTL_MAGIC, 5, int)
 
 enum rotator_clk_type {
 	ROTATOR_AXI_CLK,
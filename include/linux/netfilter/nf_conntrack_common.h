@@ -114,6 +114,8 @@ struct ip_conntrack_stat {
 	unsigned int expect_create;
 	unsigned int expect_delete;
 	unsigned int search_restart;
+	unsigned int cache_hit;
+	unsigned int cache_miss;
 };
 
 /* call to create an explicit dependency on nf_conntrack. */
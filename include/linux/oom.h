@@ -32,6 +32,10 @@ extern void out_of_memory(struct zonelist *zonelist, gfp_t gfp_mask,
 extern int register_oom_notifier(struct notifier_block *nb);
 extern int unregister_oom_notifier(struct notifier_block *nb);
 
+struct task_struct;
+/* track oom_adj writes to keep a preloaded victim candidate at hand */
+extern void oom_preload_update(struct task_struct *task);
+
 extern bool oom_killer_disabled;
 
 static inline void oom_killer_disable(void)
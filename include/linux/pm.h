@@ -458,6 +458,8 @@ struct dev_pm_info {
 	struct list_head	entry;
 	struct completion	completion;
 	unsigned long		wakeup_count;
+	s64			suspend_time_ns;	/* Owned by the PM core */
+	s64			resume_time_ns;		/* Owned by the PM core */
 #endif
 #ifdef CONFIG_PM_RUNTIME
 	struct timer_list	suspend_timer;
@@ -371,6 +371,8 @@ enum {
 #define RTAX_RTO_MIN RTAX_RTO_MIN
 	RTAX_INITRWND,
 #define RTAX_INITRWND RTAX_INITRWND
+	RTAX_DELACK_MAX,
+#define RTAX_DELACK_MAX RTAX_DELACK_MAX
 	__RTAX_MAX
 };
 
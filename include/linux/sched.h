@@ -114,6 +114,10 @@ struct perf_event_context;
  */
 #define CLONE_KERNEL	(CLONE_FS | CLONE_FILES | CLONE_SIGHAND)
 
+#define VMACACHE_BITS 2
+#define VMACACHE_SIZE (1U << VMACACHE_BITS)
+#define VMACACHE_MASK (VMACACHE_SIZE - 1)
+
 /*
  * These are the constant used to fake the fixed-point load-average
  * counting. Some notes:
@@ -720,6 +724,12 @@ extern struct user_struct root_user;
 struct backing_dev_info;
 struct reclaim_state;
 
+/*
+ * Buckets of the per-task wakeup latency histogram: log2 microseconds,
+ * the last bucket collecting everything of 32.768ms and above.
+ */
+#define SCHED_WAKEUP_HIST_BUCKETS 16
+
 #if defined(CONFIG_SCHEDSTATS) || defined(CONFIG_TASK_DELAY_ACCT)
 struct sched_info {
 	/* cumulative counters */
@@ -733,6 +743,10 @@ struct sched_info {
 	/* BKL stats */
 	unsigned int bkl_count;
 #endif
+#ifdef CONFIG_SCHED_WAKEUP_HIST
+	/* queued-to-oncpu latency histogram, /proc/<pid>/sched_hist */
+	unsigned int wait_hist[SCHED_WAKEUP_HIST_BUCKETS];
+#endif
 };
 #endif /* defined(CONFIG_SCHEDSTATS) || defined(CONFIG_TASK_DELAY_ACCT) */
 
@@ -1257,6 +1271,9 @@ struct task_struct {
 	struct plist_node pushable_tasks;
 
 	struct mm_struct *mm, *active_mm;
+	/* per-thread vma caching */
+	u32 vmacache_seqnum;
+	struct vm_area_struct *vmacache[VMACACHE_SIZE];
 #if defined(SPLIT_RSS_COUNTING)
 	struct task_rss_stat	rss_stat;
 #endif
@@ -2056,6 +2073,14 @@ static inline void sched_autogroup_fork(struct signal_struct *sig) { }
 static inline void sched_autogroup_exit(struct signal_struct *sig) { }
 #endif
 
+#ifdef CONFIG_SCHED_OOMADJ_GROUP
+extern unsigned int sysctl_sched_oomgroup_enabled;
+extern int sysctl_sched_oomgroup_adj;
+extern void sched_oomgroup_reclassify(struct task_struct *p);
+#else
+static inline void sched_oomgroup_reclassify(struct task_struct *p) { }
+#endif
+
 #ifdef CONFIG_RT_MUTEXES
 extern int rt_mutex_getprio(struct task_struct *p);
 extern void rt_mutex_setprio(struct task_struct *p, int prio);
@@ -2617,6 +2642,7 @@ extern void sched_move_task(struct task_struct *tsk);
 #ifdef CONFIG_FAIR_GROUP_SCHED
 extern int sched_group_set_shares(struct task_group *tg, unsigned long shares);
 extern unsigned long sched_group_shares(struct task_group *tg);
+extern u64 sched_group_child_exec_time(int cpu);
 #endif
 #ifdef CONFIG_RT_GROUP_SCHED
 extern int sched_group_set_rt_runtime(struct task_group *tg,
@@ -508,6 +508,26 @@ static inline struct sk_buff *alloc_skb_fclone(unsigned int size,
 
 extern bool skb_recycle_check(struct sk_buff *skb, int skb_size);
 
+/*
+ *	A small per-device pool of receive buffers built on top of
+ *	skb_recycle_check().  Drivers that free skbs themselves (typically
+ *	on transmit completion) can return them to the pool instead of the
+ *	allocator and pull them back out on the receive path, skipping the
+ *	alloc/free and initial cache-clean costs for small-packet loads.
+ *	The sk_buff_head's own lock makes the pool usable from any context.
+ */
+struct skb_pool {
+	struct sk_buff_head	queue;
+	unsigned int		size;	/* usable buffer size per skb */
+	unsigned int		max;	/* pool depth limit */
+};
+
+extern void skb_pool_init(struct skb_pool *pool, unsigned int size,
+			  unsigned int max);
+extern struct sk_buff *skb_pool_alloc(struct skb_pool *pool, unsigned int len);
+extern void skb_pool_recycle(struct skb_pool *pool, struct sk_buff *skb);
+extern void skb_pool_purge(struct skb_pool *pool);
+
 extern struct sk_buff *skb_morph(struct sk_buff *dst, struct sk_buff *src);
 extern struct sk_buff *skb_clone(struct sk_buff *skb,
 				 gfp_t priority);
@@ -34,10 +34,23 @@ enum stat_item {
 	ORDER_FALLBACK,		/* Number of times fallback was necessary */
 	NR_SLUB_STAT_ITEMS };
 
+/*
+ * Always-on subset of the statistics above: just the alloc/free
+ * fast/slow path split. Cheap enough (one per-cpu increment per event)
+ * to keep enabled in production builds where CONFIG_SLUB_STATS is not.
+ */
+enum hotstat_item {
+	HOT_ALLOC_FASTPATH,	/* Allocation from cpu slab */
+	HOT_ALLOC_SLOWPATH,	/* Allocation by getting a new cpu slab */
+	HOT_FREE_FASTPATH,	/* Free to cpu slab */
+	HOT_FREE_SLOWPATH,	/* Freeing not to cpu slab */
+	NR_SLUB_HOTSTAT_ITEMS };
+
 struct kmem_cache_cpu {
 	void **freelist;	/* Pointer to first free per cpu object */
 	struct page *page;	/* The slab from which we are allocating */
 	int node;		/* The node of the page (or -1 for debug) */
+	unsigned hotstat[NR_SLUB_HOTSTAT_ITEMS];
 #ifdef CONFIG_SLUB_STATS
 	unsigned stat[NR_SLUB_STAT_ITEMS];
 #endif
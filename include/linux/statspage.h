@@ -0,0 +1,71 @@
+/*
+ * statspage - consolidated binary counter snapshots for telemetry.
+ *
+ * Subsystems register groups of counters; a read of the debugfs file
+ * <debugfs>/statspage snapshots every registered group into one binary
+ * page, so a monitoring daemon collects all the hot-path counters with
+ * a single unformatted read.  The page can also be mmap()ed for
+ * zero-copy access; the sequence counter in the header is even while
+ * the snapshot is stable and odd while it is being rewritten.
+ *
+ * Page layout (all fields native endianness):
+ *
+ *	struct statspage_hdr
+ *	nr_groups times:
+ *		struct statspage_rec
+ *		rec.nr times u64 counter values
+ */
+#ifndef _LINUX_STATSPAGE_H
+#define _LINUX_STATSPAGE_H
+
+#include <linux/types.h>
+#include <linux/list.h>
+
+#define STATSPAGE_MAGIC		0x53504731	/* "SPG1" */
+#define STATSPAGE_NAME_LEN	16
+
+struct statspage_hdr {
+	__u32 magic;
+	__u32 seq;		/* odd while a snapshot is in progress */
+	__u32 nr_groups;
+	__u32 snap_jiffies;	/* low bits of jiffies at snapshot time */
+};
+
+struct statspage_rec {
+	char name[STATSPAGE_NAME_LEN];
+	__u32 nr;		/* number of u64 values that follow */
+	__u32 __pad;		/* keep the values 8-byte aligned */
+};
+
+/**
+ * struct statspage_group - a registered group of counters.
+ * @name: group name, truncated to %STATSPAGE_NAME_LEN - 1 characters.
+ * @nr: number of counters in the group.
+ * @counters: live counter array to be copied at snapshot time, read
+ *            locklessly; may be %NULL if @snapshot is provided.
+ * @snapshot: called at snapshot time to fill @nr values; used instead
+ *            of @counters, e.g. to sum per-cpu counters.
+ * @node: list node, for internal use.
+ */
+struct statspage_group {
+	const char *name;
+	unsigned int nr;
+	const unsigned long *counters;
+	void (*snapshot)(unsigned long *dst, unsigned int nr);
+	struct list_head node;
+};
+
+#ifdef CONFIG_STATSPAGE
+extern int statspage_register(struct statspage_group *grp);
+extern void statspage_unregister(struct statspage_group *grp);
+#else
+static inline int statspage_register(struct statspage_group *grp)
+{
+	return 0;
+}
+static inline void statspage_unregister(struct statspage_group *grp)
+{
+}
+#endif
+
+#endif /* _LINUX_STATSPAGE_H */
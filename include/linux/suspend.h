@@ -6,6 +6,7 @@
 #include <linux/init.h>
 #include <linux/pm.h>
 #include <linux/mm.h>
+#include <linux/ktime.h>
 #include <asm/errno.h>
 
 #if defined(CONFIG_PM_SLEEP) && defined(CONFIG_VT) && defined(CONFIG_VT_CONSOLE)
@@ -293,6 +294,18 @@ extern bool events_check_enabled;
 extern bool pm_check_wakeup_events(void);
 extern bool pm_get_wakeup_count(unsigned long *count);
 extern bool pm_save_wakeup_count(unsigned long count);
+
+/* drivers/base/power/stats.c */
+enum suspend_phase {
+	SUSPEND_PHASE_FREEZE,
+	SUSPEND_PHASE_DEV_SUSPEND,
+	SUSPEND_PHASE_ENTER,
+	SUSPEND_PHASE_DEV_RESUME,
+	SUSPEND_PHASE_THAW,
+	SUSPEND_PHASE_COUNT
+};
+
+extern void suspend_phase_record(enum suspend_phase phase, ktime_t starttime);
 #else /* !CONFIG_PM_SLEEP */
 
 static inline int register_pm_notifier(struct notifier_block *nb)
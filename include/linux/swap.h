@@ -248,6 +248,8 @@ extern unsigned long mem_cgroup_shrink_node_zone(struct mem_cgroup *mem,
 						struct zone *zone,
 						int nid);
 extern int __isolate_lru_page(struct page *page, int mode, int file);
+extern int isolate_lru_page(struct page *page);
+extern unsigned long reclaim_pages_from_list(struct list_head *page_list);
 extern unsigned long shrink_all_memory(unsigned long nr_pages);
 extern int vm_swappiness;
 extern int remove_mapping(struct address_space *mapping, struct page *page);
@@ -294,6 +296,7 @@ extern void swap_unplug_io_fn(struct backing_dev_info *, struct page *);
 /* linux/mm/page_io.c */
 extern int swap_readpage(struct page *);
 extern int swap_writepage(struct page *page, struct writeback_control *wbc);
+extern void swap_write_batch_flush(void);
 extern void end_swap_bio_read(struct bio *bio, int err);
 
 /* linux/mm/swap_state.c */
@@ -335,25 +338,10 @@ extern int try_to_free_swap(struct page *);
 struct backing_dev_info;
 
 /* linux/mm/thrash.c */
-extern struct mm_struct *swap_token_mm;
-extern void grab_swap_token(struct mm_struct *);
-extern void __put_swap_token(struct mm_struct *);
-
-static inline int has_swap_token(struct mm_struct *mm)
-{
-	return (mm == swap_token_mm);
-}
-
-static inline void put_swap_token(struct mm_struct *mm)
-{
-	if (has_swap_token(mm))
-		__put_swap_token(mm);
-}
-
-static inline void disable_swap_token(void)
-{
-	put_swap_token(swap_token_mm);
-}
+extern void swap_evict_note(struct mm_struct *mm);
+extern void swap_refault_note(struct mm_struct *mm);
+extern int swap_thrash_protected(struct mm_struct *mm);
+extern void swap_thrash_suspend(void);
 
 #ifdef CONFIG_CGROUP_MEM_RES_CTLR
 extern void
@@ -428,6 +416,10 @@ static inline int swap_writepage(struct page *p, struct writeback_control *wbc)
 	return 0;
 }
 
+static inline void swap_write_batch_flush(void)
+{
+}
+
 static inline struct page *lookup_swap_cache(swp_entry_t swp)
 {
 	return NULL;
@@ -467,20 +459,20 @@ static inline swp_entry_t get_swap_page(void)
 }
 
 /* linux/mm/thrash.c */
-static inline void put_swap_token(struct mm_struct *mm)
+static inline void swap_evict_note(struct mm_struct *mm)
 {
 }
 
-static inline void grab_swap_token(struct mm_struct *mm)
+static inline void swap_refault_note(struct mm_struct *mm)
 {
 }
 
-static inline int has_swap_token(struct mm_struct *mm)
+static inline int swap_thrash_protected(struct mm_struct *mm)
 {
 	return 0;
 }
 
-static inline void disable_swap_token(void)
+static inline void swap_thrash_suspend(void)
 {
 }
 
@@ -165,6 +165,10 @@ struct tcp_info {
 	__u32	tcpi_rcv_space;
 
 	__u32	tcpi_total_retrans;
+
+	/* Receive path header prediction hit rates */
+	__u32	tcpi_rcv_fastpath;
+	__u32	tcpi_rcv_slowpath;
 };
 
 /* for TCP_MD5SIG socket option */
@@ -386,6 +390,9 @@ struct tcp_sock {
 	u32	fackets_out;	/* FACK'd packets			*/
 	u32	tso_deferred;
 	u32	bytes_acked;	/* Appropriate Byte Counting - RFC3465 */
+	u32	rcv_fastpath;	/* Segments taking the header prediction
+				 * fast path in tcp_rcv_established() */
+	u32	rcv_slowpath;	/* Segments falling back to the slow path */
 
 	/* from STCP, retrans queue hinting */
 	struct sk_buff* lost_skb_hint;
@@ -67,6 +67,10 @@ struct tick_sched {
 	unsigned long			next_jiffies;
 	ktime_t				idle_expires;
 	int				do_timer_last;
+	unsigned long			sleeps_limit_wheel;
+	unsigned long			sleeps_limit_hrtimer;
+	unsigned long			sleeps_limit_tk;
+	unsigned long			sleeps_limit_other;
 };
 
 extern void __init tick_init(void);
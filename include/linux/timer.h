@@ -172,6 +172,7 @@ extern int mod_timer_pending(struct timer_list *timer, unsigned long expires);
 extern int mod_timer_pinned(struct timer_list *timer, unsigned long expires);
 
 extern void set_timer_slack(struct timer_list *time, int slack_hz);
+extern void timer_set_deferrable_on_suspend(struct timer_list *timer);
 
 #define TIMER_NOT_PINNED	0
 #define TIMER_PINNED		1
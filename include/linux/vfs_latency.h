@@ -0,0 +1,51 @@
+#ifndef _LINUX_VFS_LATENCY_H
+#define _LINUX_VFS_LATENCY_H
+
+#include <linux/ktime.h>
+
+struct super_block;
+
+/* Operations timed by fs/vfs_latency.c */
+enum {
+	VFS_LAT_READ,
+	VFS_LAT_WRITE,
+	VFS_LAT_FSYNC,
+	VFS_LAT_LOOKUP,
+	VFS_LAT_OPS
+};
+
+#ifdef CONFIG_VFS_LATENCY
+
+extern unsigned int vfs_latency_enabled;
+
+void vfs_latency_record(struct super_block *sb, int op, ktime_t start);
+
+static inline ktime_t vfs_latency_start(void)
+{
+	if (unlikely(vfs_latency_enabled))
+		return ktime_get();
+	return ktime_set(0, 0);
+}
+
+static inline void vfs_latency_end(struct super_block *sb, int op,
+				   ktime_t start)
+{
+	if (unlikely(vfs_latency_enabled) && start.tv64)
+		vfs_latency_record(sb, op, start);
+}
+
+#else /* !CONFIG_VFS_LATENCY */
+
+static inline ktime_t vfs_latency_start(void)
+{
+	return ktime_set(0, 0);
+}
+
+static inline void vfs_latency_end(struct super_block *sb, int op,
+				   ktime_t start)
+{
+}
+
+#endif /* CONFIG_VFS_LATENCY */
+
+#endif /* _LINUX_VFS_LATENCY_H */
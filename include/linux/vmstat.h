@@ -28,6 +28,9 @@
 
 #define FOR_ALL_ZONES(xx) DMA_ZONE(xx) DMA32_ZONE(xx) xx##_NORMAL HIGHMEM_ZONE(xx) , xx##_MOVABLE
 
+/* Number of log2 millisecond buckets in the stall latency histograms */
+#define VM_STALL_BUCKETS 8
+
 enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		FOR_ALL_ZONES(PGALLOC),
 		PGFREE, PGACTIVATE, PGDEACTIVATE,
@@ -43,6 +46,16 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		KSWAPD_LOW_WMARK_HIT_QUICKLY, KSWAPD_HIGH_WMARK_HIT_QUICKLY,
 		KSWAPD_SKIP_CONGESTION_WAIT,
 		PAGEOUTRUN, ALLOCSTALL, PGROTATED,
+		/*
+		 * Stall latency histograms, VM_STALL_BUCKETS consecutive
+		 * items each: bucket i counts stalls below 2^i ms, the
+		 * last bucket everything slower.
+		 */
+		ALLOCSTALL_LAT,
+		ALLOCSTALL_LAT_LAST = ALLOCSTALL_LAT + VM_STALL_BUCKETS - 1,
+		CONGESTION_WAIT_LAT,
+		CONGESTION_WAIT_LAT_LAST =
+			CONGESTION_WAIT_LAT + VM_STALL_BUCKETS - 1,
 #ifdef CONFIG_COMPACTION
 		COMPACTBLOCKS, COMPACTPAGES, COMPACTPAGEFAILED,
 		COMPACTSTALL, COMPACTFAIL, COMPACTSUCCESS,
@@ -133,6 +146,22 @@ static inline void vm_events_fold_cpu(int cpu)
 
 #endif /* CONFIG_VM_EVENT_COUNTERS */
 
+/*
+ * Count a stall of @usecs microseconds into the latency histogram
+ * whose first bucket is @first.
+ */
+static inline void count_vm_stall(enum vm_event_item first, s64 usecs)
+{
+	int bucket = 0;
+	s64 ms = usecs >> 10;	/* close enough to milliseconds */
+
+	while (ms > 0 && bucket < VM_STALL_BUCKETS - 1) {
+		ms >>= 1;
+		bucket++;
+	}
+	count_vm_event(first + bucket);
+}
+
 #define __count_zone_vm_events(item, zone, delta) \
 		__count_vm_events(item##_NORMAL - ZONE_NORMAL + \
 		zone_idx(zone), delta)
@@ -43,10 +43,19 @@ struct wake_lock {
 		int             count;
 		int             expire_count;
 		int             wakeup_count;
+		int             block_count;
 		ktime_t         total_time;
 		ktime_t         prevent_suspend_time;
 		ktime_t         max_time;
 		ktime_t         last_time;
+		/* hold-time histogram, bucket n counts holds shorter than
+		 * 2^n milliseconds (last bucket is open ended) */
+#define WAKE_LOCK_HIST_BUCKETS	12
+		unsigned int    hist[WAKE_LOCK_HIST_BUCKETS];
+		/* stack of the longest hold seen so far */
+#define WAKE_LOCK_TRACE_DEPTH	8
+		unsigned long   max_trace[WAKE_LOCK_TRACE_DEPTH];
+		unsigned int    max_trace_len;
 	} stat;
 #endif
 #endif
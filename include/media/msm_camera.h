@@ -155,6 +155,9 @@
 #define MSM_CAM_IOCTL_GET_CAMERA_INFO \
 	_IOR(MSM_CAM_IOCTL_MAGIC, 36, struct msm_camera_info *)
 
+#define MSM_CAM_IOCTL_GETFRAME_BATCH \
+	_IOWR(MSM_CAM_IOCTL_MAGIC, 37, struct msm_frame_batch *)
+
 #define MSM_CAMERA_LED_OFF  0
 #define MSM_CAMERA_LED_LOW  1
 #define MSM_CAMERA_LED_HIGH 2
@@ -414,6 +417,22 @@ struct msm_frame {
 	int croplen;
 	uint32_t error_code;
 	struct fd_roi_info roi_info;
+
+	/* ts above is stamped when the VFE completion reaches the
+	 * kernel; ts_wake when the consumer dequeued the frame.  The
+	 * difference is the in-kernel queueing delay per buffer. */
+	struct timespec ts_wake;
+};
+
+/*
+ * MSM_CAM_IOCTL_GETFRAME_BATCH argument: drains up to max ready
+ * preview frames in one ioctl, count reports how many were filled.
+ * Crop and face-detect ROI data are not copied on this path.
+ */
+struct msm_frame_batch {
+	struct msm_frame *frames;
+	uint32_t max;
+	uint32_t count;
 };
 
 #define MSM_CAMERA_ERR_MASK (0xFFFFFFFF & 1)
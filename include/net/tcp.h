@@ -599,6 +599,19 @@ static inline u32 tcp_rto_min(struct sock *sk)
 	return rto_min;
 }
 
+/* Compute the delayed ack timeout ceiling, overridable per route so that
+ * high-RTT links can trade ack frequency for CPU and airtime.
+ */
+static inline u32 tcp_delack_max(struct sock *sk)
+{
+	struct dst_entry *dst = __sk_dst_get(sk);
+	u32 delack_max = TCP_DELACK_MAX;
+
+	if (dst && dst_metric_locked(dst, RTAX_DELACK_MAX))
+		delack_max = dst_metric_rtt(dst, RTAX_DELACK_MAX);
+	return delack_max;
+}
+
 /* Compute the actual receive window we are currently advertising.
  * Rcv_nxt can be after the window if our peer push more data
  * than the offered window.
@@ -0,0 +1,40 @@
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM vfs
+
+#if !defined(_TRACE_VFS_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _TRACE_VFS_H
+
+#include <linux/tracepoint.h>
+
+/*
+ * Fired once per timed VFS operation when latency collection is
+ * enabled, see fs/vfs_latency.c.  The op numbering follows the
+ * VFS_LAT_* values in <linux/vfs_latency.h>.
+ */
+TRACE_EVENT(vfs_op_latency,
+
+	TP_PROTO(dev_t dev, int op, u64 latency_us),
+
+	TP_ARGS(dev, op, latency_us),
+
+	TP_STRUCT__entry(
+		__field(	dev_t,	dev		)
+		__field(	int,	op		)
+		__field(	u64,	latency_us	)
+	),
+
+	TP_fast_assign(
+		__entry->dev		= dev;
+		__entry->op		= op;
+		__entry->latency_us	= latency_us;
+	),
+
+	TP_printk("dev %d,%d op %d latency_us %llu",
+		  MAJOR(__entry->dev), MINOR(__entry->dev), __entry->op,
+		  (unsigned long long)__entry->latency_us)
+);
+
+#endif /* _TRACE_VFS_H */
+
+/* This part must be outside protection */
+#include <trace/define_trace.h>
@@ -70,6 +70,9 @@
 #include <linux/sfi.h>
 #include <linux/shmem_fs.h>
 #include <linux/slab.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/sort.h>
 #include <trace/boot.h>
 
 #include <asm/io.h>
@@ -724,7 +727,11 @@ static void __init do_ctors(void)
 int initcall_debug;
 core_param(initcall_debug, initcall_debug, bool, 0644);
 
-static char msgbuf[64];
+/*
+ * The boot trace buffers are too big for the init stacks; they are only
+ * touched when initcall_debug is set, and the boot tracer is not meant
+ * to be combined with initcall_async boots.
+ */
 static struct boot_trace_call call;
 static struct boot_trace_ret ret;
 
@@ -732,6 +739,8 @@ int do_one_initcall(initcall_t fn)
 {
 	int count = preempt_count();
 	ktime_t calltime, delta, rettime;
+	int result;
+	char msgbuf[64];
 
 	if (initcall_debug) {
 		call.caller = task_pid_nr(current);
@@ -741,22 +750,23 @@ int do_one_initcall(initcall_t fn)
 		enable_boot_trace();
 	}
 
-	ret.result = fn();
+	result = fn();
 
 	if (initcall_debug) {
 		disable_boot_trace();
 		rettime = ktime_get();
 		delta = ktime_sub(rettime, calltime);
+		ret.result = result;
 		ret.duration = (unsigned long long) ktime_to_ns(delta) >> 10;
 		trace_boot_ret(&ret, fn);
 		printk("initcall %pF returned %d after %Ld usecs\n", fn,
-			ret.result, ret.duration);
+			result, ret.duration);
 	}
 
 	msgbuf[0] = 0;
 
-	if (ret.result && ret.result != -ENODEV && initcall_debug)
-		sprintf(msgbuf, "error code %d ", ret.result);
+	if (result && result != -ENODEV && initcall_debug)
+		sprintf(msgbuf, "error code %d ", result);
 
 	if (preempt_count() != count) {
 		strlcat(msgbuf, "preemption imbalance ", sizeof(msgbuf));
@@ -770,23 +780,165 @@ int do_one_initcall(initcall_t fn)
 		printk("initcall %pF returned with %s\n", fn, msgbuf);
 	}
 
-	return ret.result;
+	return result;
 }
 
 
 extern initcall_t __initcall_start[], __initcall_end[], __early_initcall_end[];
 
-static void __init do_initcalls(void)
+extern initcall_t __initcall0_start[];
+extern initcall_t __initcall1_start[];
+extern initcall_t __initcall2_start[];
+extern initcall_t __initcall3_start[];
+extern initcall_t __initcall4_start[];
+extern initcall_t __initcall5_start[];
+extern initcall_t __initcallrootfs_start[];
+extern initcall_t __initcall6_start[];
+extern initcall_t __initcall7_start[];
+
+static initcall_t *initcall_levels[] __initdata = {
+	__initcall0_start,
+	__initcall1_start,
+	__initcall2_start,
+	__initcall3_start,
+	__initcall4_start,
+	__initcall5_start,
+	__initcallrootfs_start,
+	__initcall6_start,
+	__initcall7_start,
+	__initcall_end,
+};
+
+/*
+ * When set, the initcalls within each level are dispatched through the
+ * async infrastructure instead of being run back to back, so initcalls
+ * that sleep (regulator ramps, panel power sequences, ...) overlap.
+ * Level boundaries are still full barriers. This assumes the initcalls
+ * within one level are independent; leave it off if a driver relies on
+ * link order against another driver at the same level.
+ */
+static bool initcall_async;
+core_param(initcall_async, initcall_async, bool, 0444);
+
+struct initcall_timing {
+	char name[64];
+	unsigned long long duration;	/* usecs */
+};
+
+static struct initcall_timing *initcall_timings;
+static int initcall_timing_max;
+static atomic_t initcall_timing_idx = ATOMIC_INIT(0);
+
+static void __init do_one_initcall_timed(initcall_t fn)
+{
+	ktime_t calltime = ktime_get();
+	int i;
+
+	do_one_initcall(fn);
+
+	if (!initcall_timings)
+		return;
+	i = atomic_inc_return(&initcall_timing_idx) - 1;
+	if (i >= initcall_timing_max)
+		return;
+	snprintf(initcall_timings[i].name, sizeof(initcall_timings[i].name),
+		 "%pF", fn);
+	initcall_timings[i].duration = (unsigned long long)
+		ktime_to_ns(ktime_sub(ktime_get(), calltime)) >> 10;
+}
+
+static void __init do_initcall_async(void *data, async_cookie_t cookie)
+{
+	do_one_initcall_timed((initcall_t)data);
+}
+
+static void __init do_initcall_level(int level)
 {
 	initcall_t *fn;
 
-	for (fn = __early_initcall_end; fn < __initcall_end; fn++)
-		do_one_initcall(*fn);
+	for (fn = initcall_levels[level]; fn < initcall_levels[level + 1];
+	     fn++) {
+		if (initcall_async)
+			async_schedule(do_initcall_async, *fn);
+		else
+			do_one_initcall_timed(*fn);
+	}
+	if (initcall_async)
+		async_synchronize_full();
+}
+
+static void __init do_initcalls(void)
+{
+	int level;
+
+	initcall_timing_max = __initcall_end - __early_initcall_end;
+	initcall_timings = kcalloc(initcall_timing_max,
+				   sizeof(*initcall_timings), GFP_KERNEL);
+
+	for (level = 0; level < ARRAY_SIZE(initcall_levels) - 1; level++)
+		do_initcall_level(level);
 
 	/* Make sure there is no pending stuff from the initcall sequence */
 	flush_scheduled_work();
 }
 
+#ifdef CONFIG_DEBUG_FS
+static DEFINE_MUTEX(initcall_timings_mtx);
+
+static int initcall_timing_cmp(const void *a, const void *b)
+{
+	const struct initcall_timing *ta = a;
+	const struct initcall_timing *tb = b;
+
+	if (ta->duration < tb->duration)
+		return 1;
+	if (ta->duration > tb->duration)
+		return -1;
+	return 0;
+}
+
+static int initcall_timings_show(struct seq_file *m, void *unused)
+{
+	int count = atomic_read(&initcall_timing_idx);
+	int i;
+
+	if (!initcall_timings)
+		return -ENODEV;
+	if (count > initcall_timing_max)
+		count = initcall_timing_max;
+
+	mutex_lock(&initcall_timings_mtx);
+	sort(initcall_timings, count, sizeof(*initcall_timings),
+	     initcall_timing_cmp, NULL);
+	seq_puts(m, "initcall\tusecs\n");
+	for (i = 0; i < count; i++)
+		seq_printf(m, "%s\t%llu\n", initcall_timings[i].name,
+			   initcall_timings[i].duration);
+	mutex_unlock(&initcall_timings_mtx);
+	return 0;
+}
+
+static int initcall_timings_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, initcall_timings_show, NULL);
+}
+
+static const struct file_operations initcall_timings_fops = {
+	.open = initcall_timings_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int __init initcall_timings_init(void)
+{
+	debugfs_create_file("initcall_timings", S_IRUGO, NULL, NULL,
+			    &initcall_timings_fops);
+	return 0;
+}
+late_initcall(initcall_timings_init);
+#endif /* CONFIG_DEBUG_FS */
+
 /*
  * Ok, the machine is now initialized. None of the devices
  * have been touched yet, but the CPU subsystem is up and
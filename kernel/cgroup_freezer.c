@@ -32,6 +32,9 @@ struct freezer {
 	struct cgroup_subsys_state css;
 	enum freezer_state state;
 	spinlock_t lock; /* protects _writes_ to state */
+	/* proceed without tasks stuck in uninterruptible sleep: they
+	 * stay marked freezing and enter the refrigerator on wakeup */
+	bool partial;
 };
 
 static inline struct freezer *cgroup_freezer(
@@ -254,7 +257,8 @@ static void update_freezer_state(struct cgroup *cgroup,
 	cgroup_iter_start(cgroup, &it);
 	while ((task = cgroup_iter_next(cgroup, &it))) {
 		ntotal++;
-		if (is_task_frozen_enough(task))
+		if (is_task_frozen_enough(task) ||
+		    (freezer->partial && freezing(task)))
 			nfrozen++;
 	}
 
@@ -316,7 +320,7 @@ static int try_to_freeze_cgroup(struct cgroup *cgroup, struct freezer *freezer)
 	}
 	cgroup_iter_end(cgroup, &it);
 
-	return num_cant_freeze_now ? -EBUSY : 0;
+	return (num_cant_freeze_now && !freezer->partial) ? -EBUSY : 0;
 }
 
 static void unfreeze_cgroup(struct cgroup *cgroup, struct freezer *freezer)
@@ -384,12 +388,80 @@ static int freezer_write(struct cgroup *cgroup,
 	return retval;
 }
 
+/*
+ * One line per task that has not reached the refrigerator yet:
+ * pid, comm, scheduler state and the kernel function it sleeps in.
+ * Empty once the cgroup is fully FROZEN.
+ */
+static int freezer_read_stragglers(struct cgroup *cgroup, struct cftype *cft,
+				   struct seq_file *m)
+{
+	struct freezer *freezer;
+	struct cgroup_iter it;
+	struct task_struct *task;
+
+	if (!cgroup_lock_live_group(cgroup))
+		return -ENODEV;
+
+	freezer = cgroup_freezer(cgroup);
+	spin_lock_irq(&freezer->lock);
+	cgroup_iter_start(cgroup, &it);
+	while ((task = cgroup_iter_next(cgroup, &it))) {
+		unsigned int state;
+
+		if (is_task_frozen_enough(task))
+			continue;
+		state = task->state ? __ffs(task->state) + 1 : 0;
+		seq_printf(m, "%d %s %c %ps\n",
+			   task_pid_vnr(task), task->comm,
+			   state < sizeof(TASK_STATE_TO_CHAR_STR) - 1 ?
+				TASK_STATE_TO_CHAR_STR[state] : '?',
+			   (void *)get_wchan(task));
+	}
+	cgroup_iter_end(cgroup, &it);
+	spin_unlock_irq(&freezer->lock);
+	cgroup_unlock();
+	return 0;
+}
+
+static u64 freezer_read_partial(struct cgroup *cgroup, struct cftype *cft)
+{
+	return cgroup_freezer(cgroup)->partial;
+}
+
+static int freezer_write_partial(struct cgroup *cgroup, struct cftype *cft,
+				 u64 val)
+{
+	struct freezer *freezer;
+
+	if (val > 1)
+		return -EINVAL;
+
+	if (!cgroup_lock_live_group(cgroup))
+		return -ENODEV;
+	freezer = cgroup_freezer(cgroup);
+	spin_lock_irq(&freezer->lock);
+	freezer->partial = val;
+	spin_unlock_irq(&freezer->lock);
+	cgroup_unlock();
+	return 0;
+}
+
 static struct cftype files[] = {
 	{
 		.name = "state",
 		.read_seq_string = freezer_read,
 		.write_string = freezer_write,
 	},
+	{
+		.name = "partial",
+		.read_u64 = freezer_read_partial,
+		.write_u64 = freezer_write_partial,
+	},
+	{
+		.name = "stragglers",
+		.read_seq_string = freezer_read_stragglers,
+	},
 };
 
 static int freezer_populate(struct cgroup_subsys *ss, struct cgroup *cgroup)
@@ -0,0 +1,106 @@
+/*
+ * cgroup_timer_slack.c - cgroup control of per-task timer slack
+ *
+ * Lets userspace coarsen the timers of whole groups of tasks: moving a
+ * task into a group applies the group's timer_slack_ns as the task's
+ * timer slack, which the existing hrtimer range support then uses to
+ * coalesce expiries.  The Android framework points background apps at a
+ * group with tens of ms of slack so their periodic timers batch into a
+ * single CPU wakeup, while the foreground group keeps the default
+ * precision.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/cgroup.h>
+#include <linux/sched.h>
+
+struct timer_slack_cgroup {
+	struct cgroup_subsys_state css;
+	unsigned long slack_ns;
+};
+
+static struct timer_slack_cgroup *cgroup_slack(struct cgroup *cgroup)
+{
+	return container_of(cgroup_subsys_state(cgroup, timer_slack_subsys_id),
+			    struct timer_slack_cgroup, css);
+}
+
+static struct cgroup_subsys_state *slack_create(struct cgroup_subsys *ss,
+						struct cgroup *cgroup)
+{
+	struct timer_slack_cgroup *slack;
+
+	slack = kzalloc(sizeof(*slack), GFP_KERNEL);
+	if (!slack)
+		return ERR_PTR(-ENOMEM);
+
+	/* New groups start out at the unadjusted task default */
+	slack->slack_ns = init_task.timer_slack_ns;
+
+	return &slack->css;
+}
+
+static void slack_destroy(struct cgroup_subsys *ss, struct cgroup *cgroup)
+{
+	kfree(cgroup_slack(cgroup));
+}
+
+static void slack_attach(struct cgroup_subsys *ss, struct cgroup *cgroup,
+			 struct cgroup *old_cgroup, struct task_struct *tsk,
+			 bool threadgroup)
+{
+	tsk->timer_slack_ns = cgroup_slack(cgroup)->slack_ns;
+}
+
+static u64 slack_read_u64(struct cgroup *cgroup, struct cftype *cft)
+{
+	return cgroup_slack(cgroup)->slack_ns;
+}
+
+static int slack_write_u64(struct cgroup *cgroup, struct cftype *cft,
+			   u64 slack_ns)
+{
+	struct timer_slack_cgroup *slack = cgroup_slack(cgroup);
+	struct cgroup_iter it;
+	struct task_struct *tsk;
+
+	if (slack_ns > ULONG_MAX)
+		return -EINVAL;
+
+	slack->slack_ns = slack_ns;
+
+	/* Apply the new value to current members, not just future ones */
+	cgroup_iter_start(cgroup, &it);
+	while ((tsk = cgroup_iter_next(cgroup, &it)))
+		tsk->timer_slack_ns = slack_ns;
+	cgroup_iter_end(cgroup, &it);
+
+	return 0;
+}
+
+static struct cftype files[] = {
+	{
+		.name = "timer_slack_ns",
+		.read_u64 = slack_read_u64,
+		.write_u64 = slack_write_u64,
+	},
+};
+
+static int slack_populate(struct cgroup_subsys *ss, struct cgroup *cgroup)
+{
+	return cgroup_add_files(cgroup, ss, files, ARRAY_SIZE(files));
+}
+
+struct cgroup_subsys timer_slack_subsys = {
+	.name		= "timer_slack",
+	.create		= slack_create,
+	.destroy	= slack_destroy,
+	.attach		= slack_attach,
+	.populate	= slack_populate,
+	.subsys_id	= timer_slack_subsys_id,
+};
@@ -134,6 +134,63 @@ struct futex_hash_bucket {
 
 static struct futex_hash_bucket futex_queues[1<<FUTEX_HASHBITS];
 
+/*
+ * PROCESS_PRIVATE futexes - the common case thanks to glibc and Dalvik
+ * monitors - get a hash table of their own, lazily allocated on the
+ * mm's first private futex operation and sized by the thread count at
+ * that point.  This keeps lock-heavy processes from false sharing and
+ * chaining on the global buckets with unrelated processes.
+ */
+struct futex_private_hash {
+	unsigned int mask;
+	struct futex_hash_bucket buckets[];
+};
+
+/*
+ * Once an operation has hashed into the global table because allocation
+ * failed, later operations must do the same or wakeups would get lost,
+ * so the failure is made sticky:
+ */
+#define FUTEX_HASH_GLOBAL	((struct futex_private_hash *)1)
+
+#define FUTEX_PRIVATE_HASH_MIN	16
+#define FUTEX_PRIVATE_HASH_MAX	512
+
+static void futex_alloc_private_hash(struct mm_struct *mm)
+{
+	struct futex_private_hash *hash;
+	unsigned int size;
+	int i;
+
+	size = roundup_pow_of_two(get_nr_threads(current) * 4);
+	size = clamp_t(unsigned int, size, FUTEX_PRIVATE_HASH_MIN,
+		       FUTEX_PRIVATE_HASH_MAX);
+
+	hash = kmalloc(sizeof(*hash) + size * sizeof(hash->buckets[0]),
+		       GFP_KERNEL);
+	if (!hash) {
+		cmpxchg(&mm->futex_hash, NULL, FUTEX_HASH_GLOBAL);
+		return;
+	}
+
+	hash->mask = size - 1;
+	for (i = 0; i < size; i++) {
+		plist_head_init(&hash->buckets[i].chain,
+				&hash->buckets[i].lock);
+		spin_lock_init(&hash->buckets[i].lock);
+	}
+
+	if (cmpxchg(&mm->futex_hash, NULL, hash) != NULL)
+		kfree(hash);
+}
+
+/* Called from __mmdrop(); any private waiters are long gone by then */
+void futex_hash_free(struct mm_struct *mm)
+{
+	if (mm->futex_hash != FUTEX_HASH_GLOBAL)
+		kfree(mm->futex_hash);
+}
+
 /*
  * We hash on the keys returned from get_futex_key (see below).
  */
@@ -142,6 +199,28 @@ static struct futex_hash_bucket *hash_futex(union futex_key *key)
 	u32 hash = jhash2((u32*)&key->both.word,
 			  (sizeof(key->both.word)+sizeof(key->both.ptr))/4,
 			  key->both.offset);
+
+	/*
+	 * Keys without a reference flag are PROCESS_PRIVATE and carry
+	 * the owning mm; only that process can operate on them, so all
+	 * their hashing goes through the mm's own table.  Every caller
+	 * may sleep here, which is what lets us allocate lazily: the
+	 * attempt happens before any queueing, so a waiter can never be
+	 * stranded in the global table while its waker hashes private.
+	 */
+	if (!(key->both.offset & (FUT_OFF_INODE | FUT_OFF_MMSHARED)) &&
+	    key->private.mm) {
+		struct mm_struct *mm = key->private.mm;
+		struct futex_private_hash *ph;
+
+		if (unlikely(!mm->futex_hash))
+			futex_alloc_private_hash(mm);
+		ph = mm->futex_hash;
+		smp_read_barrier_depends();
+		if (likely(ph != FUTEX_HASH_GLOBAL))
+			return &ph->buckets[hash & ph->mask];
+	}
+
 	return &futex_queues[hash & ((1 << FUTEX_HASHBITS)-1)];
 }
 
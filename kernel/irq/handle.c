@@ -369,6 +369,7 @@ irqreturn_t handle_IRQ_event(unsigned int irq, struct irqaction *action)
 {
 	irqreturn_t ret, retval = IRQ_NONE;
 	unsigned int status = 0;
+	u32 start = irq_time_stats_stamp();
 
 	do {
 		trace_irq_handler_entry(irq, action);
@@ -403,6 +404,7 @@ irqreturn_t handle_IRQ_event(unsigned int irq, struct irqaction *action)
 			if (likely(!test_bit(IRQTF_DIED,
 					     &action->thread_flags))) {
 				set_bit(IRQTF_RUNTHREAD, &action->thread_flags);
+				irq_time_stats_thread_wake(irq);
 				wake_up_process(action->thread);
 			}
 
@@ -423,6 +425,8 @@ irqreturn_t handle_IRQ_event(unsigned int irq, struct irqaction *action)
 		add_interrupt_randomness(irq);
 	local_irq_disable();
 
+	irq_time_stats_account(irq, start);
+
 	return retval;
 }
 
@@ -15,6 +15,49 @@ extern int __irq_set_trigger(struct irq_desc *desc, unsigned int irq,
 extern void __disable_irq(struct irq_desc *desc, unsigned int irq, bool susp);
 extern void __enable_irq(struct irq_desc *desc, unsigned int irq, bool resume);
 
+/*
+ * Per-irq handler duration statistics (kernel/irq/time_stats.c). The
+ * inline wrappers reduce to a test of one __read_mostly word when the
+ * stats are switched off, so the hot path cost of the config option is
+ * a predicted-not-taken branch per interrupt. This tree predates jump
+ * labels, which is what we would use for the off switch otherwise.
+ */
+#ifdef CONFIG_IRQ_TIME_STATS
+extern u32 irq_time_stats_enable;
+extern u32 __irq_time_stats_stamp(void);
+extern void __irq_time_stats_account(unsigned int irq, u32 start);
+extern void __irq_time_stats_thread_wake(unsigned int irq);
+extern void __irq_time_stats_thread_run(struct irq_desc *desc);
+
+static inline u32 irq_time_stats_stamp(void)
+{
+	return irq_time_stats_enable ? __irq_time_stats_stamp() : 0;
+}
+
+static inline void irq_time_stats_account(unsigned int irq, u32 start)
+{
+	if (irq_time_stats_enable)
+		__irq_time_stats_account(irq, start);
+}
+
+static inline void irq_time_stats_thread_wake(unsigned int irq)
+{
+	if (irq_time_stats_enable)
+		__irq_time_stats_thread_wake(irq);
+}
+
+static inline void irq_time_stats_thread_run(struct irq_desc *desc)
+{
+	if (irq_time_stats_enable)
+		__irq_time_stats_thread_run(desc);
+}
+#else
+static inline u32 irq_time_stats_stamp(void) { return 0; }
+static inline void irq_time_stats_account(unsigned int irq, u32 start) { }
+static inline void irq_time_stats_thread_wake(unsigned int irq) { }
+static inline void irq_time_stats_thread_run(struct irq_desc *desc) { }
+#endif
+
 extern struct lock_class_key irq_desc_lock_class;
 extern void init_kstat_irqs(struct irq_desc *desc, int node, int nr);
 extern void clear_kstat_irqs(struct irq_desc *desc);
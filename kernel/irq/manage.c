@@ -582,6 +582,8 @@ static int irq_thread(void *data)
 
 	while (!irq_wait_for_interrupt(action)) {
 
+		irq_time_stats_thread_run(desc);
+
 		irq_thread_check_affinity(desc, action);
 
 		atomic_inc(&desc->threads_active);
@@ -0,0 +1,130 @@
+/*
+ * linux/kernel/irq/time_stats.c
+ *
+ * Per-irq handler duration and threaded-handler wakeup latency
+ * statistics.
+ *
+ * /proc/interrupts only counts interrupts, which is no help when
+ * something runs long in hardirq context on a production build. When
+ * enabled, every action chain run is timed with sched_clock() and
+ * folded into a per-irq maximum and log2 histogram, and threaded
+ * handlers additionally track their worst wakeup-to-run latency.
+ * Everything is in units of 1.024us (sched_clock() >> 10).
+ *
+ * Switched on and off at run time through
+ * /sys/kernel/debug/irq_time_stats/enable; see internals.h for the
+ * off-switch fast path.
+ */
+
+#include <linux/irq.h>
+#include <linux/sched.h>
+#include <linux/interrupt.h>
+#include <linux/kernel_stat.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+
+#include "internals.h"
+
+u32 irq_time_stats_enable __read_mostly;
+
+u32 __irq_time_stats_stamp(void)
+{
+	return (u32)(sched_clock() >> 10);
+}
+
+void __irq_time_stats_account(unsigned int irq, u32 start)
+{
+	struct irq_desc *desc = irq_to_desc(irq);
+	struct irq_time_stats *s;
+	u32 duration;
+	int bucket;
+
+	/* start is 0 when the stats were switched on mid-interrupt */
+	if (!desc || !start)
+		return;
+
+	s = &desc->time_stats;
+	duration = (u32)(sched_clock() >> 10) - start;
+	if (duration > s->max)
+		s->max = duration;
+	bucket = fls(duration);
+	if (bucket >= IRQ_TIME_HIST_BUCKETS)
+		bucket = IRQ_TIME_HIST_BUCKETS - 1;
+	s->hist[bucket]++;
+}
+
+void __irq_time_stats_thread_wake(unsigned int irq)
+{
+	struct irq_desc *desc = irq_to_desc(irq);
+
+	if (desc)
+		desc->time_stats.thread_wake_stamp =
+			(u32)(sched_clock() >> 10);
+}
+
+void __irq_time_stats_thread_run(struct irq_desc *desc)
+{
+	struct irq_time_stats *s = &desc->time_stats;
+	u32 latency;
+
+	if (!s->thread_wake_stamp)
+		return;
+
+	latency = (u32)(sched_clock() >> 10) - s->thread_wake_stamp;
+	s->thread_wake_stamp = 0;
+	if (latency > s->thread_wake_max)
+		s->thread_wake_max = latency;
+}
+
+static int irq_time_stats_show(struct seq_file *m, void *unused)
+{
+	struct irq_desc *desc;
+	int irq, i;
+
+	seq_puts(m, "irq\tname\tmax\tthread_max\thist\n");
+	for_each_irq_desc(irq, desc) {
+		struct irq_time_stats *s = &desc->time_stats;
+		u32 samples = 0;
+
+		for (i = 0; i < IRQ_TIME_HIST_BUCKETS; i++)
+			samples += s->hist[i];
+		if (!samples)
+			continue;
+
+		seq_printf(m, "%d\t%s\t%u\t%u\t", irq,
+			   desc->action ? desc->action->name : "-",
+			   s->max, s->thread_wake_max);
+		for (i = 0; i < IRQ_TIME_HIST_BUCKETS; i++)
+			seq_printf(m, " %u", s->hist[i]);
+		seq_putc(m, '\n');
+	}
+	return 0;
+}
+
+static int irq_time_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, irq_time_stats_show, NULL);
+}
+
+static const struct file_operations irq_time_stats_fops = {
+	.open		= irq_time_stats_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+static int __init irq_time_stats_init(void)
+{
+	struct dentry *dir;
+
+	dir = debugfs_create_dir("irq_time_stats", NULL);
+	if (IS_ERR_OR_NULL(dir))
+		return 0;
+
+	debugfs_create_bool("enable", S_IRUGO | S_IWUSR, dir,
+			    &irq_time_stats_enable);
+	debugfs_create_file("stats", S_IRUGO, dir, NULL,
+			    &irq_time_stats_fops);
+	return 0;
+}
+late_initcall(irq_time_stats_init);
@@ -50,6 +50,34 @@ enum {
 };
 static int state;
 
+/* Handlers that share a level have no ordering requirement between each
+ * other, only against other levels.  Fan each level out across a small
+ * pool of workers so slow handlers (fb blank, gpu idle, touch disable)
+ * overlap instead of adding up; the level boundary stays a barrier.
+ * The whole run holds early_suspend_lock, so the dispatch state below
+ * needs no extra locking.
+ */
+#define EARLY_SUSPEND_NR_WORKERS 3
+static struct workqueue_struct *early_suspend_pool[EARLY_SUSPEND_NR_WORKERS];
+static atomic_t handlers_pending;
+static DECLARE_WAIT_QUEUE_HEAD(handlers_done_wait);
+static bool handlers_resuming;
+
+static void early_suspend_run_handler(struct work_struct *work)
+{
+	struct early_suspend *h = container_of(work, struct early_suspend, work);
+
+	if (handlers_resuming) {
+		if (h->resume != NULL)
+			h->resume(h);
+	} else {
+		if (h->suspend != NULL)
+			h->suspend(h);
+	}
+	if (atomic_dec_and_test(&handlers_pending))
+		wake_up(&handlers_done_wait);
+}
+
 void register_early_suspend(struct early_suspend *handler)
 {
 	struct list_head *pos;
@@ -99,18 +127,59 @@ static void early_suspend(struct work_struct *work)
 
 	if (debug_mask & DEBUG_SUSPEND)
 		pr_info("early_suspend: call handlers\n");
-	list_for_each_entry(pos, &early_suspend_handlers, link) {
+	pos = list_entry(early_suspend_handlers.next,
+			 struct early_suspend, link);
+	while (&pos->link != &early_suspend_handlers) {
+		struct early_suspend *end = pos;
+		struct early_suspend *e;
+		int nr = 0;
+		int n = 0;
+
+		while (&end->link != &early_suspend_handlers &&
+		       end->level == pos->level) {
+			end = list_entry(end->link.next,
+					 struct early_suspend, link);
+			nr++;
+		}
+		if (nr == 1 || !early_suspend_pool[0]) {
+			for (e = pos; e != end;
+			     e = list_entry(e->link.next,
+					    struct early_suspend, link)) {
+#ifdef CONFIG_MACH_LGE
+				/* this is test code for detecting main cause of kthread's sleep
+				 * 2010-04-26, cleaneye.kim@lge.com
+				 */
+				char sym[KSYM_SYMBOL_LEN];
+
+				sprint_symbol(sym, (unsigned long)e->suspend);
+				printk(KERN_INFO"%s: %s\n", __func__, sym);
+#endif
+				if (e->suspend != NULL)
+					e->suspend(e);
+			}
+		} else {
+			handlers_resuming = false;
+			atomic_set(&handlers_pending, nr);
+			for (e = pos; e != end;
+			     e = list_entry(e->link.next,
+					    struct early_suspend, link)) {
 #ifdef CONFIG_MACH_LGE
-		/* this is test code for detecting main cause of kthread's sleep
-		 * 2010-04-26, cleaneye.kim@lge.com
-		 */
-		char sym[KSYM_SYMBOL_LEN];
-		
-		sprint_symbol(sym, (unsigned long)pos->suspend);
-		printk(KERN_INFO"%s: %s\n", __func__, sym);
+				/* this is test code for detecting main cause of kthread's sleep
+				 * 2010-04-26, cleaneye.kim@lge.com
+				 */
+				char sym[KSYM_SYMBOL_LEN];
+
+				sprint_symbol(sym, (unsigned long)e->suspend);
+				printk(KERN_INFO"%s: %s\n", __func__, sym);
 #endif
-		if (pos->suspend != NULL)
-			pos->suspend(pos);
+				INIT_WORK(&e->work, early_suspend_run_handler);
+				queue_work(early_suspend_pool[n++ %
+					   EARLY_SUSPEND_NR_WORKERS], &e->work);
+			}
+			wait_event(handlers_done_wait,
+				   atomic_read(&handlers_pending) == 0);
+		}
+		pos = end;
 	}
 	mutex_unlock(&early_suspend_lock);
 
@@ -146,18 +215,59 @@ static void late_resume(struct work_struct *work)
 	}
 	if (debug_mask & DEBUG_SUSPEND)
 		pr_info("late_resume: call handlers\n");
-	list_for_each_entry_reverse(pos, &early_suspend_handlers, link) {
+	pos = list_entry(early_suspend_handlers.prev,
+			 struct early_suspend, link);
+	while (&pos->link != &early_suspend_handlers) {
+		struct early_suspend *end = pos;
+		struct early_suspend *e;
+		int nr = 0;
+		int n = 0;
+
+		while (&end->link != &early_suspend_handlers &&
+		       end->level == pos->level) {
+			end = list_entry(end->link.prev,
+					 struct early_suspend, link);
+			nr++;
+		}
+		if (nr == 1 || !early_suspend_pool[0]) {
+			for (e = pos; e != end;
+			     e = list_entry(e->link.prev,
+					    struct early_suspend, link)) {
+#ifdef CONFIG_MACH_LGE
+				/* FIXME: this is test code for detecting main cause of kthread's sleep
+				 * 2010-04-26, cleaneye.kim@lge.com
+				 */
+				char sym[KSYM_SYMBOL_LEN];
+
+				sprint_symbol(sym, (unsigned long)e->resume);
+				printk(KERN_INFO"%s: %s\n", __func__, sym);
+#endif
+				if (e->resume != NULL)
+					e->resume(e);
+			}
+		} else {
+			handlers_resuming = true;
+			atomic_set(&handlers_pending, nr);
+			for (e = pos; e != end;
+			     e = list_entry(e->link.prev,
+					    struct early_suspend, link)) {
 #ifdef CONFIG_MACH_LGE
-		/* FIXME: this is test code for detecting main cause of kthread's sleep
-		 * 2010-04-26, cleaneye.kim@lge.com
-		 */
-		char sym[KSYM_SYMBOL_LEN];
-		
-		sprint_symbol(sym, (unsigned long)pos->resume);
-		printk(KERN_INFO"%s: %s\n", __func__, sym);
+				/* FIXME: this is test code for detecting main cause of kthread's sleep
+				 * 2010-04-26, cleaneye.kim@lge.com
+				 */
+				char sym[KSYM_SYMBOL_LEN];
+
+				sprint_symbol(sym, (unsigned long)e->resume);
+				printk(KERN_INFO"%s: %s\n", __func__, sym);
 #endif
-		if (pos->resume != NULL)
-			pos->resume(pos);
+				INIT_WORK(&e->work, early_suspend_run_handler);
+				queue_work(early_suspend_pool[n++ %
+					   EARLY_SUSPEND_NR_WORKERS], &e->work);
+			}
+			wait_event(handlers_done_wait,
+				   atomic_read(&handlers_pending) == 0);
+		}
+		pos = end;
 	}
 	if (debug_mask & DEBUG_SUSPEND)
 		pr_info("late_resume: done\n");
@@ -214,3 +324,28 @@ suspend_state_t get_suspend_state(void)
 {
 	return requested_suspend_state;
 }
+
+static int __init early_suspend_init(void)
+{
+	/* the workqueue keeps a pointer to its name, so no stack buffers */
+	static const char *const pool_names[EARLY_SUSPEND_NR_WORKERS] = {
+		"esuspend/0", "esuspend/1", "esuspend/2",
+	};
+	int i;
+
+	for (i = 0; i < EARLY_SUSPEND_NR_WORKERS; i++) {
+		early_suspend_pool[i] =
+			create_singlethread_workqueue(pool_names[i]);
+		if (early_suspend_pool[i] == NULL) {
+			pr_err("early_suspend: out of memory for worker "
+			       "pool, handlers will run serially\n");
+			while (--i >= 0) {
+				destroy_workqueue(early_suspend_pool[i]);
+				early_suspend_pool[i] = NULL;
+			}
+			break;
+		}
+	}
+	return 0;
+}
+core_initcall(early_suspend_init);
@@ -88,6 +88,7 @@ static int suspend_test(int level)
 static int suspend_prepare(void)
 {
 	int error;
+	ktime_t starttime;
 
 	if (!suspend_ops || !suspend_ops->enter)
 		return -EPERM;
@@ -102,7 +103,9 @@ static int suspend_prepare(void)
 	if (error)
 		goto Finish;
 
+	starttime = ktime_get();
 	error = suspend_freeze_processes();
+	suspend_phase_record(SUSPEND_PHASE_FREEZE, starttime);
 	if (!error)
 		return 0;
 
@@ -200,6 +203,7 @@ static int suspend_enter(suspend_state_t state)
  */
 int suspend_devices_and_enter(suspend_state_t state)
 {
+	ktime_t starttime;
 	int error;
 
 	if (!suspend_ops)
@@ -212,7 +216,9 @@ int suspend_devices_and_enter(suspend_state_t state)
 	}
 	suspend_console();
 	suspend_test_start();
+	starttime = ktime_get();
 	error = dpm_suspend_start(PMSG_SUSPEND);
+	suspend_phase_record(SUSPEND_PHASE_DEV_SUSPEND, starttime);
 	if (error) {
 		printk(KERN_ERR "PM: Some devices failed to suspend\n");
 		goto Recover_platform;
@@ -221,11 +227,15 @@ int suspend_devices_and_enter(suspend_state_t state)
 	if (suspend_test(TEST_DEVICES))
 		goto Recover_platform;
 
+	starttime = ktime_get();
 	suspend_enter(state);
+	suspend_phase_record(SUSPEND_PHASE_ENTER, starttime);
 
  Resume_devices:
 	suspend_test_start();
+	starttime = ktime_get();
 	dpm_resume_end(PMSG_RESUME);
+	suspend_phase_record(SUSPEND_PHASE_DEV_RESUME, starttime);
 	suspend_test_finish("resume devices");
 	resume_console();
  Close:
@@ -247,7 +257,10 @@ int suspend_devices_and_enter(suspend_state_t state)
  */
 static void suspend_finish(void)
 {
+	ktime_t starttime = ktime_get();
+
 	suspend_thaw_processes();
+	suspend_phase_record(SUSPEND_PHASE_THAW, starttime);
 	usermodehelper_enable();
 	pm_notifier_call_chain(PM_POST_SUSPEND);
 	pm_restore_console();
@@ -29,6 +29,15 @@
 
 #define SWSUSP_SIG	"S1SUSPEND"
 
+/*
+ * With "resume_keep" on the command line the image signature is left
+ * intact on the resume device, so every subsequent boot resumes the
+ * same image again (read-only boot image, e.g. for demo devices).
+ * Only safe when the writable filesystems are not modified after the
+ * snapshot was taken.
+ */
+static int keep_image;
+
 /*
  *	The swap map is a data structure used for keeping track of each page
  *	written to a swap partition.  It consists of many swap_map_page
@@ -643,8 +652,9 @@ int swsusp_check(void)
 		if (!memcmp(SWSUSP_SIG, swsusp_header->sig, 10)) {
 			memcpy(swsusp_header->sig, swsusp_header->orig_sig, 10);
 			/* Reset swap signature now */
-			error = hib_bio_write_page(swsusp_resume_block,
-						swsusp_header, NULL);
+			if (!keep_image)
+				error = hib_bio_write_page(swsusp_resume_block,
+							swsusp_header, NULL);
 		} else {
 			error = -EINVAL;
 		}
@@ -687,3 +697,11 @@ static int swsusp_header_init(void)
 }
 
 core_initcall(swsusp_header_init);
+
+static int __init resume_keep_setup(char *str)
+{
+	keep_image = 1;
+	return 1;
+}
+
+__setup("resume_keep", resume_keep_setup);
@@ -21,6 +21,7 @@
 #include <linux/wakelock.h>
 #ifdef CONFIG_WAKELOCK_STAT
 #include <linux/proc_fs.h>
+#include <linux/stacktrace.h>
 #endif
 #include "power.h"
 
@@ -34,6 +35,14 @@ enum {
 static int debug_mask = DEBUG_EXIT_SUSPEND | DEBUG_WAKEUP;
 module_param_named(debug_mask, debug_mask, int, S_IRUGO | S_IWUSR | S_IWGRP);
 
+/* Wait this long after the last suspend wake lock is released before
+ * retrying suspend, so that bursts of closely spaced wakeup events get
+ * consolidated into a single awake period instead of causing a full
+ * suspend/resume cycle each. 0 restores the old immediate retry. */
+static unsigned int suspend_delay_ms = 100;
+module_param_named(suspend_delay_ms, suspend_delay_ms, uint,
+		   S_IRUGO | S_IWUSR | S_IWGRP);
+
 #define WAKE_LOCK_TYPE_MASK              (0x0f)
 #define WAKE_LOCK_INITIALIZED            (1U << 8)
 #define WAKE_LOCK_ACTIVE                 (1U << 9)
@@ -53,6 +62,9 @@ static struct wake_lock unknown_wakeup;
 static struct wake_lock deleted_wake_locks;
 static ktime_t last_sleep_time_update;
 static int wait_for_wakeup;
+/* rate limit for longest-holder stack captures; list_lock is held with
+ * irqs off at the capture site, so keep captures rare */
+static unsigned long next_max_trace_capture;
 
 int get_expired_time(struct wake_lock *lock, ktime_t *expire_time)
 {
@@ -81,8 +93,60 @@ int get_expired_time(struct wake_lock *lock, ktime_t *expire_time)
 }
 
 
+/* bucket n counts holds shorter than 2^n msec, the last bucket is
+ * open ended */
+static int wake_lock_hist_bucket(ktime_t duration)
+{
+	s64 msec = ktime_to_ms(duration);
+
+	if (msec <= 0)
+		return 0;
+	if (msec >= (1 << (WAKE_LOCK_HIST_BUCKETS - 1)))
+		return WAKE_LOCK_HIST_BUCKETS - 1;
+	return fls((int)msec);
+}
+
+static void wake_lock_capture_max_trace(struct wake_lock *lock)
+{
+#ifdef CONFIG_STACKTRACE
+	struct stack_trace trace;
+
+	if (time_before(jiffies, next_max_trace_capture))
+		return;
+	next_max_trace_capture = jiffies + HZ;
+
+	trace.nr_entries = 0;
+	trace.max_entries = WAKE_LOCK_TRACE_DEPTH;
+	trace.entries = lock->stat.max_trace;
+	trace.skip = 2;
+	save_stack_trace(&trace);
+	lock->stat.max_trace_len = trace.nr_entries;
+#endif
+}
+
+static void print_lock_hist(struct seq_file *m, struct wake_lock *lock)
+{
+	int i;
+
+	seq_puts(m, "  hist:");
+	for (i = 0; i < WAKE_LOCK_HIST_BUCKETS; i++)
+		seq_printf(m, " %u", lock->stat.hist[i]);
+	seq_putc(m, '\n');
+	if (lock->stat.max_trace_len) {
+		seq_puts(m, "  max_trace:");
+		for (i = 0; i < lock->stat.max_trace_len; i++) {
+			if (lock->stat.max_trace[i] == ULONG_MAX)
+				break;
+			seq_printf(m, " %pS",
+				   (void *)lock->stat.max_trace[i]);
+		}
+		seq_putc(m, '\n');
+	}
+}
+
 static int print_lock_stat(struct seq_file *m, struct wake_lock *lock)
 {
+	int ret;
 	int lock_count = lock->stat.count;
 	int expire_count = lock->stat.expire_count;
 	ktime_t active_time = ktime_set(0, 0);
@@ -109,13 +173,17 @@ static int print_lock_stat(struct seq_file *m, struct wake_lock *lock)
 			max_time = add_time;
 	}
 
-	return seq_printf(m,
-		     "\"%s\"\t%d\t%d\t%d\t%lld\t%lld\t%lld\t%lld\t%lld\n",
+	ret = seq_printf(m,
+		     "\"%s\"\t%d\t%d\t%d\t%lld\t%lld\t%lld\t%lld\t%lld\t%d\n",
 		     lock->name, lock_count, expire_count,
 		     lock->stat.wakeup_count, ktime_to_ns(active_time),
 		     ktime_to_ns(total_time),
 		     ktime_to_ns(prevent_suspend_time), ktime_to_ns(max_time),
-		     ktime_to_ns(lock->stat.last_time));
+		     ktime_to_ns(lock->stat.last_time),
+		     lock->stat.block_count);
+	if (lock_count)
+		print_lock_hist(m, lock);
+	return ret;
 }
 
 static int wakelock_stats_show(struct seq_file *m, void *unused)
@@ -128,7 +196,8 @@ static int wakelock_stats_show(struct seq_file *m, void *unused)
 	spin_lock_irqsave(&list_lock, irqflags);
 
 	ret = seq_puts(m, "name\tcount\texpire_count\twake_count\tactive_since"
-			"\ttotal_time\tsleep_time\tmax_time\tlast_change\n");
+			"\ttotal_time\tsleep_time\tmax_time\tlast_change"
+			"\tblock_count\n");
 	list_for_each_entry(lock, &inactive_locks, link)
 		ret = print_lock_stat(m, lock);
 	for (type = 0; type < WAKE_LOCK_TYPE_COUNT; type++) {
@@ -154,8 +223,11 @@ static void wake_unlock_stat_locked(struct wake_lock *lock, int expired)
 		lock->stat.expire_count++;
 	duration = ktime_sub(now, lock->stat.last_time);
 	lock->stat.total_time = ktime_add(lock->stat.total_time, duration);
-	if (ktime_to_ns(duration) > ktime_to_ns(lock->stat.max_time))
+	lock->stat.hist[wake_lock_hist_bucket(duration)]++;
+	if (ktime_to_ns(duration) > ktime_to_ns(lock->stat.max_time)) {
 		lock->stat.max_time = duration;
+		wake_lock_capture_max_trace(lock);
+	}
 	lock->stat.last_time = ktime_get();
 	if (lock->flags & WAKE_LOCK_PREVENTING_SUSPEND) {
 		duration = ktime_sub(now, last_sleep_time_update);
@@ -190,6 +262,27 @@ static void update_sleep_wait_stats_locked(int done)
 	}
 	last_sleep_time_update = now;
 }
+
+/* Charge each lock currently blocking suspend with one failed suspend
+ * attempt. Caller must hold list_lock. */
+static void wake_lock_blame_locked(void)
+{
+	struct wake_lock *lock;
+
+	list_for_each_entry(lock, &active_wake_locks[WAKE_LOCK_SUSPEND], link)
+		if (!(lock->flags & WAKE_LOCK_AUTO_EXPIRE) ||
+		    (long)(lock->expires - jiffies) > 0)
+			lock->stat.block_count++;
+}
+
+static void wake_lock_blame(void)
+{
+	unsigned long irqflags;
+
+	spin_lock_irqsave(&list_lock, irqflags);
+	wake_lock_blame_locked();
+	spin_unlock_irqrestore(&list_lock, irqflags);
+}
 #endif
 
 
@@ -265,6 +358,9 @@ static void suspend(struct work_struct *work)
 	int entry_event_num;
 
 	if (has_wake_lock(WAKE_LOCK_SUSPEND)) {
+#ifdef CONFIG_WAKELOCK_STAT
+		wake_lock_blame();
+#endif
 		if (debug_mask & DEBUG_SUSPEND)
 			pr_info("suspend: abort suspend\n");
 		return;
@@ -291,7 +387,15 @@ static void suspend(struct work_struct *work)
 		wake_lock_timeout(&unknown_wakeup, HZ / 2);
 	}
 }
-static DECLARE_WORK(suspend_work, suspend);
+static DECLARE_DELAYED_WORK(suspend_work, suspend);
+
+/* Queue the next suspend attempt after the consolidation window. If an
+ * attempt is already queued the pending timer is left alone. */
+static void queue_suspend(void)
+{
+	queue_delayed_work(suspend_work_queue, &suspend_work,
+			   msecs_to_jiffies(suspend_delay_ms));
+}
 
 static void expire_wake_locks(unsigned long data)
 {
@@ -306,7 +410,7 @@ static void expire_wake_locks(unsigned long data)
 	if (debug_mask & DEBUG_EXPIRE)
 		pr_info("expire_wake_locks: done, has_lock %ld\n", has_lock);
 	if (has_lock == 0)
-		queue_work(suspend_work_queue, &suspend_work);
+		queue_suspend();
 	spin_unlock_irqrestore(&list_lock, irqflags);
 }
 static DEFINE_TIMER(expire_timer, expire_wake_locks, 0, 0);
@@ -315,6 +419,8 @@ static int power_suspend_late(struct device *dev)
 {
 	int ret = has_wake_lock(WAKE_LOCK_SUSPEND) ? -EAGAIN : 0;
 #ifdef CONFIG_WAKELOCK_STAT
+	if (ret)
+		wake_lock_blame();
 	wait_for_wakeup = 1;
 #endif
 	if (debug_mask & DEBUG_SUSPEND)
@@ -348,6 +454,9 @@ void wake_lock_init(struct wake_lock *lock, int type, const char *name)
 	lock->stat.count = 0;
 	lock->stat.expire_count = 0;
 	lock->stat.wakeup_count = 0;
+	lock->stat.block_count = 0;
+	memset(lock->stat.hist, 0, sizeof(lock->stat.hist));
+	lock->stat.max_trace_len = 0;
 	lock->stat.total_time = ktime_set(0, 0);
 	lock->stat.prevent_suspend_time = ktime_set(0, 0);
 	lock->stat.max_time = ktime_set(0, 0);
@@ -371,8 +480,12 @@ void wake_lock_destroy(struct wake_lock *lock)
 	lock->flags &= ~WAKE_LOCK_INITIALIZED;
 #ifdef CONFIG_WAKELOCK_STAT
 	if (lock->stat.count) {
+		int i;
 		deleted_wake_locks.stat.count += lock->stat.count;
 		deleted_wake_locks.stat.expire_count += lock->stat.expire_count;
+		deleted_wake_locks.stat.block_count += lock->stat.block_count;
+		for (i = 0; i < WAKE_LOCK_HIST_BUCKETS; i++)
+			deleted_wake_locks.stat.hist[i] += lock->stat.hist[i];
 		deleted_wake_locks.stat.total_time =
 			ktime_add(deleted_wake_locks.stat.total_time,
 				  lock->stat.total_time);
@@ -458,7 +571,7 @@ static void wake_lock_internal(
 					pr_info("wake_lock: %s, stop expire timer\n",
 						lock->name);
 			if (expire_in == 0)
-				queue_work(suspend_work_queue, &suspend_work);
+				queue_suspend();
 		}
 	}
 	spin_unlock_irqrestore(&list_lock, irqflags);
@@ -503,7 +616,7 @@ void wake_unlock(struct wake_lock *lock)
 					pr_info("wake_unlock: %s, stop expire "
 						"timer\n", lock->name);
 			if (has_lock == 0)
-				queue_work(suspend_work_queue, &suspend_work);
+				queue_suspend();
 		}
 		if (lock == &main_wake_lock) {
 			if (debug_mask & DEBUG_SUSPEND)
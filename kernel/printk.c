@@ -37,6 +37,7 @@
 #include <linux/ratelimit.h>
 #include <linux/kmsg_dump.h>
 #include <linux/syslog.h>
+#include <linux/workqueue.h>
 
 #include <asm/uaccess.h>
 
@@ -145,6 +146,17 @@ static int console_may_schedule;
 
 #define MAX_CHARS_PER_RELEASE_LOOP 128
 
+/*
+ * Upper bound on the console output an atomic-context caller of
+ * release_console_sem() drains itself.  During message storms (e.g.
+ * modem crash dumps arriving through smd) the printk that happens to
+ * own the console semaphore otherwise spends unbounded time feeding
+ * the uart from irq context with interrupts off.  Once the budget is
+ * spent the remainder is handed to process context; panics and oopses
+ * still flush everything synchronously.
+ */
+#define PRINTK_IRQ_FLUSH_BUDGET (8 * MAX_CHARS_PER_RELEASE_LOOP)
+
 #ifdef CONFIG_PRINTK
 
 static char __log_buf[__LOG_BUF_LEN];
@@ -1116,6 +1128,17 @@ void wake_up_klogd(void)
 		this_cpu_write(printk_pending, 1);
 }
 
+/*
+ * Flushes console output left behind when an atomic-context caller
+ * ran out of PRINTK_IRQ_FLUSH_BUDGET in release_console_sem().
+ */
+static void printk_flush_deferred(struct work_struct *work)
+{
+	acquire_console_sem();
+	release_console_sem();
+}
+static DECLARE_WORK(printk_flush_work, printk_flush_deferred);
+
 /**
  * release_console_sem - unlock the console system
  *
@@ -1135,6 +1158,8 @@ void release_console_sem(void)
 	unsigned long flags;
 	unsigned _con_start, _log_end;
 	unsigned wake_klogd = 0;
+	unsigned chars_printed = 0;
+	int defer_rest = 0;
 
 	if (console_suspended) {
 		up(&console_sem);
@@ -1148,6 +1173,11 @@ void release_console_sem(void)
 		wake_klogd |= log_start - log_end;
 		if (con_start == log_end)
 			break;			/* Nothing to print */
+		if (in_interrupt() && !oops_in_progress && keventd_up() &&
+		    chars_printed >= PRINTK_IRQ_FLUSH_BUDGET) {
+			defer_rest = 1;
+			break;			/* Flush from process context */
+		}
 		_con_start = con_start;
 		_log_end = (con_start + MAX_CHARS_PER_RELEASE_LOOP < log_end) ?
 			con_start + MAX_CHARS_PER_RELEASE_LOOP : log_end;
@@ -1157,10 +1187,13 @@ void release_console_sem(void)
 		call_console_drivers(_con_start, _log_end);
 		start_critical_timings();
 		local_irq_restore(flags);
+		chars_printed += _log_end - _con_start;
 	}
 	console_locked = 0;
 	up(&console_sem);
 	spin_unlock_irqrestore(&logbuf_lock, flags);
+	if (defer_rest)
+		schedule_work(&printk_flush_work);
 	if (wake_klogd)
 		wake_up_klogd();
 }
@@ -81,6 +81,7 @@
 
 #include "sched_cpupri.h"
 #include "sched_autogroup.h"
+#include "sched_oomgroup.h"
 
 #define CREATE_TRACE_POINTS
 #include <trace/events/sched.h>
@@ -259,6 +260,11 @@ struct task_group {
 	/* runqueue "owned" by this group on each cpu */
 	struct cfs_rq **cfs_rq;
 	unsigned long shares;
+	/*
+	 * Extra wakeup placement credit in ns granted to this group's
+	 * tasks in place_entity(), e.g. for the Android foreground group.
+	 */
+	unsigned long wakeup_boost;
 #endif
 
 #ifdef CONFIG_RT_GROUP_SCHED
@@ -436,6 +442,7 @@ struct root_domain {
 	 */
 	cpumask_var_t rto_mask;
 	atomic_t rto_count;
+	struct rcu_head rcu;
 #ifdef CONFIG_SMP
 	struct cpupri cpupri;
 #endif
@@ -633,7 +640,7 @@ static inline struct task_group *task_group(struct task_struct *p)
 			lockdep_is_held(&task_rq(p)->lock));
 	tg = container_of(css, struct task_group, css);
 
-	return autogroup_task_group(p, tg);
+	return oomgroup_task_group(p, autogroup_task_group(p, tg));
 }
 
 /* Change a task's cfs_rq and parent entity if it moves across CPUs/groups */
@@ -1424,10 +1431,13 @@ enum cpuacct_stat_index {
 
 #ifdef CONFIG_CGROUP_CPUACCT
 static void cpuacct_charge(struct task_struct *tsk, u64 cputime);
+static void cpuacct_charge_wait(struct task_struct *tsk, u64 waittime);
 static void cpuacct_update_stats(struct task_struct *tsk,
 		enum cpuacct_stat_index idx, cputime_t val);
 #else
 static inline void cpuacct_charge(struct task_struct *tsk, u64 cputime) {}
+static inline void cpuacct_charge_wait(struct task_struct *tsk,
+		u64 waittime) {}
 static inline void cpuacct_update_stats(struct task_struct *tsk,
 		enum cpuacct_stat_index idx, cputime_t val) {}
 #endif
@@ -2008,6 +2018,7 @@ static void deactivate_task(struct rq *rq, struct task_struct *p, int flags)
 #include "sched_fair.c"
 #include "sched_rt.c"
 #include "sched_autogroup.c"
+#include "sched_oomgroup.c"
 #ifdef CONFIG_SCHED_DEBUG
 # include "sched_debug.c"
 #endif
@@ -6298,8 +6309,6 @@ sd_parent_degenerate(struct sched_domain *sd, struct sched_domain *parent)
 
 static void free_rootdomain(struct root_domain *rd)
 {
-	synchronize_sched();
-
 	cpupri_cleanup(&rd->cpupri);
 
 	free_cpumask_var(rd->rto_mask);
@@ -6308,6 +6317,11 @@ static void free_rootdomain(struct root_domain *rd)
 	kfree(rd);
 }
 
+static void free_rootdomain_rcu(struct rcu_head *rcu)
+{
+	free_rootdomain(container_of(rcu, struct root_domain, rcu));
+}
+
 static void rq_attach_root(struct rq *rq, struct root_domain *rd)
 {
 	struct root_domain *old_rd = NULL;
@@ -6341,8 +6355,14 @@ static void rq_attach_root(struct rq *rq, struct root_domain *rd)
 
 	raw_spin_unlock_irqrestore(&rq->lock, flags);
 
+	/*
+	 * Defer the free until an rcu-sched grace period has elapsed
+	 * instead of waiting for one here; rq_attach_root() runs on
+	 * every domain rebuild and the blocking grace period was a
+	 * large part of the cpu hotplug latency.
+	 */
 	if (old_rd)
-		free_rootdomain(old_rd);
+		call_rcu_sched(&old_rd->rcu, free_rootdomain_rcu);
 }
 
 static int init_rootdomain(struct root_domain *rd, bool bootmem)
@@ -7369,7 +7389,14 @@ static void detach_destroy_domains(const struct cpumask *cpu_map)
 
 	for_each_cpu(i, cpu_map)
 		cpu_attach_domain(NULL, &def_root_domain, i);
-	synchronize_sched();
+	/*
+	 * Domains are detached on every hotplug transition; force the
+	 * grace period to end quickly rather than sleeping for several
+	 * jiffies so that offlining a core stays cheap.  Safe from the
+	 * hotplug path: get_online_cpus() recurses for the active
+	 * writer.
+	 */
+	synchronize_sched_expedited();
 	arch_destroy_sched_domains(cpu_map, to_cpumask(tmpmask));
 }
 
@@ -8479,6 +8506,33 @@ unsigned long sched_group_shares(struct task_group *tg)
 {
 	return tg->shares;
 }
+
+/*
+ * Cumulative execution time, in nanoseconds, of tasks belonging to
+ * child task groups on @cpu.  Only direct children of the root group
+ * are summed; nested groups are already accounted in their parent's
+ * group entity.  With the Android cgroup layout, where foreground
+ * tasks stay in the root cpu cgroup and background ones live in child
+ * groups, this approximates per-cpu background execution time.  The
+ * counters are read without the runqueue lock, so the result is only
+ * approximate; consumers such as cpufreq governors use it for load
+ * weighting, not accounting.
+ */
+u64 sched_group_child_exec_time(int cpu)
+{
+	struct task_group *tg;
+	u64 total = 0;
+
+	rcu_read_lock();
+	list_for_each_entry_rcu(tg, &task_groups, list) {
+		if (tg->parent != &root_task_group || !tg->se[cpu])
+			continue;
+		total += tg->se[cpu]->sum_exec_runtime;
+	}
+	rcu_read_unlock();
+
+	return total;
+}
 #endif
 
 #ifdef CONFIG_RT_GROUP_SCHED
@@ -8852,6 +8906,25 @@ static u64 cpu_shares_read_u64(struct cgroup *cgrp, struct cftype *cft)
 
 	return (u64) tg->shares;
 }
+
+static int cpu_wakeup_boost_write_u64(struct cgroup *cgrp, struct cftype *cftype,
+				      u64 boost_us)
+{
+	u64 boost = boost_us * NSEC_PER_USEC;
+
+	/* The credit is capped at one latency period; see place_entity() */
+	if (boost > sysctl_sched_latency)
+		return -EINVAL;
+
+	cgroup_tg(cgrp)->wakeup_boost = boost;
+
+	return 0;
+}
+
+static u64 cpu_wakeup_boost_read_u64(struct cgroup *cgrp, struct cftype *cft)
+{
+	return (u64) cgroup_tg(cgrp)->wakeup_boost / NSEC_PER_USEC;
+}
 #endif /* CONFIG_FAIR_GROUP_SCHED */
 
 #ifdef CONFIG_RT_GROUP_SCHED
@@ -8885,6 +8958,11 @@ static struct cftype cpu_files[] = {
 		.read_u64 = cpu_shares_read_u64,
 		.write_u64 = cpu_shares_write_u64,
 	},
+	{
+		.name = "wakeup_boost_us",
+		.read_u64 = cpu_wakeup_boost_read_u64,
+		.write_u64 = cpu_wakeup_boost_write_u64,
+	},
 #endif
 #ifdef CONFIG_RT_GROUP_SCHED
 	{
@@ -8932,6 +9010,8 @@ struct cpuacct {
 	struct cgroup_subsys_state css;
 	/* cpuusage holds pointer to a u64-type object on every cpu */
 	u64 __percpu *cpuusage;
+	/* time spent runnable but not running, in nanoseconds */
+	u64 __percpu *cpuwait;
 	struct percpu_counter cpustat[CPUACCT_STAT_NSTATS];
 	struct cpuacct *parent;
 };
@@ -8966,6 +9046,10 @@ static struct cgroup_subsys_state *cpuacct_create(
 	if (!ca->cpuusage)
 		goto out_free_ca;
 
+	ca->cpuwait = alloc_percpu(u64);
+	if (!ca->cpuwait)
+		goto out_free_cpuusage;
+
 	for (i = 0; i < CPUACCT_STAT_NSTATS; i++)
 		if (percpu_counter_init(&ca->cpustat[i], 0))
 			goto out_free_counters;
@@ -8978,6 +9062,8 @@ static struct cgroup_subsys_state *cpuacct_create(
 out_free_counters:
 	while (--i >= 0)
 		percpu_counter_destroy(&ca->cpustat[i]);
+	free_percpu(ca->cpuwait);
+out_free_cpuusage:
 	free_percpu(ca->cpuusage);
 out_free_ca:
 	kfree(ca);
@@ -8994,6 +9080,7 @@ cpuacct_destroy(struct cgroup_subsys *ss, struct cgroup *cgrp)
 
 	for (i = 0; i < CPUACCT_STAT_NSTATS; i++)
 		percpu_counter_destroy(&ca->cpustat[i]);
+	free_percpu(ca->cpuwait);
 	free_percpu(ca->cpuusage);
 	kfree(ca);
 }
@@ -9033,6 +9120,41 @@ static void cpuacct_cpuusage_write(struct cpuacct *ca, int cpu, u64 val)
 #endif
 }
 
+static u64 cpuacct_cpuwait_read(struct cpuacct *ca, int cpu)
+{
+	u64 *cpuwait = per_cpu_ptr(ca->cpuwait, cpu);
+	u64 data;
+
+#ifndef CONFIG_64BIT
+	/*
+	 * Take rq->lock to make 64-bit read safe on 32-bit platforms.
+	 */
+	raw_spin_lock_irq(&cpu_rq(cpu)->lock);
+	data = *cpuwait;
+	raw_spin_unlock_irq(&cpu_rq(cpu)->lock);
+#else
+	data = *cpuwait;
+#endif
+
+	return data;
+}
+
+static void cpuacct_cpuwait_write(struct cpuacct *ca, int cpu, u64 val)
+{
+	u64 *cpuwait = per_cpu_ptr(ca->cpuwait, cpu);
+
+#ifndef CONFIG_64BIT
+	/*
+	 * Take rq->lock to make 64-bit write safe on 32-bit platforms.
+	 */
+	raw_spin_lock_irq(&cpu_rq(cpu)->lock);
+	*cpuwait = val;
+	raw_spin_unlock_irq(&cpu_rq(cpu)->lock);
+#else
+	*cpuwait = val;
+#endif
+}
+
 /* return total cpu usage (in nanoseconds) of a group */
 static u64 cpuusage_read(struct cgroup *cgrp, struct cftype *cft)
 {
@@ -9065,6 +9187,43 @@ out:
 	return err;
 }
 
+/*
+ * return total time (in nanoseconds) the group's tasks spent runnable
+ * but not running. Only accounted when CONFIG_SCHEDSTATS is set, since
+ * that is what maintains the per-entity wait clocks; reads as 0
+ * otherwise.
+ */
+static u64 cpuwait_read(struct cgroup *cgrp, struct cftype *cft)
+{
+	struct cpuacct *ca = cgroup_ca(cgrp);
+	u64 totalcpuwait = 0;
+	int i;
+
+	for_each_present_cpu(i)
+		totalcpuwait += cpuacct_cpuwait_read(ca, i);
+
+	return totalcpuwait;
+}
+
+static int cpuwait_write(struct cgroup *cgrp, struct cftype *cftype,
+								u64 reset)
+{
+	struct cpuacct *ca = cgroup_ca(cgrp);
+	int err = 0;
+	int i;
+
+	if (reset) {
+		err = -EINVAL;
+		goto out;
+	}
+
+	for_each_present_cpu(i)
+		cpuacct_cpuwait_write(ca, i, 0);
+
+out:
+	return err;
+}
+
 static int cpuacct_percpu_seq_read(struct cgroup *cgroup, struct cftype *cft,
 				   struct seq_file *m)
 {
@@ -9109,6 +9268,11 @@ static struct cftype files[] = {
 		.name = "usage_percpu",
 		.read_seq_string = cpuacct_percpu_seq_read,
 	},
+	{
+		.name = "wait",
+		.read_u64 = cpuwait_read,
+		.write_u64 = cpuwait_write,
+	},
 	{
 		.name = "stat",
 		.read_map = cpuacct_stats_show,
@@ -9147,6 +9311,35 @@ static void cpuacct_charge(struct task_struct *tsk, u64 cputime)
 	rcu_read_unlock();
 }
 
+/*
+ * charge a task's runnable wait time (runnable but not running) to its
+ * accounting group and, walking ca->parent, to all its ancestors so a
+ * single read of an upper group rolls up the whole subtree.
+ *
+ * called with rq->lock held.
+ */
+static void cpuacct_charge_wait(struct task_struct *tsk, u64 waittime)
+{
+	struct cpuacct *ca;
+	int cpu;
+
+	if (unlikely(!cpuacct_subsys.active))
+		return;
+
+	cpu = task_cpu(tsk);
+
+	rcu_read_lock();
+
+	ca = task_ca(tsk);
+
+	for (; ca; ca = ca->parent) {
+		u64 *cpuwait = per_cpu_ptr(ca->cpuwait, cpu);
+		*cpuwait += waittime;
+	}
+
+	rcu_read_unlock();
+}
+
 /*
  * When CONFIG_VIRT_CPU_ACCOUNTING is enabled one jiffy can be very large
  * in cputime_t units. As a result, cpuacct_update_stats calls
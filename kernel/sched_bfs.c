@@ -162,6 +162,12 @@ struct global_rq {
 	unsigned long long nr_switches;
 	struct list_head queue[PRIO_LIMIT];
 	DECLARE_BITMAP(prio_bitmap, PRIO_LIMIT + 1);
+	/*
+	 * Earliest raw deadline task queued in the bucket dl_cache->prio,
+	 * or NULL when unknown. Lets earliest_deadline_task avoid the
+	 * O(n) queue scan, shortening grq lock hold time in schedule().
+	 */
+	struct task_struct *dl_cache;
 #ifdef CONFIG_SMP
 	unsigned long qnr; /* queued not running */
 	cpumask_t cpu_idle_map;
@@ -626,6 +632,8 @@ static void dequeue_task(struct task_struct *p)
 	list_del_init(&p->run_list);
 	if (list_empty(grq.queue + p->prio))
 		__clear_bit(p->prio, grq.prio_bitmap);
+	if (grq.dl_cache == p)
+		grq.dl_cache = NULL;
 }
 
 /*
@@ -659,6 +667,19 @@ static void enqueue_task(struct task_struct *p)
 			p->prio = p->normal_prio;
 		else
 			p->prio = NORMAL_PRIO;
+
+		/*
+		 * Maintain the earliest deadline cache. We know p is the
+		 * earliest in its bucket if the bucket was empty, or if it
+		 * beats the cached task of the same bucket. Prefer caching
+		 * the lowest prio bucket as that is selected from first.
+		 */
+		if (!test_bit(p->prio, grq.prio_bitmap)) {
+			if (!grq.dl_cache || p->prio <= grq.dl_cache->prio)
+				grq.dl_cache = p;
+		} else if (grq.dl_cache && grq.dl_cache->prio == p->prio &&
+			   deadline_before(p->deadline, grq.dl_cache->deadline))
+			grq.dl_cache = p;
 	}
 	__set_bit(p->prio, grq.prio_bitmap);
 	list_add_tail(&p->run_list, grq.queue + p->prio);
@@ -2758,6 +2779,23 @@ task_struct *earliest_deadline_task(struct rq *rq, struct task_struct *idle)
 	struct list_head *queue;
 	int idx = 0;
 
+	/*
+	 * Fast path: if the cached earliest deadline task belongs to the
+	 * first populated bucket (i.e. no rt or lower prio task queued),
+	 * may run here, and carries no sticky deadline bias, it is the
+	 * task the scan below would pick, without walking the queue.
+	 */
+	p = grq.dl_cache;
+	if (p) {
+		idx = find_next_bit(grq.prio_bitmap, PRIO_LIMIT, 0);
+		if (p->prio == idx && !needs_other_cpu(p, cpu) &&
+		    (task_rq(p) == rq || !task_sticky(p))) {
+			edt = p;
+			goto out_take;
+		}
+		idx = 0;
+	}
+
 retry:
 	idx = find_next_bit(grq.prio_bitmap, PRIO_LIMIT, idx);
 	if (idx >= PRIO_LIMIT)
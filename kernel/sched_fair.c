@@ -577,6 +577,8 @@ update_stats_wait_end(struct cfs_rq *cfs_rq, struct sched_entity *se)
 	if (entity_is_task(se)) {
 		trace_sched_stat_wait(task_of(se),
 			rq_of(cfs_rq)->clock - se->statistics.wait_start);
+		cpuacct_charge_wait(task_of(se),
+			rq_of(cfs_rq)->clock - se->statistics.wait_start);
 	}
 #endif
 	schedstat_set(se->statistics.wait_start, 0);
@@ -723,6 +725,15 @@ static void check_spread(struct cfs_rq *cfs_rq, struct sched_entity *se)
 #endif
 }
 
+static inline unsigned long group_wakeup_boost(struct cfs_rq *cfs_rq)
+{
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	return cfs_rq->tg->wakeup_boost;
+#else
+	return 0;
+#endif
+}
+
 static void
 place_entity(struct cfs_rq *cfs_rq, struct sched_entity *se, int initial)
 {
@@ -748,6 +759,16 @@ place_entity(struct cfs_rq *cfs_rq, struct sched_entity *se, int initial)
 		if (sched_feat(GENTLE_FAIR_SLEEPERS))
 			thresh >>= 1;
 
+		/*
+		 * Groups singled out by userspace (the Android foreground
+		 * group) get extra credit so their wakeups preempt more
+		 * readily. Cap the total bonus at one latency period so a
+		 * boosted group never gains more than sleepers ever could.
+		 */
+		thresh += group_wakeup_boost(cfs_rq);
+		if (thresh > sysctl_sched_latency)
+			thresh = sysctl_sched_latency;
+
 		vruntime -= thresh;
 	}
 
@@ -0,0 +1,103 @@
+#ifdef CONFIG_SCHED_OOMADJ_GROUP
+
+/*
+ * Android has no sessions for autogroup to key off; the framework's
+ * foreground/background signal is the oom_adj value ActivityManager
+ * writes through /proc/<pid>/oom_adj (the same value the low memory
+ * killer reads).  Tasks whose oom_adj is at or above the threshold are
+ * scheduled in one shared low-weight task group, so background sync
+ * jobs compete with each other for a slice of CPU instead of stealing
+ * whole cores from the foreground app.  No userspace cgroup setup is
+ * needed.
+ */
+
+unsigned int __read_mostly sysctl_sched_oomgroup_enabled = 1;
+/* oom_adj at/above this is "background"; 2 is just behind visible apps */
+int __read_mostly sysctl_sched_oomgroup_adj = 2;
+
+/* Matches the cpu.shares Android gives /dev/cpuctl/bg_non_interactive */
+#define OOMGROUP_BG_SHARES	52
+
+static struct task_group *oomgroup_bg_tg;
+
+static inline bool
+task_wants_oomgroup(struct task_struct *p, struct task_group *tg)
+{
+	/*
+	 * Leave tasks that were explicitly placed in a cgroup alone;
+	 * only the root group (or an automatic session group) is fair
+	 * game for reclassification.
+	 */
+	if (tg != &root_task_group
+#ifdef CONFIG_SCHED_AUTOGROUP
+	    && !tg->autogroup
+#endif
+	    )
+		return false;
+
+	if (p->sched_class != &fair_sched_class)
+		return false;
+
+	if (p->flags & PF_EXITING)
+		return false;
+
+	return p->signal->oom_adj >= sysctl_sched_oomgroup_adj;
+}
+
+static inline struct task_group *
+oomgroup_task_group(struct task_struct *p, struct task_group *tg)
+{
+	struct task_group *bg = ACCESS_ONCE(oomgroup_bg_tg);
+
+	if (bg && ACCESS_ONCE(sysctl_sched_oomgroup_enabled) &&
+	    task_wants_oomgroup(p, tg))
+		return bg;
+
+	return tg;
+}
+
+/*
+ * Requeue every thread of @p so a changed signal->oom_adj takes effect.
+ * Called from the /proc/<pid>/oom_adj write path, so allocation-free.
+ */
+void sched_oomgroup_reclassify(struct task_struct *p)
+{
+	struct task_struct *t;
+	unsigned long flags;
+
+	if (!oomgroup_bg_tg)
+		return;
+
+	if (!lock_task_sighand(p, &flags))
+		return;
+
+	t = p;
+	do {
+		sched_move_task(t);
+	} while_each_thread(p, t);
+
+	unlock_task_sighand(p, &flags);
+}
+
+static int __init oomgroup_init(void)
+{
+	struct task_group *tg;
+
+	tg = sched_create_group(&init_task_group);
+	if (IS_ERR(tg)) {
+		printk(KERN_WARNING "oomgroup_init: sched_create_group() "
+		       "failure, background grouping disabled.\n");
+		return 0;
+	}
+
+	sched_group_set_shares(tg, OOMGROUP_BG_SHARES);
+
+	/* Publish only after the group is fully set up */
+	smp_wmb();
+	oomgroup_bg_tg = tg;
+
+	return 0;
+}
+late_initcall(oomgroup_init);
+
+#endif /* CONFIG_SCHED_OOMADJ_GROUP */
@@ -0,0 +1,14 @@
+#ifdef CONFIG_SCHED_OOMADJ_GROUP
+
+static inline struct task_group *
+oomgroup_task_group(struct task_struct *p, struct task_group *tg);
+
+#else /* !CONFIG_SCHED_OOMADJ_GROUP */
+
+static inline struct task_group *
+oomgroup_task_group(struct task_struct *p, struct task_group *tg)
+{
+	return tg;
+}
+
+#endif /* CONFIG_SCHED_OOMADJ_GROUP */
@@ -199,6 +199,19 @@ static void sched_info_arrive(struct task_struct *t)
 	t->sched_info.last_arrival = now;
 	t->sched_info.pcount++;
 
+#ifdef CONFIG_SCHED_WAKEUP_HIST
+	{
+		unsigned long long us = delta >> 10; /* ns to ~us */
+		int idx = 0;
+
+		while (us > 0 && idx < SCHED_WAKEUP_HIST_BUCKETS - 1) {
+			us >>= 1;
+			idx++;
+		}
+		t->sched_info.wait_hist[idx]++;
+	}
+#endif
+
 	rq_sched_info_arrive(task_rq(t), delta);
 }
 
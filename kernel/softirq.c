@@ -204,11 +204,29 @@ EXPORT_SYMBOL(local_bh_enable_ip);
  */
 #define MAX_SOFTIRQ_RESTART 10
 
+/*
+ * Time budget in microseconds after which a softirq burst is punted to
+ * ksoftirqd when a freshly woken task is waiting for this CPU.  A NET_RX
+ * storm otherwise holds the CPU for several ms inside irq context, which
+ * UI threads notice.  0 disables the budget and restores the pure
+ * restart-count behaviour.
+ */
+int softirq_time_limit_us __read_mostly = 500;
+
+static int softirq_budget_spent(u64 start)
+{
+	if (!softirq_time_limit_us || !need_resched())
+		return 0;
+	return sched_clock() - start >
+		(u64)softirq_time_limit_us * NSEC_PER_USEC;
+}
+
 asmlinkage void __do_softirq(void)
 {
 	struct softirq_action *h;
 	__u32 pending;
 	int max_restart = MAX_SOFTIRQ_RESTART;
+	u64 start = sched_clock();
 	int cpu;
 
 	pending = local_softirq_pending();
@@ -253,7 +271,7 @@ restart:
 	local_irq_disable();
 
 	pending = local_softirq_pending();
-	if (pending && --max_restart)
+	if (pending && --max_restart && !softirq_budget_spent(start))
 		goto restart;
 
 	if (pending)
@@ -0,0 +1,182 @@
+/*
+ * statspage - consolidated binary counter snapshots for telemetry.
+ *
+ * See include/linux/statspage.h for the page layout.  The design goal
+ * is that measurement does not perturb the system being measured: the
+ * hot paths only touch their own counters, registration is O(1), and
+ * all the snapshot work happens on the reader's syscall.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ */
+
+#include <linux/kernel.h>
+#include <linux/module.h>
+#include <linux/init.h>
+#include <linux/slab.h>
+#include <linux/gfp.h>
+#include <linux/list.h>
+#include <linux/mutex.h>
+#include <linux/jiffies.h>
+#include <linux/fs.h>
+#include <linux/mm.h>
+#include <linux/debugfs.h>
+#include <linux/io.h>
+#include <linux/uaccess.h>
+#include <linux/statspage.h>
+
+static DEFINE_MUTEX(statspage_lock);
+static LIST_HEAD(statspage_groups);
+static unsigned int statspage_nr_groups;
+/* bytes of the page in use; groups may register before the page is
+ * allocated, so the header is accounted statically */
+static unsigned long statspage_used = sizeof(struct statspage_hdr);
+static void *statspage_page;
+
+static unsigned long statspage_group_bytes(struct statspage_group *grp)
+{
+	return sizeof(struct statspage_rec) + grp->nr * sizeof(u64);
+}
+
+/**
+ * statspage_register - add a counter group to the stats page.
+ * @grp: group descriptor; must stay valid until unregistration.
+ *
+ * Returns 0 on success, -ENOSPC if the group does not fit in the
+ * remaining space of the page.
+ */
+int statspage_register(struct statspage_group *grp)
+{
+	int ret = 0;
+
+	mutex_lock(&statspage_lock);
+	if (statspage_used + statspage_group_bytes(grp) > PAGE_SIZE) {
+		ret = -ENOSPC;
+	} else {
+		statspage_used += statspage_group_bytes(grp);
+		list_add_tail(&grp->node, &statspage_groups);
+		statspage_nr_groups++;
+	}
+	mutex_unlock(&statspage_lock);
+
+	return ret;
+}
+EXPORT_SYMBOL_GPL(statspage_register);
+
+void statspage_unregister(struct statspage_group *grp)
+{
+	mutex_lock(&statspage_lock);
+	list_del(&grp->node);
+	statspage_nr_groups--;
+	statspage_used -= statspage_group_bytes(grp);
+	mutex_unlock(&statspage_lock);
+}
+EXPORT_SYMBOL_GPL(statspage_unregister);
+
+/*
+ * Rewrite the page from the registered groups.  Called with
+ * statspage_lock held; the sequence counter is odd for the duration,
+ * so an mmap reader can detect that it raced with us and retry.
+ * The counters themselves are read locklessly: telemetry tolerates a
+ * counter incremented halfway through a snapshot, and stopping the
+ * writers would perturb exactly what is being measured.
+ */
+static void statspage_snapshot(void)
+{
+	struct statspage_hdr *hdr = statspage_page;
+	struct statspage_group *grp;
+	void *p = statspage_page + sizeof(*hdr);
+
+	hdr->seq++;
+	wmb();
+
+	hdr->magic = STATSPAGE_MAGIC;
+	hdr->nr_groups = statspage_nr_groups;
+	hdr->snap_jiffies = (u32)jiffies;
+
+	list_for_each_entry(grp, &statspage_groups, node) {
+		struct statspage_rec *rec = p;
+		u64 *val = p + sizeof(*rec);
+		unsigned int i;
+
+		strlcpy(rec->name, grp->name, sizeof(rec->name));
+		rec->nr = grp->nr;
+		rec->__pad = 0;
+
+		if (grp->counters) {
+			for (i = 0; i < grp->nr; i++)
+				val[i] = grp->counters[i];
+		} else {
+			unsigned long *tmp = (unsigned long *)val;
+
+			/*
+			 * Fill in place: u64 slots can hold the
+			 * unsigned long results, widen them backwards
+			 * afterwards so nothing is overwritten.
+			 */
+			grp->snapshot(tmp, grp->nr);
+			for (i = grp->nr; i-- > 0; )
+				val[i] = tmp[i];
+		}
+
+		p += statspage_group_bytes(grp);
+	}
+
+	wmb();
+	hdr->seq++;
+}
+
+static ssize_t statspage_read(struct file *file, char __user *buf,
+			      size_t count, loff_t *ppos)
+{
+	ssize_t ret;
+
+	mutex_lock(&statspage_lock);
+	/*
+	 * Only refresh when the read starts from the beginning, so a
+	 * reader issuing two read() calls for one page still gets a
+	 * consistent snapshot.
+	 */
+	if (*ppos == 0)
+		statspage_snapshot();
+	ret = simple_read_from_buffer(buf, count, ppos, statspage_page,
+				      PAGE_SIZE);
+	mutex_unlock(&statspage_lock);
+
+	return ret;
+}
+
+/*
+ * Zero-copy access: the daemon maps the page once and triggers a
+ * refresh with a 1-byte pread() whenever it wants fresh values.
+ */
+static int statspage_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	if (vma->vm_end - vma->vm_start != PAGE_SIZE || vma->vm_pgoff != 0)
+		return -EINVAL;
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	return remap_pfn_range(vma, vma->vm_start,
+			       virt_to_phys(statspage_page) >> PAGE_SHIFT,
+			       PAGE_SIZE, vma->vm_page_prot);
+}
+
+static const struct file_operations statspage_fops = {
+	.owner = THIS_MODULE,
+	.read = statspage_read,
+	.mmap = statspage_mmap,
+};
+
+static int __init statspage_init(void)
+{
+	statspage_page = (void *)get_zeroed_page(GFP_KERNEL);
+	if (!statspage_page)
+		return -ENOMEM;
+
+	debugfs_create_file("statspage", 0444, NULL, NULL, &statspage_fops);
+	return 0;
+}
+core_initcall(statspage_init);
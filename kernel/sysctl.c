@@ -94,6 +94,7 @@ extern int pid_max;
 extern int min_free_kbytes;
 extern int min_free_order_shift;
 extern int pid_max_min, pid_max_max;
+extern int softirq_time_limit_us;
 extern int sysctl_drop_caches;
 extern int percpu_pagelist_fraction;
 extern int compat_log;
@@ -401,6 +402,24 @@ static struct ctl_table kern_table[] = {
 		.extra2         = &one,
 	},
 #endif
+#ifdef CONFIG_SCHED_OOMADJ_GROUP
+	{
+		.procname       = "sched_oomgroup_enabled",
+		.data           = &sysctl_sched_oomgroup_enabled,
+		.maxlen         = sizeof(unsigned int),
+		.mode           = 0644,
+		.proc_handler   = proc_dointvec,
+		.extra1         = &zero,
+		.extra2         = &one,
+	},
+	{
+		.procname       = "sched_oomgroup_adj",
+		.data           = &sysctl_sched_oomgroup_adj,
+		.maxlen         = sizeof(int),
+		.mode           = 0644,
+		.proc_handler   = proc_dointvec,
+	},
+#endif
 #ifdef CONFIG_PROVE_LOCKING
 	{
 		.procname	= "prove_locking",
@@ -426,6 +445,13 @@ static struct ctl_table kern_table[] = {
 		.mode		= 0644,
 		.proc_handler	= proc_dointvec,
 	},
+	{
+		.procname	= "softirq_time_limit_us",
+		.data		= &softirq_time_limit_us,	/* kernel/softirq.c */
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec,
+	},
 	{
 		.procname	= "core_uses_pid",
 		.data		= &core_uses_pid,
@@ -1432,6 +1458,14 @@ static struct ctl_table fs_table[] = {
 		.mode		= 0444,
 		.proc_handler	= proc_dointvec,
 	},
+	{
+		.procname	= "negative-dentry-limit",
+		.data		= &sysctl_neg_dentry_limit,
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= &zero,
+	},
 	{
 		.procname	= "overflowuid",
 		.data		= &fs_overflowuid,
@@ -248,6 +248,57 @@ u64 get_cpu_iowait_time_us(int cpu, u64 *last_update_time)
 }
 EXPORT_SYMBOL_GPL(get_cpu_iowait_time_us);
 
+/*
+ * Attribute the deadline we are about to program to the subsystem that
+ * bounded it, so idle-power debugging can read a single source
+ * (/proc/timer_list) instead of correlating timer wheel, hrtimer and
+ * timekeeping traces.  get_next_timer_interrupt() already consolidates
+ * the timer wheel and the next hrtimer event into one expiry; here we
+ * only reconstruct which of them won.
+ */
+static void tick_nohz_account_wake_source(struct tick_sched *ts,
+					  unsigned long last_jiffies,
+					  unsigned long next_jiffies,
+					  u64 time_delta, ktime_t expires,
+					  int wake_forced)
+{
+	struct timespec tsdelta;
+	ktime_t hr_delta;
+
+	if (expires.tv64 == KTIME_MAX)
+		return;
+
+	if (wake_forced) {
+		/* rcu, printk or the arch insisted on the next tick */
+		ts->sleeps_limit_other++;
+		return;
+	}
+
+	/* sleep cut short by the timekeeping/clocksource deferment limit? */
+	if (time_delta <
+	    tick_period.tv64 * (u64)(next_jiffies - last_jiffies)) {
+		ts->sleeps_limit_tk++;
+		return;
+	}
+
+	hr_delta = hrtimer_get_next_event();
+	if (hr_delta.tv64 != KTIME_MAX) {
+		unsigned long hr_jiffies;
+
+		if (hr_delta.tv64 <= 0) {
+			ts->sleeps_limit_hrtimer++;
+			return;
+		}
+		tsdelta = ktime_to_timespec(hr_delta);
+		hr_jiffies = last_jiffies + timespec_to_jiffies(&tsdelta);
+		if (!time_after(hr_jiffies, next_jiffies)) {
+			ts->sleeps_limit_hrtimer++;
+			return;
+		}
+	}
+	ts->sleeps_limit_wheel++;
+}
+
 /**
  * tick_nohz_stop_sched_tick - stop the idle tick from the idle task
  *
@@ -260,6 +311,7 @@ void tick_nohz_stop_sched_tick(int inidle)
 	unsigned long seq, last_jiffies, next_jiffies, delta_jiffies, flags;
 	struct tick_sched *ts;
 	ktime_t last_update, expires, now;
+	int wake_forced = 0;
 	struct clock_event_device *dev = __get_cpu_var(tick_cpu_device).evtdev;
 	u64 time_delta;
 	int cpu;
@@ -328,6 +380,7 @@ void tick_nohz_stop_sched_tick(int inidle)
 	    arch_needs_cpu(cpu)) {
 		next_jiffies = last_jiffies + 1;
 		delta_jiffies = 1;
+		wake_forced = 1;
 	} else {
 		/* Get the next timer wheel timer */
 		next_jiffies = get_next_timer_interrupt(last_jiffies);
@@ -423,6 +476,9 @@ void tick_nohz_stop_sched_tick(int inidle)
 
 		/* Mark expires */
 		ts->idle_expires = expires;
+		tick_nohz_account_wake_source(ts, last_jiffies, next_jiffies,
+					      time_delta, expires,
+					      wake_forced);
 
 		/*
 		 * If the expiration time == KTIME_MAX, then
@@ -180,6 +180,10 @@ static void print_cpu(struct seq_file *m, int cpu, u64 now)
 		P(last_jiffies);
 		P(next_jiffies);
 		P_ns(idle_expires);
+		P(sleeps_limit_wheel);
+		P(sleeps_limit_hrtimer);
+		P(sleeps_limit_tk);
+		P(sleeps_limit_other);
 		SEQ_printf(m, "jiffies: %Lu\n",
 			   (unsigned long long)jiffies);
 	}
@@ -40,6 +40,7 @@
 #include <linux/perf_event.h>
 #include <linux/sched.h>
 #include <linux/slab.h>
+#include <linux/earlysuspend.h>
 
 #include <asm/uaccess.h>
 #include <asm/unistd.h>
@@ -89,21 +90,29 @@ EXPORT_SYMBOL(boot_tvec_bases);
 static DEFINE_PER_CPU(struct tvec_base *, tvec_bases) = &boot_tvec_bases;
 
 /*
- * Note that all tvec_bases are 2 byte aligned and lower bit of
- * base in timer_list is guaranteed to be zero. Use the LSB for
- * the new flag to indicate whether the timer is deferrable
+ * Note that all tvec_bases are at least 4 byte aligned and the lower two
+ * bits of base in timer_list are guaranteed to be zero. Use them as flags:
+ * bit 0 marks a timer as deferrable, bit 1 marks it as deferrable only
+ * while the system is early-suspended (screen off).
  */
 #define TBASE_DEFERRABLE_FLAG		(0x1)
+#define TBASE_SUSPEND_DEFER_FLAG	(0x2)
+#define TBASE_FLAG_MASK			(0x3)
 
-/* Functions below help us manage 'deferrable' flag */
+/* Functions below help us manage the flag bits */
 static inline unsigned int tbase_get_deferrable(struct tvec_base *base)
 {
 	return ((unsigned int)(unsigned long)base & TBASE_DEFERRABLE_FLAG);
 }
 
+static inline unsigned int tbase_get_suspend_defer(struct tvec_base *base)
+{
+	return ((unsigned int)(unsigned long)base & TBASE_SUSPEND_DEFER_FLAG);
+}
+
 static inline struct tvec_base *tbase_get_base(struct tvec_base *base)
 {
-	return ((struct tvec_base *)((unsigned long)base & ~TBASE_DEFERRABLE_FLAG));
+	return ((struct tvec_base *)((unsigned long)base & ~TBASE_FLAG_MASK));
 }
 
 static inline void timer_set_deferrable(struct timer_list *timer)
@@ -116,9 +125,20 @@ static inline void
 timer_set_base(struct timer_list *timer, struct tvec_base *new_base)
 {
 	timer->base = (struct tvec_base *)((unsigned long)(new_base) |
-				      tbase_get_deferrable(timer->base));
+			      ((unsigned long)(timer->base) & TBASE_FLAG_MASK));
 }
 
+#if defined(CONFIG_NO_HZ) && defined(CONFIG_HAS_EARLYSUSPEND)
+/*
+ * Set while the system is early-suspended: timers carrying
+ * TBASE_SUSPEND_DEFER_FLAG then stop contributing to the next timer
+ * wakeup and get batched to whatever non-deferrable event comes first.
+ */
+static int timer_suspend_defer_active;
+#else
+#define timer_suspend_defer_active	(0)
+#endif
+
 static unsigned long round_jiffies_common(unsigned long j, int cpu,
 		bool force_up)
 {
@@ -605,6 +625,22 @@ void init_timer_deferrable_key(struct timer_list *timer,
 }
 EXPORT_SYMBOL(init_timer_deferrable_key);
 
+/**
+ * timer_set_deferrable_on_suspend - defer this timer while early-suspended
+ * @timer: the timer to mark
+ *
+ * While the screen is off the timer no longer forces an idle CPU awake;
+ * it runs at the next wakeup after its expiry instead. Must be called on
+ * an initialized timer that is not pending, and the mark is kept across
+ * later mod_timer()/del_timer() cycles.
+ */
+void timer_set_deferrable_on_suspend(struct timer_list *timer)
+{
+	timer->base = ((struct tvec_base *)((unsigned long)(timer->base) |
+				       TBASE_SUSPEND_DEFER_FLAG));
+}
+EXPORT_SYMBOL_GPL(timer_set_deferrable_on_suspend);
+
 static inline void detach_timer(struct timer_list *timer,
 				int clear_pending)
 {
@@ -1126,7 +1162,9 @@ static unsigned long __next_timer_interrupt(struct tvec_base *base)
 	index = slot = timer_jiffies & TVR_MASK;
 	do {
 		list_for_each_entry(nte, base->tv1.vec + slot, entry) {
-			if (tbase_get_deferrable(nte->base))
+			if (tbase_get_deferrable(nte->base) ||
+			    (timer_suspend_defer_active &&
+			     tbase_get_suspend_defer(nte->base)))
 				continue;
 
 			found = 1;
@@ -1157,7 +1195,9 @@ cascade:
 		index = slot = timer_jiffies & TVN_MASK;
 		do {
 			list_for_each_entry(nte, varp->vec + slot, entry) {
-				if (tbase_get_deferrable(nte->base))
+				if (tbase_get_deferrable(nte->base) ||
+				    (timer_suspend_defer_active &&
+				     tbase_get_suspend_defer(nte->base)))
 					continue;
 
 				found = 1;
@@ -1244,9 +1284,18 @@ unsigned long get_next_timer_interrupt(unsigned long now)
 	if (cpu_is_offline(smp_processor_id()))
 		return now + NEXT_TIMER_MAX_DELTA;
 	spin_lock(&base->lock);
-	if (time_before_eq(base->next_timer, base->timer_jiffies))
-		base->next_timer = __next_timer_interrupt(base);
-	expires = base->next_timer;
+	if (timer_suspend_defer_active) {
+		/*
+		 * The scan skips suspend-deferrable timers, so its result
+		 * must not end up in the next_timer cache where it would
+		 * keep shortcutting those timers after we resume.
+		 */
+		expires = __next_timer_interrupt(base);
+	} else {
+		if (time_before_eq(base->next_timer, base->timer_jiffies))
+			base->next_timer = __next_timer_interrupt(base);
+		expires = base->next_timer;
+	}
 	spin_unlock(&base->lock);
 
 	if (time_before_eq(expires, now))
@@ -1254,6 +1303,41 @@ unsigned long get_next_timer_interrupt(unsigned long now)
 
 	return cmp_next_hrtimer_event(now, expires);
 }
+
+#ifdef CONFIG_HAS_EARLYSUSPEND
+static void timer_defer_nudge(void *unused)
+{
+	/*
+	 * Nothing to do here - the IPI alone makes the target CPU
+	 * re-evaluate its next timer wakeup on irq_exit().
+	 */
+}
+
+static void timer_defer_early_suspend(struct early_suspend *h)
+{
+	timer_suspend_defer_active = 1;
+}
+
+static void timer_defer_late_resume(struct early_suspend *h)
+{
+	timer_suspend_defer_active = 0;
+	/* Idle CPUs may be sleeping past a deferred timer - wake them */
+	on_each_cpu(timer_defer_nudge, NULL, 0);
+}
+
+static struct early_suspend timer_defer_suspend_handler = {
+	.level		= EARLY_SUSPEND_LEVEL_DISABLE_FB + 1,
+	.suspend	= timer_defer_early_suspend,
+	.resume		= timer_defer_late_resume,
+};
+
+static int __init timer_defer_init(void)
+{
+	register_early_suspend(&timer_defer_suspend_handler);
+	return 0;
+}
+late_initcall(timer_defer_init);
+#endif /* CONFIG_HAS_EARLYSUSPEND */
 #endif
 
 /*
@@ -1599,8 +1683,8 @@ static int __cpuinit init_timers_cpu(int cpu)
 			if (!base)
 				return -ENOMEM;
 
-			/* Make sure that tvec_base is 2 byte aligned */
-			if (tbase_get_deferrable(base)) {
+			/* Make sure tvec_base leaves the flag bits clear */
+			if ((unsigned long)base & TBASE_FLAG_MASK) {
 				WARN_ON(1);
 				kfree(base);
 				return -ENOMEM;
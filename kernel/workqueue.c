@@ -47,9 +47,22 @@ struct cpu_workqueue_struct {
 	struct list_head worklist;
 	wait_queue_head_t more_work;
 	struct work_struct *current_work;
+	unsigned long run_stamp;	/* when current_work started running */
 
 	struct workqueue_struct *wq;
 	struct task_struct *thread;
+
+	/*
+	 * Relief worker: a second thread, spawned on demand by the relief
+	 * manager the first time a queued item waits behind a slow one,
+	 * which then drains the queue whenever the primary thread stalls.
+	 */
+	struct task_struct *relief;
+	struct work_struct *relief_work; /* item the relief worker runs */
+	wait_queue_head_t relief_done;	/* relief finished an item */
+	struct list_head relief_entry;	/* on the relief manager's list */
+	int relief_pending;		/* handed to the relief manager */
+	int cpu;			/* bound cpu, -1 when unbound */
 } ____cacheline_aligned;
 
 /*
@@ -182,6 +195,16 @@ static inline void debug_work_deactivate(struct work_struct *work) { }
 static DEFINE_SPINLOCK(workqueue_lock);
 static LIST_HEAD(workqueues);
 
+/*
+ * A work item running for longer than this with others queued behind it
+ * is considered stalled and gets a relief worker.
+ */
+#define WQ_RELIEF_TIMEOUT	(HZ / 10)
+
+static DEFINE_SPINLOCK(relief_lock);
+static LIST_HEAD(relief_list);
+static DECLARE_WAIT_QUEUE_HEAD(relief_mgr_wait);
+
 static int singlethread_cpu __read_mostly;
 static const struct cpumask *cpu_singlethread_map __read_mostly;
 /*
@@ -260,6 +283,19 @@ static void insert_work(struct cpu_workqueue_struct *cwq,
 	wake_up(&cwq->more_work);
 }
 
+/*
+ * Hand the cwq to the relief manager, which can sleep to spawn a second
+ * worker thread for it.  Called with cwq->lock held.
+ */
+static void queue_relief(struct cpu_workqueue_struct *cwq)
+{
+	cwq->relief_pending = 1;
+	spin_lock(&relief_lock);
+	list_add_tail(&cwq->relief_entry, &relief_list);
+	spin_unlock(&relief_lock);
+	wake_up(&relief_mgr_wait);
+}
+
 static void __queue_work(struct cpu_workqueue_struct *cwq,
 			 struct work_struct *work)
 {
@@ -268,6 +304,17 @@ static void __queue_work(struct cpu_workqueue_struct *cwq,
 	debug_work_activate(work);
 	spin_lock_irqsave(&cwq->lock, flags);
 	insert_work(cwq, work, &cwq->worklist);
+	/*
+	 * If the thread has been stuck on one item for a while the new
+	 * work would wait behind it indefinitely; get it a relief worker.
+	 * Singlethread workqueues are exempt: their users rely on one
+	 * thread executing everything in queue order, so a second thread
+	 * is never allowed there.
+	 */
+	if (cwq->current_work && !cwq->relief && !cwq->relief_pending &&
+	    !is_wq_single_threaded(cwq->wq) &&
+	    time_after(jiffies, cwq->run_stamp + WQ_RELIEF_TIMEOUT))
+		queue_relief(cwq);
 	spin_unlock_irqrestore(&cwq->lock, flags);
 }
 
@@ -400,9 +447,22 @@ static void run_workqueue(struct cpu_workqueue_struct *cwq)
 		 */
 		struct lockdep_map lockdep_map = work->lockdep_map;
 #endif
+		/*
+		 * If the relief worker is still inside this work (it
+		 * requeued itself while running there), executing it
+		 * now would be reentrant; wait for it to retire first.
+		 */
+		if (unlikely(work == cwq->relief_work)) {
+			spin_unlock_irq(&cwq->lock);
+			wait_event(cwq->relief_done,
+				   cwq->relief_work != work);
+			spin_lock_irq(&cwq->lock);
+			continue;
+		}
 		trace_workqueue_execution(cwq->thread, work);
 		debug_work_deactivate(work);
 		cwq->current_work = work;
+		cwq->run_stamp = jiffies;
 		list_del_init(cwq->worklist.next);
 		spin_unlock_irq(&cwq->lock);
 
@@ -487,6 +547,137 @@ static void insert_wq_barrier(struct cpu_workqueue_struct *cwq,
 	insert_work(cwq, &barr->work, head);
 }
 
+/*
+ * Drain the queue on behalf of a stalled primary worker.  Stops as soon
+ * as the primary recovers, and never runs barriers: those must complete
+ * behind everything the primary runs, so they are left to it (the flush
+ * paths additionally wait for relief_work to retire, see below).
+ */
+static void run_relief(struct cpu_workqueue_struct *cwq)
+{
+	spin_lock_irq(&cwq->lock);
+	while (!list_empty(&cwq->worklist)) {
+		struct work_struct *work = list_entry(cwq->worklist.next,
+						struct work_struct, entry);
+		work_func_t f = work->func;
+#ifdef CONFIG_LOCKDEP
+		struct lockdep_map lockdep_map = work->lockdep_map;
+#endif
+		if (!cwq->current_work ||
+		    time_before(jiffies, cwq->run_stamp + WQ_RELIEF_TIMEOUT))
+			break;
+		if (f == wq_barrier_func)
+			break;
+		/*
+		 * A self-requeueing work can reach the head of the list
+		 * while the primary is still inside it; running it here
+		 * too would break per-item non-reentrancy.  It has to
+		 * wait for the primary anyway, so just stop draining.
+		 */
+		if (work == cwq->current_work)
+			break;
+
+		trace_workqueue_execution(cwq->relief, work);
+		debug_work_deactivate(work);
+		cwq->relief_work = work;
+		list_del_init(cwq->worklist.next);
+		spin_unlock_irq(&cwq->lock);
+
+		BUG_ON(get_wq_data(work) != cwq);
+		work_clear_pending(work);
+		lock_map_acquire(&cwq->wq->lockdep_map);
+		lock_map_acquire(&lockdep_map);
+		f(work);
+		lock_map_release(&lockdep_map);
+		lock_map_release(&cwq->wq->lockdep_map);
+
+		spin_lock_irq(&cwq->lock);
+		cwq->relief_work = NULL;
+		wake_up_all(&cwq->relief_done);
+	}
+	spin_unlock_irq(&cwq->lock);
+}
+
+static int relief_thread(void *__cwq)
+{
+	struct cpu_workqueue_struct *cwq = __cwq;
+	DEFINE_WAIT(wait);
+
+	if (cwq->wq->freezeable)
+		set_freezable();
+
+	for (;;) {
+		long timeout = MAX_SCHEDULE_TIMEOUT;
+
+		spin_lock_irq(&cwq->lock);
+		if (!list_empty(&cwq->worklist) && cwq->current_work)
+			timeout = WQ_RELIEF_TIMEOUT;
+		spin_unlock_irq(&cwq->lock);
+
+		prepare_to_wait(&cwq->more_work, &wait, TASK_INTERRUPTIBLE);
+		if (!freezing(current) && !kthread_should_stop())
+			schedule_timeout(timeout);
+		finish_wait(&cwq->more_work, &wait);
+
+		try_to_freeze();
+
+		if (kthread_should_stop())
+			break;
+
+		run_relief(cwq);
+	}
+
+	return 0;
+}
+
+/*
+ * The relief manager exists because the stall is detected in
+ * __queue_work() under a spinlock, where we cannot create a thread.
+ * It spawns one persistent relief worker per stalled cwq; the relief
+ * worker is torn down together with the primary thread.
+ */
+static int relief_manager_thread(void *unused)
+{
+	for (;;) {
+		struct cpu_workqueue_struct *cwq;
+		struct task_struct *p;
+
+		wait_event_interruptible(relief_mgr_wait,
+					 !list_empty(&relief_list));
+
+		spin_lock_irq(&relief_lock);
+		while (!list_empty(&relief_list)) {
+			cwq = list_first_entry(&relief_list,
+					       struct cpu_workqueue_struct,
+					       relief_entry);
+			list_del_init(&cwq->relief_entry);
+			spin_unlock_irq(&relief_lock);
+
+			p = kthread_create(relief_thread, cwq, "%s/R",
+					   cwq->wq->name);
+
+			spin_lock_irq(&cwq->lock);
+			if (!IS_ERR(p))
+				cwq->relief = p;
+			/* on failure, the next stalled queue_work retries */
+			cwq->relief_pending = 0;
+			spin_unlock_irq(&cwq->lock);
+			wake_up_all(&cwq->relief_done);
+
+			if (!IS_ERR(p)) {
+				if (cwq->cpu >= 0)
+					kthread_bind(p, cwq->cpu);
+				wake_up_process(p);
+			}
+
+			spin_lock_irq(&relief_lock);
+		}
+		spin_unlock_irq(&relief_lock);
+	}
+
+	return 0;
+}
+
 static int flush_cpu_workqueue(struct cpu_workqueue_struct *cwq)
 {
 	int active = 0;
@@ -495,7 +686,8 @@ static int flush_cpu_workqueue(struct cpu_workqueue_struct *cwq)
 	WARN_ON(cwq->thread == current);
 
 	spin_lock_irq(&cwq->lock);
-	if (!list_empty(&cwq->worklist) || cwq->current_work != NULL) {
+	if (!list_empty(&cwq->worklist) || cwq->current_work != NULL ||
+	    cwq->relief_work != NULL) {
 		insert_wq_barrier(cwq, &barr, &cwq->worklist);
 		active = 1;
 	}
@@ -504,6 +696,11 @@ static int flush_cpu_workqueue(struct cpu_workqueue_struct *cwq)
 	if (active) {
 		wait_for_completion(&barr.done);
 		destroy_work_on_stack(&barr.work);
+		/*
+		 * The barrier only orders against the primary worker;
+		 * also wait for whatever the relief worker had in flight.
+		 */
+		wait_event(cwq->relief_done, cwq->relief_work == NULL);
 	}
 
 	return active;
@@ -571,7 +768,7 @@ int flush_work(struct work_struct *work)
 			goto out;
 		prev = &work->entry;
 	} else {
-		if (cwq->current_work != work)
+		if (cwq->current_work != work && cwq->relief_work != work)
 			goto out;
 		prev = &cwq->worklist;
 	}
@@ -583,6 +780,7 @@ out:
 
 	wait_for_completion(&barr.done);
 	destroy_work_on_stack(&barr.work);
+	wait_event(cwq->relief_done, cwq->relief_work != work);
 	return 1;
 }
 EXPORT_SYMBOL_GPL(flush_work);
@@ -634,7 +832,7 @@ static void wait_on_cpu_work(struct cpu_workqueue_struct *cwq,
 	int running = 0;
 
 	spin_lock_irq(&cwq->lock);
-	if (unlikely(cwq->current_work == work)) {
+	if (unlikely(cwq->current_work == work || cwq->relief_work == work)) {
 		insert_wq_barrier(cwq, &barr, cwq->worklist.next);
 		running = 1;
 	}
@@ -643,6 +841,7 @@ static void wait_on_cpu_work(struct cpu_workqueue_struct *cwq,
 	if (unlikely(running)) {
 		wait_for_completion(&barr.done);
 		destroy_work_on_stack(&barr.work);
+		wait_event(cwq->relief_done, cwq->relief_work != work);
 	}
 }
 
@@ -941,6 +1140,8 @@ init_cpu_workqueue(struct workqueue_struct *wq, int cpu)
 	spin_lock_init(&cwq->lock);
 	INIT_LIST_HEAD(&cwq->worklist);
 	init_waitqueue_head(&cwq->more_work);
+	init_waitqueue_head(&cwq->relief_done);
+	INIT_LIST_HEAD(&cwq->relief_entry);
 
 	return cwq;
 }
@@ -976,6 +1177,7 @@ static void start_workqueue_thread(struct cpu_workqueue_struct *cwq, int cpu)
 {
 	struct task_struct *p = cwq->thread;
 
+	cwq->cpu = cpu;
 	if (p != NULL) {
 		if (cpu >= 0)
 			kthread_bind(p, cpu);
@@ -1076,6 +1278,24 @@ static void cleanup_workqueue_thread(struct cpu_workqueue_struct *cwq)
 	trace_workqueue_destruction(cwq->thread);
 	kthread_stop(cwq->thread);
 	cwq->thread = NULL;
+
+	/*
+	 * Take the cwq back from the relief manager.  If the manager
+	 * already took it off its list it may be mid-spawn, so wait for
+	 * relief_pending to clear before stopping whatever it created.
+	 */
+	spin_lock_irq(&relief_lock);
+	if (!list_empty(&cwq->relief_entry)) {
+		list_del_init(&cwq->relief_entry);
+		cwq->relief_pending = 0;
+	}
+	spin_unlock_irq(&relief_lock);
+	wait_event(cwq->relief_done, !cwq->relief_pending);
+
+	if (cwq->relief) {
+		kthread_stop(cwq->relief);
+		cwq->relief = NULL;
+	}
 }
 
 /**
@@ -1209,6 +1429,7 @@ void __init init_workqueues(void)
 	singlethread_cpu = cpumask_first(cpu_possible_mask);
 	cpu_singlethread_map = cpumask_of(singlethread_cpu);
 	hotcpu_notifier(workqueue_cpu_callback, 0);
+	BUG_ON(IS_ERR(kthread_run(relief_manager_thread, NULL, "kreliefd")));
 	keventd_wq = create_workqueue("events");
 	BUG_ON(!keventd_wq);
 }
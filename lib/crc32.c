@@ -26,8 +26,15 @@
 #include <linux/compiler.h>
 #include <linux/types.h>
 #include <linux/init.h>
+#include <linux/slab.h>
+#include <linux/ktime.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
 #include <asm/atomic.h>
 #include "crc32defs.h"
+#if CRC_LE_BITS == 8 && CRC_BE_BITS == 8
+# define CRC32_SLICE8
+#endif
 #if CRC_LE_BITS == 8
 # define tole(x) __constant_cpu_to_le32(x)
 #else
@@ -93,6 +100,82 @@ crc32_body(u32 crc, unsigned char const *buf, size_t len, const u32 (*tab)[256])
 #undef DO_CRC4
 }
 #endif
+
+#ifdef CRC32_SLICE8
+/*
+ * Rows 4-7 of the slice-by-8 tables, extended at boot from the
+ * compile-time rows 0-3 above (see crc32_variant_init()).  They are kept
+ * in the same tole()/tobe() byte order as the generated tables so the
+ * slice-by-8 loop can share the swapped-crc convention of crc32_body().
+ */
+static u32 crc32table_le_hi[4][256] __read_mostly;
+static u32 crc32table_be_hi[4][256] __read_mostly;
+
+/*
+ * Which inner loop crc32_le()/crc32_be() use: 0 = slice-by-4 (the
+ * crc32_body() above), 1 = slice-by-8.  Chosen by crc32_variant_init().
+ */
+static int crc32_slice8 __read_mostly;
+
+static inline u32
+crc32_body_slice8(u32 crc, unsigned char const *buf, size_t len,
+		  const u32 (*tab)[256], const u32 (*hi)[256])
+{
+# ifdef __LITTLE_ENDIAN
+#  define DO_CRC(x) crc = tab[0][(crc ^ (x)) & 255] ^ (crc >> 8)
+#  define DO_CRC4 (tab[3][(q) & 255] ^ \
+		tab[2][(q >> 8) & 255] ^ \
+		tab[1][(q >> 16) & 255] ^ \
+		tab[0][(q >> 24) & 255])
+#  define DO_CRC8 (hi[3][(q) & 255] ^ \
+		hi[2][(q >> 8) & 255] ^ \
+		hi[1][(q >> 16) & 255] ^ \
+		hi[0][(q >> 24) & 255])
+# else
+#  define DO_CRC(x) crc = tab[0][((crc >> 24) ^ (x)) & 255] ^ (crc << 8)
+#  define DO_CRC4 (tab[0][(q) & 255] ^ \
+		tab[1][(q >> 8) & 255] ^ \
+		tab[2][(q >> 16) & 255] ^ \
+		tab[3][(q >> 24) & 255])
+#  define DO_CRC8 (hi[0][(q) & 255] ^ \
+		hi[1][(q >> 8) & 255] ^ \
+		hi[2][(q >> 16) & 255] ^ \
+		hi[3][(q >> 24) & 255])
+# endif
+	const u32 *b;
+	size_t    rem_len;
+	u32       q;
+
+	/* Align it */
+	if (unlikely((long)buf & 3 && len)) {
+		do {
+			DO_CRC(*buf++);
+		} while ((--len) && ((long)buf)&3);
+	}
+	rem_len = len & 7;
+	/* load data 32 bits wide, xor data 32 bits wide. */
+	len = len >> 3;
+	b = (const u32 *)buf;
+	for (--b; len; --len) {
+		q = crc ^ *++b; /* use pre increment for speed */
+		crc = DO_CRC8;
+		q = *++b;
+		crc ^= DO_CRC4;
+	}
+	len = rem_len;
+	/* And the last few bytes */
+	if (len) {
+		u8 *p = (u8 *)(b + 1) - 1;
+		do {
+			DO_CRC(*++p); /* use pre increment for speed */
+		} while (--len);
+	}
+	return crc;
+#undef DO_CRC
+#undef DO_CRC4
+#undef DO_CRC8
+}
+#endif /* CRC32_SLICE8 */
 /**
  * crc32_le() - Calculate bitwise little-endian Ethernet AUTODIN II CRC32
  * @crc: seed value for computation.  ~0 for Ethernet, sometimes 0 for
@@ -126,7 +209,15 @@ u32 __pure crc32_le(u32 crc, unsigned char const *p, size_t len)
 	const u32      (*tab)[] = crc32table_le;
 
 	crc = __cpu_to_le32(crc);
+#  ifdef CRC32_SLICE8
+	if (crc32_slice8)
+		crc = crc32_body_slice8(crc, p, len, crc32table_le,
+					crc32table_le_hi);
+	else
+		crc = crc32_body(crc, p, len, tab);
+#  else
 	crc = crc32_body(crc, p, len, tab);
+#  endif
 	return __le32_to_cpu(crc);
 # elif CRC_LE_BITS == 4
 	while (len--) {
@@ -183,7 +274,15 @@ u32 __pure crc32_be(u32 crc, unsigned char const *p, size_t len)
 	const u32      (*tab)[] = crc32table_be;
 
 	crc = __cpu_to_be32(crc);
+#  ifdef CRC32_SLICE8
+	if (crc32_slice8)
+		crc = crc32_body_slice8(crc, p, len, crc32table_be,
+					crc32table_be_hi);
+	else
+		crc = crc32_body(crc, p, len, tab);
+#  else
 	crc = crc32_body(crc, p, len, tab);
+#  endif
 	return __be32_to_cpu(crc);
 # elif CRC_BE_BITS == 4
 	while (len--) {
@@ -208,6 +307,181 @@ u32 __pure crc32_be(u32 crc, unsigned char const *p, size_t len)
 EXPORT_SYMBOL(crc32_le);
 EXPORT_SYMBOL(crc32_be);
 
+#ifdef CRC32_SLICE8
+/*
+ * Boot-time variant selection.
+ *
+ * Slice-by-8 halves the table lookups per byte, but doubles the table
+ * footprint to 8KB per byte order, so on cores with small data caches it
+ * can lose to slice-by-4.  Rather than guess per machine, time both
+ * loops over a page of data at boot, sanity-check that they agree, and
+ * keep the faster one.  /proc/crc32 reports the outcome.
+ */
+#define CRC32_BENCH_LEN		4096
+#define CRC32_BENCH_PASSES	16
+#define CRC32_BENCH_TRIALS	3
+
+static s64 crc32_bench_ns[2];	/* [0] = slice-by-4, [1] = slice-by-8 */
+static u32 crc32_bench_sink;	/* keeps the __pure calls from being elided */
+
+/*
+ * Extend the compile-time tables by four more rows using the same
+ * recurrence gen_crc32table.c uses, undoing/redoing the tole()/tobe()
+ * byte order around the arithmetic (a no-op on the matching endianness).
+ */
+static void __init crc32_init_hi_tables(void)
+{
+	unsigned i, j;
+	u32 crc;
+
+	for (i = 0; i < 256; i++) {
+		crc = __le32_to_cpu(crc32table_le[3][i]);
+		for (j = 0; j < 4; j++) {
+			crc = __le32_to_cpu(crc32table_le[0][crc & 0xff]) ^
+			      (crc >> 8);
+			crc32table_le_hi[j][i] = __cpu_to_le32(crc);
+		}
+
+		crc = __be32_to_cpu(crc32table_be[3][i]);
+		for (j = 0; j < 4; j++) {
+			crc = __be32_to_cpu(crc32table_be[0][crc >> 24]) ^
+			      (crc << 8);
+			crc32table_be_hi[j][i] = __cpu_to_be32(crc);
+		}
+	}
+}
+
+/*
+ * Check slice-by-8 against the known CRC of "123456789" and against
+ * slice-by-4 over the benchmark buffer at every byte alignment.
+ */
+static int __init crc32_selftest(const unsigned char *buf)
+{
+	static const unsigned char check[] = "123456789";
+	u32 old, new;
+	unsigned i;
+
+	crc32_slice8 = 1;
+	new = crc32_le(~0, check, 9) ^ ~0;
+	crc32_slice8 = 0;
+	if (new != 0xcbf43926)
+		return -EINVAL;
+
+	for (i = 0; i < 8; i++) {
+		size_t len = CRC32_BENCH_LEN - i;
+
+		old = crc32_le(~0, buf + i, len);
+		crc32_slice8 = 1;
+		new = crc32_le(~0, buf + i, len);
+		crc32_slice8 = 0;
+		if (new != old)
+			return -EINVAL;
+
+		old = crc32_be(~0, buf + i, len);
+		crc32_slice8 = 1;
+		new = crc32_be(~0, buf + i, len);
+		crc32_slice8 = 0;
+		if (new != old)
+			return -EINVAL;
+	}
+	return 0;
+}
+
+static s64 __init crc32_time_variant(int slice8, const unsigned char *buf)
+{
+	s64 best = LLONG_MAX;
+	unsigned trial, pass;
+
+	crc32_slice8 = slice8;
+	for (trial = 0; trial < CRC32_BENCH_TRIALS; trial++) {
+		unsigned long flags;
+		ktime_t start;
+		u32 crc = ~0;
+		s64 ns;
+
+		local_irq_save(flags);
+		start = ktime_get();
+		for (pass = 0; pass < CRC32_BENCH_PASSES; pass++)
+			crc = crc32_le(crc, buf, CRC32_BENCH_LEN);
+		ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+		local_irq_restore(flags);
+
+		crc32_bench_sink ^= crc;
+		if (ns < best)
+			best = ns;
+	}
+	crc32_slice8 = 0;
+	return best;
+}
+
+#ifdef CONFIG_PROC_FS
+static int crc32_proc_show(struct seq_file *m, void *v)
+{
+	seq_printf(m, "variant: slice-by-%d\n", crc32_slice8 ? 8 : 4);
+	seq_printf(m, "slice-by-4: %lld ns\n", crc32_bench_ns[0]);
+	seq_printf(m, "slice-by-8: %lld ns\n", crc32_bench_ns[1]);
+	seq_printf(m, "benchmark: %d passes of %d bytes\n",
+		   CRC32_BENCH_PASSES, CRC32_BENCH_LEN);
+	return 0;
+}
+
+static int crc32_proc_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, crc32_proc_show, NULL);
+}
+
+static const struct file_operations crc32_proc_fops = {
+	.open		= crc32_proc_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+#endif /* CONFIG_PROC_FS */
+
+static int __init crc32_variant_init(void)
+{
+	unsigned char *buf;
+	unsigned i;
+
+	crc32_init_hi_tables();
+
+	buf = kmalloc(CRC32_BENCH_LEN + 8, GFP_KERNEL);
+	if (!buf)
+		return 0;	/* keep the slice-by-4 default */
+
+	for (i = 0; i < CRC32_BENCH_LEN + 8; i++)
+		buf[i] = i * 29 + (i >> 5);
+
+	if (crc32_selftest(buf)) {
+		printk(KERN_WARNING
+		       "crc32: slice-by-8 self-test failed, using slice-by-4\n");
+	} else {
+		crc32_bench_ns[0] = crc32_time_variant(0, buf);
+		crc32_bench_ns[1] = crc32_time_variant(1, buf);
+		crc32_slice8 = crc32_bench_ns[1] < crc32_bench_ns[0];
+		printk(KERN_INFO
+		       "crc32: using slice-by-%d (%lld ns vs %lld ns)\n",
+		       crc32_slice8 ? 8 : 4,
+		       crc32_bench_ns[crc32_slice8], crc32_bench_ns[!crc32_slice8]);
+	}
+	kfree(buf);
+
+#ifdef CONFIG_PROC_FS
+	proc_create("crc32", 0, NULL, &crc32_proc_fops);
+#endif
+	return 0;
+}
+late_initcall(crc32_variant_init);
+
+static void __exit crc32_variant_exit(void)
+{
+#ifdef CONFIG_PROC_FS
+	remove_proc_entry("crc32", NULL);
+#endif
+}
+module_exit(crc32_variant_exit);
+#endif /* CRC32_SLICE8 */
+
 /*
  * A brief CRC tutorial.
  *
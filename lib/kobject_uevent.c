@@ -20,6 +20,7 @@
 #include <linux/module.h>
 #include <linux/slab.h>
 #include <linux/user_namespace.h>
+#include <linux/workqueue.h>
 #include <linux/socket.h>
 #include <linux/skbuff.h>
 #include <linux/netlink.h>
@@ -116,6 +117,114 @@ static int kobj_usermode_filter(struct kobject *kobj)
 	return 0;
 }
 
+#ifdef CONFIG_UEVENT_BATCH
+/*
+ * Batched delivery: in addition to the one-datagram-per-event broadcast
+ * on group 1, events are coalesced for a short window and broadcast on
+ * group 2 as one datagram holding several records.  Each record is
+ * introduced by a "UEVENT=<length>\0" string giving the byte count of
+ * the record that follows; the record itself has the usual
+ * "<action>@<devpath>\0VAR=value\0..." layout.  A listener that binds
+ * group 2 instead of group 1 takes one wakeup per window instead of
+ * one per event; listeners on group 1 see no difference.
+ */
+#define UEVENT_BATCH_GROUP	2
+#define UEVENT_BATCH_BUF_SIZE	4096
+#define UEVENT_BATCH_DELAY	(HZ / 50)
+
+static char uevent_batch_buf[UEVENT_BATCH_BUF_SIZE];
+static size_t uevent_batch_len;
+static DEFINE_SPINLOCK(uevent_batch_lock);
+
+static void uevent_batch_flush(struct work_struct *work)
+{
+	struct uevent_sock *ue_sk;
+	struct sk_buff *skb;
+	size_t len;
+
+	skb = alloc_skb(UEVENT_BATCH_BUF_SIZE, GFP_KERNEL);
+	if (!skb)
+		return;
+
+	spin_lock(&uevent_batch_lock);
+	len = uevent_batch_len;
+	if (len)
+		memcpy(skb_put(skb, len), uevent_batch_buf, len);
+	uevent_batch_len = 0;
+	spin_unlock(&uevent_batch_lock);
+
+	if (!len) {
+		kfree_skb(skb);
+		return;
+	}
+
+	NETLINK_CB(skb).dst_group = UEVENT_BATCH_GROUP;
+	mutex_lock(&uevent_sock_mutex);
+	list_for_each_entry(ue_sk, &uevent_sock_list, list) {
+		if (sock_net(ue_sk->sk) != &init_net)
+			continue;
+		/* netlink_broadcast consumes the skb */
+		netlink_broadcast(ue_sk->sk, skb, 0, UEVENT_BATCH_GROUP,
+				  GFP_KERNEL);
+		skb = NULL;
+		break;
+	}
+	mutex_unlock(&uevent_sock_mutex);
+	if (skb)
+		kfree_skb(skb);
+}
+
+static DECLARE_DELAYED_WORK(uevent_batch_work, uevent_batch_flush);
+
+static void uevent_batch_queue(const char *action_string,
+			       const char *devpath,
+			       struct kobj_uevent_env *env)
+{
+	char header[32];
+	size_t rec_len;
+	size_t hdr_len;
+	size_t len;
+	int i;
+
+	rec_len = strlen(action_string) + strlen(devpath) + 2;
+	for (i = 0; i < env->envp_idx; i++)
+		rec_len += strlen(env->envp[i]) + 1;
+	hdr_len = scnprintf(header, sizeof(header),
+			    "UEVENT=%zu", rec_len) + 1;
+
+	/* an oversized event stays on the per-event path only */
+	if (hdr_len + rec_len > UEVENT_BATCH_BUF_SIZE)
+		return;
+
+	spin_lock(&uevent_batch_lock);
+	if (uevent_batch_len + hdr_len + rec_len > UEVENT_BATCH_BUF_SIZE) {
+		/* buffer full: push out what is queued and retry */
+		spin_unlock(&uevent_batch_lock);
+		uevent_batch_flush(NULL);
+		spin_lock(&uevent_batch_lock);
+		if (uevent_batch_len + hdr_len + rec_len >
+				UEVENT_BATCH_BUF_SIZE) {
+			spin_unlock(&uevent_batch_lock);
+			return;
+		}
+	}
+
+	len = uevent_batch_len;
+	memcpy(uevent_batch_buf + len, header, hdr_len);
+	len += hdr_len;
+	len += sprintf(uevent_batch_buf + len, "%s@%s",
+		       action_string, devpath) + 1;
+	for (i = 0; i < env->envp_idx; i++) {
+		strcpy(uevent_batch_buf + len, env->envp[i]);
+		len += strlen(env->envp[i]) + 1;
+	}
+	uevent_batch_len = len;
+	spin_unlock(&uevent_batch_lock);
+
+	schedule_delayed_work(&uevent_batch_work, UEVENT_BATCH_DELAY);
+}
+#endif /* CONFIG_UEVENT_BATCH */
+
 /**
  * kobject_uevent_env - send an uevent with environmental data
  *
@@ -288,6 +397,14 @@ int kobject_uevent_env(struct kobject *kobj, enum kobject_action action,
 			retval = -ENOMEM;
 	}
 	mutex_unlock(&uevent_sock_mutex);
+
+#ifdef CONFIG_UEVENT_BATCH
+	/* namespaced kobjects need the per-socket filter above, which a
+	 * stored batch cannot replay; they stay on the per-event path
+	 */
+	if (!kobj_ns_ops(kobj))
+		uevent_batch_queue(action_string, devpath, env);
+#endif
 #endif
 
 	/* call uevent_helper, usually only enabled during early boot */
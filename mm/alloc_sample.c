@@ -0,0 +1,136 @@
+/*
+ * mm/alloc_sample.c
+ *
+ * Sampled allocation origin tracking.
+ *
+ * Full allocation tracing (kmemleak, SLAB_STORE_USER) is too expensive
+ * for production builds, but attributing slow kernel memory growth in
+ * the field only needs a statistical picture. This records the call
+ * site and size of every Nth slab and page allocation into a small
+ * fixed hash table, readable and resettable through debugfs. With the
+ * default interval of 0 the hooks cost one compare per allocation.
+ */
+
+#include <linux/alloc_sample.h>
+#include <linux/debugfs.h>
+#include <linux/hash.h>
+#include <linux/module.h>
+#include <linux/percpu.h>
+#include <linux/seq_file.h>
+#include <linux/spinlock.h>
+#include <linux/string.h>
+
+/*
+ * Sample every Nth allocation; 0 disables sampling. Settable at boot
+ * (alloc_sample.interval=N) or at run time through
+ * /sys/module/alloc_sample/parameters/interval.
+ */
+static unsigned int alloc_sample_interval;
+module_param_named(interval, alloc_sample_interval, uint, S_IWUSR | S_IRUGO);
+
+#define ALLOC_SAMPLE_HASH_BITS	9
+#define ALLOC_SAMPLE_HASH_SIZE	(1 << ALLOC_SAMPLE_HASH_BITS)
+#define ALLOC_SAMPLE_PROBES	8
+
+struct alloc_sample_site {
+	unsigned long call_site;
+	unsigned long count;	/* samples, not allocations */
+	unsigned long bytes;	/* sum of sampled sizes */
+};
+
+static struct alloc_sample_site alloc_sample_hash[ALLOC_SAMPLE_HASH_SIZE];
+static unsigned long alloc_sample_drops;
+static DEFINE_SPINLOCK(alloc_sample_lock);
+static DEFINE_PER_CPU(unsigned int, alloc_sample_skip);
+
+void alloc_sample(unsigned long call_site, size_t size)
+{
+	struct alloc_sample_site *site;
+	unsigned int *skip;
+	unsigned long flags;
+	unsigned long hash;
+	int i;
+
+	if (likely(!alloc_sample_interval))
+		return;
+
+	skip = &get_cpu_var(alloc_sample_skip);
+	if (++*skip < alloc_sample_interval) {
+		put_cpu_var(alloc_sample_skip);
+		return;
+	}
+	*skip = 0;
+	put_cpu_var(alloc_sample_skip);
+
+	hash = hash_long(call_site, ALLOC_SAMPLE_HASH_BITS);
+	spin_lock_irqsave(&alloc_sample_lock, flags);
+	for (i = 0; i < ALLOC_SAMPLE_PROBES; i++) {
+		site = &alloc_sample_hash[(hash + i) &
+					  (ALLOC_SAMPLE_HASH_SIZE - 1)];
+		if (site->call_site == call_site || !site->call_site) {
+			site->call_site = call_site;
+			site->count++;
+			site->bytes += size;
+			goto out;
+		}
+	}
+	alloc_sample_drops++;
+out:
+	spin_unlock_irqrestore(&alloc_sample_lock, flags);
+}
+
+static int alloc_sample_show(struct seq_file *m, void *unused)
+{
+	struct alloc_sample_site site;
+	unsigned long flags;
+	int i;
+
+	seq_printf(m, "interval: %u  drops: %lu\n",
+		   alloc_sample_interval, alloc_sample_drops);
+	seq_puts(m, "samples\tbytes\tcall_site\n");
+	for (i = 0; i < ALLOC_SAMPLE_HASH_SIZE; i++) {
+		spin_lock_irqsave(&alloc_sample_lock, flags);
+		site = alloc_sample_hash[i];
+		spin_unlock_irqrestore(&alloc_sample_lock, flags);
+		if (!site.call_site)
+			continue;
+		seq_printf(m, "%lu\t%lu\t%pS\n", site.count, site.bytes,
+			   (void *)site.call_site);
+	}
+	return 0;
+}
+
+static int alloc_sample_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, alloc_sample_show, NULL);
+}
+
+/* any write clears the table so a new growth window can be measured */
+static ssize_t alloc_sample_write(struct file *file, const char __user *buf,
+				  size_t count, loff_t *ppos)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&alloc_sample_lock, flags);
+	memset(alloc_sample_hash, 0, sizeof(alloc_sample_hash));
+	alloc_sample_drops = 0;
+	spin_unlock_irqrestore(&alloc_sample_lock, flags);
+	return count;
+}
+
+static const struct file_operations alloc_sample_fops = {
+	.owner		= THIS_MODULE,
+	.open		= alloc_sample_open,
+	.read		= seq_read,
+	.write		= alloc_sample_write,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+static int __init alloc_sample_init(void)
+{
+	debugfs_create_file("alloc_sample", S_IRUGO | S_IWUSR, NULL, NULL,
+			    &alloc_sample_fops);
+	return 0;
+}
+late_initcall(alloc_sample_init);
@@ -26,8 +26,10 @@
 #include <linux/uaccess.h>
 #include <linux/personality.h>
 #include <linux/bitops.h>
+#include <linux/rbtree.h>
 #include <linux/mutex.h>
 #include <linux/shmem_fs.h>
+#include <linux/pagemap.h>
 #include <linux/ashmem.h>
 #include <asm/cacheflush.h>
 
@@ -43,7 +45,7 @@
  */
 struct ashmem_area {
 	char name[ASHMEM_FULL_NAME_LEN];/* optional name for /proc/pid/maps */
-	struct list_head unpinned_list;	/* list of all ashmem areas */
+	struct rb_root unpinned_tree;	/* unpinned ranges, by pgstart */
 	struct file *file;		/* the shmem-based backing file */
 	size_t size;			/* size of the mapping, in bytes */
 	unsigned long vm_start;		/* Start address of vm_area
@@ -58,7 +60,7 @@ struct ashmem_area {
  */
 struct ashmem_range {
 	struct list_head lru;		/* entry in LRU list */
-	struct list_head unpinned;	/* entry in its area's unpinned list */
+	struct rb_node unpinned;	/* node in its area's unpinned tree */
 	struct ashmem_area *asma;	/* associated area */
 	size_t pgstart;			/* starting page, inclusive */
 	size_t pgend;			/* ending page, inclusive */
@@ -71,6 +73,12 @@ static LIST_HEAD(ashmem_lru_list);
 /* Count of pages on our LRU list, protected by ashmem_mutex */
 static unsigned long lru_count;
 
+/*
+ * Pages vmscan wanted to swap but skipped because they are discardable.
+ * Reported to shrink_slab() as extra pressure so we purge them instead.
+ */
+static atomic_t discard_pressure;
+
 /*
  * ashmem_mutex - protects the list of and each individual ashmem_area
  *
@@ -100,8 +108,6 @@ static struct kmem_cache *ashmem_range_cachep __read_mostly;
   (page_in_range(range, start) || page_in_range(range, end) || \
    page_range_subsumes_range(range, start, end))
 
-#define range_before_page(range, page) \
-  ((range)->pgend < (page))
 
 #define PROT_MASK		(PROT_EXEC | PROT_READ | PROT_WRITE)
 
@@ -117,19 +123,79 @@ static inline void lru_del(struct ashmem_range *range)
 	lru_count -= range_size(range);
 }
 
+/*
+ * range_tree_insert - link a range into its area's tree of unpinned ranges
+ *
+ * Ranges in the tree are disjoint and ordered by pgstart.
+ *
+ * Caller must hold ashmem_mutex.
+ */
+static void range_tree_insert(struct ashmem_area *asma,
+			      struct ashmem_range *range)
+{
+	struct rb_node **p = &asma->unpinned_tree.rb_node;
+	struct rb_node *parent = NULL;
+
+	while (*p) {
+		struct ashmem_range *tmp;
+
+		parent = *p;
+		tmp = rb_entry(parent, struct ashmem_range, unpinned);
+		if (range->pgstart < tmp->pgstart)
+			p = &parent->rb_left;
+		else
+			p = &parent->rb_right;
+	}
+	rb_link_node(&range->unpinned, parent, p);
+	rb_insert_color(&range->unpinned, &asma->unpinned_tree);
+}
+
+/*
+ * range_tree_first_from - find the lowest range ending at or after 'page'
+ *
+ * Because the ranges are disjoint, pgstart order is also pgend order, so
+ * this is the first candidate for any overlap query starting at 'page'.
+ * Returns NULL if every range ends below 'page'.
+ *
+ * Caller must hold ashmem_mutex.
+ */
+static struct ashmem_range *range_tree_first_from(struct ashmem_area *asma,
+						  size_t page)
+{
+	struct rb_node *n = asma->unpinned_tree.rb_node;
+	struct ashmem_range *found = NULL;
+
+	while (n) {
+		struct ashmem_range *range =
+			rb_entry(n, struct ashmem_range, unpinned);
+
+		if (range->pgend >= page) {
+			found = range;
+			n = n->rb_left;
+		} else
+			n = n->rb_right;
+	}
+	return found;
+}
+
+static struct ashmem_range *range_tree_next(struct ashmem_range *range)
+{
+	struct rb_node *n = rb_next(&range->unpinned);
+
+	return n ? rb_entry(n, struct ashmem_range, unpinned) : NULL;
+}
+
 /*
  * range_alloc - allocate and initialize a new ashmem_range structure
  *
  * 'asma' - associated ashmem_area
- * 'prev_range' - the previous ashmem_range in the sorted asma->unpinned list
  * 'purged' - initial purge value (ASMEM_NOT_PURGED or ASHMEM_WAS_PURGED)
  * 'start' - starting page, inclusive
  * 'end' - ending page, inclusive
  *
  * Caller must hold ashmem_mutex.
  */
-static int range_alloc(struct ashmem_area *asma,
-		       struct ashmem_range *prev_range, unsigned int purged,
+static int range_alloc(struct ashmem_area *asma, unsigned int purged,
 		       size_t start, size_t end)
 {
 	struct ashmem_range *range;
@@ -143,7 +209,7 @@ static int range_alloc(struct ashmem_area *asma,
 	range->pgend = end;
 	range->purged = purged;
 
-	list_add_tail(&range->unpinned, &prev_range->unpinned);
+	range_tree_insert(asma, range);
 
 	if (range_on_lru(range))
 		lru_add(range);
@@ -153,7 +219,7 @@ static int range_alloc(struct ashmem_area *asma,
 
 static void range_del(struct ashmem_range *range)
 {
-	list_del(&range->unpinned);
+	rb_erase(&range->unpinned, &range->asma->unpinned_tree);
 	if (range_on_lru(range))
 		lru_del(range);
 	kmem_cache_free(ashmem_range_cachep, range);
@@ -189,7 +255,7 @@ static int ashmem_open(struct inode *inode, struct file *file)
 	if (unlikely(!asma))
 		return -ENOMEM;
 
-	INIT_LIST_HEAD(&asma->unpinned_list);
+	asma->unpinned_tree = RB_ROOT;
 	memcpy(asma->name, ASHMEM_NAME_PREFIX, ASHMEM_NAME_PREFIX_LEN);
 	asma->prot_mask = PROT_MASK;
 	file->private_data = asma;
@@ -200,11 +266,11 @@ static int ashmem_open(struct inode *inode, struct file *file)
 static int ashmem_release(struct inode *ignored, struct file *file)
 {
 	struct ashmem_area *asma = file->private_data;
-	struct ashmem_range *range, *next;
+	struct rb_node *n;
 
 	mutex_lock(&ashmem_mutex);
-	list_for_each_entry_safe(range, next, &asma->unpinned_list, unpinned)
-		range_del(range);
+	while ((n = rb_first(&asma->unpinned_tree)))
+		range_del(rb_entry(n, struct ashmem_range, unpinned));
 	mutex_unlock(&ashmem_mutex);
 
 	if (asma->file)
@@ -317,6 +383,8 @@ static int ashmem_mmap(struct file *file, struct vm_area_struct *vma)
 			ret = PTR_ERR(vmfile);
 			goto out;
 		}
+		/* swapping our pages is wasted I/O; we purge them instead */
+		mapping_set_discardable(vmfile->f_mapping);
 		asma->file = vmfile;
 	}
 	get_file(asma->file);
@@ -336,6 +404,19 @@ out:
 	return ret;
 }
 
+/*
+ * ashmem_discard_notify - vmscan found a discardable page it won't swap
+ *
+ * Called from shmem_writepage() under page lock, so we may not take
+ * ashmem_mutex or purge anything here.  Just remember the pressure;
+ * ashmem_shrink() folds it into the count it reports to shrink_slab(),
+ * which runs later in the same reclaim pass and purges LRU ranges.
+ */
+void ashmem_discard_notify(void)
+{
+	atomic_inc(&discard_pressure);
+}
+
 /*
  * ashmem_shrink - our cache shrinker, called from mm/vmscan.c :: shrink_slab
  *
@@ -359,7 +440,7 @@ static int ashmem_shrink(struct shrinker *s, int nr_to_scan, gfp_t gfp_mask)
 	if (nr_to_scan && !(gfp_mask & __GFP_FS))
 		return -1;
 	if (!nr_to_scan)
-		return lru_count;
+		return lru_count + atomic_xchg(&discard_pressure, 0);
 
 	mutex_lock(&ashmem_mutex);
 	list_for_each_entry_safe(range, next, &ashmem_lru_list, lru) {
@@ -468,10 +549,9 @@ static int ashmem_pin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 	struct ashmem_range *range, *next;
 	int ret = ASHMEM_NOT_PURGED;
 
-	list_for_each_entry_safe(range, next, &asma->unpinned_list, unpinned) {
-		/* moved past last applicable page; we can short circuit */
-		if (range_before_page(range, pgstart))
-			break;
+	range = range_tree_first_from(asma, pgstart);
+	while (range && range->pgstart <= pgend) {
+		next = range_tree_next(range);
 
 		/*
 		 * The user can ask us to pin pages that span multiple ranges,
@@ -488,37 +568,30 @@ static int ashmem_pin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 		 *    so we have to update one side of the range and then
 		 *    create a new range for the other side.
 		 */
-		if (page_range_in_range(range, pgstart, pgend)) {
-			ret |= range->purged;
-
-			/* Case #1: Easy. Just nuke the whole thing. */
-			if (page_range_subsumes_range(range, pgstart, pgend)) {
-				range_del(range);
-				continue;
-			}
+		ret |= range->purged;
 
+		/* Case #1: Easy. Just nuke the whole thing. */
+		if (page_range_subsumes_range(range, pgstart, pgend)) {
+			range_del(range);
+		} else if (range->pgstart >= pgstart) {
 			/* Case #2: We overlap from the start, so adjust it */
-			if (range->pgstart >= pgstart) {
-				range_shrink(range, pgend + 1, range->pgend);
-				continue;
-			}
-
+			range_shrink(range, pgend + 1, range->pgend);
+		} else if (range->pgend <= pgend) {
 			/* Case #3: We overlap from the rear, so adjust it */
-			if (range->pgend <= pgend) {
-				range_shrink(range, range->pgstart, pgstart-1);
-				continue;
-			}
-
+			range_shrink(range, range->pgstart, pgstart - 1);
+		} else {
 			/*
 			 * Case #4: We eat a chunk out of the middle. A bit
 			 * more complicated, we allocate a new range for the
 			 * second half and adjust the first chunk's endpoint.
 			 */
-			range_alloc(asma, range, range->purged,
+			range_alloc(asma, range->purged,
 				    pgend + 1, range->pgend);
 			range_shrink(range, range->pgstart, pgstart - 1);
 			break;
 		}
+
+		range = next;
 	}
 
 	return ret;
@@ -534,11 +607,9 @@ static int ashmem_unpin(struct ashmem_area *asma, size_t pgstart, size_t pgend)
 	struct ashmem_range *range, *next;
 	unsigned int purged = ASHMEM_NOT_PURGED;
 
-restart:
-	list_for_each_entry_safe(range, next, &asma->unpinned_list, unpinned) {
-		/* short circuit: this is our insertion point */
-		if (range_before_page(range, pgstart))
-			break;
+	range = range_tree_first_from(asma, pgstart);
+	while (range && range->pgstart <= pgend) {
+		next = range_tree_next(range);
 
 		/*
 		 * The user can ask us to unpin pages that are already entirely
@@ -546,16 +617,21 @@ restart:
 		 */
 		if (page_range_subsumed_by_range(range, pgstart, pgend))
 			return 0;
-		if (page_range_in_range(range, pgstart, pgend)) {
-			pgstart = min_t(size_t, range->pgstart, pgstart),
-			pgend = max_t(size_t, range->pgend, pgend);
-			purged |= range->purged;
-			range_del(range);
-			goto restart;
-		}
+
+		/*
+		 * Absorb any overlapping or adjacent unpinned range into the
+		 * request and carry on; because the tree is disjoint a single
+		 * left-to-right pass sees every overlap.
+		 */
+		pgstart = min_t(size_t, range->pgstart, pgstart);
+		pgend = max_t(size_t, range->pgend, pgend);
+		purged |= range->purged;
+		range_del(range);
+
+		range = next;
 	}
 
-	return range_alloc(asma, range, purged, pgstart, pgend);
+	return range_alloc(asma, purged, pgstart, pgend);
 }
 
 /*
@@ -570,14 +646,9 @@ static int ashmem_get_pin_status(struct ashmem_area *asma, size_t pgstart,
 	struct ashmem_range *range;
 	int ret = ASHMEM_IS_PINNED;
 
-	list_for_each_entry(range, &asma->unpinned_list, unpinned) {
-		if (range_before_page(range, pgstart))
-			break;
-		if (page_range_in_range(range, pgstart, pgend)) {
-			ret = ASHMEM_IS_UNPINNED;
-			break;
-		}
-	}
+	range = range_tree_first_from(asma, pgstart);
+	if (range && range->pgstart <= pgend)
+		ret = ASHMEM_IS_UNPINNED;
 
 	return ret;
 }
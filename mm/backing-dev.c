@@ -9,6 +9,7 @@
 #include <linux/sched.h>
 #include <linux/module.h>
 #include <linux/writeback.h>
+#include <linux/vmstat.h>
 #include <linux/device.h>
 
 static atomic_long_t bdi_seq = ATOMIC_LONG_INIT(0);
@@ -792,6 +793,10 @@ long congestion_wait(int sync, long timeout)
 	prepare_to_wait(wqh, &wait, TASK_UNINTERRUPTIBLE);
 	ret = io_schedule_timeout(timeout);
 	finish_wait(wqh, &wait);
+
+	count_vm_stall(CONGESTION_WAIT_LAT,
+			(s64)jiffies_to_usecs(timeout - ret));
+
 	return ret;
 }
 EXPORT_SYMBOL(congestion_wait);
@@ -14,6 +14,8 @@
 #include <linux/backing-dev.h>
 #include <linux/sysctl.h>
 #include <linux/sysfs.h>
+#include <linux/kthread.h>
+#include <linux/freezer.h>
 #include "internal.h"
 
 /*
@@ -562,6 +564,121 @@ static int compact_nodes(void)
 	return COMPACT_COMPLETE;
 }
 
+/*
+ * Background compaction. Memory pressure notifiers (currently the
+ * lowmemorykiller shrinker) call wake_compaction() when free memory dips
+ * below their watermarks. A kernel thread then pre-produces high-order
+ * free pages while the system is merely low on memory, instead of
+ * leaving all the work to direct compaction at allocation time, which
+ * stalls the allocator for the whole compaction run.
+ */
+
+/* Order that background compaction tries to keep available */
+#define COMPACT_BACKGROUND_ORDER (PAGE_ALLOC_COSTLY_ORDER + 1)
+
+/* Minimum interval between background compaction passes */
+#define COMPACT_BACKGROUND_INTERVAL (5 * HZ)
+
+static struct task_struct *kcompactd_task;
+static DECLARE_WAIT_QUEUE_HEAD(kcompactd_wait);
+static int kcompactd_wakeup;
+static unsigned long kcompactd_next_run;
+
+/*
+ * Decide whether a zone is worth a background pass: enough order-0
+ * pages for migration to make progress, no suitable high-order page
+ * already free, and the shortage due to fragmentation rather than
+ * plain lack of memory. Mirrors the checks in try_to_compact_pages().
+ */
+static int should_compact_zone_background(struct zone *zone)
+{
+	unsigned long watermark;
+	int fragindex;
+
+	watermark = low_wmark_pages(zone) + (2UL << COMPACT_BACKGROUND_ORDER);
+	if (!zone_watermark_ok(zone, 0, watermark, 0, 0))
+		return 0;
+
+	if (zone_watermark_ok(zone, COMPACT_BACKGROUND_ORDER,
+					low_wmark_pages(zone), 0, 0))
+		return 0;
+
+	fragindex = fragmentation_index(zone, COMPACT_BACKGROUND_ORDER);
+	if (fragindex >= 0 && fragindex <= sysctl_extfrag_threshold)
+		return 0;
+
+	return 1;
+}
+
+static int kcompactd(void *p)
+{
+	set_freezable();
+
+	for ( ; ; ) {
+		int nid;
+
+		wait_event_freezable(kcompactd_wait,
+				kcompactd_wakeup || kthread_should_stop());
+		if (kthread_should_stop())
+			break;
+		kcompactd_wakeup = 0;
+
+		/* Flush pending updates to the LRU lists */
+		lru_add_drain_all();
+
+		for_each_online_node(nid) {
+			pg_data_t *pgdat = NODE_DATA(nid);
+			int zoneid;
+
+			for (zoneid = 0; zoneid < MAX_NR_ZONES; zoneid++) {
+				struct zone *zone = &pgdat->node_zones[zoneid];
+
+				if (!populated_zone(zone))
+					continue;
+				if (!should_compact_zone_background(zone))
+					continue;
+
+				compact_zone_order(zone,
+						COMPACT_BACKGROUND_ORDER,
+						GFP_KERNEL);
+			}
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Kick the background compaction thread. Callers may run from atomic
+ * context (shrinkers, allocator slow path); all the work happens in
+ * kcompactd. Wakeups are rate-limited so a burst of shrinker calls
+ * results in a single pass.
+ */
+void wake_compaction(void)
+{
+	if (!kcompactd_task)
+		return;
+
+	if (time_before(jiffies, kcompactd_next_run))
+		return;
+	kcompactd_next_run = jiffies + COMPACT_BACKGROUND_INTERVAL;
+
+	kcompactd_wakeup = 1;
+	wake_up(&kcompactd_wait);
+}
+
+static int __init kcompactd_init(void)
+{
+	kcompactd_task = kthread_run(kcompactd, NULL, "kcompactd");
+	if (IS_ERR(kcompactd_task)) {
+		pr_err("Failed to start kcompactd\n");
+		kcompactd_task = NULL;
+	}
+
+	return 0;
+}
+module_init(kcompactd_init);
+
 /* The written value is actually unused, all memory is compacted */
 int sysctl_compact_memory;
 
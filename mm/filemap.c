@@ -21,6 +21,7 @@
 #include <linux/swap.h>
 #include <linux/mman.h>
 #include <linux/pagemap.h>
+#include <linux/ghostcache.h>
 #include <linux/file.h>
 #include <linux/uio.h>
 #include <linux/hash.h>
@@ -137,6 +138,7 @@ void __remove_from_page_cache(struct page *page)
 	if (PageDirty(page) && mapping_cap_account_dirty(mapping)) {
 		dec_zone_page_state(page, NR_FILE_DIRTY);
 		dec_bdi_stat(mapping->backing_dev_info, BDI_RECLAIMABLE);
+		mem_cgroup_update_file_dirty(page, -1);
 	}
 }
 
@@ -1110,7 +1112,9 @@ readpage:
 		 */
 		ClearPageError(page);
 		/* Start the actual read. The read will unlock the page. */
-		error = mapping->a_ops->readpage(filp, page);
+		error = ghostcache_get_page(page);
+		if (error)
+			error = mapping->a_ops->readpage(filp, page);
 
 		if (unlikely(error)) {
 			if (error == AOP_TRUNCATED_PAGE) {
@@ -1417,8 +1421,11 @@ static int page_cache_read(struct file *file, pgoff_t offset)
 			return -ENOMEM;
 
 		ret = add_to_page_cache_lru(page, mapping, offset, GFP_KERNEL);
-		if (ret == 0)
-			ret = mapping->a_ops->readpage(file, page);
+		if (ret == 0) {
+			ret = ghostcache_get_page(page);
+			if (ret)
+				ret = mapping->a_ops->readpage(file, page);
+		}
 		else if (ret == -EEXIST)
 			ret = 0; /* losing race to add is OK */
 
@@ -1609,7 +1616,9 @@ page_not_uptodate:
 	 * and we need to check for errors.
 	 */
 	ClearPageError(page);
-	error = mapping->a_ops->readpage(file, page);
+	error = ghostcache_get_page(page);
+	if (error)
+		error = mapping->a_ops->readpage(file, page);
 	if (!error) {
 		wait_on_page_locked(page);
 		if (!PageUptodate(page))
@@ -0,0 +1,287 @@
+/*
+ * mm/ghostcache.c
+ *
+ * Compressed second-chance cache for evicted clean file pages.
+ *
+ * When reclaim drops a clean file page we often re-read it from slow
+ * flash within seconds (app switches re-touch the same text pages).
+ * Instead of losing the data, the page is LZO-compressed into a small
+ * bounded pool keyed by (mapping, index) as it leaves the page cache,
+ * and a later page-cache miss is satisfied from the pool before the
+ * block layer is involved. Entries are single shot: a hit removes the
+ * entry, and the pool evicts from the cold end of an LRU when it is
+ * over budget.
+ *
+ * Correctness relies on three hooks: eviction in shrink_page_list()
+ * fills entries (overwriting a stale one for the same key), truncate
+ * and invalidate_inode_pages2 flush the mapping, and clear_inode()
+ * flushes the mapping before the address_space can be recycled.
+ */
+
+#include <linux/ghostcache.h>
+#include <linux/debugfs.h>
+#include <linux/hash.h>
+#include <linux/highmem.h>
+#include <linux/list.h>
+#include <linux/lzo.h>
+#include <linux/mm.h>
+#include <linux/module.h>
+#include <linux/pagemap.h>
+#include <linux/slab.h>
+#include <linux/spinlock.h>
+
+/*
+ * Pool budget in kilobytes of compressed data (plus per-entry
+ * overhead); 0 disables the cache. Settable at boot
+ * (ghostcache.pool_kb=N) or at run time.
+ */
+static unsigned int ghost_pool_kb = 16384;
+module_param_named(pool_kb, ghost_pool_kb, uint, S_IWUSR | S_IRUGO);
+
+/* pages that barely compress are not worth caching */
+#define GHOST_MAX_CLEN		(PAGE_SIZE * 7 / 8)
+
+#define GHOST_HASH_BITS		10
+#define GHOST_HASH_SIZE		(1 << GHOST_HASH_BITS)
+#define GHOST_MAPPING_HASH_BITS	8
+#define GHOST_MAPPING_HASH_SIZE	(1 << GHOST_MAPPING_HASH_BITS)
+
+struct ghost_entry {
+	struct hlist_node	hash;
+	struct list_head	lru;
+	struct address_space	*mapping;
+	pgoff_t			index;
+	unsigned int		clen;
+	void			*data;
+};
+
+static struct hlist_head ghost_hash[GHOST_HASH_SIZE];
+static LIST_HEAD(ghost_lru);
+static unsigned long ghost_bytes;
+static DEFINE_SPINLOCK(ghost_lock);
+
+/*
+ * Count of entries per mapping-pointer hash slot, so clear_inode() on
+ * an inode that never left anything behind does not have to walk the
+ * whole table. Collisions only cause an unnecessary walk.
+ */
+static unsigned int ghost_mapping_count[GHOST_MAPPING_HASH_SIZE];
+
+/*
+ * Compression scratch space, protected by ghost_lock. A single buffer
+ * is fine on the UP systems this targets; making it per-cpu would be
+ * the first step for SMP.
+ */
+static unsigned char ghost_cbuf[lzo1x_worst_compress(PAGE_SIZE)];
+static unsigned char ghost_wmem[LZO1X_1_MEM_COMPRESS];
+
+static u32 ghost_stat_stores;
+static u32 ghost_stat_store_skips;
+static u32 ghost_stat_hits;
+static u32 ghost_stat_misses;
+static u32 ghost_stat_evictions;
+static u32 ghost_stat_invalidates;
+
+static unsigned long ghost_hash_key(struct address_space *mapping,
+				    pgoff_t index)
+{
+	return hash_long((unsigned long)mapping ^ index, GHOST_HASH_BITS);
+}
+
+static unsigned long ghost_mapping_slot(struct address_space *mapping)
+{
+	return hash_long((unsigned long)mapping, GHOST_MAPPING_HASH_BITS);
+}
+
+/* ghost_lock must be held */
+static struct ghost_entry *ghost_find(struct address_space *mapping,
+				      pgoff_t index)
+{
+	struct ghost_entry *entry;
+	struct hlist_node *node;
+
+	hlist_for_each_entry(entry, node,
+			     &ghost_hash[ghost_hash_key(mapping, index)],
+			     hash) {
+		if (entry->mapping == mapping && entry->index == index)
+			return entry;
+	}
+	return NULL;
+}
+
+/* ghost_lock must be held */
+static void ghost_free_entry(struct ghost_entry *entry)
+{
+	hlist_del(&entry->hash);
+	list_del(&entry->lru);
+	ghost_mapping_count[ghost_mapping_slot(entry->mapping)]--;
+	ghost_bytes -= entry->clen + sizeof(*entry);
+	kfree(entry->data);
+	kfree(entry);
+}
+
+/* ghost_lock must be held */
+static void ghost_shrink_to_budget(void)
+{
+	unsigned long budget = (unsigned long)ghost_pool_kb << 10;
+
+	while (ghost_bytes > budget && !list_empty(&ghost_lru)) {
+		ghost_free_entry(list_entry(ghost_lru.prev,
+					    struct ghost_entry, lru));
+		ghost_stat_evictions++;
+	}
+}
+
+/*
+ * Called from shrink_page_list() after a clean file page has been
+ * removed from its mapping and is about to be freed. The page is still
+ * locked and its data intact; page->mapping is already NULL, hence the
+ * separate mapping argument.
+ */
+void ghostcache_put_page(struct address_space *mapping, struct page *page)
+{
+	struct ghost_entry *entry, *old;
+	size_t clen;
+	void *src;
+	int ret;
+
+	if (!ghost_pool_kb || PageSwapBacked(page))
+		return;
+
+	spin_lock(&ghost_lock);
+
+	/* an older entry for this key is stale now, never keep it */
+	old = ghost_find(mapping, page->index);
+	if (old)
+		ghost_free_entry(old);
+
+	src = kmap_atomic(page, KM_USER0);
+	ret = lzo1x_1_compress(src, PAGE_SIZE, ghost_cbuf, &clen, ghost_wmem);
+	kunmap_atomic(src, KM_USER0);
+	if (ret != LZO_E_OK || clen > GHOST_MAX_CLEN)
+		goto skip;
+
+	/*
+	 * GFP_NOWAIT: this is the reclaim path, do not recurse into it.
+	 * Failing to cache a page is always acceptable.
+	 */
+	entry = kmalloc(sizeof(*entry), GFP_NOWAIT | __GFP_NOWARN);
+	if (!entry)
+		goto skip;
+	entry->data = kmalloc(clen, GFP_NOWAIT | __GFP_NOWARN);
+	if (!entry->data) {
+		kfree(entry);
+		goto skip;
+	}
+
+	memcpy(entry->data, ghost_cbuf, clen);
+	entry->mapping = mapping;
+	entry->index = page->index;
+	entry->clen = clen;
+	hlist_add_head(&entry->hash,
+		       &ghost_hash[ghost_hash_key(mapping, page->index)]);
+	list_add(&entry->lru, &ghost_lru);
+	ghost_mapping_count[ghost_mapping_slot(mapping)]++;
+	ghost_bytes += clen + sizeof(*entry);
+	ghost_stat_stores++;
+
+	ghost_shrink_to_budget();
+	spin_unlock(&ghost_lock);
+	return;
+
+skip:
+	ghost_stat_store_skips++;
+	spin_unlock(&ghost_lock);
+}
+
+/*
+ * Try to fill a not-uptodate page-cache page from the ghost cache.
+ * Mimics ->readpage() semantics: the page is locked on entry and, on
+ * success, is marked uptodate and unlocked. Returns 0 on a hit,
+ * -ENOENT otherwise (the caller then reads from the block layer).
+ */
+int ghostcache_get_page(struct page *page)
+{
+	struct address_space *mapping = page->mapping;
+	struct ghost_entry *entry;
+	size_t dlen = PAGE_SIZE;
+	void *dst;
+	int ret;
+
+	if (!mapping)
+		return -ENOENT;
+
+	spin_lock(&ghost_lock);
+	entry = ghost_find(mapping, page->index);
+	if (!entry) {
+		ghost_stat_misses++;
+		spin_unlock(&ghost_lock);
+		return -ENOENT;
+	}
+
+	dst = kmap_atomic(page, KM_USER0);
+	ret = lzo1x_decompress_safe(entry->data, entry->clen, dst, &dlen);
+	kunmap_atomic(dst, KM_USER0);
+
+	/* single shot: a hit consumes the entry */
+	ghost_free_entry(entry);
+
+	if (ret != LZO_E_OK || dlen != PAGE_SIZE) {
+		WARN_ONCE(1, "ghostcache: bad decompress %d len %zu\n",
+			  ret, dlen);
+		ghost_stat_misses++;
+		spin_unlock(&ghost_lock);
+		return -ENOENT;
+	}
+	ghost_stat_hits++;
+	spin_unlock(&ghost_lock);
+
+	flush_dcache_page(page);
+	SetPageUptodate(page);
+	unlock_page(page);
+	return 0;
+}
+
+/*
+ * Drop every entry belonging to a mapping. Called when on-disk data
+ * may change under the cache (truncate, direct IO invalidate) and when
+ * the inode is cleared, which also protects against a recycled
+ * address_space pointer matching stale entries.
+ */
+void ghostcache_invalidate_inode(struct address_space *mapping)
+{
+	struct ghost_entry *entry, *next;
+
+	spin_lock(&ghost_lock);
+	if (!ghost_mapping_count[ghost_mapping_slot(mapping)]) {
+		spin_unlock(&ghost_lock);
+		return;
+	}
+	list_for_each_entry_safe(entry, next, &ghost_lru, lru) {
+		if (entry->mapping == mapping) {
+			ghost_free_entry(entry);
+			ghost_stat_invalidates++;
+		}
+	}
+	spin_unlock(&ghost_lock);
+}
+
+static int __init ghostcache_init(void)
+{
+	struct dentry *dir;
+
+	dir = debugfs_create_dir("ghostcache", NULL);
+	if (IS_ERR_OR_NULL(dir))
+		return 0;
+
+	debugfs_create_u32("stores", S_IRUGO, dir, &ghost_stat_stores);
+	debugfs_create_u32("store_skips", S_IRUGO, dir,
+			   &ghost_stat_store_skips);
+	debugfs_create_u32("hits", S_IRUGO, dir, &ghost_stat_hits);
+	debugfs_create_u32("misses", S_IRUGO, dir, &ghost_stat_misses);
+	debugfs_create_u32("evictions", S_IRUGO, dir, &ghost_stat_evictions);
+	debugfs_create_u32("invalidates", S_IRUGO, dir,
+			   &ghost_stat_invalidates);
+	return 0;
+}
+late_initcall(ghostcache_init);
@@ -185,6 +185,18 @@ static unsigned int ksm_thread_pages_to_scan = 100;
 /* Milliseconds ksmd should sleep between batches */
 static unsigned int ksm_thread_sleep_millisecs = 20;
 
+/* Whether ksmd automatically backs off when scanning stops paying off */
+static unsigned int ksm_thread_auto_throttle = 1;
+
+/* Multiplier currently applied to sleep_millisecs by the throttle */
+static unsigned int ksm_throttle = 1;
+#define KSM_THROTTLE_MAX	32
+
+/* Pages scanned per merge yield measurement window */
+#define KSM_YIELD_WINDOW	4096
+static unsigned long ksm_yield_scanned;
+static unsigned long ksm_yield_base;
+
 #define KSM_RUN_STOP	0
 #define KSM_RUN_MERGE	1
 #define KSM_RUN_UNMERGE	2
@@ -1382,6 +1394,37 @@ static void ksm_do_scan(unsigned int scan_npages)
 	}
 }
 
+/*
+ * Track the merge yield of the last KSM_YIELD_WINDOW pages scanned, and
+ * keep doubling the scanner's sleep time while whole windows go by
+ * without a single new merge.  The yield collapses once the stable
+ * workload has been deduplicated, at which point the fixed scan rate is
+ * pure CPU tax; __ksm_enter() resets the throttle when new mergeable
+ * address space shows up.
+ */
+static void ksm_update_throttle(unsigned int scanned)
+{
+	unsigned long merged = ksm_pages_sharing + ksm_pages_shared;
+
+	if (!ksm_thread_auto_throttle) {
+		ksm_throttle = 1;
+		return;
+	}
+
+	ksm_yield_scanned += scanned;
+	if (ksm_yield_scanned < KSM_YIELD_WINDOW)
+		return;
+
+	if (merged <= ksm_yield_base) {
+		if (ksm_throttle < KSM_THROTTLE_MAX)
+			ksm_throttle <<= 1;
+	} else
+		ksm_throttle = 1;
+
+	ksm_yield_base = merged;
+	ksm_yield_scanned = 0;
+}
+
 static int ksmd_should_run(void)
 {
 	return (ksm_run & KSM_RUN_MERGE) && !list_empty(&ksm_mm_head.mm_list);
@@ -1393,13 +1436,16 @@ static int ksm_scan_thread(void *nothing)
 
 	while (!kthread_should_stop()) {
 		mutex_lock(&ksm_thread_mutex);
-		if (ksmd_should_run())
+		if (ksmd_should_run()) {
 			ksm_do_scan(ksm_thread_pages_to_scan);
+			ksm_update_throttle(ksm_thread_pages_to_scan);
+		}
 		mutex_unlock(&ksm_thread_mutex);
 
 		if (ksmd_should_run()) {
 			schedule_timeout_interruptible(
-				msecs_to_jiffies(ksm_thread_sleep_millisecs));
+				msecs_to_jiffies(ksm_thread_sleep_millisecs *
+						 ksm_throttle));
 		} else {
 			wait_event_interruptible(ksm_thread_wait,
 				ksmd_should_run() || kthread_should_stop());
@@ -1476,6 +1522,14 @@ int __ksm_enter(struct mm_struct *mm)
 	set_bit(MMF_VM_MERGEABLE, &mm->flags);
 	atomic_inc(&mm->mm_count);
 
+	/*
+	 * New mergeable address space (app launch, fork of a mergeable
+	 * parent): give the scanner its full rate back.  Unsynchronized,
+	 * but only a heuristic and the stores are word-sized.
+	 */
+	ksm_throttle = 1;
+	ksm_yield_scanned = 0;
+
 	if (needs_wakeup)
 		wake_up_interruptible(&ksm_thread_wait);
 
@@ -1823,6 +1877,29 @@ static ssize_t pages_to_scan_store(struct kobject *kobj,
 }
 KSM_ATTR(pages_to_scan);
 
+static ssize_t auto_throttle_show(struct kobject *kobj,
+				  struct kobj_attribute *attr, char *buf)
+{
+	return sprintf(buf, "%u\n", ksm_thread_auto_throttle);
+}
+
+static ssize_t auto_throttle_store(struct kobject *kobj,
+				   struct kobj_attribute *attr,
+				   const char *buf, size_t count)
+{
+	int err;
+	unsigned long value;
+
+	err = strict_strtoul(buf, 10, &value);
+	if (err || value > 1)
+		return -EINVAL;
+
+	ksm_thread_auto_throttle = value;
+
+	return count;
+}
+KSM_ATTR(auto_throttle);
+
 static ssize_t run_show(struct kobject *kobj, struct kobj_attribute *attr,
 			char *buf)
 {
@@ -1918,6 +1995,7 @@ KSM_ATTR_RO(full_scans);
 static struct attribute *ksm_attrs[] = {
 	&sleep_millisecs_attr.attr,
 	&pages_to_scan_attr.attr,
+	&auto_throttle_attr.attr,
 	&run_attr.attr,
 	&pages_shared_attr.attr,
 	&pages_sharing_attr.attr,
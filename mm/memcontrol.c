@@ -33,6 +33,7 @@
 #include <linux/bit_spinlock.h>
 #include <linux/rcupdate.h>
 #include <linux/limits.h>
+#include <linux/math64.h>
 #include <linux/mutex.h>
 #include <linux/rbtree.h>
 #include <linux/slab.h>
@@ -47,6 +48,7 @@
 #include <linux/mm_inline.h>
 #include <linux/page_cgroup.h>
 #include <linux/cpu.h>
+#include <linux/oom.h>
 #include "internal.h"
 
 #include <asm/uaccess.h>
@@ -83,6 +85,7 @@ enum mem_cgroup_stat_index {
 	MEM_CGROUP_STAT_CACHE, 	   /* # of pages charged as cache */
 	MEM_CGROUP_STAT_RSS,	   /* # of pages charged as anon rss */
 	MEM_CGROUP_STAT_FILE_MAPPED,  /* # of pages charged as file rss */
+	MEM_CGROUP_STAT_FILE_DIRTY,   /* # of dirty pages charged */
 	MEM_CGROUP_STAT_PGPGIN_COUNT,	/* # of pages paged in */
 	MEM_CGROUP_STAT_PGPGOUT_COUNT,	/* # of pages paged out */
 	MEM_CGROUP_STAT_SWAPOUT, /* # of pages, swapped out */
@@ -229,6 +232,18 @@ struct mem_cgroup {
 	/* OOM-Killer disable */
 	int		oom_kill_disable;
 
+	/*
+	 * Dirty page limit as a percentage of the group's memory limit,
+	 * enforced in balance_dirty_pages().  0 means no per-group limit.
+	 */
+	unsigned int	dirty_ratio;
+
+	/*
+	 * Extra left-shift applied to the badness score of member tasks;
+	 * higher means the group's tasks are killed sooner on OOM.
+	 */
+	int		oom_priority;
+
 	/* set when res.limit == memsw.limit */
 	bool		memsw_is_minimum;
 
@@ -1455,6 +1470,63 @@ done:
 	unlock_page_cgroup(pc);
 }
 
+/*
+ * Called when a file page becomes dirty (val > 0) or is cleaned (val < 0).
+ * Mirrors mem_cgroup_update_file_mapped(); keeps a per-cgroup dirty page
+ * count so balance_dirty_pages() can throttle against a per-cgroup limit.
+ */
+void mem_cgroup_update_file_dirty(struct page *page, int val)
+{
+	struct mem_cgroup *mem;
+	struct page_cgroup *pc;
+
+	pc = lookup_page_cgroup(page);
+	if (unlikely(!pc))
+		return;
+
+	lock_page_cgroup(pc);
+	mem = pc->mem_cgroup;
+	if (!mem || !PageCgroupUsed(pc))
+		goto done;
+
+	if (val > 0) {
+		this_cpu_inc(mem->stat->count[MEM_CGROUP_STAT_FILE_DIRTY]);
+		SetPageCgroupFileDirty(pc);
+	} else {
+		this_cpu_dec(mem->stat->count[MEM_CGROUP_STAT_FILE_DIRTY]);
+		ClearPageCgroupFileDirty(pc);
+	}
+
+done:
+	unlock_page_cgroup(pc);
+}
+
+/*
+ * Returns true if current's cgroup is over its own dirty limit, configured
+ * via memory.dirty_ratio as a percentage of the group's memory limit.
+ */
+bool mem_cgroup_dirty_limit_exceeded(void)
+{
+	struct mem_cgroup *mem;
+	u64 limit, thresh, dirty;
+	bool over = false;
+
+	if (mem_cgroup_disabled())
+		return false;
+
+	rcu_read_lock();
+	mem = mem_cgroup_from_task(current);
+	if (mem && !mem_cgroup_is_root(mem) && mem->dirty_ratio) {
+		limit = res_counter_read_u64(&mem->res, RES_LIMIT);
+		thresh = div_u64(limit, 100) * mem->dirty_ratio;
+		dirty = (u64)mem_cgroup_read_stat(mem,
+				MEM_CGROUP_STAT_FILE_DIRTY) * PAGE_SIZE;
+		over = dirty > thresh;
+	}
+	rcu_read_unlock();
+	return over;
+}
+
 /*
  * size of first charge trial. "32" comes from vmscan.c's magic value.
  * TODO: maybe necessary to use big numbers in big irons.
@@ -1893,6 +1965,13 @@ static void __mem_cgroup_move_account(struct page_cgroup *pc,
 		__this_cpu_inc(to->stat->count[MEM_CGROUP_STAT_FILE_MAPPED]);
 		preempt_enable();
 	}
+	if (PageCgroupFileDirty(pc)) {
+		/* Keep the dirty page accounted against the new cgroup */
+		preempt_disable();
+		__this_cpu_dec(from->stat->count[MEM_CGROUP_STAT_FILE_DIRTY]);
+		__this_cpu_inc(to->stat->count[MEM_CGROUP_STAT_FILE_DIRTY]);
+		preempt_enable();
+	}
 	mem_cgroup_charge_statistics(from, pc, false);
 	if (uncharge)
 		/* This is not "cancel", but cancel_charge does all we need. */
@@ -3283,6 +3362,7 @@ enum {
 	MCS_CACHE,
 	MCS_RSS,
 	MCS_FILE_MAPPED,
+	MCS_FILE_DIRTY,
 	MCS_PGPGIN,
 	MCS_PGPGOUT,
 	MCS_SWAP,
@@ -3305,6 +3385,7 @@ struct {
 	{"cache", "total_cache"},
 	{"rss", "total_rss"},
 	{"mapped_file", "total_mapped_file"},
+	{"file_dirty", "total_file_dirty"},
 	{"pgpgin", "total_pgpgin"},
 	{"pgpgout", "total_pgpgout"},
 	{"swap", "total_swap"},
@@ -3328,6 +3409,8 @@ static int mem_cgroup_get_local_stat(struct mem_cgroup *mem, void *data)
 	s->stat[MCS_RSS] += val * PAGE_SIZE;
 	val = mem_cgroup_read_stat(mem, MEM_CGROUP_STAT_FILE_MAPPED);
 	s->stat[MCS_FILE_MAPPED] += val * PAGE_SIZE;
+	val = mem_cgroup_read_stat(mem, MEM_CGROUP_STAT_FILE_DIRTY);
+	s->stat[MCS_FILE_DIRTY] += val * PAGE_SIZE;
 	val = mem_cgroup_read_stat(mem, MEM_CGROUP_STAT_PGPGIN_COUNT);
 	s->stat[MCS_PGPGIN] += val;
 	val = mem_cgroup_read_stat(mem, MEM_CGROUP_STAT_PGPGOUT_COUNT);
@@ -3461,6 +3544,70 @@ static int mem_cgroup_swappiness_write(struct cgroup *cgrp, struct cftype *cft,
 	return 0;
 }
 
+static u64 mem_cgroup_dirty_ratio_read(struct cgroup *cgrp, struct cftype *cft)
+{
+	struct mem_cgroup *memcg = mem_cgroup_from_cont(cgrp);
+
+	return memcg->dirty_ratio;
+}
+
+static int mem_cgroup_dirty_ratio_write(struct cgroup *cgrp, struct cftype *cft,
+					u64 val)
+{
+	struct mem_cgroup *memcg = mem_cgroup_from_cont(cgrp);
+
+	if (val > 100)
+		return -EINVAL;
+
+	/* root writers are throttled by the global limits only */
+	if (cgrp->parent == NULL)
+		return -EINVAL;
+
+	memcg->dirty_ratio = val;
+
+	return 0;
+}
+
+/* called from badness() to fold cgroup policy into the score */
+int mem_cgroup_oom_priority(struct task_struct *p)
+{
+	struct mem_cgroup *memcg;
+	int prio;
+
+	rcu_read_lock();
+	memcg = mem_cgroup_from_task(p);
+	prio = memcg ? memcg->oom_priority : 0;
+	rcu_read_unlock();
+
+	return prio;
+}
+
+static u64 mem_cgroup_oom_priority_read(struct cgroup *cgrp,
+					struct cftype *cft)
+{
+	struct mem_cgroup *memcg = mem_cgroup_from_cont(cgrp);
+
+	return memcg->oom_priority;
+}
+
+static int mem_cgroup_oom_priority_write(struct cgroup *cgrp,
+					 struct cftype *cft, u64 val)
+{
+	struct mem_cgroup *memcg = mem_cgroup_from_cont(cgrp);
+
+	/* keep the shift small enough that oom_adj can still override */
+	if (val > OOM_ADJUST_MAX)
+		return -EINVAL;
+
+	/* the root group has no policy of its own */
+	if (cgrp->parent == NULL)
+		return -EINVAL;
+
+	memcg->oom_priority = val;
+
+	return 0;
+}
+
 static void __mem_cgroup_threshold(struct mem_cgroup *memcg, bool swap)
 {
 	struct mem_cgroup_threshold_ary *t;
@@ -3837,6 +3984,16 @@ static struct cftype mem_cgroup_files[] = {
 		.read_u64 = mem_cgroup_swappiness_read,
 		.write_u64 = mem_cgroup_swappiness_write,
 	},
+	{
+		.name = "dirty_ratio",
+		.read_u64 = mem_cgroup_dirty_ratio_read,
+		.write_u64 = mem_cgroup_dirty_ratio_write,
+	},
+	{
+		.name = "oom_priority",
+		.read_u64 = mem_cgroup_oom_priority_read,
+		.write_u64 = mem_cgroup_oom_priority_write,
+	},
 	{
 		.name = "move_charge_at_immigrate",
 		.read_u64 = mem_cgroup_move_charge_read,
@@ -4088,6 +4245,7 @@ mem_cgroup_create(struct cgroup_subsys *ss, struct cgroup *cont)
 		parent = mem_cgroup_from_cont(cont->parent);
 		mem->use_hierarchy = parent->use_hierarchy;
 		mem->oom_kill_disable = parent->oom_kill_disable;
+		mem->oom_priority = parent->oom_priority;
 	}
 
 	if (parent && parent->use_hierarchy) {
@@ -4108,8 +4266,10 @@ mem_cgroup_create(struct cgroup_subsys *ss, struct cgroup *cont)
 	spin_lock_init(&mem->reclaim_param_lock);
 	INIT_LIST_HEAD(&mem->oom_notify);
 
-	if (parent)
+	if (parent) {
 		mem->swappiness = get_swappiness(parent);
+		mem->dirty_ratio = parent->dirty_ratio;
+	}
 	atomic_set(&mem->refcnt, 1);
 	mem->move_charge_at_immigrate = 0;
 	mutex_init(&mem->thresholds_lock);
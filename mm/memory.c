@@ -707,6 +707,22 @@ copy_one_pte(struct mm_struct *dst_mm, struct mm_struct *src_mm,
 	pte = pte_mkold(pte);
 
 	page = vm_normal_page(vma, addr, pte);
+
+	/*
+	 * Clean file ptes in ordinary private mappings need not be
+	 * copied at all: the child can refault them from the page
+	 * cache.  Once a private mapping has an anon_vma the whole-vma
+	 * skip above no longer applies, yet typically only a handful
+	 * of its pages have been COWed while the rest still map file
+	 * text that the child may never touch before exec.  Leaving
+	 * those ptes empty trades a minor fault per page actually used
+	 * against copying every pte at fork.
+	 */
+	if (page && !PageAnon(page) && !pte_dirty(pte) && vma->vm_file &&
+	    !(vm_flags & (VM_SHARED|VM_LOCKED|VM_NONLINEAR|
+			  VM_INSERTPAGE|VM_PFNMAP|VM_MIXEDMAP)))
+		return 0;
+
 	if (page) {
 		get_page(page);
 		page_dup_rmap(page);
@@ -2648,9 +2664,9 @@ static int do_swap_page(struct mm_struct *mm, struct vm_area_struct *vma,
 		goto out;
 	}
 	delayacct_set_flag(DELAYACCT_PF_SWAPIN);
+	swap_refault_note(mm); /* Was this page evicted only recently? */
 	page = lookup_swap_cache(entry);
 	if (!page) {
-		grab_swap_token(mm); /* Contend for token _before_ read-in */
 		page = swapin_readahead(entry,
 					GFP_HIGHUSER_MOVABLE, vma, address);
 		if (!page) {
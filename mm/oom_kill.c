@@ -35,6 +35,74 @@ int sysctl_oom_dump_tasks;
 static DEFINE_SPINLOCK(zone_scan_lock);
 /* #define DEBUG */
 
+/*
+ * Preloaded victim selection.
+ *
+ * Walking the whole tasklist computing badness can take long enough on
+ * a thrashing system that the watchdog fires before a victim is picked.
+ * The activity manager rewrites oom_adj on every application state
+ * change, so tracking those writes keeps the most expendable candidate
+ * (highest positive oom_adj seen alive) at hand; the OOM path then
+ * kills it without a scan.  The candidate is held as a struct pid, so
+ * a candidate that exits simply fails to resolve and the slow path
+ * runs as before.  Only tasks with oom_adj > 0 are preloaded: nothing
+ * important is ever killed on the word of a stale cache.
+ */
+static DEFINE_SPINLOCK(oom_preload_lock);
+static struct pid *oom_preload_pid;
+static int oom_preload_adj;
+
+void oom_preload_update(struct task_struct *task)
+{
+	int adj = task->signal->oom_adj;
+	struct pid *old = NULL;
+
+	spin_lock(&oom_preload_lock);
+	if (oom_preload_pid == task_pid(task)) {
+		if (adj > 0) {
+			oom_preload_adj = adj;
+		} else {
+			old = oom_preload_pid;
+			oom_preload_pid = NULL;
+		}
+	} else if (adj > 0 && (!oom_preload_pid || adj >= oom_preload_adj)) {
+		old = oom_preload_pid;
+		oom_preload_pid = get_pid(task_pid(task));
+		oom_preload_adj = adj;
+	}
+	spin_unlock(&oom_preload_lock);
+
+	if (old)
+		put_pid(old);
+}
+
+/*
+ * Consume the preloaded candidate.  Must be called with tasklist_lock
+ * held for read so the task cannot be detached underneath us.  Returns
+ * NULL when there is no usable candidate, in which case the caller
+ * falls back to the full badness scan.
+ */
+static struct task_struct *oom_preload_victim(void)
+{
+	struct task_struct *p = NULL;
+	struct pid *pid;
+
+	spin_lock(&oom_preload_lock);
+	pid = oom_preload_pid;
+	oom_preload_pid = NULL;
+	spin_unlock(&oom_preload_lock);
+
+	if (!pid)
+		return NULL;
+
+	p = pid_task(pid, PIDTYPE_PID);
+	if (p && (p->signal->oom_adj <= 0 || (p->flags & PF_EXITING) ||
+			!p->mm))
+		p = NULL;
+	put_pid(pid);
+	return p;
+}
+
 /*
  * Is all threads of the target process nodes overlap ours?
  */
@@ -187,6 +255,18 @@ unsigned long badness(struct task_struct *p, unsigned long uptime)
 			points >>= -(oom_adj);
 	}
 
+	/*
+	 * Per-cgroup policy: memory.oom_priority shifts the score up so
+	 * whole groups (e.g. media pipelines) can be preferred over
+	 * system services regardless of their individual sizes.
+	 */
+	oom_adj = mem_cgroup_oom_priority(p);
+	if (oom_adj > 0) {
+		if (!points)
+			points = 1;
+		points <<= oom_adj;
+	}
+
 #ifdef DEBUG
 	printk(KERN_DEBUG "OOMkill: task %d (%s) got %lu points\n",
 	p->pid, p->comm, points);
@@ -566,6 +646,16 @@ static void __out_of_memory(gfp_t gfp_mask, int order)
 		if (!oom_kill_process(current, gfp_mask, order, 0, NULL,
 				"Out of memory (oom_kill_allocating_task)"))
 			return;
+
+	/*
+	 * Fast path: kill the preloaded expendable candidate before
+	 * paying for a full badness scan.  If the kill fails the scan
+	 * below runs as usual.
+	 */
+	p = oom_preload_victim();
+	if (p && !oom_kill_process(p, gfp_mask, order, 0, NULL,
+			"Out of memory (preloaded victim)"))
+		return;
 retry:
 	/*
 	 * Rambo mode: Shoot down a process and hope it solves whatever
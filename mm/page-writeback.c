@@ -33,6 +33,7 @@
 #include <linux/cpu.h>
 #include <linux/syscalls.h>
 #include <linux/buffer_head.h>
+#include <linux/memcontrol.h>
 #include <linux/pagevec.h>
 
 /*
@@ -490,6 +491,7 @@ static void balance_dirty_pages(struct address_space *mapping,
 	unsigned long bdi_thresh;
 	unsigned long pages_written = 0;
 	unsigned long pause = 1;
+	bool memcg_over;
 
 	struct backing_dev_info *bdi = mapping->backing_dev_info;
 
@@ -511,7 +513,16 @@ static void balance_dirty_pages(struct address_space *mapping,
 		bdi_nr_reclaimable = bdi_stat(bdi, BDI_RECLAIMABLE);
 		bdi_nr_writeback = bdi_stat(bdi, BDI_WRITEBACK);
 
-		if (bdi_nr_reclaimable + bdi_nr_writeback <= bdi_thresh)
+		/*
+		 * A task whose cgroup is over its own dirty limit keeps
+		 * being throttled even when the global and per-bdi limits
+		 * are fine, so one group's writeout cannot monopolize the
+		 * dirty memory that other groups' writers rely on.
+		 */
+		memcg_over = mem_cgroup_dirty_limit_exceeded();
+
+		if (!memcg_over &&
+		    bdi_nr_reclaimable + bdi_nr_writeback <= bdi_thresh)
 			break;
 
 		/*
@@ -519,7 +530,7 @@ static void balance_dirty_pages(struct address_space *mapping,
 		 * catch-up. This avoids (excessively) small writeouts
 		 * when the bdi limits are ramping up.
 		 */
-		if (nr_reclaimable + nr_writeback <
+		if (!memcg_over && nr_reclaimable + nr_writeback <
 				(background_thresh + dirty_thresh) / 2)
 			break;
 
@@ -535,7 +546,7 @@ static void balance_dirty_pages(struct address_space *mapping,
 		 * threshold otherwise wait until the disk writes catch
 		 * up.
 		 */
-		if (bdi_nr_reclaimable > bdi_thresh) {
+		if (bdi_nr_reclaimable > bdi_thresh || memcg_over) {
 			writeback_inodes_wb(&bdi->wb, &wbc);
 			pages_written += write_chunk - wbc.nr_to_write;
 			get_dirty_limits(&background_thresh, &dirty_thresh,
@@ -560,7 +571,8 @@ static void balance_dirty_pages(struct address_space *mapping,
 			bdi_nr_writeback = bdi_stat(bdi, BDI_WRITEBACK);
 		}
 
-		if (bdi_nr_reclaimable + bdi_nr_writeback <= bdi_thresh)
+		if (!memcg_over &&
+		    bdi_nr_reclaimable + bdi_nr_writeback <= bdi_thresh)
 			break;
 		if (pages_written >= write_chunk)
 			break;		/* We've done our duty */
@@ -1086,6 +1098,7 @@ void account_page_dirtied(struct page *page, struct address_space *mapping)
 	if (mapping_cap_account_dirty(mapping)) {
 		__inc_zone_page_state(page, NR_FILE_DIRTY);
 		__inc_bdi_stat(mapping->backing_dev_info, BDI_RECLAIMABLE);
+		mem_cgroup_update_file_dirty(page, 1);
 		task_dirty_inc(current);
 		task_io_account_write(PAGE_CACHE_SIZE);
 	}
@@ -1262,6 +1275,7 @@ int clear_page_dirty_for_io(struct page *page)
 			dec_zone_page_state(page, NR_FILE_DIRTY);
 			dec_bdi_stat(mapping->backing_dev_info,
 					BDI_RECLAIMABLE);
+			mem_cgroup_update_file_dirty(page, -1);
 			return 1;
 		}
 		return 0;
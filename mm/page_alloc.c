@@ -48,6 +48,7 @@
 #include <linux/page_cgroup.h>
 #include <linux/debugobjects.h>
 #include <linux/kmemleak.h>
+#include <linux/alloc_sample.h>
 #include <linux/memory.h>
 #include <linux/compaction.h>
 #include <trace/events/kmem.h>
@@ -2176,6 +2177,8 @@ __alloc_pages_nodemask(gfp_t gfp_mask, unsigned int order,
 	put_mems_allowed();
 
 	trace_mm_page_alloc(page, order, gfp_mask, migratetype);
+	if (page)
+		alloc_sample(_RET_IP_, PAGE_SIZE << order);
 	return page;
 }
 EXPORT_SYMBOL(__alloc_pages_nodemask);
@@ -40,6 +40,23 @@ static struct bio *get_swap_bio(gfp_t gfp_flags,
 	return bio;
 }
 
+/*
+ * Asynchronous swap-out is batched: contiguous pages are collected in
+ * one open multi-page bio and submitted together, so a shrink pass
+ * emits a few large sequential writes instead of scattered 4K ones,
+ * which is the worst possible pattern for flash media. The batch is
+ * flushed when a page does not extend it, when it reaches
+ * SWAP_BATCH_PAGES, and at the end of every shrink_page_list() pass,
+ * so no page sits in an unsubmitted bio after reclaim returns.
+ * swap_batch_lock is a mutex since building and submitting bios may
+ * sleep; all users are process context.
+ */
+#define SWAP_BATCH_PAGES	32
+
+static struct bio *swap_batch_bio;
+static sector_t swap_batch_next_sector;
+static DEFINE_MUTEX(swap_batch_lock);
+
 static void end_swap_bio_write(struct bio *bio, int err)
 {
 	const int uptodate = test_bit(BIO_UPTODATE, &bio->bi_flags);
@@ -66,6 +83,48 @@ static void end_swap_bio_write(struct bio *bio, int err)
 	bio_put(bio);
 }
 
+static void end_swap_batch_bio_write(struct bio *bio, int err)
+{
+	const int uptodate = test_bit(BIO_UPTODATE, &bio->bi_flags);
+	int i;
+
+	if (!uptodate)
+		printk(KERN_ALERT "Write-error on swap-device (%u:%u:%Lu)\n",
+				imajor(bio->bi_bdev->bd_inode),
+				iminor(bio->bi_bdev->bd_inode),
+				(unsigned long long)bio->bi_sector);
+
+	for (i = 0; i < bio->bi_vcnt; i++) {
+		struct page *page = bio->bi_io_vec[i].bv_page;
+
+		if (!uptodate) {
+			SetPageError(page);
+			set_page_dirty(page);
+			ClearPageReclaim(page);
+		}
+		end_page_writeback(page);
+	}
+	bio_put(bio);
+}
+
+/* submit the open batch, if any; swap_batch_lock must be held */
+static void __swap_write_batch_flush(void)
+{
+	struct bio *bio = swap_batch_bio;
+
+	if (!bio)
+		return;
+	swap_batch_bio = NULL;
+	submit_bio(WRITE, bio);
+}
+
+void swap_write_batch_flush(void)
+{
+	mutex_lock(&swap_batch_lock);
+	__swap_write_batch_flush();
+	mutex_unlock(&swap_batch_lock);
+}
+
 void end_swap_bio_read(struct bio *bio, int err)
 {
 	const int uptodate = test_bit(BIO_UPTODATE, &bio->bi_flags);
@@ -91,6 +150,8 @@ void end_swap_bio_read(struct bio *bio, int err)
  */
 int swap_writepage(struct page *page, struct writeback_control *wbc)
 {
+	struct block_device *bdev;
+	sector_t sector;
 	struct bio *bio;
 	int ret = 0, rw = WRITE;
 
@@ -98,19 +159,63 @@ int swap_writepage(struct page *page, struct writeback_control *wbc)
 		unlock_page(page);
 		goto out;
 	}
-	bio = get_swap_bio(GFP_NOIO, page, end_swap_bio_write);
-	if (bio == NULL) {
-		set_page_dirty(page);
+
+	if (wbc->sync_mode == WB_SYNC_ALL) {
+		bio = get_swap_bio(GFP_NOIO, page, end_swap_bio_write);
+		if (bio == NULL) {
+			set_page_dirty(page);
+			unlock_page(page);
+			ret = -ENOMEM;
+			goto out;
+		}
+		rw |= (1 << BIO_RW_SYNCIO) | (1 << BIO_RW_UNPLUG);
+		count_vm_event(PSWPOUT);
+		set_page_writeback(page);
 		unlock_page(page);
-		ret = -ENOMEM;
+		submit_bio(rw, bio);
 		goto out;
 	}
-	if (wbc->sync_mode == WB_SYNC_ALL)
-		rw |= (1 << BIO_RW_SYNCIO) | (1 << BIO_RW_UNPLUG);
+
+	sector = map_swap_page(page, &bdev);
+	sector <<= PAGE_SHIFT - 9;
+
+	mutex_lock(&swap_batch_lock);
+	if (swap_batch_bio &&
+	    (swap_batch_bio->bi_bdev != bdev ||
+	     swap_batch_next_sector != sector))
+		__swap_write_batch_flush();
+	if (!swap_batch_bio) {
+		bio = bio_alloc(GFP_NOIO, SWAP_BATCH_PAGES);
+		if (bio == NULL) {
+			mutex_unlock(&swap_batch_lock);
+			set_page_dirty(page);
+			unlock_page(page);
+			ret = -ENOMEM;
+			goto out;
+		}
+		bio->bi_sector = sector;
+		bio->bi_bdev = bdev;
+		bio->bi_end_io = end_swap_batch_bio_write;
+		swap_batch_bio = bio;
+		swap_batch_next_sector = sector;
+	}
+
+	/*
+	 * bio_add_page enforces the queue limits for us; if the page
+	 * does not fit, submit the batch and retry on a fresh bio.
+	 */
+	if (!bio_add_page(swap_batch_bio, page, PAGE_SIZE, 0)) {
+		__swap_write_batch_flush();
+		mutex_unlock(&swap_batch_lock);
+		return swap_writepage(page, wbc);
+	}
+	swap_batch_next_sector += PAGE_SIZE >> 9;
 	count_vm_event(PSWPOUT);
 	set_page_writeback(page);
 	unlock_page(page);
-	submit_bio(rw, bio);
+	if (swap_batch_bio->bi_vcnt >= SWAP_BATCH_PAGES)
+		__swap_write_batch_flush();
+	mutex_unlock(&swap_batch_lock);
 out:
 	return ret;
 }
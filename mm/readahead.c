@@ -17,6 +17,7 @@
 #include <linux/task_io_accounting_ops.h>
 #include <linux/pagevec.h>
 #include <linux/pagemap.h>
+#include <linux/ioprio.h>
 
 /*
  * Initialise a struct file's readahead state.  Assumes that the caller has
@@ -383,6 +384,17 @@ static int try_context_readahead(struct address_space *mapping,
 	return 1;
 }
 
+/*
+ * Has the task flagged its reads as application cold-start I/O?
+ * Reading our own io_context pointer needs no locking.
+ */
+static int launch_mode_readahead(void)
+{
+	struct io_context *ioc = current->io_context;
+
+	return ioc && (ioc->ioprio & IOPRIO_FLAG_LAUNCH);
+}
+
 /*
  * A minimal readahead algorithm for trivial sequential/random reads.
  */
@@ -463,7 +475,16 @@ ondemand_readahead(struct address_space *mapping,
 
 initial_readahead:
 	ra->start = offset;
-	ra->size = get_init_ra_size(req_size, max);
+	/*
+	 * Launch-mode tasks stream dozens of small files (dex,
+	 * resources) exactly once, front to back, so window ramp-up
+	 * never pays off for them. Open with the maximum window, which
+	 * swallows a whole small file in a single request.
+	 */
+	if (launch_mode_readahead())
+		ra->size = max;
+	else
+		ra->size = get_init_ra_size(req_size, max);
 	ra->async_size = ra->size > req_size ? ra->size - req_size : ra->size;
 
 readit:
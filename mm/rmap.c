@@ -464,10 +464,9 @@ int page_referenced_one(struct page *page, struct vm_area_struct *vma,
 			referenced++;
 	}
 
-	/* Pretend the page is referenced if the task has the
-	   swap token and is in the middle of a page fault. */
-	if (mm != current->mm && has_swap_token(mm) &&
-			rwsem_is_locked(&mm->mmap_sem))
+	/* Pretend the page is referenced if the mm has recently been
+	   refaulting pages that reclaim evicted; see mm/thrash.c. */
+	if (mm != current->mm && swap_thrash_protected(mm))
 		referenced++;
 
 out_unmap:
@@ -966,6 +965,7 @@ int try_to_unmap_one(struct page *page, struct vm_area_struct *vma,
 			}
 			dec_mm_counter(mm, MM_ANONPAGES);
 			inc_mm_counter(mm, MM_SWAPENTS);
+			swap_evict_note(mm);
 		} else if (PAGE_MIGRATION) {
 			/*
 			 * Store the pfn of the page in a special migration
@@ -59,6 +59,7 @@ static struct vfsmount *shm_mnt;
 #include <linux/highmem.h>
 #include <linux/seq_file.h>
 #include <linux/magic.h>
+#include <linux/ashmem.h>
 
 #include <asm/uaccess.h>
 #include <asm/div64.h>
@@ -561,7 +562,24 @@ static void shmem_truncate_range(struct inode *inode, loff_t start, loff_t end)
 	if (idx >= info->next_index)
 		return;
 
+	/*
+	 * The common teardown of a small tmpfs/ashmem object: the pages
+	 * were already dropped by truncate_inode_pages(), and the file
+	 * never touched swap, so there are no swap entries or index
+	 * pages to walk.  Settle the accounting in one pass instead of
+	 * setting up the directory walk; thousands of short-lived
+	 * regions go through here.  With no pages in the mapping there
+	 * is nothing for racing writeback or swapin to swizzle, so the
+	 * SHMEM_TRUNCATE protocol is not needed either.
+	 */
 	spin_lock(&info->lock);
+	if (likely(end == (loff_t) -1) && !info->swapped &&
+	    !info->i_indirect && !inode->i_mapping->nrpages) {
+		info->next_index = idx;
+		shmem_recalc_inode(inode);
+		spin_unlock(&info->lock);
+		return;
+	}
 	info->flags |= SHMEM_TRUNCATE;
 	if (likely(end == (loff_t) -1)) {
 		limit = info->next_index;
@@ -1050,6 +1068,17 @@ static int shmem_writepage(struct page *page, struct writeback_control *wbc)
 	if (!total_swap_pages)
 		goto redirty;
 
+	/*
+	 * Discardable (ashmem-backed) pages hold regenerable caches:
+	 * writing them to swap is wasted I/O, and the ashmem shrinker
+	 * may be about to punch them out anyway.  Leave them alone and
+	 * tell the shrinker there is pressure to act on instead.
+	 */
+	if (mapping_discardable(mapping)) {
+		ashmem_discard_notify();
+		goto redirty;
+	}
+
 	/*
 	 * shmem_backing_dev_info's capabilities prevent regular writeback or
 	 * sync from ever calling shmem_writepage; but a stacking filesystem
@@ -19,6 +19,7 @@
 #include <linux/seq_file.h>
 #include <linux/kmemtrace.h>
 #include <linux/kmemcheck.h>
+#include <linux/alloc_sample.h>
 #include <linux/cpu.h>
 #include <linux/cpuset.h>
 #include <linux/mempolicy.h>
@@ -217,6 +218,12 @@ static inline void stat(struct kmem_cache *s, enum stat_item si)
 #endif
 }
 
+/* Always-on hot path counters, reported via /sys/kernel/slab/<cache>/hotstats */
+static inline void hotstat(struct kmem_cache *s, enum hotstat_item si)
+{
+	__this_cpu_inc(s->cpu_slab->hotstat[si]);
+}
+
 /********************************************************************
  * 			Core slab cache functions
  *******************************************************************/
@@ -1634,6 +1641,7 @@ load_freelist:
 unlock_out:
 	slab_unlock(c->page);
 	stat(s, ALLOC_SLOWPATH);
+	hotstat(s, HOT_ALLOC_SLOWPATH);
 	return object;
 
 another_slab:
@@ -1713,6 +1721,7 @@ static __always_inline void *slab_alloc(struct kmem_cache *s,
 	else {
 		c->freelist = get_freepointer(s, object);
 		stat(s, ALLOC_FASTPATH);
+		hotstat(s, HOT_ALLOC_FASTPATH);
 	}
 	local_irq_restore(flags);
 
@@ -1721,6 +1730,8 @@ static __always_inline void *slab_alloc(struct kmem_cache *s,
 
 	kmemcheck_slab_alloc(s, gfpflags, object, s->objsize);
 	kmemleak_alloc_recursive(object, s->objsize, 1, s->flags, gfpflags);
+	if (object)
+		alloc_sample(addr, s->objsize);
 
 	return object;
 }
@@ -1781,6 +1792,7 @@ static void __slab_free(struct kmem_cache *s, struct page *page,
 	void **object = (void *)x;
 
 	stat(s, FREE_SLOWPATH);
+	hotstat(s, HOT_FREE_SLOWPATH);
 	slab_lock(page);
 
 	if (unlikely(SLABDEBUG && PageSlubDebug(page)))
@@ -1861,6 +1873,7 @@ static __always_inline void slab_free(struct kmem_cache *s,
 		set_freepointer(s, object, c->freelist);
 		c->freelist = object;
 		stat(s, FREE_FASTPATH);
+		hotstat(s, HOT_FREE_FASTPATH);
 	} else
 		__slab_free(s, page, x, addr);
 
@@ -4207,6 +4220,50 @@ static ssize_t remote_node_defrag_ratio_store(struct kmem_cache *s,
 SLAB_ATTR(remote_node_defrag_ratio);
 #endif
 
+/*
+ * Always-on hot path counters. Unlike the CONFIG_SLUB_STATS attributes
+ * below, this one is available in production builds; it is what tells
+ * us which caches keep falling off the alloc/free fastpath.
+ * Write '0' to clear.
+ */
+static ssize_t hotstats_show(struct kmem_cache *s, char *buf)
+{
+	static const char *const names[NR_SLUB_HOTSTAT_ITEMS] = {
+		"alloc_fastpath", "alloc_slowpath",
+		"free_fastpath", "free_slowpath",
+	};
+	unsigned long sum[NR_SLUB_HOTSTAT_ITEMS] = { 0, };
+	int cpu, si, len = 0;
+
+	for_each_online_cpu(cpu) {
+		struct kmem_cache_cpu *c = per_cpu_ptr(s->cpu_slab, cpu);
+
+		for (si = 0; si < NR_SLUB_HOTSTAT_ITEMS; si++)
+			sum[si] += c->hotstat[si];
+	}
+
+	for (si = 0; si < NR_SLUB_HOTSTAT_ITEMS; si++)
+		len += sprintf(buf + len, "%s %lu\n", names[si], sum[si]);
+
+	return len;
+}
+
+static ssize_t hotstats_store(struct kmem_cache *s,
+				const char *buf, size_t length)
+{
+	int cpu;
+
+	if (buf[0] != '0')
+		return -EINVAL;
+
+	for_each_online_cpu(cpu)
+		memset(per_cpu_ptr(s->cpu_slab, cpu)->hotstat, 0,
+			sizeof(per_cpu_ptr(s->cpu_slab, cpu)->hotstat));
+
+	return length;
+}
+SLAB_ATTR(hotstats);
+
 #ifdef CONFIG_SLUB_STATS
 static int show_stat(struct kmem_cache *s, char *buf, enum stat_item si)
 {
@@ -4313,6 +4370,7 @@ static struct attribute *slab_attrs[] = {
 #ifdef CONFIG_NUMA
 	&remote_node_defrag_ratio_attr.attr,
 #endif
+	&hotstats_attr.attr,
 #ifdef CONFIG_SLUB_STATS
 	&alloc_fastpath_attr.attr,
 	&alloc_slowpath_attr.attr,
@@ -205,6 +205,8 @@ static int wait_for_discard(void *word)
 }
 
 #define SWAPFILE_CLUSTER	256
+/* smallest free run worth allocating sequentially when no cluster is free */
+#define SWAPFILE_SUBCLUSTER	32
 #define LATENCY_LIMIT		256
 
 static inline unsigned long scan_swap_map(struct swap_info_struct *si,
@@ -301,6 +303,33 @@ static inline unsigned long scan_swap_map(struct swap_info_struct *si,
 			}
 		}
 
+		/*
+		 * No empty cluster anywhere. Before resorting to
+		 * first-free allocation, settle for a smaller free run:
+		 * even a SWAPFILE_SUBCLUSTER run keeps swap-out in
+		 * flash-friendly sequential writes instead of the
+		 * scattered single slots a fragmented map hands out.
+		 */
+		offset = si->lowest_bit;
+		last_in_cluster = offset + SWAPFILE_SUBCLUSTER - 1;
+		for (; last_in_cluster <= si->highest_bit; offset++) {
+			if (si->swap_map[offset])
+				last_in_cluster = offset + SWAPFILE_SUBCLUSTER;
+			else if (offset == last_in_cluster) {
+				spin_lock(&swap_lock);
+				offset -= SWAPFILE_SUBCLUSTER - 1;
+				si->cluster_next = offset;
+				si->cluster_nr = SWAPFILE_SUBCLUSTER - 1;
+				/* partial runs are not worth a discard */
+				si->lowest_alloc = 0;
+				goto checks;
+			}
+			if (unlikely(--latency_ration < 0)) {
+				cond_resched();
+				latency_ration = LATENCY_LIMIT;
+			}
+		}
+
 		offset = scan_base;
 		spin_lock(&swap_lock);
 		si->cluster_nr = SWAPFILE_CLUSTER - 1;
@@ -1256,6 +1285,8 @@ static int try_to_unuse(unsigned int type)
 			};
 
 			swap_writepage(page, &wbc);
+			/* the write may still sit in the swap-out batch */
+			swap_write_batch_flush();
 			lock_page(page);
 			wait_on_page_writeback(page);
 		}
@@ -5,16 +5,20 @@
  * Copyright (C) 2004, Rik van Riel <riel@redhat.com>
  * Released under the GPL, see the file COPYING for details.
  *
- * Simple token based thrashing protection, using the algorithm
- * described in:  http://www.cs.wm.edu/~sjiang/token.pdf
+ * Working-set aware thrashing protection.
  *
- * Sep 2006, Ashwin Chaugule <ashwin.chaugule@celunite.com>
- * Improved algorithm to pass token:
- * Each task has a priority which is incremented if it contended
- * for the token in an interval less than its previous attempt.
- * If the token is acquired, that task's priority is boosted to prevent
- * the token from bouncing around too often and to let the task make
- * some progress in its execution.
+ * This file used to implement the single global swap token described
+ * in http://www.cs.wm.edu/~sjiang/token.pdf. With several processes
+ * of similar size the token just ping-pongs between the two largest
+ * while everything else thrashes.
+ *
+ * Instead, track refaults per mm: reclaim stamps an mm whenever it
+ * swaps out one of its anonymous pages, and a swap fault arriving
+ * shortly after that stamp means reclaim took a page the process was
+ * still using. Such an mm is granted a short period of reclaim
+ * immunity, honoured by page_referenced(). Any number of mms can be
+ * protected at once, so sustained app switching under pressure does
+ * not degenerate into one lucky token holder.
  */
 
 #include <linux/jiffies.h>
@@ -22,56 +26,66 @@
 #include <linux/sched.h>
 #include <linux/swap.h>
 
-static DEFINE_SPINLOCK(swap_token_lock);
-struct mm_struct *swap_token_mm;
-static unsigned int global_faults;
+/* Eviction-to-refault gap that counts as thrashing */
+#define SWAP_REFAULT_WINDOW	(2 * HZ)
 
-void grab_swap_token(struct mm_struct *mm)
-{
-	int current_interval;
+/* Immunity granted per detected refault, and the cap on accumulation */
+#define THRASH_IMMUNE_GRANT	(HZ)
+#define THRASH_IMMUNE_MAX	(5 * HZ)
 
-	global_faults++;
+/* Severe memory pressure suspends all immunity until this time */
+static unsigned long thrash_immune_suspended;
+
+/*
+ * Called by reclaim when it swaps out an anonymous page belonging to
+ * @mm. All updates here are racy by design: a lost store just makes
+ * the heuristic slightly less accurate, much like the old trylock on
+ * the token did.
+ */
+void swap_evict_note(struct mm_struct *mm)
+{
+	mm->swap_evict_stamp = jiffies;
+}
 
-	current_interval = global_faults - mm->faultstamp;
+/*
+ * Called on every swap fault. A refault of a page that was evicted
+ * only moments ago means reclaim is eating this process' working set,
+ * so extend its immunity window.
+ */
+void swap_refault_note(struct mm_struct *mm)
+{
+	unsigned long now = jiffies;
+	unsigned long immune;
 
-	if (!spin_trylock(&swap_token_lock))
+	if (!mm->swap_evict_stamp ||
+	    time_after(now, mm->swap_evict_stamp + SWAP_REFAULT_WINDOW))
 		return;
 
-	/* First come first served */
-	if (swap_token_mm == NULL) {
-		mm->token_priority = mm->token_priority + 2;
-		swap_token_mm = mm;
-		goto out;
-	}
+	immune = mm->thrash_immune_until;
+	if (!immune || time_before(immune, now))
+		immune = now;
+	immune += THRASH_IMMUNE_GRANT;
+	if (time_after(immune, now + THRASH_IMMUNE_MAX))
+		immune = now + THRASH_IMMUNE_MAX;
+	mm->thrash_immune_until = immune;
+}
 
-	if (mm != swap_token_mm) {
-		if (current_interval < mm->last_interval)
-			mm->token_priority++;
-		else {
-			if (likely(mm->token_priority > 0))
-				mm->token_priority--;
-		}
-		/* Check if we deserve the token */
-		if (mm->token_priority > swap_token_mm->token_priority) {
-			mm->token_priority += 2;
-			swap_token_mm = mm;
-		}
-	} else {
-		/* Token holder came in again! */
-		mm->token_priority += 2;
-	}
+/* Is this mm currently immune from reclaim? */
+int swap_thrash_protected(struct mm_struct *mm)
+{
+	if (thrash_immune_suspended &&
+	    time_before(jiffies, thrash_immune_suspended))
+		return 0;
 
-out:
-	mm->faultstamp = global_faults;
-	mm->last_interval = current_interval;
-	spin_unlock(&swap_token_lock);
+	return mm->thrash_immune_until &&
+		time_before(jiffies, mm->thrash_immune_until);
 }
 
-/* Called on process exit. */
-void __put_swap_token(struct mm_struct *mm)
+/*
+ * Reclaim is struggling to make progress: ignore all immunity for a
+ * while, like disabling the swap token used to.
+ */
+void swap_thrash_suspend(void)
 {
-	spin_lock(&swap_token_lock);
-	if (likely(mm == swap_token_mm))
-		swap_token_mm = NULL;
-	spin_unlock(&swap_token_lock);
+	thrash_immune_suspended = jiffies + THRASH_IMMUNE_GRANT;
 }
@@ -14,7 +14,9 @@
 #include <linux/swap.h>
 #include <linux/module.h>
 #include <linux/pagemap.h>
+#include <linux/ghostcache.h>
 #include <linux/highmem.h>
+#include <linux/memcontrol.h>
 #include <linux/pagevec.h>
 #include <linux/task_io_accounting_ops.h>
 #include <linux/buffer_head.h>	/* grr. try_to_release_page,
@@ -77,6 +79,7 @@ void cancel_dirty_page(struct page *page, unsigned int account_size)
 			dec_zone_page_state(page, NR_FILE_DIRTY);
 			dec_bdi_stat(mapping->backing_dev_info,
 					BDI_RECLAIMABLE);
+			mem_cgroup_update_file_dirty(page, -1);
 			if (account_size)
 				task_io_account_cancelled_write(account_size);
 		}
@@ -215,6 +218,9 @@ void truncate_inode_pages_range(struct address_space *mapping,
 	pgoff_t next;
 	int i;
 
+	/* ghost entries can outlive the pages, flush before nrpages check */
+	ghostcache_invalidate_inode(mapping);
+
 	if (mapping->nrpages == 0)
 		return;
 
@@ -327,6 +333,13 @@ unsigned long invalidate_mapping_pages(struct address_space *mapping,
 	unsigned long ret = 0;
 	int i;
 
+	/*
+	 * Clean pages dropped here may have been rewritten since their
+	 * ghost entries were stored, so the entries must go too or a
+	 * later read could resurrect the old data.
+	 */
+	ghostcache_invalidate_inode(mapping);
+
 	pagevec_init(&pvec, 0);
 	while (next <= end &&
 			pagevec_lookup(&pvec, mapping, next, PAGEVEC_SIZE)) {
@@ -428,6 +441,8 @@ int invalidate_inode_pages2_range(struct address_space *mapping,
 	int did_range_unmap = 0;
 	int wrapped = 0;
 
+	ghostcache_invalidate_inode(mapping);
+
 	pagevec_init(&pvec, 0);
 	next = start;
 	while (next <= end && !wrapped &&
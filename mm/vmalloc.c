@@ -1357,6 +1357,21 @@ struct vm_struct *get_vm_area_caller(unsigned long size, unsigned long flags,
 						-1, GFP_KERNEL, caller);
 }
 
+/*
+ * Like get_vm_area_caller() but with a caller supplied alignment, for
+ * mappings that want to use large page table entries (e.g. ARM
+ * section mapped ioremap, which needs the virtual address aligned the
+ * same as the physical one).
+ */
+struct vm_struct *get_vm_area_aligned_caller(unsigned long size,
+				unsigned long align, unsigned long flags,
+				void *caller)
+{
+	return __get_vm_area_node(size, align, flags, VMALLOC_START,
+						VMALLOC_END, -1, GFP_KERNEL,
+						caller);
+}
+
 static struct vm_struct *find_vm_area(const void *addr)
 {
 	struct vmap_area *va;
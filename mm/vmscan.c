@@ -17,8 +17,10 @@
 #include <linux/kernel_stat.h>
 #include <linux/swap.h>
 #include <linux/pagemap.h>
+#include <linux/ghostcache.h>
 #include <linux/init.h>
 #include <linux/highmem.h>
+#include <linux/ktime.h>
 #include <linux/vmstat.h>
 #include <linux/file.h>
 #include <linux/writeback.h>
@@ -796,6 +798,12 @@ static unsigned long shrink_page_list(struct list_head *page_list,
 		if (!mapping || !__remove_mapping(mapping, page))
 			goto keep_locked;
 
+		/*
+		 * The data of a clean file page is still intact here; give
+		 * the compressed ghost cache a chance to keep it around.
+		 */
+		ghostcache_put_page(mapping, page);
+
 		/*
 		 * At this point, we have no other references and there is
 		 * no way to pick any more up (removed from LRU, removed
@@ -835,10 +843,50 @@ keep:
 	list_splice(&ret_pages, page_list);
 	if (pagevec_count(&freed_pvec))
 		__pagevec_free(&freed_pvec);
+	/*
+	 * Submit any swap-out pages still sitting in the open write
+	 * batch before returning; a later sync pass may wait on them.
+	 */
+	swap_write_batch_flush();
 	count_vm_events(PGACTIVATE, pgactivate);
 	return nr_reclaimed;
 }
 
+#ifdef CONFIG_MMU
+/*
+ * Reclaim pages isolated from a task's LRU lists by /proc/<pid>/reclaim.
+ * The caller hands us pages already off the LRU; whatever
+ * shrink_page_list() could not free is put back. Batches are at most
+ * SWAP_CLUSTER_MAX pages, so we do not bother with the NR_ISOLATED_*
+ * accounting that zone reclaim uses for throttling.
+ */
+unsigned long reclaim_pages_from_list(struct list_head *page_list)
+{
+	struct scan_control sc = {
+		.gfp_mask = GFP_KERNEL,
+		.may_writepage = 1,
+		.may_unmap = 1,
+		.may_swap = 1,
+		.swappiness = vm_swappiness,
+	};
+	unsigned long nr_reclaimed;
+	struct page *page;
+
+	list_for_each_entry(page, page_list, lru)
+		ClearPageActive(page);
+
+	nr_reclaimed = shrink_page_list(page_list, &sc, PAGEOUT_IO_ASYNC);
+
+	while (!list_empty(page_list)) {
+		page = lru_to_page(page_list);
+		list_del(&page->lru);
+		putback_lru_page(page);
+	}
+
+	return nr_reclaimed;
+}
+#endif
+
 /*
  * Attempt to remove the specified page from its LRU.  Only take this page
  * if it is of the appropriate PageActive status.  Pages which are being
@@ -1808,7 +1856,7 @@ static unsigned long do_try_to_free_pages(struct zonelist *zonelist,
 	for (priority = DEF_PRIORITY; priority >= 0; priority--) {
 		sc->nr_scanned = 0;
 		if (!priority)
-			disable_swap_token();
+			swap_thrash_suspend();
 		shrink_zones(priority, zonelist, sc);
 		/*
 		 * Don't shrink slabs when reclaiming memory from
@@ -1882,6 +1930,8 @@ out:
 unsigned long try_to_free_pages(struct zonelist *zonelist, int order,
 				gfp_t gfp_mask, nodemask_t *nodemask)
 {
+	unsigned long nr_reclaimed;
+	ktime_t start = ktime_get();
 	struct scan_control sc = {
 		.gfp_mask = gfp_mask,
 		.may_writepage = !laptop_mode,
@@ -1894,7 +1944,12 @@ unsigned long try_to_free_pages(struct zonelist *zonelist, int order,
 		.nodemask = nodemask,
 	};
 
-	return do_try_to_free_pages(zonelist, &sc);
+	nr_reclaimed = do_try_to_free_pages(zonelist, &sc);
+
+	count_vm_stall(ALLOCSTALL_LAT,
+			ktime_to_us(ktime_sub(ktime_get(), start)));
+
+	return nr_reclaimed;
 }
 
 #ifdef CONFIG_CGROUP_MEM_RES_CTLR
@@ -2043,9 +2098,9 @@ loop_again:
 		unsigned long lru_pages = 0;
 		int has_under_min_watermark_zone = 0;
 
-		/* The swap token gets in the way of swapout... */
+		/* Thrash immunity gets in the way of swapout... */
 		if (!priority)
-			disable_swap_token();
+			swap_thrash_suspend();
 
 		all_zones_ok = 1;
 
@@ -2588,7 +2643,7 @@ static int __zone_reclaim(struct zone *zone, gfp_t gfp_mask, unsigned int order)
 	};
 	unsigned long slab_reclaimable;
 
-	disable_swap_token();
+	swap_thrash_suspend();
 	cond_resched();
 	/*
 	 * We need to be able to allocate from the reserves for RECLAIM_SWAP
@@ -17,6 +17,7 @@
 #include <linux/vmstat.h>
 #include <linux/sched.h>
 #include <linux/math64.h>
+#include <linux/statspage.h>
 
 #ifdef CONFIG_VM_EVENT_COUNTERS
 DEFINE_PER_CPU(struct vm_event_state, vm_event_states) = {{0}};
@@ -855,6 +856,24 @@ static const char * const vmstat_text[] = {
 
 	"pgrotated",
 
+	"allocstall_lat_1ms",
+	"allocstall_lat_2ms",
+	"allocstall_lat_4ms",
+	"allocstall_lat_8ms",
+	"allocstall_lat_16ms",
+	"allocstall_lat_32ms",
+	"allocstall_lat_64ms",
+	"allocstall_lat_slow",
+
+	"congestion_wait_lat_1ms",
+	"congestion_wait_lat_2ms",
+	"congestion_wait_lat_4ms",
+	"congestion_wait_lat_8ms",
+	"congestion_wait_lat_16ms",
+	"congestion_wait_lat_32ms",
+	"congestion_wait_lat_64ms",
+	"congestion_wait_lat_slow",
+
 #ifdef CONFIG_COMPACTION
 	"compact_blocks_moved",
 	"compact_pages_moved",
@@ -1105,6 +1124,23 @@ static struct notifier_block __cpuinitdata vmstat_notifier =
 	{ &vmstat_cpuup_callback, NULL, 0 };
 #endif
 
+#if defined(CONFIG_STATSPAGE) && defined(CONFIG_VM_EVENT_COUNTERS)
+/*
+ * Export the vm event counters on the binary stats page, so telemetry
+ * does not have to parse /proc/vmstat every sample.
+ */
+static void vmstat_statspage_snapshot(unsigned long *dst, unsigned int nr)
+{
+	all_vm_events(dst);
+}
+
+static struct statspage_group vmstat_statspage_group = {
+	.name = "vm_events",
+	.nr = NR_VM_EVENT_ITEMS,
+	.snapshot = vmstat_statspage_snapshot,
+};
+#endif
+
 static int __init setup_vmstat(void)
 {
 #ifdef CONFIG_SMP
@@ -1121,6 +1157,9 @@ static int __init setup_vmstat(void)
 	proc_create("pagetypeinfo", S_IRUGO, NULL, &pagetypeinfo_file_ops);
 	proc_create("vmstat", S_IRUGO, NULL, &proc_vmstat_file_operations);
 	proc_create("zoneinfo", S_IRUGO, NULL, &proc_zoneinfo_file_operations);
+#endif
+#if defined(CONFIG_STATSPAGE) && defined(CONFIG_VM_EVENT_COUNTERS)
+	statspage_register(&vmstat_statspage_group);
 #endif
 	return 0;
 }
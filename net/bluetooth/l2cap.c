@@ -4468,9 +4468,41 @@ static int l2cap_security_cfm(struct hci_conn *hcon, u8 status, u8 encrypt)
 	return 0;
 }
 
+/* Reassembled frames whose fragments were chained on a frag list can be
+ * delivered as-is only where the consumer copes with non-linear data.
+ * Basic mode data channels are read through skb_copy_datagram_iovec(),
+ * which walks frag lists, so A2DP style traffic needs no flattening.
+ * Signalling, connectionless, ERTM and streaming frames are parsed in
+ * place (control fields, FCS) and must stay linear.
+ */
+static int l2cap_frame_linear_required(struct l2cap_conn *conn, struct sk_buff *skb)
+{
+	struct l2cap_hdr *lh = (void *) skb->data;
+	struct sock *sk;
+	u16 cid;
+	int required = 1;
+
+	if (skb_headlen(skb) < L2CAP_HDR_SIZE)
+		return 1;
+
+	cid = __le16_to_cpu(lh->cid);
+	if (cid == L2CAP_CID_SIGNALING || cid == L2CAP_CID_CONN_LESS)
+		return 1;
+
+	sk = l2cap_get_chan_by_scid(&conn->chan_list, cid);
+	if (!sk)
+		return 1;
+
+	required = l2cap_pi(sk)->mode != L2CAP_MODE_BASIC;
+	bh_unlock_sock(sk);
+
+	return required;
+}
+
 static int l2cap_recv_acldata(struct hci_conn *hcon, struct sk_buff *skb, u16 flags)
 {
 	struct l2cap_conn *conn = hcon->l2cap_data;
+	struct sk_buff **frag;
 
 	if (!conn && !(conn = l2cap_conn_add(hcon, 0)))
 		goto drop;
@@ -4513,14 +4545,13 @@ static int l2cap_recv_acldata(struct hci_conn *hcon, struct sk_buff *skb, u16 fl
 			goto drop;
 		}
 
-		/* Allocate skb for the complete frame (with header) */
-		conn->rx_skb = bt_skb_alloc(len, GFP_ATOMIC);
-		if (!conn->rx_skb)
-			goto drop;
-
-		skb_copy_from_linear_data(skb, skb_put(conn->rx_skb, skb->len),
-								skb->len);
+		/* Keep the start fragment as the head of the frame and
+		 * chain further fragments below it instead of copying
+		 * everything into a freshly allocated buffer.
+		 */
+		conn->rx_skb = skb;
 		conn->rx_len = len - skb->len;
+		return 0;
 	} else {
 		BT_DBG("Cont: frag len %d (expecting %d)", skb->len, conn->rx_len);
 
@@ -4540,15 +4571,34 @@ static int l2cap_recv_acldata(struct hci_conn *hcon, struct sk_buff *skb, u16 fl
 			goto drop;
 		}
 
-		skb_copy_from_linear_data(skb, skb_put(conn->rx_skb, skb->len),
-								skb->len);
+		/* Append the fragment to the frag list, no copy.  HCI
+		 * fragments per frame are few, so the walk is short.
+		 */
+		frag = &skb_shinfo(conn->rx_skb)->frag_list;
+		while (*frag)
+			frag = &(*frag)->next;
+		*frag = skb;
+
+		conn->rx_skb->len += skb->len;
+		conn->rx_skb->data_len += skb->len;
+		conn->rx_skb->truesize += skb->truesize;
 		conn->rx_len -= skb->len;
 
 		if (!conn->rx_len) {
 			/* Complete frame received */
-			l2cap_recv_frame(conn, conn->rx_skb);
+			struct sk_buff *rx_skb = conn->rx_skb;
+
 			conn->rx_skb = NULL;
+
+			if (l2cap_frame_linear_required(conn, rx_skb) &&
+					skb_linearize(rx_skb)) {
+				kfree_skb(rx_skb);
+				l2cap_conn_unreliable(conn, ECOMM);
+			} else {
+				l2cap_recv_frame(conn, rx_skb);
+			}
 		}
+		return 0;
 	}
 
 drop:
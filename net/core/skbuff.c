@@ -513,6 +513,73 @@ bool skb_recycle_check(struct sk_buff *skb, int skb_size)
 }
 EXPORT_SYMBOL(skb_recycle_check);
 
+/**
+ *	skb_pool_init - set up an skb recycling pool
+ *	@pool: pool to initialize
+ *	@size: usable buffer size each pooled skb must provide
+ *	@max: maximum number of skbs kept in the pool
+ */
+void skb_pool_init(struct skb_pool *pool, unsigned int size, unsigned int max)
+{
+	skb_queue_head_init(&pool->queue);
+	pool->size = size;
+	pool->max = max;
+}
+EXPORT_SYMBOL(skb_pool_init);
+
+/**
+ *	skb_pool_alloc - allocate a receive skb, preferring the pool
+ *	@pool: pool to draw from
+ *	@len: buffer size the caller needs
+ *
+ *	Returns a recycled skb when one is available and @len fits in the
+ *	pool's buffer size, otherwise falls back to dev_alloc_skb().  The
+ *	recycled buffers were reset by skb_recycle_check() and behave like
+ *	a fresh dev_alloc_skb(pool->size).
+ */
+struct sk_buff *skb_pool_alloc(struct skb_pool *pool, unsigned int len)
+{
+	struct sk_buff *skb = NULL;
+
+	if (len <= pool->size) {
+		skb = skb_dequeue(&pool->queue);
+		if (!skb)
+			skb = dev_alloc_skb(pool->size);
+	} else {
+		skb = dev_alloc_skb(len);
+	}
+	return skb;
+}
+EXPORT_SYMBOL(skb_pool_alloc);
+
+/**
+ *	skb_pool_recycle - return an skb to the pool or free it
+ *	@pool: pool the skb should go back to
+ *	@skb: buffer the caller is done with
+ *
+ *	Queues the skb for reuse when skb_recycle_check() accepts it and
+ *	the pool is not full; frees it otherwise.  Safe from any context.
+ */
+void skb_pool_recycle(struct skb_pool *pool, struct sk_buff *skb)
+{
+	if (skb_queue_len(&pool->queue) < pool->max &&
+	    skb_recycle_check(skb, pool->size))
+		skb_queue_head(&pool->queue, skb);
+	else
+		dev_kfree_skb_any(skb);
+}
+EXPORT_SYMBOL(skb_pool_recycle);
+
+/**
+ *	skb_pool_purge - free every skb held by the pool
+ *	@pool: pool to empty
+ */
+void skb_pool_purge(struct skb_pool *pool)
+{
+	skb_queue_purge(&pool->queue);
+}
+EXPORT_SYMBOL(skb_pool_purge);
+
 static void __copy_skb_header(struct sk_buff *new, const struct sk_buff *old)
 {
 	new->tstamp		= old->tstamp;
@@ -325,6 +325,15 @@ void inet_csk_init_xmit_timers(struct sock *sk,
 	setup_timer(&icsk->icsk_delack_timer, delack_handler,
 			(unsigned long)sk);
 	setup_timer(&sk->sk_timer, keepalive_handler, (unsigned long)sk);
+
+	/*
+	 * Retransmit and delayed-ack timers regularly wake an otherwise
+	 * idle handset; while the screen is off let them batch to the
+	 * next wakeup instead of forcing one of their own.
+	 */
+	timer_set_deferrable_on_suspend(&icsk->icsk_retransmit_timer);
+	timer_set_deferrable_on_suspend(&icsk->icsk_delack_timer);
+
 	icsk->icsk_pending = icsk->icsk_ack.pending = 0;
 }
 
@@ -2488,6 +2488,9 @@ void tcp_get_info(struct sock *sk, struct tcp_info *info)
 	info->tcpi_rcv_space = tp->rcvq_space.space;
 
 	info->tcpi_total_retrans = tp->total_retrans;
+
+	info->tcpi_rcv_fastpath = tp->rcv_fastpath;
+	info->tcpi_rcv_slowpath = tp->rcv_slowpath;
 }
 
 EXPORT_SYMBOL_GPL(tcp_get_info);
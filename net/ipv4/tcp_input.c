@@ -5299,6 +5299,7 @@ int tcp_rcv_established(struct sock *sk, struct sk_buff *skb,
 				/* We know that such packets are checksummed
 				 * on entry.
 				 */
+				tp->rcv_fastpath++;
 				tcp_ack(sk, skb, 0);
 				__kfree_skb(skb);
 				tcp_data_snd_check(sk);
@@ -5395,6 +5396,7 @@ no_ack:
 				__kfree_skb(skb);
 			else
 				sk->sk_data_ready(sk, 0);
+			tp->rcv_fastpath++;
 			return 0;
 		}
 	}
@@ -5403,6 +5405,8 @@ slow_path:
 	if (len < (th->doff << 2) || tcp_checksum_complete_user(sk, skb))
 		goto csum_error;
 
+	tp->rcv_slowpath++;
+
 	/*
 	 *	Standard slow path.
 	 */
@@ -2641,7 +2641,7 @@ void tcp_send_delayed_ack(struct sock *sk)
 
 		if (icsk->icsk_ack.pingpong ||
 		    (icsk->icsk_ack.pending & ICSK_ACK_PUSHED))
-			max_ato = TCP_DELACK_MAX;
+			max_ato = tcp_delack_max(sk);
 
 		/* Slow path, intersegment interval is "high". */
 
@@ -59,6 +59,9 @@ STA_FILE(tx_bytes, tx_bytes, LU);
 STA_FILE(rx_duplicates, num_duplicates, LU);
 STA_FILE(rx_fragments, rx_fragments, LU);
 STA_FILE(rx_dropped, rx_dropped, LU);
+STA_FILE(rx_reorder_buffered, rx_reorder_buffered, LU);
+STA_FILE(rx_reorder_timeouts, rx_reorder_timeouts, LU);
+STA_FILE(rx_reorder_jumps, rx_reorder_jumps, LU);
 STA_FILE(tx_fragments, tx_fragments, LU);
 STA_FILE(tx_filtered, tx_filtered_count, LU);
 STA_FILE(tx_retry_failed, tx_retry_failed, LU);
@@ -346,6 +349,9 @@ void ieee80211_sta_debugfs_add(struct sta_info *sta)
 	DEBUGFS_ADD(rx_duplicates);
 	DEBUGFS_ADD(rx_fragments);
 	DEBUGFS_ADD(rx_dropped);
+	DEBUGFS_ADD(rx_reorder_buffered);
+	DEBUGFS_ADD(rx_reorder_timeouts);
+	DEBUGFS_ADD(rx_reorder_jumps);
 	DEBUGFS_ADD(tx_fragments);
 	DEBUGFS_ADD(tx_filtered);
 	DEBUGFS_ADD(tx_retry_failed);
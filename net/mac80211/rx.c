@@ -589,6 +589,7 @@ static void ieee80211_release_reorder_frames(struct ieee80211_hw *hw,
  * can be processed immediately, true if it was consumed.
  */
 static bool ieee80211_sta_manage_reorder_buf(struct ieee80211_hw *hw,
+					     struct sta_info *sta,
 					     struct tid_ampdu_rx *tid_agg_rx,
 					     struct sk_buff *skb,
 					     struct sk_buff_head *frames)
@@ -613,6 +614,7 @@ static bool ieee80211_sta_manage_reorder_buf(struct ieee80211_hw *hw,
 	 * size release some previous frames to make room for this one.
 	 */
 	if (!seq_less(mpdu_seq_num, head_seq_num + buf_size)) {
+		sta->rx_reorder_jumps++;
 		head_seq_num = seq_inc(seq_sub(mpdu_seq_num, buf_size));
 		/* release stored frames up to new head to stack */
 		ieee80211_release_reorder_frames(hw, tid_agg_rx, head_seq_num,
@@ -643,6 +645,7 @@ static bool ieee80211_sta_manage_reorder_buf(struct ieee80211_hw *hw,
 	tid_agg_rx->reorder_buf[index] = skb;
 	tid_agg_rx->reorder_time[index] = jiffies;
 	tid_agg_rx->stored_mpdu_num++;
+	sta->rx_reorder_buffered++;
 	/* release the buffer until next missing frame */
 	index = seq_sub(tid_agg_rx->head_seq_num, tid_agg_rx->ssn) %
 						tid_agg_rx->buf_size;
@@ -671,6 +674,7 @@ static bool ieee80211_sta_manage_reorder_buf(struct ieee80211_hw *hw,
 				       "frames\n",
 				       wiphy_name(hw->wiphy));
 #endif
+			sta->rx_reorder_timeouts++;
 			ieee80211_release_reorder_frame(hw, tid_agg_rx,
 							j, frames);
 
@@ -747,7 +751,8 @@ static void ieee80211_rx_reorder_ampdu(struct ieee80211_rx_data *rx,
 		return;
 	}
 
-	if (ieee80211_sta_manage_reorder_buf(hw, tid_agg_rx, skb, frames)) {
+	if (ieee80211_sta_manage_reorder_buf(hw, sta, tid_agg_rx, skb,
+					     frames)) {
 		spin_unlock(&sta->lock);
 		return;
 	}
@@ -197,6 +197,12 @@ struct sta_ampdu_mlme {
  * @num_duplicates: number of duplicate frames received from this STA
  * @rx_fragments: number of received MPDUs
  * @rx_dropped: number of dropped MPDUs from this STA
+ * @rx_reorder_buffered: number of MPDUs from this STA held back in the
+ *	RX reorder buffer because they arrived out of order
+ * @rx_reorder_timeouts: number of MPDUs from this STA released from the
+ *	RX reorder buffer only after the reorder timeout expired
+ * @rx_reorder_jumps: number of times this STA's RX reorder window
+ *	jumped forward past frames that never arrived
  * @last_signal: signal of last received frame from this STA
  * @last_seq_ctrl: last received seq/frag number from this STA (per RX queue)
  * @tx_filtered_count: number of frames the hardware filtered for this STA
@@ -263,6 +269,9 @@ struct sta_info {
 	unsigned long num_duplicates;
 	unsigned long rx_fragments;
 	unsigned long rx_dropped;
+	unsigned long rx_reorder_buffered;
+	unsigned long rx_reorder_timeouts;
+	unsigned long rx_reorder_jumps;
 	int last_signal;
 	__le16 last_seq_ctrl[NUM_RX_DATA_QUEUES];
 
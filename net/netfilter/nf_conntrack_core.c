@@ -292,13 +292,13 @@ static void death_by_timeout(unsigned long ul_conntrack)
  * OR
  * - Caller must lock nf_conntrack_lock before calling this function
  */
-struct nf_conntrack_tuple_hash *
-__nf_conntrack_find(struct net *net, u16 zone,
-		    const struct nf_conntrack_tuple *tuple)
+static struct nf_conntrack_tuple_hash *
+____nf_conntrack_find(struct net *net, u16 zone,
+		      const struct nf_conntrack_tuple *tuple,
+		      unsigned int hash)
 {
 	struct nf_conntrack_tuple_hash *h;
 	struct hlist_nulls_node *n;
-	unsigned int hash = hash_conntrack(net, zone, tuple);
 
 	/* Disable BHs the entire time since we normally need to disable them
 	 * at least once for the stats anyway.
@@ -327,19 +327,64 @@ begin:
 
 	return NULL;
 }
+
+struct nf_conntrack_tuple_hash *
+__nf_conntrack_find(struct net *net, u16 zone,
+		    const struct nf_conntrack_tuple *tuple)
+{
+	return ____nf_conntrack_find(net, zone, tuple,
+				     hash_conntrack(net, zone, tuple));
+}
 EXPORT_SYMBOL_GPL(__nf_conntrack_find);
 
+/* Per-cpu one-slot cache of the last computed tuple hash.  Established
+ * bulk flows hit the same tuple for every packet, so remembering the
+ * previous result lets them skip the hash computation.  Only the hash
+ * value is cached, never a tuple_hash pointer: SLAB_DESTROY_BY_RCU
+ * keeps a conntrack object type-stable only within the RCU read
+ * section where the pointer was obtained, so a pointer kept across
+ * sections could point into memory returned to the page allocator.
+ * The chain is therefore always re-walked.
+ */
+struct nf_conntrack_lookup_cache {
+	struct net *net;
+	u16 zone;
+	struct nf_conntrack_tuple tuple;
+	unsigned int htable_size;	/* hash depends on the table size */
+	unsigned int hash;
+};
+static DEFINE_PER_CPU(struct nf_conntrack_lookup_cache, nf_conntrack_cache);
+
 /* Find a connection corresponding to a tuple. */
 struct nf_conntrack_tuple_hash *
 nf_conntrack_find_get(struct net *net, u16 zone,
 		      const struct nf_conntrack_tuple *tuple)
 {
+	struct nf_conntrack_lookup_cache *cache;
 	struct nf_conntrack_tuple_hash *h;
 	struct nf_conn *ct;
+	unsigned int hash;
 
 	rcu_read_lock();
+	local_bh_disable();
+	cache = &__get_cpu_var(nf_conntrack_cache);
+	if (cache->net == net && cache->zone == zone &&
+	    cache->htable_size == net->ct.htable_size &&
+	    nf_ct_tuple_equal(tuple, &cache->tuple)) {
+		hash = cache->hash;
+		NF_CT_STAT_INC(net, cache_hit);
+	} else {
+		hash = hash_conntrack(net, zone, tuple);
+		cache->net = net;
+		cache->zone = zone;
+		cache->tuple = *tuple;
+		cache->htable_size = net->ct.htable_size;
+		cache->hash = hash;
+		NF_CT_STAT_INC(net, cache_miss);
+	}
+	local_bh_enable();
 begin:
-	h = __nf_conntrack_find(net, zone, tuple);
+	h = ____nf_conntrack_find(net, zone, tuple, hash);
 	if (h) {
 		ct = nf_ct_tuplehash_to_ctrack(h);
 		if (unlikely(nf_ct_is_dying(ct) ||
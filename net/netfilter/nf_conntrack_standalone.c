@@ -252,12 +252,12 @@ static int ct_cpu_seq_show(struct seq_file *seq, void *v)
 	const struct ip_conntrack_stat *st = v;
 
 	if (v == SEQ_START_TOKEN) {
-		seq_printf(seq, "entries  searched found new invalid ignore delete delete_list insert insert_failed drop early_drop icmp_error  expect_new expect_create expect_delete search_restart\n");
+		seq_printf(seq, "entries  searched found new invalid ignore delete delete_list insert insert_failed drop early_drop icmp_error  expect_new expect_create expect_delete search_restart cache_hit cache_miss\n");
 		return 0;
 	}
 
 	seq_printf(seq, "%08x  %08x %08x %08x %08x %08x %08x %08x "
-			"%08x %08x %08x %08x %08x  %08x %08x %08x %08x\n",
+			"%08x %08x %08x %08x %08x  %08x %08x %08x %08x %08x %08x\n",
 		   nr_conntracks,
 		   st->searched,
 		   st->found,
@@ -275,7 +275,9 @@ static int ct_cpu_seq_show(struct seq_file *seq, void *v)
 		   st->expect_new,
 		   st->expect_create,
 		   st->expect_delete,
-		   st->search_restart
+		   st->search_restart,
+		   st->cache_hit,
+		   st->cache_miss
 		);
 	return 0;
 }
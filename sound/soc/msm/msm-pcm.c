@@ -45,6 +45,8 @@
 	msm_adsp_write(prtd->audrec, QDSP_uPAudRecCmdQueue, cmd, len)
 
 int intcnt;
+int msm_pcm_deep_buffer;
+EXPORT_SYMBOL(msm_pcm_deep_buffer);
 static int audio_dsp_send_buffer(struct msm_audio *prtd,
 			unsigned idx, unsigned len);
 
@@ -293,17 +295,25 @@ int alsa_adsp_configure(struct msm_audio *prtd)
 	if (ret)
 		goto err2;
 	if (prtd->dir == SNDRV_PCM_STREAM_PLAYBACK) {
-		prtd->out_buffer_size = PLAYBACK_DMASZ;
+		/* The buffer size is fixed for the life of the stream:
+		 * the DSP gets the addresses and lengths when the pcm
+		 * interface is enabled.  Streams configured while the
+		 * screen is off use the deep pair so the DSP only
+		 * interrupts the AP a few times a second.
+		 */
+		unsigned bufsz = msm_pcm_deep_buffer ? BUFSZ_DEEP : BUFSZ;
+
+		prtd->out_buffer_size = bufsz * 2;
 		prtd->out_sample_rate = 44100;
 		prtd->out_channel_mode = AUDPP_CMD_PCM_INTF_STEREO_V;
 		prtd->out_weight = 100;
 
 		prtd->out[0].data = prtd->data + 0;
 		prtd->out[0].addr = prtd->phys + 0;
-		prtd->out[0].size = BUFSZ;
-		prtd->out[1].data = prtd->data + BUFSZ;
-		prtd->out[1].addr = prtd->phys + BUFSZ;
-		prtd->out[1].size = BUFSZ;
+		prtd->out[0].size = bufsz;
+		prtd->out[1].data = prtd->data + bufsz;
+		prtd->out[1].addr = prtd->phys + bufsz;
+		prtd->out[1].size = bufsz;
 	}
 	if (prtd->dir == SNDRV_PCM_STREAM_CAPTURE) {
 		prtd->samp_rate = RPC_AUD_DEF_SAMPLE_RATE_44100;
@@ -39,7 +39,13 @@
 #define CAPTURE_DMASZ           (FRAME_SIZE * FRAME_NUM)
 
 #define BUFSZ			(960 * 5)
-#define PLAYBACK_DMASZ 		(BUFSZ * 2)
+/* Deep buffer used for screen-off playback: ~109ms per buffer at
+ * 44.1kHz stereo, so the DSP wakes the AP a few times a second
+ * instead of every ~27ms.  The DMA area is sized for the deep pair;
+ * the normal mode only uses the first 2 * BUFSZ of it.
+ */
+#define BUFSZ_DEEP		(960 * 20)
+#define PLAYBACK_DMASZ 		(BUFSZ_DEEP * 2)
 
 #define MSM_PLAYBACK_DEFAULT_VOLUME 0 /* 0dB */
 #define MSM_PLAYBACK_DEFAULT_PAN 0
@@ -53,11 +59,11 @@
 #define USE_RATE_MIN            8000
 #define USE_RATE_MAX            48000
 #define MAX_BUFFER_PLAYBACK_SIZE \
-				(4800*4)
+				(BUFSZ_DEEP * 2)
 /* 2048 frames (Mono), 1024 frames (Stereo) */
 #define CAPTURE_SIZE		4096
 #define MAX_BUFFER_CAPTURE_SIZE (4096*4)
-#define MAX_PERIOD_SIZE         BUFSZ
+#define MAX_PERIOD_SIZE         BUFSZ_DEEP
 #define USE_PERIODS_MAX         1024
 #define USE_PERIODS_MIN		1
 
@@ -71,6 +77,9 @@
 
 extern int copy_count;
 extern int intcnt;
+/* set while the screen is off; playback streams configured then use
+ * BUFSZ_DEEP sized buffers (see alsa_adsp_configure) */
+extern int msm_pcm_deep_buffer;
 
 struct msm_volume {
 	bool update;
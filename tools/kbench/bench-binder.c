@@ -0,0 +1,125 @@
+/*
+ * bench-binder - binder ping round-trip latency
+ *
+ * Sends PING_TRANSACTION to handle 0 (the service manager) and waits
+ * for BR_REPLY, the same null transaction libbinder uses for
+ * pingBinder(). Needs a running service manager; skips otherwise.
+ * Reports ns per round trip.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#include "kbench.h"	/* before binder.h: supplies stdint.h */
+#include "../../drivers/staging/android/binder.h"
+
+#define BINDER_LOOPS		1000
+#define BINDER_MMAP_SIZE	(128 * 1024)
+#define PING_TRANSACTION	B_PACK_CHARS('_', 'P', 'N', 'G')
+
+static int binder_ping(int fd)
+{
+	struct {
+		uint32_t cmd;
+		struct binder_transaction_data tr;
+	} __attribute__((packed)) writebuf;
+	unsigned char readbuf[256];
+	struct binder_write_read bwr;
+	unsigned char *p, *end;
+	uint32_t cmd;
+
+	memset(&writebuf, 0, sizeof(writebuf));
+	writebuf.cmd = BC_TRANSACTION;
+	writebuf.tr.target.handle = 0;
+	writebuf.tr.code = PING_TRANSACTION;
+
+	memset(&bwr, 0, sizeof(bwr));
+	bwr.write_size = sizeof(writebuf);
+	bwr.write_buffer = (unsigned long)&writebuf;
+
+	for (;;) {
+		bwr.read_size = sizeof(readbuf);
+		bwr.read_buffer = (unsigned long)readbuf;
+		bwr.read_consumed = 0;
+
+		if (ioctl(fd, BINDER_WRITE_READ, &bwr) < 0)
+			return -1;
+		bwr.write_size = 0;
+
+		p = readbuf;
+		end = readbuf + bwr.read_consumed;
+		while (p + sizeof(cmd) <= end) {
+			cmd = *(uint32_t *)p;
+			p += sizeof(cmd);
+			switch (cmd) {
+			case BR_NOOP:
+			case BR_TRANSACTION_COMPLETE:
+				break;
+			case BR_REPLY: {
+				struct binder_transaction_data *tr =
+					(struct binder_transaction_data *)p;
+				struct {
+					uint32_t cmd;
+					const void *buffer;
+				} __attribute__((packed)) free_cmd;
+
+				free_cmd.cmd = BC_FREE_BUFFER;
+				free_cmd.buffer = tr->data.ptr.buffer;
+				bwr.write_size = sizeof(free_cmd);
+				bwr.write_buffer = (unsigned long)&free_cmd;
+				bwr.write_consumed = 0;
+				bwr.read_size = 0;
+				ioctl(fd, BINDER_WRITE_READ, &bwr);
+				return 0;
+			}
+			case BR_DEAD_REPLY:
+			case BR_FAILED_REPLY:
+				return -1;
+			default:
+				return -1;
+			}
+		}
+	}
+}
+
+int bench_binder(int argc, char **argv)
+{
+	uint64_t t0, t1;
+	void *map;
+	int fd, i;
+
+	fd = open("/dev/binder", O_RDWR);
+	if (fd < 0) {
+		kbench_skip("binder", "no_dev_binder");
+		return 0;
+	}
+	map = mmap(NULL, BINDER_MMAP_SIZE, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		kbench_skip("binder", "mmap_failed");
+		close(fd);
+		return 1;
+	}
+
+	/* warm up and check the service manager is answering */
+	if (binder_ping(fd) < 0) {
+		kbench_skip("binder", "no_service_manager");
+		goto out;
+	}
+
+	t0 = ts_ns();
+	for (i = 0; i < BINDER_LOOPS; i++) {
+		if (binder_ping(fd) < 0)
+			break;
+	}
+	t1 = ts_ns();
+
+	kbench_report("binder", "loops=%d ns_per_roundtrip=%llu", i,
+		      (unsigned long long)(i ? (t1 - t0) / i : 0));
+out:
+	munmap(map, BINDER_MMAP_SIZE);
+	close(fd);
+	return 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * bench-ctxsw - context switch cost via pipe ping-pong
+ *
+ * Parent and child bounce one byte over a pair of pipes; each round
+ * trip is two context switches on a single-core target. Reports
+ * ns per switch.
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "kbench.h"
+
+#define CTXSW_LOOPS	20000
+
+int bench_ctxsw(int argc, char **argv)
+{
+	int p2c[2], c2p[2];
+	uint64_t t0, t1;
+	char byte = 0;
+	pid_t pid;
+	int i;
+
+	if (pipe(p2c) < 0 || pipe(c2p) < 0) {
+		kbench_skip("ctxsw", "pipe_failed");
+		return 1;
+	}
+
+	pid = fork();
+	if (pid < 0) {
+		kbench_skip("ctxsw", "fork_failed");
+		return 1;
+	}
+
+	if (pid == 0) {
+		for (i = 0; i < CTXSW_LOOPS; i++) {
+			if (read(p2c[0], &byte, 1) != 1)
+				_exit(1);
+			if (write(c2p[1], &byte, 1) != 1)
+				_exit(1);
+		}
+		_exit(0);
+	}
+
+	t0 = ts_ns();
+	for (i = 0; i < CTXSW_LOOPS; i++) {
+		if (write(p2c[1], &byte, 1) != 1)
+			break;
+		if (read(c2p[0], &byte, 1) != 1)
+			break;
+	}
+	t1 = ts_ns();
+	waitpid(pid, NULL, 0);
+
+	kbench_report("ctxsw", "loops=%d ns_per_switch=%llu", CTXSW_LOOPS,
+		      (unsigned long long)((t1 - t0) / (2 * CTXSW_LOOPS)));
+	return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * bench-epoll - epoll wakeup latency
+ *
+ * A writer thread stamps the monotonic clock just before writing one
+ * byte to a pipe; the main thread sleeps in epoll_wait on the read end
+ * and measures how long the wakeup took. Reports average and max ns.
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+
+#include "kbench.h"
+
+#define EPOLL_LOOPS	2000
+
+static volatile uint64_t wake_t0;
+static int wake_fd;
+
+static void *epoll_writer(void *arg)
+{
+	char byte = 0;
+	int i;
+
+	for (i = 0; i < EPOLL_LOOPS; i++) {
+		/* let the waiter get back into epoll_wait */
+		usleep(500);
+		wake_t0 = ts_ns();
+		if (write(wake_fd, &byte, 1) != 1)
+			break;
+	}
+	return NULL;
+}
+
+int bench_epoll(int argc, char **argv)
+{
+	uint64_t total = 0, max = 0, delta;
+	struct epoll_event ev;
+	pthread_t thread;
+	int pfd[2], epfd;
+	char byte;
+	int i;
+
+	if (pipe(pfd) < 0) {
+		kbench_skip("epoll", "pipe_failed");
+		return 1;
+	}
+	epfd = epoll_create(1);
+	if (epfd < 0) {
+		kbench_skip("epoll", "epoll_create_failed");
+		return 1;
+	}
+	ev.events = EPOLLIN;
+	ev.data.fd = pfd[0];
+	epoll_ctl(epfd, EPOLL_CTL_ADD, pfd[0], &ev);
+
+	wake_fd = pfd[1];
+	if (pthread_create(&thread, NULL, epoll_writer, NULL)) {
+		kbench_skip("epoll", "pthread_create_failed");
+		return 1;
+	}
+
+	for (i = 0; i < EPOLL_LOOPS; i++) {
+		if (epoll_wait(epfd, &ev, 1, 1000) != 1)
+			break;
+		delta = ts_ns() - wake_t0;
+		total += delta;
+		if (delta > max)
+			max = delta;
+		if (read(pfd[0], &byte, 1) != 1)
+			break;
+	}
+	pthread_join(thread, NULL);
+
+	kbench_report("epoll", "loops=%d avg_wake_ns=%llu max_wake_ns=%llu",
+		      i, (unsigned long long)(i ? total / i : 0),
+		      (unsigned long long)max);
+	return 0;
+}
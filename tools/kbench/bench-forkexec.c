@@ -0,0 +1,57 @@
+/*
+ * bench-forkexec - fork and fork+exec cost
+ *
+ * fork+exec re-executes this binary; main() sees KBENCH_EXEC_CHILD in
+ * the environment and exits immediately. Reports us per fork and us
+ * per fork+exec.
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "kbench.h"
+
+#define FORK_LOOPS	200
+
+int bench_forkexec(int argc, char **argv)
+{
+	uint64_t t0, fork_ns, exec_ns;
+	pid_t pid;
+	int i;
+
+	t0 = ts_ns();
+	for (i = 0; i < FORK_LOOPS; i++) {
+		pid = fork();
+		if (pid < 0) {
+			kbench_skip("forkexec", "fork_failed");
+			return 1;
+		}
+		if (pid == 0)
+			_exit(0);
+		waitpid(pid, NULL, 0);
+	}
+	fork_ns = ts_ns() - t0;
+
+	setenv("KBENCH_EXEC_CHILD", "1", 1);
+	t0 = ts_ns();
+	for (i = 0; i < FORK_LOOPS; i++) {
+		pid = fork();
+		if (pid < 0) {
+			kbench_skip("forkexec", "fork_failed");
+			return 1;
+		}
+		if (pid == 0) {
+			execl("/proc/self/exe", "kbench", (char *)NULL);
+			_exit(1);
+		}
+		waitpid(pid, NULL, 0);
+	}
+	exec_ns = ts_ns() - t0;
+	unsetenv("KBENCH_EXEC_CHILD");
+
+	kbench_report("forkexec", "loops=%d us_per_fork=%llu us_per_forkexec=%llu",
+		      FORK_LOOPS,
+		      (unsigned long long)(fork_ns / 1000 / FORK_LOOPS),
+		      (unsigned long long)(exec_ns / 1000 / FORK_LOOPS));
+	return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * bench-pgfault - anonymous page fault rate
+ *
+ * Maps, touches and unmaps anonymous memory; every first touch takes a
+ * minor fault. Reports ns per fault.
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "kbench.h"
+
+#define PGFAULT_MAP_SIZE	(16 * 1024 * 1024)
+#define PGFAULT_PASSES		8
+
+int bench_pgfault(int argc, char **argv)
+{
+	long page = sysconf(_SC_PAGESIZE);
+	unsigned long faults = 0;
+	uint64_t t0, t1;
+	char *map, *p;
+	int pass;
+
+	t0 = ts_ns();
+	for (pass = 0; pass < PGFAULT_PASSES; pass++) {
+		map = mmap(NULL, PGFAULT_MAP_SIZE, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (map == MAP_FAILED) {
+			kbench_skip("pgfault", "mmap_failed");
+			return 1;
+		}
+		for (p = map; p < map + PGFAULT_MAP_SIZE; p += page) {
+			*p = 1;
+			faults++;
+		}
+		munmap(map, PGFAULT_MAP_SIZE);
+	}
+	t1 = ts_ns();
+
+	kbench_report("pgfault", "faults=%lu ns_per_fault=%llu", faults,
+		      (unsigned long long)((t1 - t0) / faults));
+	return 0;
+}
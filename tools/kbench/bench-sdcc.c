@@ -0,0 +1,95 @@
+/*
+ * bench-sdcc - sdcc sequential and random throughput
+ *
+ * Exercises the block stack over a scratch file (default
+ * /data/kbench.tmp, first argument overrides): sequential write with
+ * fsync, sequential read, then random 4K reads. The page cache is
+ * dropped with POSIX_FADV_DONTNEED between phases so reads hit the
+ * card. Reports MB/s and 4K read iops.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "kbench.h"
+
+#define SDCC_FILE_SIZE	(32 * 1024 * 1024)
+#define SDCC_BLOCK_SIZE	(128 * 1024)
+#define SDCC_RAND_SIZE	4096
+#define SDCC_RAND_LOOPS	512
+
+static void sdcc_drop_cache(int fd)
+{
+#ifdef POSIX_FADV_DONTNEED
+	fsync(fd);
+	posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+}
+
+static unsigned long long sdcc_mbps(uint64_t bytes, uint64_t ns)
+{
+	return ns ? bytes * 1000 / ns : 0;
+}
+
+int bench_sdcc(int argc, char **argv)
+{
+	const char *path = argc > 0 ? argv[0] : "/data/kbench.tmp";
+	uint64_t t0, wr_ns, rd_ns, rand_ns;
+	static char buf[SDCC_BLOCK_SIZE];
+	off_t off;
+	int fd, i;
+
+	fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0) {
+		kbench_skip("sdcc", "cannot_create_file");
+		return 0;
+	}
+	memset(buf, 0xa5, sizeof(buf));
+
+	t0 = ts_ns();
+	for (off = 0; off < SDCC_FILE_SIZE; off += SDCC_BLOCK_SIZE) {
+		if (write(fd, buf, SDCC_BLOCK_SIZE) != SDCC_BLOCK_SIZE) {
+			kbench_skip("sdcc", "write_failed");
+			goto out;
+		}
+	}
+	fsync(fd);
+	wr_ns = ts_ns() - t0;
+
+	sdcc_drop_cache(fd);
+	lseek(fd, 0, SEEK_SET);
+	t0 = ts_ns();
+	for (off = 0; off < SDCC_FILE_SIZE; off += SDCC_BLOCK_SIZE) {
+		if (read(fd, buf, SDCC_BLOCK_SIZE) != SDCC_BLOCK_SIZE) {
+			kbench_skip("sdcc", "read_failed");
+			goto out;
+		}
+	}
+	rd_ns = ts_ns() - t0;
+
+	sdcc_drop_cache(fd);
+	srandom(ts_ns());
+	t0 = ts_ns();
+	for (i = 0; i < SDCC_RAND_LOOPS; i++) {
+		off = (random() % (SDCC_FILE_SIZE / SDCC_RAND_SIZE)) *
+			SDCC_RAND_SIZE;
+		if (pread(fd, buf, SDCC_RAND_SIZE, off) != SDCC_RAND_SIZE) {
+			kbench_skip("sdcc", "pread_failed");
+			goto out;
+		}
+	}
+	rand_ns = ts_ns() - t0;
+
+	kbench_report("sdcc",
+		      "file_mb=%d seq_write_mbps=%llu seq_read_mbps=%llu rand_read_4k_iops=%llu",
+		      SDCC_FILE_SIZE / (1024 * 1024),
+		      sdcc_mbps(SDCC_FILE_SIZE, wr_ns / 1000),
+		      sdcc_mbps(SDCC_FILE_SIZE, rd_ns / 1000),
+		      (unsigned long long)(rand_ns ?
+			(uint64_t)SDCC_RAND_LOOPS * 1000000000ull / rand_ns : 0));
+out:
+	close(fd);
+	unlink(path);
+	return 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * bench-smd - SMD loopback echo latency
+ *
+ * Writes packets to /dev/smd_pkt_loopback (the LOOPBACK channel the
+ * modem echoes back, see arch/arm/mach-msm/smd_pkt.c) and times the
+ * round trip through shared memory. Skips when the node is absent or
+ * the modem has not brought the channel up. Reports us per echo.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "kbench.h"
+
+#define SMD_LOOPBACK_DEV	"/dev/smd_pkt_loopback"
+#define SMD_LOOPS		500
+#define SMD_PKT_SIZE		64
+
+int bench_smd(int argc, char **argv)
+{
+	unsigned char txbuf[SMD_PKT_SIZE], rxbuf[SMD_PKT_SIZE];
+	uint64_t t0, t1;
+	int fd, i;
+
+	fd = open(SMD_LOOPBACK_DEV, O_RDWR);
+	if (fd < 0) {
+		kbench_skip("smd", "no_loopback_dev");
+		return 0;
+	}
+
+	memset(txbuf, 0x5a, sizeof(txbuf));
+
+	/* first echo also covers channel bring-up; keep it out of the timing */
+	if (write(fd, txbuf, sizeof(txbuf)) != sizeof(txbuf) ||
+	    read(fd, rxbuf, sizeof(rxbuf)) <= 0) {
+		kbench_skip("smd", "loopback_not_up");
+		close(fd);
+		return 0;
+	}
+
+	t0 = ts_ns();
+	for (i = 0; i < SMD_LOOPS; i++) {
+		if (write(fd, txbuf, sizeof(txbuf)) != sizeof(txbuf))
+			break;
+		if (read(fd, rxbuf, sizeof(rxbuf)) <= 0)
+			break;
+	}
+	t1 = ts_ns();
+	close(fd);
+
+	kbench_report("smd", "loops=%d pkt_bytes=%d us_per_echo=%llu", i,
+		      SMD_PKT_SIZE,
+		      (unsigned long long)(i ? (t1 - t0) / 1000 / i : 0));
+	return 0;
+}
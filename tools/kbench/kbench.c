@@ -0,0 +1,63 @@
+/*
+ * kbench - on-device microbenchmarks for kernel hot paths
+ *
+ * Usage: kbench <benchmark>|all [args]
+ *
+ * Modelled on tools/perf/builtin-bench.c: a static table of benchmarks,
+ * each a self-contained run function. Build with the Android toolchain
+ * (see Makefile) and push the binary to the target.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "kbench.h"
+
+static struct kbench benchmarks[] = {
+	{ "ctxsw",	"context switch cost (pipe ping-pong)",	bench_ctxsw },
+	{ "pgfault",	"anonymous page fault rate",		bench_pgfault },
+	{ "forkexec",	"fork and fork+exec time",		bench_forkexec },
+	{ "epoll",	"epoll wakeup latency",			bench_epoll },
+	{ "binder",	"binder ping round-trip latency",	bench_binder },
+	{ "smd",	"SMD loopback echo latency",		bench_smd },
+	{ "sdcc",	"sdcc sequential/random throughput",	bench_sdcc },
+	{ NULL, NULL, NULL }
+};
+
+static void usage(void)
+{
+	struct kbench *b;
+
+	fprintf(stderr, "usage: kbench <benchmark>|all [args]\n\n");
+	for (b = benchmarks; b->name; b++)
+		fprintf(stderr, "  %-10s %s\n", b->name, b->desc);
+}
+
+int main(int argc, char **argv)
+{
+	struct kbench *b;
+	int ret = 0;
+
+	/* re-exec child for the forkexec benchmark, see bench-forkexec.c */
+	if (getenv("KBENCH_EXEC_CHILD"))
+		_exit(0);
+
+	if (argc < 2) {
+		usage();
+		return 1;
+	}
+
+	if (!strcmp(argv[1], "all")) {
+		for (b = benchmarks; b->name; b++)
+			ret |= b->run(0, NULL);
+		return ret;
+	}
+
+	for (b = benchmarks; b->name; b++) {
+		if (!strcmp(argv[1], b->name))
+			return b->run(argc - 2, argv + 2);
+	}
+
+	usage();
+	return 1;
+}
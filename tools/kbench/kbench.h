@@ -0,0 +1,47 @@
+/*
+ * kbench.h - common helpers for the on-device kernel microbenchmarks
+ *
+ * Every benchmark reports one machine-readable line per result:
+ *
+ *	KBENCH <bench> <key>=<value> [<key>=<value> ...]
+ *
+ * and "KBENCH <bench> SKIP reason=..." when the required device or
+ * service is not present on the target, so a harness can tell a skip
+ * from a failure.
+ */
+#ifndef KBENCH_H
+#define KBENCH_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+static inline uint64_t ts_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+#define kbench_report(bench, fmt, ...) \
+	printf("KBENCH %s " fmt "\n", bench, ##__VA_ARGS__)
+
+#define kbench_skip(bench, reason) \
+	printf("KBENCH %s SKIP reason=%s\n", bench, reason)
+
+struct kbench {
+	const char *name;
+	const char *desc;
+	int (*run)(int argc, char **argv);
+};
+
+int bench_ctxsw(int argc, char **argv);
+int bench_pgfault(int argc, char **argv);
+int bench_forkexec(int argc, char **argv);
+int bench_epoll(int argc, char **argv);
+int bench_binder(int argc, char **argv);
+int bench_smd(int argc, char **argv);
+int bench_sdcc(int argc, char **argv);
+
+#endif /* KBENCH_H */